@@ -0,0 +1,270 @@
+#import <Foundation/Foundation.h>
+
+
+/**
+ @brief      Compact binary encoder / decoder for poll models.
+ @discussion Coder write and read values using variable-length integers (varints) and
+             length-prefixed UTF-8 strings, so messages doesn't carry class and property names.
+             Poll identifier can be replaced with short numeric poll token, if coder has been
+             configured with poll information.
+             Every compact payload starts with format version and model type identifier.
+
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPCompactCoder : NSObject
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on data which has been written by encoder or passed to decoder.
+ */
+@property (nonatomic, readonly, strong) NSData *data;
+
+/**
+ @brief  Stores whether decoder was able to read all requested values or not.
+ */
+@property (nonatomic, readonly, assign, getter = isValid) BOOL valid;
+
+/**
+ @brief  Stores whether decoder read all passed data or not (used to detect optional trailing 
+         fields).
+ */
+@property (nonatomic, readonly, assign, getter = isAtEnd) BOOL atEnd;
+
+/**
+ @brief  Retrieve name of compact format which is used by host to announce supported encodings.
+
+ @return Format name with version.
+ */
++ (NSString *)formatName;
+
+/**
+ @brief  Retrieve version of compact format which is written by encoder.
+
+ @return Compact format version.
+ */
++ (NSUInteger)formatVersion;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure encoder.
+
+ @param pollIdentifier Reference on identifier of the poll which should be replaced with token.
+ @param token          Reference on short poll token which should be used instead of identifier.
+
+ @return Configured and ready to use encoder.
+ */
++ (instancetype)encoderForPoll:(NSString *)pollIdentifier token:(NSNumber *)token;
+
+/**
+ @brief  Create and configure decoder.
+
+ @param data           Reference on compact data which should be decoded.
+ @param pollIdentifier Reference on identifier of the poll which should be used instead of token.
+ @param token          Reference on short poll token which is known to decoder.
+
+ @return Configured and ready to use decoder.
+ */
++ (instancetype)decoderWithData:(NSData *)data forPoll:(NSString *)pollIdentifier
+                          token:(NSNumber *)token;
+
+/**
+ @brief      Create and configure decoder which can be reused for number of messages.
+ @discussion Decoder own buffer into which messages decoded by \c -resetWithRepresentation:, so 
+             fields can be projected from many messages without per-message allocations.
+ 
+ @param pollIdentifier Reference on identifier of the poll which should be used instead of token.
+ @param token          Reference on short poll token which is known to decoder.
+ 
+ @return Configured and ready to use decoder.
+ */
++ (instancetype)reusableDecoderForPoll:(NSString *)pollIdentifier token:(NSNumber *)token;
+
+/**
+ @brief  Decode base64 compact representation into decoder's buffer and start reading from it.
+ 
+ @param representation Reference on base64 encoded compact representation.
+ 
+ @return \c NO in case if \c representation can't be decoded.
+ */
+- (BOOL)resetWithRepresentation:(NSString *)representation;
+
+/**
+ @brief      Decode only leading part of base64 compact representation into decoder's buffer and
+             start reading from it.
+ @discussion Allow to read message header (for example poll key) without decoding whole message.
+             Reading beyond decoded part makes decoder invalid.
+ 
+ @param representation Reference on base64 encoded compact representation.
+ @param length         Maximum number of leading base64 characters which should be decoded (rounded
+                       down to whole quads, not more than 512).
+ 
+ @return \c NO in case if leading part of \c representation can't be decoded.
+ */
+- (BOOL)resetWithRepresentation:(NSString *)representation length:(NSUInteger)length;
+
+
+///------------------------------------------------
+/// @name Encoding
+///------------------------------------------------
+
+/**
+ @brief  Write unsigned integer as varint.
+ */
+- (void)encodeUnsignedInteger:(uint64_t)value;
+
+/**
+ @brief  Write signed integer as zigzag varint.
+ */
+- (void)encodeSignedInteger:(int64_t)value;
+
+/**
+ @brief  Write optional unsigned number (\c nil encoded as single zero byte).
+ */
+- (void)encodeNumber:(NSNumber *)number;
+
+/**
+ @brief  Write boolean value.
+ */
+- (void)encodeBool:(BOOL)value;
+
+/**
+ @brief  Write double value as 8 bytes (little-endian IEEE 754).
+ */
+- (void)encodeDouble:(double)value;
+
+/**
+ @brief  Write optional length-prefixed UTF-8 string.
+ */
+- (void)encodeString:(NSString *)string;
+
+/**
+ @brief  Write optional identifier as 16 bytes \c UUID (if possible) or string.
+ */
+- (void)encodeIdentifier:(NSString *)identifier;
+
+/**
+ @brief      Write poll identifier.
+ @discussion Identifier of the poll for which coder has been configured replaced with token. Other
+             identifiers written as 16 bytes \c UUID (if possible) or string.
+ */
+- (void)encodePollIdentifier:(NSString *)identifier;
+
+/**
+ @brief  Write optional list of models which support compact coding.
+ */
+- (void)encodeObjects:(NSArray *)objects;
+
+
+///------------------------------------------------
+/// @name Decoding
+///------------------------------------------------
+
+/**
+ @brief  Read varint unsigned integer.
+ */
+- (uint64_t)decodeUnsignedInteger;
+
+/**
+ @brief  Read zigzag varint signed integer.
+ */
+- (int64_t)decodeSignedInteger;
+
+/**
+ @brief  Read optional unsigned number.
+ */
+- (NSNumber *)decodeNumber;
+
+/**
+ @brief  Read boolean value.
+ */
+- (BOOL)decodeBool;
+
+/**
+ @brief  Read double value.
+ */
+- (double)decodeDouble;
+
+/**
+ @brief  Read optional UTF-8 string.
+ */
+- (NSString *)decodeString;
+
+/**
+ @brief  Read optional identifier.
+ */
+- (NSString *)decodeIdentifier;
+
+/**
+ @brief  Read poll identifier (\c nil will be returned for token of unknown poll).
+ */
+- (NSString *)decodePollIdentifier;
+
+/**
+ @brief      Read poll identifier without resolving poll token.
+ @discussion Allow to find out for which poll message has been sent before decoder configured for
+             it.
+
+ @return Poll identifier, \c NSNumber with short poll token or \c nil.
+ */
+- (id)decodePollKey;
+
+/**
+ @brief  Read optional list of models.
+
+ @param objectClass Reference on \b SPNPSerializable subclass which is stored in list.
+
+ @return List of decoded models or \c nil in case of decoding error.
+ */
+- (NSArray *)decodeObjectsOfClass:(Class)objectClass;
+
+
+///------------------------------------------------
+/// @name Field projection
+///------------------------------------------------
+
+/**
+ @brief  Read optional unsigned number without \c NSNumber creation.
+ 
+ @param value Reference on variable into which number should be stored.
+ 
+ @return \c NO in case if number has been written as \c nil.
+ */
+- (BOOL)decodeNumberValue:(uint64_t *)value;
+
+/**
+ @brief  Skip optional UTF-8 string.
+ */
+- (void)skipString;
+
+/**
+ @brief  Read poll identifier and compare it with decoder's poll (identifier or token).
+ 
+ @return \c YES in case if value has been written for decoder's poll.
+ */
+- (BOOL)decodePollKeyMatchingPoll;
+
+/**
+ @brief      Read optional identifier without string creation.
+ @discussion Returned pointer valid till next decoder reset.
+ 
+ @param length Reference on variable into which number of identifier bytes should be stored.
+ @param isUUID Reference on variable into which stored whether identifier written as binary 
+               \c UUID or as UTF-8 string.
+ 
+ @return Pointer on first identifier byte or \c NULL in case if identifier written as \c nil.
+ */
+- (const uint8_t *)decodeIdentifierBytesWithLength:(NSUInteger *)length isUUID:(BOOL *)isUUID;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,654 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPCompactCoder.h"
+#import "SPNPSerializable.h"
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores version of compact format which is written by encoder.
+ */
+static NSUInteger const kSPNPCompactFormatVersion = 1;
+
+/**
+ @brief  Stores maximum number of elements which decoder allow to be passed in single list (to
+         protect from malformed messages).
+ */
+static uint64_t const kSPNPCompactMaximumListLength = 65535;
+
+/**
+ @brief  Stores maximum length of base64 representation which reusable decoder decode without heap
+         allocations (longer representations decoded through \c NSData).
+ */
+static NSUInteger const kSPNPCompactMaximumInlineRepresentationLength = 512;
+
+
+#pragma mark - Types
+
+/**
+ @brief  Describes how poll identifier has been written.
+ */
+typedef NS_ENUM(uint8_t, SPNPCompactPollIdentifierType) {
+
+    /**
+     @brief  Identifier not set.
+     */
+    SPNPCompactNoPollIdentifier,
+
+    /**
+     @brief  Identifier replaced with poll token.
+     */
+    SPNPCompactPollToken,
+
+    /**
+     @brief  Identifier written as 16 bytes \c UUID.
+     */
+    SPNPCompactPollUUID,
+
+    /**
+     @brief  Identifier written as string.
+     */
+    SPNPCompactPollString
+};
+
+
+#pragma mark - Private interface declaration
+
+@interface SPNPCompactCoder () {
+
+    /**
+     @brief  Stores binary representation of poll identifier (if it is \c UUID).
+     */
+    uuid_t _pollUUID;
+}
+
+
+#pragma mark - Properties
+
+@property (nonatomic, strong) NSData *data;
+@property (nonatomic, assign, getter = isValid) BOOL valid;
+
+/**
+ @brief  Stores reference on buffer to which encoder write data.
+ */
+@property (nonatomic, strong) NSMutableData *buffer;
+
+/**
+ @brief  Stores current decoder read position.
+ */
+@property (nonatomic, assign) NSUInteger offset;
+
+/**
+ @brief  Stores reference on poll identifier and token which is used for identifier replacement.
+ */
+@property (nonatomic, copy) NSString *pollIdentifier;
+@property (nonatomic, strong) NSNumber *pollToken;
+
+/**
+ @brief  Stores reference on buffer into which reusable decoder decode messages.
+ */
+@property (nonatomic, strong) NSMutableData *scratch;
+
+/**
+ @brief  Stores whether poll identifier is \c UUID (binary representation stored in \c _pollUUID).
+ */
+@property (nonatomic, assign) BOOL hasPollUUID;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize encoder or decoder.
+
+ @param data           Reference on data which should be decoded or \c nil for encoder.
+ @param pollIdentifier Reference on identifier of the poll which should be replaced with token.
+ @param token          Reference on short poll token.
+
+ @return Initialized and ready to use coder.
+ */
+- (instancetype)initWithData:(NSData *)data forPoll:(NSString *)pollIdentifier
+                       token:(NSNumber *)token;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Read specified number of raw bytes.
+
+ @param length Number of bytes which should be read.
+
+ @return Pointer on first byte or \c NULL in case if there is not enough data.
+ */
+- (const uint8_t *)readBytes:(NSUInteger)length;
+
+/**
+ @brief  Read identifier.
+
+ @param allowToken Whether identifier can be replaced with poll token or not.
+
+ @return Decoded identifier or \c nil in case if it has been written as \c nil or token of unknown
+         poll.
+ */
+- (NSString *)decodeIdentifierAllowingToken:(BOOL)allowToken;
+
+/**
+ @brief  Decode base64 characters into decoder's buffer.
+
+ @param characters Pointer on ASCII base64 characters.
+ @param length     Number of characters.
+
+ @return \c NO in case if passed characters isn't valid base64 representation.
+ */
+- (BOOL)decodeBase64Characters:(const char *)characters length:(NSUInteger)length;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPCompactCoder
+
+
+#pragma mark - Information
+
++ (NSString *)formatName {
+
+    return [NSString stringWithFormat:@"compact/%@", @(kSPNPCompactFormatVersion)];
+}
+
++ (NSUInteger)formatVersion {
+
+    return kSPNPCompactFormatVersion;
+}
+
+- (NSData *)data {
+
+    return (self.buffer?: _data);
+}
+
+- (BOOL)isAtEnd {
+
+    return (self.offset >= self.data.length);
+}
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)encoderForPoll:(NSString *)pollIdentifier token:(NSNumber *)token {
+
+    return [[self alloc] initWithData:nil forPoll:pollIdentifier token:token];
+}
+
++ (instancetype)decoderWithData:(NSData *)data forPoll:(NSString *)pollIdentifier
+                          token:(NSNumber *)token {
+
+    return [[self alloc] initWithData:(data?: [NSData data]) forPoll:pollIdentifier token:token];
+}
+
+- (instancetype)initWithData:(NSData *)data forPoll:(NSString *)pollIdentifier
+                       token:(NSNumber *)token {
+
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+
+        _data = data;
+        _buffer = (data ? nil : [NSMutableData dataWithCapacity:32]);
+        _pollIdentifier = [pollIdentifier copy];
+        _pollToken = (pollIdentifier ? token : nil);
+        _valid = YES;
+        NSUUID *uuid = (pollIdentifier ? [[NSUUID alloc] initWithUUIDString:pollIdentifier] : nil);
+        if (uuid) {
+
+            [uuid getUUIDBytes:_pollUUID];
+            _hasPollUUID = YES;
+        }
+    }
+
+    return self;
+}
+
++ (instancetype)reusableDecoderForPoll:(NSString *)pollIdentifier token:(NSNumber *)token {
+
+    NSMutableData *scratch = [NSMutableData dataWithCapacity:kSPNPCompactMaximumInlineRepresentationLength];
+    SPNPCompactCoder *decoder = [[self alloc] initWithData:scratch forPoll:pollIdentifier token:token];
+    decoder.scratch = scratch;
+
+    return decoder;
+}
+
+- (BOOL)resetWithRepresentation:(NSString *)representation {
+
+    self.offset = 0;
+    self.valid = NO;
+    if (!self.scratch || ![representation isKindOfClass:NSString.class]) { return NO; }
+
+    NSUInteger length = representation.length;
+    const char *characters = CFStringGetCStringPtr((__bridge CFStringRef)representation,
+                                                   kCFStringEncodingASCII);
+    char inlineCharacters[kSPNPCompactMaximumInlineRepresentationLength + 1];
+    if (!characters && length <= kSPNPCompactMaximumInlineRepresentationLength &&
+        [representation getCString:inlineCharacters maxLength:sizeof(inlineCharacters)
+                          encoding:NSASCIIStringEncoding]) {
+
+        characters = inlineCharacters;
+    }
+
+    if (characters) { self.valid = [self decodeBase64Characters:characters length:length]; }
+    else {
+
+        NSData *payload = [[NSData alloc] initWithBase64EncodedString:representation options:0];
+        self.scratch.length = payload.length;
+        if (payload.length) { memcpy(self.scratch.mutableBytes, payload.bytes, payload.length); }
+        self.valid = (payload != nil);
+    }
+
+    return self.isValid;
+}
+
+- (BOOL)resetWithRepresentation:(NSString *)representation length:(NSUInteger)length {
+
+    self.offset = 0;
+    self.valid = NO;
+    if (!self.scratch || ![representation isKindOfClass:NSString.class]) { return NO; }
+
+    // Only whole quads can be decoded from the middle of representation.
+    length = MIN(length, representation.length);
+    if (length < representation.length) { length -= (length % 4); }
+    char characters[kSPNPCompactMaximumInlineRepresentationLength];
+    NSUInteger usedLength = 0;
+    if (length <= sizeof(characters) &&
+        [representation getBytes:characters maxLength:length usedLength:&usedLength
+                        encoding:NSASCIIStringEncoding options:0 range:NSMakeRange(0, length)
+                  remainingRange:NULL] && usedLength == length) {
+
+        self.valid = [self decodeBase64Characters:characters length:length];
+    }
+
+    return self.isValid;
+}
+
+
+#pragma mark - Encoding
+
+- (void)encodeUnsignedInteger:(uint64_t)value {
+
+    uint8_t bytes[10];
+    NSUInteger length = 0;
+    do {
+
+        uint8_t byte = (value & 0x7F);
+        value >>= 7;
+        bytes[length++] = (byte | (value ? 0x80 : 0x00));
+    } while (value);
+    [self.buffer appendBytes:bytes length:length];
+}
+
+- (void)encodeSignedInteger:(int64_t)value {
+
+    [self encodeUnsignedInteger:(((uint64_t)value << 1) ^ (uint64_t)(value >> 63))];
+}
+
+- (void)encodeNumber:(NSNumber *)number {
+
+    [self encodeUnsignedInteger:(number ? number.unsignedLongLongValue + 1 : 0)];
+}
+
+- (void)encodeBool:(BOOL)value {
+
+    uint8_t byte = (value ? 1 : 0);
+    [self.buffer appendBytes:&byte length:1];
+}
+
+- (void)encodeDouble:(double)value {
+
+    uint64_t bits = 0;
+    memcpy(&bits, &value, sizeof(double));
+    bits = CFSwapInt64HostToLittle(bits);
+    [self.buffer appendBytes:&bits length:sizeof(uint64_t)];
+}
+
+- (void)encodeString:(NSString *)string {
+
+    NSUInteger length = [string lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+    [self encodeUnsignedInteger:(string ? length + 1 : 0)];
+    if (length) { [self.buffer appendBytes:string.UTF8String length:length]; }
+}
+
+- (void)encodeIdentifier:(NSString *)identifier {
+
+    NSUUID *uuid = nil;
+    if (identifier && (uuid = [[NSUUID alloc] initWithUUIDString:identifier])) {
+
+        uuid_t bytes;
+        [uuid getUUIDBytes:bytes];
+        [self encodeUnsignedInteger:SPNPCompactPollUUID];
+        [self.buffer appendBytes:bytes length:sizeof(uuid_t)];
+    }
+    else if (identifier) {
+
+        [self encodeUnsignedInteger:SPNPCompactPollString];
+        [self encodeString:identifier];
+    }
+    else { [self encodeUnsignedInteger:SPNPCompactNoPollIdentifier]; }
+}
+
+- (void)encodePollIdentifier:(NSString *)identifier {
+
+    if (identifier && self.pollToken && [identifier isEqualToString:self.pollIdentifier]) {
+
+        [self encodeUnsignedInteger:SPNPCompactPollToken];
+        [self encodeUnsignedInteger:self.pollToken.unsignedLongLongValue];
+    }
+    else { [self encodeIdentifier:identifier]; }
+}
+
+- (void)encodeObjects:(NSArray *)objects {
+
+    [self encodeUnsignedInteger:(objects ? objects.count + 1 : 0)];
+    for (SPNPSerializable *object in objects) { [object encodeWithCompactCoder:self]; }
+}
+
+
+#pragma mark - Decoding
+
+- (uint64_t)decodeUnsignedInteger {
+
+    uint64_t value = 0;
+    NSUInteger shift = 0;
+    const uint8_t *byte = NULL;
+    do {
+
+        byte = [self readBytes:1];
+
+        // Tenth byte can carry only highest bit of the value, anything else overflows 64 bits.
+        if (byte && (shift < 63 || (shift == 63 && (*byte & 0x7E) == 0))) {
+
+            value |= ((uint64_t)(*byte & 0x7F) << shift);
+        }
+        else if (byte) { self.valid = NO; }
+        shift += 7;
+    } while (self.isValid && byte && (*byte & 0x80));
+
+    return (self.isValid ? value : 0);
+}
+
+- (int64_t)decodeSignedInteger {
+
+    uint64_t value = [self decodeUnsignedInteger];
+
+    return (int64_t)((value >> 1) ^ (~(value & 1) + 1));
+}
+
+- (NSNumber *)decodeNumber {
+
+    uint64_t value = [self decodeUnsignedInteger];
+
+    return (value ? @(value - 1) : nil);
+}
+
+- (BOOL)decodeBool {
+
+    const uint8_t *byte = [self readBytes:1];
+
+    return (byte && *byte != 0);
+}
+
+- (double)decodeDouble {
+
+    double value = 0.0f;
+    const uint8_t *bytes = [self readBytes:sizeof(uint64_t)];
+    if (bytes) {
+
+        uint64_t bits = 0;
+        memcpy(&bits, bytes, sizeof(uint64_t));
+        bits = CFSwapInt64LittleToHost(bits);
+        memcpy(&value, &bits, sizeof(double));
+    }
+
+    return value;
+}
+
+- (NSString *)decodeString {
+
+    NSString *string = nil;
+    uint64_t length = [self decodeUnsignedInteger];
+    if (length) {
+
+        const uint8_t *bytes = [self readBytes:(NSUInteger)(length - 1)];
+        if (bytes) {
+
+            string = [[NSString alloc] initWithBytes:bytes length:(NSUInteger)(length - 1)
+                                            encoding:NSUTF8StringEncoding];
+            if (!string) { self.valid = NO; }
+        }
+    }
+
+    return string;
+}
+
+- (NSString *)decodeIdentifier {
+
+    return [self decodeIdentifierAllowingToken:NO];
+}
+
+- (NSString *)decodePollIdentifier {
+
+    return [self decodeIdentifierAllowingToken:YES];
+}
+
+- (id)decodePollKey {
+
+    id key = nil;
+    SPNPCompactPollIdentifierType type = (SPNPCompactPollIdentifierType)[self decodeUnsignedInteger];
+    switch (type) {
+        case SPNPCompactNoPollIdentifier:
+            break;
+        case SPNPCompactPollToken:
+        {
+            uint64_t token = [self decodeUnsignedInteger];
+            if (self.isValid) { key = @(token); }
+        }
+            break;
+        case SPNPCompactPollUUID:
+        {
+            const uint8_t *bytes = [self readBytes:sizeof(uuid_t)];
+            if (bytes) { key = [[NSUUID alloc] initWithUUIDBytes:bytes].UUIDString; }
+        }
+            break;
+        case SPNPCompactPollString:
+            key = [self decodeString];
+            break;
+        default:
+            self.valid = NO;
+            break;
+    }
+
+    return key;
+}
+
+- (NSString *)decodeIdentifierAllowingToken:(BOOL)allowToken {
+
+    NSString *identifier = nil;
+    id key = [self decodePollKey];
+    if ([key isKindOfClass:NSNumber.class]) {
+
+        if (!allowToken) { self.valid = NO; }
+        else if (self.pollToken && [self.pollToken isEqualToNumber:key]) {
+
+            identifier = self.pollIdentifier;
+        }
+    }
+    else { identifier = key; }
+
+    return identifier;
+}
+
+- (NSArray *)decodeObjectsOfClass:(Class)objectClass {
+
+    NSMutableArray *objects = nil;
+    uint64_t count = [self decodeUnsignedInteger];
+    if (count > kSPNPCompactMaximumListLength + 1) { self.valid = NO; }
+    if (count && self.isValid) {
+
+        objects = [NSMutableArray arrayWithCapacity:(NSUInteger)(count - 1)];
+        for (uint64_t objectIdx = 0; objectIdx < count - 1 && self.isValid; objectIdx++) {
+
+            SPNPSerializable *object = [objectClass new];
+            [object decodeWithCompactCoder:self];
+            [objects addObject:object];
+        }
+    }
+
+    return (self.isValid ? [objects copy] : nil);
+}
+
+
+#pragma mark - Field projection
+
+- (BOOL)decodeNumberValue:(uint64_t *)value {
+
+    uint64_t number = [self decodeUnsignedInteger];
+    if (number && value) { *value = (number - 1); }
+
+    return (number != 0);
+}
+
+- (void)skipString {
+
+    uint64_t length = [self decodeUnsignedInteger];
+    if (length) { [self readBytes:(NSUInteger)(length - 1)]; }
+}
+
+- (BOOL)decodePollKeyMatchingPoll {
+
+    BOOL isMatching = NO;
+    SPNPCompactPollIdentifierType type = (SPNPCompactPollIdentifierType)[self decodeUnsignedInteger];
+    switch (type) {
+        case SPNPCompactNoPollIdentifier:
+            break;
+        case SPNPCompactPollToken:
+        {
+            uint64_t token = [self decodeUnsignedInteger];
+            isMatching = (self.isValid && self.pollToken &&
+                          token == self.pollToken.unsignedLongLongValue);
+        }
+            break;
+        case SPNPCompactPollUUID:
+        {
+            const uint8_t *bytes = [self readBytes:sizeof(uuid_t)];
+            isMatching = (bytes && self.hasPollUUID && memcmp(bytes, _pollUUID, sizeof(uuid_t)) == 0);
+        }
+            break;
+        case SPNPCompactPollString:
+        {
+            uint64_t length = [self decodeUnsignedInteger];
+            const uint8_t *bytes = (length ? [self readBytes:(NSUInteger)(length - 1)] : NULL);
+            const char *identifier = self.pollIdentifier.UTF8String;
+            isMatching = (bytes && identifier && strlen(identifier) == length - 1 &&
+                          memcmp(bytes, identifier, (size_t)(length - 1)) == 0);
+        }
+            break;
+        default:
+            self.valid = NO;
+            break;
+    }
+
+    return (self.isValid && isMatching);
+}
+
+- (const uint8_t *)decodeIdentifierBytesWithLength:(NSUInteger *)length isUUID:(BOOL *)isUUID {
+
+    const uint8_t *bytes = NULL;
+    NSUInteger bytesLength = 0;
+    SPNPCompactPollIdentifierType type = (SPNPCompactPollIdentifierType)[self decodeUnsignedInteger];
+    if (type == SPNPCompactPollUUID) {
+
+        bytesLength = sizeof(uuid_t);
+        bytes = [self readBytes:bytesLength];
+    }
+    else if (type == SPNPCompactPollString) {
+
+        uint64_t stringLength = [self decodeUnsignedInteger];
+        bytesLength = (NSUInteger)(stringLength ? stringLength - 1 : 0);
+        bytes = (stringLength ? [self readBytes:bytesLength] : NULL);
+    }
+    else if (type != SPNPCompactNoPollIdentifier) { self.valid = NO; }
+
+    if (length) { *length = (bytes ? bytesLength : 0); }
+    if (isUUID) { *isUUID = (type == SPNPCompactPollUUID); }
+
+    return bytes;
+}
+
+
+#pragma mark - Misc
+
+- (BOOL)decodeBase64Characters:(const char *)characters length:(NSUInteger)length {
+
+    static int8_t table[256];
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+
+        const char *alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        memset(table, -1, sizeof(table));
+        for (int8_t valueIdx = 0; valueIdx < 64; valueIdx++) { table[(uint8_t)alphabet[valueIdx]] = valueIdx; }
+    });
+
+    NSUInteger padding = 0;
+    while (padding < 2 && length > padding && characters[length - padding - 1] == '=') { padding++; }
+    if (length % 4 != 0) { return NO; }
+
+    self.scratch.length = (length / 4 * 3 - padding);
+    uint8_t *bytes = (uint8_t *)self.scratch.mutableBytes;
+    NSUInteger byteIdx = 0;
+    uint32_t accumulator = 0;
+    for (NSUInteger characterIdx = 0; characterIdx < length - padding; characterIdx++) {
+
+        int8_t value = table[(uint8_t)characters[characterIdx]];
+        if (value < 0) { return NO; }
+        accumulator = ((accumulator << 6) | (uint32_t)value);
+        if (characterIdx % 4 == 3) {
+
+            bytes[byteIdx++] = (uint8_t)(accumulator >> 16);
+            bytes[byteIdx++] = (uint8_t)(accumulator >> 8);
+            bytes[byteIdx++] = (uint8_t)accumulator;
+            accumulator = 0;
+        }
+    }
+
+    // Flush last incomplete quantum (2 or 3 characters).
+    NSUInteger tail = ((length - padding) % 4);
+    if (tail == 2) { bytes[byteIdx++] = (uint8_t)(accumulator >> 4); }
+    else if (tail == 3) {
+
+        bytes[byteIdx++] = (uint8_t)(accumulator >> 10);
+        bytes[byteIdx++] = (uint8_t)(accumulator >> 2);
+    }
+    else if (tail == 1) { return NO; }
+
+    return YES;
+}
+
+- (const uint8_t *)readBytes:(NSUInteger)length {
+
+    const uint8_t *bytes = NULL;
+    if (self.isValid && self.data.length - self.offset >= length) {
+
+        bytes = ((const uint8_t *)self.data.bytes + self.offset);
+        self.offset += length;
+    }
+    else { self.valid = NO; }
+
+    return bytes;
+}
+
+#pragma mark -
+
+
+@end
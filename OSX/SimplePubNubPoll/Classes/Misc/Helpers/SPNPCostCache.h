@@ -0,0 +1,112 @@
+#import <Foundation/Foundation.h>
+
+
+/**
+ @brief      Least recently used objects cache with cost budget.
+ @discussion Each object stored with cost (for example number of bytes used by bitmap) and least
+             recently used objects evicted as soon as total cost exceed \c costLimit. Lookup,
+             insertion and eviction done in constant time. Cache doesn't depend from platform
+             frameworks, so it can be used from any target.
+             Cache is not thread-safe and should be used from single queue.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPCostCache : NSObject
+
+
+///------------------------------------------------
+/// @name Configuration
+///------------------------------------------------
+
+/**
+ @brief      Stores maximum total cost of cached objects.
+ @discussion Decreased limit evict least recently used objects right away.
+ */
+@property (nonatomic, assign) NSUInteger costLimit;
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores number of cached objects.
+ */
+@property (nonatomic, readonly, assign) NSUInteger count;
+
+/**
+ @brief  Stores total cost of cached objects.
+ */
+@property (nonatomic, readonly, assign) NSUInteger totalCost;
+
+/**
+ @brief  Stores number of lookups which returned cached object.
+ */
+@property (nonatomic, readonly, assign) unsigned long long hitsCount;
+
+/**
+ @brief  Stores number of lookups for which there was no cached object.
+ */
+@property (nonatomic, readonly, assign) unsigned long long missesCount;
+
+/**
+ @brief  Stores number of objects which has been evicted because of cost limit.
+ */
+@property (nonatomic, readonly, assign) unsigned long long evictionsCount;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure cache.
+ 
+ @param costLimit Maximum total cost of cached objects.
+ 
+ @return Configured and ready to use cache.
+ */
++ (instancetype)cacheWithCostLimit:(NSUInteger)costLimit;
+
+
+///------------------------------------------------
+/// @name Objects
+///------------------------------------------------
+
+/**
+ @brief      Retrieve cached object.
+ @discussion Found object become most recently used.
+ 
+ @param key Reference on key with which object has been stored.
+ 
+ @return Cached object or \c nil in case if there is no object for \c key.
+ */
+- (id)objectForKey:(id<NSCopying>)key;
+
+/**
+ @brief      Store object in cache.
+ @discussion Object which cost exceed \c costLimit isn't stored.
+ 
+ @param object Reference on object which should be cached.
+ @param key    Reference on key with which object should be stored.
+ @param cost   Object's cost.
+ */
+- (void)setObject:(id)object forKey:(id<NSCopying>)key cost:(NSUInteger)cost;
+
+/**
+ @brief  Remove object from cache.
+ 
+ @param key Reference on key with which object has been stored.
+ */
+- (void)removeObjectForKey:(id<NSCopying>)key;
+
+/**
+ @brief  Remove all cached objects (hits, misses and evictions counters preserved).
+ */
+- (void)removeAllObjects;
+
+#pragma mark -
+
+
+@end
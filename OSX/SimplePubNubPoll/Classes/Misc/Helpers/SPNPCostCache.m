@@ -0,0 +1,242 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPCostCache.h"
+
+
+#pragma mark Types
+
+/**
+ @brief  Describes single cached object which is linked into recency list.
+ */
+@interface SPNPCostCacheEntry : NSObject
+
+
+#pragma mark - Properties
+
+@property (nonatomic, copy) id<NSCopying> key;
+@property (nonatomic, strong) id object;
+@property (nonatomic, assign) NSUInteger cost;
+
+/**
+ @brief  Stores reference on more recently used entry.
+ */
+@property (nonatomic, unsafe_unretained) SPNPCostCacheEntry *previous;
+
+/**
+ @brief  Stores reference on less recently used entry.
+ */
+@property (nonatomic, unsafe_unretained) SPNPCostCacheEntry *next;
+
+#pragma mark -
+
+
+@end
+
+
+@implementation SPNPCostCacheEntry
+@end
+
+
+#pragma mark - Private interface declaration
+
+@interface SPNPCostCache ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, assign) NSUInteger totalCost;
+@property (nonatomic, assign) unsigned long long hitsCount;
+@property (nonatomic, assign) unsigned long long missesCount;
+@property (nonatomic, assign) unsigned long long evictionsCount;
+
+/**
+ @brief      Stores reference on entries stored by their keys.
+ @discussion Dictionary is the only strong owner of entries.
+ */
+@property (nonatomic, strong) NSMutableDictionary *entries;
+
+/**
+ @brief  Stores reference on most recently used entry.
+ */
+@property (nonatomic, unsafe_unretained) SPNPCostCacheEntry *head;
+
+/**
+ @brief  Stores reference on least recently used entry.
+ */
+@property (nonatomic, unsafe_unretained) SPNPCostCacheEntry *tail;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize cache.
+ 
+ @param costLimit Maximum total cost of cached objects.
+ 
+ @return Initialized and ready to use cache.
+ */
+- (instancetype)initWithCostLimit:(NSUInteger)costLimit;
+
+
+#pragma mark - Recency list
+
+/**
+ @brief  Insert entry at the head of recency list.
+ 
+ @param entry Reference on entry which should become most recently used.
+ */
+- (void)linkEntry:(SPNPCostCacheEntry *)entry;
+
+/**
+ @brief  Remove entry from recency list.
+ 
+ @param entry Reference on entry which should be removed.
+ */
+- (void)unlinkEntry:(SPNPCostCacheEntry *)entry;
+
+/**
+ @brief  Evict least recently used entries till total cost fit into \c costLimit.
+ */
+- (void)trimToCostLimit;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPCostCache
+
+
+#pragma mark - Information
+
+- (NSUInteger)count {
+    
+    return self.entries.count;
+}
+
+
+#pragma mark - Configuration
+
+- (void)setCostLimit:(NSUInteger)costLimit {
+    
+    _costLimit = costLimit;
+    [self trimToCostLimit];
+}
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)cacheWithCostLimit:(NSUInteger)costLimit {
+    
+    return [[self alloc] initWithCostLimit:costLimit];
+}
+
+- (instancetype)initWithCostLimit:(NSUInteger)costLimit {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _costLimit = costLimit;
+        _entries = [NSMutableDictionary new];
+    }
+    
+    return self;
+}
+
+
+#pragma mark - Objects
+
+- (id)objectForKey:(id<NSCopying>)key {
+    
+    SPNPCostCacheEntry *entry = (key ? self.entries[key] : nil);
+    if (entry) {
+        
+        self.hitsCount++;
+        if (entry != self.head) {
+            
+            [self unlinkEntry:entry];
+            [self linkEntry:entry];
+        }
+    }
+    else { self.missesCount++; }
+    
+    return entry.object;
+}
+
+- (void)setObject:(id)object forKey:(id<NSCopying>)key cost:(NSUInteger)cost {
+    
+    if (!key) { return; }
+    
+    [self removeObjectForKey:key];
+    if (object && cost <= self.costLimit) {
+        
+        SPNPCostCacheEntry *entry = [SPNPCostCacheEntry new];
+        entry.key = key;
+        entry.object = object;
+        entry.cost = cost;
+        self.entries[key] = entry;
+        [self linkEntry:entry];
+        self.totalCost += cost;
+        [self trimToCostLimit];
+    }
+}
+
+- (void)removeObjectForKey:(id<NSCopying>)key {
+    
+    SPNPCostCacheEntry *entry = (key ? self.entries[key] : nil);
+    if (entry) {
+        
+        [self unlinkEntry:entry];
+        self.totalCost -= entry.cost;
+        [self.entries removeObjectForKey:key];
+    }
+}
+
+- (void)removeAllObjects {
+    
+    self.head = nil;
+    self.tail = nil;
+    self.totalCost = 0;
+    [self.entries removeAllObjects];
+}
+
+
+#pragma mark - Recency list
+
+- (void)linkEntry:(SPNPCostCacheEntry *)entry {
+    
+    entry.previous = nil;
+    entry.next = self.head;
+    self.head.previous = entry;
+    self.head = entry;
+    if (!self.tail) { self.tail = entry; }
+}
+
+- (void)unlinkEntry:(SPNPCostCacheEntry *)entry {
+    
+    if (entry.previous) { entry.previous.next = entry.next; }
+    else { self.head = entry.next; }
+    if (entry.next) { entry.next.previous = entry.previous; }
+    else { self.tail = entry.previous; }
+    entry.previous = nil;
+    entry.next = nil;
+}
+
+- (void)trimToCostLimit {
+    
+    while (self.totalCost > self.costLimit && self.tail) {
+        
+        self.evictionsCount++;
+        [self removeObjectForKey:self.tail.key];
+    }
+}
+
+#pragma mark -
+
+
+@end
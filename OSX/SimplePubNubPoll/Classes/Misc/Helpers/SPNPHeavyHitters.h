@@ -0,0 +1,95 @@
+#import <Foundation/Foundation.h>
+
+
+/**
+ @brief      Streaming top-K counter of most frequent items.
+ @discussion Counter use Space-Saving algorithm: not more than \c capacity items tracked at once and
+             when untracked item arrive it replace item with smallest count (new item inherit that
+             count as overestimation error). Because of this memory usage doesn't depend from number
+             of distinct items in stream, while any item which has been seen more than 
+             \c maximumError times guaranteed to be tracked. Each tracked item report \c count which
+             never lower than real one and \c error: real count is in [count - error, count] range.
+             Tracked items stored in min-heap, so each item update take logarithmic time.
+             Counter is not thread-safe and should be used from single queue.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPHeavyHitters : NSObject
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores maximum number of items which can be tracked at once.
+ */
+@property (nonatomic, readonly, assign) NSUInteger capacity;
+
+/**
+ @brief  Stores number of items which currently tracked.
+ */
+@property (nonatomic, readonly, assign) NSUInteger trackedCount;
+
+/**
+ @brief  Stores overall number of items which has been added to counter.
+ */
+@property (nonatomic, readonly, assign) unsigned long long totalCount;
+
+/**
+ @brief      Stores maximum overestimation of tracked items count.
+ @discussion Equal to \c totalCount / \c capacity. Items which has been seen more times than this
+             value never evicted.
+ */
+@property (nonatomic, readonly, assign) unsigned long long maximumError;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure top-K counter.
+ 
+ @param capacity Maximum number of items which can be tracked at once (larger capacity give
+                 smaller counting error).
+ 
+ @return Configured and ready to use counter.
+ */
++ (instancetype)heavyHittersWithCapacity:(NSUInteger)capacity;
+
+
+///------------------------------------------------
+/// @name Counting
+///------------------------------------------------
+
+/**
+ @brief  Count item occurrence.
+ 
+ @param item Reference on item which has been seen in stream.
+ */
+- (void)addItem:(NSString *)item;
+
+/**
+ @brief  Enumerate most frequent items.
+ 
+ @param count Maximum number of items which should be enumerated.
+ @param block Reference on block which is called for each item (ordered by count from largest). 
+              Block pass four arguments: \c item - counted item; \c itemCount - estimated number of
+              item occurrences; \c error - maximum overestimation of \c itemCount; \c stop - 
+              reference on flag which allow to stop enumeration.
+ */
+- (void)enumerateTopItems:(NSUInteger)count
+               usingBlock:(void(^)(NSString *item, unsigned long long itemCount,
+                                   unsigned long long error, BOOL *stop))block;
+
+/**
+ @brief  Remove all tracked items and reset counts.
+ */
+- (void)reset;
+
+#pragma mark -
+
+
+@end
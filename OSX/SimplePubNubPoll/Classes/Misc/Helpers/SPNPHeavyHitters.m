@@ -0,0 +1,274 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPHeavyHitters.h"
+
+
+#pragma mark Types
+
+/**
+ @brief  Describes single tracked item.
+ */
+@interface SPNPHeavyHittersEntry : NSObject
+
+
+#pragma mark - Properties
+
+@property (nonatomic, copy) NSString *item;
+@property (nonatomic, assign) unsigned long long count;
+@property (nonatomic, assign) unsigned long long error;
+
+/**
+ @brief  Stores entry position in min-heap.
+ */
+@property (nonatomic, assign) NSUInteger heapIndex;
+
+#pragma mark -
+
+
+@end
+
+
+@implementation SPNPHeavyHittersEntry
+@end
+
+
+#pragma mark - Private interface declaration
+
+@interface SPNPHeavyHitters ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, assign) NSUInteger capacity;
+@property (nonatomic, assign) unsigned long long totalCount;
+
+/**
+ @brief  Stores reference on tracked entries ordered as min-heap by count.
+ */
+@property (nonatomic, strong) NSMutableArray *heap;
+
+/**
+ @brief  Stores reference on tracked entries stored by their items.
+ */
+@property (nonatomic, strong) NSMutableDictionary *entries;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize top-K counter.
+ 
+ @param capacity Maximum number of items which can be tracked at once.
+ 
+ @return Initialized and ready to use counter.
+ */
+- (instancetype)initWithCapacity:(NSUInteger)capacity;
+
+
+#pragma mark - Heap
+
+/**
+ @brief  Move entry towards heap root while it's count is smaller than parent's count.
+ 
+ @param index Index of entry which count has been decreased or which has been appended.
+ */
+- (void)siftUpFromIndex:(NSUInteger)index;
+
+/**
+ @brief  Move entry towards heap leaves while it's count is larger than children's count.
+ 
+ @param index Index of entry which count has been increased.
+ */
+- (void)siftDownFromIndex:(NSUInteger)index;
+
+/**
+ @brief  Retrieve count of entry in heap.
+ 
+ @param index Index of entry in heap.
+ 
+ @return Entry's item count.
+ */
+- (unsigned long long)countAtIndex:(NSUInteger)index;
+
+/**
+ @brief  Swap entries in heap and update their positions.
+ 
+ @param index      Index of first entry.
+ @param otherIndex Index of second entry.
+ */
+- (void)swapEntryAtIndex:(NSUInteger)index withEntryAtIndex:(NSUInteger)otherIndex;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPHeavyHitters
+
+
+#pragma mark - Information
+
+- (NSUInteger)trackedCount {
+    
+    return self.heap.count;
+}
+
+- (unsigned long long)maximumError {
+    
+    return (self.totalCount / self.capacity);
+}
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)heavyHittersWithCapacity:(NSUInteger)capacity {
+    
+    return [[self alloc] initWithCapacity:capacity];
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _capacity = MAX(capacity, (NSUInteger)1);
+        _heap = [NSMutableArray arrayWithCapacity:_capacity];
+        _entries = [NSMutableDictionary dictionaryWithCapacity:_capacity];
+    }
+    
+    return self;
+}
+
+
+#pragma mark - Counting
+
+- (void)addItem:(NSString *)item {
+    
+    if (!item) { return; }
+    
+    self.totalCount++;
+    SPNPHeavyHittersEntry *entry = self.entries[item];
+    if (entry) {
+        
+        entry.count++;
+        [self siftDownFromIndex:entry.heapIndex];
+    }
+    else if (self.heap.count < self.capacity) {
+        
+        entry = [SPNPHeavyHittersEntry new];
+        entry.item = item;
+        entry.count = 1;
+        entry.heapIndex = self.heap.count;
+        self.entries[entry.item] = entry;
+        [self.heap addObject:entry];
+        [self siftUpFromIndex:entry.heapIndex];
+    }
+    else {
+        
+        // Item with smallest count replaced and new item inherit it's count as possible error.
+        entry = self.heap.firstObject;
+        [self.entries removeObjectForKey:entry.item];
+        entry.item = item;
+        entry.error = entry.count;
+        entry.count++;
+        self.entries[entry.item] = entry;
+        [self siftDownFromIndex:0];
+    }
+}
+
+- (void)enumerateTopItems:(NSUInteger)count
+               usingBlock:(void(^)(NSString *item, unsigned long long itemCount,
+                                   unsigned long long error, BOOL *stop))block {
+    
+    NSArray *entries = [self.heap sortedArrayUsingComparator:^NSComparisonResult(id object1,
+                                                                                 id object2) {
+        
+        SPNPHeavyHittersEntry *entry1 = object1;
+        SPNPHeavyHittersEntry *entry2 = object2;
+        
+        if (entry1.count != entry2.count) {
+            
+            return (entry1.count > entry2.count ? NSOrderedAscending : NSOrderedDescending);
+        }
+        
+        // Items with same count ordered by guaranteed count and then alphabetically, so same state
+        // always enumerated in same order.
+        if (entry1.error != entry2.error) {
+            
+            return (entry1.error < entry2.error ? NSOrderedAscending : NSOrderedDescending);
+        }
+        
+        return [entry1.item compare:entry2.item];
+    }];
+    BOOL stop = NO;
+    for (NSUInteger entryIdx = 0; entryIdx < MIN(count, entries.count) && !stop; entryIdx++) {
+        
+        SPNPHeavyHittersEntry *entry = entries[entryIdx];
+        block(entry.item, entry.count, entry.error, &stop);
+    }
+}
+
+- (void)reset {
+    
+    self.totalCount = 0;
+    [self.heap removeAllObjects];
+    [self.entries removeAllObjects];
+}
+
+
+#pragma mark - Heap
+
+- (void)siftUpFromIndex:(NSUInteger)index {
+    
+    while (index > 0) {
+        
+        NSUInteger parentIdx = ((index - 1) / 2);
+        if ([self countAtIndex:parentIdx] <= [self countAtIndex:index]) { break; }
+        [self swapEntryAtIndex:index withEntryAtIndex:parentIdx];
+        index = parentIdx;
+    }
+}
+
+- (void)siftDownFromIndex:(NSUInteger)index {
+    
+    NSUInteger count = self.heap.count;
+    while (YES) {
+        
+        NSUInteger smallestIdx = index;
+        NSUInteger leftIdx = (2 * index + 1);
+        NSUInteger rightIdx = (leftIdx + 1);
+        if (leftIdx < count && [self countAtIndex:leftIdx] < [self countAtIndex:smallestIdx]) {
+            
+            smallestIdx = leftIdx;
+        }
+        if (rightIdx < count && [self countAtIndex:rightIdx] < [self countAtIndex:smallestIdx]) {
+            
+            smallestIdx = rightIdx;
+        }
+        if (smallestIdx == index) { break; }
+        [self swapEntryAtIndex:index withEntryAtIndex:smallestIdx];
+        index = smallestIdx;
+    }
+}
+
+- (unsigned long long)countAtIndex:(NSUInteger)index {
+    
+    return ((SPNPHeavyHittersEntry *)self.heap[index]).count;
+}
+
+- (void)swapEntryAtIndex:(NSUInteger)index withEntryAtIndex:(NSUInteger)otherIndex {
+    
+    [self.heap exchangeObjectAtIndex:index withObjectAtIndex:otherIndex];
+    ((SPNPHeavyHittersEntry *)self.heap[index]).heapIndex = index;
+    ((SPNPHeavyHittersEntry *)self.heap[otherIndex]).heapIndex = otherIndex;
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,93 @@
+#import <Foundation/Foundation.h>
+
+
+/**
+ @brief      Fixed-size sketch which estimate number of unique identifiers.
+ @discussion Sketch store only maximum leading zeros rank for each of \c 2^precision registers 
+             (\b HyperLogLog), so memory usage doesn't depend from number of added identifiers
+             (4 KB with default precision and ~1.6% standard error).
+             Sketch is not thread-safe and should be used from single queue.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPHyperLogLog : NSObject
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores number of index bits (number of sketch registers is \c 2^precision).
+ */
+@property (nonatomic, readonly, assign) NSUInteger precision;
+
+/**
+ @brief  Stores number of bytes which is used by sketch registers.
+ */
+@property (nonatomic, readonly, assign) NSUInteger memoryUsage;
+
+/**
+ @brief      Stores estimated number of unique identifiers which has been added to sketch.
+ @discussion Estimation cached and recomputed only after registers change.
+ */
+@property (nonatomic, readonly, assign) unsigned long long estimatedCount;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure sketch with default precision (\c 12).
+ 
+ @return Configured and ready to use sketch.
+ */
++ (instancetype)sketch;
+
+/**
+ @brief  Create and configure sketch.
+ 
+ @param precision Number of index bits (clamped to \c 4 - \c 16 range).
+ 
+ @return Configured and ready to use sketch.
+ */
++ (instancetype)sketchWithPrecision:(NSUInteger)precision;
+
+
+///------------------------------------------------
+/// @name Estimation
+///------------------------------------------------
+
+/**
+ @brief  Add identifier to sketch.
+ 
+ @param key Well mixed 64-bit identifier fingerprint (for example computed with 
+            \b SPNPVoterIndex \c +keyForVoter:).
+ 
+ @return \c YES in case if sketch registers has been changed (estimation may change).
+ */
+- (BOOL)addKey:(uint64_t)key;
+
+/**
+ @brief      Merge identifiers which has been added to other sketch.
+ @discussion Merge keep maximum rank of each register, so it is idempotent, commutative and
+             associative: sketches of several nodes merged in any order estimate number of unique
+             identifiers seen by all of them.
+ 
+ @param sketch Reference on sketch which identifiers should be merged (should have same precision).
+ 
+ @return \c YES in case if sketch registers has been changed (estimation may change).
+ */
+- (BOOL)mergeSketch:(SPNPHyperLogLog *)sketch;
+
+/**
+ @brief  Remove all identifiers from sketch.
+ */
+- (void)reset;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,195 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPHyperLogLog.h"
+#import <math.h>
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores default number of index bits.
+ */
+static NSUInteger const kSPNPHyperLogLogDefaultPrecision = 12;
+
+
+#pragma mark - Private interface declaration
+
+@interface SPNPHyperLogLog ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, assign) NSUInteger precision;
+@property (nonatomic, assign) unsigned long long estimatedCount;
+
+/**
+ @brief  Stores number of sketch registers.
+ */
+@property (nonatomic, assign) NSUInteger registersCount;
+
+/**
+ @brief  Stores reference on registers with maximum leading zeros rank.
+ */
+@property (nonatomic, assign) uint8_t *registers;
+
+/**
+ @brief  Stores whether registers has been changed since last estimation.
+ */
+@property (nonatomic, assign, getter = isEstimationOutdated) BOOL estimationOutdated;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize sketch.
+ 
+ @param precision Number of index bits.
+ 
+ @return Initialized and ready to use sketch.
+ */
+- (instancetype)initWithPrecision:(NSUInteger)precision;
+
+
+#pragma mark - Estimation
+
+/**
+ @brief  Compute estimated number of unique identifiers from registers.
+ 
+ @return Estimated number of unique identifiers.
+ */
+- (unsigned long long)estimate;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPHyperLogLog
+
+
+#pragma mark - Information
+
+- (NSUInteger)memoryUsage {
+    
+    return (self.registersCount * sizeof(uint8_t));
+}
+
+- (unsigned long long)estimatedCount {
+    
+    if (self.isEstimationOutdated) {
+        
+        _estimatedCount = [self estimate];
+        self.estimationOutdated = NO;
+    }
+    
+    return _estimatedCount;
+}
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)sketch {
+    
+    return [self sketchWithPrecision:kSPNPHyperLogLogDefaultPrecision];
+}
+
++ (instancetype)sketchWithPrecision:(NSUInteger)precision {
+    
+    return [[self alloc] initWithPrecision:MIN(MAX(precision, 4), 16)];
+}
+
+- (instancetype)initWithPrecision:(NSUInteger)precision {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _precision = precision;
+        _registersCount = ((NSUInteger)1 << precision);
+        _registers = calloc(_registersCount, sizeof(uint8_t));
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    
+    free(_registers);
+}
+
+
+#pragma mark - Estimation
+
+- (BOOL)addKey:(uint64_t)key {
+    
+    // High bits used as register index and rank computed from the rest of the key.
+    NSUInteger registerIdx = (NSUInteger)(key >> (64 - self.precision));
+    uint64_t remainder = (key << self.precision);
+    uint8_t rank = (uint8_t)(remainder ? __builtin_clzll(remainder) + 1 : 64 - self.precision + 1);
+    BOOL isChanged = (rank > self.registers[registerIdx]);
+    if (isChanged) {
+        
+        self.registers[registerIdx] = rank;
+        self.estimationOutdated = YES;
+    }
+    
+    return isChanged;
+}
+
+- (BOOL)mergeSketch:(SPNPHyperLogLog *)sketch {
+    
+    if (!sketch || sketch.precision != self.precision) { return NO; }
+    
+    BOOL isChanged = NO;
+    for (NSUInteger registerIdx = 0; registerIdx < self.registersCount; registerIdx++) {
+        
+        if (sketch.registers[registerIdx] > self.registers[registerIdx]) {
+            
+            self.registers[registerIdx] = sketch.registers[registerIdx];
+            isChanged = YES;
+        }
+    }
+    if (isChanged) { self.estimationOutdated = YES; }
+    
+    return isChanged;
+}
+
+- (void)reset {
+    
+    memset(self.registers, 0, self.registersCount * sizeof(uint8_t));
+    _estimatedCount = 0;
+    self.estimationOutdated = NO;
+}
+
+- (unsigned long long)estimate {
+    
+    double registersCount = (double)self.registersCount;
+    double sum = 0.0;
+    NSUInteger emptyRegistersCount = 0;
+    for (NSUInteger registerIdx = 0; registerIdx < self.registersCount; registerIdx++) {
+        
+        uint8_t rank = self.registers[registerIdx];
+        sum += ldexp(1.0, -(int)rank);
+        if (rank == 0) { emptyRegistersCount++; }
+    }
+    
+    double alpha = 0.7213 / (1.0 + 1.079 / registersCount);
+    double estimate = (alpha * registersCount * registersCount / sum);
+    
+    // Linear counting gives better estimation while there is many empty registers.
+    if (estimate <= 2.5 * registersCount && emptyRegistersCount) {
+        
+        estimate = (registersCount * log(registersCount / (double)emptyRegistersCount));
+    }
+    
+    return (unsigned long long)llround(estimate);
+}
+
+#pragma mark -
+
+
+@end
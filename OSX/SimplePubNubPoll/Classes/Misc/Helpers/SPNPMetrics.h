@@ -0,0 +1,204 @@
+#import <Foundation/Foundation.h>
+
+
+#pragma mark Types
+
+/**
+ @brief  Counters which is tracked by metrics.
+ */
+typedef NS_ENUM(NSUInteger, SPNPMetricsCounter) {
+    
+    /**
+     @brief  Number of messages which has been received from transport.
+     */
+    SPNPReceivedMessagesCounter,
+    
+    /**
+     @brief  Number of attendee votes which has been counted by host.
+     */
+    SPNPCountedVotesCounter,
+    
+    /**
+     @brief  Number of attendee votes which has been dropped by host because they can't be 
+             attributed to the voter.
+     */
+    SPNPDroppedVotesCounter,
+    
+    /**
+     @brief  Number of attendee votes which has been counted by host without voter tracking because
+             voters index is full (repeated votes of such voters can't be detected).
+     */
+    SPNPUntrackedVotesCounter,
+    
+    /**
+     @brief  Number of statistic updates which has been published by host.
+     */
+    SPNPPublishedStatisticsCounter,
+    
+    /**
+     @brief  Number of statistic updates which host failed to publish.
+     */
+    SPNPFailedPublishesCounter,
+    
+    /**
+     @brief  Number of poll statistic key-value observing notifications which has been sent by
+             manager.
+     */
+    SPNPObserverNotificationsCounter,
+    SPNPMetricsCountersCount
+};
+
+/**
+ @brief  Operations which duration is tracked by metrics.
+ */
+typedef NS_ENUM(NSUInteger, SPNPMetricsLatency) {
+    
+    /**
+     @brief  Time required to decode single model object from received message.
+     */
+    SPNPMessageDecodeLatency,
+    
+    /**
+     @brief  Time required to parse and count single batch of attendee votes.
+     */
+    SPNPVotesAggregationLatency,
+    
+    /**
+     @brief  Time between statistic publish request and transport's completion.
+     */
+    SPNPStatisticPublishLatency,
+    
+    /**
+     @brief  Time required to restore statistic or recover votes from history.
+     */
+    SPNPHistoryRestoreLatency,
+    
+    /**
+     @brief  Time spent by key-value observers to handle single poll statistic change
+             notification.
+     */
+    SPNPObserverNotificationLatency,
+    
+    /**
+     @brief  Time between attendee's vote submission and moment when statistic which include it has
+             been shown to attendee (sampled votes only).
+     */
+    SPNPVoteVisibleLatency,
+    
+    /**
+     @brief  Time between sampled vote receipt by host and moment when it has been counted.
+     */
+    SPNPVoteIngestLatency,
+    
+    /**
+     @brief  Time between moment when host counted sampled vote and statistic publish.
+     */
+    SPNPVotePublishIntervalLatency,
+    
+    /**
+     @brief  Part of sampled vote visible latency which has been spent by transport (both 
+             directions).
+     */
+    SPNPVoteTransportLatency,
+    SPNPMetricsLatenciesCount
+};
+
+
+/**
+ @brief      Lock-free instrumentation of poll manager hot paths.
+ @discussion Metrics consist of counters and fixed-bucket latency histograms (power of two
+             nanoseconds buckets). Recording is single relaxed atomic operation for counter and few
+             for latency, so metrics can be used from any thread and stay enabled in production.
+             Snapshot report latencies in microseconds with percentiles estimated from buckets.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPMetrics : NSObject
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure metrics.
+ 
+ @return Configured and ready to use metrics with zeroed counters and histograms.
+ */
++ (instancetype)metrics;
+
+
+///------------------------------------------------
+/// @name Recording
+///------------------------------------------------
+
+/**
+ @brief  Retrieve current time which should be used as start of tracked operation.
+ 
+ @return Monotonic time in host time units.
+ */
++ (uint64_t)currentTime;
+
+/**
+ @brief  Increase counter value.
+ 
+ @param counter One of \b SPNPMetricsCounter fields.
+ @param value   Value which should be added to counter.
+ */
+- (void)incrementCounter:(SPNPMetricsCounter)counter by:(uint64_t)value;
+
+/**
+ @brief  Record duration of operation which has been started at specified time.
+ 
+ @param latency   One of \b SPNPMetricsLatency fields.
+ @param startTime Value returned by \c +currentTime when operation started.
+ */
+- (void)recordLatency:(SPNPMetricsLatency)latency since:(uint64_t)startTime;
+
+/**
+ @brief  Record duration of operation which has been measured by other means.
+ 
+ @param latency  One of \b SPNPMetricsLatency fields.
+ @param duration Operation duration in seconds.
+ */
+- (void)recordLatency:(SPNPMetricsLatency)latency withDuration:(NSTimeInterval)duration;
+
+/**
+ @brief  Zero all counters and histograms.
+ */
+- (void)reset;
+
+
+///------------------------------------------------
+/// @name Snapshot
+///------------------------------------------------
+
+/**
+ @brief      Retrieve current metrics values.
+ @discussion Snapshot contains \c time (seconds since 1970), \c counters (value for each counter
+             name) and \c latencies (\c count, \c mean, \c p50, \c p90, \c p99 and \c max in
+             microseconds for each operation name).
+ 
+ @return \b JSON compatible dictionary with metrics values.
+ */
+- (NSDictionary *)snapshot;
+
+/**
+ @brief      Start periodic snapshots dump.
+ @discussion Each snapshot appended to the file as separate \b JSON line (NDJSON).
+ 
+ @param path     Full path to the file into which snapshots should be appended.
+ @param interval Interval between snapshots.
+ */
+- (void)startDumpingToFileAtPath:(NSString *)path withInterval:(NSTimeInterval)interval;
+
+/**
+ @brief  Stop periodic snapshots dump.
+ */
+- (void)stopDumping;
+
+#pragma mark -
+
+
+@end
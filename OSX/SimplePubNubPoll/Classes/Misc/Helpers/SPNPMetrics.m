@@ -0,0 +1,343 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPMetrics.h"
+#import <mach/mach_time.h>
+#import <stdatomic.h>
+
+
+#pragma mark Static
+
+/**
+ @brief      Stores number of latency histogram buckets.
+ @discussion Bucket \c N store durations in [2^(N-1), 2^N) nanoseconds range, so last bucket
+             collect everything longer than ~4.5 minutes.
+ */
+#define kSPNPMetricsBucketsCount 40
+
+/**
+ @brief  Stores names which is used for counters in snapshot.
+ */
+static NSString * const kSPNPMetricsCounterNames[SPNPMetricsCountersCount] = {
+    @"receivedMessages", @"countedVotes", @"droppedVotes", @"untrackedVotes",
+    @"publishedStatistics", @"failedPublishes", @"observerNotifications"
+};
+
+/**
+ @brief  Stores names which is used for latency histograms in snapshot.
+ */
+static NSString * const kSPNPMetricsLatencyNames[SPNPMetricsLatenciesCount] = {
+    @"messageDecode", @"votesAggregation", @"statisticPublish", @"historyRestore",
+    @"observerNotification", @"voteVisible", @"voteIngest", @"votePublishInterval",
+    @"voteTransport"
+};
+
+/**
+ @brief  Stores host time units to nanoseconds conversion ratio.
+ */
+static mach_timebase_info_data_t kSPNPMetricsTimebase;
+
+
+#pragma mark - Types
+
+/**
+ @brief  Describes latency histogram which can be updated from any thread.
+ */
+typedef struct {
+    
+    _Atomic(uint64_t) buckets[kSPNPMetricsBucketsCount];
+    _Atomic(uint64_t) sum;
+    _Atomic(uint64_t) maximum;
+} SPNPMetricsHistogram;
+
+
+#pragma mark - Private interface declaration
+
+@interface SPNPMetrics () {
+    
+    /**
+     @brief  Stores counter values.
+     */
+    _Atomic(uint64_t) _counters[SPNPMetricsCountersCount];
+    
+    /**
+     @brief  Stores latency histograms.
+     */
+    SPNPMetricsHistogram _histograms[SPNPMetricsLatenciesCount];
+}
+
+
+#pragma mark - Properties
+
+/**
+ @brief  Stores reference on serial queue on which snapshots dumped.
+ */
+@property (nonatomic, strong) dispatch_queue_t queue;
+
+/**
+ @brief  Stores reference on timer which trigger snapshots dump.
+ */
+@property (nonatomic, strong) dispatch_source_t dumpTimer;
+
+/**
+ @brief      Stores reference on file into which snapshots appended.
+ @discussion Property accessed only from thread which control dump, timer handler capture file.
+ */
+@property (nonatomic, strong) NSFileHandle *dumpFile;
+
+
+#pragma mark - Recording
+
+/**
+ @brief  Store operation duration in histogram.
+ 
+ @param duration  Operation duration in nanoseconds.
+ @param histogram Reference on histogram which should be updated.
+ */
+- (void)recordDuration:(uint64_t)duration inHistogram:(SPNPMetricsHistogram *)histogram;
+
+
+#pragma mark - Snapshot
+
+/**
+ @brief  Compose snapshot of single latency histogram.
+ 
+ @param histogram Reference on histogram from which values should be taken.
+ 
+ @return \b JSON compatible dictionary with histogram values in microseconds.
+ */
+- (NSDictionary *)snapshotOfHistogram:(SPNPMetricsHistogram *)histogram;
+
+/**
+ @brief  Append snapshot as \b JSON line to the file.
+ 
+ @param snapshot Reference on snapshot which should be written.
+ @param file     Reference on file into which snapshot should be appended.
+ */
++ (void)dumpSnapshot:(NSDictionary *)snapshot toFile:(NSFileHandle *)file;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPMetrics
+
+
+#pragma mark - Initialization and Configuration
+
++ (void)initialize {
+    
+    if (self == [SPNPMetrics class]) { mach_timebase_info(&kSPNPMetricsTimebase); }
+}
+
++ (instancetype)metrics {
+    
+    return [self new];
+}
+
+- (instancetype)init {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _queue = dispatch_queue_create("com.pubnub.poll.metrics", DISPATCH_QUEUE_SERIAL);
+        [self reset];
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    
+    if (_dumpTimer) { dispatch_source_cancel(_dumpTimer); }
+}
+
+
+#pragma mark - Recording
+
++ (uint64_t)currentTime {
+    
+    return mach_absolute_time();
+}
+
+- (void)incrementCounter:(SPNPMetricsCounter)counter by:(uint64_t)value {
+    
+    if (counter < SPNPMetricsCountersCount) {
+        
+        atomic_fetch_add_explicit(&_counters[counter], value, memory_order_relaxed);
+    }
+}
+
+- (void)recordLatency:(SPNPMetricsLatency)latency since:(uint64_t)startTime {
+    
+    if (latency >= SPNPMetricsLatenciesCount) { return; }
+    
+    uint64_t time = mach_absolute_time();
+    uint64_t duration = (time > startTime ? time - startTime : 0);
+    duration = (duration * kSPNPMetricsTimebase.numer / kSPNPMetricsTimebase.denom);
+    [self recordDuration:duration inHistogram:&_histograms[latency]];
+}
+
+- (void)recordLatency:(SPNPMetricsLatency)latency withDuration:(NSTimeInterval)duration {
+    
+    if (latency < SPNPMetricsLatenciesCount) {
+        
+        [self recordDuration:(uint64_t)(MAX(duration, 0.0f) * NSEC_PER_SEC)
+                 inHistogram:&_histograms[latency]];
+    }
+}
+
+- (void)recordDuration:(uint64_t)duration inHistogram:(SPNPMetricsHistogram *)histogram {
+    
+    NSUInteger bucketIdx = (duration ? (NSUInteger)(64 - __builtin_clzll(duration)) : 0);
+    bucketIdx = MIN(bucketIdx, (NSUInteger)(kSPNPMetricsBucketsCount - 1));
+    
+    atomic_fetch_add_explicit(&histogram->buckets[bucketIdx], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&histogram->sum, duration, memory_order_relaxed);
+    uint64_t maximum = atomic_load_explicit(&histogram->maximum, memory_order_relaxed);
+    while (duration > maximum &&
+           !atomic_compare_exchange_weak_explicit(&histogram->maximum, &maximum, duration,
+                                                  memory_order_relaxed, memory_order_relaxed));
+}
+
+- (void)reset {
+    
+    for (NSUInteger counterIdx = 0; counterIdx < SPNPMetricsCountersCount; counterIdx++) {
+        
+        atomic_store_explicit(&_counters[counterIdx], 0, memory_order_relaxed);
+    }
+    for (NSUInteger latencyIdx = 0; latencyIdx < SPNPMetricsLatenciesCount; latencyIdx++) {
+        
+        SPNPMetricsHistogram *histogram = &_histograms[latencyIdx];
+        for (NSUInteger bucketIdx = 0; bucketIdx < kSPNPMetricsBucketsCount; bucketIdx++) {
+            
+            atomic_store_explicit(&histogram->buckets[bucketIdx], 0, memory_order_relaxed);
+        }
+        atomic_store_explicit(&histogram->sum, 0, memory_order_relaxed);
+        atomic_store_explicit(&histogram->maximum, 0, memory_order_relaxed);
+    }
+}
+
+
+#pragma mark - Snapshot
+
+- (NSDictionary *)snapshot {
+    
+    NSMutableDictionary *counters = [NSMutableDictionary new];
+    for (NSUInteger counterIdx = 0; counterIdx < SPNPMetricsCountersCount; counterIdx++) {
+        
+        uint64_t value = atomic_load_explicit(&_counters[counterIdx], memory_order_relaxed);
+        counters[kSPNPMetricsCounterNames[counterIdx]] = @(value);
+    }
+    NSMutableDictionary *latencies = [NSMutableDictionary new];
+    for (NSUInteger latencyIdx = 0; latencyIdx < SPNPMetricsLatenciesCount; latencyIdx++) {
+        
+        NSDictionary *histogram = [self snapshotOfHistogram:&_histograms[latencyIdx]];
+        latencies[kSPNPMetricsLatencyNames[latencyIdx]] = histogram;
+    }
+    
+    return @{@"time": @([[NSDate date] timeIntervalSince1970]), @"counters": counters,
+             @"latencies": latencies};
+}
+
+- (NSDictionary *)snapshotOfHistogram:(SPNPMetricsHistogram *)histogram {
+    
+    uint64_t buckets[kSPNPMetricsBucketsCount];
+    uint64_t count = 0;
+    for (NSUInteger bucketIdx = 0; bucketIdx < kSPNPMetricsBucketsCount; bucketIdx++) {
+        
+        buckets[bucketIdx] = atomic_load_explicit(&histogram->buckets[bucketIdx],
+                                                  memory_order_relaxed);
+        count += buckets[bucketIdx];
+    }
+    uint64_t sum = atomic_load_explicit(&histogram->sum, memory_order_relaxed);
+    uint64_t maximum = atomic_load_explicit(&histogram->maximum, memory_order_relaxed);
+    
+    // Percentiles reported as upper bound of bucket in which they fall (but not above maximum).
+    double percentiles[3] = {0.5f, 0.9f, 0.99f};
+    double values[3] = {0.0f, 0.0f, 0.0f};
+    for (NSUInteger percentileIdx = 0; percentileIdx < 3 && count; percentileIdx++) {
+        
+        uint64_t rank = (uint64_t)ceil(percentiles[percentileIdx] * (double)count);
+        uint64_t accumulated = 0;
+        for (NSUInteger bucketIdx = 0; bucketIdx < kSPNPMetricsBucketsCount; bucketIdx++) {
+            
+            accumulated += buckets[bucketIdx];
+            if (accumulated >= rank) {
+                
+                double upperBound = ldexp(1.0f, (int)bucketIdx);
+                values[percentileIdx] = MIN(upperBound, (double)maximum) / 1000.0f;
+                break;
+            }
+        }
+    }
+    
+    return @{@"count": @(count), @"mean": @(count ? (double)sum / (double)count / 1000.0f : 0.0f),
+             @"p50": @(values[0]), @"p90": @(values[1]), @"p99": @(values[2]),
+             @"max": @((double)maximum / 1000.0f)};
+}
+
+- (void)startDumpingToFileAtPath:(NSString *)path withInterval:(NSTimeInterval)interval {
+    
+    [self stopDumping];
+    if (![[NSFileManager defaultManager] fileExistsAtPath:path]) {
+        
+        [[NSFileManager defaultManager] createFileAtPath:path contents:nil attributes:nil];
+    }
+    NSFileHandle *file = [NSFileHandle fileHandleForWritingAtPath:path];
+    if (!file || interval <= 0.0f) { return; }
+    
+    [file seekToEndOfFile];
+    self.dumpFile = file;
+    self.dumpTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, self.queue);
+    uint64_t period = (uint64_t)(interval * NSEC_PER_SEC);
+    dispatch_source_set_timer(self.dumpTimer, dispatch_time(DISPATCH_TIME_NOW, (int64_t)period),
+                              period, period / 10);
+    __weak __typeof(self) weakSelf = self;
+    dispatch_source_set_event_handler(self.dumpTimer, ^{
+        
+        NSDictionary *snapshot = [weakSelf snapshot];
+        if (snapshot) { [SPNPMetrics dumpSnapshot:snapshot toFile:file]; }
+    });
+    dispatch_resume(self.dumpTimer);
+}
+
+- (void)stopDumping {
+    
+    if (self.dumpTimer) {
+        
+        dispatch_source_cancel(self.dumpTimer);
+        self.dumpTimer = nil;
+        
+        // Write last snapshot after all scheduled dumps and close the file.
+        NSFileHandle *file = self.dumpFile;
+        self.dumpFile = nil;
+        NSDictionary *snapshot = [self snapshot];
+        dispatch_async(self.queue, ^{
+            
+            [SPNPMetrics dumpSnapshot:snapshot toFile:file];
+            [file closeFile];
+        });
+    }
+}
+
++ (void)dumpSnapshot:(NSDictionary *)snapshot toFile:(NSFileHandle *)file {
+    
+    NSMutableData *line = [[NSJSONSerialization dataWithJSONObject:snapshot options:0
+                                                             error:nil] mutableCopy];
+    if (line) {
+        
+        [line appendBytes:"\n" length:1];
+        [file writeData:line];
+    }
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,149 @@
+#import <Foundation/Foundation.h>
+
+
+/**
+ @brief      Streaming numeric ratings aggregate.
+ @discussion Accumulator keep number of values, their mean and sum of squared deviations from mean
+             (Welford's algorithm) and fixed-bins histogram over ratings scale, so each value added
+             or removed in constant time and memory doesn't depend from number of values. 
+             Histogram bins used as small quantiles sketch: quantile error doesn't exceed bin width
+             (exact for integer scale which has one bin per value).
+             Partial aggregates from different hosts can be merged w/o loss of precision (Chan's 
+             parallel variance formula).
+             Accumulator is not thread-safe and should be used from single queue.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPRatingAccumulator : NSObject
+
+
+///------------------------------------------------
+/// @name Configuration
+///------------------------------------------------
+
+/**
+ @brief  Stores lowest value on ratings scale.
+ */
+@property (nonatomic, readonly, assign) double minimumValue;
+
+/**
+ @brief  Stores highest value on ratings scale.
+ */
+@property (nonatomic, readonly, assign) double maximumValue;
+
+/**
+ @brief  Stores number of histogram bins.
+ */
+@property (nonatomic, readonly, assign) NSUInteger binsCount;
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores number of accumulated values.
+ */
+@property (nonatomic, readonly, assign) unsigned long long count;
+
+/**
+ @brief  Stores mean of accumulated values.
+ */
+@property (nonatomic, readonly, assign) double mean;
+
+/**
+ @brief  Stores sum of squared deviations of accumulated values from their mean.
+ */
+@property (nonatomic, readonly, assign) double sumOfSquaredDeviations;
+
+/**
+ @brief  Stores sample variance of accumulated values (\c 0 in case if there is less than two 
+         values).
+ */
+@property (nonatomic, readonly, assign) double variance;
+
+/**
+ @brief  Stores reference on list of values count in each histogram bin.
+ */
+@property (nonatomic, readonly, strong) NSArray *histogram;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief      Create and configure ratings accumulator for integer scale.
+ @discussion Each integer value on scale has own bin while scale fit into maximum bins count, 
+             otherwise scale split into bins of same width.
+ 
+ @param minimumValue Lowest value on ratings scale.
+ @param maximumValue Highest value on ratings scale.
+ 
+ @return Configured and ready to use accumulator.
+ */
++ (instancetype)accumulatorWithMinimumValue:(NSInteger)minimumValue
+                               maximumValue:(NSInteger)maximumValue;
+
+
+///------------------------------------------------
+/// @name Values
+///------------------------------------------------
+
+/**
+ @brief  Accumulate value.
+ 
+ @param value Value from ratings scale (values outside of scale counted by edge bins).
+ */
+- (void)addValue:(double)value;
+
+/**
+ @brief      Remove previously accumulated value.
+ @discussion Used when attendee changed own rating.
+ 
+ @param value Value which has been added before.
+ */
+- (void)removeValue:(double)value;
+
+/**
+ @brief  Retrieve approximate value at specified quantile.
+ 
+ @param quantile Quantile (from \c 0.0 to \c 1.0), for example \c 0.5 for median.
+ 
+ @return Interpolated value from histogram or \c NAN in case if there is no values.
+ */
+- (double)valueAtQuantile:(double)quantile;
+
+/**
+ @brief  Remove all accumulated values.
+ */
+- (void)reset;
+
+
+///------------------------------------------------
+/// @name Merge
+///------------------------------------------------
+
+/**
+ @brief  Merge partial aggregate into receiver.
+ 
+ @param count                  Number of values in partial aggregate.
+ @param mean                   Mean of values in partial aggregate.
+ @param sumOfSquaredDeviations Sum of squared deviations of values in partial aggregate.
+ @param histogram              Histogram of partial aggregate (ignored if bins count differ).
+ */
+- (void)mergeCount:(unsigned long long)count mean:(double)mean
+sumOfSquaredDeviations:(double)sumOfSquaredDeviations histogram:(NSArray *)histogram;
+
+/**
+ @brief  Merge aggregate from another accumulator into receiver.
+ 
+ @param accumulator Reference on accumulator with same scale.
+ */
+- (void)mergeAccumulator:(SPNPRatingAccumulator *)accumulator;
+
+#pragma mark -
+
+
+@end
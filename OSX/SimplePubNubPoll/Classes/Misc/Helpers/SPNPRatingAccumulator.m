@@ -0,0 +1,231 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPRatingAccumulator.h"
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores maximum number of histogram bins (limit accumulator and published statistic size).
+ */
+static NSUInteger const kSPNPRatingAccumulatorMaximumBinsCount = 64;
+
+
+#pragma mark - Private interface declaration
+
+@interface SPNPRatingAccumulator ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, assign) double minimumValue;
+@property (nonatomic, assign) double maximumValue;
+@property (nonatomic, assign) NSUInteger binsCount;
+@property (nonatomic, assign) unsigned long long count;
+@property (nonatomic, assign) double mean;
+@property (nonatomic, assign) double sumOfSquaredDeviations;
+
+/**
+ @brief  Stores width of each histogram bin.
+ */
+@property (nonatomic, assign) double binWidth;
+
+/**
+ @brief  Stores reference on values count in each histogram bin.
+ */
+@property (nonatomic, assign) unsigned long long *bins;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize ratings accumulator.
+ 
+ @param minimumValue Lowest value on ratings scale.
+ @param maximumValue Highest value on ratings scale.
+ 
+ @return Initialized and ready to use accumulator.
+ */
+- (instancetype)initWithMinimumValue:(NSInteger)minimumValue maximumValue:(NSInteger)maximumValue;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Find histogram bin for value.
+ 
+ @param value Value from ratings scale.
+ 
+ @return Index of the bin which count value.
+ */
+- (NSUInteger)binForValue:(double)value;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPRatingAccumulator
+
+
+#pragma mark - Information
+
+- (double)variance {
+    
+    return (self.count > 1 ? self.sumOfSquaredDeviations / (double)(self.count - 1) : 0.0f);
+}
+
+- (NSArray *)histogram {
+    
+    NSMutableArray *histogram = [NSMutableArray arrayWithCapacity:self.binsCount];
+    for (NSUInteger binIdx = 0; binIdx < self.binsCount; binIdx++) {
+        
+        [histogram addObject:@(self.bins[binIdx])];
+    }
+    
+    return [histogram copy];
+}
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)accumulatorWithMinimumValue:(NSInteger)minimumValue
+                               maximumValue:(NSInteger)maximumValue {
+    
+    return [[self alloc] initWithMinimumValue:minimumValue maximumValue:maximumValue];
+}
+
+- (instancetype)initWithMinimumValue:(NSInteger)minimumValue maximumValue:(NSInteger)maximumValue {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        // Each bin cover [lower, lower + width) range, so highest value get own bin too.
+        double valuesCount = MAX((double)maximumValue - (double)minimumValue + 1.0f, 1.0f);
+        _minimumValue = (double)minimumValue;
+        _maximumValue = (double)MAX(maximumValue, minimumValue);
+        _binsCount = (NSUInteger)MIN(valuesCount, (double)kSPNPRatingAccumulatorMaximumBinsCount);
+        _binWidth = (valuesCount / (double)_binsCount);
+        _bins = calloc(_binsCount, sizeof(unsigned long long));
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    
+    free(_bins);
+}
+
+
+#pragma mark - Values
+
+- (void)addValue:(double)value {
+    
+    self.count++;
+    double delta = (value - self.mean);
+    self.mean += (delta / (double)self.count);
+    self.sumOfSquaredDeviations += (delta * (value - self.mean));
+    self.bins[[self binForValue:value]]++;
+}
+
+- (void)removeValue:(double)value {
+    
+    NSUInteger binIdx = [self binForValue:value];
+    if (self.bins[binIdx] == 0) { return; }
+    
+    self.bins[binIdx]--;
+    if (self.count > 1) {
+        
+        // Reversed Welford's update.
+        double delta = (value - self.mean);
+        self.mean -= (delta / (double)(self.count - 1));
+        self.sumOfSquaredDeviations = MAX(self.sumOfSquaredDeviations - delta * (value - self.mean),
+                                          0.0f);
+        self.count--;
+    }
+    else { [self reset]; }
+}
+
+- (double)valueAtQuantile:(double)quantile {
+    
+    if (!self.count) { return NAN; }
+    
+    double rank = (MIN(MAX(quantile, 0.0f), 1.0f) * (double)self.count);
+    unsigned long long countedValues = 0;
+    NSUInteger binIdx = 0;
+    for (; binIdx + 1 < self.binsCount; binIdx++) {
+        
+        if ((double)(countedValues + self.bins[binIdx]) >= rank && self.bins[binIdx]) { break; }
+        countedValues += self.bins[binIdx];
+    }
+    
+    // Bin of integer scale contain only one value, so there is nothing to interpolate.
+    double lowerValue = (self.minimumValue + self.binWidth * (double)binIdx);
+    if (self.binWidth <= 1.0f) { return lowerValue; }
+    double binFraction = (self.bins[binIdx] ? (rank - (double)countedValues) /
+                          (double)self.bins[binIdx] : 0.0f);
+    
+    return MIN(lowerValue + self.binWidth * MIN(MAX(binFraction, 0.0f), 1.0f), self.maximumValue);
+}
+
+- (void)reset {
+    
+    self.count = 0;
+    self.mean = 0.0f;
+    self.sumOfSquaredDeviations = 0.0f;
+    memset(self.bins, 0, self.binsCount * sizeof(unsigned long long));
+}
+
+
+#pragma mark - Merge
+
+- (void)mergeCount:(unsigned long long)count mean:(double)mean
+sumOfSquaredDeviations:(double)sumOfSquaredDeviations histogram:(NSArray *)histogram {
+    
+    if (!count) { return; }
+    
+    double totalCount = ((double)self.count + (double)count);
+    double delta = (mean - self.mean);
+    double weight = ((double)self.count * (double)count / totalCount);
+    self.sumOfSquaredDeviations += (sumOfSquaredDeviations + delta * delta * weight);
+    self.mean += (delta * (double)count / totalCount);
+    self.count += count;
+    if (histogram.count == self.binsCount) {
+        
+        for (NSUInteger binIdx = 0; binIdx < self.binsCount; binIdx++) {
+            
+            NSNumber *binCount = histogram[binIdx];
+            if ([binCount isKindOfClass:NSNumber.class]) {
+                
+                self.bins[binIdx] += binCount.unsignedLongLongValue;
+            }
+        }
+    }
+}
+
+- (void)mergeAccumulator:(SPNPRatingAccumulator *)accumulator {
+    
+    [self mergeCount:accumulator.count mean:accumulator.mean
+sumOfSquaredDeviations:accumulator.sumOfSquaredDeviations histogram:accumulator.histogram];
+}
+
+
+#pragma mark - Misc
+
+- (NSUInteger)binForValue:(double)value {
+    
+    double binIdx = floor((value - self.minimumValue) / self.binWidth);
+    
+    return (NSUInteger)MIN(MAX(binIdx, 0.0f), (double)(self.binsCount - 1));
+}
+
+#pragma mark -
+
+
+@end
@@ -1,12 +1,19 @@
 #import <Foundation/Foundation.h>
 
 
+#pragma mark Class forward
+
+@class SPNPCompactCoder;
+
+
 /**
  @brief      Model representation helper class.
  @discussion This class provide ability to represent model as dictionary so it will be possible to 
              send it elsewhere using JSON serialization.
              Class also provide methods to create object instance back from dictionary 
              representation.
+             Subclasses which implement compact coding methods can be represented with versioned
+             compact binary payload (Base64 encoded string) which is much smaller than dictionary.
 
  @author Sergey Mamontov
  @copyright © 2009-2015 PubNub, Inc.
@@ -26,8 +33,10 @@
 - (NSDictionary *)dictionaryRepresentation;
 
 /**
- @brief  Allow subclass to pass list of property names which shouldn't be used during object
-         serialization.
+ @brief      Allow subclass to pass list of property names which shouldn't be used during object
+             serialization.
+ @discussion List requested only once per class (when serialization codec is built), so it should 
+             be the same for all class instances.
  
  @return List of ignored property list names.
  */
@@ -39,7 +48,9 @@
 ///------------------------------------------------
 
 /**
- @brief  Create model class from it's dictionary representation.
+ @brief      Create model class from it's dictionary representation.
+ @discussion Every key from \c data except \c s_class applied to created instance (including keys
+             for ignored properties); keys which doesn't match to any property silently skipped.
  
  @param data Model dictionary representation.
  
@@ -47,6 +58,71 @@
  */
 + (instancetype)objectFromDictionaryRepresentation:(NSDictionary *)data;
 
+
+///------------------------------------------------
+/// @name Compact representation
+///------------------------------------------------
+
+/**
+ @brief      Unique model type identifier which is written into compact representation.
+ @discussion Subclass should return non-zero value to enable compact representation support.
+ 
+ @return Model type identifier or \c 0 in case if compact representation not supported.
+ */
++ (NSUInteger)compactTypeIdentifier;
+
+/**
+ @brief  Write model fields using compact coder.
+ 
+ @param coder Reference on coder which should be used to write model fields.
+ */
+- (void)encodeWithCompactCoder:(SPNPCompactCoder *)coder;
+
+/**
+ @brief  Read model fields using compact coder.
+ 
+ @param coder Reference on coder which should be used to read model fields.
+ */
+- (void)decodeWithCompactCoder:(SPNPCompactCoder *)coder;
+
+/**
+ @brief  Serialize model object to compact representation.
+ 
+ @param pollIdentifier Identifier of the poll which should be replaced with short token.
+ @param token          Reference on short poll token.
+ 
+ @return Base64 encoded compact representation or \c nil if model doesn't support it.
+ */
+- (NSString *)compactRepresentationForPoll:(NSString *)pollIdentifier token:(NSNumber *)token;
+
+/**
+ @brief  Create model class from it's compact representation.
+ 
+ @param data           Base64 encoded compact model representation.
+ @param pollIdentifier Identifier of the poll which should be used in place of short token.
+ @param token          Reference on short poll token.
+ 
+ @return Initialized and ready to use model instance or \c nil in case if \c data can't be 
+         decoded (unknown version, different model or malformed payload).
+ */
++ (instancetype)objectFromCompactRepresentation:(NSString *)data
+                                        forPoll:(NSString *)pollIdentifier token:(NSNumber *)token;
+
+/**
+ @brief      Create model class from received message.
+ @discussion Depending on message type, model restored from compact (\c NSString) or dictionary
+             representation.
+ 
+ @param message        Reference on received message.
+ @param pollIdentifier Identifier of the poll which should be used in place of short token.
+ @param token          Reference on short poll token.
+ 
+ @return Initialized and ready to use model instance or \c nil in case if \c message can't be 
+         parsed.
+ */
++ (instancetype)objectFromMessage:(id)message forPoll:(NSString *)pollIdentifier
+                            token:(NSNumber *)token;
+
 #pragma mark -
 
 @end
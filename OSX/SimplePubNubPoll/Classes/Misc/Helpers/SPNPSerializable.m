@@ -3,7 +3,8 @@
  @copyright © 2009-2015 PubNub, Inc.
  */
 #import "SPNPSerializable.h"
-#import <objc/runtime.h>
+#import "SPNPSerializableCodec.h"
+#import "SPNPCompactCoder.h"
 
 
 #pragma mark Private interface declaration
@@ -11,18 +12,6 @@
 @interface SPNPSerializable ()
 
 
-#pragma mark - Instance variables
-
-/**
- @brief  Retrieve list of properties which should be serialized into dictionary.
- 
- @return List of property variable names.
- 
- @since 1.0
- */
-- (NSArray *)properties;
-
-
 #pragma mark - Serialization
 
 /**
@@ -83,12 +72,13 @@
 
 - (NSDictionary *)dictionaryRepresentation {
     
-    NSMutableDictionary *dictionary = [@{@"s_class": NSStringFromClass(self.class)} mutableCopy];
-    NSArray *properties = [self properties];
-    for (NSString *propertyName in properties) {
+    SPNPSerializableCodec *codec = [SPNPSerializableCodec codecForObject:self];
+    NSMutableDictionary *dictionary = [[NSMutableDictionary alloc] initWithCapacity:(codec.count + 1)];
+    dictionary[@"s_class"] = codec.className;
+    for (NSUInteger propertyIdx = 0; propertyIdx < codec.count; propertyIdx++) {
         
-        id propertyValue = [self serializedValue:[self valueForKey:propertyName]];
-        if (propertyValue) { dictionary[propertyName] = propertyValue; }
+        id propertyValue = [self serializedValue:[codec valueAtIndex:propertyIdx fromObject:self]];
+        if (propertyValue) { dictionary[[codec propertyNameAtIndex:propertyIdx]] = propertyValue; }
     }
     
     return (dictionary.count ? dictionary : nil);
@@ -110,7 +100,7 @@
     id(^serializationBlock)(id value) = ^id(id value) {
         
         id serializedValue = value;
-        if (![value respondsToSelector:@selector(dictionaryRepresentation)]) {
+        if (![value isKindOfClass:SPNPSerializable.class]) {
             
             serializedValue = [self serializedValue:value];
         }
@@ -148,15 +138,22 @@
 + (instancetype)objectFromDictionaryRepresentation:(NSDictionary *)data {
     
     id object = nil;
-    if (data && [data isKindOfClass:NSDictionary.class] && [NSStringFromClass(self.class) isEqualToString:data[@"s_class"]]) {
+    if ([data isKindOfClass:NSDictionary.class] &&
+        [SPNPSerializableCodec serializableClassWithName:data[@"s_class"]] == self) {
         
         object = [self new];
-        for (NSString *propertyName in data.allKeys) {
+        SPNPSerializableCodec *codec = [SPNPSerializableCodec codecForObject:object];
+        for (NSString *propertyName in data) {
             
             if (![propertyName isEqualToString:@"s_class"]) {
                 
                 id propertyValue = [self deserializedValue:data[propertyName]];
-                if (propertyValue) { [object setValue:propertyValue forKey:propertyName]; }
+                NSUInteger propertyIdx = [codec indexOfPropertyWithName:propertyName];
+                if (propertyValue && propertyIdx != NSNotFound) {
+                    
+                    [codec setValue:propertyValue atIndex:propertyIdx forObject:object];
+                }
+                else if (propertyValue) { [object setValue:propertyValue forKey:propertyName]; }
             }
         }
     }
@@ -171,7 +168,8 @@
         
         if ([value isKindOfClass:NSDictionary.class] && value[@"s_class"] != nil) {
             
-            deserializedValue = [NSClassFromString(value[@"s_class"]) objectFromDictionaryRepresentation:value];
+            Class objectClass = [SPNPSerializableCodec serializableClassWithName:value[@"s_class"]];
+            deserializedValue = [objectClass objectFromDictionaryRepresentation:value];
         }
         else { deserializedValue = [self deserializedCollection:value]; }
     }
@@ -205,33 +203,84 @@
     return deserializedCollection;
 }
 
-- (void)setValue:(id)value forUndefinedKey:(NSString *)key {
+
+#pragma mark - Compact representation
+
++ (NSUInteger)compactTypeIdentifier {
     
-    // Do nothing.
+    return 0;
 }
 
+- (void)encodeWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    // Do nothing.
+}
 
-#pragma mark - Properties access
+- (void)decodeWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    // Do nothing.
+}
 
-- (NSArray *)properties {
+- (NSString *)compactRepresentationForPoll:(NSString *)pollIdentifier token:(NSNumber *)token {
     
-    unsigned int propertiesCount;
-    objc_property_t *property_structures = class_copyPropertyList(self.class, &propertiesCount);
+    NSString *representation = nil;
+    if ([self.class compactTypeIdentifier]) {
+        
+        SPNPCompactCoder *coder = [SPNPCompactCoder encoderForPoll:pollIdentifier token:token];
+        [coder encodeUnsignedInteger:[SPNPCompactCoder formatVersion]];
+        [coder encodeUnsignedInteger:[self.class compactTypeIdentifier]];
+        [self encodeWithCompactCoder:coder];
+        representation = [coder.data base64EncodedStringWithOptions:0];
+    }
     
-    NSMutableArray *properties = [NSMutableArray arrayWithCapacity:propertiesCount];
-    NSArray *ignoredProperties = [self ignoredProperties];
-    for (NSUInteger propertyIdx = 0; propertyIdx < propertiesCount; propertyIdx++) {
+    return representation;
+}
+
++ (instancetype)objectFromCompactRepresentation:(NSString *)data
+                                        forPoll:(NSString *)pollIdentifier token:(NSNumber *)token {
+    
+    id object = nil;
+    NSData *payload = nil;
+    if ([data isKindOfClass:NSString.class] && [self compactTypeIdentifier]) {
         
-        objc_property_t property = property_structures[propertyIdx];
-        NSString *propertyName = [NSString stringWithFormat:@"%s", property_getName(property)];
-        if (![ignoredProperties containsObject:propertyName]) {
+        payload = [[NSData alloc] initWithBase64EncodedString:data options:0];
+    }
+    if (payload) {
+        
+        SPNPCompactCoder *coder = [SPNPCompactCoder decoderWithData:payload forPoll:pollIdentifier
+                                                              token:token];
+        BOOL isSupported = ([coder decodeUnsignedInteger] == [SPNPCompactCoder formatVersion]);
+        isSupported = (isSupported && [coder decodeUnsignedInteger] == [self compactTypeIdentifier]);
+        if (isSupported) {
             
-            [properties addObject:propertyName];
+            object = [self new];
+            [object decodeWithCompactCoder:coder];
         }
+        if (!coder.isValid) { object = nil; }
+    }
+    
+    return object;
+}
+
++ (instancetype)objectFromMessage:(id)message forPoll:(NSString *)pollIdentifier
+                            token:(NSNumber *)token {
+    
+    id object = nil;
+    if ([message isKindOfClass:NSString.class]) {
+        
+        object = [self objectFromCompactRepresentation:message forPoll:pollIdentifier token:token];
     }
-    free(property_structures);
+    else { object = [self objectFromDictionaryRepresentation:message]; }
+    
+    return object;
+}
+
+
+#pragma mark - Misc
+
+- (void)setValue:(id)value forUndefinedKey:(NSString *)key {
     
-    return [properties copy];
+    // Do nothing.
 }
 
 #pragma mark -
@@ -0,0 +1,121 @@
+#import <Foundation/Foundation.h>
+
+
+#pragma mark Class forward
+
+@class SPNPSerializable;
+
+
+/**
+ @brief      Per-class serialization codec used by \b SPNPSerializable.
+ @discussion Codec resolve list of serializable properties, their getter/setter implementations and
+             value types once per class and cache results, so serialization and de-serialization
+             doesn't need to use runtime reflection or KVC for every processed object.
+             Codec also maintain registry of class names which can be used as \c s_class value
+             in dictionary representation.
+
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPSerializableCodec : NSObject
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on name of the class which is handled by codec (used as \c s_class
+         value).
+ */
+@property (nonatomic, readonly, copy) NSString *className;
+
+/**
+ @brief  Stores number of properties which should be serialized.
+ */
+@property (nonatomic, readonly, assign) NSUInteger count;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief      Retrieve cached codec for passed object's class or build new one.
+ @discussion Codec built using \c -ignoredProperties of the object passed during first request for
+             concrete class, so list of ignored properties expected to be same for all class
+             instances.
+             Only properties declared by object's class itself are used (properties inherited
+             from superclasses not serialized).
+
+ @param object Reference on model instance for which codec should be provided.
+
+ @return Cached and ready to use codec instance.
+ */
++ (instancetype)codecForObject:(SPNPSerializable *)object;
+
+
+///------------------------------------------------
+/// @name Class registry
+///------------------------------------------------
+
+/**
+ @brief      Find model class which is registered under specified \c s_class name.
+ @discussion Only \b SPNPSerializable subclasses allowed to be created from dictionary
+             representation. Name resolution result (including failed one) cached, so every name
+             resolved using runtime only once.
+
+ @param className Reference on name which has been received in \c s_class field.
+
+ @return Reference on model class or \c nil in case if name unknown or not allowed.
+ */
++ (Class)serializableClassWithName:(NSString *)className;
+
+
+///------------------------------------------------
+/// @name Properties access
+///------------------------------------------------
+
+/**
+ @brief  Retrieve name of serializable property.
+
+ @param propertyIdx Index of property inside of codec's properties list.
+
+ @return Property name which should be used as key in dictionary representation.
+ */
+- (NSString *)propertyNameAtIndex:(NSUInteger)propertyIdx;
+
+/**
+ @brief  Find serializable property by it's name.
+
+ @param propertyName Reference on name which has been received in dictionary representation.
+
+ @return Index of property inside of codec's properties list or \c NSNotFound in case if there is
+         no serializable property with specified name.
+ */
+- (NSUInteger)indexOfPropertyWithName:(NSString *)propertyName;
+
+/**
+ @brief  Retrieve property value using cached getter implementation.
+
+ @param propertyIdx Index of property inside of codec's properties list.
+ @param object      Reference on model instance from which value should be retrieved.
+
+ @return Property value (scalar values boxed into \c NSNumber).
+ */
+- (id)valueAtIndex:(NSUInteger)propertyIdx fromObject:(id)object;
+
+/**
+ @brief  Update property value using cached setter implementation.
+
+ @param value       Reference on value which should be set (scalar values expected to be boxed
+                    into \c NSNumber).
+ @param propertyIdx Index of property inside of codec's properties list.
+ @param object      Reference on model instance which should be updated.
+ */
+- (void)setValue:(id)value atIndex:(NSUInteger)propertyIdx forObject:(id)object;
+
+#pragma mark -
+
+
+@end
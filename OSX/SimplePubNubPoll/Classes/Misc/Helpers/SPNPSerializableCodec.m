@@ -0,0 +1,466 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPSerializableCodec.h"
+#import "SPNPSerializable.h"
+#import <objc/runtime.h>
+#import <pthread.h>
+
+
+#pragma mark Types
+
+/**
+ @brief  Describes property value type which define how getter and setter implementation should be
+         called.
+ */
+typedef NS_ENUM(NSUInteger, SPNPCodecValueType) {
+
+    /**
+     @brief  Property value is object.
+     */
+    SPNPCodecObjectValue,
+
+    /**
+     @brief  Property value is \c BOOL or \c char.
+     */
+    SPNPCodecBoolValue,
+
+    /**
+     @brief  Property value is signed integer (\c int).
+     */
+    SPNPCodecIntValue,
+
+    /**
+     @brief  Property value is unsigned integer (\c unsigned \c int).
+     */
+    SPNPCodecUnsignedIntValue,
+
+    /**
+     @brief  Property value is signed 64-bit integer (\c long \c long).
+     */
+    SPNPCodecLongLongValue,
+
+    /**
+     @brief  Property value is unsigned 64-bit integer (\c unsigned \c long \c long).
+     */
+    SPNPCodecUnsignedLongLongValue,
+
+    /**
+     @brief  Property value is floating point number (\c double).
+     */
+    SPNPCodecDoubleValue,
+
+    /**
+     @brief  Property value is floating point number (\c float).
+     */
+    SPNPCodecFloatValue,
+
+    /**
+     @brief  Property value type not supported by cached accessors and KVC should be used.
+     */
+    SPNPCodecUnknownValue
+};
+
+/**
+ @brief  Structure which describe resolved accessors for single property.
+ */
+typedef struct SPNPCodecProperty {
+
+    SPNPCodecValueType type;
+    SEL getter;
+    IMP getterImplementation;
+    SEL setter;
+    IMP setterImplementation;
+} SPNPCodecProperty;
+
+
+#pragma mark - Static
+
+/**
+ @brief  Stores reference on lock which is used to protect codecs and class names caches.
+ */
+static pthread_mutex_t SPNPCodecCacheLock = PTHREAD_MUTEX_INITIALIZER;
+
+
+#pragma mark - Private interface declaration
+
+@interface SPNPSerializableCodec ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, copy) NSString *className;
+@property (nonatomic, assign) NSUInteger count;
+
+/**
+ @brief  Stores reference on list of serializable property names.
+ */
+@property (nonatomic, copy) NSArray *propertyNames;
+
+/**
+ @brief  Stores reference on map of property names to their index inside of \c propertyNames.
+ */
+@property (nonatomic, copy) NSDictionary *propertyIndices;
+
+/**
+ @brief  Stores reference on resolved property accessors (same order as in \c propertyNames).
+ */
+@property (nonatomic, assign) SPNPCodecProperty *properties;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize codec for concrete model class.
+
+ @param objectClass       Reference on class for which codec should be created.
+ @param ignoredProperties List of property names which shouldn't be serialized.
+
+ @return Initialized and ready to use codec instance.
+ */
+- (instancetype)initForClass:(Class)objectClass ignoredProperties:(NSArray *)ignoredProperties;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Stores reference on map of class to codec instances.
+ */
++ (NSMapTable *)codecs;
+
+/**
+ @brief  Stores reference on map of \c s_class names to resolved classes (or \c NSNull for names
+         which can't be used).
+ */
++ (NSMutableDictionary *)classNames;
+
+/**
+ @brief  Resolve value type basing on property type encoding.
+
+ @param property Reference on property for which type should be resolved.
+
+ @return One of \b SPNPCodecValueType fields.
+ */
++ (SPNPCodecValueType)typeOfProperty:(objc_property_t)property;
+
+/**
+ @brief  Resolve name of accessor selector basing on property attributes.
+
+ @param property  Reference on property for which accessor should be found.
+ @param attribute Name of attribute which store custom accessor name (\c G or \c S).
+ @param name      Reference on property name.
+
+ @return Reference on accessor selector.
+ */
++ (SEL)accessorForProperty:(objc_property_t)property attribute:(const char *)attribute
+                      name:(NSString *)name;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPSerializableCodec
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)codecForObject:(SPNPSerializable *)object {
+
+    Class objectClass = object_getClass(object);
+    pthread_mutex_lock(&SPNPCodecCacheLock);
+    SPNPSerializableCodec *codec = [[self codecs] objectForKey:objectClass];
+    pthread_mutex_unlock(&SPNPCodecCacheLock);
+    if (!codec) {
+
+        // Build codec outside of lock, because -ignoredProperties is subclass code. In worst case
+        // two threads will build same codec and one of them will be dropped.
+        codec = [[self alloc] initForClass:objectClass ignoredProperties:[object ignoredProperties]];
+        pthread_mutex_lock(&SPNPCodecCacheLock);
+        SPNPSerializableCodec *cachedCodec = [[self codecs] objectForKey:objectClass];
+        if (!cachedCodec) { [[self codecs] setObject:codec forKey:objectClass]; }
+        else { codec = cachedCodec; }
+        [self classNames][codec.className] = objectClass;
+        pthread_mutex_unlock(&SPNPCodecCacheLock);
+    }
+
+    return codec;
+}
+
+- (instancetype)initForClass:(Class)objectClass ignoredProperties:(NSArray *)ignoredProperties {
+
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+
+        _className = [NSStringFromClass(objectClass) copy];
+        NSMutableArray *names = [NSMutableArray new];
+        NSMutableArray *resolvedProperties = [NSMutableArray new];
+        NSMutableDictionary *indices = [NSMutableDictionary new];
+        unsigned int propertiesCount;
+        objc_property_t *property_structures = class_copyPropertyList(objectClass, &propertiesCount);
+        for (NSUInteger propertyIdx = 0; propertyIdx < propertiesCount; propertyIdx++) {
+
+            objc_property_t property = property_structures[propertyIdx];
+            NSString *propertyName = @(property_getName(property));
+            if (![ignoredProperties containsObject:propertyName]) {
+
+                indices[propertyName] = @(names.count);
+                [names addObject:propertyName];
+                [resolvedProperties addObject:[NSValue valueWithPointer:property]];
+            }
+        }
+        free(property_structures);
+
+        _propertyNames = [names copy];
+        _propertyIndices = [indices copy];
+        _count = names.count;
+        _properties = calloc(MAX(_count, 1), sizeof(SPNPCodecProperty));
+        for (NSUInteger propertyIdx = 0; propertyIdx < _count; propertyIdx++) {
+
+            objc_property_t property = [resolvedProperties[propertyIdx] pointerValue];
+            SPNPCodecProperty *accessors = &_properties[propertyIdx];
+            accessors->type = [self.class typeOfProperty:property];
+            accessors->getter = [self.class accessorForProperty:property attribute:"G"
+                                                           name:names[propertyIdx]];
+            accessors->setter = [self.class accessorForProperty:property attribute:"S"
+                                                           name:names[propertyIdx]];
+            if ([objectClass instancesRespondToSelector:accessors->getter]) {
+
+                accessors->getterImplementation = class_getMethodImplementation(objectClass,
+                                                                                accessors->getter);
+            }
+            if ([objectClass instancesRespondToSelector:accessors->setter]) {
+
+                accessors->setterImplementation = class_getMethodImplementation(objectClass,
+                                                                                accessors->setter);
+            }
+        }
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+
+    free(_properties);
+}
+
+
+#pragma mark - Class registry
+
++ (Class)serializableClassWithName:(NSString *)className {
+
+    id objectClass = nil;
+    if ([className isKindOfClass:NSString.class]) {
+
+        pthread_mutex_lock(&SPNPCodecCacheLock);
+        objectClass = [self classNames][className];
+        pthread_mutex_unlock(&SPNPCodecCacheLock);
+    }
+    if (!objectClass && [className isKindOfClass:NSString.class]) {
+
+        Class resolvedClass = NSClassFromString(className);
+        BOOL isAllowed = (resolvedClass && resolvedClass != SPNPSerializable.class &&
+                          [resolvedClass isSubclassOfClass:SPNPSerializable.class]);
+        objectClass = (isAllowed ? resolvedClass : [NSNull null]);
+        pthread_mutex_lock(&SPNPCodecCacheLock);
+        [self classNames][className] = objectClass;
+        pthread_mutex_unlock(&SPNPCodecCacheLock);
+    }
+
+    return (objectClass != [NSNull null] ? objectClass : nil);
+}
+
+
+#pragma mark - Properties access
+
+- (NSString *)propertyNameAtIndex:(NSUInteger)propertyIdx {
+
+    return self.propertyNames[propertyIdx];
+}
+
+- (NSUInteger)indexOfPropertyWithName:(NSString *)propertyName {
+
+    NSNumber *propertyIdx = self.propertyIndices[propertyName];
+
+    return (propertyIdx ? propertyIdx.unsignedIntegerValue : NSNotFound);
+}
+
+- (id)valueAtIndex:(NSUInteger)propertyIdx fromObject:(id)object {
+
+    SPNPCodecProperty *accessors = &self.properties[propertyIdx];
+    IMP getter = accessors->getterImplementation;
+    SEL selector = accessors->getter;
+    id value = nil;
+    if (!getter) { accessors = NULL; }
+    switch (accessors ? accessors->type : SPNPCodecUnknownValue) {
+        case SPNPCodecObjectValue:
+            value = ((id(*)(id, SEL))getter)(object, selector);
+            break;
+        case SPNPCodecBoolValue:
+            value = @(((BOOL(*)(id, SEL))getter)(object, selector));
+            break;
+        case SPNPCodecIntValue:
+            value = @(((int(*)(id, SEL))getter)(object, selector));
+            break;
+        case SPNPCodecUnsignedIntValue:
+            value = @(((unsigned int(*)(id, SEL))getter)(object, selector));
+            break;
+        case SPNPCodecLongLongValue:
+            value = @(((long long(*)(id, SEL))getter)(object, selector));
+            break;
+        case SPNPCodecUnsignedLongLongValue:
+            value = @(((unsigned long long(*)(id, SEL))getter)(object, selector));
+            break;
+        case SPNPCodecDoubleValue:
+            value = @(((double(*)(id, SEL))getter)(object, selector));
+            break;
+        case SPNPCodecFloatValue:
+            value = @(((float(*)(id, SEL))getter)(object, selector));
+            break;
+        default:
+            value = [object valueForKey:self.propertyNames[propertyIdx]];
+            break;
+    }
+
+    return value;
+}
+
+- (void)setValue:(id)value atIndex:(NSUInteger)propertyIdx forObject:(id)object {
+
+    SPNPCodecProperty *accessors = &self.properties[propertyIdx];
+    IMP setter = accessors->setterImplementation;
+    SEL selector = accessors->setter;
+    BOOL isScalar = (accessors->type != SPNPCodecObjectValue);
+    if (!setter || (isScalar && ![value isKindOfClass:NSNumber.class])) { accessors = NULL; }
+    switch (accessors ? accessors->type : SPNPCodecUnknownValue) {
+        case SPNPCodecObjectValue:
+            ((void(*)(id, SEL, id))setter)(object, selector, value);
+            break;
+        case SPNPCodecBoolValue:
+            ((void(*)(id, SEL, BOOL))setter)(object, selector, [value boolValue]);
+            break;
+        case SPNPCodecIntValue:
+            ((void(*)(id, SEL, int))setter)(object, selector, [value intValue]);
+            break;
+        case SPNPCodecUnsignedIntValue:
+            ((void(*)(id, SEL, unsigned int))setter)(object, selector, [value unsignedIntValue]);
+            break;
+        case SPNPCodecLongLongValue:
+            ((void(*)(id, SEL, long long))setter)(object, selector, [value longLongValue]);
+            break;
+        case SPNPCodecUnsignedLongLongValue:
+            ((void(*)(id, SEL, unsigned long long))setter)(object, selector,
+                                                           [value unsignedLongLongValue]);
+            break;
+        case SPNPCodecDoubleValue:
+            ((void(*)(id, SEL, double))setter)(object, selector, [value doubleValue]);
+            break;
+        case SPNPCodecFloatValue:
+            ((void(*)(id, SEL, float))setter)(object, selector, [value floatValue]);
+            break;
+        default:
+            [object setValue:value forKey:self.propertyNames[propertyIdx]];
+            break;
+    }
+}
+
+
+#pragma mark - Misc
+
++ (NSMapTable *)codecs {
+
+    static NSMapTable *_sharedCodecs;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+
+        _sharedCodecs = [NSMapTable mapTableWithKeyOptions:(NSPointerFunctionsOpaqueMemory |
+                                                            NSPointerFunctionsOpaquePersonality)
+                                              valueOptions:NSPointerFunctionsStrongMemory];
+    });
+
+    return _sharedCodecs;
+}
+
++ (NSMutableDictionary *)classNames {
+
+    static NSMutableDictionary *_sharedClassNames;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+
+        _sharedClassNames = [NSMutableDictionary new];
+    });
+
+    return _sharedClassNames;
+}
+
++ (SPNPCodecValueType)typeOfProperty:(objc_property_t)property {
+
+    SPNPCodecValueType type = SPNPCodecUnknownValue;
+    char *encoding = property_copyAttributeValue(property, "T");
+    if (encoding) {
+
+        switch (encoding[0]) {
+            case '@':
+                type = SPNPCodecObjectValue;
+                break;
+            case 'B':
+            case 'c':
+                type = SPNPCodecBoolValue;
+                break;
+            case 'i':
+                type = SPNPCodecIntValue;
+                break;
+            case 'I':
+                type = SPNPCodecUnsignedIntValue;
+                break;
+            case 'q':
+                type = SPNPCodecLongLongValue;
+                break;
+            case 'Q':
+                type = SPNPCodecUnsignedLongLongValue;
+                break;
+            case 'd':
+                type = SPNPCodecDoubleValue;
+                break;
+            case 'f':
+                type = SPNPCodecFloatValue;
+                break;
+            default:
+                break;
+        }
+        free(encoding);
+    }
+
+    return type;
+}
+
++ (SEL)accessorForProperty:(objc_property_t)property attribute:(const char *)attribute
+                      name:(NSString *)name {
+
+    SEL accessor = NULL;
+    char *accessorName = property_copyAttributeValue(property, attribute);
+    if (accessorName) {
+
+        accessor = sel_registerName(accessorName);
+        free(accessorName);
+    }
+    else if (strcmp(attribute, "S") == 0) {
+
+        NSString *setterName = [NSString stringWithFormat:@"set%@%@:",
+                                [name substringToIndex:1].uppercaseString, [name substringFromIndex:1]];
+        accessor = NSSelectorFromString(setterName);
+    }
+    else { accessor = NSSelectorFromString(name); }
+
+    return accessor;
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,58 @@
+#import <Foundation/Foundation.h>
+
+
+/**
+ @brief      Table of interned strings.
+ @discussion Equal strings received from different sources (poll identifier in each response, 
+             response title in poll and in each statistic update) replaced with single shared 
+             instance, so poll with many response variants keep only one copy of each string in 
+             memory. Table doesn't retain strings: entry disappear as soon as last model which used 
+             string is released.
+             Table is thread-safe.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPStringTable : NSObject
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores number of strings which currently interned in table.
+ */
+@property (nonatomic, readonly, assign) NSUInteger count;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Retrieve reference on table which is shared by models.
+ 
+ @return Shared strings table.
+ */
++ (instancetype)sharedTable;
+
+
+///------------------------------------------------
+/// @name Interning
+///------------------------------------------------
+
+/**
+ @brief  Retrieve shared instance of string.
+ 
+ @param string Reference on string which should be interned.
+ 
+ @return Previously interned string equal to \c string or immutable copy of \c string (it will be
+         returned for equal strings from now on). \c nil in case if \c nil has been passed.
+ */
+- (NSString *)internedString:(NSString *)string;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,103 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPStringTable.h"
+#import <pthread.h>
+
+
+#pragma mark Private interface declaration
+
+@interface SPNPStringTable () {
+    
+    /**
+     @brief  Stores reference on lock which is used to protect strings table.
+     */
+    pthread_mutex_t _lock;
+}
+
+
+#pragma mark - Properties
+
+/**
+ @brief  Stores reference on table which weakly reference interned strings.
+ */
+@property (nonatomic, strong) NSHashTable *strings;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPStringTable
+
+
+#pragma mark - Information
+
+- (NSUInteger)count {
+    
+    pthread_mutex_lock(&_lock);
+    NSUInteger count = self.strings.allObjects.count;
+    pthread_mutex_unlock(&_lock);
+    
+    return count;
+}
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)sharedTable {
+    
+    static SPNPStringTable *_sharedTable;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        
+        _sharedTable = [self new];
+    });
+    
+    return _sharedTable;
+}
+
+- (instancetype)init {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        pthread_mutex_init(&_lock, NULL);
+        _strings = [NSHashTable weakObjectsHashTable];
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    
+    pthread_mutex_destroy(&_lock);
+}
+
+
+#pragma mark - Interning
+
+- (NSString *)internedString:(NSString *)string {
+    
+    if (!string) { return nil; }
+    
+    pthread_mutex_lock(&_lock);
+    NSString *internedString = [self.strings member:string];
+    if (!internedString) {
+        
+        internedString = [string copy];
+        [self.strings addObject:internedString];
+    }
+    pthread_mutex_unlock(&_lock);
+    
+    return internedString;
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,153 @@
+#import <Foundation/Foundation.h>
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores maximum number of attendees which can be tracked for single poll.
+ */
+static NSUInteger const kSPNPVoterIndexMaximumVotersCount = 1048576;
+
+/**
+ @brief      Stores value which is returned on attempt to register choice which can't be tracked.
+ @discussion Choice of new voter can't be tracked when index is full (or can't allocate bigger 
+             table). Such votes still should be counted, but reported as untracked, because repeated
+             votes from same voter won't be detected.
+ */
+static NSUInteger const kSPNPVoterIndexFull = (NSNotFound - 1);
+
+
+/**
+ @brief      Memory-compact index of poll attendees votes.
+ @discussion Index store 64-bit fingerprint of voter identifier (attendee \c UUID) and chosen 
+             response order number in open addressing hash table, so both "has voted" and 
+             "previous choice" lookups take constant time and each voter costs 12 bytes of table 
+             storage (not more than 32 bytes with table load factor).
+             Index doesn't grow over specified maximum number of voters to keep memory usage 
+             bounded.
+             Index is not thread-safe and should be used from single queue.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPVoterIndex : NSObject
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores number of voters which has been registered in index.
+ */
+@property (nonatomic, readonly, assign) NSUInteger count;
+
+/**
+ @brief  Stores maximum number of voters which can be registered in index.
+ */
+@property (nonatomic, readonly, assign) NSUInteger maximumCount;
+
+/**
+ @brief  Stores number of bytes which is used by index table.
+ */
+@property (nonatomic, readonly, assign) NSUInteger memoryUsage;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure voters index.
+ 
+ @param maximumCount Maximum number of voters which can be registered in index.
+ 
+ @return Configured and ready to use voters index.
+ */
++ (instancetype)indexWithMaximumCount:(NSUInteger)maximumCount;
+
+
+///------------------------------------------------
+/// @name Fingerprints
+///------------------------------------------------
+
+/**
+ @brief      Compute 64-bit voter identifier fingerprint.
+ @discussion \c UUID identifiers folded from their binary representation, other identifiers hashed
+             as UTF-8 string. Fingerprint can be stored elsewhere (for example in votes log) and used
+             to register voter's choice later.
+ 
+ @param voter Reference on voter identifier.
+ 
+ @return Non-zero voter fingerprint.
+ */
++ (uint64_t)keyForVoter:(NSString *)voter;
+
+/**
+ @brief      Compute 64-bit voter identifier fingerprint from raw identifier representation.
+ @discussion Allow to compute fingerprint right from received message (without identifier string
+             creation). Fingerprint is the same as one returned by \c +keyForVoter: for same
+             identifier.
+ 
+ @param bytes  Pointer on 16 bytes \c UUID or UTF-8 identifier bytes.
+ @param length Number of identifier bytes.
+ @param isUUID Whether \c bytes store binary \c UUID representation or not.
+ 
+ @return Non-zero voter fingerprint.
+ */
++ (uint64_t)keyForVoterBytes:(const uint8_t *)bytes length:(NSUInteger)length isUUID:(BOOL)isUUID;
+
+
+///------------------------------------------------
+/// @name Voters
+///------------------------------------------------
+
+/**
+ @brief  Retrieve response order number which has been chosen by voter.
+ 
+ @param voter Reference on voter identifier.
+ 
+ @return Response order number or \c NSNotFound in case if voter didn't vote yet.
+ */
+- (NSUInteger)choiceForVoter:(NSString *)voter;
+
+/**
+ @brief      Register voter's choice.
+ @discussion Lookup and registration performed with single hash table probe.
+ 
+ @param choice        Response order number which has been chosen by voter.
+ @param voter         Reference on voter identifier.
+ @param shouldReplace Whether previously registered choice should be replaced or not.
+ 
+ @return Previously registered response order number, \c NSNotFound in case if this is first 
+         voter's vote or \c kSPNPVoterIndexFull in case if vote can't be tracked.
+ */
+- (NSUInteger)registerChoice:(NSUInteger)choice forVoter:(NSString *)voter
+           replacingExisting:(BOOL)shouldReplace;
+
+/**
+ @brief  Register voter's choice using voter fingerprint.
+ 
+ @param choice        Response order number which has been chosen by voter.
+ @param key           Non-zero voter fingerprint (computed with \c +keyForVoter:).
+ @param shouldReplace Whether previously registered choice should be replaced or not.
+ 
+ @return Previously registered response order number, \c NSNotFound in case if this is first 
+         voter's vote or \c kSPNPVoterIndexFull in case if vote can't be tracked.
+ */
+- (NSUInteger)registerChoice:(NSUInteger)choice forKey:(uint64_t)key
+           replacingExisting:(BOOL)shouldReplace;
+
+/**
+ @brief  Enumerate registered voters choices.
+ 
+ @param block Reference on block which is called for each registered voter. Block pass two 
+              arguments: \c key - voter fingerprint; \c choice - response order number which has
+              been chosen by voter.
+ */
+- (void)enumerateChoicesUsingBlock:(void(^)(uint64_t key, NSUInteger choice))block;
+
+#pragma mark -
+
+
+@end
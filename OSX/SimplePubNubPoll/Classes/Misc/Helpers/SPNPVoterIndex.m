@@ -0,0 +1,287 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPVoterIndex.h"
+#import <uuid/uuid.h>
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores initial number of hash table slots.
+ */
+static NSUInteger const kSPNPVoterIndexInitialCapacity = 1024;
+
+/**
+ @brief  Stores value which is used to mark empty hash table slot.
+ */
+static uint64_t const kSPNPVoterIndexEmptyKey = 0;
+
+
+#pragma mark - Private interface declaration
+
+@interface SPNPVoterIndex ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, assign) NSUInteger count;
+@property (nonatomic, assign) NSUInteger maximumCount;
+
+/**
+ @brief  Stores number of hash table slots (always power of two).
+ */
+@property (nonatomic, assign) NSUInteger capacity;
+
+/**
+ @brief  Stores reference on voter fingerprints and choices tables.
+ */
+@property (nonatomic, assign) uint64_t *keys;
+@property (nonatomic, assign) uint32_t *choices;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize voters index.
+ 
+ @param maximumCount Maximum number of voters which can be registered in index.
+ 
+ @return Initialized and ready to use voters index.
+ */
+- (instancetype)initWithMaximumCount:(NSUInteger)maximumCount;
+
+
+#pragma mark - Hash table
+
+/**
+ @brief  Find slot which store voter's fingerprint or empty slot which can be used for it.
+ 
+ @param key Reference on voter fingerprint.
+ 
+ @return Slot index.
+ */
+- (NSUInteger)slotForKey:(uint64_t)key;
+
+/**
+ @brief  Double hash table capacity (if it doesn't exceed limits).
+ 
+ @return \c YES in case if table has been extended.
+ */
+- (BOOL)grow;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPVoterIndex
+
+
+#pragma mark - Information
+
+- (NSUInteger)memoryUsage {
+    
+    return (self.capacity * (sizeof(uint64_t) + sizeof(uint32_t)));
+}
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)indexWithMaximumCount:(NSUInteger)maximumCount {
+    
+    return [[self alloc] initWithMaximumCount:maximumCount];
+}
+
+- (instancetype)initWithMaximumCount:(NSUInteger)maximumCount {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _maximumCount = maximumCount;
+        _capacity = kSPNPVoterIndexInitialCapacity;
+        _keys = calloc(_capacity, sizeof(uint64_t));
+        _choices = calloc(_capacity, sizeof(uint32_t));
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    
+    free(_keys);
+    free(_choices);
+}
+
+
+#pragma mark - Voters
+
+- (NSUInteger)choiceForVoter:(NSString *)voter {
+    
+    NSUInteger choice = NSNotFound;
+    uint64_t key = [SPNPVoterIndex keyForVoter:voter];
+    NSUInteger slot = [self slotForKey:key];
+    if (self.keys[slot] == key) { choice = self.choices[slot]; }
+    
+    return choice;
+}
+
+- (NSUInteger)registerChoice:(NSUInteger)choice forVoter:(NSString *)voter
+           replacingExisting:(BOOL)shouldReplace {
+    
+    return [self registerChoice:choice forKey:[SPNPVoterIndex keyForVoter:voter]
+              replacingExisting:shouldReplace];
+}
+
+- (NSUInteger)registerChoice:(NSUInteger)choice forKey:(uint64_t)key
+           replacingExisting:(BOOL)shouldReplace {
+    
+    NSUInteger previousChoice = NSNotFound;
+    NSUInteger slot = [self slotForKey:key];
+    if (self.keys[slot] == key) {
+        
+        previousChoice = self.choices[slot];
+        if (shouldReplace) { self.choices[slot] = (uint32_t)choice; }
+    }
+    else {
+        
+        previousChoice = kSPNPVoterIndexFull;
+        if (choice < MIN(UINT32_MAX, kSPNPVoterIndexFull) && self.count < self.maximumCount) {
+            
+            // Keep load factor below 3/4 to make sure what probe sequences stay short.
+            BOOL isGrown = ((self.count + 1) * 4 > self.capacity * 3 && [self grow]);
+            if (isGrown) { slot = [self slotForKey:key]; }
+            if ((self.count + 1) * 4 <= self.capacity * 3) {
+                
+                self.keys[slot] = key;
+                self.choices[slot] = (uint32_t)choice;
+                self.count++;
+                previousChoice = NSNotFound;
+            }
+        }
+    }
+    
+    return previousChoice;
+}
+
+- (void)enumerateChoicesUsingBlock:(void(^)(uint64_t key, NSUInteger choice))block {
+    
+    for (NSUInteger slot = 0; slot < self.capacity; slot++) {
+        
+        if (self.keys[slot] != kSPNPVoterIndexEmptyKey) { block(self.keys[slot], self.choices[slot]); }
+    }
+}
+
+
+#pragma mark - Hash table
+
+- (NSUInteger)slotForKey:(uint64_t)key {
+    
+    NSUInteger mask = (self.capacity - 1);
+    NSUInteger slot = (NSUInteger)(key & mask);
+    while (self.keys[slot] != kSPNPVoterIndexEmptyKey && self.keys[slot] != key) {
+        
+        slot = ((slot + 1) & mask);
+    }
+    
+    return slot;
+}
+
+- (BOOL)grow {
+    
+    BOOL isGrown = NO;
+    uint64_t *keys = NULL;
+    uint32_t *choices = NULL;
+    NSUInteger capacity = (self.capacity * 2);
+    if (self.capacity / 4 * 3 < self.maximumCount) {
+        
+        keys = calloc(capacity, sizeof(uint64_t));
+        choices = calloc(capacity, sizeof(uint32_t));
+    }
+    if (keys && choices) {
+        
+        uint64_t *oldKeys = self.keys;
+        uint32_t *oldChoices = self.choices;
+        NSUInteger oldCapacity = self.capacity;
+        self.keys = keys;
+        self.choices = choices;
+        self.capacity = capacity;
+        for (NSUInteger slotIdx = 0; slotIdx < oldCapacity; slotIdx++) {
+            
+            if (oldKeys[slotIdx] != kSPNPVoterIndexEmptyKey) {
+                
+                NSUInteger slot = [self slotForKey:oldKeys[slotIdx]];
+                keys[slot] = oldKeys[slotIdx];
+                choices[slot] = oldChoices[slotIdx];
+            }
+        }
+        free(oldKeys);
+        free(oldChoices);
+        isGrown = YES;
+    }
+    else {
+        
+        free(keys);
+        free(choices);
+    }
+    
+    return isGrown;
+}
+
+
+#pragma mark - Fingerprints
+
++ (uint64_t)keyForVoter:(NSString *)voter {
+    
+    // Identifier parsed from stack buffer, so fingerprint computed without allocations.
+    uuid_t uuid;
+    char string[37];
+    if (voter.length == 36 && [voter getCString:string maxLength:sizeof(string)
+                                       encoding:NSASCIIStringEncoding] &&
+        uuid_parse(string, uuid) == 0) {
+        
+        return [self keyForVoterBytes:uuid length:sizeof(uuid_t) isUUID:YES];
+    }
+    
+    const uint8_t *bytes = (const uint8_t *)voter.UTF8String;
+    
+    return [self keyForVoterBytes:bytes length:(bytes ? strlen((const char *)bytes) : 0) isUUID:NO];
+}
+
++ (uint64_t)keyForVoterBytes:(const uint8_t *)bytes length:(NSUInteger)length isUUID:(BOOL)isUUID {
+    
+    uint64_t key = 0;
+    if (isUUID && length == sizeof(uuid_t)) {
+        
+        uint64_t words[2];
+        memcpy(words, bytes, sizeof(words));
+        key = (words[0] ^ (words[1] * 0x9E3779B97F4A7C15ULL));
+    }
+    else {
+        
+        // FNV-1a hash of UTF-8 representation.
+        key = 0xCBF29CE484222325ULL;
+        for (NSUInteger byteIdx = 0; bytes && byteIdx < length && bytes[byteIdx]; byteIdx++) {
+            
+            key = ((key ^ bytes[byteIdx]) * 0x100000001B3ULL);
+        }
+    }
+    
+    // Final bits mixing (to spread fingerprints over hash table slots).
+    key ^= (key >> 33);
+    key *= 0xFF51AFD7ED558CCDULL;
+    key ^= (key >> 33);
+    key *= 0xC4CEB9FE1A85EC53ULL;
+    key ^= (key >> 33);
+    
+    return (key != kSPNPVoterIndexEmptyKey ? key : 1);
+}
+
+#pragma mark -
+
+
+@end
@@ -39,6 +39,101 @@
  */
 @property (nonatomic, readonly, copy) NSArray *responses;
 
+/**
+ @brief      Stores reference on short poll token.
+ @discussion Token used by compact message representation in place of poll identifier.
+ */
+@property (nonatomic, readonly, strong) NSNumber *token;
+
+/**
+ @brief      Stores reference on list of message encodings which is supported by poll host.
+ @discussion Attendees use this list to negotiate encoding for their responses. Hosts which 
+             doesn't provide this list support only \c JSON dictionaries.
+ */
+@property (nonatomic, readonly, copy) NSArray *encodings;
+
+/**
+ @brief      Stores reference on real-time network time token (10^-7 seconds since 1970) at which 
+             poll has been announced.
+ @discussion Used by host to find first message in responses history when votes has to be recounted.
+             Polls announced by older hosts (or by host which wasn't able to get time token) doesn't
+             provide this value.
+ */
+@property (nonatomic, readonly, strong) NSNumber *startTimetoken;
+
+/**
+ @brief      Stores number of channels into which attendees send their responses.
+ @discussion Each attendee send responses to the same shard channel which is chosen using his 
+             \c UUID fingerprint. Polls announced by older hosts doesn't provide this value (single
+             responses channel used).
+ */
+@property (nonatomic, readonly, strong) NSNumber *answerShardsCount;
+
+/**
+ @brief      Stores whether attendees respond with free text instead of choosing one of response 
+             variants.
+ @discussion Open-text poll doesn't have \c responses and attendees send \b SPNPPollTextResponse 
+             (for example "one word to describe this talk").
+ */
+@property (nonatomic, readonly, assign, getter = isOpenText) BOOL openText;
+
+/**
+ @brief      Stores whether attendees rank response variants instead of choosing one of them.
+ @discussion Attendees send \b SPNPPollRankedResponse and host count them with instant-runoff.
+ */
+@property (nonatomic, readonly, assign, getter = isRanked) BOOL ranked;
+
+/**
+ @brief      Stores whether attendees respond with numeric rating instead of choosing one of 
+             response variants.
+ @discussion Attendees send \b SPNPPollRatingResponse with integer value from 
+             [\c minimumRating, \c maximumRating] range.
+ */
+@property (nonatomic, readonly, assign, getter = isRating) BOOL rating;
+
+/**
+ @brief  Stores reference on lowest value on rating poll scale.
+ */
+@property (nonatomic, readonly, strong) NSNumber *minimumRating;
+
+/**
+ @brief  Stores reference on highest value on rating poll scale.
+ */
+@property (nonatomic, readonly, strong) NSNumber *maximumRating;
+
+/**
+ @brief      Stores reference on name of channel into which host publish poll statistic.
+ @discussion Additional polls statistic published to own channels. Polls announced without this
+             value (primary polls and polls announced by older hosts) use default poll statistic
+             channel.
+ */
+@property (nonatomic, readonly, copy) NSString *statisticsChannel;
+
+
+///------------------------------------------------
+/// @name Limits
+///------------------------------------------------
+
+/**
+ @brief      Retrieve maximum number of response variants which can be used by poll.
+ @discussion Statistic stored in contiguous storage, so polls like "pick your session" with 
+             hundreds of variants can be used. Poll with this number of variants still may not fit
+             into announcement message (depending on response titles length), so it should be 
+             checked with \c -fitsIntoAnnouncement.
+ 
+ @return Maximum number of response variants.
+ */
++ (NSUInteger)maximumResponsesCount;
+
+/**
+ @brief      Check whether poll can be announced with single message.
+ @discussion Measured size of escaped JSON representation (which include all response titles) 
+             compared with PubNub message size limit.
+ 
+ @return \c YES in case if poll announcement doesn't exceed message size limit.
+ */
+- (BOOL)fitsIntoAnnouncement;
+
 
 ///------------------------------------------------
 /// @name Initialization and Configuration
@@ -54,6 +149,65 @@
  */
 + (instancetype)pollWithQuestion:(NSString *)question responses:(NSArray *)responseVariants;
 
+/**
+ @brief  Create and configure polling model which collect responses using several channels.
+ 
+ @param question          Question on which attendees should respond.
+ @param responseVariants  List of response variants from which user should choose.
+ @param answerShardsCount Number of channels into which attendees should send their responses.
+ 
+ @return Configured and ready to use polling model.
+ */
++ (instancetype)pollWithQuestion:(NSString *)question responses:(NSArray *)responseVariants
+                    answerShards:(NSUInteger)answerShardsCount;
+
+/**
+ @brief  Create and configure polling model on which attendees respond with free text.
+ 
+ @param question          Question on which attendees should respond.
+ @param answerShardsCount Number of channels into which attendees should send their responses.
+ 
+ @return Configured and ready to use polling model.
+ */
++ (instancetype)openTextPollWithQuestion:(NSString *)question
+                            answerShards:(NSUInteger)answerShardsCount;
+
+/**
+ @brief  Create and configure polling model on which attendees rank response variants.
+ 
+ @param question          Question on which attendees should respond.
+ @param responseVariants  List of response variants which attendees should rank.
+ @param answerShardsCount Number of channels into which attendees should send their ballots.
+ 
+ @return Configured and ready to use polling model.
+ */
++ (instancetype)rankedPollWithQuestion:(NSString *)question responses:(NSArray *)responseVariants
+                          answerShards:(NSUInteger)answerShardsCount;
+
+/**
+ @brief  Create and configure polling model on which attendees respond with numeric rating.
+ 
+ @param question          Question on which attendees should respond.
+ @param minimumRating     Lowest value on rating scale.
+ @param maximumRating     Highest value on rating scale.
+ @param answerShardsCount Number of channels into which attendees should send their ratings.
+ 
+ @return Configured and ready to use polling model.
+ */
++ (instancetype)ratingPollWithQuestion:(NSString *)question minimumRating:(NSInteger)minimumRating
+                         maximumRating:(NSInteger)maximumRating
+                          answerShards:(NSUInteger)answerShardsCount;
+
+/**
+ @brief      Choose responses channel shard for attendee.
+ @discussion Host use the same rule to partition index of attendees which voted between shards.
+ 
+ @param voterKey Attendee \c UUID fingerprint (computed with \b SPNPVoterIndex).
+ 
+ @return Index of shard into which attendee should send responses.
+ */
+- (NSUInteger)answerShardForVoterKey:(uint64_t)voterKey;
+
 /**
  @brief  Construct from existing poll instance the same but in inactive state.
  
@@ -61,6 +215,24 @@
  */
 - (instancetype)completedPoll;
 
+/**
+ @brief  Construct from existing poll instance the same but with specified start time token.
+ 
+ @param timetoken Reference on real-time network time token at which poll has been announced.
+ 
+ @return Reference on poll instance which has start time token.
+ */
+- (instancetype)pollStartedAt:(NSNumber *)timetoken;
+
+/**
+ @brief  Construct from existing poll instance the same but with specified statistic channel.
+ 
+ @param channel Reference on name of channel into which host publish poll statistic.
+ 
+ @return Reference on poll instance which has statistic channel.
+ */
+- (instancetype)pollWithStatisticsChannel:(NSString *)channel;
+
 #pragma mark - 
 
 
@@ -4,9 +4,26 @@
  */
 #import "SPNPPoll.h"
 #import "SPNPPollResponse.h"
+#import "SPNPCompactCoder.h"
+#import "SPNPStringTable.h"
 
 
-#pragma mark Private interface declaration
+#pragma mark Static
+
+/**
+ @brief  Stores maximum number of response variants which can be used by poll.
+ */
+static NSUInteger const kSPNPPollMaximumResponsesCount = 1000;
+
+/**
+ @brief      Stores maximum size of poll announcement message.
+ @discussion PubNub limit size of published message (with channel name and escaped characters) to 
+             32 KiB. Part of limit reserved for channel name and mobile push payload.
+ */
+static NSUInteger const kSPNPPollMaximumAnnouncementSize = (32768 - 1024);
+
+
+#pragma mark - Private interface declaration
 
 @interface SPNPPoll ()
 
@@ -17,6 +34,16 @@
 @property (nonatomic, assign, getter = isActive) BOOL active;
 @property (nonatomic, copy) NSString *question;
 @property (nonatomic, copy) NSArray *responses;
+@property (nonatomic, strong) NSNumber *token;
+@property (nonatomic, copy) NSArray *encodings;
+@property (nonatomic, strong) NSNumber *startTimetoken;
+@property (nonatomic, strong) NSNumber *answerShardsCount;
+@property (nonatomic, assign, getter = isOpenText) BOOL openText;
+@property (nonatomic, assign, getter = isRanked) BOOL ranked;
+@property (nonatomic, assign, getter = isRating) BOOL rating;
+@property (nonatomic, strong) NSNumber *minimumRating;
+@property (nonatomic, strong) NSNumber *maximumRating;
+@property (nonatomic, copy) NSString *statisticsChannel;
 
 
 #pragma mark - Initialization and Configuration
@@ -55,6 +82,26 @@
 @implementation SPNPPoll
 
 
+#pragma mark - Limits
+
++ (NSUInteger)maximumResponsesCount {
+    
+    return kSPNPPollMaximumResponsesCount;
+}
+
+- (BOOL)fitsIntoAnnouncement {
+    
+    // Size measured in the same way as PubNub does: escaped JSON representation.
+    NSData *data = [NSJSONSerialization dataWithJSONObject:[self dictionaryRepresentation]
+                                                   options:(NSJSONWritingOptions)0 error:NULL];
+    NSString *message = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+    NSCharacterSet *allowedCharacters = [NSCharacterSet URLQueryAllowedCharacterSet];
+    message = [message stringByAddingPercentEncodingWithAllowedCharacters:allowedCharacters];
+    
+    return (message && message.length <= kSPNPPollMaximumAnnouncementSize);
+}
+
+
 #pragma mark - Initialization and Configuration
 
 + (instancetype)pollWithQuestion:(NSString *)question responses:(NSArray *)responseVariants {
@@ -62,12 +109,54 @@
     return [[self alloc] initWithQuestion:question responses:responseVariants];
 }
 
++ (instancetype)pollWithQuestion:(NSString *)question responses:(NSArray *)responseVariants
+                    answerShards:(NSUInteger)answerShardsCount {
+    
+    SPNPPoll *poll = [self pollWithQuestion:question responses:responseVariants];
+    if (answerShardsCount > 1) { poll.answerShardsCount = @(answerShardsCount); }
+    
+    return poll;
+}
+
++ (instancetype)openTextPollWithQuestion:(NSString *)question
+                            answerShards:(NSUInteger)answerShardsCount {
+    
+    SPNPPoll *poll = [self pollWithQuestion:question responses:nil answerShards:answerShardsCount];
+    poll.openText = YES;
+    
+    return poll;
+}
+
++ (instancetype)rankedPollWithQuestion:(NSString *)question responses:(NSArray *)responseVariants
+                          answerShards:(NSUInteger)answerShardsCount {
+    
+    SPNPPoll *poll = [self pollWithQuestion:question responses:responseVariants
+                               answerShards:answerShardsCount];
+    poll.ranked = YES;
+    
+    return poll;
+}
+
++ (instancetype)ratingPollWithQuestion:(NSString *)question minimumRating:(NSInteger)minimumRating
+                         maximumRating:(NSInteger)maximumRating
+                          answerShards:(NSUInteger)answerShardsCount {
+    
+    SPNPPoll *poll = [self pollWithQuestion:question responses:nil answerShards:answerShardsCount];
+    poll.rating = YES;
+    poll.minimumRating = @(minimumRating);
+    poll.maximumRating = @(maximumRating);
+    
+    return poll;
+}
+
 - (instancetype)initWithQuestion:(NSString *)question responses:(NSArray *)responseVariants {
     
     // Check whether initialization was successful or not.
     if ((self = [super init])) {
         
         _identifier = [NSUUID UUID].UUIDString;
+        _token = @(arc4random_uniform(0x1FFFFF) + 1);
+        _encodings = @[@"json", [SPNPCompactCoder formatName]];
         _active = YES;
         _question = [question copy];
         _responses = [self responsesFromList:responseVariants];
@@ -84,6 +173,31 @@
     return [self.class objectFromDictionaryRepresentation:pollData];
 }
 
+- (instancetype)pollStartedAt:(NSNumber *)timetoken {
+    
+    NSMutableDictionary *pollData = [[self dictionaryRepresentation] mutableCopy];
+    pollData[@"startTimetoken"] = timetoken;
+    
+    return [self.class objectFromDictionaryRepresentation:pollData];
+}
+
+- (instancetype)pollWithStatisticsChannel:(NSString *)channel {
+    
+    NSMutableDictionary *pollData = [[self dictionaryRepresentation] mutableCopy];
+    pollData[@"statisticsChannel"] = channel;
+    
+    return [self.class objectFromDictionaryRepresentation:pollData];
+}
+
+- (NSUInteger)answerShardForVoterKey:(uint64_t)voterKey {
+    
+    // High fingerprint bits used, because low bits choose voters index table slot and shard's
+    // index would be filled unevenly.
+    NSUInteger count = MAX(self.answerShardsCount.unsignedIntegerValue, 1);
+    
+    return (NSUInteger)((voterKey >> 32) % count);
+}
+
 - (void)setResponses:(NSArray *)responses {
     
     [self willChangeValueForKey:@"responses"];
@@ -93,13 +207,72 @@
 }
 
 
+#pragma mark - Compact representation
+
++ (NSUInteger)compactTypeIdentifier {
+    
+    return 1;
+}
+
+- (void)encodeWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    [coder encodePollIdentifier:self.identifier];
+    [coder encodeNumber:self.token];
+    [coder encodeBool:self.isActive];
+    [coder encodeString:self.question];
+    [coder encodeObjects:self.responses];
+    [coder encodeNumber:self.startTimetoken];
+    [coder encodeNumber:self.answerShardsCount];
+    
+    // Optional fields written only till last one which has value.
+    BOOL hasChannel = (self.statisticsChannel != nil);
+    if (hasChannel || self.isOpenText || self.isRanked || self.isRating) {
+        
+        [coder encodeBool:self.isOpenText];
+    }
+    if (hasChannel || self.isRanked || self.isRating) { [coder encodeBool:self.isRanked]; }
+    if (hasChannel || self.isRating) {
+        
+        [coder encodeBool:self.isRating];
+        [coder encodeSignedInteger:self.minimumRating.longLongValue];
+        [coder encodeSignedInteger:self.maximumRating.longLongValue];
+    }
+    if (hasChannel) { [coder encodeString:self.statisticsChannel]; }
+}
+
+- (void)decodeWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    _identifier = [[SPNPStringTable sharedTable] internedString:[coder decodePollIdentifier]];
+    _token = [coder decodeNumber];
+    _active = [coder decodeBool];
+    _question = [[coder decodeString] copy];
+    self.responses = [coder decodeObjectsOfClass:SPNPPollResponse.class];
+    if (!coder.isAtEnd) { _startTimetoken = [coder decodeNumber]; }
+    if (!coder.isAtEnd) { _answerShardsCount = [coder decodeNumber]; }
+    if (!coder.isAtEnd) { _openText = [coder decodeBool]; }
+    if (!coder.isAtEnd) { _ranked = [coder decodeBool]; }
+    if (!coder.isAtEnd) {
+        
+        _rating = [coder decodeBool];
+        long long minimumRating = [coder decodeSignedInteger];
+        long long maximumRating = [coder decodeSignedInteger];
+        if (_rating) {
+            
+            _minimumRating = @(minimumRating);
+            _maximumRating = @(maximumRating);
+        }
+    }
+    if (!coder.isAtEnd) { _statisticsChannel = [[coder decodeString] copy]; }
+}
+
+
 #pragma mark - Misc
 
 - (NSArray *)responsesFromList:(NSArray *)variants {
     
     NSMutableArray *responses = (variants.count ? [NSMutableArray new] : nil);
     for (NSUInteger variantIdx = 0; variantIdx < variants.count; variantIdx++) {
-
+        
         [responses addObject:[SPNPPollResponse pollResponseFor:_identifier withValue:variants[variantIdx]
                                                    orderNumber:@(variantIdx)]];
     }
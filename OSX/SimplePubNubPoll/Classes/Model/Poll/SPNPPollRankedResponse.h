@@ -0,0 +1,59 @@
+#import <Foundation/Foundation.h>
+#import "SPNPSerializable.h"
+
+
+/**
+ @brief      Describes model which store attendee's ranked ballot on ranked-choice poll.
+ @discussion Ballot store response order numbers from most to least preferred. Attendee may rank
+             only some of response variants.
+             Ballot sent only with dictionary representation, so host route it by poll identifier
+             as any other response.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPPollRankedResponse : SPNPSerializable
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on identifier of the poll for which ballot has been sent.
+ */
+@property (nonatomic, readonly, copy) NSString *pollIdentifier;
+
+/**
+ @brief  Stores reference on list of response order numbers (from most preferred).
+ */
+@property (nonatomic, readonly, copy) NSArray *ranking;
+
+/**
+ @brief      Stores reference on unique identifier of attendee which submitted ballot.
+ @discussion Used by host to count only one ballot from each attendee.
+ */
+@property (nonatomic, readonly, copy) NSString *voter;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief      Create and configure attendee's ranked ballot.
+ @discussion Repeated order numbers ignored (only first, most preferred, mention is used).
+ 
+ @param pollIdentifier Identifier of the poll for which ballot should be sent.
+ @param ranking        List of response order numbers (from most preferred).
+ @param voter          Unique identifier of attendee which submit ballot.
+ 
+ @return Configured and ready to use ballot instance or \c nil in case if \c ranking is empty.
+ */
++ (instancetype)rankedResponseFor:(NSString *)pollIdentifier withRanking:(NSArray *)ranking
+                            voter:(NSString *)voter;
+
+#pragma mark -
+
+
+@end
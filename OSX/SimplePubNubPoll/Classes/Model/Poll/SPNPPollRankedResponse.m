@@ -0,0 +1,74 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPPollRankedResponse.h"
+#import "SPNPStringTable.h"
+
+
+#pragma mark Private interface declaration
+
+@interface SPNPPollRankedResponse ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, copy) NSString *pollIdentifier;
+@property (nonatomic, copy) NSArray *ranking;
+@property (nonatomic, copy) NSString *voter;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize attendee's ranked ballot.
+ 
+ @param pollIdentifier Identifier of the poll for which ballot should be sent.
+ @param ranking        List of unique response order numbers (from most preferred).
+ @param voter          Unique identifier of attendee which submit ballot.
+ 
+ @return Initialized and ready to use ballot instance.
+ */
+- (instancetype)initFor:(NSString *)pollIdentifier withRanking:(NSArray *)ranking
+                  voter:(NSString *)voter;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPPollRankedResponse
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)rankedResponseFor:(NSString *)pollIdentifier withRanking:(NSArray *)ranking
+                            voter:(NSString *)voter {
+    
+    NSOrderedSet *uniqueRanking = [NSOrderedSet orderedSetWithArray:ranking];
+    
+    return (uniqueRanking.count ? [[self alloc] initFor:pollIdentifier
+                                            withRanking:uniqueRanking.array voter:voter] : nil);
+}
+
+- (instancetype)initFor:(NSString *)pollIdentifier withRanking:(NSArray *)ranking
+                  voter:(NSString *)voter {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _pollIdentifier = [[SPNPStringTable sharedTable] internedString:pollIdentifier];
+        _ranking = [ranking copy];
+        _voter = [voter copy];
+    }
+    
+    return self;
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,71 @@
+#import <Foundation/Foundation.h>
+#import "SPNPSerializable.h"
+
+
+/**
+ @brief      Describes model which is used to describe ranked-choice poll stats.
+ @discussion Statistic store standings of each instant-runoff round (see 
+             \b SPNPRankedRoundStatistic) till one of responses collect majority of continuing 
+             ballots. Each update is full statistic state (there is no deltas), so attendees only
+             drop updates which is older than applied one.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPPollRankedStatistic : SPNPSerializable
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on target poll identifier.
+ */
+@property (nonatomic, readonly, copy) NSString *pollIdentifier;
+
+/**
+ @brief  Stores reference on statistic stream sequence number.
+ */
+@property (nonatomic, readonly, strong) NSNumber *sequence;
+
+/**
+ @brief  Stores overall number of counted ballots.
+ */
+@property (nonatomic, readonly, strong) NSNumber *ballotsCount;
+
+/**
+ @brief  Stores reference on list of \b SPNPRankedRoundStatistic instances (from first round).
+ */
+@property (nonatomic, readonly, copy) NSArray *rounds;
+
+/**
+ @brief  Stores reference on order number of response which won in last round (\c nil in case if
+         there is no ballots).
+ */
+@property (nonatomic, readonly, strong) NSNumber *winner;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure ranked-choice poll statistic.
+ 
+ @param pollIdentifier Identifier of the poll for which statistic has been gathered.
+ @param rounds         List of \b SPNPRankedRoundStatistic instances (from first round).
+ @param winner         Order number of response which won in last round.
+ @param sequence       Reference on statistic stream sequence number.
+ @param ballotsCount   Overall number of counted ballots.
+ 
+ @return Configured and ready to use statistic instance.
+ */
++ (instancetype)statisticForPoll:(NSString *)pollIdentifier withRounds:(NSArray *)rounds
+                          winner:(NSNumber *)winner sequence:(NSNumber *)sequence
+                    ballotsCount:(unsigned long long)ballotsCount;
+
+#pragma mark -
+
+
+@end
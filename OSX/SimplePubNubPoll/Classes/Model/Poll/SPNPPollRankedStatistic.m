@@ -0,0 +1,110 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPPollRankedStatistic.h"
+#import "SPNPRankedRoundStatistic.h"
+#import "SPNPCompactCoder.h"
+
+
+#pragma mark Private interface declaration
+
+@interface SPNPPollRankedStatistic ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, copy) NSString *pollIdentifier;
+@property (nonatomic, strong) NSNumber *sequence;
+@property (nonatomic, strong) NSNumber *ballotsCount;
+@property (nonatomic, copy) NSArray *rounds;
+@property (nonatomic, strong) NSNumber *winner;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize ranked-choice poll statistic.
+ 
+ @param pollIdentifier Identifier of the poll for which statistic has been gathered.
+ @param rounds         List of \b SPNPRankedRoundStatistic instances (from first round).
+ @param winner         Order number of response which won in last round.
+ @param sequence       Reference on statistic stream sequence number.
+ @param ballotsCount   Overall number of counted ballots.
+ 
+ @return Initialized and ready to use statistic instance.
+ */
+- (instancetype)initForPoll:(NSString *)pollIdentifier withRounds:(NSArray *)rounds
+                     winner:(NSNumber *)winner sequence:(NSNumber *)sequence
+               ballotsCount:(unsigned long long)ballotsCount;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPPollRankedStatistic
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)statisticForPoll:(NSString *)pollIdentifier withRounds:(NSArray *)rounds
+                          winner:(NSNumber *)winner sequence:(NSNumber *)sequence
+                    ballotsCount:(unsigned long long)ballotsCount {
+    
+    return [[self alloc] initForPoll:pollIdentifier withRounds:rounds winner:winner
+                            sequence:sequence ballotsCount:ballotsCount];
+}
+
+- (instancetype)initForPoll:(NSString *)pollIdentifier withRounds:(NSArray *)rounds
+                     winner:(NSNumber *)winner sequence:(NSNumber *)sequence
+               ballotsCount:(unsigned long long)ballotsCount {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _pollIdentifier = [pollIdentifier copy];
+        _rounds = [rounds copy];
+        _winner = winner;
+        _sequence = sequence;
+        _ballotsCount = @(ballotsCount);
+    }
+    
+    return self;
+}
+
+
+#pragma mark - Compact representation
+
++ (NSUInteger)compactTypeIdentifier {
+    
+    return 10;
+}
+
+- (void)encodeWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    // Zero is valid response order number, so winner presence encoded separately.
+    [coder encodePollIdentifier:self.pollIdentifier];
+    [coder encodeNumber:self.sequence];
+    [coder encodeNumber:self.ballotsCount];
+    [coder encodeBool:(self.winner != nil)];
+    if (self.winner) { [coder encodeUnsignedInteger:self.winner.unsignedIntegerValue]; }
+    [coder encodeObjects:self.rounds];
+}
+
+- (void)decodeWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    _pollIdentifier = [[coder decodePollIdentifier] copy];
+    _sequence = [coder decodeNumber];
+    _ballotsCount = [coder decodeNumber];
+    if ([coder decodeBool]) { _winner = @([coder decodeUnsignedInteger]); }
+    _rounds = [coder decodeObjectsOfClass:SPNPRankedRoundStatistic.class];
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,56 @@
+#import <Foundation/Foundation.h>
+#import "SPNPSerializable.h"
+
+
+/**
+ @brief      Describes model which store attendee's numeric rating on rating poll.
+ @discussion Response sent only with dictionary representation, so host route it by poll 
+             identifier as any other response.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPPollRatingResponse : SPNPSerializable
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on identifier of the poll for which rating has been sent.
+ */
+@property (nonatomic, readonly, copy) NSString *pollIdentifier;
+
+/**
+ @brief  Stores reference on integer value from poll's rating scale.
+ */
+@property (nonatomic, readonly, strong) NSNumber *rating;
+
+/**
+ @brief      Stores reference on unique identifier of attendee which submitted rating.
+ @discussion Used by host to count only one rating from each attendee.
+ */
+@property (nonatomic, readonly, copy) NSString *voter;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure attendee's rating.
+ 
+ @param pollIdentifier Identifier of the poll for which rating should be sent.
+ @param rating         Integer value from poll's rating scale.
+ @param voter          Unique identifier of attendee which submit rating.
+ 
+ @return Configured and ready to use rating instance.
+ */
++ (instancetype)ratingResponseFor:(NSString *)pollIdentifier withRating:(NSInteger)rating
+                            voter:(NSString *)voter;
+
+#pragma mark -
+
+
+@end
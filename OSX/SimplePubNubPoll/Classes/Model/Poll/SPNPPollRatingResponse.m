@@ -0,0 +1,71 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPPollRatingResponse.h"
+#import "SPNPStringTable.h"
+
+
+#pragma mark Private interface declaration
+
+@interface SPNPPollRatingResponse ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, copy) NSString *pollIdentifier;
+@property (nonatomic, strong) NSNumber *rating;
+@property (nonatomic, copy) NSString *voter;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize attendee's rating.
+ 
+ @param pollIdentifier Identifier of the poll for which rating should be sent.
+ @param rating         Integer value from poll's rating scale.
+ @param voter          Unique identifier of attendee which submit rating.
+ 
+ @return Initialized and ready to use rating instance.
+ */
+- (instancetype)initFor:(NSString *)pollIdentifier withRating:(NSInteger)rating
+                  voter:(NSString *)voter;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPPollRatingResponse
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)ratingResponseFor:(NSString *)pollIdentifier withRating:(NSInteger)rating
+                            voter:(NSString *)voter {
+    
+    return [[self alloc] initFor:pollIdentifier withRating:rating voter:voter];
+}
+
+- (instancetype)initFor:(NSString *)pollIdentifier withRating:(NSInteger)rating
+                  voter:(NSString *)voter {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _pollIdentifier = [[SPNPStringTable sharedTable] internedString:pollIdentifier];
+        _rating = @(rating);
+        _voter = [voter copy];
+    }
+    
+    return self;
+}
+
+#pragma mark -
+
+
+@end
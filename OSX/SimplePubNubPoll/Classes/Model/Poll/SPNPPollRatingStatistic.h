@@ -0,0 +1,102 @@
+#import <Foundation/Foundation.h>
+#import "SPNPSerializable.h"
+
+
+#pragma mark Class forward
+
+@class SPNPRatingAccumulator, SPNPPoll;
+
+
+/**
+ @brief      Describes model which is used to describe rating poll stats.
+ @discussion Statistic carry streaming aggregates (see \b SPNPRatingAccumulator): number of 
+             ratings, their mean, sum of squared deviations and histogram over rating scale. Each
+             update is full statistic state (there is no deltas).
+             Statistic published by host node is partial and should be merged with latest 
+             statistic from other nodes.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPPollRatingStatistic : SPNPSerializable
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on target poll identifier.
+ */
+@property (nonatomic, readonly, copy) NSString *pollIdentifier;
+
+/**
+ @brief  Stores reference on statistic stream sequence number.
+ */
+@property (nonatomic, readonly, strong) NSNumber *sequence;
+
+/**
+ @brief  Stores reference on identifier of host node which counted ratings (\c nil for single 
+         host).
+ */
+@property (nonatomic, readonly, copy) NSString *node;
+
+/**
+ @brief  Stores number of counted ratings.
+ */
+@property (nonatomic, readonly, strong) NSNumber *votesCount;
+
+/**
+ @brief  Stores reference on mean of counted ratings.
+ */
+@property (nonatomic, readonly, strong) NSNumber *mean;
+
+/**
+ @brief  Stores reference on sum of squared deviations of counted ratings from their mean.
+ */
+@property (nonatomic, readonly, strong) NSNumber *sumOfSquaredDeviations;
+
+/**
+ @brief  Stores reference on list of ratings count in each histogram bin.
+ */
+@property (nonatomic, readonly, copy) NSArray *histogram;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure rating poll statistic.
+ 
+ @param pollIdentifier Identifier of the poll for which statistic has been gathered.
+ @param accumulator    Reference on accumulator with aggregated ratings.
+ @param node           Identifier of host node which counted ratings.
+ @param sequence       Reference on statistic stream sequence number.
+ 
+ @return Configured and ready to use statistic instance.
+ */
++ (instancetype)statisticForPoll:(NSString *)pollIdentifier
+                 withAccumulator:(SPNPRatingAccumulator *)accumulator node:(NSString *)node
+                        sequence:(NSNumber *)sequence;
+
+
+///------------------------------------------------
+/// @name Aggregates
+///------------------------------------------------
+
+/**
+ @brief      Restore ratings accumulator from statistic.
+ @discussion Accumulator allow to get variance and quantiles or merge statistic from several host
+             nodes.
+ 
+ @param poll Reference on rating poll for which statistic has been received.
+ 
+ @return Accumulator with aggregated ratings.
+ */
+- (SPNPRatingAccumulator *)accumulatorForPoll:(SPNPPoll *)poll;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,149 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPPollRatingStatistic.h"
+#import "SPNPRatingAccumulator.h"
+#import "SPNPCompactCoder.h"
+#import "SPNPPoll.h"
+
+
+#pragma mark Private interface declaration
+
+@interface SPNPPollRatingStatistic ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, copy) NSString *pollIdentifier;
+@property (nonatomic, strong) NSNumber *sequence;
+@property (nonatomic, copy) NSString *node;
+@property (nonatomic, strong) NSNumber *votesCount;
+@property (nonatomic, strong) NSNumber *mean;
+@property (nonatomic, strong) NSNumber *sumOfSquaredDeviations;
+@property (nonatomic, copy) NSArray *histogram;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize rating poll statistic.
+ 
+ @param pollIdentifier Identifier of the poll for which statistic has been gathered.
+ @param accumulator    Reference on accumulator with aggregated ratings.
+ @param node           Identifier of host node which counted ratings.
+ @param sequence       Reference on statistic stream sequence number.
+ 
+ @return Initialized and ready to use statistic instance.
+ */
+- (instancetype)initForPoll:(NSString *)pollIdentifier
+            withAccumulator:(SPNPRatingAccumulator *)accumulator node:(NSString *)node
+                   sequence:(NSNumber *)sequence;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPPollRatingStatistic
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)statisticForPoll:(NSString *)pollIdentifier
+                 withAccumulator:(SPNPRatingAccumulator *)accumulator node:(NSString *)node
+                        sequence:(NSNumber *)sequence {
+    
+    return [[self alloc] initForPoll:pollIdentifier withAccumulator:accumulator node:node
+                            sequence:sequence];
+}
+
+- (instancetype)initForPoll:(NSString *)pollIdentifier
+            withAccumulator:(SPNPRatingAccumulator *)accumulator node:(NSString *)node
+                   sequence:(NSNumber *)sequence {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _pollIdentifier = [pollIdentifier copy];
+        _sequence = sequence;
+        _node = [node copy];
+        _votesCount = @(accumulator.count);
+        _mean = @(accumulator.mean);
+        _sumOfSquaredDeviations = @(accumulator.sumOfSquaredDeviations);
+        _histogram = accumulator.histogram;
+    }
+    
+    return self;
+}
+
+
+#pragma mark - Aggregates
+
+- (SPNPRatingAccumulator *)accumulatorForPoll:(SPNPPoll *)poll {
+    
+    NSInteger minimumRating = poll.minimumRating.integerValue;
+    NSInteger maximumRating = poll.maximumRating.integerValue;
+    SPNPRatingAccumulator *accumulator = nil;
+    accumulator = [SPNPRatingAccumulator accumulatorWithMinimumValue:minimumRating
+                                                        maximumValue:maximumRating];
+    NSArray *histogram = ([self.histogram isKindOfClass:NSArray.class] ? self.histogram : nil);
+    BOOL isValid = ([self.votesCount isKindOfClass:NSNumber.class] &&
+                    [self.mean isKindOfClass:NSNumber.class] &&
+                    [self.sumOfSquaredDeviations isKindOfClass:NSNumber.class]);
+    if (isValid) {
+        
+        [accumulator mergeCount:self.votesCount.unsignedLongLongValue mean:self.mean.doubleValue
+         sumOfSquaredDeviations:self.sumOfSquaredDeviations.doubleValue histogram:histogram];
+    }
+    
+    return accumulator;
+}
+
+
+#pragma mark - Compact representation
+
++ (NSUInteger)compactTypeIdentifier {
+    
+    return 11;
+}
+
+- (void)encodeWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    [coder encodePollIdentifier:self.pollIdentifier];
+    [coder encodeNumber:self.sequence];
+    [coder encodeString:self.node];
+    [coder encodeNumber:self.votesCount];
+    [coder encodeDouble:self.mean.doubleValue];
+    [coder encodeDouble:self.sumOfSquaredDeviations.doubleValue];
+    [coder encodeUnsignedInteger:self.histogram.count];
+    for (NSNumber *binCount in self.histogram) {
+        
+        [coder encodeUnsignedInteger:binCount.unsignedLongLongValue];
+    }
+}
+
+- (void)decodeWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    _pollIdentifier = [[coder decodePollIdentifier] copy];
+    _sequence = [coder decodeNumber];
+    _node = [[coder decodeString] copy];
+    _votesCount = [coder decodeNumber];
+    _mean = @([coder decodeDouble]);
+    _sumOfSquaredDeviations = @([coder decodeDouble]);
+    uint64_t count = [coder decodeUnsignedInteger];
+    NSMutableArray *histogram = [NSMutableArray new];
+    for (uint64_t binIdx = 0; binIdx < count && coder.isValid && !coder.isAtEnd; binIdx++) {
+        
+        [histogram addObject:@([coder decodeUnsignedInteger])];
+    }
+    _histogram = [histogram copy];
+}
+
+#pragma mark -
+
+
+@end
@@ -1,6 +1,11 @@
 #import "SPNPSerializable.h"
 
 
+#pragma mark Class forward
+
+@class SPNPCompactCoder;
+
+
 /**
  @brief      Describes model which store information about single response on poll.
  @discussion This model used by host to describe single response on upcoming poll and used by 
@@ -31,7 +36,20 @@
  @brief  Stores reference on sorting order index and at the same time unique question identifier 
          used during response submission.
  */
-@property (nonatomic, readonly, assign) NSNumber *order;
+@property (nonatomic, readonly, strong) NSNumber *order;
+
+/**
+ @brief      Stores reference on unique identifier of attendee which submitted response.
+ @discussion Used by host to count only one vote from each attendee.
+ */
+@property (nonatomic, readonly, copy) NSString *voter;
+
+/**
+ @brief      Stores reference on time when attendee sent response (milliseconds since 1970).
+ @discussion Set only for responses which has been sampled for end-to-end latency tracing (see 
+             \b SPNPVoteTrace).
+ */
+@property (nonatomic, readonly, strong) NSNumber *traceTime;
 
 
 ///------------------------------------------------
@@ -51,6 +69,92 @@
 + (instancetype)pollResponseFor:(NSString *)pollIdentifier withValue:(NSString *)response
                     orderNumber:(NSNumber *)order;
 
+/**
+ @brief  Create and configure attendee's vote for one of poll responses.
+ 
+ @param pollIdentifier Identifier of the poll for which response object will be created.
+ @param response       Response \c body which will be shown in user interface of host and attendees.
+ @param order          Sorting order index and at the same time unique question identifier used 
+                       during response submission.
+ @param voter          Unique identifier of attendee which submit response.
+ 
+ @return Configured and ready to use poll response instance.
+ */
++ (instancetype)pollResponseFor:(NSString *)pollIdentifier withValue:(NSString *)response
+                    orderNumber:(NSNumber *)order voter:(NSString *)voter;
+
+/**
+ @brief  Create and configure attendee's vote which should be traced till it will be published by 
+         host.
+ 
+ @param pollIdentifier Identifier of the poll for which response object will be created.
+ @param response       Response \c body which will be shown in user interface of host and attendees.
+ @param order          Sorting order index and at the same time unique question identifier used 
+                       during response submission.
+ @param voter          Unique identifier of attendee which submit response.
+ @param traceTime      Reference on time when attendee sent response (milliseconds since 1970).
+ 
+ @return Configured and ready to use poll response instance.
+ */
++ (instancetype)pollResponseFor:(NSString *)pollIdentifier withValue:(NSString *)response
+                    orderNumber:(NSNumber *)order voter:(NSString *)voter
+                      traceTime:(NSNumber *)traceTime;
+
+
+///------------------------------------------------
+/// @name Routing
+///------------------------------------------------
+
+/**
+ @brief      Retrieve key of the poll for which response has been sent.
+ @discussion Only poll identifier read from message, so host is able to find poll or drop response
+             without model deserialization.
+ 
+ @param message Reference on received message (dictionary or compact representation).
+ 
+ @return Poll identifier, \c NSNumber with short poll token (for compact representation) or \c nil
+         in case if \c message doesn't look like response.
+ */
++ (id)pollKeyFromMessage:(id)message;
+
+/**
+ @brief      Read only fields which is required to count attendee's vote.
+ @discussion Fields projected right from received message: response model, intermediate 
+             collections and voter identifier string not created.
+ 
+ @param message        Reference on received message (dictionary or compact representation).
+ @param pollIdentifier Reference on identifier of the poll for which votes counted.
+ @param decoder        Reference on decoder created with \c +reusableDecoderForPoll:token: for 
+                       \c pollIdentifier (used to read compact representation).
+ @param order          Reference on variable into which response order number should be stored.
+ @param voterKey       Reference on variable into which voter fingerprint should be stored (\c 0 in
+                       case if response has been sent w/o voter identifier).
+ 
+ @return \c YES in case if \c message is response for specified poll.
+ */
++ (BOOL)readVoteFromMessage:(id)message forPoll:(NSString *)pollIdentifier
+               usingDecoder:(SPNPCompactCoder *)decoder order:(NSUInteger *)order
+                   voterKey:(uint64_t *)voterKey;
+
+/**
+ @brief  Read only fields which is required to count and trace attendee's vote.
+ 
+ @param message        Reference on received message (dictionary or compact representation).
+ @param pollIdentifier Reference on identifier of the poll for which votes counted.
+ @param decoder        Reference on decoder created with \c +reusableDecoderForPoll:token: for 
+                       \c pollIdentifier (used to read compact representation).
+ @param order          Reference on variable into which response order number should be stored.
+ @param voterKey       Reference on variable into which voter fingerprint should be stored (\c 0 in
+                       case if response has been sent w/o voter identifier).
+ @param traceTime      Reference on variable into which response send time should be stored (\c 0 
+                       in case if response hasn't been sampled for tracing).
+ 
+ @return \c YES in case if \c message is response for specified poll.
+ */
++ (BOOL)readVoteFromMessage:(id)message forPoll:(NSString *)pollIdentifier
+               usingDecoder:(SPNPCompactCoder *)decoder order:(NSUInteger *)order
+                   voterKey:(uint64_t *)voterKey traceTime:(uint64_t *)traceTime;
+
 #pragma mark -
 
 
@@ -3,6 +3,23 @@
  @copyright © 2009-2015 PubNub, Inc.
  */
 #import "SPNPPollResponse.h"
+#import "SPNPCompactCoder.h"
+#import "SPNPStringTable.h"
+#import "SPNPVoterIndex.h"
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores name of class which is stored in dictionary representation of response.
+ */
+static NSString * const kSPNPPollResponseClassName = @"SPNPPollResponse";
+
+/**
+ @brief  Stores number of leading base64 characters of compact response which cover format version,
+         type and poll token or \c UUID.
+ */
+static NSUInteger const kSPNPPollResponseKeyRepresentationLength = 28;
 
 
 #pragma mark Private interface declaration
@@ -14,7 +31,9 @@
 
 @property (nonatomic, copy) NSString *pollIdentifier;
 @property (nonatomic, copy) NSString *response;
-@property (nonatomic, assign) NSNumber *order;
+@property (nonatomic, strong) NSNumber *order;
+@property (nonatomic, copy) NSString *voter;
+@property (nonatomic, strong) NSNumber *traceTime;
 
 
 #pragma mark - Initialization and Configuration
@@ -26,11 +45,13 @@
  @param response       Response \c body which will be shown in user interface of host and attendees.
  @param order          Sorting order index and at the same time unique question identifier used 
                        during response submission.
+ @param voter          Unique identifier of attendee which submit response.
+ @param traceTime      Reference on time when attendee sent response (milliseconds since 1970).
  
  @return Initialized and ready to use poll response instance.
  */
 - (instancetype)initFor:(NSString *)pollIdentifier withValue:(NSString *)response
-            orderNumber:(NSNumber *)order;
+            orderNumber:(NSNumber *)order voter:(NSString *)voter traceTime:(NSNumber *)traceTime;
 
 #pragma mark -
 
@@ -48,23 +69,180 @@
 + (instancetype)pollResponseFor:(NSString *)pollIdentifier withValue:(NSString *)response
                     orderNumber:(NSNumber *)order {
     
-    return [[self alloc] initFor:pollIdentifier withValue:response orderNumber:order];
+    return [self pollResponseFor:pollIdentifier withValue:response orderNumber:order voter:nil];
+}
+
++ (instancetype)pollResponseFor:(NSString *)pollIdentifier withValue:(NSString *)response
+                    orderNumber:(NSNumber *)order voter:(NSString *)voter {
+    
+    return [self pollResponseFor:pollIdentifier withValue:response orderNumber:order voter:voter
+                       traceTime:nil];
+}
+
++ (instancetype)pollResponseFor:(NSString *)pollIdentifier withValue:(NSString *)response
+                    orderNumber:(NSNumber *)order voter:(NSString *)voter
+                      traceTime:(NSNumber *)traceTime {
+    
+    return [[self alloc] initFor:pollIdentifier withValue:response orderNumber:order voter:voter
+                       traceTime:traceTime];
 }
 
 - (instancetype)initFor:(NSString *)pollIdentifier withValue:(NSString *)response
-            orderNumber:(NSNumber *)order {
+            orderNumber:(NSNumber *)order voter:(NSString *)voter traceTime:(NSNumber *)traceTime {
     
     // Check whether initialization was successful or not.
     if ((self = [super init])) {
         
-        _pollIdentifier = [pollIdentifier copy];
-        _response = [response stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
+        // Poll identifier and title shared by all models which describe same poll response.
+        SPNPStringTable *strings = [SPNPStringTable sharedTable];
+        NSCharacterSet *whitespaces = [NSCharacterSet whitespaceAndNewlineCharacterSet];
+        _pollIdentifier = [strings internedString:pollIdentifier];
+        _response = [strings internedString:[response stringByTrimmingCharactersInSet:whitespaces]];
         _order = order;
+        _voter = [voter copy];
+        _traceTime = traceTime;
     }
     
     return self;
 }
 
+
+#pragma mark - Compact representation
+
++ (NSUInteger)compactTypeIdentifier {
+    
+    return 2;
+}
+
+- (void)encodeWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    [coder encodePollIdentifier:self.pollIdentifier];
+    [coder encodeNumber:self.order];
+    [coder encodeString:self.response];
+    [coder encodeIdentifier:self.voter];
+    if (self.traceTime) { [coder encodeNumber:self.traceTime]; }
+}
+
+- (void)decodeWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    SPNPStringTable *strings = [SPNPStringTable sharedTable];
+    _pollIdentifier = [strings internedString:[coder decodePollIdentifier]];
+    _order = [coder decodeNumber];
+    _response = [strings internedString:[coder decodeString]];
+    if (!coder.isAtEnd) { _voter = [[coder decodeIdentifier] copy]; }
+    if (!coder.isAtEnd) { _traceTime = [coder decodeNumber]; }
+}
+
+
+#pragma mark - Routing
+
++ (id)pollKeyFromMessage:(id)message {
+    
+    id key = nil;
+    if ([message isKindOfClass:NSString.class]) {
+        
+        // Only leading quads decoded on delivery thread. Whole message decoded only if poll key 
+        // doesn't fit into them (long string poll identifier).
+        NSString *representation = message;
+        NSUInteger length = kSPNPPollResponseKeyRepresentationLength;
+        SPNPCompactCoder *coder = [SPNPCompactCoder reusableDecoderForPoll:nil token:nil];
+        [coder resetWithRepresentation:representation length:length];
+        BOOL isSupported = ([coder decodeUnsignedInteger] == [SPNPCompactCoder formatVersion]);
+        isSupported = (isSupported && [coder decodeUnsignedInteger] == [self compactTypeIdentifier]);
+        if (isSupported) { key = [coder decodePollKey]; }
+        if (isSupported && !coder.isValid && representation.length > length &&
+            [coder resetWithRepresentation:representation]) {
+            
+            [coder decodeUnsignedInteger];
+            [coder decodeUnsignedInteger];
+            key = [coder decodePollKey];
+        }
+        if (!coder.isValid) { key = nil; }
+    }
+    else if ([message isKindOfClass:NSDictionary.class]) {
+        
+        key = ((NSDictionary *)message)[@"pollIdentifier"];
+        if (![key isKindOfClass:NSString.class]) { key = nil; }
+    }
+    
+    return key;
+}
+
++ (BOOL)readVoteFromMessage:(id)message forPoll:(NSString *)pollIdentifier
+               usingDecoder:(SPNPCompactCoder *)decoder order:(NSUInteger *)order
+                   voterKey:(uint64_t *)voterKey {
+    
+    return [self readVoteFromMessage:message forPoll:pollIdentifier usingDecoder:decoder order:order
+                            voterKey:voterKey traceTime:NULL];
+}
+
++ (BOOL)readVoteFromMessage:(id)message forPoll:(NSString *)pollIdentifier
+               usingDecoder:(SPNPCompactCoder *)decoder order:(NSUInteger *)order
+                   voterKey:(uint64_t *)voterKey traceTime:(uint64_t *)traceTime {
+    
+    BOOL isVote = NO;
+    uint64_t responseOrder = 0;
+    uint64_t responseVoterKey = 0;
+    uint64_t responseTraceTime = 0;
+    if ([message isKindOfClass:NSString.class]) {
+        
+        // Fields read in same order as they written by -encodeWithCompactCoder:.
+        if ([decoder resetWithRepresentation:message] &&
+            [decoder decodeUnsignedInteger] == [SPNPCompactCoder formatVersion] &&
+            [decoder decodeUnsignedInteger] == [self compactTypeIdentifier] &&
+            [decoder decodePollKeyMatchingPoll] && [decoder decodeNumberValue:&responseOrder]) {
+            
+            [decoder skipString];
+            if (decoder.isValid && !decoder.isAtEnd) {
+                
+                BOOL isUUID = NO;
+                NSUInteger length = 0;
+                const uint8_t *bytes = [decoder decodeIdentifierBytesWithLength:&length isUUID:&isUUID];
+                if (bytes) {
+                    
+                    responseVoterKey = [SPNPVoterIndex keyForVoterBytes:bytes length:length
+                                                                 isUUID:isUUID];
+                }
+                if (traceTime && decoder.isValid && !decoder.isAtEnd) {
+                    
+                    [decoder decodeNumberValue:&responseTraceTime];
+                }
+            }
+            isVote = decoder.isValid;
+        }
+    }
+    else if ([message isKindOfClass:NSDictionary.class]) {
+        
+        NSDictionary *dictionary = message;
+        NSString *responsePollIdentifier = dictionary[@"pollIdentifier"];
+        NSNumber *orderNumber = dictionary[@"order"];
+        NSString *voter = dictionary[@"voter"];
+        NSNumber *sentTime = (traceTime ? dictionary[@"traceTime"] : nil);
+        if ([dictionary[@"s_class"] isEqual:kSPNPPollResponseClassName] &&
+            [responsePollIdentifier isKindOfClass:NSString.class] &&
+            [responsePollIdentifier isEqualToString:pollIdentifier] &&
+            [orderNumber isKindOfClass:NSNumber.class]) {
+            
+            responseOrder = orderNumber.unsignedLongLongValue;
+            if ([voter isKindOfClass:NSString.class]) {
+                
+                responseVoterKey = [SPNPVoterIndex keyForVoter:voter];
+            }
+            if ([sentTime isKindOfClass:NSNumber.class]) {
+                
+                responseTraceTime = sentTime.unsignedLongLongValue;
+            }
+            isVote = YES;
+        }
+    }
+    
+    if (isVote && order) { *order = (NSUInteger)MIN(responseOrder, (uint64_t)NSUIntegerMax); }
+    if (isVote && voterKey) { *voterKey = responseVoterKey; }
+    if (isVote && traceTime) { *traceTime = responseTraceTime; }
+    
+    return isVote;
+}
+
 #pragma mark - 
 
 
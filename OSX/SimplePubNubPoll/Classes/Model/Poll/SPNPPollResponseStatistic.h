@@ -36,6 +36,16 @@
  */
 @property (nonatomic, readonly, strong) NSNumber *votesCount;
 
+/**
+ @brief      Stores reference on votes counters of host nodes which aggregate responses.
+ @discussion Each host node aggregate responses only from subset of attendees and own node's entry. 
+             Entry is list of two grow-only counters: number of votes which has been added and 
+             removed by node (\c PN-counter). Counters merged by picking largest value for each
+             node, so same statistic can be merged any number of times and in any order. \c nil for
+             statistic aggregated by single host.
+ */
+@property (nonatomic, readonly, copy) NSDictionary *nodeCounters;
+
 
 ///------------------------------------------------
 /// @name Initialization and Configuration
@@ -60,6 +70,54 @@
  */
 - (void)registerVoice;
 
+/**
+ @brief  Update number of votes using change received from host.
+ 
+ @param change Number of votes which should be added (or removed if negative).
+ */
+- (void)applyVotesCountChange:(long long)change;
+
+/**
+ @brief  Replace number of votes with value aggregated by host.
+ 
+ @param votesCount Number of votes which has been given for response variant.
+ */
+- (void)updateVotesCount:(unsigned long long)votesCount;
+
+/**
+ @brief  Retrieve number of votes which has been aggregated by host node.
+ 
+ @param node Reference on unique host node identifier.
+ 
+ @return Number of votes counted by node.
+ */
+- (unsigned long long)votesCountForNode:(NSString *)node;
+
+/**
+ @brief      Replace number of votes aggregated by host node.
+ @discussion Difference with previous node's value added to one of node's grow-only counters and 
+             overall votes count recomputed from all nodes counters.
+ 
+ @param votesCount Number of votes which has been counted by node.
+ @param node       Reference on unique host node identifier.
+ */
+- (void)updateVotesCount:(unsigned long long)votesCount forNode:(NSString *)node;
+
+/**
+ @brief      Merge votes counters received from other host nodes.
+ @discussion Merge is idempotent, commutative and associative, so duplicated or reordered statistic
+             updates doesn't inflate overall votes count.
+ 
+ @param nodeCounters Reference on node counters received with statistic (same format as 
+                     \c nodeCounters).
+ @param node         Reference on identifier of node which votes count should stay the same (counts
+                     from previous node's run can be higher than restored one). \c nil to merge all
+                     counters as-is.
+ 
+ @return \c YES in case if overall votes count has been changed.
+ */
+- (BOOL)mergeNodeCounters:(NSDictionary *)nodeCounters preservingNode:(NSString *)node;
+
 #pragma mark -
 
 
@@ -4,6 +4,8 @@
  */
 #import "SPNPPollResponseStatistic.h"
 #import "SPNPPollResponse.h"
+#import "SPNPCompactCoder.h"
+#import "SPNPStringTable.h"
 
 
 #pragma mark Private interface declaration
@@ -16,6 +18,7 @@
 @property (nonatomic, copy) NSString *response;
 @property (nonatomic, strong) NSNumber *order;
 @property (nonatomic, strong) NSNumber *votesCount;
+@property (nonatomic, copy) NSDictionary *nodeCounters;
 
 
 #pragma mark - Initialization and Configuration
@@ -29,6 +32,16 @@
  */
 - (instancetype)initWithResponse:(SPNPPollResponse *)response;
 
+
+#pragma mark - Statistic
+
+/**
+ @brief  Store node's counters and recompute overall votes count.
+ 
+ @param nodeCounters Reference on node counters which should replace current one.
+ */
+- (void)updateNodeCounters:(NSDictionary *)nodeCounters;
+
 #pragma mark -
 
 
@@ -62,7 +75,37 @@
 
 - (id)copyWithZone:(NSZone *)zone {
     
-    return self;
+    // Statistic replace values instead of changing them, so copy can share them with receiver and
+    // stay unchanged when receiver will be updated.
+    SPNPPollResponseStatistic *statistic = [[[self class] allocWithZone:zone] init];
+    statistic->_response = _response;
+    statistic->_order = _order;
+    statistic->_votesCount = _votesCount;
+    statistic->_nodeCounters = _nodeCounters;
+    
+    return statistic;
+}
+
+
+#pragma mark - Compact representation
+
++ (NSUInteger)compactTypeIdentifier {
+    
+    return 3;
+}
+
+- (void)encodeWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    [coder encodeNumber:self.order];
+    [coder encodeNumber:self.votesCount];
+    [coder encodeString:self.response];
+}
+
+- (void)decodeWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    _order = [coder decodeNumber];
+    _votesCount = [coder decodeNumber];
+    _response = [[SPNPStringTable sharedTable] internedString:[coder decodeString]];
 }
 
 
@@ -73,6 +116,88 @@
     self.votesCount = @(self.votesCount.unsignedLongLongValue + 1);
 }
 
+- (void)applyVotesCountChange:(long long)change {
+    
+    long long votesCount = (self.votesCount.longLongValue + change);
+    self.votesCount = @((unsigned long long)MAX(votesCount, 0));
+}
+
+- (void)updateVotesCount:(unsigned long long)votesCount {
+    
+    if (self.votesCount.unsignedLongLongValue != votesCount) { self.votesCount = @(votesCount); }
+}
+
+- (unsigned long long)votesCountForNode:(NSString *)node {
+    
+    NSArray *counters = self.nodeCounters[node];
+    unsigned long long added = [counters.firstObject unsignedLongLongValue];
+    unsigned long long removed = [counters.lastObject unsignedLongLongValue];
+    
+    return (added > removed ? added - removed : 0);
+}
+
+- (void)updateVotesCount:(unsigned long long)votesCount forNode:(NSString *)node {
+    
+    NSArray *counters = self.nodeCounters[node];
+    unsigned long long added = [counters.firstObject unsignedLongLongValue];
+    unsigned long long removed = [counters.lastObject unsignedLongLongValue];
+    unsigned long long nodeVotesCount = [self votesCountForNode:node];
+    if (!counters || nodeVotesCount != votesCount) {
+        
+        if (votesCount > nodeVotesCount) { added += (votesCount - nodeVotesCount); }
+        else { removed += (nodeVotesCount - votesCount); }
+        
+        NSMutableDictionary *nodeCounters = [(self.nodeCounters?: @{}) mutableCopy];
+        nodeCounters[node] = @[@(added), @(removed)];
+        [self updateNodeCounters:nodeCounters];
+    }
+}
+
+- (BOOL)mergeNodeCounters:(NSDictionary *)nodeCounters preservingNode:(NSString *)node {
+    
+    unsigned long long votesCount = self.votesCount.unsignedLongLongValue;
+    unsigned long long nodeVotesCount = [self votesCountForNode:node];
+    BOOL hasNodeCounters = (node && self.nodeCounters[node] != nil);
+    __block NSMutableDictionary *mergedCounters = nil;
+    [nodeCounters enumerateKeysAndObjectsUsingBlock:^(NSString *mergedNode, NSArray *counters,
+                                                      BOOL *nodeCountersEnumeratorStop) {
+        
+        if (![mergedNode isKindOfClass:NSString.class] || ![counters isKindOfClass:NSArray.class] ||
+            counters.count != 2) {
+            
+            return;
+        }
+        
+        NSArray *currentCounters = (mergedCounters?: self.nodeCounters)[mergedNode];
+        unsigned long long added = MAX([currentCounters.firstObject unsignedLongLongValue],
+                                       [counters.firstObject unsignedLongLongValue]);
+        unsigned long long removed = MAX([currentCounters.lastObject unsignedLongLongValue],
+                                         [counters.lastObject unsignedLongLongValue]);
+        if (!currentCounters || added != [currentCounters.firstObject unsignedLongLongValue] ||
+            removed != [currentCounters.lastObject unsignedLongLongValue]) {
+            
+            if (!mergedCounters) { mergedCounters = [(self.nodeCounters?: @{}) mutableCopy]; }
+            mergedCounters[mergedNode] = @[@(added), @(removed)];
+        }
+    }];
+    if (mergedCounters) { [self updateNodeCounters:mergedCounters]; }
+    if (hasNodeCounters) { [self updateVotesCount:nodeVotesCount forNode:node]; }
+    
+    return (self.votesCount.unsignedLongLongValue != votesCount);
+}
+
+- (void)updateNodeCounters:(NSDictionary *)nodeCounters {
+    
+    __block unsigned long long votesCount = 0;
+    self.nodeCounters = nodeCounters;
+    [nodeCounters enumerateKeysAndObjectsUsingBlock:^(NSString *node, NSArray *counters,
+                                                      BOOL *nodeCountersEnumeratorStop) {
+        
+        votesCount += [self votesCountForNode:node];
+    }];
+    [self updateVotesCount:votesCount];
+}
+
 #pragma mark -
 
 
@@ -33,6 +33,45 @@
  */
 @property (nonatomic, readonly, strong) NSArray *responses;
 
+/**
+ @brief      Stores reference on statistic stream sequence number.
+ @discussion Full statistic published by host as keyframe for delta updates stream (represented by
+             \b SPNPPollStatisticDelta). Statistic from hosts which doesn't use delta updates 
+             doesn't have sequence number.
+ */
+@property (nonatomic, readonly, strong) NSNumber *sequence;
+
+/**
+ @brief      Stores whether statistic carry votes counters of host nodes.
+ @discussion Statistic from host nodes should be merged with statistic from other nodes rather than
+             replace it (see \b SPNPPollResponseStatistic \c nodeCounters).
+ */
+@property (nonatomic, readonly, assign, getter = isMergeable) BOOL mergeable;
+
+/**
+ @brief      Stores reference on recent votes trend.
+ @discussion Optional list of per-response lists (in responses order) with votes changes for each
+             of last seconds (from oldest to newest second). Used by attendees to render trend
+             charts.
+ */
+@property (nonatomic, readonly, strong) NSArray *trend;
+
+/**
+ @brief      Stores reference on traces of sampled votes which has been counted first time by this
+             keyframe.
+ @discussion Optional list of \b SPNPVoteTrace instances which allow attendees to measure time in
+             which their votes become visible.
+ */
+@property (nonatomic, readonly, strong) NSArray *traces;
+
+/**
+ @brief      Stores reference on time till which votes has been counted by this keyframe
+             (milliseconds since 1970 by host's clock).
+ @discussion Votes which has been counted by host before this time included into keyframe. Sent 
+             along with \c traces.
+ */
+@property (nonatomic, readonly, strong) NSNumber *coveredTime;
+
 
 ///------------------------------------------------
 /// @name Initialization and Configuration
@@ -49,6 +88,50 @@
  */
 + (instancetype)statisticForPoll:(SPNPPoll *)poll withResponses:(NSArray *)responseVariants;
 
+/**
+ @brief  Create and configure poll statistic keyframe for delta updates stream.
+ 
+ @param poll             Reference on poll for which statistic information should be aggregated and
+                         published.
+ @param responseVariants List of response statistic instances.
+ @param sequence         Reference on statistic stream sequence number.
+ 
+ @return Configured and ready to use poll statistic instance.
+ */
++ (instancetype)statisticForPoll:(SPNPPoll *)poll withResponses:(NSArray *)responseVariants
+                        sequence:(NSNumber *)sequence;
+
+/**
+ @brief  Create and configure poll statistic keyframe which carry recent votes trend.
+ 
+ @param poll             Reference on poll for which statistic information should be aggregated and
+                         published.
+ @param responseVariants List of response statistic instances.
+ @param sequence         Reference on statistic stream sequence number.
+ @param trend            Reference on list of per-response per-second votes changes.
+ 
+ @return Configured and ready to use poll statistic instance.
+ */
++ (instancetype)statisticForPoll:(SPNPPoll *)poll withResponses:(NSArray *)responseVariants
+                        sequence:(NSNumber *)sequence trend:(NSArray *)trend;
+
+/**
+ @brief  Create and configure poll statistic keyframe which carry sampled votes traces.
+ 
+ @param poll             Reference on poll for which statistic information should be aggregated and
+                         published.
+ @param responseVariants List of response statistic instances.
+ @param sequence         Reference on statistic stream sequence number.
+ @param trend            Reference on list of per-response per-second votes changes.
+ @param traces           List of \b SPNPVoteTrace instances for votes included into keyframe.
+ @param coveredTime      Reference on time till which votes has been counted.
+ 
+ @return Configured and ready to use poll statistic instance.
+ */
++ (instancetype)statisticForPoll:(SPNPPoll *)poll withResponses:(NSArray *)responseVariants
+                        sequence:(NSNumber *)sequence trend:(NSArray *)trend
+                          traces:(NSArray *)traces coveredTime:(NSNumber *)coveredTime;
+
 #pragma mark -
 
 
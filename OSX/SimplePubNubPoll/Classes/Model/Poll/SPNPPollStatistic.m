@@ -3,6 +3,9 @@
  @copyright © 2009-2015 PubNub, Inc.
  */
 #import "SPNPPollStatistic.h"
+#import "SPNPPollResponseStatistic.h"
+#import "SPNPCompactCoder.h"
+#import "SPNPVoteTrace.h"
 #import "SPNPPoll.h"
 
 
@@ -15,6 +18,45 @@
 
 @property (nonatomic, copy) NSString *pollIdentifier;
 @property (nonatomic, strong) NSArray *responses;
+@property (nonatomic, strong) NSNumber *sequence;
+@property (nonatomic, strong) NSArray *trend;
+@property (nonatomic, strong) NSArray *traces;
+@property (nonatomic, strong) NSNumber *coveredTime;
+
+
+#pragma mark - Compact representation
+
+/**
+ @brief      Write votes counters of host nodes.
+ @discussion Counters written as optional trailing field: list of node identifiers and for each 
+             node pair of counters for every response (in responses order).
+ 
+ @param coder Reference on coder which should be used to write counters.
+ */
+- (void)encodeNodeCountersWithCompactCoder:(SPNPCompactCoder *)coder;
+
+/**
+ @brief  Read votes counters of host nodes and merge them into response statistic instances.
+ 
+ @param coder Reference on coder which should be used to read counters.
+ */
+- (void)decodeNodeCountersWithCompactCoder:(SPNPCompactCoder *)coder;
+
+/**
+ @brief      Write recent votes trend.
+ @discussion Trend written as optional trailing field (after host nodes counters): number of
+             seconds and for each response votes change of every second.
+ 
+ @param coder Reference on coder which should be used to write trend.
+ */
+- (void)encodeTrendWithCompactCoder:(SPNPCompactCoder *)coder;
+
+/**
+ @brief  Read recent votes trend.
+ 
+ @param coder Reference on coder which should be used to read trend.
+ */
+- (void)decodeTrendWithCompactCoder:(SPNPCompactCoder *)coder;
 
 
 #pragma mark - Initialization and Configuration
@@ -25,10 +67,16 @@
  @param poll             Reference on poll for which statistic information should be aggregated and
                          published.
  @param responseVariants List of response statistic instances.
+ @param sequence         Reference on statistic stream sequence number.
+ @param trend            Reference on list of per-response per-second votes changes.
+ @param traces           List of \b SPNPVoteTrace instances for votes included into keyframe.
+ @param coveredTime      Reference on time till which votes has been counted.
  
  @return Initialized and ready to use poll statistic instance.
  */
-- (instancetype)initForPoll:(SPNPPoll *)poll withResponses:(NSArray *)responseVariants;
+- (instancetype)initForPoll:(SPNPPoll *)poll withResponses:(NSArray *)responseVariants
+                   sequence:(NSNumber *)sequence trend:(NSArray *)trend traces:(NSArray *)traces
+                coveredTime:(NSNumber *)coveredTime;
 
 #pragma mark -
 
@@ -45,21 +93,196 @@
 
 + (instancetype)statisticForPoll:(SPNPPoll *)poll withResponses:(NSArray *)responseVariants {
     
-    return [[self alloc] initForPoll:poll withResponses:responseVariants];
+    return [self statisticForPoll:poll withResponses:responseVariants sequence:nil];
+}
+
++ (instancetype)statisticForPoll:(SPNPPoll *)poll withResponses:(NSArray *)responseVariants
+                        sequence:(NSNumber *)sequence {
+    
+    return [self statisticForPoll:poll withResponses:responseVariants sequence:sequence trend:nil];
 }
 
-- (instancetype)initForPoll:(SPNPPoll *)poll withResponses:(NSArray *)responseVariants {
++ (instancetype)statisticForPoll:(SPNPPoll *)poll withResponses:(NSArray *)responseVariants
+                        sequence:(NSNumber *)sequence trend:(NSArray *)trend {
+    
+    return [self statisticForPoll:poll withResponses:responseVariants sequence:sequence trend:trend
+                           traces:nil coveredTime:nil];
+}
+
++ (instancetype)statisticForPoll:(SPNPPoll *)poll withResponses:(NSArray *)responseVariants
+                        sequence:(NSNumber *)sequence trend:(NSArray *)trend
+                          traces:(NSArray *)traces coveredTime:(NSNumber *)coveredTime {
+    
+    return [[self alloc] initForPoll:poll withResponses:responseVariants sequence:sequence
+                               trend:trend traces:traces coveredTime:coveredTime];
+}
+
+- (instancetype)initForPoll:(SPNPPoll *)poll withResponses:(NSArray *)responseVariants
+                   sequence:(NSNumber *)sequence trend:(NSArray *)trend traces:(NSArray *)traces
+                coveredTime:(NSNumber *)coveredTime {
     
     // Check whether initialization was successful or not.
     if ((self = [super init])) {
         
         _pollIdentifier = [poll.identifier copy];
         _responses = responseVariants;
+        _sequence = sequence;
+        _trend = trend;
+        _traces = [traces copy];
+        _coveredTime = coveredTime;
     }
     
     return self;
 }
 
+
+#pragma mark - Information
+
+- (BOOL)isMergeable {
+    
+    BOOL isMergeable = NO;
+    for (SPNPPollResponseStatistic *statistic in self.responses) {
+        
+        if (statistic.nodeCounters.count) {
+            
+            isMergeable = YES;
+            break;
+        }
+    }
+    
+    return isMergeable;
+}
+
+- (NSArray *)ignoredProperties {
+    
+    return @[@"mergeable"];
+}
+
+
+#pragma mark - Compact representation
+
++ (NSUInteger)compactTypeIdentifier {
+    
+    return 4;
+}
+
+- (void)encodeWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    [coder encodePollIdentifier:self.pollIdentifier];
+    [coder encodeObjects:self.responses];
+    [coder encodeNumber:self.sequence];
+    // Trailing fields are positional, so each of them require (may be empty) preceding fields.
+    BOOL hasTraces = (self.traces.count > 0);
+    BOOL hasTrend = (self.trend.count > 0 || hasTraces);
+    if (self.isMergeable || hasTrend) { [self encodeNodeCountersWithCompactCoder:coder]; }
+    if (hasTrend) { [self encodeTrendWithCompactCoder:coder]; }
+    if (hasTraces) {
+        
+        [coder encodeNumber:self.coveredTime];
+        [coder encodeObjects:self.traces];
+    }
+}
+
+- (void)decodeWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    _pollIdentifier = [[coder decodePollIdentifier] copy];
+    _responses = [coder decodeObjectsOfClass:SPNPPollResponseStatistic.class];
+    if (!coder.isAtEnd) { _sequence = [coder decodeNumber]; }
+    if (!coder.isAtEnd) { [self decodeNodeCountersWithCompactCoder:coder]; }
+    if (!coder.isAtEnd) { [self decodeTrendWithCompactCoder:coder]; }
+    if (!coder.isAtEnd) {
+        
+        _coveredTime = [coder decodeNumber];
+        _traces = [coder decodeObjectsOfClass:SPNPVoteTrace.class];
+    }
+}
+
+- (void)encodeNodeCountersWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    NSMutableSet *nodes = [NSMutableSet new];
+    for (SPNPPollResponseStatistic *statistic in self.responses) {
+        
+        [nodes addObjectsFromArray:statistic.nodeCounters.allKeys];
+    }
+    
+    [coder encodeUnsignedInteger:nodes.count];
+    for (NSString *node in nodes) {
+        
+        [coder encodeString:node];
+        for (SPNPPollResponseStatistic *statistic in self.responses) {
+            
+            NSArray *counters = statistic.nodeCounters[node];
+            [coder encodeUnsignedInteger:[counters.firstObject unsignedLongLongValue]];
+            [coder encodeUnsignedInteger:[counters.lastObject unsignedLongLongValue]];
+        }
+    }
+}
+
+- (void)decodeNodeCountersWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    NSUInteger responsesCount = self.responses.count;
+    NSMutableArray *nodeCounters = [NSMutableArray arrayWithCapacity:responsesCount];
+    for (NSUInteger responseIdx = 0; responseIdx < responsesCount; responseIdx++) {
+        
+        [nodeCounters addObject:[NSMutableDictionary new]];
+    }
+    
+    uint64_t nodesCount = [coder decodeUnsignedInteger];
+    for (uint64_t nodeIdx = 0; nodeIdx < nodesCount && coder.isValid; nodeIdx++) {
+        
+        NSString *node = [coder decodeString];
+        for (NSUInteger responseIdx = 0; responseIdx < responsesCount && coder.isValid; responseIdx++) {
+            
+            uint64_t added = [coder decodeUnsignedInteger];
+            uint64_t removed = [coder decodeUnsignedInteger];
+            if (node) { nodeCounters[responseIdx][node] = @[@(added), @(removed)]; }
+        }
+    }
+    
+    if (coder.isValid) {
+        
+        [self.responses enumerateObjectsUsingBlock:^(SPNPPollResponseStatistic *statistic,
+                                                     NSUInteger statisticIdx,
+                                                     BOOL *statisticsEnumeratorStop) {
+            
+            [statistic mergeNodeCounters:nodeCounters[statisticIdx] preservingNode:nil];
+        }];
+    }
+}
+
+- (void)encodeTrendWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    NSUInteger secondsCount = [self.trend.firstObject count];
+    [coder encodeUnsignedInteger:secondsCount];
+    for (NSUInteger responseIdx = 0; responseIdx < self.responses.count; responseIdx++) {
+        
+        NSArray *series = (responseIdx < self.trend.count ? self.trend[responseIdx] : nil);
+        for (NSUInteger secondIdx = 0; secondIdx < secondsCount; secondIdx++) {
+            
+            long long change = (secondIdx < series.count ? [series[secondIdx] longLongValue] : 0);
+            [coder encodeSignedInteger:change];
+        }
+    }
+}
+
+- (void)decodeTrendWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    uint64_t secondsCount = [coder decodeUnsignedInteger];
+    NSUInteger responsesCount = self.responses.count;
+    NSMutableArray *trend = [NSMutableArray arrayWithCapacity:responsesCount];
+    for (NSUInteger responseIdx = 0; responseIdx < responsesCount && coder.isValid; responseIdx++) {
+        
+        NSMutableArray *series = [NSMutableArray new];
+        for (uint64_t secondIdx = 0; secondIdx < secondsCount && coder.isValid; secondIdx++) {
+            
+            [series addObject:@([coder decodeSignedInteger])];
+        }
+        [trend addObject:series];
+    }
+    
+    if (coder.isValid && secondsCount) { _trend = trend; }
+}
+
 #pragma mark -
 
 
@@ -0,0 +1,107 @@
+#import <Foundation/Foundation.h>
+#import "SPNPSerializable.h"
+
+
+#pragma mark Class forward
+
+@class SPNPPoll;
+
+
+/**
+ @brief      Describes model which is used to describe change of poll response statistic.
+ @discussion Object stores only per-option votes count changes since previous statistic update and
+             sequence number which allow attendees to detect lost and reordered updates. Host 
+             periodically publish full \b SPNPPollStatistic keyframe which allow attendees to 
+             re-synchronize.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPPollStatisticDelta : SPNPSerializable
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on target poll identifier.
+ */
+@property (nonatomic, readonly, copy) NSString *pollIdentifier;
+
+/**
+ @brief  Stores reference on statistic stream sequence number.
+ */
+@property (nonatomic, readonly, strong) NSNumber *sequence;
+
+/**
+ @brief      Stores reference on list of votes count changes.
+ @discussion List consist of pairs: response order number followed by votes count change.
+ */
+@property (nonatomic, readonly, strong) NSArray *changes;
+
+/**
+ @brief      Stores reference on traces of sampled votes which has been counted first time by this
+             update.
+ @discussion Optional list of \b SPNPVoteTrace instances which allow attendees to measure time in
+             which their votes become visible.
+ */
+@property (nonatomic, readonly, strong) NSArray *traces;
+
+/**
+ @brief      Stores reference on time till which votes has been counted by this update (milliseconds
+             since 1970 by host's clock).
+ @discussion Votes which has been counted by host before this time included into update. Sent 
+             along with \c traces.
+ */
+@property (nonatomic, readonly, strong) NSNumber *coveredTime;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure poll statistic change instance.
+ 
+ @param poll     Reference on poll for which statistic change should be published.
+ @param sequence Reference on statistic stream sequence number.
+ @param changes  List of response order number and votes count change pairs.
+ 
+ @return Configured and ready to use poll statistic change instance.
+ */
++ (instancetype)deltaForPoll:(SPNPPoll *)poll sequence:(NSNumber *)sequence
+                 withChanges:(NSArray *)changes;
+
+/**
+ @brief  Create and configure poll statistic change instance which carry sampled votes traces.
+ 
+ @param poll        Reference on poll for which statistic change should be published.
+ @param sequence    Reference on statistic stream sequence number.
+ @param changes     List of response order number and votes count change pairs.
+ @param traces      List of \b SPNPVoteTrace instances for votes included into change.
+ @param coveredTime Reference on time till which votes has been counted.
+ 
+ @return Configured and ready to use poll statistic change instance.
+ */
++ (instancetype)deltaForPoll:(SPNPPoll *)poll sequence:(NSNumber *)sequence
+                 withChanges:(NSArray *)changes traces:(NSArray *)traces
+                 coveredTime:(NSNumber *)coveredTime;
+
+
+///------------------------------------------------
+/// @name Changes
+///------------------------------------------------
+
+/**
+ @brief  Iterate over stored votes count changes.
+ 
+ @param block Reference on block which will be called for each changed response. Block pass two 
+              arguments: \c order - response order number; \c change - votes count change.
+ */
+- (void)enumerateChangesUsingBlock:(void(^)(NSUInteger order, long long change))block;
+
+#pragma mark -
+
+
+@end
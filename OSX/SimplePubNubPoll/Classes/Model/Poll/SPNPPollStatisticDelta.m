@@ -0,0 +1,151 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPPollStatisticDelta.h"
+#import "SPNPCompactCoder.h"
+#import "SPNPVoteTrace.h"
+#import "SPNPPoll.h"
+
+
+#pragma mark Private interface declaration
+
+@interface SPNPPollStatisticDelta ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, copy) NSString *pollIdentifier;
+@property (nonatomic, strong) NSNumber *sequence;
+@property (nonatomic, strong) NSArray *changes;
+@property (nonatomic, strong) NSArray *traces;
+@property (nonatomic, strong) NSNumber *coveredTime;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize poll statistic change instance.
+ 
+ @param poll        Reference on poll for which statistic change should be published.
+ @param sequence    Reference on statistic stream sequence number.
+ @param changes     List of response order number and votes count change pairs.
+ @param traces      List of \b SPNPVoteTrace instances for votes included into change.
+ @param coveredTime Reference on time till which votes has been counted.
+ 
+ @return Initialized and ready to use poll statistic change instance.
+ */
+- (instancetype)initForPoll:(SPNPPoll *)poll sequence:(NSNumber *)sequence
+                withChanges:(NSArray *)changes traces:(NSArray *)traces
+                coveredTime:(NSNumber *)coveredTime;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPPollStatisticDelta
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)deltaForPoll:(SPNPPoll *)poll sequence:(NSNumber *)sequence
+                 withChanges:(NSArray *)changes {
+    
+    return [self deltaForPoll:poll sequence:sequence withChanges:changes traces:nil
+                  coveredTime:nil];
+}
+
++ (instancetype)deltaForPoll:(SPNPPoll *)poll sequence:(NSNumber *)sequence
+                 withChanges:(NSArray *)changes traces:(NSArray *)traces
+                 coveredTime:(NSNumber *)coveredTime {
+    
+    return [[self alloc] initForPoll:poll sequence:sequence withChanges:changes traces:traces
+                         coveredTime:coveredTime];
+}
+
+- (instancetype)initForPoll:(SPNPPoll *)poll sequence:(NSNumber *)sequence
+                withChanges:(NSArray *)changes traces:(NSArray *)traces
+                coveredTime:(NSNumber *)coveredTime {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _pollIdentifier = [poll.identifier copy];
+        _sequence = sequence;
+        _changes = [changes copy];
+        _traces = [traces copy];
+        _coveredTime = coveredTime;
+    }
+    
+    return self;
+}
+
+
+#pragma mark - Changes
+
+- (void)enumerateChangesUsingBlock:(void(^)(NSUInteger order, long long change))block {
+    
+    NSArray *changes = ([self.changes isKindOfClass:NSArray.class] ? self.changes : nil);
+    for (NSUInteger changeIdx = 0; changeIdx + 1 < changes.count; changeIdx += 2) {
+        
+        NSNumber *order = changes[changeIdx];
+        NSNumber *change = changes[changeIdx + 1];
+        if ([order isKindOfClass:NSNumber.class] && [change isKindOfClass:NSNumber.class]) {
+            
+            block(order.unsignedIntegerValue, change.longLongValue);
+        }
+    }
+}
+
+
+#pragma mark - Compact representation
+
++ (NSUInteger)compactTypeIdentifier {
+    
+    return 5;
+}
+
+- (void)encodeWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    [coder encodePollIdentifier:self.pollIdentifier];
+    [coder encodeNumber:self.sequence];
+    [coder encodeUnsignedInteger:(self.changes.count / 2)];
+    [self enumerateChangesUsingBlock:^(NSUInteger order, long long change) {
+        
+        [coder encodeUnsignedInteger:order];
+        [coder encodeSignedInteger:change];
+    }];
+    if (self.traces.count) {
+        
+        [coder encodeNumber:self.coveredTime];
+        [coder encodeObjects:self.traces];
+    }
+}
+
+- (void)decodeWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    _pollIdentifier = [[coder decodePollIdentifier] copy];
+    _sequence = [coder decodeNumber];
+    uint64_t count = [coder decodeUnsignedInteger];
+    NSMutableArray *changes = [NSMutableArray new];
+    for (uint64_t changeIdx = 0; changeIdx < count && coder.isValid && !coder.isAtEnd; changeIdx++) {
+        
+        [changes addObject:@([coder decodeUnsignedInteger])];
+        [changes addObject:@([coder decodeSignedInteger])];
+    }
+    _changes = [changes copy];
+    if (!coder.isAtEnd) {
+        
+        _coveredTime = [coder decodeNumber];
+        _traces = [coder decodeObjectsOfClass:SPNPVoteTrace.class];
+    }
+}
+
+#pragma mark -
+
+
+@end
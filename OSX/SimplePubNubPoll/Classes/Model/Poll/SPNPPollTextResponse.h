@@ -0,0 +1,84 @@
+#import <Foundation/Foundation.h>
+#import "SPNPSerializable.h"
+
+
+/**
+ @brief      Describes model which store attendee's free-text response on open-text poll.
+ @discussion Open-text polls doesn't have response variants, so attendees send arbitrary short text
+             (for example "one word to describe this talk"). Text normalized before it is counted,
+             so different spelling of the same word counted together.
+             Response sent only with dictionary representation, so host route it by poll 
+             identifier as any other response.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPPollTextResponse : SPNPSerializable
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on identifier of the poll for which response has been sent.
+ */
+@property (nonatomic, readonly, copy) NSString *pollIdentifier;
+
+/**
+ @brief  Stores reference on normalized response text.
+ */
+@property (nonatomic, readonly, copy) NSString *text;
+
+/**
+ @brief      Stores reference on unique identifier of attendee which submitted response.
+ @discussion Used by host to count only one response from each attendee.
+ */
+@property (nonatomic, readonly, copy) NSString *voter;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure attendee's response on open-text poll.
+ 
+ @param pollIdentifier Identifier of the poll for which response should be sent.
+ @param text           Response text (will be normalized).
+ @param voter          Unique identifier of attendee which submit response.
+ 
+ @return Configured and ready to use response instance or \c nil in case if nothing left from 
+         \c text after normalization.
+ */
++ (instancetype)textResponseFor:(NSString *)pollIdentifier withText:(NSString *)text
+                          voter:(NSString *)voter;
+
+
+///------------------------------------------------
+/// @name Normalization
+///------------------------------------------------
+
+/**
+ @brief      Normalize free-text response.
+ @discussion Text folded to lowercase w/o diacritics, everything except letters and digits treated 
+             as word separator, words separated with single space and result truncated to 
+             \c +maximumTextLength characters.
+ 
+ @param text Reference on text which has been entered by attendee.
+ 
+ @return Normalized text or \c nil in case if \c text doesn't contain letters or digits.
+ */
++ (NSString *)normalizedText:(NSString *)text;
+
+/**
+ @brief  Retrieve maximum length of normalized response text.
+ 
+ @return Maximum number of characters.
+ */
++ (NSUInteger)maximumTextLength;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,116 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPPollTextResponse.h"
+#import "SPNPStringTable.h"
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores maximum length of normalized response text.
+ */
+static NSUInteger const kSPNPPollTextResponseMaximumLength = 32;
+
+
+#pragma mark - Private interface declaration
+
+@interface SPNPPollTextResponse ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, copy) NSString *pollIdentifier;
+@property (nonatomic, copy) NSString *text;
+@property (nonatomic, copy) NSString *voter;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize attendee's response on open-text poll.
+ 
+ @param pollIdentifier Identifier of the poll for which response should be sent.
+ @param text           Normalized response text.
+ @param voter          Unique identifier of attendee which submit response.
+ 
+ @return Initialized and ready to use response instance.
+ */
+- (instancetype)initFor:(NSString *)pollIdentifier withText:(NSString *)text
+                  voter:(NSString *)voter;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPPollTextResponse
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)textResponseFor:(NSString *)pollIdentifier withText:(NSString *)text
+                          voter:(NSString *)voter {
+    
+    NSString *normalizedText = [self normalizedText:text];
+    
+    return (normalizedText ? [[self alloc] initFor:pollIdentifier withText:normalizedText
+                                             voter:voter] : nil);
+}
+
+- (instancetype)initFor:(NSString *)pollIdentifier withText:(NSString *)text
+                  voter:(NSString *)voter {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _pollIdentifier = [[SPNPStringTable sharedTable] internedString:pollIdentifier];
+        _text = [text copy];
+        _voter = [voter copy];
+    }
+    
+    return self;
+}
+
+
+#pragma mark - Normalization
+
++ (NSString *)normalizedText:(NSString *)text {
+    
+    if (![text isKindOfClass:NSString.class]) { return nil; }
+    
+    NSStringCompareOptions options = (NSCaseInsensitiveSearch | NSDiacriticInsensitiveSearch |
+                                      NSWidthInsensitiveSearch);
+    NSString *foldedText = [[text stringByFoldingWithOptions:options locale:nil] lowercaseString];
+    NSCharacterSet *separators = [NSCharacterSet alphanumericCharacterSet].invertedSet;
+    NSMutableArray *words = [NSMutableArray new];
+    for (NSString *word in [foldedText componentsSeparatedByCharactersInSet:separators]) {
+        
+        if (word.length) { [words addObject:word]; }
+    }
+    NSString *normalizedText = [words componentsJoinedByString:@" "];
+    if (normalizedText.length > kSPNPPollTextResponseMaximumLength) {
+        
+        // Truncate on composed characters boundary, so result stay valid string.
+        NSUInteger length = [normalizedText rangeOfComposedCharacterSequenceAtIndex:
+                             kSPNPPollTextResponseMaximumLength].location;
+        normalizedText = [[normalizedText substringToIndex:length]
+                          stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+    }
+    
+    return (normalizedText.length ? normalizedText : nil);
+}
+
++ (NSUInteger)maximumTextLength {
+    
+    return kSPNPPollTextResponseMaximumLength;
+}
+
+#pragma mark -
+
+
+@end
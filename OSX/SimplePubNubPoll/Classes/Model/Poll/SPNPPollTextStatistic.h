@@ -0,0 +1,74 @@
+#import <Foundation/Foundation.h>
+#import "SPNPSerializable.h"
+
+
+/**
+ @brief      Describes model which is used to describe open-text poll stats.
+ @discussion Number of distinct answers on open-text poll isn't limited, so host publish only most
+             frequent answers (top-K) with their counting error. Each update is full statistic 
+             state (there is no deltas), so attendees only drop updates which is older than applied
+             one.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPPollTextStatistic : SPNPSerializable
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on target poll identifier.
+ */
+@property (nonatomic, readonly, copy) NSString *pollIdentifier;
+
+/**
+ @brief  Stores reference on statistic stream sequence number.
+ */
+@property (nonatomic, readonly, strong) NSNumber *sequence;
+
+/**
+ @brief  Stores reference on list of \b SPNPTextResponseStatistic instances for most frequent
+         answers (sorted by votes count from largest).
+ */
+@property (nonatomic, readonly, copy) NSArray *responses;
+
+/**
+ @brief  Stores overall number of counted responses.
+ */
+@property (nonatomic, readonly, strong) NSNumber *responsesCount;
+
+/**
+ @brief      Stores maximum counting error of any answer.
+ @discussion Answers which has been received more times than this value are guaranteed to be 
+             counted by host (answers with smaller count can be missing from \c responses).
+ */
+@property (nonatomic, readonly, strong) NSNumber *maximumError;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure open-text poll statistic.
+ 
+ @param pollIdentifier Identifier of the poll for which statistic has been gathered.
+ @param responses      List of \b SPNPTextResponseStatistic instances for most frequent answers.
+ @param sequence       Reference on statistic stream sequence number.
+ @param responsesCount Overall number of counted responses.
+ @param maximumError   Maximum counting error of any answer.
+ 
+ @return Configured and ready to use statistic instance.
+ */
++ (instancetype)statisticForPoll:(NSString *)pollIdentifier withResponses:(NSArray *)responses
+                        sequence:(NSNumber *)sequence
+                  responsesCount:(unsigned long long)responsesCount
+                    maximumError:(unsigned long long)maximumError;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,109 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPPollTextStatistic.h"
+#import "SPNPTextResponseStatistic.h"
+#import "SPNPCompactCoder.h"
+
+
+#pragma mark Private interface declaration
+
+@interface SPNPPollTextStatistic ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, copy) NSString *pollIdentifier;
+@property (nonatomic, strong) NSNumber *sequence;
+@property (nonatomic, copy) NSArray *responses;
+@property (nonatomic, strong) NSNumber *responsesCount;
+@property (nonatomic, strong) NSNumber *maximumError;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize open-text poll statistic.
+ 
+ @param pollIdentifier Identifier of the poll for which statistic has been gathered.
+ @param responses      List of \b SPNPTextResponseStatistic instances for most frequent answers.
+ @param sequence       Reference on statistic stream sequence number.
+ @param responsesCount Overall number of counted responses.
+ @param maximumError   Maximum counting error of any answer.
+ 
+ @return Initialized and ready to use statistic instance.
+ */
+- (instancetype)initForPoll:(NSString *)pollIdentifier withResponses:(NSArray *)responses
+                   sequence:(NSNumber *)sequence responsesCount:(unsigned long long)responsesCount
+               maximumError:(unsigned long long)maximumError;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPPollTextStatistic
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)statisticForPoll:(NSString *)pollIdentifier withResponses:(NSArray *)responses
+                        sequence:(NSNumber *)sequence
+                  responsesCount:(unsigned long long)responsesCount
+                    maximumError:(unsigned long long)maximumError {
+    
+    return [[self alloc] initForPoll:pollIdentifier withResponses:responses sequence:sequence
+                      responsesCount:responsesCount maximumError:maximumError];
+}
+
+- (instancetype)initForPoll:(NSString *)pollIdentifier withResponses:(NSArray *)responses
+                   sequence:(NSNumber *)sequence responsesCount:(unsigned long long)responsesCount
+               maximumError:(unsigned long long)maximumError {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _pollIdentifier = [pollIdentifier copy];
+        _responses = [responses copy];
+        _sequence = sequence;
+        _responsesCount = @(responsesCount);
+        _maximumError = @(maximumError);
+    }
+    
+    return self;
+}
+
+
+#pragma mark - Compact representation
+
++ (NSUInteger)compactTypeIdentifier {
+    
+    return 7;
+}
+
+- (void)encodeWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    [coder encodePollIdentifier:self.pollIdentifier];
+    [coder encodeNumber:self.sequence];
+    [coder encodeNumber:self.responsesCount];
+    [coder encodeNumber:self.maximumError];
+    [coder encodeObjects:self.responses];
+}
+
+- (void)decodeWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    _pollIdentifier = [[coder decodePollIdentifier] copy];
+    _sequence = [coder decodeNumber];
+    _responsesCount = [coder decodeNumber];
+    _maximumError = [coder decodeNumber];
+    _responses = [coder decodeObjectsOfClass:SPNPTextResponseStatistic.class];
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,72 @@
+#import <Foundation/Foundation.h>
+#import "SPNPSerializable.h"
+
+
+/**
+ @brief      Describes model which is used to describe single instant-runoff round standings.
+ @discussion Each ballot counted for most preferred response which hasn't been eliminated in 
+             previous rounds. Ballots on which all ranked responses has been eliminated counted as
+             exhausted.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPRankedRoundStatistic : SPNPSerializable
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on list of continuing response order number and votes count pairs.
+ */
+@property (nonatomic, readonly, copy) NSArray *standings;
+
+/**
+ @brief  Stores reference on list of response order numbers which has been eliminated at the end of 
+         round.
+ */
+@property (nonatomic, readonly, copy) NSArray *eliminated;
+
+/**
+ @brief  Stores number of ballots which doesn't rank any of continuing responses.
+ */
+@property (nonatomic, readonly, strong) NSNumber *exhaustedCount;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure instant-runoff round statistic.
+ 
+ @param standings      List of continuing response order number and votes count pairs.
+ @param eliminated     List of response order numbers which has been eliminated at the end of round.
+ @param exhaustedCount Number of ballots which doesn't rank any of continuing responses.
+ 
+ @return Configured and ready to use round statistic instance.
+ */
++ (instancetype)roundWithStandings:(NSArray *)standings eliminated:(NSArray *)eliminated
+                    exhaustedCount:(unsigned long long)exhaustedCount;
+
+
+///------------------------------------------------
+/// @name Standings
+///------------------------------------------------
+
+/**
+ @brief  Enumerate continuing responses votes count.
+ 
+ @param block Reference on block which is called for each continuing response. Block pass two 
+              arguments: \c order - response order number; \c votesCount - number of ballots which
+              has been counted for response in this round.
+ */
+- (void)enumerateStandingsUsingBlock:(void(^)(NSUInteger order,
+                                              unsigned long long votesCount))block;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,135 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPRankedRoundStatistic.h"
+#import "SPNPCompactCoder.h"
+
+
+#pragma mark Private interface declaration
+
+@interface SPNPRankedRoundStatistic ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, copy) NSArray *standings;
+@property (nonatomic, copy) NSArray *eliminated;
+@property (nonatomic, strong) NSNumber *exhaustedCount;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize instant-runoff round statistic.
+ 
+ @param standings      List of continuing response order number and votes count pairs.
+ @param eliminated     List of response order numbers which has been eliminated at the end of round.
+ @param exhaustedCount Number of ballots which doesn't rank any of continuing responses.
+ 
+ @return Initialized and ready to use round statistic instance.
+ */
+- (instancetype)initWithStandings:(NSArray *)standings eliminated:(NSArray *)eliminated
+                   exhaustedCount:(unsigned long long)exhaustedCount;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPRankedRoundStatistic
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)roundWithStandings:(NSArray *)standings eliminated:(NSArray *)eliminated
+                    exhaustedCount:(unsigned long long)exhaustedCount {
+    
+    return [[self alloc] initWithStandings:standings eliminated:eliminated
+                            exhaustedCount:exhaustedCount];
+}
+
+- (instancetype)initWithStandings:(NSArray *)standings eliminated:(NSArray *)eliminated
+                   exhaustedCount:(unsigned long long)exhaustedCount {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _standings = [standings copy];
+        _eliminated = [eliminated copy];
+        _exhaustedCount = @(exhaustedCount);
+    }
+    
+    return self;
+}
+
+
+#pragma mark - Standings
+
+- (void)enumerateStandingsUsingBlock:(void(^)(NSUInteger order,
+                                              unsigned long long votesCount))block {
+    
+    NSArray *standings = ([self.standings isKindOfClass:NSArray.class] ? self.standings : nil);
+    for (NSUInteger standingIdx = 0; standingIdx + 1 < standings.count; standingIdx += 2) {
+        
+        NSNumber *order = standings[standingIdx];
+        NSNumber *votesCount = standings[standingIdx + 1];
+        if ([order isKindOfClass:NSNumber.class] && [votesCount isKindOfClass:NSNumber.class]) {
+            
+            block(order.unsignedIntegerValue, votesCount.unsignedLongLongValue);
+        }
+    }
+}
+
+
+#pragma mark - Compact representation
+
++ (NSUInteger)compactTypeIdentifier {
+    
+    return 9;
+}
+
+- (void)encodeWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    [coder encodeUnsignedInteger:(self.standings.count / 2)];
+    [self enumerateStandingsUsingBlock:^(NSUInteger order, unsigned long long votesCount) {
+        
+        [coder encodeUnsignedInteger:order];
+        [coder encodeUnsignedInteger:votesCount];
+    }];
+    [coder encodeUnsignedInteger:self.eliminated.count];
+    for (NSNumber *order in self.eliminated) {
+        
+        [coder encodeUnsignedInteger:order.unsignedIntegerValue];
+    }
+    [coder encodeNumber:self.exhaustedCount];
+}
+
+- (void)decodeWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    uint64_t count = [coder decodeUnsignedInteger];
+    NSMutableArray *standings = [NSMutableArray new];
+    for (uint64_t standingIdx = 0; standingIdx < count && coder.isValid && !coder.isAtEnd;
+         standingIdx++) {
+        
+        [standings addObject:@([coder decodeUnsignedInteger])];
+        [standings addObject:@([coder decodeUnsignedInteger])];
+    }
+    _standings = [standings copy];
+    count = [coder decodeUnsignedInteger];
+    NSMutableArray *eliminated = [NSMutableArray new];
+    for (uint64_t orderIdx = 0; orderIdx < count && coder.isValid && !coder.isAtEnd; orderIdx++) {
+        
+        [eliminated addObject:@([coder decodeUnsignedInteger])];
+    }
+    _eliminated = [eliminated copy];
+    _exhaustedCount = [coder decodeNumber];
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,60 @@
+#import <Foundation/Foundation.h>
+
+
+/**
+ @brief      Immutable versioned view on poll statistic.
+ @discussion Statistic instances updated in place by manager on main thread, so they can't be read
+             from other queues. Snapshot stores copies of them, which never change after snapshot
+             has been taken, so it can be serialized or published from any queue w/o locks.
+             New snapshot shares copies of unchanged responses with previous snapshot and previous
+             snapshot itself returned if nothing changed (in this case \c version stay the same).
+             Snapshots should be taken on the same thread on which statistic is updated.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPStatisticSnapshot : NSObject
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores statistic generation number (incremented each time when snapshot content change).
+ */
+@property (nonatomic, readonly, assign) unsigned long long version;
+
+/**
+ @brief  Stores reference on list of immutable \b SPNPPollResponseStatistic copies (in the same
+         order as statistic from which snapshot has been taken).
+ */
+@property (nonatomic, readonly, copy) NSArray *statistics;
+
+/**
+ @brief  Stores reference on list of votes count for each response.
+ */
+@property (nonatomic, readonly, copy) NSArray *votesCount;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Take snapshot of statistic.
+ 
+ @param statistics Reference on list of \b SPNPPollResponseStatistic instances which is updated in
+                   place.
+ @param snapshot   Reference on snapshot which has been taken from the same statistic before (can
+                   be \c nil).
+ 
+ @return \c snapshot if statistic doesn't changed since it has been taken or new snapshot.
+ */
++ (instancetype)snapshotOfStatistics:(NSArray *)statistics
+                    previousSnapshot:(SPNPStatisticSnapshot *)snapshot;
+
+#pragma mark -
+
+
+@end
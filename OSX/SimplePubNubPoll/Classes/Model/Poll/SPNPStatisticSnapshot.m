@@ -0,0 +1,111 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPStatisticSnapshot.h"
+#import "SPNPPollResponseStatistic.h"
+
+
+#pragma mark Private interface declaration
+
+@interface SPNPStatisticSnapshot ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, assign) unsigned long long version;
+@property (nonatomic, copy) NSArray *statistics;
+@property (nonatomic, copy) NSArray *votesCount;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize statistic snapshot.
+ 
+ @param statistics Reference on list of immutable response statistic copies.
+ @param version    Statistic generation number.
+ 
+ @return Initialized and ready to use statistic snapshot.
+ */
+- (instancetype)initWithStatistics:(NSArray *)statistics version:(unsigned long long)version;
+
+
+#pragma mark - Misc
+
+/**
+ @brief      Check whether response statistic copy still represent statistic instance.
+ @discussion Statistic replace values instead of changing them, so comparing references is
+             enough.
+ 
+ @param copy      Reference on response statistic copy from previous snapshot.
+ @param statistic Reference on response statistic which is updated in place.
+ 
+ @return \c YES in case if copy can be shared with new snapshot.
+ */
++ (BOOL)isCopy:(SPNPPollResponseStatistic *)copy
+   ofStatistic:(SPNPPollResponseStatistic *)statistic;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPStatisticSnapshot
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)snapshotOfStatistics:(NSArray *)statistics
+                    previousSnapshot:(SPNPStatisticSnapshot *)snapshot {
+    
+    NSArray *previousStatistics = (statistics.count == snapshot.statistics.count ?
+                                   snapshot.statistics : nil);
+    NSMutableArray *copies = [NSMutableArray arrayWithCapacity:statistics.count];
+    BOOL isChanged = (snapshot == nil || previousStatistics == nil);
+    for (NSUInteger statisticIdx = 0; statisticIdx < statistics.count; statisticIdx++) {
+        
+        SPNPPollResponseStatistic *statistic = statistics[statisticIdx];
+        SPNPPollResponseStatistic *copy = previousStatistics[statisticIdx];
+        if (!copy || ![self isCopy:copy ofStatistic:statistic]) {
+            
+            copy = [statistic copy];
+            isChanged = YES;
+        }
+        [copies addObject:copy];
+    }
+    
+    return (isChanged ? [[self alloc] initWithStatistics:copies version:(snapshot.version + 1)] :
+            snapshot);
+}
+
+- (instancetype)initWithStatistics:(NSArray *)statistics version:(unsigned long long)version {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _statistics = [statistics copy];
+        _votesCount = [[statistics valueForKey:@"votesCount"] copy];
+        _version = version;
+    }
+    
+    return self;
+}
+
+
+#pragma mark - Misc
+
++ (BOOL)isCopy:(SPNPPollResponseStatistic *)copy
+   ofStatistic:(SPNPPollResponseStatistic *)statistic {
+    
+    return (copy.votesCount == statistic.votesCount && copy.order == statistic.order &&
+            copy.response == statistic.response && copy.nodeCounters == statistic.nodeCounters);
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,140 @@
+#import <Foundation/Foundation.h>
+
+
+/**
+ @brief      Contiguous storage of poll responses and their votes count.
+ @discussion Store keeps votes count of all response variants in single array indexed by response
+             index (position in list sorted by order number), so counting and diffing iterate plain
+             memory instead of statistic objects and boxed numbers. Poll identifier and response 
+             titles interned using \b SPNPStringTable and shared with models, so poll with hundreds 
+             or thousands response variants doesn't duplicate them.
+             Store is not thread-safe and should be used from single queue.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPStatisticStore : NSObject
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on identifier of the poll which votes stored.
+ */
+@property (nonatomic, readonly, copy) NSString *pollIdentifier;
+
+/**
+ @brief  Stores number of response variants.
+ */
+@property (nonatomic, readonly, assign) NSUInteger count;
+
+/**
+ @brief  Stores overall number of votes stored for all response variants.
+ */
+@property (nonatomic, readonly, assign) unsigned long long totalVotesCount;
+
+/**
+ @brief  Stores reference on contiguous list of votes count (\c count items).
+ */
+@property (nonatomic, readonly, assign) const unsigned long long *votesCounts;
+
+/**
+ @brief  Stores number of bytes which is used by store (w/o shared strings).
+ */
+@property (nonatomic, readonly, assign) NSUInteger memoryUsage;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure store for response statistic.
+ 
+ @param statistics     Reference on list of \b SPNPPollResponseStatistic instances (in any 
+                       order).
+ @param pollIdentifier Reference on identifier of the poll for which statistic has been gathered.
+ 
+ @return Configured and ready to use store with votes count from \c statistics.
+ */
++ (instancetype)storeWithStatistics:(NSArray *)statistics forPoll:(NSString *)pollIdentifier;
+
+
+///------------------------------------------------
+/// @name Responses
+///------------------------------------------------
+
+/**
+ @brief  Find response index.
+ 
+ @param order Response order number.
+ 
+ @return Index of response with specified \c order or \c NSNotFound.
+ */
+- (NSUInteger)indexForOrder:(NSUInteger)order;
+
+/**
+ @brief  Retrieve response order number.
+ 
+ @param index Response index.
+ 
+ @return Order number or \c NSNotFound for index which is out of bounds.
+ */
+- (NSUInteger)orderAtIndex:(NSUInteger)index;
+
+/**
+ @brief  Retrieve response title.
+ 
+ @param index Response index.
+ 
+ @return Interned response title or \c nil for index which is out of bounds.
+ */
+- (NSString *)responseAtIndex:(NSUInteger)index;
+
+
+///------------------------------------------------
+/// @name Votes
+///------------------------------------------------
+
+/**
+ @brief  Retrieve response votes count.
+ 
+ @param index Response index.
+ 
+ @return Number of votes or \c 0 for index which is out of bounds.
+ */
+- (unsigned long long)votesCountAtIndex:(NSUInteger)index;
+
+/**
+ @brief  Replace response votes count.
+ 
+ @param votesCount Number of votes which has been given for response.
+ @param index      Response index.
+ 
+ @return \c YES in case if stored value has been changed.
+ */
+- (BOOL)setVotesCount:(unsigned long long)votesCount atIndex:(NSUInteger)index;
+
+/**
+ @brief  Replace votes count of all responses at once.
+ 
+ @param votesCount Reference on list of votes count for each response (sorted by response order).
+ 
+ @return Indexes of responses which votes count has been changed or \c nil in case if \c votesCount
+         doesn't match responses count.
+ */
+- (NSIndexSet *)updateWithVotesCount:(NSArray *)votesCount;
+
+/**
+ @brief  Retrieve boxed votes count.
+ 
+ @return List of votes count for each response (sorted by response order).
+ */
+- (NSArray *)votesCount;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,203 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPStatisticStore.h"
+#import "SPNPPollResponseStatistic.h"
+#import "SPNPStringTable.h"
+
+
+#pragma mark Private interface declaration
+
+@interface SPNPStatisticStore () {
+    
+    /**
+     @brief  Stores reference on contiguous list of response votes count.
+     */
+    unsigned long long *_counts;
+    
+    /**
+     @brief  Stores reference on contiguous list of response order numbers (sorted ascending).
+     */
+    NSUInteger *_orders;
+}
+
+
+#pragma mark - Properties
+
+@property (nonatomic, copy) NSString *pollIdentifier;
+@property (nonatomic, assign) NSUInteger count;
+@property (nonatomic, assign) unsigned long long totalVotesCount;
+
+/**
+ @brief  Stores reference on list of interned response titles (sorted by response order).
+ */
+@property (nonatomic, copy) NSArray *responses;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize store.
+ 
+ @param statistics     Reference on list of \b SPNPPollResponseStatistic instances.
+ @param pollIdentifier Reference on identifier of the poll which votes stored.
+ 
+ @return Initialized and ready to use store.
+ */
+- (instancetype)initWithStatistics:(NSArray *)statistics forPoll:(NSString *)pollIdentifier;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPStatisticStore
+
+
+#pragma mark - Information
+
+- (const unsigned long long *)votesCounts {
+    
+    return _counts;
+}
+
+- (NSUInteger)memoryUsage {
+    
+    return (self.count * (sizeof(unsigned long long) + sizeof(NSUInteger) + sizeof(id)));
+}
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)storeWithStatistics:(NSArray *)statistics forPoll:(NSString *)pollIdentifier {
+    
+    SPNPStatisticStore *store = [[self alloc] initWithStatistics:statistics forPoll:pollIdentifier];
+    for (SPNPPollResponseStatistic *statistic in statistics) {
+        
+        [store setVotesCount:statistic.votesCount.unsignedLongLongValue
+                     atIndex:[store indexForOrder:statistic.order.unsignedIntegerValue]];
+    }
+    
+    return store;
+}
+
+- (instancetype)initWithStatistics:(NSArray *)statistics forPoll:(NSString *)pollIdentifier {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        SPNPStringTable *strings = [SPNPStringTable sharedTable];
+        NSSortDescriptor *descriptor = [NSSortDescriptor sortDescriptorWithKey:@"order"
+                                                                     ascending:YES];
+        NSArray *sortedStatistics = [statistics sortedArrayUsingDescriptors:@[descriptor]];
+        NSMutableArray *responses = [NSMutableArray arrayWithCapacity:sortedStatistics.count];
+        _pollIdentifier = [strings internedString:pollIdentifier];
+        _count = sortedStatistics.count;
+        _counts = calloc(MAX(_count, (NSUInteger)1), sizeof(unsigned long long));
+        _orders = calloc(MAX(_count, (NSUInteger)1), sizeof(NSUInteger));
+        for (NSUInteger statisticIdx = 0; statisticIdx < _count; statisticIdx++) {
+            
+            SPNPPollResponseStatistic *statistic = sortedStatistics[statisticIdx];
+            _orders[statisticIdx] = statistic.order.unsignedIntegerValue;
+            [responses addObject:([strings internedString:statistic.response]?: @"")];
+        }
+        _responses = [responses copy];
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    
+    free(_counts);
+    free(_orders);
+}
+
+
+#pragma mark - Responses
+
+- (NSUInteger)indexForOrder:(NSUInteger)order {
+    
+    // Order numbers assigned sequentially by host, so in most cases order is index.
+    if (order < self.count && _orders[order] == order) { return order; }
+    
+    NSUInteger lowerIdx = 0;
+    NSUInteger upperIdx = self.count;
+    while (lowerIdx < upperIdx) {
+        
+        NSUInteger middleIdx = (lowerIdx + (upperIdx - lowerIdx) / 2);
+        if (_orders[middleIdx] == order) { return middleIdx; }
+        else if (_orders[middleIdx] < order) { lowerIdx = middleIdx + 1; }
+        else { upperIdx = middleIdx; }
+    }
+    
+    return NSNotFound;
+}
+
+- (NSUInteger)orderAtIndex:(NSUInteger)index {
+    
+    return (index < self.count ? _orders[index] : NSNotFound);
+}
+
+- (NSString *)responseAtIndex:(NSUInteger)index {
+    
+    return (index < self.count ? self.responses[index] : nil);
+}
+
+
+#pragma mark - Votes
+
+- (unsigned long long)votesCountAtIndex:(NSUInteger)index {
+    
+    return (index < self.count ? _counts[index] : 0);
+}
+
+- (BOOL)setVotesCount:(unsigned long long)votesCount atIndex:(NSUInteger)index {
+    
+    BOOL isChanged = (index < self.count && _counts[index] != votesCount);
+    if (isChanged) {
+        
+        self.totalVotesCount = (self.totalVotesCount - _counts[index] + votesCount);
+        _counts[index] = votesCount;
+    }
+    
+    return isChanged;
+}
+
+- (NSIndexSet *)updateWithVotesCount:(NSArray *)votesCount {
+    
+    if (votesCount.count != self.count) { return nil; }
+    
+    NSMutableIndexSet *changedIndexes = [NSMutableIndexSet new];
+    NSUInteger responseIdx = 0;
+    for (NSNumber *responseVotesCount in votesCount) {
+        
+        if ([self setVotesCount:responseVotesCount.unsignedLongLongValue atIndex:responseIdx]) {
+            
+            [changedIndexes addIndex:responseIdx];
+        }
+        responseIdx++;
+    }
+    
+    return changedIndexes;
+}
+
+- (NSArray *)votesCount {
+    
+    NSMutableArray *votesCount = [NSMutableArray arrayWithCapacity:self.count];
+    for (NSUInteger responseIdx = 0; responseIdx < self.count; responseIdx++) {
+        
+        [votesCount addObject:@(_counts[responseIdx])];
+    }
+    
+    return [votesCount copy];
+}
+
+#pragma mark -
+
+
+@end
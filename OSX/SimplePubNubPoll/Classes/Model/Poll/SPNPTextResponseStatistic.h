@@ -0,0 +1,56 @@
+#import <Foundation/Foundation.h>
+#import "SPNPSerializable.h"
+
+
+/**
+ @brief      Describes model which is used to describe free-text response stats.
+ @discussion Host count free-text responses approximately (see \b SPNPHeavyHitters), so object 
+             stores estimated number of responses with same text along with estimation error: real
+             number of responses is in [votesCount - error, votesCount] range.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPTextResponseStatistic : SPNPSerializable
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on normalized response text.
+ */
+@property (nonatomic, readonly, copy) NSString *text;
+
+/**
+ @brief  Stores estimated number of responses with \c text (never lower than real one).
+ */
+@property (nonatomic, readonly, strong) NSNumber *votesCount;
+
+/**
+ @brief  Stores maximum overestimation of \c votesCount.
+ */
+@property (nonatomic, readonly, strong) NSNumber *error;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure statistic object for free-text response.
+ 
+ @param text       Reference on normalized response text.
+ @param votesCount Estimated number of responses with \c text.
+ @param error      Maximum overestimation of \c votesCount.
+ 
+ @return Configured and ready to use statistic instance.
+ */
++ (instancetype)statisticForText:(NSString *)text votesCount:(unsigned long long)votesCount
+                           error:(unsigned long long)error;
+
+#pragma mark -
+
+
+@end
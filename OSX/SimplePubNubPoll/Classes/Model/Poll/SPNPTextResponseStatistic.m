@@ -0,0 +1,95 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPTextResponseStatistic.h"
+#import "SPNPCompactCoder.h"
+#import "SPNPStringTable.h"
+
+
+#pragma mark Private interface declaration
+
+@interface SPNPTextResponseStatistic ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, copy) NSString *text;
+@property (nonatomic, strong) NSNumber *votesCount;
+@property (nonatomic, strong) NSNumber *error;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize statistic object for free-text response.
+ 
+ @param text       Reference on normalized response text.
+ @param votesCount Estimated number of responses with \c text.
+ @param error      Maximum overestimation of \c votesCount.
+ 
+ @return Initialized and ready to use statistic instance.
+ */
+- (instancetype)initForText:(NSString *)text votesCount:(unsigned long long)votesCount
+                      error:(unsigned long long)error;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPTextResponseStatistic
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)statisticForText:(NSString *)text votesCount:(unsigned long long)votesCount
+                           error:(unsigned long long)error {
+    
+    return [[self alloc] initForText:text votesCount:votesCount error:error];
+}
+
+- (instancetype)initForText:(NSString *)text votesCount:(unsigned long long)votesCount
+                      error:(unsigned long long)error {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _text = [text copy];
+        _votesCount = @(votesCount);
+        _error = @(error);
+    }
+    
+    return self;
+}
+
+
+#pragma mark - Compact representation
+
++ (NSUInteger)compactTypeIdentifier {
+    
+    return 8;
+}
+
+- (void)encodeWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    [coder encodeString:self.text];
+    [coder encodeNumber:self.votesCount];
+    [coder encodeNumber:self.error];
+}
+
+- (void)decodeWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    // Same popular answers arrive with each update, so their text shared between updates.
+    _text = [[SPNPStringTable sharedTable] internedString:[coder decodeString]];
+    _votesCount = [coder decodeNumber];
+    _error = [coder decodeNumber];
+}
+
+#pragma mark -
+
+
+@end
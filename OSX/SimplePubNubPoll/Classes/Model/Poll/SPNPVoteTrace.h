@@ -0,0 +1,102 @@
+#import <Foundation/Foundation.h>
+#import "SPNPSerializable.h"
+
+
+/**
+ @brief      Describes timestamps of single sampled attendee vote.
+ @discussion Attendee stamp sampled votes with send time, host add receive, aggregation and publish
+             time and send trace back with statistic update which include vote. All timestamps are
+             milliseconds since 1970: send time taken from attendee's clock and rest of them from
+             host's clock, so only differences between timestamps from same clock are meaningful.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPVoteTrace : SPNPSerializable
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief      Stores reference on fingerprint of attendee which sent vote (see \b SPNPVoterIndex).
+ @discussion Only 53 most significant bits of fingerprint stored, so value survive \b JSON number
+             representation (see \c +traceKeyForVoterKey:).
+ */
+@property (nonatomic, readonly, strong) NSNumber *voterKey;
+
+/**
+ @brief  Stores reference on time when attendee sent vote.
+ */
+@property (nonatomic, readonly, strong) NSNumber *sentTime;
+
+/**
+ @brief  Stores reference on time when host received vote.
+ */
+@property (nonatomic, readonly, strong) NSNumber *receivedTime;
+
+/**
+ @brief  Stores reference on time when host counted vote.
+ */
+@property (nonatomic, readonly, strong) NSNumber *aggregatedTime;
+
+/**
+ @brief  Stores reference on time when host published statistic update which include vote.
+ */
+@property (nonatomic, readonly, strong) NSNumber *publishedTime;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure vote trace.
+ 
+ @param voterKey       Fingerprint of attendee which sent vote.
+ @param sentTime       Reference on time when attendee sent vote.
+ @param receivedTime   Reference on time when host received vote.
+ @param aggregatedTime Reference on time when host counted vote.
+ @param publishedTime  Reference on time when host published statistic which include vote.
+ 
+ @return Configured and ready to use vote trace.
+ */
++ (instancetype)traceForVoterKey:(uint64_t)voterKey sentTime:(NSNumber *)sentTime
+                    receivedTime:(NSNumber *)receivedTime aggregatedTime:(NSNumber *)aggregatedTime
+                   publishedTime:(NSNumber *)publishedTime;
+
+/**
+ @brief  Create copy of vote trace which is completed with statistic publish time.
+ 
+ @param publishedTime Reference on time when host published statistic which include vote.
+ 
+ @return Configured and ready to use vote trace.
+ */
+- (instancetype)traceWithPublishedTime:(NSNumber *)publishedTime;
+
+
+///------------------------------------------------
+/// @name Misc
+///------------------------------------------------
+
+/**
+ @brief  Convert voter fingerprint to the value which is stored in trace.
+ 
+ @param voterKey Fingerprint of attendee which sent vote.
+ 
+ @return Value which can be compared with \c voterKey.
+ */
++ (NSNumber *)traceKeyForVoterKey:(uint64_t)voterKey;
+
+/**
+ @brief  Retrieve current time in format which is used by traces.
+ 
+ @return Number of milliseconds since 1970.
+ */
++ (NSNumber *)currentTime;
+
+#pragma mark -
+
+
+@end
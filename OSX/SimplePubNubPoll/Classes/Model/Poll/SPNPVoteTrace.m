@@ -0,0 +1,131 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPVoteTrace.h"
+#import "SPNPCompactCoder.h"
+
+
+#pragma mark Private interface declaration
+
+@interface SPNPVoteTrace ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, strong) NSNumber *voterKey;
+@property (nonatomic, strong) NSNumber *sentTime;
+@property (nonatomic, strong) NSNumber *receivedTime;
+@property (nonatomic, strong) NSNumber *aggregatedTime;
+@property (nonatomic, strong) NSNumber *publishedTime;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize vote trace.
+ 
+ @param voterKey       Fingerprint of attendee which sent vote.
+ @param sentTime       Reference on time when attendee sent vote.
+ @param receivedTime   Reference on time when host received vote.
+ @param aggregatedTime Reference on time when host counted vote.
+ @param publishedTime  Reference on time when host published statistic which include vote.
+ 
+ @return Initialized and ready to use vote trace.
+ */
+- (instancetype)initForVoterKey:(uint64_t)voterKey sentTime:(NSNumber *)sentTime
+                   receivedTime:(NSNumber *)receivedTime aggregatedTime:(NSNumber *)aggregatedTime
+                  publishedTime:(NSNumber *)publishedTime;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPVoteTrace
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)traceForVoterKey:(uint64_t)voterKey sentTime:(NSNumber *)sentTime
+                    receivedTime:(NSNumber *)receivedTime aggregatedTime:(NSNumber *)aggregatedTime
+                   publishedTime:(NSNumber *)publishedTime {
+    
+    return [[self alloc] initForVoterKey:voterKey sentTime:sentTime receivedTime:receivedTime
+                          aggregatedTime:aggregatedTime publishedTime:publishedTime];
+}
+
+- (instancetype)initForVoterKey:(uint64_t)voterKey sentTime:(NSNumber *)sentTime
+                   receivedTime:(NSNumber *)receivedTime aggregatedTime:(NSNumber *)aggregatedTime
+                  publishedTime:(NSNumber *)publishedTime {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _voterKey = [SPNPVoteTrace traceKeyForVoterKey:voterKey];
+        _sentTime = sentTime;
+        _receivedTime = receivedTime;
+        _aggregatedTime = aggregatedTime;
+        _publishedTime = publishedTime;
+    }
+    
+    return self;
+}
+
+- (instancetype)traceWithPublishedTime:(NSNumber *)publishedTime {
+    
+    SPNPVoteTrace *trace = [[[self class] alloc] initForVoterKey:0 sentTime:self.sentTime
+                                                    receivedTime:self.receivedTime
+                                                  aggregatedTime:self.aggregatedTime
+                                                   publishedTime:publishedTime];
+    trace.voterKey = self.voterKey;
+    
+    return trace;
+}
+
+
+#pragma mark - Misc
+
++ (NSNumber *)traceKeyForVoterKey:(uint64_t)voterKey {
+    
+    return @(voterKey >> 11);
+}
+
++ (NSNumber *)currentTime {
+    
+    return @((unsigned long long)([[NSDate date] timeIntervalSince1970] * 1000.0f));
+}
+
+
+#pragma mark - Compact representation
+
++ (NSUInteger)compactTypeIdentifier {
+    
+    return 6;
+}
+
+- (void)encodeWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    [coder encodeNumber:self.voterKey];
+    [coder encodeNumber:self.sentTime];
+    [coder encodeNumber:self.receivedTime];
+    [coder encodeNumber:self.aggregatedTime];
+    [coder encodeNumber:self.publishedTime];
+}
+
+- (void)decodeWithCompactCoder:(SPNPCompactCoder *)coder {
+    
+    _voterKey = [coder decodeNumber];
+    _sentTime = [coder decodeNumber];
+    _receivedTime = [coder decodeNumber];
+    _aggregatedTime = [coder decodeNumber];
+    _publishedTime = [coder decodeNumber];
+}
+
+#pragma mark -
+
+
+@end
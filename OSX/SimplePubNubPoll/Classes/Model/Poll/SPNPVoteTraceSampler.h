@@ -0,0 +1,96 @@
+#import <Foundation/Foundation.h>
+
+
+#pragma mark Class forward
+
+@class SPNPMetrics;
+
+
+/**
+ @brief      Attendee side sampler of votes which should be traced end-to-end.
+ @discussion Sampler decide which votes carry send time and keep send time of sampled votes till 
+             statistic update with their traces is received. Number of tracked votes is bounded, 
+             so traces lost by host or transport doesn't grow memory usage (oldest votes dropped).
+             Sampler should be used from main thread.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPVoteTraceSampler : NSObject
+
+
+///------------------------------------------------
+/// @name Configuration
+///------------------------------------------------
+
+/**
+ @brief  Stores fraction of votes which should be traced (from \c 0 to \c 1).
+ */
+@property (nonatomic, assign) double sampleRate;
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores maximum number of sampled votes which wait for their traces.
+ */
+@property (nonatomic, readonly, assign) NSUInteger maximumTracesCount;
+
+/**
+ @brief  Stores number of sampled votes which wait for their traces.
+ */
+@property (nonatomic, readonly, assign) NSUInteger pendingTracesCount;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure votes sampler.
+ 
+ @param maximumTracesCount Maximum number of sampled votes which wait for their traces.
+ 
+ @return Configured and ready to use votes sampler with disabled sampling.
+ */
++ (instancetype)samplerWithMaximumTracesCount:(NSUInteger)maximumTracesCount;
+
+
+///------------------------------------------------
+/// @name Sampling
+///------------------------------------------------
+
+/**
+ @brief  Decide whether vote which is about to be sent should be traced.
+ 
+ @return Send time which should be stored in vote or \c nil in case if vote hasn't been sampled.
+ */
+- (NSNumber *)traceTimeForVote;
+
+/**
+ @brief      Record latency of sampled votes which has been included into statistic update.
+ @discussion Visible latency measured by attendee's clock only and its components computed as 
+             differences of host's stamps, so clocks doesn't need to be synchronized. Each sampled 
+             vote recorded only once, traces of other attendees and unknown votes ignored.
+ 
+ @param traces   List of \b SPNPVoteTrace instances which has been sent with statistic update.
+ @param voterKey Fingerprint of attendee which sent sampled votes.
+ @param time     Reference on time when statistic update has been received.
+ @param metrics  Reference on metrics into which latencies should be recorded.
+ 
+ @return Number of sampled votes which latency has been recorded.
+ */
+- (NSUInteger)recordLatencyOfTraces:(NSArray *)traces forVoterKey:(uint64_t)voterKey
+                             atTime:(NSNumber *)time inMetrics:(SPNPMetrics *)metrics;
+
+/**
+ @brief  Forget all sampled votes which wait for their traces.
+ */
+- (void)reset;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,117 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPVoteTraceSampler.h"
+#import "SPNPVoteTrace.h"
+#import "SPNPMetrics.h"
+
+
+#pragma mark Private interface declaration
+
+@interface SPNPVoteTraceSampler ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, assign) NSUInteger maximumTracesCount;
+
+/**
+ @brief  Stores send time of sampled votes for which statistic update with trace still not 
+         received.
+ */
+@property (nonatomic, strong) NSMutableOrderedSet *tracedVoteTimes;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPVoteTraceSampler
+
+
+#pragma mark - Information
+
+- (NSUInteger)pendingTracesCount {
+    
+    return self.tracedVoteTimes.count;
+}
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)samplerWithMaximumTracesCount:(NSUInteger)maximumTracesCount {
+    
+    SPNPVoteTraceSampler *sampler = [self new];
+    sampler.maximumTracesCount = maximumTracesCount;
+    sampler.tracedVoteTimes = [NSMutableOrderedSet new];
+    
+    return sampler;
+}
+
+
+#pragma mark - Sampling
+
+- (NSNumber *)traceTimeForVote {
+    
+    NSNumber *traceTime = nil;
+    if (self.maximumTracesCount && self.sampleRate > 0.0f &&
+        (double)arc4random_uniform(UINT32_MAX) < self.sampleRate * (double)UINT32_MAX) {
+        
+        traceTime = [SPNPVoteTrace currentTime];
+        [self.tracedVoteTimes addObject:traceTime];
+        if (self.tracedVoteTimes.count > self.maximumTracesCount) {
+            
+            [self.tracedVoteTimes removeObjectAtIndex:0];
+        }
+    }
+    
+    return traceTime;
+}
+
+- (NSUInteger)recordLatencyOfTraces:(NSArray *)traces forVoterKey:(uint64_t)voterKey
+                             atTime:(NSNumber *)time inMetrics:(SPNPMetrics *)metrics {
+    
+    if (!traces.count || !self.tracedVoteTimes.count) { return 0; }
+    
+    NSUInteger recordedTracesCount = 0;
+    NSNumber *traceVoterKey = [SPNPVoteTrace traceKeyForVoterKey:voterKey];
+    for (SPNPVoteTrace *trace in traces) {
+        
+        if (![trace.voterKey isEqualToNumber:traceVoterKey] ||
+            ![self.tracedVoteTimes containsObject:trace.sentTime]) {
+            
+            continue;
+        }
+        [self.tracedVoteTimes removeObject:trace.sentTime];
+        recordedTracesCount++;
+        
+        // Trace time stamps stored in milliseconds.
+        double receivedTime = trace.receivedTime.doubleValue;
+        double aggregatedTime = trace.aggregatedTime.doubleValue;
+        double publishedTime = trace.publishedTime.doubleValue;
+        double visible = (time.doubleValue - trace.sentTime.doubleValue);
+        double transport = (visible - (publishedTime - receivedTime));
+        [metrics recordLatency:SPNPVoteVisibleLatency withDuration:(visible / 1000.0f)];
+        [metrics recordLatency:SPNPVoteIngestLatency
+                  withDuration:((aggregatedTime - receivedTime) / 1000.0f)];
+        [metrics recordLatency:SPNPVotePublishIntervalLatency
+                  withDuration:((publishedTime - aggregatedTime) / 1000.0f)];
+        [metrics recordLatency:SPNPVoteTransportLatency withDuration:(transport / 1000.0f)];
+    }
+    
+    return recordedTracesCount;
+}
+
+- (void)reset {
+    
+    [self.tracedVoteTimes removeAllObjects];
+}
+
+#pragma mark -
+
+
+@end
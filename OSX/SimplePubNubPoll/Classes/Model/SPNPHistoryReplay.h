@@ -0,0 +1,103 @@
+#import <Foundation/Foundation.h>
+#import "SPNPTransport.h"
+
+
+#pragma mark Class forward
+
+@class SPNPVoterIndex, SPNPPoll;
+
+
+/**
+ @brief      Host side votes recount from responses channel history.
+ @discussion Replay split time range since poll start into several segments and page through each
+             of them independently, so few history requests are in flight at once. Each page parsed
+             on concurrent queue and then folded into counters in original time order (pages which
+             arrived earlier than preceding ones wait for them), so final votes count is exact and
+             doesn't depend on order in which pages arrived. Same de-duplication rules used as for
+             real-time votes.
+             Each responses shard channel paged independently (attendee always send responses to
+             the same shard, so only pages of single channel should be folded in time order).
+             Replay should be used from main thread. Blocks called on main queue.
+
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPHistoryReplay : NSObject
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief      Stores maximum number of history requests which can be in flight at once.
+ @discussion Value used as number of time range segments (split between channels). Default
+             value is \c 4.
+ */
+@property (nonatomic, assign) NSUInteger maximumConcurrentRequests;
+
+/**
+ @brief      Stores reference on names of channels into which attendees send responses.
+ @discussion Poll which use several shard channels require all of them to be replayed.
+ */
+@property (nonatomic, copy) NSArray *channels;
+
+/**
+ @brief  Stores maximum number of messages which is requested with single history request (default
+         value is \c 100).
+ */
+@property (nonatomic, assign) NSUInteger pageSize;
+
+/**
+ @brief  Stores number of history pages which has been received.
+ */
+@property (nonatomic, readonly, assign) NSUInteger fetchedPagesCount;
+
+/**
+ @brief  Stores number of messages which has been parsed.
+ */
+@property (nonatomic, readonly, assign) NSUInteger decodedMessagesCount;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure history replay.
+
+ @param transport Reference on transport which should be used to fetch history.
+ @param channel   Reference on name of channel into which attendees send responses.
+
+ @return Configured and ready to use history replay.
+ */
++ (instancetype)replayWithTransport:(id<SPNPTransport>)transport channel:(NSString *)channel;
+
+
+///------------------------------------------------
+/// @name Replay
+///------------------------------------------------
+
+/**
+ @brief  Count votes which has been sent for poll.
+
+ @param poll             Reference on poll for which votes should be counted.
+ @param allowsVoteChange Whether attendee allowed to change his vote or not.
+ @param progressBlock    Reference on block which is called each time when new pages has been
+                         counted. Block pass two arguments: \c votesCount - list of votes count
+                         for each response variant for pages counted so far; \c progress - part of
+                         time range which has been processed (from \c 0.0 to \c 1.0).
+ @param completionBlock  Reference on block which should be called at the end of replay. Block pass
+                         three arguments: \c votesCount - list of votes count for each response
+                         variant; \c voters - index of attendees which voted; \c errorMessage -
+                         history request error description (counts are incomplete in this case).
+ */
+- (void)replayVotesForPoll:(SPNPPoll *)poll allowingVoteChange:(BOOL)allowsVoteChange
+             progressBlock:(void(^)(NSArray *votesCount, float progress))progressBlock
+           completionBlock:(void(^)(NSArray *votesCount, SPNPVoterIndex *voters,
+                                    NSString *errorMessage))completionBlock;
+
+#pragma mark -
+
+
+@end
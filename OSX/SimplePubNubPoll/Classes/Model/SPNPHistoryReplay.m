@@ -0,0 +1,545 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPHistoryReplay.h"
+#import "SPNPPollResponse.h"
+#import "SPNPCompactCoder.h"
+#import "SPNPVoterIndex.h"
+#import "SPNPPoll.h"
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores default replay configuration.
+ */
+static NSUInteger const kSPNPDefaultConcurrentRequests = 4;
+static NSUInteger const kSPNPDefaultPageSize = 100;
+
+/**
+ @brief  Stores how many times failed history request can be repeated before replay will fail.
+ */
+static NSUInteger const kSPNPMaximumRequestRetries = 3;
+
+
+#pragma mark - Types
+
+/**
+ @brief  Describes part of time range which is paged independently.
+ */
+typedef struct {
+
+    /**
+     @brief  Index of channel which is paged by segment.
+     */
+    NSUInteger channelIdx;
+
+    /**
+     @brief  Time token from which segment starts (exclusive, \c 0 - from oldest message).
+     */
+    unsigned long long origin;
+
+    /**
+     @brief  Time token of last received message (next page requested from it).
+     */
+    unsigned long long cursor;
+
+    /**
+     @brief  Time token at which segment ends (inclusive, \c 0 - till latest message).
+     */
+    unsigned long long end;
+    NSUInteger retries;
+    BOOL completed;
+
+    /**
+     @brief  Whether all segment pages has been folded into counters.
+     */
+    BOOL folded;
+} SPNPHistoryReplaySegment;
+
+/**
+ @brief  Describes vote which has been parsed from history page.
+ */
+typedef struct {
+
+    uint64_t voter;
+    uint32_t choice;
+} SPNPHistoryReplayVote;
+
+
+#pragma mark - Private interface declaration
+
+@interface SPNPHistoryReplay ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, assign) NSUInteger fetchedPagesCount;
+@property (nonatomic, assign) NSUInteger decodedMessagesCount;
+
+/**
+ @brief  Stores reference on transport which is used to fetch history.
+ */
+@property (nonatomic, strong) id<SPNPTransport> transport;
+
+/**
+ @brief  Stores number of time range segments into which each channel history split.
+ */
+@property (nonatomic, assign) NSUInteger channelSegmentsCount;
+
+/**
+ @brief  Stores reference on serial queue which is used to manage replay state and fold pages.
+ */
+@property (nonatomic, strong) dispatch_queue_t queue;
+
+/**
+ @brief  Stores reference on poll for which votes counted and de-duplication mode.
+ */
+@property (nonatomic, strong) SPNPPoll *poll;
+@property (nonatomic, assign) BOOL allowsVoteChange;
+
+/**
+ @brief  Stores reference on time range segments (\b SPNPHistoryReplaySegment values).
+ */
+@property (nonatomic, strong) NSMutableData *segments;
+@property (nonatomic, assign) NSUInteger segmentsCount;
+
+/**
+ @brief  Stores reference on parsed pages (one list for each segment) which wait for folding.
+ */
+@property (nonatomic, strong) NSArray *pendingPages;
+
+/**
+ @brief  Stores number of segments which has been completely folded into counters.
+ */
+@property (nonatomic, assign) NSUInteger foldedSegmentsCount;
+
+/**
+ @brief  Stores time range boundaries (used to compute progress).
+ */
+@property (nonatomic, assign) unsigned long long rangeStart;
+@property (nonatomic, assign) unsigned long long rangeEnd;
+
+/**
+ @brief  Stores reference on votes counters (\c int64_t for each response variant) and index of
+         attendees which voted.
+ */
+@property (nonatomic, strong) NSMutableData *counters;
+@property (nonatomic, strong) SPNPVoterIndex *voters;
+
+/**
+ @brief  Stores reference on blocks which has been passed to replay.
+ */
+@property (nonatomic, copy) void(^progressBlock)(NSArray *votesCount, float progress);
+@property (nonatomic, copy) void(^completionBlock)(NSArray *votesCount, SPNPVoterIndex *voters,
+                                                   NSString *errorMessage);
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize history replay.
+
+ @param transport Reference on transport which should be used to fetch history.
+ @param channel   Reference on name of channel into which attendees send responses.
+
+ @return Initialized and ready to use history replay.
+ */
+- (instancetype)initWithTransport:(id<SPNPTransport>)transport channel:(NSString *)channel;
+
+
+#pragma mark - Replay
+
+/**
+ @brief  Split responses history from poll start till specified time token on segments and start
+         fetching them.
+
+ @param poll             Reference on poll for which votes should be recounted.
+ @param rangeEnd         Network time token at which replay has been requested or \c 0 if it is
+                         unknown.
+ @param allowsVoteChange Whether last vote of each voter should be counted instead of first one.
+ @param progressBlock    Reference on block which is called after each folded page.
+ @param completionBlock  Reference on block which is called at the end of replay.
+ */
+- (void)replayVotesForPoll:(SPNPPoll *)poll before:(unsigned long long)rangeEnd
+        allowingVoteChange:(BOOL)allowsVoteChange
+             progressBlock:(void(^)(NSArray *votesCount, float progress))progressBlock
+           completionBlock:(void(^)(NSArray *votesCount, SPNPVoterIndex *voters,
+                                    NSString *errorMessage))completionBlock;
+
+
+#pragma mark - Pages
+
+/**
+ @brief      Request next page for time range segment.
+ @discussion Method called on replay queue. Only one request for each segment is in flight, so
+             pages of single segment received in time order.
+
+ @param segmentIdx Index of segment for which page should be requested.
+ */
+- (void)requestPageForSegment:(NSUInteger)segmentIdx;
+
+/**
+ @brief  Handle parsed history page.
+
+ @param votes         Reference on parsed votes (\b SPNPHistoryReplayVote values).
+ @param messagesCount Number of messages which has been received with page.
+ @param lastTimetoken Reference on time token of last message in page.
+ @param segmentIdx    Index of segment for which page has been requested.
+ @param errorMessage  History request error description.
+ */
+- (void)handlePageVotes:(NSData *)votes messagesCount:(NSUInteger)messagesCount
+          lastTimetoken:(NSNumber *)lastTimetoken forSegment:(NSUInteger)segmentIdx
+              withError:(NSString *)errorMessage;
+
+/**
+ @brief  Parse votes for poll from history page.
+
+ @param messages Reference on list of messages from responses channel history.
+ @param poll     Reference on poll for which votes should be parsed.
+
+ @return List of \b SPNPHistoryReplayVote values.
+ */
++ (NSData *)votesFromMessages:(NSArray *)messages forPoll:(SPNPPoll *)poll;
+
+
+#pragma mark - Counting
+
+/**
+ @brief      Fold pages into counters in time order.
+ @discussion Pages of segment folded only after all preceding segments of the same channel has been
+             folded.
+ */
+- (void)foldPendingPages;
+
+/**
+ @brief  Count votes from single page.
+
+ @param votes Reference on parsed votes (\b SPNPHistoryReplayVote values).
+ */
+- (void)foldVotes:(NSData *)votes;
+
+/**
+ @brief  Compute part of time range which has been processed.
+
+ @return Progress value from \c 0.0 to \c 1.0.
+ */
+- (float)progress;
+
+/**
+ @brief  Complete replay and pass results to completion block.
+
+ @param errorMessage History request error description.
+ */
+- (void)finishWithError:(NSString *)errorMessage;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Retrieve snapshot of votes count.
+
+ @return List of votes count for each response variant.
+ */
+- (NSArray *)votesCount;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPHistoryReplay
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)replayWithTransport:(id<SPNPTransport>)transport channel:(NSString *)channel {
+
+    return [[self alloc] initWithTransport:transport channel:channel];
+}
+
+- (instancetype)initWithTransport:(id<SPNPTransport>)transport channel:(NSString *)channel {
+
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+
+        _transport = transport;
+        _channels = @[[channel copy]];
+        _queue = dispatch_queue_create("com.pubnub.poll.replay", DISPATCH_QUEUE_SERIAL);
+        _maximumConcurrentRequests = kSPNPDefaultConcurrentRequests;
+        _pageSize = kSPNPDefaultPageSize;
+    }
+
+    return self;
+}
+
+
+#pragma mark - Replay
+
+- (void)replayVotesForPoll:(SPNPPoll *)poll allowingVoteChange:(BOOL)allowsVoteChange
+             progressBlock:(void(^)(NSArray *votesCount, float progress))progressBlock
+           completionBlock:(void(^)(NSArray *votesCount, SPNPVoterIndex *voters,
+                                    NSString *errorMessage))completionBlock {
+
+    // Range end taken from network, because host clock may be skewed from time tokens assigned to
+    // responses. Without it whole history will be scanned as single segment.
+    __weak __typeof(self) weakSelf = self;
+    [self.transport timeWithCompletion:^(NSNumber *timetoken, NSString *timeErrorMessage) {
+
+        [weakSelf replayVotesForPoll:poll before:timetoken.unsignedLongLongValue
+                  allowingVoteChange:allowsVoteChange progressBlock:progressBlock
+                     completionBlock:completionBlock];
+    }];
+}
+
+- (void)replayVotesForPoll:(SPNPPoll *)poll before:(unsigned long long)rangeEnd
+        allowingVoteChange:(BOOL)allowsVoteChange
+             progressBlock:(void(^)(NSArray *votesCount, float progress))progressBlock
+           completionBlock:(void(^)(NSArray *votesCount, SPNPVoterIndex *voters,
+                                    NSString *errorMessage))completionBlock {
+
+    NSUInteger maximumConcurrentRequests = MAX(self.maximumConcurrentRequests, 1);
+    NSArray *channels = [self.channels copy];
+    dispatch_async(self.queue, ^{
+
+        self.poll = poll;
+        self.allowsVoteChange = allowsVoteChange;
+        self.progressBlock = progressBlock;
+        self.completionBlock = completionBlock;
+        self.counters = [NSMutableData dataWithLength:(poll.responses.count * sizeof(int64_t))];
+        self.voters = [SPNPVoterIndex indexWithMaximumCount:kSPNPVoterIndexMaximumVotersCount];
+        self.foldedSegmentsCount = 0;
+
+        // Time range can be split only if it is known when poll has been started.
+        self.rangeStart = poll.startTimetoken.unsignedLongLongValue;
+        self.rangeEnd = rangeEnd;
+        BOOL isRangeKnown = (self.rangeStart > 0 && self.rangeStart < self.rangeEnd);
+        self.channelSegmentsCount = (isRangeKnown ? MAX(maximumConcurrentRequests / channels.count, 1) : 1);
+        self.segmentsCount = (channels.count * self.channelSegmentsCount);
+        unsigned long long step = (isRangeKnown ? (self.rangeEnd - self.rangeStart) / self.channelSegmentsCount : 0);
+        self.segments = [NSMutableData dataWithLength:(self.segmentsCount * sizeof(SPNPHistoryReplaySegment))];
+        SPNPHistoryReplaySegment *segments = (SPNPHistoryReplaySegment *)self.segments.mutableBytes;
+        NSMutableArray *pendingPages = [NSMutableArray arrayWithCapacity:self.segmentsCount];
+        for (NSUInteger segmentIdx = 0; segmentIdx < self.segmentsCount; segmentIdx++) {
+
+            NSUInteger channelSegmentIdx = (segmentIdx % self.channelSegmentsCount);
+            BOOL isLastSegment = (channelSegmentIdx + 1 == self.channelSegmentsCount);
+            segments[segmentIdx].channelIdx = (segmentIdx / self.channelSegmentsCount);
+            segments[segmentIdx].origin = (self.rangeStart + channelSegmentIdx * step);
+            segments[segmentIdx].cursor = segments[segmentIdx].origin;
+            segments[segmentIdx].end = (isLastSegment ? 0 : segments[segmentIdx].origin + step);
+            [pendingPages addObject:[NSMutableArray new]];
+        }
+        self.pendingPages = pendingPages;
+        for (NSUInteger segmentIdx = 0; segmentIdx < self.segmentsCount; segmentIdx++) {
+
+            [self requestPageForSegment:segmentIdx];
+        }
+    });
+}
+
+
+#pragma mark - Pages
+
+- (void)requestPageForSegment:(NSUInteger)segmentIdx {
+
+    SPNPHistoryReplaySegment *segment = &((SPNPHistoryReplaySegment *)self.segments.mutableBytes)[segmentIdx];
+    NSNumber *start = (segment->cursor ? @(segment->cursor) : nil);
+    NSNumber *end = (segment->end ? @(segment->end) : nil);
+    NSString *channel = self.channels[segment->channelIdx];
+    SPNPPoll *poll = self.poll;
+    __weak __typeof(self) weakSelf = self;
+    dispatch_async(dispatch_get_main_queue(), ^{
+
+        [weakSelf.transport historyForChannel:channel start:start end:end
+                                        limit:weakSelf.pageSize
+                               withCompletion:^(NSArray *messages, NSNumber *lastTimetoken,
+                                                NSString *errorMessage) {
+
+            // Pages parsed concurrently and only folding is serialized.
+            dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+
+                NSData *votes = (!errorMessage ? [SPNPHistoryReplay votesFromMessages:messages
+                                                                              forPoll:poll] : nil);
+                __strong __typeof(self) strongSelf = weakSelf;
+                dispatch_async(strongSelf.queue, ^{
+
+                    [strongSelf handlePageVotes:votes messagesCount:messages.count
+                                  lastTimetoken:lastTimetoken forSegment:segmentIdx
+                                      withError:errorMessage];
+                });
+            });
+        }];
+    });
+}
+
+- (void)handlePageVotes:(NSData *)votes messagesCount:(NSUInteger)messagesCount
+          lastTimetoken:(NSNumber *)lastTimetoken forSegment:(NSUInteger)segmentIdx
+              withError:(NSString *)errorMessage {
+
+    SPNPHistoryReplaySegment *segment = &((SPNPHistoryReplaySegment *)self.segments.mutableBytes)[segmentIdx];
+    if (self.completionBlock && errorMessage) {
+
+        if (segment->retries < kSPNPMaximumRequestRetries) {
+
+            segment->retries++;
+            [self requestPageForSegment:segmentIdx];
+        }
+        else { [self finishWithError:errorMessage]; }
+    }
+    else if (self.completionBlock) {
+
+        segment->retries = 0;
+        self.fetchedPagesCount++;
+        self.decodedMessagesCount += messagesCount;
+        [self.pendingPages[segmentIdx] addObject:votes];
+        unsigned long long timetoken = lastTimetoken.unsignedLongLongValue;
+        if (lastTimetoken) { segment->cursor = timetoken; }
+        segment->completed = (messagesCount < self.pageSize || !lastTimetoken ||
+                              (segment->end && timetoken >= segment->end));
+        if (!segment->completed) { [self requestPageForSegment:segmentIdx]; }
+        [self foldPendingPages];
+    }
+}
+
++ (NSData *)votesFromMessages:(NSArray *)messages forPoll:(SPNPPoll *)poll {
+
+    NSUInteger count = poll.responses.count;
+    NSMutableData *votes = [NSMutableData dataWithCapacity:(messages.count * sizeof(SPNPHistoryReplayVote))];
+    SPNPCompactCoder *decoder = [SPNPCompactCoder reusableDecoderForPoll:poll.identifier
+                                                                   token:poll.token];
+    for (id message in messages) {
+
+        NSUInteger order = 0;
+        uint64_t voterKey = 0;
+        if ([SPNPPollResponse readVoteFromMessage:message forPoll:poll.identifier usingDecoder:decoder
+                                            order:&order voterKey:&voterKey] && order < count) {
+
+            SPNPHistoryReplayVote vote = { .voter = voterKey, .choice = (uint32_t)order };
+            [votes appendBytes:&vote length:sizeof(SPNPHistoryReplayVote)];
+        }
+    }
+
+    return votes;
+}
+
+
+#pragma mark - Counting
+
+- (void)foldPendingPages {
+
+    BOOL hasFoldedPages = NO;
+    SPNPHistoryReplaySegment *segments = (SPNPHistoryReplaySegment *)self.segments.mutableBytes;
+    for (NSUInteger segmentIdx = 0; segmentIdx < self.segmentsCount; segmentIdx++) {
+
+        // Segment can be folded only after preceding segment of the same channel.
+        BOOL isFirstChannelSegment = (segmentIdx % self.channelSegmentsCount == 0);
+        if (segments[segmentIdx].folded ||
+            (!isFirstChannelSegment && !segments[segmentIdx - 1].folded)) { continue; }
+
+        NSMutableArray *pages = self.pendingPages[segmentIdx];
+        for (NSData *votes in pages) { [self foldVotes:votes]; }
+        hasFoldedPages = (hasFoldedPages || pages.count > 0);
+        [pages removeAllObjects];
+        if (segments[segmentIdx].completed) {
+
+            segments[segmentIdx].folded = YES;
+            self.foldedSegmentsCount++;
+        }
+    }
+
+    if (self.foldedSegmentsCount == self.segmentsCount) { [self finishWithError:nil]; }
+    else if (hasFoldedPages && self.progressBlock) {
+
+        NSArray *votesCount = [self votesCount];
+        float progress = [self progress];
+        void(^progressBlock)(NSArray *, float) = self.progressBlock;
+        dispatch_async(dispatch_get_main_queue(), ^{
+
+            progressBlock(votesCount, progress);
+        });
+    }
+}
+
+- (void)foldVotes:(NSData *)votes {
+
+    int64_t *counters = (int64_t *)self.counters.mutableBytes;
+    const SPNPHistoryReplayVote *values = (const SPNPHistoryReplayVote *)votes.bytes;
+    NSUInteger count = (votes.length / sizeof(SPNPHistoryReplayVote));
+    for (NSUInteger voteIdx = 0; voteIdx < count; voteIdx++) {
+
+        // History doesn't provide publisher identifier, so payload voter is the only one which can
+        // be used. Votes without voter can't be de-duplicated and dropped.
+        NSUInteger order = values[voteIdx].choice;
+        if (!values[voteIdx].voter) { continue; }
+        NSUInteger previousOrder = [self.voters registerChoice:order forKey:values[voteIdx].voter
+                                             replacingExisting:self.allowsVoteChange];
+
+        // Same rules as for real-time votes: first vote wins unless change allowed and votes which
+        // can't be tracked counted as first votes.
+        if (previousOrder == kSPNPVoterIndexFull) { previousOrder = NSNotFound; }
+        if (previousOrder == NSNotFound || (self.allowsVoteChange && previousOrder != order)) {
+
+            if (previousOrder != NSNotFound) { counters[previousOrder]--; }
+            counters[order]++;
+        }
+    }
+}
+
+- (float)progress {
+
+    double processed = 0.0f;
+    const SPNPHistoryReplaySegment *segments = (const SPNPHistoryReplaySegment *)self.segments.bytes;
+    for (NSUInteger segmentIdx = 0; segmentIdx < self.segmentsCount; segmentIdx++) {
+
+        const SPNPHistoryReplaySegment *segment = &segments[segmentIdx];
+        unsigned long long end = (segment->end ?: self.rangeEnd);
+        unsigned long long cursor = (segment->completed ? end : MIN(segment->cursor, end));
+        if (self.rangeStart > 0) { processed += (cursor - segment->origin); }
+        else if (segment->completed) { processed += 1.0f; }
+    }
+    NSUInteger channelsCount = (self.segmentsCount / self.channelSegmentsCount);
+    double length = (self.rangeStart > 0 ? (double)(self.rangeEnd - self.rangeStart) * channelsCount
+                                         : self.segmentsCount);
+
+    return (float)MIN(processed / MAX(length, 1.0f), 1.0f);
+}
+
+- (void)finishWithError:(NSString *)errorMessage {
+
+    void(^completionBlock)(NSArray *, SPNPVoterIndex *, NSString *) = self.completionBlock;
+    NSArray *votesCount = [self votesCount];
+    SPNPVoterIndex *voters = self.voters;
+    self.completionBlock = nil;
+    self.progressBlock = nil;
+    self.voters = nil;
+    dispatch_async(dispatch_get_main_queue(), ^{
+
+        completionBlock(votesCount, voters, errorMessage);
+    });
+}
+
+
+#pragma mark - Misc
+
+- (NSArray *)votesCount {
+
+    const int64_t *counters = (const int64_t *)self.counters.bytes;
+    NSUInteger count = (self.counters.length / sizeof(int64_t));
+    NSMutableArray *votesCount = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger counterIdx = 0; counterIdx < count; counterIdx++) {
+
+        [votesCount addObject:@(MAX(counters[counterIdx], 0))];
+    }
+
+    return [votesCount copy];
+}
+
+#pragma mark -
+
+
+@end
@@ -4,6 +4,7 @@
  */
 #import "SPNPPollDataVerificator.h"
 #import <Cocoa/Cocoa.h>
+#import "SPNPPoll.h"
 
 
 #pragma mark Private interface declaration
@@ -79,7 +80,12 @@
                 variantsCount++;
             }
         }
-        isValid = (variantsList.count >= 2 && variantsCount >= 2 && variantsCount <= 5);
+        isValid = (variantsList.count >= 2 && variantsCount >= 2 &&
+                   variantsCount <= [SPNPPoll maximumResponsesCount]);
+        
+        // Response titles length limit number of variants which fit into announcement message.
+        isValid = (isValid && [[SPNPPoll pollWithQuestion:question responses:variantsList]
+                               fitsIntoAnnouncement]);
     }
     
     return isValid;
@@ -3,7 +3,9 @@
 
 #pragma mark Class forward
 
-@class SPNPPollResponse, SPNPPoll;
+@class SPNPPollRankedStatistic, SPNPPollRatingStatistic, SPNPPollTextStatistic, SPNPPollResponse;
+@class SPNPStatisticSnapshot, SPNPVoteTimeSeries, SPNPMetrics, SPNPPoll;
+@protocol SPNPTransport;
 
 
 /**
@@ -30,6 +32,34 @@
  */
 @property (nonatomic, readonly, strong) NSMutableArray *statistics;
 
+/**
+ @brief      Stores reference on recent votes trend of active poll.
+ @discussion List of per-response lists (in responses order) with votes changes for each of last 
+             seconds. Attendee receive trend with statistic keyframes and host update it when 
+             keyframe published (only if \c publishesStatisticTrend is enabled).
+ */
+@property (nonatomic, readonly, strong) NSArray *statisticTrend;
+
+/**
+ @brief      Stores reference on most frequent answers of active open-text poll.
+ @discussion Host publish only top answers with their counts and error bounds, so \c statistics 
+             stay empty for open-text poll.
+ */
+@property (nonatomic, readonly, strong) SPNPPollTextStatistic *textStatistic;
+
+/**
+ @brief      Stores reference on instant-runoff rounds of active ranked-choice poll.
+ @discussion Votes count in \c statistics doesn't change for ranked-choice poll.
+ */
+@property (nonatomic, readonly, strong) SPNPPollRankedStatistic *rankedStatistic;
+
+/**
+ @brief      Stores reference on ratings aggregates of active rating poll.
+ @discussion Partial aggregates from several host nodes merged into single statistic. Variance and
+             quantiles can be retrieved from statistic's accumulator.
+ */
+@property (nonatomic, readonly, strong) SPNPPollRatingStatistic *ratingStatistic;
+
 /**
  @brief  Stores how many active attendees on current host session.
  */
@@ -41,8 +71,32 @@
 @property (nonatomic, readonly, copy) NSString *attendeesCountString;
 
 /**
- @brief  Stores whether \b PubNub client has active connection or there was unexpected 
-         disconnection.
+ @brief      Stores estimated number of unique attendees which joined since active poll has been
+             announced.
+ @discussion Estimation error is about 1.6% and doesn't depend from room size.
+ */
+@property (nonatomic, readonly, strong) NSNumber *uniqueAttendeesCount;
+
+/**
+ @brief      Stores minimum interval between attendees count updates (default value is \c 1 
+             second).
+ @discussion Presence events aggregated in between, so user interface updated not more often than
+             once per interval regardless of room size.
+ */
+@property (nonatomic, assign) NSTimeInterval attendeesCountUpdateInterval;
+
+/**
+ @brief      Stores reference on manager's instrumentation.
+ @discussion Metrics track received messages, counted votes, statistic publish results, messages
+             decoding, votes aggregation, statistic publish round-trip, history restore and 
+             statistic observers notification time. Metrics always enabled and can be snapshot or 
+             periodically dumped at any moment.
+ */
+@property (nonatomic, readonly, strong) SPNPMetrics *metrics;
+
+/**
+ @brief  Stores whether transport (\b PubNub client by default) has active connection or there was
+         unexpected disconnection.
  */
 @property (nonatomic, readonly, assign, getter = isConnected) BOOL connected;
 
@@ -56,6 +110,84 @@
  */
 @property (nonatomic, readonly, assign, getter = isInitiallyConnected) BOOL initiallyConnected;
 
+/**
+ @brief      Stores whether host should publish aggregated statistic using compact encoding.
+ @discussion Attendees negotiate compact encoding for their responses using list of encodings 
+             announced with poll. Compact encoding used only for statistic changes channel, so
+             attendees without compact and changes support still receive full \c JSON statistic
+             through statistic channel. Disabled by default (\c JSON dictionaries used).
+ */
+@property (nonatomic, assign) BOOL publishesCompactStatistic;
+
+/**
+ @brief      Stores whether host should publish recent votes trend with statistic keyframes.
+ @discussion Trend allow attendees to render votes velocity charts. Disabled by default.
+ */
+@property (nonatomic, assign) BOOL publishesStatisticTrend;
+
+/**
+ @brief      Stores fraction of attendee votes which should be traced end-to-end (from \c 0 to 
+             \c 1).
+ @discussion Traced vote carry send time, host stamp receive, aggregation and publish time and
+             return them with statistic update which include vote. Attendee use them to record
+             \c SPNPVoteVisibleLatency and its components with \c metrics (\c p50 and \c p99 
+             available from metrics snapshot). Default value is \c 0 (tracing disabled).
+ */
+@property (nonatomic, assign) double voteTraceSampleRate;
+
+/**
+ @brief      Stores whether attendees allowed to change their votes or not.
+ @discussion Host count only one vote from each attendee. If change allowed, latest attendee's vote
+             will be counted ("latest vote wins"), otherwise all votes after first one ignored 
+             ("first vote wins"). Disabled by default.
+ */
+@property (nonatomic, assign) BOOL allowsVoteChange;
+
+/**
+ @brief      Stores maximum number of attendee responses which host process at once.
+ @discussion Responses collected into batches which is parsed and counted in single pass. Value 
+             \c 1 disable batching. Default value is \c 128.
+ */
+@property (nonatomic, assign) NSUInteger votesBatchSize;
+
+/**
+ @brief  Stores maximum time which attendee response can wait in batch for processing (default 
+         value is \c 0.005 seconds).
+ */
+@property (nonatomic, assign) NSTimeInterval votesBatchLatency;
+
+/**
+ @brief      Stores number of channels into which attendees should send responses for polls 
+             announced by host.
+ @discussion Each attendee choose shard channel using his \c UUID and host aggregate votes from
+             each shard independently, so responses processing isn't limited by single channel 
+             throughput. Value carried in poll announcement and changes affect only polls which will
+             be announced later. Default value is \c 1 (single responses channel).
+ */
+@property (nonatomic, assign) NSUInteger answerShardsCount;
+
+/**
+ @brief      Stores reference on unique identifier of host node.
+ @discussion Several host nodes can aggregate responses for same poll, so each of them process only
+             subset of attendees (see \c nodeAnswerShards). Node publish statistic with votes 
+             counters of all known nodes and merge statistic published by other nodes, so any node
+             and attendees converge to same overall votes count. \c nil by default (single host).
+ */
+@property (nonatomic, copy) NSString *nodeIdentifier;
+
+/**
+ @brief      Stores reference on indices of responses shard channels which is processed by host 
+             node.
+ @discussion Nodes should process non-overlapping shards, otherwise same votes will be counted by
+             few nodes. \c nil by default (all shards processed).
+ */
+@property (nonatomic, copy) NSIndexSet *nodeAnswerShards;
+
+/**
+ @brief  Stores whether host recount votes from responses channel history at this moment.
+ */
+@property (nonatomic, readonly, assign, getter = isRecoveringVotes) BOOL recoveringVotes;
+
 /**
  @brief  Retrieve active poll question.
  
@@ -70,6 +202,45 @@
  */
 - (NSArray *)pollResponseVariants;
 
+/**
+ @brief      Retrieve list of polls which accept responses at this moment.
+ @discussion Active poll always go first and followed by additional polls (in announcement order).
+ 
+ @return List of \b SPNPPoll instances.
+ */
+- (NSArray *)activePolls;
+
+/**
+ @brief      Retrieve aggregated statistic for one of active polls.
+ @discussion Attendee has statistic only for poll which is shown at this moment.
+ 
+ @param poll Reference on poll for which statistic should be retrieved.
+ 
+ @return List of \b SPNPPollResponseStatistic instances or \c nil if poll doesn't accept responses.
+ */
+- (NSArray *)statisticsForPoll:(SPNPPoll *)poll;
+
+/**
+ @brief      Take immutable view on active poll statistic.
+ @discussion \c statistics updated in place on main thread, so they shouldn't be read from other 
+             queues. Snapshot should be taken on main thread, but it never change and can be 
+             used from any queue. Snapshot shared between calls while statistic doesn't change.
+ 
+ @return Reference on latest statistic snapshot.
+ */
+- (SPNPStatisticSnapshot *)statisticSnapshot;
+
+/**
+ @brief      Retrieve votes time series for one of active polls.
+ @discussion Series allow to compute windowed votes rate and its moving average for each response.
+             Only host track votes time series.
+ 
+ @param poll Reference on poll for which time series should be retrieved.
+ 
+ @return Votes time series or \c nil if poll doesn't accept responses.
+ */
+- (SPNPVoteTimeSeries *)voteTimeSeriesForPoll:(SPNPPoll *)poll;
+
 
 ///------------------------------------------------
 /// @name Initialization and Configuration
@@ -86,6 +257,21 @@
  */
 + (instancetype)pollManagerHost:(BOOL)isHost withHostIdentifier:(NSString *)identifier;
 
+/**
+ @brief      Create and configure poll manager which use specified transport.
+ @discussion Allow to run host and attendees logic on top of in-process loopback transport (for 
+             example for load tests).
+ 
+ @param isHost     Whether manager created for host or attendees.
+ @param identifier Reference on unique host identifier which should be used by attendees to join to
+                   polls announced by host.
+ @param transport  Reference on transport which should be used for real-time communication.
+ 
+ @return Configured and ready to use poll manager instance.
+ */
++ (instancetype)pollManagerHost:(BOOL)isHost withHostIdentifier:(NSString *)identifier
+                      transport:(id<SPNPTransport>)transport;
+
 /**
  @brief  Use provided device push token to register it with set of required channels.
  
@@ -130,6 +316,77 @@
  */
 - (void)announcePollCompletionWithBlock:(void(^)(NSString *errorMessage))block;
 
+/**
+ @brief      Announce new polling on which attendees respond with free text.
+ @discussion Host count only most frequent answers with bounded memory, so statistic for such poll
+             can't be restored after host restart.
+ 
+ @param question Reference on question which should be suggested for attendees to response.
+ @param block    Reference on block which will be called at the end of announcement process. Block
+                 pass two arguments: \c announced - whether new poll successfully announced or not;
+                 \c errorMessage - information about error because of which announcement failed.
+ */
+- (void)announceOpenTextPoll:(NSString *)question
+             completionBlock:(void(^)(BOOL announced, NSString *errorMessage))block;
+
+/**
+ @brief      Announce new polling on which attendees rank response variants.
+ @discussion Ballots counted with instant-runoff and standings of each round published with 
+             statistic. Statistic for such poll can't be restored after host restart.
+ 
+ @param question Reference on question which should be suggested for attendees to response.
+ @param variants List of responses which attendees should rank.
+ @param block    Reference on block which will be called at the end of announcement process. Block
+                 pass two arguments: \c announced - whether new poll successfully announced or not;
+                 \c errorMessage - information about error because of which announcement failed.
+ */
+- (void)announceRankedPoll:(NSString *)question withResponse:(NSArray *)variants
+           completionBlock:(void(^)(BOOL announced, NSString *errorMessage))block;
+
+/**
+ @brief      Announce new polling on which attendees respond with numeric rating.
+ @discussion Host aggregate ratings with constant memory (count, mean, variance and histogram).
+             Statistic for such poll can't be restored after host restart.
+ 
+ @param question      Reference on question which should be suggested for attendees to response.
+ @param minimumRating Lowest value on rating scale.
+ @param maximumRating Highest value on rating scale.
+ @param block         Reference on block which will be called at the end of announcement process. 
+                      Block pass two arguments: \c announced - whether new poll successfully 
+                      announced or not; \c errorMessage - information about error because of which
+                      announcement failed.
+ */
+- (void)announceRatingPoll:(NSString *)question minimumRating:(NSInteger)minimumRating
+             maximumRating:(NSInteger)maximumRating
+           completionBlock:(void(^)(BOOL announced, NSString *errorMessage))block;
+
+/**
+ @brief      Announce poll which will accept responses along with active poll.
+ @discussion Responses for all active polls share answers channels and routed to own poll's votes
+             aggregation engine by poll identifier. Statistic for additional poll published into
+             separate channel (statistic channel name with poll token suffix) which is announced
+             with poll. Additional polls doesn't use votes log and can't be restored after host
+             restart.
+ 
+ @param question Reference on question which should be suggested for attendees to response.
+ @param variants List of responses from which used should choose.
+ @param block    Reference on block which will be called at the end of announcement process. Block
+                 pass two arguments: \c poll - reference on announced poll; \c errorMessage - 
+                 information about error because of which announcement failed.
+ */
+- (void)announceAdditionalPoll:(NSString *)question withResponse:(NSArray *)variants
+               completionBlock:(void(^)(SPNPPoll *poll, NSString *errorMessage))block;
+
+/**
+ @brief      Inform attendees about completion of one of active polls.
+ @discussion Responses for completed poll ignored by host right after announcement.
+ 
+ @param poll  Reference on poll which should be completed.
+ @param block Reference on block which should be called at the end of announcement. Block pass only
+              one argument - announcement error message in case of failure.
+ */
+- (void)announceCompletionOfPoll:(SPNPPoll *)poll withBlock:(void(^)(NSString *errorMessage))block;
+
 /**
  @brief  Submit attendees response to the polling host.
  
@@ -140,6 +397,54 @@
 - (void)submitResponse:(SPNPPollResponse *)response
    withCompletionBlock:(void(^)(NSString *errorMessage))block;
 
+/**
+ @brief      Submit attendees free-text response on active open-text poll to the polling host.
+ @discussion Text normalized before it will be sent and empty responses doesn't sent at all.
+ 
+ @param text  Reference on text which has been entered by user.
+ @param block Reference on block which should be called at the end of submittion process. Block
+              pass only one argument - submittion error description.
+ */
+- (void)submitTextResponse:(NSString *)text
+       withCompletionBlock:(void(^)(NSString *errorMessage))block;
+
+/**
+ @brief  Submit attendees ranked ballot on active ranked-choice poll to the polling host.
+ 
+ @param ranking List of response order numbers (from most preferred).
+ @param block   Reference on block which should be called at the end of submittion process. Block
+                pass only one argument - submittion error description.
+ */
+- (void)submitRankedResponse:(NSArray *)ranking
+         withCompletionBlock:(void(^)(NSString *errorMessage))block;
+
+/**
+ @brief  Submit attendees rating on active rating poll to the polling host.
+ 
+ @param rating Integer value from poll's rating scale.
+ @param block  Reference on block which should be called at the end of submittion process. Block
+               pass only one argument - submittion error description.
+ */
+- (void)submitRating:(NSInteger)rating withCompletionBlock:(void(^)(NSString *errorMessage))block;
+
+/**
+ @brief      Recount active poll votes using responses channel history.
+ @discussion Used by host when statistic can't be restored from local votes log and published
+             statistic. History paged from poll start with several requests in flight and pages
+             decoded concurrently. Statistic updated with partially counted votes as pages arrive
+             and replaced with exact votes count at the end of recovery.
+             Responses received during recovery counted as well and merged with recounted votes
+             (de-duplicated by voter).
+ 
+ @param progressBlock   Reference on block which is called each time when new pages has been 
+                        counted. Block pass only one argument - part of poll history which has been
+                        processed (from \c 0.0 to \c 1.0).
+ @param completionBlock Reference on block which should be called at the end of recovery. Block pass
+                        only one argument - history request error description.
+ */
+- (void)recoverVotesFromHistoryWithProgressBlock:(void(^)(float progress))progressBlock
+                                 completionBlock:(void(^)(NSString *errorMessage))completionBlock;
+
 #pragma mark -
 
 
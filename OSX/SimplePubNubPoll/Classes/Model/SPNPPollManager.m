@@ -3,45 +3,87 @@
  @copyright © 2009-2015 PubNub, Inc.
  */
 #import "SPNPPollManager.h"
+#import "SPNPPresenceAggregator.h"
+#import "SPNPStatisticPublishScheduler.h"
+#import "SPNPStatisticSequencer.h"
+#import "SPNPStatisticSnapshot.h"
+#import "SPNPStatisticStore.h"
+#import "SPNPPubNubTransport.h"
 #import "SPNPPollResponseStatistic.h"
+#import "SPNPPollStatisticDelta.h"
+#import "SPNPPollRankedStatistic.h"
+#import "SPNPPollRatingStatistic.h"
+#import "SPNPPollRankedResponse.h"
+#import "SPNPPollRatingResponse.h"
+#import "SPNPRatingAccumulator.h"
+#import "SPNPPollTextStatistic.h"
+#import "SPNPPollTextResponse.h"
+#import "SPNPVoteTraceSampler.h"
+#import "SPNPVoteAggregator.h"
+#import "SPNPVoteTimeSeries.h"
+#import "SPNPHistoryReplay.h"
 #import "SPNPPollStatistic.h"
 #import "SPNPPollResponse.h"
-#import <PubNub/PubNub.h>
+#import "SPNPPollRegistry.h"
+#import "SPNPPollSession.h"
+#import "SPNPRankedTally.h"
+#import "SPNPRatingTally.h"
+#import "SPNPTextTally.h"
+#import "SPNPCompactCoder.h"
+#import "SPNPVoterIndex.h"
+#import "SPNPMetrics.h"
+#import "SPNPVoteTrace.h"
+#import "SPNPVoteLog.h"
 #import "SPNPPoll.h"
 
 
 #pragma mark Static
 
 /**
- @brief  Stores reference on key which is required by \b PubNub client to give ability to retrieve
-         real-time updates.
+ @brief      Stores how often host should publish full statistic instead of changes.
+ @discussion Every N-th statistic update published as keyframe which allow attendees which missed
+             some changes to re-synchronize. Only keyframes published into legacy statistic channel.
+             Same value used as number of messages which is fetched from history to restore 
+             statistic.
  */
-static NSString * const kSPNPPubNubSubscribeKey = @"demo-36";
+static NSUInteger const kSPNPStatisticKeyframeInterval = 20;
 
 /**
- @brief  Stores reference on key which is required by \b PubNub client to give ability to push data
-         to data channels.
+ @brief  Stores maximum number of sampled votes traces which is sent with single statistic update
+         or tracked by attendee.
  */
-static NSString * const kSPNPPubNubPublishKey = @"demo-36";
+static NSUInteger const kSPNPMaximumVoteTraces = 32;
 
 /**
- @brief  Stores value which is used by statistic update timer if new data available.
+ @brief  Stores error message which is reported when poll announcement exceeds message size limit.
  */
-static NSTimeInterval const kSPNPStatisticRefreshInterval = 0.5f;
+static NSString * const kSPNPPollAnnouncementSizeErrorMessage = @"Poll response variants doesn't "
+                                                                 "fit into announcement message.";
 
 
 #pragma mark - Private interface declaration
 
-@interface SPNPPollManager () <PNObjectEventListener>
+@interface SPNPPollManager () <SPNPTransportDelegate>
 
 
 #pragma mark - Properties
 
 /**
- @brief  Stores reference on \b PubNub client which is used for real-time communication with 
-         attendees to send them updates and accept data.
+ @brief  Stores reference on transport (\b PubNub client by default) which is used for real-time 
+         communication with attendees to send them updates and accept data.
  */
-@property (nonatomic) PubNub *client;
+@property (nonatomic, strong) id<SPNPTransport> transport;
+@property (nonatomic, strong) NSArray *statisticTrend;
+@property (nonatomic, strong) SPNPPollTextStatistic *textStatistic;
+@property (nonatomic, strong) SPNPPollRankedStatistic *rankedStatistic;
+@property (nonatomic, strong) SPNPPollRatingStatistic *ratingStatistic;
+
+/**
+ @brief      Stores reference on latest rating poll statistic received from each host node.
+ @discussion Statistic from single host stored with empty node identifier.
+ */
+@property (nonatomic, strong) NSMutableDictionary *nodeRatingStatistics;
+@property (nonatomic, strong) SPNPMetrics *metrics;
 
 /**
  @brief  Stores reference on unique host identifier which is used to build data channel names for
@@ -54,22 +96,94 @@ static NSTimeInterval const kSPNPStatisticRefreshInterval = 0.5f;
  */
 @property (nonatomic, assign, getter = isHost) BOOL host;
 
+/**
+ @brief  Stores reference on engine which is used by host to count attendee votes off the thread on
+         which messages delivered.
+ */
+@property (nonatomic, strong) SPNPVoteAggregator *voteAggregator;
+
+/**
+ @brief  Stores reference on replay which is used by host to recount votes from responses channel
+         history.
+ */
+@property (nonatomic, strong) SPNPHistoryReplay *historyReplay;
+@property (nonatomic, assign, getter = isRecoveringVotes) BOOL recoveringVotes;
+
+/**
+ @brief  Stores reference on names of data channels which is used by poll manager (names built once
+         because they used to route every received message).
+ */
+@property (nonatomic, copy) NSString *pollChannelName;
+@property (nonatomic, copy) NSString *pollStatisticsChannelName;
+@property (nonatomic, copy) NSString *pollStatisticDeltasChannelName;
+@property (nonatomic, copy) NSString *answersChannelName;
+
+/**
+ @brief      Stores reference on names of responses shard channels which is used by active polls.
+ @discussion Map shard channel name to shard index, so host route every received response with 
+             single lookup.
+ */
+@property (nonatomic, copy) NSDictionary *answerShardChannels;
+
+/**
+ @brief      Stores reference on registry of polls which accept responses.
+ @discussion Responses routed to poll's session by poll identifier (or short token).
+ */
+@property (nonatomic, strong) SPNPPollRegistry *pollRegistry;
+
+/**
+ @brief      Stores reference on session of active poll.
+ @discussion Session use manager's statistic, votes aggregation engine (backed by votes log) and
+             publish scheduler. Statistic published into common statistic channel.
+ */
+@property (nonatomic, strong) SPNPPollSession *primarySession;
+
 @property (nonatomic, strong) SPNPPoll *activePoll;
 @property (nonatomic, assign) BOOL restoredSession;
 @property (nonatomic, strong) NSNumber *attendeesCount;
 @property (nonatomic, copy) NSString *attendeesCountString;
+@property (nonatomic, strong) NSNumber *uniqueAttendeesCount;
+
+/**
+ @brief  Stores reference on aggregator which throttle presence events for user interface.
+ */
+@property (nonatomic, strong) SPNPPresenceAggregator *presenceAggregator;
 @property (nonatomic, assign, getter = isConnected) BOOL connected;
 @property (nonatomic, assign, getter = isInitiallyConnected) BOOL initiallyConnected;
 
 /**
- @brief  Stores reference on timer which is used to publish poll statistic for attendees.
+ @brief      Stores reference on scheduler which is used by host to refresh local statistic and 
+             publish it for attendees.
+ @discussion Scheduler adapt refresh interval to votes rate and doesn't allow more than one publish
+             request at once.
+ */
+@property (nonatomic, strong) SPNPStatisticPublishScheduler *publishScheduler;
+
+/**
+ @brief      Stores reference on tracker of applied statistic updates sequence.
+ @discussion Attendee use it to decide which of received updates can be applied. Host track 
+             published updates sequence with poll session.
+ */
+@property (nonatomic, strong) SPNPStatisticSequencer *statisticSequencer;
+
+/**
+ @brief  Stores reference on sampler which decide which attendee's votes should be traced and track
+         them till statistic update with trace is received.
+ */
+@property (nonatomic, strong) SPNPVoteTraceSampler *voteTraceSampler;
+
+/**
+ @brief      Stores reference on last taken snapshot of attendee's statistic.
+ @discussion Host take snapshots of primary poll session statistic.
  */
-@property (nonatomic) NSTimer *statisticUpdateTimer;
+@property (nonatomic, strong) SPNPStatisticSnapshot *lastStatisticSnapshot;
 
 /**
- @brief  Stores whether manager store some polling statistic which wasn't published yet.
+ @brief      Stores reference on serial queue on which statistic updates serialized before publish.
+ @discussion Updates built from statistic snapshots, so serialization doesn't block main thread 
+             and doesn't race with votes counting.
  */
-@property (nonatomic, assign) BOOL hasUnupblishedStatistic;
+@property (nonatomic, strong) dispatch_queue_t serializationQueue;
 
 /**
  @Brief  Stores reference on block which will be called by manager every time when commectivity 
@@ -86,15 +200,35 @@ static NSTimeInterval const kSPNPStatisticRefreshInterval = 0.5f;
  @param isHost     Whether manager created for host or attendees.
  @param identifier Reference on unique host identifier which should be used by attendees to join to
  polls announced by host.
+ @param transport  Reference on transport which should be used for real-time communication.
  
  @return Initialized and ready to use poll manager instance.
  */
-- (instancetype)initHost:(BOOL)isHost withHostIdentifier:(NSString *)identifier;
+- (instancetype)initHost:(BOOL)isHost withHostIdentifier:(NSString *)identifier
+               transport:(id<SPNPTransport>)transport;
+
+
+#pragma mark - Operation manipulaion
+
+/**
+ @brief  Publish poll announcement and start accepting responses for it.
+ 
+ @param poll  Reference on poll which should become active poll.
+ @param block Reference on block which will be called at the end of announcement process.
+ */
+- (void)announceActivePoll:(SPNPPoll *)poll
+           completionBlock:(void(^)(BOOL announced, NSString *errorMessage))block;
 
 /**
- @brief  Complete \b PunNub client configuraion.
+ @brief      Stamp poll with real-time network time token before it will be announced.
+ @discussion Host clock can't be used for this purpose, because it may be skewed from time tokens
+             which is assigned to responses. If time token can't be retrieved, poll passed as-is
+             and votes recount will scan whole responses history.
+ 
+ @param poll  Reference on poll which is about to be announced.
+ @param block Reference on block which will be called with poll which should be announced.
  */
-- (void)initializePubNubClient;
+- (void)stampStartOfPoll:(SPNPPoll *)poll withBlock:(void(^)(SPNPPoll *startedPoll))block;
 
 
 #pragma mark - Restore
@@ -119,6 +253,17 @@ static NSTimeInterval const kSPNPStatisticRefreshInterval = 0.5f;
  */
 - (void)searchForPreviousPollSessionWith:(void(^)(SPNPPoll *poll, NSString *errorMessage))block;
 
+/**
+ @brief      Reconcile host state which has been restored from local votes log with poll which has 
+             been found in history.
+ @discussion Votes count from log preferred (they are exact), history used to continue statistic 
+             updates sequence. If history report another active poll, log ignored.
+ 
+ @param loggedPoll Reference on poll which has been restored from log.
+ @param poll       Reference on active poll which has been found in history (if any).
+ */
+- (void)reconcileLoggedPoll:(SPNPPoll *)loggedPoll withPoll:(SPNPPoll *)poll;
+
 /**
  @brief  Try to restore latest statistic for passed poll instance.
  
@@ -129,6 +274,16 @@ static NSTimeInterval const kSPNPStatisticRefreshInterval = 0.5f;
 - (void)restoreStatisticInformationFor:(SPNPPoll *)poll
                              withBlock:(void(^)(NSString *errorMessage))block;
 
+/**
+ @brief      Start votes aggregation for active poll with restored statistic.
+ @discussion If there is no keyframe for active poll in statistic channel history (statistic is 
+             missing or stale), votes recounted from responses channel history.
+ 
+ @param block Reference on block which should be called when votes aggregation started. Block pass
+              only one argument - error message in case if votes recount failed.
+ */
+- (void)resetVoteAggregationWithRestoredStatistic:(void(^)(NSString *errorMessage))block;
+
 
 #pragma mark - Statistic
 
@@ -140,31 +295,196 @@ static NSTimeInterval const kSPNPStatisticRefreshInterval = 0.5f;
 - (void)updateStatisticFromHost:(NSArray *)statistics;
 
 /**
- @brief  Use passed response instance to increase counter for passed response option.
+ @brief      Merge votes counters of host nodes into local cache.
+ @discussion Host node keep own votes count, attendees merge all counters as-is. In case if local
+             cache doesn't match to received statistic it will be replaced.
+ 
+ @param statistics Reference on list of statistic instances objects.
+ */
+- (void)mergeStatisticFromHost:(NSArray *)statistics;
+
+/**
+ @brief  Handle statistic update received from host.
+ 
+ @param message Reference on received message (keyframe or changes).
+ */
+- (void)handleStatisticMessage:(id)message;
+
+/**
+ @brief      Use full statistic published by host to replace local cache.
+ @discussion Keyframes older than last applied update ignored, so statistic doesn't regress when 
+             messages delivered out of order.
+ 
+ @param statistic Reference on full statistic keyframe.
+ */
+- (void)applyStatistic:(SPNPPollStatistic *)statistic;
+
+/**
+ @brief      Use votes count changes published by host to update local cache in place.
+ @discussion Changes applied only if they directly follow last applied update. In case if gap 
+             detected, manager ignore changes till next keyframe.
+ 
+ @param delta Reference on votes count changes.
+ */
+- (void)applyStatisticDelta:(SPNPPollStatisticDelta *)delta;
+
+/**
+ @brief  Apply most frequent answers of open-text poll received from host.
+ 
+ @param statistic Reference on open-text poll statistic.
+ */
+- (void)applyTextStatistic:(SPNPPollTextStatistic *)statistic;
+
+/**
+ @brief  Apply instant-runoff rounds of ranked-choice poll received from host.
+ 
+ @param statistic Reference on ranked-choice poll statistic.
+ */
+- (void)applyRankedStatistic:(SPNPPollRankedStatistic *)statistic;
+
+/**
+ @brief      Apply ratings aggregates of rating poll received from host.
+ @discussion Aggregates from different host nodes merged, so sequence checked for each node 
+             separately.
+ 
+ @param statistic Reference on rating poll statistic.
+ */
+- (void)applyRatingStatistic:(SPNPPollRatingStatistic *)statistic;
+
+/**
+ @brief      Record latency of attendee's sampled votes which has been included into applied 
+             statistic update.
+ @discussion Visible latency measured by attendee's clock only and its components computed as 
+             differences of host's stamps, so clocks doesn't need to be synchronized.
+ 
+ @param traces List of \b SPNPVoteTrace instances which has been sent with statistic update.
+ */
+- (void)recordLatencyOfVoteTraces:(NSArray *)traces;
+
+/**
+ @brief      Notify observers that statistic change has been completed.
+ @discussion Observers notified synchronously, so their handling time is part of manager's hot path
+             and recorded with \c metrics.
+ */
+- (void)didChangeStatistics;
+
+/**
+ @brief      Use votes count aggregated by host to update poll statistic.
+ @discussion Statistic instances updated in place with single KVO notification.
+ 
+ @param session Reference on session of the poll which statistic should be updated.
+ 
+ @return \c YES in case if there was new votes since last update.
+ */
+- (BOOL)updateStatisticFromAggregatedVotesForSession:(SPNPPollSession *)session;
+
+/**
+ @brief      Retrieve number of votes which has been counted by this host for each response.
+ @discussion Host node count only own part of overall votes count.
+ 
+ @param statistics Reference on list of response statistic instances.
+ 
+ @return List of votes count (sorted by response order).
+ */
+- (NSArray *)aggregatedVotesCountFrom:(NSArray *)statistics;
+
+/**
+ @brief  Update poll statistic instances with votes count.
  
- @param response Reference on response instance for which used gave his voice.
+ @param session    Reference on session of the poll which statistic should be updated.
+ @param votesCount List of votes count for each response variant (sorted by response order).
  */
-- (void)updateStatisticInformationForResponse:(SPNPPollResponse *)response;
+- (void)updateStatisticForSession:(SPNPPollSession *)session withVotesCount:(NSArray *)votesCount;
 
 /**
- @brief  Launch timer which is responsible for statistic updated.
+ @brief  Update only changed poll statistic instances with votes count from session's store.
+ 
+ @param session        Reference on session of the poll which statistic should be updated.
+ @param changedIndexes Indexes of responses which votes count has been changed in store.
+ */
+- (void)updateStatisticForSession:(SPNPPollSession *)session
+                        atIndexes:(NSIndexSet *)changedIndexes;
+
+/**
+ @brief      Retrieve store of votes count aggregated for session.
+ @discussion Store created from current session statistic if it doesn't exist or doesn't match it.
+ 
+ @param session Reference on session for which store should be retrieved.
+ 
+ @return Reference on store which match vote aggregator counters.
+ */
+- (SPNPStatisticStore *)statisticStoreForSession:(SPNPPollSession *)session;
+
+/**
+ @brief  Start votes aggregation for active poll using current statistic as initial state.
+ */
+- (void)resetVoteAggregation;
+
+/**
+ @brief  Launch scheduler which is responsible for statistic updated.
  */
 - (void)startStatisticPublising;
 
 /**
- @brief  Stop timer which is responsible for statistic publish triggering.
+ @brief  Stop scheduler which is responsible for statistic publish triggering.
  */
 - (void)stopStatisticPublishing;
 
 /**
  @brief  Publish aggrgated statistic to the stats channel used by attendees to get results in
          real-time.
+ 
+ @param session Reference on session of the poll which statistic should be published.
+ @param block   Reference on block which should be called at the end of publish process. Block 
+                pass only one argument - whether statistic has been published or not.
+ */
+- (void)publishStatisticForSession:(SPNPPollSession *)session
+                    withCompletion:(void(^)(BOOL published))block;
+
+/**
+ @brief      Publish statistic of open-text, ranked-choice or rating poll.
+ @discussion Such statistic is small and always published as keyframe.
+ 
+ @param session Reference on session of the poll which statistic should be published.
+ @param block   Reference on block which will be called at the end of publish process.
+ */
+- (void)publishTallyStatisticForSession:(SPNPPollSession *)session
+                         withCompletion:(void(^)(BOOL published))block;
+
+/**
+ @brief  Create scheduler which will refresh and publish statistic of additional poll.
+ 
+ @param session Reference on session of the poll which statistic should be published.
+ 
+ @return Configured and ready to use publish scheduler.
+ */
+- (SPNPStatisticPublishScheduler *)publishSchedulerForSession:(SPNPPollSession *)session;
+
+/**
+ @brief  Reset statistic updates stream state for new poll.
  */
-- (void)publishStatistic;
+- (void)resetStatisticSequence;
 
 
 #pragma mark - Misc
 
+/**
+ @brief  Check whether active poll host support compact messages encoding or not.
+ 
+ @return \c YES in case if host announced compact encoding support.
+ */
+- (BOOL)supportsCompactEncoding;
+
+/**
+ @brief  Restore model instance from received message.
+ 
+ @param objectClass Reference on class of model which is expected in message.
+ @param message     Reference on received message (dictionary or compact representation).
+ 
+ @return Restored model instance or \c nil in case if message can't be parsed.
+ */
+- (id)objectOfClass:(Class)objectClass fromMessage:(id)message;
+
 /**
  @brief  Fill up statistic instance with initial statistic information for just started test.
  
@@ -173,18 +493,53 @@ static NSTimeInterval const kSPNPStatisticRefreshInterval = 0.5f;
 - (void)setInitialStatisticStateWith:(NSArray *)statistics;
 
 /**
- @brief  Retrieve reference on list of channel names on which \b PubNub client should subscribe.
+ @brief  Create statistic instances for poll which doesn't have votes yet.
  
- @return List of channel names.
+ @param poll Reference on poll for which statistic should be created.
+ 
+ @return List of response statistic instances (sorted by response order).
  */
-- (NSArray *)channelsForSubscription;
+- (NSMutableArray *)initialStatisticForPoll:(SPNPPoll *)poll;
+
+/**
+ @brief  Configure votes aggregation engine for additional poll using primary engine settings.
+ 
+ @param voteAggregator Reference on engine which should be configured.
+ */
+- (void)configureVoteAggregator:(SPNPVoteAggregator *)voteAggregator;
+
+/**
+ @brief      Retrieve name of channel into which attendees should send responses for shard.
+ @discussion First shard use channel which is used by polls without shards.
+ 
+ @param shardIndex Index of responses shard.
+ 
+ @return Responses shard channel name.
+ */
+- (NSString *)answersChannelNameForShard:(NSUInteger)shardIndex;
+
+/**
+ @brief      Retrieve name of channel from which attendee receive statistic changes of the poll.
+ @discussion Statistic of additional polls published to channels which announced with poll.
+ 
+ @param poll Reference on poll which is followed by attendee.
+ 
+ @return Statistic changes channel name.
+ */
+- (NSString *)statisticDeltasChannelNameForPoll:(SPNPPoll *)poll;
+
+/**
+ @brief      Rebuild map of responses shard channels.
+ @discussion Map should cover shards of all polls which accept responses.
+ */
+- (void)updateAnswerShardChannels;
 
 /**
- @brief  Channel name construction helpers.
+ @brief  Retrieve reference on list of channel names on which transport should subscribe.
+ 
+ @return List of channel names.
  */
-- (NSString *)pollChannelName;
-- (NSString *)pollStatisticsChannelName;
-- (NSString *)answersChannelName;
+- (NSArray *)channelsForSubscription;
 
 #pragma mark -
 
@@ -202,42 +557,200 @@ static NSTimeInterval const kSPNPStatisticRefreshInterval = 0.5f;
 
 + (instancetype)pollManagerHost:(BOOL)isHost withHostIdentifier:(NSString *)identifier {
     
-    return [[self alloc] initHost:isHost withHostIdentifier:identifier];
+    id<SPNPTransport> transport = [SPNPPubNubTransport transportWithUUID:(isHost ? identifier : nil)];
+    
+    return [self pollManagerHost:isHost withHostIdentifier:identifier transport:transport];
+}
+
++ (instancetype)pollManagerHost:(BOOL)isHost withHostIdentifier:(NSString *)identifier
+                      transport:(id<SPNPTransport>)transport {
+    
+    return [[self alloc] initHost:isHost withHostIdentifier:identifier transport:transport];
 }
 
-- (instancetype)initHost:(BOOL)isHost withHostIdentifier:(NSString *)identifier {
+- (instancetype)initHost:(BOOL)isHost withHostIdentifier:(NSString *)identifier
+               transport:(id<SPNPTransport>)transport {
     
     // Check whether initialization was successful or not.
     if ((self = [super init])) {
         
         _host = isHost;
         _identifier = [identifier copy];
+        _pollChannelName = [_identifier stringByAppendingString:@"-poll"];
+        _pollStatisticsChannelName = [_identifier stringByAppendingString:@"-stat"];
+        _pollStatisticDeltasChannelName = [SPNPPollSession deltasChannelFor:_pollStatisticsChannelName];
+        _answersChannelName = [_identifier stringByAppendingString:@"-res"];
+        _answerShardChannels = @{_answersChannelName: @0};
+        _answerShardsCount = 1;
         _statistics = [NSMutableArray new];
-        [self initializePubNubClient];
+        _statisticSequencer =
+            [SPNPStatisticSequencer sequencerWithKeyframeInterval:kSPNPStatisticKeyframeInterval];
+        _voteTraceSampler =
+            [SPNPVoteTraceSampler samplerWithMaximumTracesCount:kSPNPMaximumVoteTraces];
+        _nodeRatingStatistics = [NSMutableDictionary new];
+        _metrics = [SPNPMetrics metrics];
+        _voteAggregator = (isHost ? [SPNPVoteAggregator new] : nil);
+        _voteAggregator.metrics = _metrics;
+        _pollRegistry = (isHost ? [SPNPPollRegistry new] : nil);
+        if (isHost) {
+            
+            _serializationQueue = dispatch_queue_create("com.pubnub.poll.serialization",
+                                                        DISPATCH_QUEUE_SERIAL);
+            NSString *logPath = [SPNPVoteLog defaultPathForHost:_identifier];
+            _voteAggregator.voteLog = [SPNPVoteLog logWithPath:logPath];
+            _historyReplay = [SPNPHistoryReplay replayWithTransport:transport
+                                                            channel:_answersChannelName];
+            
+            __weak __typeof(self) weakSelf = self;
+            _publishScheduler = [SPNPStatisticPublishScheduler schedulerWithChangesBlock:^BOOL{
+                
+                __strong __typeof(self) strongSelf = weakSelf;
+                return [strongSelf updateStatisticFromAggregatedVotesForSession:strongSelf.primarySession];
+            } publishBlock:^(void(^completion)(BOOL published)) {
+                
+                __strong __typeof(self) strongSelf = weakSelf;
+                [strongSelf publishStatisticForSession:strongSelf.primarySession
+                                        withCompletion:completion];
+            }];
+        }
+        _transport = transport;
+        _transport.delegate = self;
+        
+        __weak __typeof(self) weakSelf = self;
+        _presenceAggregator = [SPNPPresenceAggregator aggregatorWithUpdateBlock:^(NSUInteger occupancy,
+                                                                                 unsigned long long uniqueAttendeesCount) {
+            
+            __strong __typeof(self) strongSelf = weakSelf;
+            strongSelf.attendeesCount = @(MAX(occupancy, 1) - 1);
+            strongSelf.attendeesCountString = [NSString stringWithFormat:@"%@",
+                                               (strongSelf.attendeesCount.unsignedLongLongValue == 0) ?
+                                               @"--" : strongSelf.attendeesCount];
+            strongSelf.uniqueAttendeesCount = @(uniqueAttendeesCount);
+        }];
+        _presenceAggregator.ignoredIdentifier = (isHost ? transport.uuid : nil);
     }
     
     return self;
 }
 
-- (void)initializePubNubClient {
+- (void)setActivePoll:(SPNPPoll *)activePoll {
+    
+    // Unique attendees, votes trend and traces tracked for each poll separately.
+    if (activePoll && ![activePoll.identifier isEqualToString:_activePoll.identifier]) {
+        
+        [self.presenceAggregator resetUniqueAttendees];
+        [self.voteTraceSampler reset];
+        self.statisticTrend = nil;
+        self.textStatistic = nil;
+        self.rankedStatistic = nil;
+        self.ratingStatistic = nil;
+        [self.nodeRatingStatistics removeAllObjects];
+    }
+    _activePoll = activePoll;
+    if (self.isHost) {
+        
+        if (self.primarySession) { [self.pollRegistry unregisterSessionForPoll:self.primarySession.poll]; }
+        self.primarySession = nil;
+        if (activePoll) {
+            
+            self.primarySession = [SPNPPollSession sessionForPoll:activePoll withStatistics:_statistics
+                                                   voteAggregator:self.voteAggregator
+                                                statisticsChannel:self.pollStatisticsChannelName];
+            self.primarySession.publishScheduler = self.publishScheduler;
+            self.primarySession.rankedTally.allowsBallotChange = self.allowsVoteChange;
+            self.primarySession.ratingTally.allowsRatingChange = self.allowsVoteChange;
+            [self.pollRegistry registerSession:self.primarySession];
+        }
+    }
+    [self updateAnswerShardChannels];
+    
+    // Only primary poll is able to recover votes from responses history.
+    NSUInteger shardsCount = MAX(activePoll.answerShardsCount.unsignedIntegerValue, 1);
+    NSMutableArray *replayChannels = [NSMutableArray new];
+    for (NSUInteger shardIdx = 0; shardIdx < shardsCount; shardIdx++) {
+        
+        if (!self.nodeAnswerShards || [self.nodeAnswerShards containsIndex:shardIdx]) {
+            
+            [replayChannels addObject:[self answersChannelNameForShard:shardIdx]];
+        }
+    }
+    self.historyReplay.channels = replayChannels;
+}
+
+- (NSTimeInterval)attendeesCountUpdateInterval {
+    
+    return self.presenceAggregator.updateInterval;
+}
+
+- (void)setAttendeesCountUpdateInterval:(NSTimeInterval)attendeesCountUpdateInterval {
+    
+    self.presenceAggregator.updateInterval = attendeesCountUpdateInterval;
+}
+
+- (void)setNodeAnswerShards:(NSIndexSet *)nodeAnswerShards {
+    
+    _nodeAnswerShards = [nodeAnswerShards copy];
+    [self updateAnswerShardChannels];
+}
+
+- (void)setAllowsVoteChange:(BOOL)allowsVoteChange {
     
-    [PNLog enabled:YES];
-    PNConfiguration *configuration = [PNConfiguration configurationWithPublishKey:kSPNPPubNubPublishKey
-                                                                     subscribeKey:kSPNPPubNubSubscribeKey];
-    if (_host) { configuration.uuid = _identifier; }
-    _client = [PubNub clientWithConfiguration:configuration];
-    [_client addListener:self];
+    _allowsVoteChange = allowsVoteChange;
+    self.voteAggregator.allowsVoteChange = allowsVoteChange;
+    for (SPNPPollSession *session in self.pollRegistry.sessions) {
+        
+        session.voteAggregator.allowsVoteChange = allowsVoteChange;
+        session.rankedTally.allowsBallotChange = allowsVoteChange;
+        session.ratingTally.allowsRatingChange = allowsVoteChange;
+    }
+}
+
+- (NSUInteger)votesBatchSize {
+    
+    return self.voteAggregator.maximumBatchSize;
+}
+
+- (void)setVotesBatchSize:(NSUInteger)votesBatchSize {
+    
+    self.voteAggregator.maximumBatchSize = votesBatchSize;
+    for (SPNPPollSession *session in self.pollRegistry.sessions) {
+        
+        session.voteAggregator.maximumBatchSize = votesBatchSize;
+    }
+}
+
+- (NSTimeInterval)votesBatchLatency {
+    
+    return self.voteAggregator.batchLatency;
+}
+
+- (void)setVotesBatchLatency:(NSTimeInterval)votesBatchLatency {
+    
+    self.voteAggregator.batchLatency = votesBatchLatency;
+    for (SPNPPollSession *session in self.pollRegistry.sessions) {
+        
+        session.voteAggregator.batchLatency = votesBatchLatency;
+    }
 }
 
 - (void)registerDevicePushToken:(NSData *)token {
     
-    [self.client addPushNotificationsOnChannels:@[[self pollChannelName]] withDevicePushToken:token
-                                  andCompletion:nil];
+    [self.transport addPushNotificationsOnChannels:@[[self pollChannelName]] withDevicePushToken:token];
 }
 
 
 #pragma mark - Information
 
+- (double)voteTraceSampleRate {
+    
+    return self.voteTraceSampler.sampleRate;
+}
+
+- (void)setVoteTraceSampleRate:(double)voteTraceSampleRate {
+    
+    self.voteTraceSampler.sampleRate = voteTraceSampleRate;
+}
+
 - (NSString *)pollQuestion {
     
     return (self.activePoll.question?: @"");
@@ -248,6 +761,44 @@ static NSTimeInterval const kSPNPStatisticRefreshInterval = 0.5f;
     return ([self.activePoll.responses valueForKey:@"response"]?: @[]);
 }
 
+- (NSArray *)activePolls {
+    
+    NSMutableArray *polls = [NSMutableArray new];
+    if (self.activePoll) { [polls addObject:self.activePoll]; }
+    for (SPNPPollSession *session in self.pollRegistry.sessions) {
+        
+        if (session != self.primarySession) { [polls addObject:session.poll]; }
+    }
+    
+    return [polls copy];
+}
+
+- (NSArray *)statisticsForPoll:(SPNPPoll *)poll {
+    
+    NSArray *statistics = [self.pollRegistry sessionForPollIdentifier:poll.identifier].statistics;
+    if (!self.isHost && [poll.identifier isEqualToString:self.activePoll.identifier]) {
+        
+        statistics = self.statistics;
+    }
+    
+    return [statistics copy];
+}
+
+- (SPNPStatisticSnapshot *)statisticSnapshot {
+    
+    if (self.primarySession) { return [self.primarySession statisticSnapshot]; }
+    SPNPStatisticSnapshot *snapshot = self.lastStatisticSnapshot;
+    self.lastStatisticSnapshot = [SPNPStatisticSnapshot snapshotOfStatistics:self.statistics
+                                                            previousSnapshot:snapshot];
+    
+    return self.lastStatisticSnapshot;
+}
+
+- (SPNPVoteTimeSeries *)voteTimeSeriesForPoll:(SPNPPoll *)poll {
+    
+    return [self.pollRegistry sessionForPollIdentifier:poll.identifier].timeSeries;
+}
+
 
 #pragma mark - Operation manipulaion
 
@@ -260,8 +811,7 @@ static NSTimeInterval const kSPNPStatisticRefreshInterval = 0.5f;
         __strong __typeof(self) strongSelf = weakSelf;
         if (!errorMessage) {
             
-            [strongSelf.client subscribeToChannels:[strongSelf channelsForSubscription]
-                                      withPresence:NO];
+            [strongSelf.transport subscribeToChannels:[strongSelf channelsForSubscription]];
         }
         else if (strongSelf.statusHandleBlock) { strongSelf.statusHandleBlock(NO, errorMessage); }
     }];
@@ -270,109 +820,545 @@ static NSTimeInterval const kSPNPStatisticRefreshInterval = 0.5f;
 - (void)announcePoll:(NSString *)question withResponse:(NSArray *)variants
      completionBlock:(void(^)(BOOL announced, NSString *errorMessage))block {
     
+    SPNPPoll *poll = nil;
     if (!self.activePoll) {
         
-        SPNPPoll *poll = [SPNPPoll pollWithQuestion:question responses:variants];
-        NSDictionary *aps = @{@"aps": @{@"alert": @"New poll announced!"}};
-        __weak __typeof(self) weakSelf = self;
-        [self.client publish:[poll dictionaryRepresentation] toChannel:[self pollChannelName]
-           mobilePushPayload:aps compressed:YES withCompletion:^(PNPublishStatus *status) {
-                  
-            __strong __typeof(self) strongSelf = weakSelf;
-            NSString *publishErrorMessage = nil;
-            if (status.isError) { publishErrorMessage = status.errorData.information; }
-            if (!status.isError) {
-                
-                strongSelf.activePoll = poll;
-                [strongSelf setInitialStatisticStateWith:nil];
-                [strongSelf startStatisticPublising];
-            }
-            block(!status.isError, publishErrorMessage);
-        }];
+        poll = [SPNPPoll pollWithQuestion:question responses:variants
+                             answerShards:self.answerShardsCount];
     }
-    else { block(YES, nil); }
+    [self announceActivePoll:poll completionBlock:block];
 }
 
-- (void)announcePollCompletionWithBlock:(void(^)(NSString *errorMessage))block {
+- (void)announceOpenTextPoll:(NSString *)question
+             completionBlock:(void(^)(BOOL announced, NSString *errorMessage))block {
     
-    [self publishStatistic];
-    __weak __typeof(self) weakSelf = self;
-    NSDictionary *aps = @{@"aps": @{@"alert": @"Poll has been completed!"}};
-    [self.client publish:[[self.activePoll completedPoll] dictionaryRepresentation]
-               toChannel:[self pollChannelName] mobilePushPayload:aps compressed:YES
-          withCompletion:^(PNPublishStatus *status) {
-              
-        __strong __typeof(self) strongSelf = weakSelf;
-        if (!status.isError) {
-            
-            strongSelf.activePoll = nil;
-            [strongSelf.statistics removeAllObjects];
-            [strongSelf stopStatisticPublishing];
-        }
-        block(status.isError ? status.errorData.information : nil);
-    }];
+    SPNPPoll *poll = nil;
+    if (!self.activePoll) {
+        
+        poll = [SPNPPoll openTextPollWithQuestion:question answerShards:self.answerShardsCount];
+    }
+    [self announceActivePoll:poll completionBlock:block];
 }
 
-- (void)submitResponse:(SPNPPollResponse *)response
-   withCompletionBlock:(void(^)(NSString *errorMessage))block {
+- (void)announceRankedPoll:(NSString *)question withResponse:(NSArray *)variants
+           completionBlock:(void(^)(BOOL announced, NSString *errorMessage))block {
     
-    [self.client publish:[response dictionaryRepresentation] toChannel:[self answersChannelName]
-              compressed:YES withCompletion:^(PNPublishStatus *status) {
-              
-        block(status.isError ? status.errorData.information : nil);
-    }];
-}
+    SPNPPoll *poll = nil;
+    if (!self.activePoll) {
+        
+        poll = [SPNPPoll rankedPollWithQuestion:question responses:variants
+                                   answerShards:self.answerShardsCount];
+    }
+    [self announceActivePoll:poll completionBlock:block];
+}
+
+- (void)announceRatingPoll:(NSString *)question minimumRating:(NSInteger)minimumRating
+             maximumRating:(NSInteger)maximumRating
+           completionBlock:(void(^)(BOOL announced, NSString *errorMessage))block {
+    
+    if (minimumRating >= maximumRating) {
+        
+        block(NO, @"Rating scale should contain at least two values.");
+        return;
+    }
+    
+    SPNPPoll *poll = nil;
+    if (!self.activePoll) {
+        
+        poll = [SPNPPoll ratingPollWithQuestion:question minimumRating:minimumRating
+                                  maximumRating:maximumRating answerShards:self.answerShardsCount];
+    }
+    [self announceActivePoll:poll completionBlock:block];
+}
+
+- (void)announceActivePoll:(SPNPPoll *)poll
+           completionBlock:(void(^)(BOOL announced, NSString *errorMessage))block {
+    
+    if (poll && ![poll fitsIntoAnnouncement]) {
+        
+        block(NO, kSPNPPollAnnouncementSizeErrorMessage);
+    }
+    else if (poll) {
+        
+        NSDictionary *aps = @{@"aps": @{@"alert": @"New poll announced!"}};
+        __weak __typeof(self) weakSelf = self;
+        [self stampStartOfPoll:poll withBlock:^(SPNPPoll *startedPoll) {
+            
+            [weakSelf.transport publish:[startedPoll dictionaryRepresentation]
+                              toChannel:[weakSelf pollChannelName] mobilePushPayload:aps
+                         withCompletion:^(NSString *publishErrorMessage) {
+                
+                __strong __typeof(self) strongSelf = weakSelf;
+                if (!publishErrorMessage) {
+                    
+                    strongSelf.activePoll = startedPoll;
+                    [strongSelf resetStatisticSequence];
+                    [strongSelf setInitialStatisticStateWith:nil];
+                    [strongSelf resetVoteAggregation];
+                    NSArray *channels = strongSelf.answerShardChannels.allKeys;
+                    [strongSelf.transport subscribeToChannels:channels];
+                    [strongSelf startStatisticPublising];
+                }
+                block(publishErrorMessage == nil, publishErrorMessage);
+            }];
+        }];
+    }
+    else { block(YES, nil); }
+}
+
+- (void)stampStartOfPoll:(SPNPPoll *)poll withBlock:(void(^)(SPNPPoll *startedPoll))block {
+    
+    [self.transport timeWithCompletion:^(NSNumber *timetoken, NSString *errorMessage) {
+        
+        block(timetoken ? [poll pollStartedAt:timetoken] : poll);
+    }];
+}
+
+- (void)announcePollCompletionWithBlock:(void(^)(NSString *errorMessage))block {
+    
+    [self.voteAggregator flushPendingVotes];
+    
+    // Final statistic published by scheduler, so it won't overlap with publish request which is in
+    // progress and completion announced after it.
+    SPNPPoll *completedPoll = [self.activePoll completedPoll];
+    __weak __typeof(self) weakSelf = self;
+    [self.publishScheduler flushWithCompletion:^(BOOL published) {
+        
+        NSDictionary *aps = @{@"aps": @{@"alert": @"Poll has been completed!"}};
+        [weakSelf.transport publish:[completedPoll dictionaryRepresentation]
+                          toChannel:[weakSelf pollChannelName] mobilePushPayload:aps
+                     withCompletion:^(NSString *errorMessage) {
+            
+            __strong __typeof(self) strongSelf = weakSelf;
+            if (!errorMessage) {
+                
+                strongSelf.activePoll = nil;
+                [strongSelf.statistics removeAllObjects];
+                [strongSelf resetVoteAggregation];
+                [strongSelf stopStatisticPublishing];
+            }
+            block(errorMessage);
+        }];
+    }];
+}
+
+- (void)announceAdditionalPoll:(NSString *)question withResponse:(NSArray *)variants
+               completionBlock:(void(^)(SPNPPoll *poll, NSString *errorMessage))block {
+    
+    if (!self.activePoll) {
+        
+        block(nil, @"Additional poll can be announced only along with active poll.");
+        return;
+    }
+    
+    // Short token should identify only one poll which accept responses.
+    SPNPPoll *poll = nil;
+    do {
+        
+        poll = [SPNPPoll pollWithQuestion:question responses:variants
+                             answerShards:self.answerShardsCount];
+    } while ([self.pollRegistry hasSessionWithToken:poll.token]);
+    
+    // Attendees subscribe to statistic channel which is announced with additional poll.
+    NSString *statisticsChannel = [self.pollStatisticsChannelName
+                                   stringByAppendingFormat:@"-%@", poll.token];
+    poll = [poll pollWithStatisticsChannel:statisticsChannel];
+    if (![poll fitsIntoAnnouncement]) {
+        
+        block(nil, kSPNPPollAnnouncementSizeErrorMessage);
+        return;
+    }
+    
+    __weak __typeof(self) weakSelf = self;
+    [self stampStartOfPoll:poll withBlock:^(SPNPPoll *startedPoll) {
+        
+        [weakSelf.transport publish:[startedPoll dictionaryRepresentation]
+                          toChannel:[weakSelf pollChannelName] mobilePushPayload:nil
+                     withCompletion:^(NSString *publishErrorMessage) {
+            
+            __strong __typeof(self) strongSelf = weakSelf;
+            if (!publishErrorMessage) {
+                
+                SPNPVoteAggregator *voteAggregator = [SPNPVoteAggregator new];
+                [strongSelf configureVoteAggregator:voteAggregator];
+                NSMutableArray *statistics = [strongSelf initialStatisticForPoll:startedPoll];
+                [voteAggregator resetForPoll:startedPoll
+                              withVotesCount:[statistics valueForKey:@"votesCount"]];
+                NSString *channel = strongSelf.pollStatisticsChannelName;
+                SPNPPollSession *session = [SPNPPollSession sessionForPoll:startedPoll
+                                                            withStatistics:statistics
+                                                            voteAggregator:voteAggregator
+                                                         statisticsChannel:channel];
+                session.publishScheduler = [strongSelf publishSchedulerForSession:session];
+                [strongSelf.pollRegistry registerSession:session];
+                [strongSelf updateAnswerShardChannels];
+                [strongSelf.transport subscribeToChannels:strongSelf.answerShardChannels.allKeys];
+                [session.publishScheduler start];
+            }
+            block((publishErrorMessage ? nil : startedPoll), publishErrorMessage);
+        }];
+    }];
+}
+
+- (void)announceCompletionOfPoll:(SPNPPoll *)poll withBlock:(void(^)(NSString *errorMessage))block {
+    
+    SPNPPollSession *session = [self.pollRegistry sessionForPollIdentifier:poll.identifier];
+    if (!session) {
+        
+        block(nil);
+        return;
+    }
+    else if (session == self.primarySession) {
+        
+        [self announcePollCompletionWithBlock:block];
+        return;
+    }
+    
+    [session.voteAggregator flushPendingVotes];
+    __weak __typeof(self) weakSelf = self;
+    [session.publishScheduler flushWithCompletion:^(BOOL published) {
+        
+        [weakSelf.transport publish:[[session.poll completedPoll] dictionaryRepresentation]
+                          toChannel:[weakSelf pollChannelName] mobilePushPayload:nil
+                     withCompletion:^(NSString *errorMessage) {
+            
+            __strong __typeof(self) strongSelf = weakSelf;
+            if (!errorMessage) {
+                
+                [session.publishScheduler stop];
+                [strongSelf.pollRegistry unregisterSessionForPoll:session.poll];
+                [strongSelf updateAnswerShardChannels];
+            }
+            block(errorMessage);
+        }];
+    }];
+}
+
+- (void)submitResponse:(SPNPPollResponse *)response
+   withCompletionBlock:(void(^)(NSString *errorMessage))block {
+    
+    // Host use only poll identifier, response order and voter, so there is no need to send title
+    // with compact representation.
+    BOOL isCompact = [self supportsCompactEncoding];
+    NSNumber *traceTime = [self.voteTraceSampler traceTimeForVote];
+    SPNPPollResponse *vote = [SPNPPollResponse pollResponseFor:response.pollIdentifier
+                                                     withValue:(isCompact ? nil : response.response)
+                                                   orderNumber:response.order
+                                                         voter:self.transport.uuid
+                                                     traceTime:traceTime];
+    id message = [vote dictionaryRepresentation];
+    if (isCompact) {
+        
+        message = [vote compactRepresentationForPoll:self.activePoll.identifier
+                                               token:self.activePoll.token];
+    }
+    uint64_t voterKey = [SPNPVoterIndex keyForVoter:self.transport.uuid];
+    NSUInteger shardIndex = [self.activePoll answerShardForVoterKey:voterKey];
+    [self.transport publish:message toChannel:[self answersChannelNameForShard:shardIndex]
+          mobilePushPayload:nil withCompletion:block];
+}
+
+- (void)submitTextResponse:(NSString *)text
+       withCompletionBlock:(void(^)(NSString *errorMessage))block {
+    
+    // Free-text responses sent only with dictionary representation.
+    SPNPPollTextResponse *response = nil;
+    if (self.activePoll.isOpenText) {
+        
+        response = [SPNPPollTextResponse textResponseFor:self.activePoll.identifier withText:text
+                                                   voter:self.transport.uuid];
+    }
+    if (response) {
+        
+        uint64_t voterKey = [SPNPVoterIndex keyForVoter:self.transport.uuid];
+        NSUInteger shardIndex = [self.activePoll answerShardForVoterKey:voterKey];
+        [self.transport publish:[response dictionaryRepresentation]
+                      toChannel:[self answersChannelNameForShard:shardIndex]
+              mobilePushPayload:nil withCompletion:block];
+    }
+    else { block(@"Response should contain at least one letter or digit."); }
+}
+
+- (void)submitRankedResponse:(NSArray *)ranking
+         withCompletionBlock:(void(^)(NSString *errorMessage))block {
+    
+    // Ranked ballots sent only with dictionary representation.
+    SPNPPollRankedResponse *response = nil;
+    if (self.activePoll.isRanked) {
+        
+        response = [SPNPPollRankedResponse rankedResponseFor:self.activePoll.identifier
+                                                 withRanking:ranking voter:self.transport.uuid];
+    }
+    if (response) {
+        
+        uint64_t voterKey = [SPNPVoterIndex keyForVoter:self.transport.uuid];
+        NSUInteger shardIndex = [self.activePoll answerShardForVoterKey:voterKey];
+        [self.transport publish:[response dictionaryRepresentation]
+                      toChannel:[self answersChannelNameForShard:shardIndex]
+              mobilePushPayload:nil withCompletion:block];
+    }
+    else { block(@"Ballot should rank at least one response."); }
+}
+
+- (void)submitRating:(NSInteger)rating withCompletionBlock:(void(^)(NSString *errorMessage))block {
+    
+    // Ratings sent only with dictionary representation.
+    SPNPPoll *poll = self.activePoll;
+    if (poll.isRating && rating >= poll.minimumRating.integerValue &&
+        rating <= poll.maximumRating.integerValue) {
+        
+        NSString *voter = self.transport.uuid;
+        SPNPPollRatingResponse *response = [SPNPPollRatingResponse ratingResponseFor:poll.identifier
+                                                                          withRating:rating
+                                                                               voter:voter];
+        uint64_t voterKey = [SPNPVoterIndex keyForVoter:self.transport.uuid];
+        NSUInteger shardIndex = [poll answerShardForVoterKey:voterKey];
+        [self.transport publish:[response dictionaryRepresentation]
+                      toChannel:[self answersChannelNameForShard:shardIndex]
+              mobilePushPayload:nil withCompletion:block];
+    }
+    else { block(@"Rating should be in poll's rating scale."); }
+}
 
 
 #pragma mark - Restore
 
 - (void)restoreHostStateWith:(void(^)(NSString *errorMessage))completionBlock {
     
+    // Host restore exact votes count from local log without waiting for history.
+    NSArray *votesCount = nil;
+    SPNPPoll *loggedPoll = [self.voteAggregator restoreFromVoteLogWithVotesCount:&votesCount];
+    if (loggedPoll) {
+        
+        self.activePoll = loggedPoll;
+        self.restoredSession = YES;
+        [self setInitialStatisticStateWith:nil];
+        [self updateStatisticForSession:self.primarySession withVotesCount:votesCount];
+        completionBlock(nil);
+    }
+    
     __weak __typeof(self) weakSelf = self;
     [self searchForPreviousPollSessionWith:^(SPNPPoll *poll, NSString *searchErrorMessage) {
         
         __strong __typeof(self) strongSelf = weakSelf;
-        strongSelf.activePoll = poll;
-        strongSelf.restoredSession = (poll != nil);
-        if (strongSelf.restoredSession) {
+        if (loggedPoll) { [strongSelf reconcileLoggedPoll:loggedPoll withPoll:poll]; }
+        else {
+            
+            strongSelf.activePoll = poll;
+            strongSelf.restoredSession = (poll != nil);
+        }
+        if (!loggedPoll && strongSelf.restoredSession) {
             
             [strongSelf restoreStatisticInformationFor:strongSelf.activePoll
                                              withBlock:^(NSString *errorMessage) {
                 
-                completionBlock(errorMessage);
-                [strongSelf startStatisticPublising];
+                [strongSelf resetVoteAggregationWithRestoredStatistic:^(NSString *recoveryErrorMessage) {
+                    
+                    completionBlock(errorMessage ?: recoveryErrorMessage);
+                    [strongSelf startStatisticPublising];
+                }];
             }];
         }
-        else { completionBlock(searchErrorMessage); }
+        else if (!loggedPoll) { completionBlock(searchErrorMessage); }
     }];
 }
 
-- (void)searchForPreviousPollSessionWith:(void(^)(SPNPPoll *poll, NSString *errorMessage))block {
+- (void)reconcileLoggedPoll:(SPNPPoll *)loggedPoll withPoll:(SPNPPoll *)poll {
     
-    [self.client historyForChannel:[self pollChannelName] start:nil end:nil limit:1
-                    withCompletion:^(PNHistoryResult *result, PNErrorStatus *status) {
+    __weak __typeof(self) weakSelf = self;
+    
+    // Different poll has been announced since log has been written (log is stale).
+    if (poll && ![poll.identifier isEqualToString:loggedPoll.identifier]) {
+        
+        self.activePoll = poll;
+        [self.statistics removeAllObjects];
+        [self restoreStatisticInformationFor:poll withBlock:^(NSString *errorMessage) {
+            
+            __strong __typeof(self) strongSelf = weakSelf;
+            [strongSelf resetVoteAggregationWithRestoredStatistic:^(NSString *recoveryErrorMessage) {
+                
+                [strongSelf startStatisticPublising];
+            }];
+        }];
+    }
+    // Log is exact, so history used only to continue statistic sequence.
+    else {
+        
+        NSArray *loggedStatistics = [self.statistics copy];
+        [self restoreStatisticInformationFor:loggedPoll withBlock:^(NSString *errorMessage) {
+            
+            // Host node should keep counters which has been published by other nodes.
+            __strong __typeof(self) strongSelf = weakSelf;
+            NSArray *publishedStatistics = [strongSelf.statistics copy];
+            [strongSelf updateStatisticFromHost:loggedStatistics];
+            if (strongSelf.nodeIdentifier) { [strongSelf mergeStatisticFromHost:publishedStatistics]; }
+            [strongSelf startStatisticPublising];
+        }];
+    }
+}
 
-        SPNPPoll *poll = [SPNPPoll objectFromDictionaryRepresentation:result.data.messages.lastObject];
-        block((poll.isActive ? poll : nil), (status.isError ? status.errorData.information : nil));
+- (void)searchForPreviousPollSessionWith:(void(^)(SPNPPoll *poll, NSString *errorMessage))block {
+    
+    __weak __typeof(self) weakSelf = self;
+    [self.transport historyForChannel:[self pollChannelName] limit:1
+                       withCompletion:^(NSArray *messages, NSString *errorMessage) {
+        
+        __strong __typeof(self) strongSelf = weakSelf;
+        SPNPPoll *poll = [strongSelf objectOfClass:SPNPPoll.class fromMessage:messages.lastObject];
+        block((poll.isActive ? poll : nil), errorMessage);
     }];
 }
 
 - (void)restoreStatisticInformationFor:(SPNPPoll *)poll
                              withBlock:(void(^)(NSString *errorMessage))block {
     
+    uint64_t startTime = [SPNPMetrics currentTime];
+    __weak __typeof(self) weakSelf = self;
+    [self.transport historyForChannel:[self pollStatisticDeltasChannelName]
+                                limit:kSPNPStatisticKeyframeInterval
+                       withCompletion:^(NSArray *messages, NSString *errorMessage) {
+        
+        __strong __typeof(self) strongSelf = weakSelf;
+        [strongSelf resetStatisticSequence];
+        
+        // Find latest keyframe for the poll.
+        __block NSUInteger keyframeIdx = NSNotFound;
+        __block SPNPPollStatistic *statistic = nil;
+        [messages enumerateObjectsWithOptions:NSEnumerationReverse
+                                   usingBlock:^(id message, NSUInteger messageIdx,
+                                                BOOL *messagesEnumeratorStop) {
+            
+            SPNPPollStatistic *keyframe = [strongSelf objectOfClass:SPNPPollStatistic.class
+                                                        fromMessage:message];
+            if ([keyframe.pollIdentifier isEqualToString:poll.identifier]) {
+                
+                statistic = keyframe;
+                keyframeIdx = messageIdx;
+                *messagesEnumeratorStop = YES;
+            }
+        }];
+        [strongSelf.statistics removeAllObjects];
+        [strongSelf setInitialStatisticStateWith:statistic.responses];
+        
+        // Each host node publish own keyframes, so all of them should be merged.
+        if (statistic.isMergeable) {
+            
+            for (NSUInteger messageIdx = 0; messageIdx < keyframeIdx; messageIdx++) {
+                
+                SPNPPollStatistic *keyframe = [strongSelf objectOfClass:SPNPPollStatistic.class
+                                                            fromMessage:messages[messageIdx]];
+                if (keyframe.isMergeable && [keyframe.pollIdentifier isEqualToString:poll.identifier]) {
+                    
+                    [strongSelf mergeStatisticFromHost:keyframe.responses];
+                }
+            }
+        }
+        
+        // Apply changes which has been published after keyframe.
+        unsigned long long lastSequence = statistic.sequence.unsignedLongLongValue;
+        if (statistic.sequence) {
+            
+            [strongSelf.statisticSequencer resetWithSequence:lastSequence synchronized:YES];
+            for (NSUInteger messageIdx = keyframeIdx + 1; messageIdx < messages.count; messageIdx++) {
+                
+                SPNPPollStatisticDelta *delta = [strongSelf objectOfClass:SPNPPollStatisticDelta.class
+                                                              fromMessage:messages[messageIdx]];
+                if ([delta.pollIdentifier isEqualToString:poll.identifier]) {
+                    
+                    [strongSelf applyStatisticDelta:delta];
+                    lastSequence = MAX(lastSequence, delta.sequence.unsignedLongLongValue);
+                }
+            }
+        }
+        
+        // Host should continue sequence after last published update (even if some of them has been
+        // lost) and start with keyframe.
+        if (strongSelf.isHost) {
+            
+            [strongSelf.statisticSequencer resetWithSequence:lastSequence synchronized:YES];
+            strongSelf.primarySession.statisticSequence = lastSequence;
+        }
+        [strongSelf.metrics recordLatency:SPNPHistoryRestoreLatency since:startTime];
+        block(errorMessage);
+    }];
+}
+
+- (void)resetVoteAggregationWithRestoredStatistic:(void(^)(NSString *errorMessage))block {
+    
+    if (!self.statisticSequencer.isSynchronized) {
+        
+        [self recoverVotesFromHistoryWithProgressBlock:nil completionBlock:block];
+    }
+    else {
+        
+        [self resetVoteAggregation];
+        block(nil);
+    }
+}
+
+- (void)recoverVotesFromHistoryWithProgressBlock:(void(^)(float progress))progressBlock
+                                 completionBlock:(void(^)(NSString *errorMessage))completionBlock {
+    
+    SPNPPoll *poll = self.activePoll;
+    if (!self.isHost || !poll || self.isRecoveringVotes) {
+        
+        if (completionBlock) {
+            
+            completionBlock(!poll ? @"There is no active poll." : nil);
+        }
+        return;
+    }
+    
+    // Host subscribe for responses before history replay and count them from scratch, so votes
+    // which arrive during replay won't be lost. They merged with recounted votes at the end.
+    self.recoveringVotes = YES;
+    NSArray *initialVotesCount = [[self initialStatisticForPoll:poll] valueForKey:@"votesCount"];
+    [self.voteAggregator resetForPoll:poll withVotesCount:initialVotesCount];
+    [self.transport subscribeToChannels:self.answerShardChannels.allKeys];
+    uint64_t startTime = [SPNPMetrics currentTime];
     __weak __typeof(self) weakSelf = self;
-    [self.client historyForChannel:[self pollStatisticsChannelName] start:nil end:nil limit:1
-                    withCompletion:^(PNHistoryResult *result, PNErrorStatus *status) {
+    [self.historyReplay replayVotesForPoll:poll allowingVoteChange:self.allowsVoteChange
+                             progressBlock:^(NSArray *votesCount, float progress) {
         
         __strong __typeof(self) strongSelf = weakSelf;
-        NSDictionary *object = result.data.messages.lastObject;
-        SPNPPollStatistic *statistic = [SPNPPollStatistic objectFromDictionaryRepresentation:object];
-        if (statistic && [statistic.pollIdentifier isEqualToString:strongSelf.activePoll.identifier]) {
+        if ([strongSelf.activePoll.identifier isEqualToString:poll.identifier]) {
+            
+            [strongSelf updateStatisticForSession:strongSelf.primarySession withVotesCount:votesCount];
+        }
+        if (progressBlock) { progressBlock(progress); }
+    } completionBlock:^(NSArray *votesCount, SPNPVoterIndex *voters, NSString *errorMessage) {
+        
+        __strong __typeof(self) strongSelf = weakSelf;
+        [strongSelf.metrics recordLatency:SPNPHistoryRestoreLatency since:startTime];
+        if (![strongSelf.activePoll.identifier isEqualToString:poll.identifier]) {
+            
+            strongSelf.recoveringVotes = NO;
+            if (completionBlock) { completionBlock(errorMessage); }
+        }
+        // Partially recounted votes can't be used as base for real-time votes counting.
+        else if (errorMessage) {
+            
+            strongSelf.recoveringVotes = NO;
+            [strongSelf resetVoteAggregation];
+            strongSelf.primarySession.publishedVotesCount = nil;
+            if (completionBlock) { completionBlock(errorMessage); }
+        }
+        else {
             
-            [strongSelf setInitialStatisticStateWith:statistic.responses];
+            [strongSelf.voteAggregator mergeRecountedVotesCount:votesCount voters:voters
+                                                 withCompletion:^{
+                
+                __strong __typeof(self) mergeStrongSelf = weakSelf;
+                SPNPPollSession *session = mergeStrongSelf.primarySession;
+                NSArray *mergedVotesCount = [mergeStrongSelf.voteAggregator votesCountIfChanged];
+                session.statisticStore = nil;
+                [mergeStrongSelf updateStatisticForSession:session
+                                            withVotesCount:(mergedVotesCount ?: votesCount)];
+                session.publishedVotesCount = nil;
+                mergeStrongSelf.recoveringVotes = NO;
+                if (completionBlock) { completionBlock(nil); }
+            }];
         }
-        else { [strongSelf setInitialStatisticStateWith:nil]; }
-        block(status.isError ? status.errorData.information : nil);
     }];
 }
 
@@ -386,166 +1372,709 @@ static NSTimeInterval const kSPNPStatisticRefreshInterval = 0.5f;
     NSArray *sortedStatistics = [statistics sortedArrayUsingDescriptors:@[descriptor]];
     [_statistics removeAllObjects];
     [_statistics addObjectsFromArray:sortedStatistics];
-    [self didChangeValueForKey:@"statistics"];
+    [self didChangeStatistics];
 }
 
-- (void)updateStatisticInformationForResponse:(SPNPPollResponse *)response {
+- (void)mergeStatisticFromHost:(NSArray *)statistics {
     
-    [self willChangeValueForKey:@"statistics"];
-    SPNPPollResponseStatistic *responseStatistic = self.statistics[response.order.unsignedIntegerValue];
-    [responseStatistic registerVoice];
+    NSSortDescriptor *descriptor = [NSSortDescriptor sortDescriptorWithKey:@"order" ascending:YES];
+    NSArray *sortedStatistics = [statistics sortedArrayUsingDescriptors:@[descriptor]];
+    if (sortedStatistics.count == _statistics.count) {
+        
+        [self willChangeValueForKey:@"statistics"];
+        NSString *node = (self.isHost ? self.nodeIdentifier : nil);
+        [_statistics enumerateObjectsUsingBlock:^(SPNPPollResponseStatistic *statistic,
+                                                  NSUInteger statisticIdx,
+                                                  BOOL *statisticsEnumeratorStop) {
+            
+            SPNPPollResponseStatistic *mergedStatistic = sortedStatistics[statisticIdx];
+            if (mergedStatistic != statistic) {
+                
+                [statistic mergeNodeCounters:mergedStatistic.nodeCounters preservingNode:node];
+            }
+        }];
+        [self didChangeStatistics];
+    }
+    else if (!self.isHost) { [self updateStatisticFromHost:statistics]; }
+}
+
+- (void)handleStatisticMessage:(id)message {
+    
+    if (self.activePoll.isOpenText) {
+        
+        SPNPPollTextStatistic *statistic = [self objectOfClass:SPNPPollTextStatistic.class
+                                                   fromMessage:message];
+        if (statistic) { [self applyTextStatistic:statistic]; }
+        return;
+    }
+    else if (self.activePoll.isRanked) {
+        
+        SPNPPollRankedStatistic *statistic = [self objectOfClass:SPNPPollRankedStatistic.class
+                                                     fromMessage:message];
+        if (statistic) { [self applyRankedStatistic:statistic]; }
+        return;
+    }
+    else if (self.activePoll.isRating) {
+        
+        SPNPPollRatingStatistic *statistic = [self objectOfClass:SPNPPollRatingStatistic.class
+                                                     fromMessage:message];
+        if (statistic) { [self applyRatingStatistic:statistic]; }
+        return;
+    }
+    
+    SPNPPollStatisticDelta *delta = [self objectOfClass:SPNPPollStatisticDelta.class
+                                            fromMessage:message];
+    if (delta) { [self applyStatisticDelta:delta]; }
+    else {
+        
+        SPNPPollStatistic *statistic = [self objectOfClass:SPNPPollStatistic.class fromMessage:message];
+        if (statistic) { [self applyStatistic:statistic]; }
+    }
+}
+
+- (void)applyStatistic:(SPNPPollStatistic *)statistic {
+    
+    BOOL isActivePoll = [statistic.pollIdentifier isEqualToString:self.activePoll.identifier];
+    
+    // Statistic from host nodes can be merged in any order and doesn't depend from sequence.
+    if (statistic.isMergeable) {
+        
+        if (isActivePoll) {
+            
+            [self mergeStatisticFromHost:statistic.responses];
+            if (statistic.trend) { self.statisticTrend = statistic.trend; }
+            [self recordLatencyOfVoteTraces:statistic.traces];
+        }
+        return;
+    }
+    
+    if (isActivePoll && [self.statisticSequencer acceptKeyframeWithSequence:statistic.sequence]) {
+        
+        [self updateStatisticFromHost:statistic.responses];
+        if (statistic.trend) { self.statisticTrend = statistic.trend; }
+        [self recordLatencyOfVoteTraces:statistic.traces];
+    }
+}
+
+- (void)applyTextStatistic:(SPNPPollTextStatistic *)statistic {
+    
+    BOOL isActivePoll = [statistic.pollIdentifier isEqualToString:self.activePoll.identifier];
+    if (isActivePoll && [self.statisticSequencer acceptKeyframeWithSequence:statistic.sequence]) {
+        
+        self.textStatistic = statistic;
+    }
+}
+
+- (void)applyRankedStatistic:(SPNPPollRankedStatistic *)statistic {
+    
+    BOOL isActivePoll = [statistic.pollIdentifier isEqualToString:self.activePoll.identifier];
+    if (isActivePoll && [self.statisticSequencer acceptKeyframeWithSequence:statistic.sequence]) {
+        
+        self.rankedStatistic = statistic;
+    }
+}
+
+- (void)applyRatingStatistic:(SPNPPollRatingStatistic *)statistic {
+    
+    if (![statistic.pollIdentifier isEqualToString:self.activePoll.identifier]) { return; }
+    
+    NSString *node = ([statistic.node isKindOfClass:NSString.class] ? statistic.node : @"");
+    SPNPPollRatingStatistic *nodeStatistic = self.nodeRatingStatistics[node];
+    unsigned long long nodeSequence = nodeStatistic.sequence.unsignedLongLongValue;
+    BOOL isNewer = (!nodeStatistic ||
+                    [SPNPStatisticSequencer isSequence:statistic.sequence newerThan:nodeSequence
+                                      keyframeInterval:kSPNPStatisticKeyframeInterval]);
+    if (isNewer) {
+        
+        self.nodeRatingStatistics[node] = statistic;
+        if (self.nodeRatingStatistics.count > 1) {
+            
+            SPNPRatingAccumulator *accumulator = nil;
+            for (SPNPPollRatingStatistic *partialStatistic in self.nodeRatingStatistics.allValues) {
+                
+                SPNPRatingAccumulator *partialAccumulator = nil;
+                partialAccumulator = [partialStatistic accumulatorForPoll:self.activePoll];
+                if (accumulator) { [accumulator mergeAccumulator:partialAccumulator]; }
+                else { accumulator = partialAccumulator; }
+            }
+            statistic = [SPNPPollRatingStatistic statisticForPoll:statistic.pollIdentifier
+                                                  withAccumulator:accumulator node:nil
+                                                         sequence:nil];
+        }
+        self.ratingStatistic = statistic;
+    }
+}
+
+- (void)applyStatisticDelta:(SPNPPollStatisticDelta *)delta {
+    
+    BOOL isActivePoll = [delta.pollIdentifier isEqualToString:self.activePoll.identifier];
+    if (isActivePoll && [self.statisticSequencer acceptChangesWithSequence:delta.sequence]) {
+        
+        [self willChangeValueForKey:@"statistics"];
+        NSArray *statistics = _statistics;
+        [delta enumerateChangesUsingBlock:^(NSUInteger order, long long change) {
+            
+            if (order < statistics.count) {
+                
+                [(SPNPPollResponseStatistic *)statistics[order] applyVotesCountChange:change];
+            }
+        }];
+        [self didChangeStatistics];
+        [self recordLatencyOfVoteTraces:delta.traces];
+    }
+}
+
+- (void)recordLatencyOfVoteTraces:(NSArray *)traces {
+    
+    [self.voteTraceSampler recordLatencyOfTraces:traces
+                                     forVoterKey:[SPNPVoterIndex keyForVoter:self.transport.uuid]
+                                          atTime:[SPNPVoteTrace currentTime]
+                                       inMetrics:self.metrics];
+}
+
+- (void)didChangeStatistics {
+    
+    uint64_t startTime = [SPNPMetrics currentTime];
     [self didChangeValueForKey:@"statistics"];
+    [self.metrics recordLatency:SPNPObserverNotificationLatency since:startTime];
+    [self.metrics incrementCounter:SPNPObserverNotificationsCounter by:1];
 }
 
-- (void)startStatisticPublising {
+- (BOOL)updateStatisticFromAggregatedVotesForSession:(SPNPPollSession *)session {
+    
+    if (session.textTally) { return [session.textTally hasResponsesSinceLastCheck]; }
+    else if (session.rankedTally) { return [session.rankedTally hasBallotsSinceLastCheck]; }
+    else if (session.ratingTally) { return [session.ratingTally hasRatingsSinceLastCheck]; }
+    
+    // Votes aggregated during recovery doesn't include recounted votes till they will be merged.
+    BOOL isRecovering = (session == self.primarySession && self.isRecoveringVotes);
+    if (isRecovering) { return NO; }
+    
+    // Traces dequeued first, so votes count retrieved after include all traced votes.
+    NSArray *traces = [session.voteAggregator dequeueVoteTraces];
+    SPNPStatisticStore *store = [self statisticStoreForSession:session];
+    NSIndexSet *changedIndexes = [session.voteAggregator updateVotesCountInStore:store];
+    if (changedIndexes) { session.coveredTime = [SPNPVoteTrace currentTime]; }
+    for (SPNPVoteTrace *trace in traces) {
+        
+        if (session.pendingTraces.count >= kSPNPMaximumVoteTraces) { break; }
+        [session.pendingTraces addObject:trace];
+    }
+    
+    if (changedIndexes.count) {
+        
+        // Statistic still store previous votes count of changed responses.
+        NSTimeInterval time = [NSDate timeIntervalSinceReferenceDate];
+        NSString *node = self.nodeIdentifier;
+        [changedIndexes enumerateIndexesUsingBlock:^(NSUInteger responseIdx, BOOL *indexesStop) {
+            
+            SPNPPollResponseStatistic *statistic = session.statistics[responseIdx];
+            unsigned long long previousVotesCount = (node ? [statistic votesCountForNode:node] :
+                                                     statistic.votesCount.unsignedLongLongValue);
+            long long change = ((long long)[store votesCountAtIndex:responseIdx] -
+                                (long long)previousVotesCount);
+            [session.timeSeries recordChange:change forResponse:responseIdx atTime:time];
+        }];
+    }
+    [self updateStatisticForSession:session atIndexes:changedIndexes];
     
-    [self stopStatisticPublishing];
-    self.statisticUpdateTimer = [NSTimer scheduledTimerWithTimeInterval:kSPNPStatisticRefreshInterval
-                                 target:self selector:@selector(publishStatistic) userInfo:nil
-                                                                repeats:YES];
+    return (changedIndexes != nil);
 }
 
-- (void)stopStatisticPublishing {
+- (void)updateStatisticForSession:(SPNPPollSession *)session withVotesCount:(NSArray *)votesCount {
     
-    if (self.statisticUpdateTimer.isValid) {
+    if (session && votesCount.count == session.statistics.count) {
+        
+        [session.statisticStore updateWithVotesCount:votesCount];
         
-        [self.statisticUpdateTimer invalidate];
-        self.statisticUpdateTimer = nil;
+        // Only primary poll statistic is observed by user interface.
+        BOOL isPrimary = (session == self.primarySession);
+        if (isPrimary) { [self willChangeValueForKey:@"statistics"]; }
+        [session.statistics enumerateObjectsUsingBlock:^(SPNPPollResponseStatistic *statistic,
+                                                         NSUInteger statisticIdx,
+                                                         BOOL *statisticsEnumeratorStop) {
+            
+            unsigned long long responseVotesCount = [votesCount[statisticIdx] unsignedLongLongValue];
+            if (self.nodeIdentifier) {
+                
+                [statistic updateVotesCount:responseVotesCount forNode:self.nodeIdentifier];
+            }
+            else { [statistic updateVotesCount:responseVotesCount]; }
+        }];
+        if (isPrimary) { [self didChangeStatistics]; }
     }
 }
 
-- (void)publishStatistic {
+- (void)updateStatisticForSession:(SPNPPollSession *)session
+                        atIndexes:(NSIndexSet *)changedIndexes {
     
-    if (self.hasUnupblishedStatistic && self.activePoll) {
+    SPNPStatisticStore *store = session.statisticStore;
+    if (changedIndexes.count && store.count == session.statistics.count) {
         
-        self.hasUnupblishedStatistic = NO;
-        SPNPPollStatistic *statistics = [SPNPPollStatistic statisticForPoll:self.activePoll
-                                                              withResponses:self.statistics];
-        __weak __typeof(self) weakSelf = self;
-        [self.client publish:[statistics dictionaryRepresentation]
-                   toChannel:[self pollStatisticsChannelName] compressed:YES
-              withCompletion:^(PNPublishStatus *status) {
+        // Only primary poll statistic is observed by user interface.
+        BOOL isPrimary = (session == self.primarySession);
+        if (isPrimary) { [self willChangeValueForKey:@"statistics"]; }
+        [changedIndexes enumerateIndexesUsingBlock:^(NSUInteger responseIdx, BOOL *indexesStop) {
             
-            __strong __typeof(self) strongSelf = weakSelf;
-            if (status.isError) { strongSelf.hasUnupblishedStatistic = YES; }
+            SPNPPollResponseStatistic *statistic = session.statistics[responseIdx];
+            unsigned long long responseVotesCount = [store votesCountAtIndex:responseIdx];
+            if (self.nodeIdentifier) {
+                
+                [statistic updateVotesCount:responseVotesCount forNode:self.nodeIdentifier];
+            }
+            else { [statistic updateVotesCount:responseVotesCount]; }
         }];
+        if (isPrimary) { [self didChangeStatistics]; }
     }
 }
 
+- (SPNPStatisticStore *)statisticStoreForSession:(SPNPPollSession *)session {
+    
+    if (session.statisticStore.count != session.statistics.count) {
+        
+        NSString *pollIdentifier = session.poll.identifier;
+        SPNPStatisticStore *store = [SPNPStatisticStore storeWithStatistics:session.statistics
+                                                                    forPoll:pollIdentifier];
+        [store updateWithVotesCount:[self aggregatedVotesCountFrom:session.statistics]];
+        session.statisticStore = store;
+    }
+    
+    return session.statisticStore;
+}
 
-#pragma mark - PubNub event listener
+- (void)resetVoteAggregation {
+    
+    self.primarySession.statisticStore = nil;
+    [self.voteAggregator resetForPoll:self.activePoll
+                       withVotesCount:[self aggregatedVotesCountFrom:self.statistics]];
+}
 
-- (void)client:(PubNub *)client didReceiveStatus:(PNStatus *)status {
+- (NSArray *)aggregatedVotesCountFrom:(NSArray *)statistics {
     
-    if (status.operation == PNSubscribeOperation) {
+    NSArray *votesCount = [statistics valueForKey:@"votesCount"];
+    if (self.nodeIdentifier) {
         
-        __block NSString *errorMessage = nil;
-        if (status.category == PNUnexpectedDisconnectCategory) {
+        NSMutableArray *nodeVotesCount = [NSMutableArray arrayWithCapacity:statistics.count];
+        for (SPNPPollResponseStatistic *statistic in statistics) {
             
-            errorMessage = ((PNErrorStatus *)status).errorData.information;
+            [nodeVotesCount addObject:@([statistic votesCountForNode:self.nodeIdentifier])];
         }
-        self.connected = (errorMessage == nil);
-        if (!self.isInitiallyConnected && self.isConnected) {
+        votesCount = nodeVotesCount;
+    }
+    
+    return votesCount;
+}
+
+- (void)startStatisticPublising {
+    
+    [self.publishScheduler start];
+}
+
+- (void)stopStatisticPublishing {
+    
+    [self.publishScheduler stop];
+}
+
+- (void)resetStatisticSequence {
+    
+    [self.statisticSequencer resetWithSequence:0 synchronized:NO];
+    self.primarySession.statisticSequence = 0;
+    self.primarySession.publishedVotesCount = nil;
+}
+
+- (void)publishStatisticForSession:(SPNPPollSession *)session
+                    withCompletion:(void(^)(BOOL published))block {
+    
+    SPNPPoll *poll = session.poll;
+    if (poll && (session.textTally || session.rankedTally || session.ratingTally)) {
+        
+        [self publishTallyStatisticForSession:session withCompletion:block];
+    }
+    else if (poll) {
+        
+        session.statisticSequence++;
+        NSNumber *sequence = @(session.statisticSequence);
+        SPNPStatisticSnapshot *snapshot = [session statisticSnapshot];
+        NSArray *responseStatistics = snapshot.statistics;
+        NSArray *votesCount = snapshot.votesCount;
+        NSArray *publishedVotesCount = session.publishedVotesCount;
+        SPNPSerializable *statistics = nil;
+        NSMutableArray *traces = nil;
+        if (session.pendingTraces.count) {
             
-            self.initiallyConnected = YES;
+            NSNumber *publishedTime = [SPNPVoteTrace currentTime];
+            traces = [NSMutableArray arrayWithCapacity:session.pendingTraces.count];
+            for (SPNPVoteTrace *trace in session.pendingTraces) {
+                
+                [traces addObject:[trace traceWithPublishedTime:publishedTime]];
+            }
+            [session.pendingTraces removeAllObjects];
+        }
+        NSArray *trend = nil;
+        if (self.publishesStatisticTrend) {
+            
+            trend = [session.timeSeries trendAtTime:[NSDate timeIntervalSinceReferenceDate]];
+            if (session == self.primarySession) { self.statisticTrend = trend; }
+        }
+        // Changes from few host nodes can't be merged, so node always publish keyframes.
+        BOOL isKeyframe = (publishedVotesCount.count != votesCount.count || self.nodeIdentifier ||
+                           session.statisticSequence % kSPNPStatisticKeyframeInterval == 0);
+        if (isKeyframe) {
+            
+            statistics = [SPNPPollStatistic statisticForPoll:poll withResponses:responseStatistics
+                                                    sequence:sequence trend:trend traces:traces
+                                                 coveredTime:session.coveredTime];
+        }
+        else {
+            
+            NSMutableArray *changes = [NSMutableArray new];
+            [responseStatistics enumerateObjectsUsingBlock:^(SPNPPollResponseStatistic *statistic,
+                                                             NSUInteger statisticIdx,
+                                                             BOOL *statisticsEnumeratorStop) {
+                
+                long long change = ([votesCount[statisticIdx] longLongValue] -
+                                    [publishedVotesCount[statisticIdx] longLongValue]);
+                if (change != 0) { [changes addObjectsFromArray:@[statistic.order, @(change)]]; }
+            }];
+            statistics = [SPNPPollStatisticDelta deltaForPoll:poll sequence:sequence
+                                                  withChanges:changes traces:traces
+                                                  coveredTime:session.coveredTime];
         }
-        if (self.statusHandleBlock) { self.statusHandleBlock(errorMessage == nil, errorMessage); }
+        session.publishedVotesCount = votesCount;
+        if (session == self.primarySession) {
+            
+            [self.statisticSequencer resetWithSequence:session.statisticSequence synchronized:YES];
+        }
+        
+        // Update built from snapshot, so it can be serialized while votes counted. Serial queue and
+        // main queue preserve updates order.
+        BOOL isCompact = self.publishesCompactStatistic;
+        uint64_t startTime = [SPNPMetrics currentTime];
+        SPNPMetrics *metrics = self.metrics;
+        __weak __typeof(self) weakSelf = self;
+        dispatch_async(self.serializationQueue, ^{
+            
+            id message = (isCompact ? [statistics compactRepresentationForPoll:poll.identifier
+                                                                         token:poll.token] :
+                          [statistics dictionaryRepresentation]);
+            
+            // Attendees without changes support listen for full statistic which is sent only with
+            // keyframes, so each update doesn't cost two messages.
+            NSDictionary *keyframeMessage = nil;
+            if (isKeyframe) {
+                
+                keyframeMessage = (isCompact ? [statistics dictionaryRepresentation] : message);
+            }
+            dispatch_async(dispatch_get_main_queue(), ^{
+                
+                if (keyframeMessage) {
+                    
+                    [weakSelf.transport publish:keyframeMessage
+                                      toChannel:session.statisticsChannelName
+                              mobilePushPayload:nil withCompletion:^(NSString *errorMessage) {
+                        
+                        [metrics incrementCounter:(errorMessage ? SPNPFailedPublishesCounter :
+                                                   SPNPPublishedStatisticsCounter) by:1];
+                    }];
+                }
+                [weakSelf.transport publish:message toChannel:session.statisticDeltasChannelName
+                          mobilePushPayload:nil withCompletion:^(NSString *errorMessage) {
+                    
+                    [metrics recordLatency:SPNPStatisticPublishLatency since:startTime];
+                    [metrics incrementCounter:(errorMessage ? SPNPFailedPublishesCounter :
+                                               SPNPPublishedStatisticsCounter) by:1];
+                    
+                    // Attendees will detect lost update, so next update should be sent as keyframe.
+                    if (errorMessage) { session.publishedVotesCount = nil; }
+                    if (block) { block(errorMessage == nil); }
+                }];
+            });
+        });
+    }
+    else if (block) { block(YES); }
+}
+
+- (void)publishTallyStatisticForSession:(SPNPPollSession *)session
+                         withCompletion:(void(^)(BOOL published))block {
+    
+    session.statisticSequence++;
+    SPNPPoll *poll = session.poll;
+    NSNumber *sequence = @(session.statisticSequence);
+    SPNPPollTextStatistic *textStatistic = nil;
+    SPNPPollRankedStatistic *rankedStatistic = nil;
+    SPNPPollRatingStatistic *ratingStatistic = nil;
+    SPNPSerializable *statistic = nil;
+    if (session.textTally) {
+        
+        textStatistic = [session.textTally statisticWithTopCount:session.textStatisticTopCount
+                                                        sequence:sequence];
+        statistic = textStatistic;
+    }
+    else if (session.rankedTally) {
+        
+        rankedStatistic = [session.rankedTally statisticWithSequence:sequence];
+        statistic = rankedStatistic;
     }
-    else if (status.operation == PNUnsubscribeOperation && self.statusHandleBlock) {
+    else {
+        
+        ratingStatistic = [session.ratingTally statisticForNode:self.nodeIdentifier
+                                                       sequence:sequence];
+        statistic = ratingStatistic;
+    }
+    if (session == self.primarySession) {
+        
+        [self.statisticSequencer resetWithSequence:session.statisticSequence synchronized:YES];
+        self.textStatistic = textStatistic;
+        self.rankedStatistic = rankedStatistic;
+        if (ratingStatistic) { [self applyRatingStatistic:ratingStatistic]; }
+    }
+    
+    BOOL isCompact = self.publishesCompactStatistic;
+    uint64_t startTime = [SPNPMetrics currentTime];
+    SPNPMetrics *metrics = self.metrics;
+    __weak __typeof(self) weakSelf = self;
+    dispatch_async(self.serializationQueue, ^{
+        
+        id message = (isCompact ? [statistic compactRepresentationForPoll:poll.identifier
+                                                                    token:poll.token] :
+                      [statistic dictionaryRepresentation]);
+        dispatch_async(dispatch_get_main_queue(), ^{
+            
+            // Attendees without tally statistic support can't parse it, so it sent only along with
+            // changes.
+            [weakSelf.transport publish:message toChannel:session.statisticDeltasChannelName
+                      mobilePushPayload:nil withCompletion:^(NSString *errorMessage) {
+                
+                [metrics recordLatency:SPNPStatisticPublishLatency since:startTime];
+                [metrics incrementCounter:(errorMessage ? SPNPFailedPublishesCounter :
+                                           SPNPPublishedStatisticsCounter) by:1];
+                if (block) { block(errorMessage == nil); }
+            }];
+        });
+    });
+}
+
+- (SPNPStatisticPublishScheduler *)publishSchedulerForSession:(SPNPPollSession *)session {
+    
+    __weak __typeof(self) weakSelf = self;
+    __weak SPNPPollSession *weakSession = session;
+    SPNPStatisticPublishScheduler *scheduler = nil;
+    scheduler = [SPNPStatisticPublishScheduler schedulerWithChangesBlock:^BOOL{
+        
+        return [weakSelf updateStatisticFromAggregatedVotesForSession:weakSession];
+    } publishBlock:^(void(^completion)(BOOL published)) {
+        
+        __strong SPNPPollSession *strongSession = weakSession;
+        if (strongSession) { [weakSelf publishStatisticForSession:strongSession withCompletion:completion]; }
+        else if (completion) { completion(YES); }
+    }];
+    scheduler.minimumInterval = self.publishScheduler.minimumInterval;
+    scheduler.maximumInterval = self.publishScheduler.maximumInterval;
+    scheduler.maximumBackOffInterval = self.publishScheduler.maximumBackOffInterval;
+    
+    return scheduler;
+}
+
+
+#pragma mark - Transport delegate
+
+- (void)transport:(id<SPNPTransport>)transport didChangeStatus:(SPNPTransportStatus)status
+        withError:(NSString *)errorMessage {
+    
+    if (status != SPNPTransportDisconnected) {
         
-        self.statusHandleBlock(NO, nil);
+        self.connected = (status == SPNPTransportConnected);
+        if (!self.isInitiallyConnected && self.isConnected) {
+            
+            self.initiallyConnected = YES;
+        }
+        if (self.statusHandleBlock) { self.statusHandleBlock(self.isConnected, errorMessage); }
     }
+    else if (self.statusHandleBlock) { self.statusHandleBlock(NO, nil); }
 }
 
-- (void)client:(PubNub *)client didReceivePresenceEvent:(PNPresenceEventResult *)event {
+- (void)transport:(id<SPNPTransport>)transport didReceiveOccupancy:(NSUInteger)occupancy
+           joined:(NSArray *)joined left:(NSArray *)left onChannel:(NSString *)channel {
     
-    if ([event.data.subscribedChannel isEqualToString:self.identifier]) {
+    if ([channel isEqualToString:self.identifier]) {
         
-        self.attendeesCount = @(event.data.presence.occupancy.unsignedLongLongValue - 1);
-        self.attendeesCountString = [NSString stringWithFormat:@"%@",
-                                     (self.attendeesCount.unsignedLongLongValue == 0) ?
-                                     @"--" : self.attendeesCount];
+        [self.presenceAggregator handleOccupancy:occupancy joined:joined left:left];
     }
 }
 
-- (void)client:(PubNub *)client didReceiveMessage:(PNMessageResult *)message {
+- (void)transport:(id<SPNPTransport>)transport didReceiveMessage:(id)data
+    fromPublisher:(NSString *)publisher onChannel:(NSString *)channelName {
     
-    NSString *channelName = message.data.subscribedChannel;
-    NSDictionary *data = message.data.message;
+    [self.metrics incrementCounter:SPNPReceivedMessagesCounter by:1];
     
     // Handle responses from poll attendees.
-    if ([channelName isEqualToString:[self answersChannelName]]) {
+    // Responses for unknown or already completed polls dropped right after poll key lookup.
+    NSNumber *shardIndex = (self.isHost ? self.answerShardChannels[channelName] : nil);
+    if (shardIndex) {
         
-        self.hasUnupblishedStatistic = YES;
-        SPNPPollResponse *response = [SPNPPollResponse objectFromDictionaryRepresentation:data];
-        [self updateStatisticInformationForResponse:response];
+        // Responses de-duplicated by publisher, because voter identifier in payload can be spoofed.
+        SPNPPollSession *session = [self.pollRegistry sessionForResponseMessage:data];
+        if (session.textTally) {
+            
+            [session.textTally registerResponseFromMessage:data fromVoter:publisher];
+        }
+        else if (session.rankedTally) {
+            
+            [session.rankedTally registerBallotFromMessage:data fromVoter:publisher];
+        }
+        else if (session.ratingTally) {
+            
+            [session.ratingTally registerRatingFromMessage:data fromVoter:publisher];
+        }
+        else {
+            
+            [session.voteAggregator registerVoteFromMessage:data fromVoter:publisher
+                                                    inShard:shardIndex.unsignedIntegerValue];
+        }
+        [session.publishScheduler setNeedsCheck];
     }
-    // Handle stats from host.
-    else if ([channelName isEqualToString:[self pollStatisticsChannelName]]) {
+    // Handle stats from host (additional polls publish to own statistic channels).
+    else if ([channelName hasPrefix:[self pollStatisticsChannelName]]) {
         
-        SPNPPollStatistic *statistics = [SPNPPollStatistic objectFromDictionaryRepresentation:data];
-        [self updateStatisticFromHost:statistics.responses];
+        [self handleStatisticMessage:data];
     }
     // Handle polls announcements from host.
     else if ([channelName isEqualToString:[self pollChannelName]]) {
         
-        SPNPPoll *poll = [SPNPPoll objectFromDictionaryRepresentation:data];
-        self.activePoll = (poll.isActive ? poll : nil);
-        if (self.activePoll) { [self setInitialStatisticStateWith:nil]; }
-        else { [self.statistics removeAllObjects]; }
+        SPNPPoll *poll = [self objectOfClass:SPNPPoll.class fromMessage:data];
+        
+        // Attendee follow single poll, so announcements of other polls ignored till followed poll
+        // will be completed.
+        SPNPPoll *followedPoll = self.activePoll;
+        if (!followedPoll || [poll.identifier isEqualToString:followedPoll.identifier]) {
+            
+            self.activePoll = (poll.isActive ? poll : nil);
+            [self resetStatisticSequence];
+            [self.statistics removeAllObjects];
+            NSString *channel = nil;
+            if (self.activePoll) {
+                
+                [self setInitialStatisticStateWith:nil];
+                channel = [self statisticDeltasChannelNameForPoll:poll];
+                [self.transport subscribeToChannels:@[channel]];
+            }
+            
+            // Statistic of poll which is not followed anymore shouldn't be delivered to attendee.
+            NSString *followedChannel = (followedPoll ?
+                                         [self statisticDeltasChannelNameForPoll:followedPoll] : nil);
+            if (followedChannel && ![followedChannel isEqualToString:channel]) {
+                
+                [self.transport unsubscribeFromChannels:@[followedChannel]];
+            }
+        }
     }
 }
 
 
 #pragma mark - Misc
 
+- (BOOL)supportsCompactEncoding {
+    
+    return [self.activePoll.encodings containsObject:[SPNPCompactCoder formatName]];
+}
+
+- (id)objectOfClass:(Class)objectClass fromMessage:(id)message {
+    
+    uint64_t startTime = [SPNPMetrics currentTime];
+    id object = [objectClass objectFromMessage:message forPoll:self.activePoll.identifier
+                                         token:self.activePoll.token];
+    [self.metrics recordLatency:SPNPMessageDecodeLatency since:startTime];
+    
+    return object;
+}
+
 - (void)setInitialStatisticStateWith:(NSArray *)statistics {
     
-    NSMutableArray *responseStatistics = nil;
-    NSArray *pollResponses = self.activePoll.responses;
-    NSSortDescriptor *descriptor = [NSSortDescriptor sortDescriptorWithKey:@"order" ascending:YES];
-    NSArray *sortedResponses = [(statistics?: pollResponses) sortedArrayUsingDescriptors:@[descriptor]];
-    if (!statistics) {
+    NSArray *responseStatistics = nil;
+    if (statistics) {
         
-        responseStatistics = [NSMutableArray new];
-        [sortedResponses enumerateObjectsUsingBlock:^(SPNPPollResponse *response, NSUInteger responseIdx,
-                                                      BOOL *responsesEnumeratorStop) {
-            
-            [responseStatistics addObject:[SPNPPollResponseStatistic statisticForResponse:response]];
-        }];
+        NSSortDescriptor *descriptor = [NSSortDescriptor sortDescriptorWithKey:@"order" ascending:YES];
+        responseStatistics = [statistics sortedArrayUsingDescriptors:@[descriptor]];
     }
-    [self.statistics addObjectsFromArray:(responseStatistics?: sortedResponses)];
+    else { responseStatistics = [self initialStatisticForPoll:self.activePoll]; }
+    [self.statistics addObjectsFromArray:responseStatistics];
 }
 
-- (NSArray *)channelsForSubscription {
+- (NSMutableArray *)initialStatisticForPoll:(SPNPPoll *)poll {
     
-    NSMutableArray *channels = [@[self.identifier] mutableCopy];
-    [channels addObject:[self.identifier stringByAppendingString:@"-pnpres"]];
-    if (self.isHost) {
+    NSMutableArray *responseStatistics = [NSMutableArray new];
+    NSSortDescriptor *descriptor = [NSSortDescriptor sortDescriptorWithKey:@"order" ascending:YES];
+    NSArray *sortedResponses = [poll.responses sortedArrayUsingDescriptors:@[descriptor]];
+    [sortedResponses enumerateObjectsUsingBlock:^(SPNPPollResponse *response, NSUInteger responseIdx,
+                                                  BOOL *responsesEnumeratorStop) {
         
-        [channels addObjectsFromArray:@[[self answersChannelName]]];
-    }
-    else {
+        [responseStatistics addObject:[SPNPPollResponseStatistic statisticForResponse:response]];
+    }];
+    
+    return responseStatistics;
+}
+
+- (void)configureVoteAggregator:(SPNPVoteAggregator *)voteAggregator {
+    
+    voteAggregator.allowsVoteChange = self.allowsVoteChange;
+    voteAggregator.maximumBatchSize = self.voteAggregator.maximumBatchSize;
+    voteAggregator.batchLatency = self.voteAggregator.batchLatency;
+    voteAggregator.metrics = self.metrics;
+}
+
+- (NSString *)answersChannelNameForShard:(NSUInteger)shardIndex {
+    
+    NSString *channel = self.answersChannelName;
+    if (shardIndex > 0) {
         
-        [channels addObjectsFromArray:@[[self pollChannelName], [self pollStatisticsChannelName]]];
+        channel = [channel stringByAppendingFormat:@"-%@", @(shardIndex)];
     }
     
-    return [channels copy];
+    return channel;
 }
 
-- (NSString *)pollChannelName {
+- (NSString *)statisticDeltasChannelNameForPoll:(SPNPPoll *)poll {
+    
+    NSString *channel = [SPNPPollSession statisticsChannelForPoll:poll
+                                                   defaultChannel:self.pollStatisticsChannelName];
     
-    return [self.identifier stringByAppendingString:@"-poll"];
+    return [SPNPPollSession deltasChannelFor:channel];
 }
 
-- (NSString *)pollStatisticsChannelName {
+- (void)updateAnswerShardChannels {
     
-    return [self.identifier stringByAppendingString:@"-stat"];
+    NSUInteger shardsCount = MAX(self.activePoll.answerShardsCount.unsignedIntegerValue, 1);
+    for (SPNPPollSession *session in self.pollRegistry.sessions) {
+        
+        shardsCount = MAX(shardsCount, session.poll.answerShardsCount.unsignedIntegerValue);
+    }
+    NSMutableDictionary *answerShardChannels = [NSMutableDictionary new];
+    for (NSUInteger shardIdx = 0; shardIdx < shardsCount; shardIdx++) {
+        
+        if (!self.nodeAnswerShards || [self.nodeAnswerShards containsIndex:shardIdx]) {
+            
+            answerShardChannels[[self answersChannelNameForShard:shardIdx]] = @(shardIdx);
+        }
+    }
+    self.answerShardChannels = answerShardChannels;
 }
 
-- (NSString *)answersChannelName {
+- (NSArray *)channelsForSubscription {
     
-    return [self.identifier stringByAppendingString:@"-res"];
+    NSMutableArray *channels = [@[self.identifier] mutableCopy];
+    [channels addObject:[self.identifier stringByAppendingString:@"-pnpres"]];
+    if (self.isHost) {
+        
+        [channels addObjectsFromArray:self.answerShardChannels.allKeys];
+        if (self.nodeIdentifier) { [channels addObject:[self pollStatisticDeltasChannelName]]; }
+    }
+    else {
+        
+        [channels addObjectsFromArray:@[[self pollChannelName],
+                                        [self pollStatisticDeltasChannelName]]];
+    }
+    
+    return [channels copy];
 }
 
 #pragma mark -
@@ -0,0 +1,90 @@
+#import <Foundation/Foundation.h>
+
+
+#pragma mark Class forward
+
+@class SPNPPollSession, SPNPPoll;
+
+
+/**
+ @brief      Host side registry of polls which accept responses.
+ @discussion Registry index sessions by poll identifier and short poll token, so every received 
+             response routed to poll's votes aggregation engine with single hash lookup. Poll key
+             read from response before it is deserialized, so responses for unknown or closed polls
+             dropped cheaply.
+             Registry should be used from main thread.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPPollRegistry : NSObject
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on list of registered poll sessions.
+ */
+@property (nonatomic, readonly, copy) NSArray *sessions;
+
+
+///------------------------------------------------
+/// @name Sessions
+///------------------------------------------------
+
+/**
+ @brief      Register poll session.
+ @discussion Session which has been registered for the same poll before will be replaced.
+ 
+ @param session Reference on session which should accept poll responses.
+ */
+- (void)registerSession:(SPNPPollSession *)session;
+
+/**
+ @brief  Remove session of the poll.
+ 
+ @param poll Reference on poll for which responses shouldn't be accepted anymore.
+ */
+- (void)unregisterSessionForPoll:(SPNPPoll *)poll;
+
+/**
+ @brief  Retrieve session of the poll.
+ 
+ @param pollIdentifier Unique poll identifier.
+ 
+ @return Registered session or \c nil in case if there is no such poll.
+ */
+- (SPNPPollSession *)sessionForPollIdentifier:(NSString *)pollIdentifier;
+
+/**
+ @brief      Check whether there is registered poll with specified token.
+ @discussion Short tokens are random, so host should make sure what concurrently active polls use
+             different tokens.
+ 
+ @param token Reference on short poll token.
+ 
+ @return \c YES in case if token already used by one of registered polls.
+ */
+- (BOOL)hasSessionWithToken:(NSNumber *)token;
+
+
+///------------------------------------------------
+/// @name Routing
+///------------------------------------------------
+
+/**
+ @brief  Find session of the poll for which response has been sent.
+ 
+ @param message Reference on message received from attendee (dictionary or compact 
+                representation).
+ 
+ @return Registered session or \c nil in case if response has been sent for unknown poll.
+ */
+- (SPNPPollSession *)sessionForResponseMessage:(id)message;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,111 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPPollRegistry.h"
+#import "SPNPPollResponse.h"
+#import "SPNPPollSession.h"
+#import "SPNPPoll.h"
+
+
+#pragma mark Private interface declaration
+
+@interface SPNPPollRegistry ()
+
+
+#pragma mark - Properties
+
+/**
+ @brief  Stores reference on poll identifier to session map.
+ */
+@property (nonatomic, strong) NSMutableDictionary *sessionsByIdentifier;
+
+/**
+ @brief  Stores reference on short poll token to session map.
+ */
+@property (nonatomic, strong) NSMutableDictionary *sessionsByToken;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPPollRegistry
+
+
+#pragma mark - Information
+
+- (NSArray *)sessions {
+    
+    return self.sessionsByIdentifier.allValues;
+}
+
+
+#pragma mark - Initialization and Configuration
+
+- (instancetype)init {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _sessionsByIdentifier = [NSMutableDictionary new];
+        _sessionsByToken = [NSMutableDictionary new];
+    }
+    
+    return self;
+}
+
+
+#pragma mark - Sessions
+
+- (void)registerSession:(SPNPPollSession *)session {
+    
+    if (session.poll.identifier) {
+        
+        [self unregisterSessionForPoll:session.poll];
+        self.sessionsByIdentifier[session.poll.identifier] = session;
+        if (session.poll.token) { self.sessionsByToken[session.poll.token] = session; }
+    }
+}
+
+- (void)unregisterSessionForPoll:(SPNPPoll *)poll {
+    
+    SPNPPollSession *session = (poll.identifier ? self.sessionsByIdentifier[poll.identifier] : nil);
+    if (session) {
+        
+        [self.sessionsByIdentifier removeObjectForKey:poll.identifier];
+        if (session.poll.token && self.sessionsByToken[session.poll.token] == session) {
+            
+            [self.sessionsByToken removeObjectForKey:session.poll.token];
+        }
+    }
+}
+
+- (SPNPPollSession *)sessionForPollIdentifier:(NSString *)pollIdentifier {
+    
+    return (pollIdentifier ? self.sessionsByIdentifier[pollIdentifier] : nil);
+}
+
+- (BOOL)hasSessionWithToken:(NSNumber *)token {
+    
+    return (token && self.sessionsByToken[token] != nil);
+}
+
+
+#pragma mark - Routing
+
+- (SPNPPollSession *)sessionForResponseMessage:(id)message {
+    
+    id key = [SPNPPollResponse pollKeyFromMessage:message];
+    
+    return ([key isKindOfClass:NSNumber.class] ? self.sessionsByToken[key]
+                                               : [self sessionForPollIdentifier:key]);
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,182 @@
+#import <Foundation/Foundation.h>
+
+
+#pragma mark Class forward
+
+@class SPNPStatisticPublishScheduler, SPNPStatisticSnapshot, SPNPVoteAggregator, SPNPVoteTimeSeries;
+@class SPNPStatisticStore, SPNPRankedTally, SPNPRatingTally, SPNPTextTally, SPNPPoll;
+
+
+/**
+ @brief      Host side state of single poll which accept responses.
+ @discussion Each poll which is run by host concurrently has own votes aggregation engine, 
+             statistic and publish scheduler, so polls statistic published independently into 
+             poll's statistic channel.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPPollSession : NSObject
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on poll for which responses accepted.
+ */
+@property (nonatomic, readonly, strong) SPNPPoll *poll;
+
+/**
+ @brief  Stores reference on list of poll response variants statistic (sorted by response order).
+ */
+@property (nonatomic, readonly, strong) NSMutableArray *statistics;
+
+/**
+ @brief  Stores reference on engine which is used to count poll votes.
+ */
+@property (nonatomic, readonly, strong) SPNPVoteAggregator *voteAggregator;
+
+/**
+ @brief  Stores reference on per-response votes time series which is fed with aggregated votes.
+ */
+@property (nonatomic, readonly, strong) SPNPVoteTimeSeries *timeSeries;
+
+/**
+ @brief  Stores reference on scheduler which is used to refresh and publish poll statistic.
+ */
+@property (nonatomic, strong) SPNPStatisticPublishScheduler *publishScheduler;
+
+/**
+ @brief  Stores reference on name of channel into which poll statistic published.
+ */
+@property (nonatomic, readonly, copy) NSString *statisticsChannelName;
+
+/**
+ @brief      Stores reference on name of channel into which poll statistic changes published.
+ @discussion Channel receive keyframes and changes between them in format configured by host, while
+             \c statisticsChannelName receive only full JSON keyframes which can be handled by
+             attendees without changes support.
+ */
+@property (nonatomic, readonly, copy) NSString *statisticDeltasChannelName;
+
+/**
+ @brief  Stores sequence number of last published statistic update.
+ */
+@property (nonatomic, assign) unsigned long long statisticSequence;
+
+/**
+ @brief      Stores list of votes count which has been sent with last statistic update.
+ @discussion Used to compute changes which should be published. \c nil forces keyframe.
+ */
+@property (nonatomic, strong) NSArray *publishedVotesCount;
+
+/**
+ @brief      Stores list of sampled votes traces which should be sent with next statistic update.
+ @discussion Traces moved here from vote aggregator at the same time when votes which they describe
+             applied to statistic.
+ */
+@property (nonatomic, readonly, strong) NSMutableArray *pendingTraces;
+
+/**
+ @brief  Stores time (milliseconds since 1970) till which aggregated votes has been applied to
+         statistic.
+ */
+@property (nonatomic, strong) NSNumber *coveredTime;
+
+/**
+ @brief      Stores reference on contiguous store of votes count which has been aggregated by host.
+ @discussion Used to find responses which votes count has been changed w/o touching statistic of
+             others. Store should be reset (set to \c nil) each time when vote aggregator reset 
+             with new initial votes count.
+ */
+@property (nonatomic, strong) SPNPStatisticStore *statisticStore;
+
+/**
+ @brief      Stores reference on free-text responses counting engine.
+ @discussion Created only for open-text poll. Responses for such poll counted by tally instead of 
+             \c voteAggregator.
+ */
+@property (nonatomic, readonly, strong) SPNPTextTally *textTally;
+
+/**
+ @brief      Stores reference on ranked ballots counting engine.
+ @discussion Created only for ranked-choice poll. Ballots for such poll counted by tally instead of
+             \c voteAggregator.
+ */
+@property (nonatomic, readonly, strong) SPNPRankedTally *rankedTally;
+
+/**
+ @brief      Stores reference on numeric ratings counting engine.
+ @discussion Created only for rating poll. Ratings for such poll counted by tally instead of 
+             \c voteAggregator.
+ */
+@property (nonatomic, readonly, strong) SPNPRatingTally *ratingTally;
+
+/**
+ @brief  Stores maximum number of most frequent answers which published with open-text poll 
+         statistic.
+ */
+@property (nonatomic, readonly, assign) NSUInteger textStatisticTopCount;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure poll session.
+ 
+ @param poll                  Reference on poll for which responses should be accepted.
+ @param statistics            Reference on list into which poll statistic should be stored.
+ @param voteAggregator        Reference on engine which should be used to count poll votes.
+ @param statisticsChannelName Reference on name of channel into which poll statistic should be
+                              published (if poll doesn't specify own channel).
+ 
+ @return Configured and ready to use poll session.
+ */
++ (instancetype)sessionForPoll:(SPNPPoll *)poll withStatistics:(NSMutableArray *)statistics
+                voteAggregator:(SPNPVoteAggregator *)voteAggregator
+             statisticsChannel:(NSString *)statisticsChannelName;
+
+/**
+ @brief      Resolve name of channel into which poll statistic published.
+ @discussion Same rule used by host's session and by attendee, so attendee subscribe to channel into
+             which session publish statistic.
+ 
+ @param poll                  Reference on poll for which statistic channel should be found.
+ @param statisticsChannelName Reference on name of default poll statistic channel.
+ 
+ @return Statistic channel announced with poll or default channel.
+ */
++ (NSString *)statisticsChannelForPoll:(SPNPPoll *)poll
+                        defaultChannel:(NSString *)statisticsChannelName;
+
+/**
+ @brief  Compose name of channel into which statistic changes published.
+ 
+ @param statisticsChannelName Reference on name of channel into which full poll statistic 
+                              published.
+ 
+ @return Statistic changes channel name.
+ */
++ (NSString *)deltasChannelFor:(NSString *)statisticsChannelName;
+
+
+///------------------------------------------------
+/// @name Statistic
+///------------------------------------------------
+
+/**
+ @brief      Take immutable view on poll statistic.
+ @discussion Should be called on main thread. Returned snapshot can be used from any queue.
+ 
+ @return Reference on latest statistic snapshot (same instance while statistic doesn't change).
+ */
+- (SPNPStatisticSnapshot *)statisticSnapshot;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,157 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPPollSession.h"
+#import "SPNPStatisticSnapshot.h"
+#import "SPNPVoteTimeSeries.h"
+#import "SPNPRankedTally.h"
+#import "SPNPRatingTally.h"
+#import "SPNPTextTally.h"
+#import "SPNPPoll.h"
+
+
+#pragma mark Static
+
+/**
+ @brief      Stores maximum number of distinct answers which tracked by open-text poll tally.
+ @discussion Answers which has been mentioned at least N / capacity times (where N is number of 
+             counted responses) guaranteed to be tracked.
+ */
+static NSUInteger const kSPNPPollSessionTextTallyCapacity = 256;
+
+/**
+ @brief  Stores maximum number of most frequent answers which published with statistic.
+ */
+static NSUInteger const kSPNPPollSessionTextStatisticTopCount = 10;
+
+/**
+ @brief  Stores suffix which is added to statistic channel name to get statistic changes channel.
+ */
+static NSString * const kSPNPPollSessionDeltasChannelSuffix = @"-delta";
+
+
+#pragma mark - Private interface declaration
+
+@interface SPNPPollSession ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, strong) SPNPPoll *poll;
+@property (nonatomic, strong) NSMutableArray *statistics;
+@property (nonatomic, strong) SPNPVoteAggregator *voteAggregator;
+@property (nonatomic, strong) SPNPVoteTimeSeries *timeSeries;
+@property (nonatomic, strong) NSMutableArray *pendingTraces;
+@property (nonatomic, strong) SPNPTextTally *textTally;
+@property (nonatomic, strong) SPNPRankedTally *rankedTally;
+@property (nonatomic, strong) SPNPRatingTally *ratingTally;
+@property (nonatomic, copy) NSString *statisticsChannelName;
+@property (nonatomic, copy) NSString *statisticDeltasChannelName;
+
+/**
+ @brief  Stores reference on last taken statistic snapshot.
+ */
+@property (nonatomic, strong) SPNPStatisticSnapshot *lastStatisticSnapshot;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize poll session.
+ 
+ @param poll                  Reference on poll for which responses should be accepted.
+ @param statistics            Reference on list into which poll statistic should be stored.
+ @param voteAggregator        Reference on engine which should be used to count poll votes.
+ @param statisticsChannelName Reference on name of channel into which poll statistic should be
+                              published.
+ 
+ @return Initialized and ready to use poll session.
+ */
+- (instancetype)initForPoll:(SPNPPoll *)poll withStatistics:(NSMutableArray *)statistics
+             voteAggregator:(SPNPVoteAggregator *)voteAggregator
+          statisticsChannel:(NSString *)statisticsChannelName;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPPollSession
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)sessionForPoll:(SPNPPoll *)poll withStatistics:(NSMutableArray *)statistics
+                voteAggregator:(SPNPVoteAggregator *)voteAggregator
+             statisticsChannel:(NSString *)statisticsChannelName {
+    
+    return [[self alloc] initForPoll:poll withStatistics:statistics voteAggregator:voteAggregator
+                   statisticsChannel:statisticsChannelName];
+}
+
+- (instancetype)initForPoll:(SPNPPoll *)poll withStatistics:(NSMutableArray *)statistics
+             voteAggregator:(SPNPVoteAggregator *)voteAggregator
+          statisticsChannel:(NSString *)statisticsChannelName {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _poll = poll;
+        _statistics = statistics;
+        _voteAggregator = voteAggregator;
+        _timeSeries = [SPNPVoteTimeSeries seriesWithResponsesCount:poll.responses.count];
+        _statisticsChannelName = [[self.class statisticsChannelForPoll:poll
+                                                        defaultChannel:statisticsChannelName] copy];
+        _statisticDeltasChannelName = [self.class deltasChannelFor:_statisticsChannelName];
+        _pendingTraces = [NSMutableArray new];
+        if (poll.isOpenText) {
+            
+            _textTally = [SPNPTextTally tallyForPoll:poll
+                                            capacity:kSPNPPollSessionTextTallyCapacity];
+        }
+        else if (poll.isRanked) { _rankedTally = [SPNPRankedTally tallyForPoll:poll]; }
+        else if (poll.isRating) { _ratingTally = [SPNPRatingTally tallyForPoll:poll]; }
+    }
+    
+    return self;
+}
+
++ (NSString *)statisticsChannelForPoll:(SPNPPoll *)poll
+                        defaultChannel:(NSString *)statisticsChannelName {
+    
+    return (poll.statisticsChannel ?: statisticsChannelName);
+}
+
++ (NSString *)deltasChannelFor:(NSString *)statisticsChannelName {
+    
+    return [statisticsChannelName stringByAppendingString:kSPNPPollSessionDeltasChannelSuffix];
+}
+
+
+#pragma mark - Information
+
+- (NSUInteger)textStatisticTopCount {
+    
+    return kSPNPPollSessionTextStatisticTopCount;
+}
+
+
+#pragma mark - Statistic
+
+- (SPNPStatisticSnapshot *)statisticSnapshot {
+    
+    SPNPStatisticSnapshot *snapshot = self.lastStatisticSnapshot;
+    self.lastStatisticSnapshot = [SPNPStatisticSnapshot snapshotOfStatistics:self.statistics
+                                                            previousSnapshot:snapshot];
+    
+    return self.lastStatisticSnapshot;
+}
+
+#pragma mark -
+
+
+@end
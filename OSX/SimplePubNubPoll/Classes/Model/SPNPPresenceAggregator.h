@@ -0,0 +1,103 @@
+#import <Foundation/Foundation.h>
+
+
+/**
+ @brief      Aggregator of host channel presence events.
+ @discussion Aggregator handle both single presence events (join / leave / timeout) and interval
+             announcements (lists of attendees which joined / left since previous announcement).
+             Each event updates occupancy in constant time and joined attendees added to unique
+             attendees sketch, so memory usage doesn't depend from room size. Changes reported
+             with update block not more often than once per \c updateInterval.
+             Aggregator should be used from main thread.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPPresenceAggregator : NSObject
+
+
+///------------------------------------------------
+/// @name Configuration
+///------------------------------------------------
+
+/**
+ @brief  Stores minimum interval between update block calls (default value is \c 1 second).
+ */
+@property (nonatomic, assign) NSTimeInterval updateInterval;
+
+/**
+ @brief  Stores reference on identifier which shouldn't be counted as unique attendee (for example
+         host's own \c UUID).
+ */
+@property (nonatomic, copy) NSString *ignoredIdentifier;
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores latest number of channel subscribers.
+ */
+@property (nonatomic, readonly, assign) NSUInteger occupancy;
+
+/**
+ @brief  Stores estimated number of unique attendees which joined since last reset.
+ */
+@property (nonatomic, readonly, assign) unsigned long long uniqueAttendeesCount;
+
+/**
+ @brief  Stores number of presence events which has been handled by aggregator.
+ */
+@property (nonatomic, readonly, assign) NSUInteger eventsCount;
+
+/**
+ @brief  Stores number of times when update block has been called.
+ */
+@property (nonatomic, readonly, assign) NSUInteger updatesCount;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure presence aggregator.
+ 
+ @param block Reference on block which will be called on main queue with throttled changes. Block
+              pass two arguments: \c occupancy - number of channel subscribers; 
+              \c uniqueAttendeesCount - estimated number of unique attendees.
+ 
+ @return Configured and ready to use presence aggregator.
+ */
++ (instancetype)aggregatorWithUpdateBlock:(void(^)(NSUInteger occupancy,
+                                                   unsigned long long uniqueAttendeesCount))block;
+
+
+///------------------------------------------------
+/// @name Presence
+///------------------------------------------------
+
+/**
+ @brief  Handle presence event.
+ 
+ @param occupancy Number of channel subscribers reported with event.
+ @param joined    List of identifiers which joined channel (single identifier for join event).
+ @param left      List of identifiers which left channel or timed out.
+ */
+- (void)handleOccupancy:(NSUInteger)occupancy joined:(NSArray *)joined left:(NSArray *)left;
+
+/**
+ @brief  Forget unique attendees (for example when new poll announced).
+ */
+- (void)resetUniqueAttendees;
+
+/**
+ @brief  Call update block right away if there is pending changes.
+ */
+- (void)flush;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,185 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPPresenceAggregator.h"
+#import "SPNPHyperLogLog.h"
+#import "SPNPVoterIndex.h"
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores default minimum interval between update block calls.
+ */
+static NSTimeInterval const kSPNPPresenceDefaultUpdateInterval = 1.0f;
+
+
+#pragma mark - Private interface declaration
+
+@interface SPNPPresenceAggregator ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, assign) NSUInteger occupancy;
+@property (nonatomic, assign) NSUInteger eventsCount;
+@property (nonatomic, assign) NSUInteger updatesCount;
+
+/**
+ @brief  Stores reference on sketch which is used to estimate unique attendees count.
+ */
+@property (nonatomic, strong) SPNPHyperLogLog *uniqueAttendees;
+
+/**
+ @brief  Stores reference on block which should be called with throttled changes.
+ */
+@property (nonatomic, copy) void(^updateBlock)(NSUInteger occupancy,
+                                               unsigned long long uniqueAttendeesCount);
+
+/**
+ @brief  Stores time when update block has been called last time.
+ */
+@property (nonatomic, assign) NSTimeInterval updateTime;
+
+/**
+ @brief  Stores whether there is changes which hasn't been reported yet.
+ */
+@property (nonatomic, assign) BOOL hasPendingChanges;
+
+/**
+ @brief  Stores whether delayed update already scheduled or not.
+ */
+@property (nonatomic, assign, getter = isUpdateScheduled) BOOL updateScheduled;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize presence aggregator.
+ 
+ @param block Reference on block which will be called with throttled changes.
+ 
+ @return Initialized and ready to use presence aggregator.
+ */
+- (instancetype)initWithUpdateBlock:(void(^)(NSUInteger occupancy,
+                                             unsigned long long uniqueAttendeesCount))block;
+
+
+#pragma mark - Updates
+
+/**
+ @brief      Mark aggregated values as changed.
+ @discussion Update block called right away if last update has been done earlier than 
+             \c updateInterval, otherwise delayed update scheduled.
+ */
+- (void)setNeedsUpdate;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPPresenceAggregator
+
+
+#pragma mark - Information
+
+- (unsigned long long)uniqueAttendeesCount {
+    
+    return self.uniqueAttendees.estimatedCount;
+}
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)aggregatorWithUpdateBlock:(void(^)(NSUInteger occupancy,
+                                                   unsigned long long uniqueAttendeesCount))block {
+    
+    return [[self alloc] initWithUpdateBlock:block];
+}
+
+- (instancetype)initWithUpdateBlock:(void(^)(NSUInteger occupancy,
+                                             unsigned long long uniqueAttendeesCount))block {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _updateInterval = kSPNPPresenceDefaultUpdateInterval;
+        _uniqueAttendees = [SPNPHyperLogLog sketch];
+        _updateBlock = [block copy];
+    }
+    
+    return self;
+}
+
+
+#pragma mark - Presence
+
+- (void)handleOccupancy:(NSUInteger)occupancy joined:(NSArray *)joined left:(NSArray *)left {
+    
+    self.eventsCount++;
+    BOOL isChanged = (self.occupancy != occupancy);
+    self.occupancy = occupancy;
+    
+    // Left attendees already reflected by occupancy and stay counted as unique.
+    for (NSString *identifier in joined) {
+        
+        if ([identifier isKindOfClass:NSString.class] &&
+            ![identifier isEqualToString:self.ignoredIdentifier]) {
+            
+            isChanged = ([self.uniqueAttendees addKey:[SPNPVoterIndex keyForVoter:identifier]] ||
+                         isChanged);
+        }
+    }
+    
+    if (isChanged) { [self setNeedsUpdate]; }
+}
+
+- (void)resetUniqueAttendees {
+    
+    [self.uniqueAttendees reset];
+    [self setNeedsUpdate];
+}
+
+- (void)flush {
+    
+    if (self.hasPendingChanges) {
+        
+        self.hasPendingChanges = NO;
+        self.updateTime = [NSDate timeIntervalSinceReferenceDate];
+        self.updatesCount++;
+        if (self.updateBlock) { self.updateBlock(self.occupancy, self.uniqueAttendeesCount); }
+    }
+}
+
+
+#pragma mark - Updates
+
+- (void)setNeedsUpdate {
+    
+    self.hasPendingChanges = YES;
+    NSTimeInterval delay = (self.updateTime + self.updateInterval -
+                            [NSDate timeIntervalSinceReferenceDate]);
+    if (delay <= 0.0f) { [self flush]; }
+    else if (!self.isUpdateScheduled) {
+        
+        self.updateScheduled = YES;
+        __weak __typeof(self) weakSelf = self;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)),
+                       dispatch_get_main_queue(), ^{
+            
+            __strong __typeof(self) strongSelf = weakSelf;
+            strongSelf.updateScheduled = NO;
+            [strongSelf flush];
+        });
+    }
+}
+
+#pragma mark -
+
+
+@end
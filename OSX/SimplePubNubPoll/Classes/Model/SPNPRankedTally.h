@@ -0,0 +1,112 @@
+#import <Foundation/Foundation.h>
+
+
+#pragma mark Class forward
+
+@class SPNPPollRankedStatistic, SPNPPoll;
+
+
+/**
+ @brief      Host side ranked ballots counting engine (instant-runoff).
+ @discussion Identical rankings grouped into counted buckets, so each ballot only increment bucket
+             counter and first preferences tally. Runoff rounds computed over buckets (not 
+             ballots) and only when new ballots has been counted since last computation, so
+             publish cost depends from number of distinct rankings and doesn't grow with number of
+             ballots.
+             Tally should be used from main thread.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPRankedTally : NSObject
+
+
+///------------------------------------------------
+/// @name Configuration
+///------------------------------------------------
+
+/**
+ @brief  Stores whether attendee's next ballot should replace previous one or should be dropped 
+         (default value is \c NO).
+ */
+@property (nonatomic, assign) BOOL allowsBallotChange;
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on ranked-choice poll for which ballots counted.
+ */
+@property (nonatomic, readonly, strong) SPNPPoll *poll;
+
+/**
+ @brief  Stores number of ballots which has been counted.
+ */
+@property (nonatomic, readonly, assign) unsigned long long ballotsCount;
+
+/**
+ @brief      Stores number of ballots which has been dropped.
+ @discussion Ballot dropped if it has been sent for different poll, attendee already voted or
+             ranking contains unknown response order numbers.
+ */
+@property (nonatomic, readonly, assign) unsigned long long droppedBallotsCount;
+
+/**
+ @brief  Stores number of distinct rankings which has been received.
+ */
+@property (nonatomic, readonly, assign) NSUInteger bucketsCount;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure ranked ballots tally.
+ 
+ @param poll Reference on ranked-choice poll for which ballots should be counted.
+ 
+ @return Configured and ready to use tally.
+ */
++ (instancetype)tallyForPoll:(SPNPPoll *)poll;
+
+
+///------------------------------------------------
+/// @name Counting
+///------------------------------------------------
+
+/**
+ @brief      Count attendee's ballot.
+ @discussion Ballots de-duplicated using \c voter (identifier from message payload ignored), so
+             ballots without voter dropped.
+ 
+ @param message Reference on received message with \b SPNPPollRankedResponse.
+ @param voter   Reference on identifier of message publisher reported by transport.
+ 
+ @return \c YES in case if ballot has been counted.
+ */
+- (BOOL)registerBallotFromMessage:(id)message fromVoter:(NSString *)voter;
+
+/**
+ @brief  Check whether ballots has been counted since last call.
+ 
+ @return \c YES in case if statistic should be published.
+ */
+- (BOOL)hasBallotsSinceLastCheck;
+
+/**
+ @brief      Build statistic with standings of each runoff round.
+ @discussion Rounds recomputed only if ballots has been counted since previous call.
+ 
+ @param sequence Reference on statistic stream sequence number.
+ 
+ @return Configured and ready to publish statistic.
+ */
+- (SPNPPollRankedStatistic *)statisticWithSequence:(NSNumber *)sequence;
+
+#pragma mark -
+
+
+@end
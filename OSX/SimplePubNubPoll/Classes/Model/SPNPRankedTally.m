@@ -0,0 +1,412 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPRankedTally.h"
+#import "SPNPRankedRoundStatistic.h"
+#import "SPNPPollRankedStatistic.h"
+#import "SPNPPollRankedResponse.h"
+#import "SPNPVoterIndex.h"
+#import "SPNPPoll.h"
+
+
+#pragma mark Types
+
+/**
+ @brief  Describes group of identical ballots.
+ */
+@interface SPNPRankedBallotBucket : NSObject
+
+
+#pragma mark - Properties
+
+/**
+ @brief  Stores reference on ranked response order numbers (\c uint32_t from most preferred).
+ */
+@property (nonatomic, copy) NSData *ranking;
+@property (nonatomic, assign) unsigned long long count;
+
+/**
+ @brief  Stores index of ranking entry for which bucket counted in currently computed round.
+ */
+@property (nonatomic, assign) NSUInteger position;
+
+#pragma mark -
+
+
+@end
+
+
+@implementation SPNPRankedBallotBucket
+@end
+
+
+#pragma mark - Private interface declaration
+
+@interface SPNPRankedTally ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, strong) SPNPPoll *poll;
+@property (nonatomic, assign) unsigned long long ballotsCount;
+@property (nonatomic, assign) unsigned long long droppedBallotsCount;
+
+/**
+ @brief  Stores reference on list of ballot buckets (bucket index stored in voters index).
+ */
+@property (nonatomic, strong) NSMutableArray *buckets;
+
+/**
+ @brief  Stores reference on bucket indices stored by their ranking.
+ */
+@property (nonatomic, strong) NSMutableDictionary *bucketIndexes;
+
+/**
+ @brief  Stores reference on number of ballots for which response is most preferred (by order).
+ */
+@property (nonatomic, assign) unsigned long long *firstPreferences;
+
+/**
+ @brief  Stores reference on index of attendees ballots bucket.
+ */
+@property (nonatomic, strong) SPNPVoterIndex *voters;
+
+/**
+ @brief  Stores whether ballots has been counted since last check.
+ */
+@property (nonatomic, assign) BOOL hasBallots;
+
+/**
+ @brief  Stores whether ballots has been counted since rounds has been computed.
+ */
+@property (nonatomic, assign) BOOL needsRounds;
+
+/**
+ @brief  Stores reference on list of computed \b SPNPRankedRoundStatistic instances.
+ */
+@property (nonatomic, copy) NSArray *rounds;
+
+/**
+ @brief  Stores reference on order number of response which won in last computed round.
+ */
+@property (nonatomic, strong) NSNumber *winner;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize ranked ballots tally.
+ 
+ @param poll Reference on ranked-choice poll for which ballots should be counted.
+ 
+ @return Initialized and ready to use tally.
+ */
+- (instancetype)initForPoll:(SPNPPoll *)poll;
+
+
+#pragma mark - Counting
+
+/**
+ @brief  Validate ballot ranking.
+ 
+ @param ranking Reference on list of response order numbers received from attendee.
+ 
+ @return Packed unique response order numbers or \c nil in case if ranking is empty or contains
+         unknown order numbers.
+ */
+- (NSData *)packedRanking:(NSArray *)ranking;
+
+/**
+ @brief  Change number of ballots in bucket.
+ 
+ @param bucket Reference on bucket which votes count should be changed.
+ @param change Number of ballots which should be added (or removed) to the bucket.
+ */
+- (void)changeBucket:(SPNPRankedBallotBucket *)bucket by:(long long)change;
+
+
+#pragma mark - Rounds
+
+/**
+ @brief  Compute instant-runoff rounds from ballot buckets.
+ */
+- (void)updateRounds;
+
+/**
+ @brief      Choose responses which should be eliminated at the end of round.
+ @discussion All responses w/o votes eliminated at once. Otherwise response with least votes is 
+             eliminated (ties broken by first preferences and by order number).
+ 
+ @param tallies      Reference on votes count of each response in current round.
+ @param isEliminated Reference on list of flags for responses eliminated in previous rounds.
+ 
+ @return List of response order numbers.
+ */
+- (NSArray *)eliminatedWithTallies:(const unsigned long long *)tallies
+                      isEliminated:(const BOOL *)isEliminated;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPRankedTally
+
+
+#pragma mark - Information
+
+- (NSUInteger)bucketsCount {
+    
+    return self.buckets.count;
+}
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)tallyForPoll:(SPNPPoll *)poll {
+    
+    return [[self alloc] initForPoll:poll];
+}
+
+- (instancetype)initForPoll:(SPNPPoll *)poll {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _poll = poll;
+        _buckets = [NSMutableArray new];
+        _bucketIndexes = [NSMutableDictionary new];
+        _firstPreferences = calloc(MAX(poll.responses.count, (NSUInteger)1),
+                                   sizeof(unsigned long long));
+        _voters = [SPNPVoterIndex indexWithMaximumCount:kSPNPVoterIndexMaximumVotersCount];
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    
+    free(_firstPreferences);
+}
+
+
+#pragma mark - Counting
+
+- (BOOL)registerBallotFromMessage:(id)message fromVoter:(NSString *)voter {
+    
+    SPNPPoll *poll = self.poll;
+    SPNPPollRankedResponse *response = [SPNPPollRankedResponse objectFromMessage:message
+                                                                         forPoll:poll.identifier
+                                                                           token:poll.token];
+    NSData *ranking = [self packedRanking:response.ranking];
+    BOOL isCounted = (ranking && [voter isKindOfClass:NSString.class] &&
+                      [poll.identifier isEqual:response.pollIdentifier]);
+    NSNumber *bucketIndex = (isCounted ? self.bucketIndexes[ranking] : nil);
+    
+    // Index of bucket which doesn't exist yet registered for voter, so bucket created only for
+    // counted ballots.
+    NSUInteger bucketIdx = (bucketIndex ? bucketIndex.unsignedIntegerValue : self.buckets.count);
+    NSUInteger previousBucketIdx = NSNotFound;
+    if (isCounted) {
+        
+        previousBucketIdx = [self.voters registerChoice:bucketIdx forVoter:voter
+                                      replacingExisting:self.allowsBallotChange];
+        isCounted = (previousBucketIdx == NSNotFound ||
+                     (self.allowsBallotChange && previousBucketIdx != kSPNPVoterIndexFull &&
+                      previousBucketIdx != bucketIdx));
+    }
+    if (isCounted) {
+        
+        if (!bucketIndex) {
+            
+            SPNPRankedBallotBucket *bucket = [SPNPRankedBallotBucket new];
+            bucket.ranking = ranking;
+            [self.buckets addObject:bucket];
+            self.bucketIndexes[ranking] = @(bucketIdx);
+        }
+        [self changeBucket:self.buckets[bucketIdx] by:1];
+        if (previousBucketIdx != NSNotFound) {
+            
+            [self changeBucket:self.buckets[previousBucketIdx] by:-1];
+        }
+        else { self.ballotsCount++; }
+        self.hasBallots = YES;
+        self.needsRounds = YES;
+    }
+    else { self.droppedBallotsCount++; }
+    
+    return isCounted;
+}
+
+- (NSData *)packedRanking:(NSArray *)ranking {
+    
+    if (![ranking isKindOfClass:NSArray.class]) { return nil; }
+    
+    NSUInteger responsesCount = self.poll.responses.count;
+    NSUInteger capacity = (MIN(ranking.count, responsesCount) * sizeof(uint32_t));
+    NSMutableData *packedRanking = [NSMutableData dataWithCapacity:capacity];
+    NSMutableIndexSet *rankedOrders = [NSMutableIndexSet new];
+    for (NSNumber *order in ranking) {
+        
+        if (![order isKindOfClass:NSNumber.class] || order.unsignedIntegerValue >= responsesCount) {
+            
+            return nil;
+        }
+        if (![rankedOrders containsIndex:order.unsignedIntegerValue]) {
+            
+            uint32_t packedOrder = (uint32_t)order.unsignedIntegerValue;
+            [rankedOrders addIndex:order.unsignedIntegerValue];
+            [packedRanking appendBytes:&packedOrder length:sizeof(uint32_t)];
+        }
+    }
+    
+    return (packedRanking.length ? [packedRanking copy] : nil);
+}
+
+- (void)changeBucket:(SPNPRankedBallotBucket *)bucket by:(long long)change {
+    
+    uint32_t firstOrder = ((const uint32_t *)bucket.ranking.bytes)[0];
+    unsigned long long *firstPreferences = self.firstPreferences;
+    bucket.count = (unsigned long long)((long long)bucket.count + change);
+    firstPreferences[firstOrder] = (unsigned long long)((long long)firstPreferences[firstOrder] +
+                                                        change);
+}
+
+- (BOOL)hasBallotsSinceLastCheck {
+    
+    BOOL hasBallots = self.hasBallots;
+    self.hasBallots = NO;
+    
+    return hasBallots;
+}
+
+- (SPNPPollRankedStatistic *)statisticWithSequence:(NSNumber *)sequence {
+    
+    if (self.needsRounds) {
+        
+        [self updateRounds];
+        self.needsRounds = NO;
+    }
+    
+    return [SPNPPollRankedStatistic statisticForPoll:self.poll.identifier withRounds:self.rounds
+                                              winner:self.winner sequence:sequence
+                                        ballotsCount:self.ballotsCount];
+}
+
+
+#pragma mark - Rounds
+
+- (void)updateRounds {
+    
+    // First round tallies maintained while ballots counted, so only buckets of eliminated
+    // responses touched in following rounds.
+    NSUInteger responsesCount = self.poll.responses.count;
+    NSUInteger tableSize = MAX(responsesCount, (NSUInteger)1);
+    unsigned long long *tallies = calloc(tableSize, sizeof(unsigned long long));
+    BOOL *isEliminated = calloc(tableSize, sizeof(BOOL));
+    memcpy(tallies, self.firstPreferences, responsesCount * sizeof(unsigned long long));
+    NSMutableArray *responseBuckets = [NSMutableArray arrayWithCapacity:responsesCount];
+    for (NSUInteger responseIdx = 0; responseIdx < responsesCount; responseIdx++) {
+        
+        [responseBuckets addObject:[NSMutableArray new]];
+    }
+    for (SPNPRankedBallotBucket *bucket in self.buckets) {
+        
+        if (bucket.count) {
+            
+            bucket.position = 0;
+            [responseBuckets[((const uint32_t *)bucket.ranking.bytes)[0]] addObject:bucket];
+        }
+    }
+    
+    NSMutableArray *rounds = [NSMutableArray new];
+    NSNumber *winner = nil;
+    NSUInteger continuingCount = responsesCount;
+    unsigned long long exhaustedCount = 0;
+    while (exhaustedCount < self.ballotsCount) {
+        
+        NSMutableArray *standings = [NSMutableArray arrayWithCapacity:(continuingCount * 2)];
+        NSUInteger leader = NSNotFound;
+        for (NSUInteger order = 0; order < responsesCount; order++) {
+            
+            if (!isEliminated[order]) {
+                
+                [standings addObjectsFromArray:@[@(order), @(tallies[order])]];
+                if (leader == NSNotFound || tallies[order] > tallies[leader]) { leader = order; }
+            }
+        }
+        
+        // Round won by response with majority of continuing ballots.
+        if (tallies[leader] * 2 > self.ballotsCount - exhaustedCount || continuingCount <= 1) {
+            
+            [rounds addObject:[SPNPRankedRoundStatistic roundWithStandings:standings eliminated:@[]
+                                                            exhaustedCount:exhaustedCount]];
+            winner = @(leader);
+            break;
+        }
+        
+        NSArray *eliminated = [self eliminatedWithTallies:tallies isEliminated:isEliminated];
+        [rounds addObject:[SPNPRankedRoundStatistic roundWithStandings:standings
+                                                            eliminated:eliminated
+                                                        exhaustedCount:exhaustedCount]];
+        for (NSNumber *order in eliminated) { isEliminated[order.unsignedIntegerValue] = YES; }
+        continuingCount -= eliminated.count;
+        
+        // Ballots transferred to next continuing preference (responses eliminated in same round
+        // skipped).
+        for (NSNumber *order in eliminated) {
+            
+            for (SPNPRankedBallotBucket *bucket in responseBuckets[order.unsignedIntegerValue]) {
+                
+                const uint32_t *ranking = bucket.ranking.bytes;
+                NSUInteger length = bucket.ranking.length / sizeof(uint32_t);
+                NSUInteger position = bucket.position + 1;
+                while (position < length && isEliminated[ranking[position]]) { position++; }
+                bucket.position = position;
+                if (position < length) {
+                    
+                    tallies[ranking[position]] += bucket.count;
+                    [responseBuckets[ranking[position]] addObject:bucket];
+                }
+                else { exhaustedCount += bucket.count; }
+            }
+            tallies[order.unsignedIntegerValue] = 0;
+            [responseBuckets[order.unsignedIntegerValue] removeAllObjects];
+        }
+    }
+    free(tallies);
+    free(isEliminated);
+    
+    self.rounds = rounds;
+    self.winner = winner;
+}
+
+- (NSArray *)eliminatedWithTallies:(const unsigned long long *)tallies
+                      isEliminated:(const BOOL *)isEliminated {
+    
+    NSUInteger responsesCount = self.poll.responses.count;
+    NSMutableArray *eliminated = [NSMutableArray new];
+    NSUInteger loser = NSNotFound;
+    for (NSUInteger order = 0; order < responsesCount; order++) {
+        
+        if (isEliminated[order]) { continue; }
+        if (tallies[order] == 0) { [eliminated addObject:@(order)]; }
+        else if (loser == NSNotFound || tallies[order] < tallies[loser] ||
+                 (tallies[order] == tallies[loser] &&
+                  self.firstPreferences[order] <= self.firstPreferences[loser])) {
+            
+            loser = order;
+        }
+    }
+    
+    return (eliminated.count || loser == NSNotFound ? eliminated : @[@(loser)]);
+}
+
+#pragma mark -
+
+
+@end
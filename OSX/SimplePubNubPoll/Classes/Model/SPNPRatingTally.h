@@ -0,0 +1,105 @@
+#import <Foundation/Foundation.h>
+
+
+#pragma mark Class forward
+
+@class SPNPPollRatingStatistic, SPNPRatingAccumulator, SPNPPoll;
+
+
+/**
+ @brief      Host side numeric ratings counting engine.
+ @discussion Each rating update streaming aggregates (see \b SPNPRatingAccumulator) in constant 
+             time, so memory used by tally doesn't depend from number of ratings (except index of
+             attendees which already responded).
+             Tally should be used from main thread.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPRatingTally : NSObject
+
+
+///------------------------------------------------
+/// @name Configuration
+///------------------------------------------------
+
+/**
+ @brief  Stores whether attendee's next rating should replace previous one or should be dropped 
+         (default value is \c NO).
+ */
+@property (nonatomic, assign) BOOL allowsRatingChange;
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on rating poll for which ratings counted.
+ */
+@property (nonatomic, readonly, strong) SPNPPoll *poll;
+
+/**
+ @brief  Stores reference on accumulator with counted ratings.
+ */
+@property (nonatomic, readonly, strong) SPNPRatingAccumulator *accumulator;
+
+/**
+ @brief      Stores number of ratings which has been dropped.
+ @discussion Rating dropped if it has been sent for different poll, attendee already responded or
+             value is outside of poll's rating scale.
+ */
+@property (nonatomic, readonly, assign) unsigned long long droppedRatingsCount;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure ratings tally.
+ 
+ @param poll Reference on rating poll for which ratings should be counted.
+ 
+ @return Configured and ready to use tally.
+ */
++ (instancetype)tallyForPoll:(SPNPPoll *)poll;
+
+
+///------------------------------------------------
+/// @name Counting
+///------------------------------------------------
+
+/**
+ @brief      Count attendee's rating.
+ @discussion Ratings de-duplicated using \c voter (identifier from message payload ignored), so
+             ratings without voter dropped.
+ 
+ @param message Reference on received message with \b SPNPPollRatingResponse.
+ @param voter   Reference on identifier of message publisher reported by transport.
+ 
+ @return \c YES in case if rating has been counted.
+ */
+- (BOOL)registerRatingFromMessage:(id)message fromVoter:(NSString *)voter;
+
+/**
+ @brief  Check whether ratings has been counted since last call.
+ 
+ @return \c YES in case if statistic should be published.
+ */
+- (BOOL)hasRatingsSinceLastCheck;
+
+/**
+ @brief  Build statistic from aggregated ratings.
+ 
+ @param node     Identifier of host node which counted ratings (\c nil for single host).
+ @param sequence Reference on statistic stream sequence number.
+ 
+ @return Configured and ready to publish statistic.
+ */
+- (SPNPPollRatingStatistic *)statisticForNode:(NSString *)node sequence:(NSNumber *)sequence;
+
+#pragma mark -
+
+
+@end
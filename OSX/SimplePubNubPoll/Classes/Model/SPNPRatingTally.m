@@ -0,0 +1,139 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPRatingTally.h"
+#import "SPNPPollRatingStatistic.h"
+#import "SPNPPollRatingResponse.h"
+#import "SPNPRatingAccumulator.h"
+#import "SPNPVoterIndex.h"
+#import "SPNPPoll.h"
+
+
+#pragma mark Private interface declaration
+
+@interface SPNPRatingTally ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, strong) SPNPPoll *poll;
+@property (nonatomic, strong) SPNPRatingAccumulator *accumulator;
+@property (nonatomic, assign) unsigned long long droppedRatingsCount;
+
+/**
+ @brief  Stores reference on index of attendees ratings (offset from lowest value on scale).
+ */
+@property (nonatomic, strong) SPNPVoterIndex *voters;
+
+/**
+ @brief  Stores whether ratings has been counted since last check.
+ */
+@property (nonatomic, assign) BOOL hasRatings;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize ratings tally.
+ 
+ @param poll Reference on rating poll for which ratings should be counted.
+ 
+ @return Initialized and ready to use tally.
+ */
+- (instancetype)initForPoll:(SPNPPoll *)poll;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPRatingTally
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)tallyForPoll:(SPNPPoll *)poll {
+    
+    return [[self alloc] initForPoll:poll];
+}
+
+- (instancetype)initForPoll:(SPNPPoll *)poll {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        NSInteger minimumRating = poll.minimumRating.integerValue;
+        NSInteger maximumRating = poll.maximumRating.integerValue;
+        _poll = poll;
+        _accumulator = [SPNPRatingAccumulator accumulatorWithMinimumValue:minimumRating
+                                                             maximumValue:maximumRating];
+        _voters = [SPNPVoterIndex indexWithMaximumCount:kSPNPVoterIndexMaximumVotersCount];
+    }
+    
+    return self;
+}
+
+
+#pragma mark - Counting
+
+- (BOOL)registerRatingFromMessage:(id)message fromVoter:(NSString *)voter {
+    
+    SPNPPoll *poll = self.poll;
+    SPNPPollRatingResponse *response = [SPNPPollRatingResponse objectFromMessage:message
+                                                                         forPoll:poll.identifier
+                                                                           token:poll.token];
+    NSNumber *rating = ([response.rating isKindOfClass:NSNumber.class] ? response.rating : nil);
+    NSInteger value = rating.integerValue;
+    BOOL isCounted = (rating && [voter isKindOfClass:NSString.class] &&
+                      [poll.identifier isEqual:response.pollIdentifier] &&
+                      value >= poll.minimumRating.integerValue &&
+                      value <= poll.maximumRating.integerValue);
+    
+    // Voter index store offset from lowest value, so changed rating can be removed from aggregates.
+    NSUInteger offset = (NSUInteger)(value - poll.minimumRating.integerValue);
+    NSUInteger previousOffset = NSNotFound;
+    if (isCounted) {
+        
+        previousOffset = [self.voters registerChoice:offset forVoter:voter
+                                   replacingExisting:self.allowsRatingChange];
+        isCounted = (previousOffset == NSNotFound ||
+                     (self.allowsRatingChange && previousOffset != kSPNPVoterIndexFull &&
+                      previousOffset != offset));
+    }
+    if (isCounted) {
+        
+        if (previousOffset != NSNotFound) {
+            
+            NSInteger previousValue = (poll.minimumRating.integerValue + (NSInteger)previousOffset);
+            [self.accumulator removeValue:(double)previousValue];
+        }
+        [self.accumulator addValue:(double)value];
+        self.hasRatings = YES;
+    }
+    else { self.droppedRatingsCount++; }
+    
+    return isCounted;
+}
+
+- (BOOL)hasRatingsSinceLastCheck {
+    
+    BOOL hasRatings = self.hasRatings;
+    self.hasRatings = NO;
+    
+    return hasRatings;
+}
+
+- (SPNPPollRatingStatistic *)statisticForNode:(NSString *)node sequence:(NSNumber *)sequence {
+    
+    return [SPNPPollRatingStatistic statisticForPoll:self.poll.identifier
+                                     withAccumulator:self.accumulator node:node sequence:sequence];
+}
+
+#pragma mark -
+
+
+@end
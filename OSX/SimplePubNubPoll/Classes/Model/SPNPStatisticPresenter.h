@@ -0,0 +1,135 @@
+#import <Foundation/Foundation.h>
+
+
+/**
+ @brief      Platform independent model of poll statistic chart.
+ @discussion Presenter sits between poll manager and chart views: statistic updates coalesced, so
+             views updated not more often than \c maximumFrameRate times per second regardless of
+             how often statistic changes. Chart scale and bar percents computed in single pass
+             and views receive indices of bars which presented value really changed, so unchanged
+             bars doesn't get layout or animation updates.
+             Presenter should be used from main thread.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPStatisticPresenter : NSObject
+
+
+///------------------------------------------------
+/// @name Configuration
+///------------------------------------------------
+
+/**
+ @brief  Stores maximum number of times per second when update block can be called (default value
+         is \c 30).
+ */
+@property (nonatomic, assign) NSUInteger maximumFrameRate;
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores number of bars which is presented at this moment.
+ */
+@property (nonatomic, readonly, assign) NSUInteger barsCount;
+
+/**
+ @brief  Stores chart scale (largest votes count among presented bars).
+ */
+@property (nonatomic, readonly, assign) unsigned long long scale;
+
+/**
+ @brief  Stores number of times when update block has been called.
+ */
+@property (nonatomic, readonly, assign) NSUInteger updatesCount;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure statistic presenter.
+ 
+ @param block Reference on block which will be called on main queue with coalesced changes. Block
+              pass two arguments: \c changedBars - indices of bars which should be updated;
+              \c isInitial - whether bars layout has been changed (first update or different
+              number of bars) and all bars should be updated w/o animation.
+ 
+ @return Configured and ready to use statistic presenter.
+ */
++ (instancetype)presenterWithUpdateBlock:(void(^)(NSIndexSet *changedBars, BOOL isInitial))block;
+
+
+///------------------------------------------------
+/// @name Updates
+///------------------------------------------------
+
+/**
+ @brief      Schedule presentation of poll statistic.
+ @discussion Only latest statistic passed before next frame will be presented.
+ 
+ @param statistics Reference on list of \b SPNPPollResponseStatistic instances (sorted by response
+                   order).
+ */
+- (void)updateWithStatistics:(NSArray *)statistics;
+
+/**
+ @brief      Schedule presentation of votes count.
+ @discussion Only latest votes count passed before next frame will be presented.
+ 
+ @param votesCount List of votes count for each bar.
+ */
+- (void)updateWithVotesCount:(NSArray *)votesCount;
+
+/**
+ @brief  Call update block right away if there is pending votes count.
+ */
+- (void)flush;
+
+/**
+ @brief  Forget presented values, so next update will be reported as initial.
+ */
+- (void)reset;
+
+
+///------------------------------------------------
+/// @name Diff
+///------------------------------------------------
+
+/**
+ @brief      Replace presented values with new votes count.
+ @discussion Method doesn't depend from time or main queue and doesn't call update block.
+ 
+ @param votesCount List of votes count for each bar.
+ 
+ @return Indices of bars which presented votes count or percent has been changed (all bars in case
+         if number of bars changed).
+ */
+- (NSIndexSet *)applyVotesCount:(NSArray *)votesCount;
+
+/**
+ @brief  Retrieve presented bar votes count.
+ 
+ @param barIdx Index of bar for which value should be retrieved.
+ 
+ @return Bar votes count or \c 0 if there is no such bar.
+ */
+- (unsigned long long)votesCountForBar:(NSUInteger)barIdx;
+
+/**
+ @brief  Retrieve presented bar height relative to chart scale.
+ 
+ @param barIdx Index of bar for which value should be retrieved.
+ 
+ @return Value from \c 0 to \c 1.
+ */
+- (double)percentForBar:(NSUInteger)barIdx;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,239 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPStatisticPresenter.h"
+#import "SPNPPollResponseStatistic.h"
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores default maximum number of update block calls per second.
+ */
+static NSUInteger const kSPNPStatisticPresenterDefaultFrameRate = 30;
+
+
+#pragma mark - Private interface declaration
+
+@interface SPNPStatisticPresenter ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, assign) NSUInteger barsCount;
+@property (nonatomic, assign) unsigned long long scale;
+@property (nonatomic, assign) NSUInteger updatesCount;
+
+/**
+ @brief  Stores reference on presented votes count of each bar.
+ */
+@property (nonatomic, assign) unsigned long long *votesCounts;
+
+/**
+ @brief  Stores reference on presented percent of each bar.
+ */
+@property (nonatomic, assign) double *percents;
+
+/**
+ @brief  Stores reference on latest votes count which hasn't been presented yet.
+ */
+@property (nonatomic, strong) NSArray *pendingVotesCount;
+
+/**
+ @brief  Stores whether bars layout has been changed since last update block call.
+ */
+@property (nonatomic, assign) BOOL needsLayout;
+
+/**
+ @brief  Stores reference on block which should be called with coalesced changes.
+ */
+@property (nonatomic, copy) void(^updateBlock)(NSIndexSet *changedBars, BOOL isInitial);
+
+/**
+ @brief  Stores time when update block has been called last time.
+ */
+@property (nonatomic, assign) NSTimeInterval updateTime;
+
+/**
+ @brief  Stores whether delayed update already scheduled or not.
+ */
+@property (nonatomic, assign, getter = isUpdateScheduled) BOOL updateScheduled;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize statistic presenter.
+ 
+ @param block Reference on block which will be called with coalesced changes.
+ 
+ @return Initialized and ready to use statistic presenter.
+ */
+- (instancetype)initWithUpdateBlock:(void(^)(NSIndexSet *changedBars, BOOL isInitial))block;
+
+
+#pragma mark - Updates
+
+/**
+ @brief      Mark pending votes count as changed.
+ @discussion Update block called right away if last update has been done earlier than frame
+             duration, otherwise delayed update scheduled.
+ */
+- (void)setNeedsUpdate;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPStatisticPresenter
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)presenterWithUpdateBlock:(void(^)(NSIndexSet *changedBars, BOOL isInitial))block {
+    
+    return [[self alloc] initWithUpdateBlock:block];
+}
+
+- (instancetype)initWithUpdateBlock:(void(^)(NSIndexSet *changedBars, BOOL isInitial))block {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _maximumFrameRate = kSPNPStatisticPresenterDefaultFrameRate;
+        _needsLayout = YES;
+        _updateBlock = [block copy];
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    
+    free(_votesCounts);
+    free(_percents);
+}
+
+
+#pragma mark - Updates
+
+- (void)updateWithStatistics:(NSArray *)statistics {
+    
+    NSMutableArray *votesCount = [NSMutableArray arrayWithCapacity:statistics.count];
+    for (SPNPPollResponseStatistic *statistic in statistics) {
+        
+        [votesCount addObject:(statistic.votesCount ?: @0)];
+    }
+    [self updateWithVotesCount:votesCount];
+}
+
+- (void)updateWithVotesCount:(NSArray *)votesCount {
+    
+    self.pendingVotesCount = votesCount;
+    [self setNeedsUpdate];
+}
+
+- (void)flush {
+    
+    if (self.pendingVotesCount) {
+        
+        NSIndexSet *changedBars = [self applyVotesCount:self.pendingVotesCount];
+        self.pendingVotesCount = nil;
+        BOOL isInitial = self.needsLayout;
+        self.needsLayout = NO;
+        if (changedBars.count || isInitial) {
+            
+            self.updateTime = [NSDate timeIntervalSinceReferenceDate];
+            self.updatesCount++;
+            if (self.updateBlock) { self.updateBlock(changedBars, isInitial); }
+        }
+    }
+}
+
+- (void)reset {
+    
+    free(self.votesCounts);
+    free(self.percents);
+    self.votesCounts = NULL;
+    self.percents = NULL;
+    self.barsCount = 0;
+    self.scale = 0;
+    self.needsLayout = YES;
+}
+
+- (void)setNeedsUpdate {
+    
+    NSTimeInterval frameDuration = (1.0f / MAX(self.maximumFrameRate, (NSUInteger)1));
+    NSTimeInterval delay = (self.updateTime + frameDuration -
+                            [NSDate timeIntervalSinceReferenceDate]);
+    if (delay <= 0.0f) { [self flush]; }
+    else if (!self.isUpdateScheduled) {
+        
+        self.updateScheduled = YES;
+        __weak __typeof(self) weakSelf = self;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)),
+                       dispatch_get_main_queue(), ^{
+            
+            __strong __typeof(self) strongSelf = weakSelf;
+            strongSelf.updateScheduled = NO;
+            [strongSelf flush];
+        });
+    }
+}
+
+
+#pragma mark - Diff
+
+- (NSIndexSet *)applyVotesCount:(NSArray *)votesCount {
+    
+    NSUInteger barsCount = votesCount.count;
+    NSMutableIndexSet *changedBars = [NSMutableIndexSet new];
+    if (barsCount != self.barsCount) {
+        
+        [self reset];
+        self.votesCounts = calloc(MAX(barsCount, 1), sizeof(unsigned long long));
+        self.percents = calloc(MAX(barsCount, 1), sizeof(double));
+        self.barsCount = barsCount;
+        [changedBars addIndexesInRange:NSMakeRange(0, barsCount)];
+    }
+    
+    unsigned long long scale = 0;
+    for (NSNumber *barVotesCount in votesCount) {
+        
+        scale = MAX(scale, barVotesCount.unsignedLongLongValue);
+    }
+    self.scale = scale;
+    for (NSUInteger barIdx = 0; barIdx < barsCount; barIdx++) {
+        
+        unsigned long long barVotesCount = [votesCount[barIdx] unsignedLongLongValue];
+        double percent = (scale ? (double)barVotesCount / (double)scale : 0.0f);
+        if (barVotesCount != self.votesCounts[barIdx] || percent != self.percents[barIdx]) {
+            
+            self.votesCounts[barIdx] = barVotesCount;
+            self.percents[barIdx] = percent;
+            [changedBars addIndex:barIdx];
+        }
+    }
+    
+    return changedBars;
+}
+
+- (unsigned long long)votesCountForBar:(NSUInteger)barIdx {
+    
+    return (barIdx < self.barsCount ? self.votesCounts[barIdx] : 0);
+}
+
+- (double)percentForBar:(NSUInteger)barIdx {
+    
+    return (barIdx < self.barsCount ? self.percents[barIdx] : 0.0f);
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,204 @@
+#import <Foundation/Foundation.h>
+
+
+#pragma mark Types
+
+/**
+ @brief  Describes decisions which can be made by scheduler during statistic check.
+ */
+typedef NS_ENUM(NSUInteger, SPNPStatisticPublishDecision) {
+    
+    /**
+     @brief  There is no changes which should be published.
+     */
+    SPNPStatisticPublishIdle,
+    
+    /**
+     @brief  Changes will be published after previous publish request completion.
+     */
+    SPNPStatisticPublishWaitForCompletion,
+    
+    /**
+     @brief  Changes will be published after back off delay (previous publish failed).
+     */
+    SPNPStatisticPublishBackOff,
+    
+    /**
+     @brief  Latest statistic snapshot should be published.
+     */
+    SPNPStatisticPublish
+};
+
+
+/**
+ @brief      Scheduler which decide when host should publish aggregated statistic.
+ @discussion Scheduler periodically check for statistic changes and adapt checks interval to 
+             changes rate: interval is shortened while results changing and extended while it's
+             quiet. Only one publish request can be in progress, failed publish repeated with 
+             exponential back off and every publish use latest snapshot, so number of publish 
+             requests depends from activity and not from time.
+             Decision logic available through \c -check method and methods which accept time, so
+             it can be verified with custom \c clock and without timers.
+             Scheduler should be used from main thread.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPStatisticPublishScheduler : NSObject
+
+
+///------------------------------------------------
+/// @name Configuration
+///------------------------------------------------
+
+/**
+ @brief  Stores minimum checks interval which is used while statistic changing (default value is
+         \c 0.25 seconds).
+ */
+@property (nonatomic, assign) NSTimeInterval minimumInterval;
+
+/**
+ @brief  Stores maximum checks interval which is used while statistic doesn't change (default value
+         is \c 2 seconds).
+ */
+@property (nonatomic, assign) NSTimeInterval maximumInterval;
+
+/**
+ @brief  Stores maximum delay before failed publish will be repeated (default value is \c 30 
+         seconds).
+ */
+@property (nonatomic, assign) NSTimeInterval maximumBackOffInterval;
+
+/**
+ @brief      Stores reference on block which is used by scheduler to get current time.
+ @discussion By default \c NSDate reference time is used. Block can be replaced to check scheduler
+             decisions with simulated time.
+ */
+@property (nonatomic, copy) NSTimeInterval(^clock)(void);
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores current interval between statistic checks.
+ */
+@property (nonatomic, readonly, assign) NSTimeInterval interval;
+
+/**
+ @brief  Stores decision which has been made during last statistic check.
+ */
+@property (nonatomic, readonly, assign) SPNPStatisticPublishDecision lastDecision;
+
+/**
+ @brief  Stores whether there is statistic changes which wasn't published yet.
+ */
+@property (nonatomic, readonly, assign) BOOL hasPendingChanges;
+
+/**
+ @brief  Stores whether publish request currently in progress.
+ */
+@property (nonatomic, readonly, assign, getter = isPublishing) BOOL publishing;
+
+/**
+ @brief  Stores number of publish requests which failed in a row.
+ */
+@property (nonatomic, readonly, assign) NSUInteger failuresCount;
+
+/**
+ @brief  Stores number of publish requests which has been made since scheduler creation.
+ */
+@property (nonatomic, readonly, assign) NSUInteger publishesCount;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure statistic publish scheduler.
+ 
+ @param changesBlock Reference on block which is called during each check and should return whether
+                     statistic changed since previous check or not.
+ @param publishBlock Reference on block which is called when latest statistic snapshot should be
+                     published. Block pass only one argument - block which should be called at the
+                     end of publish process with publish request result.
+ 
+ @return Configured and ready to use scheduler.
+ */
++ (instancetype)schedulerWithChangesBlock:(BOOL(^)(void))changesBlock
+                             publishBlock:(void(^)(void(^completion)(BOOL published)))publishBlock;
+
+
+///------------------------------------------------
+/// @name State management
+///------------------------------------------------
+
+/**
+ @brief  Start periodic statistic checks.
+ */
+- (void)start;
+
+/**
+ @brief  Stop periodic statistic checks and reset scheduler state.
+ */
+- (void)stop;
+
+/**
+ @brief      Inform scheduler what new data has been received.
+ @discussion Scheduler shorten time till next check if it has been extended because of inactivity.
+ */
+- (void)setNeedsCheck;
+
+/**
+ @brief      Publish latest statistic snapshot for the last time.
+ @discussion Periodic checks stopped and changes published using same rules as for periodic checks:
+             flush wait for completion of publish request which is in progress and for back off
+             delay after failed request.
+ 
+ @param block Reference on block which should be called at the end of flush process. Block pass
+              only one argument - whether statistic has been published (or there was no changes)
+              or not.
+ */
+- (void)flushWithCompletion:(void(^)(BOOL published))block;
+
+
+///------------------------------------------------
+/// @name Decisions
+///------------------------------------------------
+
+/**
+ @brief      Check statistic and publish it if required.
+ @discussion Method called by periodic checks timer and use \c clock to get check time. Changes
+             block is called to check statistic and publish block is called if
+             \b SPNPStatisticPublish decision has been made.
+ 
+ @return Scheduler decision.
+ */
+- (SPNPStatisticPublishDecision)check;
+
+/**
+ @brief      Decide whether latest statistic snapshot should be published or not.
+ @discussion Method update checks interval basing on \c hasChanges and mark publish request as 
+             started if \b SPNPStatisticPublish decision has been made.
+ 
+ @param time       Reference time at which check has been performed.
+ @param hasChanges Whether statistic changed since previous check or not.
+ 
+ @return Scheduler decision.
+ */
+- (SPNPStatisticPublishDecision)decisionAtTime:(NSTimeInterval)time hasChanges:(BOOL)hasChanges;
+
+/**
+ @brief  Update scheduler state with publish request result.
+ 
+ @param published Whether statistic has been published or not.
+ @param time      Reference time at which publish request completed.
+ */
+- (void)handlePublishResult:(BOOL)published atTime:(NSTimeInterval)time;
+
+#pragma mark -
+
+
+@end
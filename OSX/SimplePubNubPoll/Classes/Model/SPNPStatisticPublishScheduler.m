@@ -0,0 +1,338 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPStatisticPublishScheduler.h"
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores default scheduler configuration.
+ */
+static NSTimeInterval const kSPNPDefaultMinimumInterval = 0.25f;
+static NSTimeInterval const kSPNPDefaultMaximumInterval = 2.0f;
+static NSTimeInterval const kSPNPDefaultMaximumBackOffInterval = 30.0f;
+
+
+#pragma mark - Private interface declaration
+
+@interface SPNPStatisticPublishScheduler ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, assign) NSTimeInterval interval;
+@property (nonatomic, assign) SPNPStatisticPublishDecision lastDecision;
+@property (nonatomic, assign) BOOL hasPendingChanges;
+@property (nonatomic, assign, getter = isPublishing) BOOL publishing;
+@property (nonatomic, assign) NSUInteger failuresCount;
+@property (nonatomic, assign) NSUInteger publishesCount;
+
+/**
+ @brief  Stores time before which failed publish shouldn't be repeated.
+ */
+@property (nonatomic, assign) NSTimeInterval backOffTime;
+
+/**
+ @brief  Stores time at which next check has been scheduled.
+ */
+@property (nonatomic, assign) NSTimeInterval checkTime;
+
+/**
+ @brief  Stores reference on timer which is used to trigger next check.
+ */
+@property (nonatomic, strong) NSTimer *timer;
+
+/**
+ @brief  Stores references on blocks which is used to check and publish statistic.
+ */
+@property (nonatomic, copy) BOOL(^changesBlock)(void);
+@property (nonatomic, copy) void(^publishBlock)(void(^completion)(BOOL published));
+
+/**
+ @brief  Stores reference on block which should be called when requested flush will be completed.
+ */
+@property (nonatomic, copy) void(^flushCompletion)(BOOL published);
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize statistic publish scheduler.
+ 
+ @param changesBlock Reference on block which is called during each check and should return whether
+                     statistic changed since previous check or not.
+ @param publishBlock Reference on block which is called when latest statistic snapshot should be
+                     published.
+ 
+ @return Initialized and ready to use scheduler.
+ */
+- (instancetype)initWithChangesBlock:(BOOL(^)(void))changesBlock
+                        publishBlock:(void(^)(void(^completion)(BOOL published)))publishBlock;
+
+
+#pragma mark - Checks
+
+/**
+ @brief  Schedule next statistic check.
+ 
+ @param interval Delay after which check should be performed.
+ */
+- (void)scheduleCheckAfter:(NSTimeInterval)interval;
+
+/**
+ @brief  Handle checks timer.
+ 
+ @param timer Reference on timer which triggered check.
+ */
+- (void)handleCheckTimer:(NSTimer *)timer;
+
+
+#pragma mark - Flush
+
+/**
+ @brief      Publish latest statistic snapshot if flush has been requested.
+ @discussion Flush postponed if publish request in progress or back off delay not passed yet.
+ */
+- (void)continueFlush;
+
+/**
+ @brief  Call flush completion block (if flush has been requested).
+ 
+ @param published Whether statistic has been published or not.
+ */
+- (void)completeFlushWithResult:(BOOL)published;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPStatisticPublishScheduler
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)schedulerWithChangesBlock:(BOOL(^)(void))changesBlock
+                             publishBlock:(void(^)(void(^completion)(BOOL published)))publishBlock {
+    
+    return [[self alloc] initWithChangesBlock:changesBlock publishBlock:publishBlock];
+}
+
+- (instancetype)initWithChangesBlock:(BOOL(^)(void))changesBlock
+                        publishBlock:(void(^)(void(^completion)(BOOL published)))publishBlock {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _minimumInterval = kSPNPDefaultMinimumInterval;
+        _maximumInterval = kSPNPDefaultMaximumInterval;
+        _maximumBackOffInterval = kSPNPDefaultMaximumBackOffInterval;
+        _interval = _minimumInterval;
+        _clock = [^NSTimeInterval{ return [NSDate timeIntervalSinceReferenceDate]; } copy];
+        _changesBlock = [changesBlock copy];
+        _publishBlock = [publishBlock copy];
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    
+    [_timer invalidate];
+}
+
+
+#pragma mark - State management
+
+- (void)start {
+    
+    [self stop];
+    [self scheduleCheckAfter:self.minimumInterval];
+}
+
+- (void)stop {
+    
+    [self.timer invalidate];
+    self.timer = nil;
+    self.interval = self.minimumInterval;
+    self.lastDecision = SPNPStatisticPublishIdle;
+    self.hasPendingChanges = NO;
+    self.failuresCount = 0;
+    self.backOffTime = 0;
+    [self completeFlushWithResult:NO];
+}
+
+- (void)setNeedsCheck {
+    
+    NSTimeInterval time = self.clock();
+    if (self.timer && self.checkTime > time + self.minimumInterval) {
+        
+        self.interval = self.minimumInterval;
+        [self scheduleCheckAfter:self.minimumInterval];
+    }
+}
+
+- (void)flushWithCompletion:(void(^)(BOOL published))block {
+    
+    [self.timer invalidate];
+    self.timer = nil;
+    void(^previousCompletion)(BOOL published) = self.flushCompletion;
+    self.flushCompletion = ^(BOOL published) {
+        
+        if (previousCompletion) { previousCompletion(published); }
+        if (block) { block(published); }
+    };
+    [self continueFlush];
+}
+
+
+#pragma mark - Decisions
+
+- (SPNPStatisticPublishDecision)decisionAtTime:(NSTimeInterval)time hasChanges:(BOOL)hasChanges {
+    
+    // Check more often while results changing and less often while it's quiet.
+    if (hasChanges) { self.interval = MAX(self.interval * 0.5f, self.minimumInterval); }
+    else { self.interval = MIN(self.interval * 2.0f, self.maximumInterval); }
+    self.hasPendingChanges = (self.hasPendingChanges || hasChanges);
+    
+    SPNPStatisticPublishDecision decision = SPNPStatisticPublishIdle;
+    if (self.hasPendingChanges) {
+        
+        if (self.isPublishing) { decision = SPNPStatisticPublishWaitForCompletion; }
+        else if (time < self.backOffTime) { decision = SPNPStatisticPublishBackOff; }
+        else {
+            
+            decision = SPNPStatisticPublish;
+            self.hasPendingChanges = NO;
+            self.publishing = YES;
+            self.publishesCount++;
+        }
+    }
+    self.lastDecision = decision;
+    
+    return decision;
+}
+
+- (void)handlePublishResult:(BOOL)published atTime:(NSTimeInterval)time {
+    
+    self.publishing = NO;
+    if (!published) {
+        
+        // Snapshot which will be published after back off delay will include changes from failed
+        // request.
+        self.failuresCount++;
+        NSTimeInterval delay = (self.minimumInterval * pow(2.0f, MIN(self.failuresCount, 16)));
+        self.backOffTime = (time + MIN(delay, self.maximumBackOffInterval));
+        self.hasPendingChanges = YES;
+    }
+    else {
+        
+        self.failuresCount = 0;
+        self.backOffTime = 0;
+    }
+}
+
+
+#pragma mark - Checks
+
+- (void)scheduleCheckAfter:(NSTimeInterval)interval {
+    
+    [self.timer invalidate];
+    self.checkTime = (self.clock() + interval);
+    self.timer = [NSTimer scheduledTimerWithTimeInterval:interval target:self
+                                                selector:@selector(handleCheckTimer:)
+                                                userInfo:nil repeats:NO];
+}
+
+- (void)handleCheckTimer:(NSTimer *)timer {
+    
+    [self check];
+}
+
+- (SPNPStatisticPublishDecision)check {
+    
+    NSTimeInterval time = self.clock();
+    BOOL hasChanges = (self.changesBlock ? self.changesBlock() : NO);
+    SPNPStatisticPublishDecision decision = [self decisionAtTime:time hasChanges:hasChanges];
+    if (decision == SPNPStatisticPublish) {
+        
+        __weak __typeof(self) weakSelf = self;
+        NSTimeInterval(^clock)(void) = self.clock;
+        self.publishBlock(^(BOOL published) {
+            
+            __strong __typeof(self) strongSelf = weakSelf;
+            [strongSelf handlePublishResult:published atTime:clock()];
+            
+            // Publish changes which has been collected while request was in progress.
+            if (strongSelf.timer && strongSelf.hasPendingChanges && !strongSelf.failuresCount) {
+                
+                [strongSelf scheduleCheckAfter:strongSelf.minimumInterval];
+            }
+            [strongSelf continueFlush];
+        });
+    }
+    
+    // Timer may be cleared by changes or publish blocks (if scheduler has been stopped).
+    if (self.timer) {
+        
+        NSTimeInterval interval = self.interval;
+        if (self.lastDecision == SPNPStatisticPublishBackOff) {
+            
+            interval = MAX(self.backOffTime - time, self.minimumInterval);
+        }
+        [self scheduleCheckAfter:interval];
+    }
+    
+    return decision;
+}
+
+
+#pragma mark - Flush
+
+- (void)continueFlush {
+    
+    // Flush will be continued when active publish request will be completed.
+    if (!self.flushCompletion || self.isPublishing) { return; }
+    
+    NSTimeInterval time = self.clock();
+    BOOL hasChanges = (self.changesBlock ? self.changesBlock() : NO);
+    SPNPStatisticPublishDecision decision = [self decisionAtTime:time hasChanges:hasChanges];
+    __weak __typeof(self) weakSelf = self;
+    if (decision == SPNPStatisticPublish) {
+        
+        NSTimeInterval(^clock)(void) = self.clock;
+        self.publishBlock(^(BOOL published) {
+            
+            __strong __typeof(self) strongSelf = weakSelf;
+            [strongSelf handlePublishResult:published atTime:clock()];
+            [strongSelf completeFlushWithResult:published];
+        });
+    }
+    else if (decision == SPNPStatisticPublishBackOff) {
+        
+        NSTimeInterval delay = (self.backOffTime - time);
+        dispatch_time_t backOffTime = dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC));
+        dispatch_after(backOffTime, dispatch_get_main_queue(), ^{
+            
+            [weakSelf continueFlush];
+        });
+    }
+    else { [self completeFlushWithResult:YES]; }
+}
+
+- (void)completeFlushWithResult:(BOOL)published {
+    
+    void(^block)(BOOL published) = self.flushCompletion;
+    self.flushCompletion = nil;
+    if (block) { block(published); }
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,98 @@
+#import <Foundation/Foundation.h>
+
+
+/**
+ @brief      Tracker of statistic updates stream which is received from host.
+ @discussion Host publish keyframes with full statistic and changes which should be applied on top
+             of previous update. Sequencer decide which of received updates can be applied: changes
+             accepted only if all previous updates has been applied, lost or reordered changes make
+             attendee wait for next keyframe and duplicated or outdated updates ignored.
+             Sequencer should be used from main thread.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPStatisticSequencer : NSObject
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores sequence number of last accepted statistic update.
+ */
+@property (nonatomic, readonly, assign) unsigned long long sequence;
+
+/**
+ @brief  Stores whether keyframe and all following changes has been accepted or some of them has
+         been lost and sequencer wait for next keyframe.
+ */
+@property (nonatomic, readonly, assign, getter = isSynchronized) BOOL synchronized;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure statistic updates sequencer.
+ 
+ @param keyframeInterval How often host publish keyframes instead of changes.
+ 
+ @return Configured and ready to use sequencer.
+ */
++ (instancetype)sequencerWithKeyframeInterval:(NSUInteger)keyframeInterval;
+
+
+///------------------------------------------------
+/// @name Sequence
+///------------------------------------------------
+
+/**
+ @brief      Check whether update with specified sequence number should replace previous one.
+ @discussion Sequence number much lower than last applied one means what host has been restarted and
+             started new updates stream.
+ 
+ @param sequence         Sequence number of received update (\c nil for hosts which doesn't number
+                         updates).
+ @param lastSequence     Sequence number of last applied update.
+ @param keyframeInterval How often host publish keyframes instead of changes.
+ 
+ @return \c YES in case if update is newer than last applied one.
+ */
++ (BOOL)isSequence:(NSNumber *)sequence newerThan:(unsigned long long)lastSequence
+  keyframeInterval:(NSUInteger)keyframeInterval;
+
+/**
+ @brief  Check whether received keyframe should be applied and track it's sequence number.
+ 
+ @param sequence Sequence number of received keyframe.
+ 
+ @return \c YES in case if keyframe is newer than last accepted update.
+ */
+- (BOOL)acceptKeyframeWithSequence:(NSNumber *)sequence;
+
+/**
+ @brief      Check whether received changes should be applied and track it's sequence number.
+ @discussion Changes accepted only if they directly follow last accepted update. Gap in sequence
+             numbers mark stream as not synchronized till next keyframe.
+ 
+ @param sequence Sequence number of received changes.
+ 
+ @return \c YES in case if changes can be applied on top of last accepted update.
+ */
+- (BOOL)acceptChangesWithSequence:(NSNumber *)sequence;
+
+/**
+ @brief  Reset sequencer state (for example after statistic has been restored from history).
+ 
+ @param sequence       Sequence number of last applied update.
+ @param isSynchronized Whether applied statistic include all updates till \c sequence.
+ */
+- (void)resetWithSequence:(unsigned long long)sequence synchronized:(BOOL)isSynchronized;
+
+#pragma mark -
+
+
+@end
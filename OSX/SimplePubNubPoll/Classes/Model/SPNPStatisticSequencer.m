@@ -0,0 +1,90 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPStatisticSequencer.h"
+
+
+#pragma mark Private interface declaration
+
+@interface SPNPStatisticSequencer ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, assign) unsigned long long sequence;
+@property (nonatomic, assign, getter = isSynchronized) BOOL synchronized;
+
+/**
+ @brief  Stores how often host publish keyframes instead of changes.
+ */
+@property (nonatomic, assign) NSUInteger keyframeInterval;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPStatisticSequencer
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)sequencerWithKeyframeInterval:(NSUInteger)keyframeInterval {
+    
+    SPNPStatisticSequencer *sequencer = [self new];
+    sequencer.keyframeInterval = keyframeInterval;
+    
+    return sequencer;
+}
+
+
+#pragma mark - Sequence
+
++ (BOOL)isSequence:(NSNumber *)sequence newerThan:(unsigned long long)lastSequence
+  keyframeInterval:(NSUInteger)keyframeInterval {
+    
+    unsigned long long value = sequence.unsignedLongLongValue;
+    
+    return (!sequence || value > lastSequence || value + 2 * keyframeInterval < lastSequence);
+}
+
+- (BOOL)acceptKeyframeWithSequence:(NSNumber *)sequence {
+    
+    BOOL isNewer = [[self class] isSequence:sequence newerThan:self.sequence
+                           keyframeInterval:self.keyframeInterval];
+    if (isNewer) {
+        
+        [self resetWithSequence:sequence.unsignedLongLongValue synchronized:(sequence != nil)];
+    }
+    
+    return isNewer;
+}
+
+- (BOOL)acceptChangesWithSequence:(NSNumber *)sequence {
+    
+    unsigned long long value = sequence.unsignedLongLongValue;
+    BOOL isNext = (sequence && self.isSynchronized && value == self.sequence + 1);
+    if (isNext) { self.sequence = value; }
+    else if (value > self.sequence + 1) {
+        
+        // Some updates has been lost or reordered. Wait for next keyframe.
+        self.synchronized = NO;
+    }
+    
+    return isNext;
+}
+
+- (void)resetWithSequence:(unsigned long long)sequence synchronized:(BOOL)isSynchronized {
+    
+    self.sequence = sequence;
+    self.synchronized = isSynchronized;
+}
+
+#pragma mark -
+
+
+@end
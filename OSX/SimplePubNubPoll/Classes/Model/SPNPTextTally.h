@@ -0,0 +1,96 @@
+#import <Foundation/Foundation.h>
+
+
+#pragma mark Class forward
+
+@class SPNPPollTextStatistic, SPNPPoll;
+
+
+/**
+ @brief      Host side free-text responses counting engine.
+ @discussion Tally accept only one response from each attendee, normalize response text and count
+             it with bounded memory top-K counter (see \b SPNPHeavyHitters), so thousands of 
+             distinct answers doesn't grow host memory usage and only most frequent of them 
+             published with statistic.
+             Tally should be used from main thread.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPTextTally : NSObject
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on open-text poll for which responses counted.
+ */
+@property (nonatomic, readonly, strong) SPNPPoll *poll;
+
+/**
+ @brief  Stores number of responses which has been counted.
+ */
+@property (nonatomic, readonly, assign) unsigned long long responsesCount;
+
+/**
+ @brief      Stores number of responses which has been dropped.
+ @discussion Response dropped if it has been sent for different poll, attendee already responded or
+             there is no letters and digits in response text.
+ */
+@property (nonatomic, readonly, assign) unsigned long long droppedResponsesCount;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure free-text responses tally.
+ 
+ @param poll     Reference on open-text poll for which responses should be counted.
+ @param capacity Maximum number of distinct answers which can be tracked at once.
+ 
+ @return Configured and ready to use tally.
+ */
++ (instancetype)tallyForPoll:(SPNPPoll *)poll capacity:(NSUInteger)capacity;
+
+
+///------------------------------------------------
+/// @name Counting
+///------------------------------------------------
+
+/**
+ @brief      Count attendee's response.
+ @discussion Responses de-duplicated using \c voter (identifier from message payload ignored), so
+             responses without voter dropped.
+ 
+ @param message Reference on received message with \b SPNPPollTextResponse.
+ @param voter   Reference on identifier of message publisher reported by transport.
+ 
+ @return \c YES in case if response has been counted.
+ */
+- (BOOL)registerResponseFromMessage:(id)message fromVoter:(NSString *)voter;
+
+/**
+ @brief  Check whether responses has been counted since last call.
+ 
+ @return \c YES in case if statistic should be published.
+ */
+- (BOOL)hasResponsesSinceLastCheck;
+
+/**
+ @brief  Build statistic from most frequent answers.
+ 
+ @param count    Maximum number of answers which should be included into statistic.
+ @param sequence Reference on statistic stream sequence number.
+ 
+ @return Configured and ready to publish statistic.
+ */
+- (SPNPPollTextStatistic *)statisticWithTopCount:(NSUInteger)count sequence:(NSNumber *)sequence;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,143 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPTextTally.h"
+#import "SPNPTextResponseStatistic.h"
+#import "SPNPPollTextStatistic.h"
+#import "SPNPPollTextResponse.h"
+#import "SPNPHeavyHitters.h"
+#import "SPNPStringTable.h"
+#import "SPNPVoterIndex.h"
+#import "SPNPPoll.h"
+
+
+#pragma mark Private interface declaration
+
+@interface SPNPTextTally ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, strong) SPNPPoll *poll;
+@property (nonatomic, assign) unsigned long long responsesCount;
+@property (nonatomic, assign) unsigned long long droppedResponsesCount;
+
+/**
+ @brief  Stores reference on counter of most frequent answers.
+ */
+@property (nonatomic, strong) SPNPHeavyHitters *heavyHitters;
+
+/**
+ @brief  Stores reference on index of attendees which already responded.
+ */
+@property (nonatomic, strong) SPNPVoterIndex *responders;
+
+/**
+ @brief  Stores whether responses has been counted since last check.
+ */
+@property (nonatomic, assign) BOOL hasResponses;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize free-text responses tally.
+ 
+ @param poll     Reference on open-text poll for which responses should be counted.
+ @param capacity Maximum number of distinct answers which can be tracked at once.
+ 
+ @return Initialized and ready to use tally.
+ */
+- (instancetype)initForPoll:(SPNPPoll *)poll capacity:(NSUInteger)capacity;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPTextTally
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)tallyForPoll:(SPNPPoll *)poll capacity:(NSUInteger)capacity {
+    
+    return [[self alloc] initForPoll:poll capacity:capacity];
+}
+
+- (instancetype)initForPoll:(SPNPPoll *)poll capacity:(NSUInteger)capacity {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _poll = poll;
+        _heavyHitters = [SPNPHeavyHitters heavyHittersWithCapacity:capacity];
+        _responders = [SPNPVoterIndex indexWithMaximumCount:kSPNPVoterIndexMaximumVotersCount];
+    }
+    
+    return self;
+}
+
+
+#pragma mark - Counting
+
+- (BOOL)registerResponseFromMessage:(id)message fromVoter:(NSString *)voter {
+    
+    SPNPPollTextResponse *response = [SPNPPollTextResponse objectFromMessage:message
+                                                                     forPoll:self.poll.identifier
+                                                                       token:self.poll.token];
+    
+    // Text normalized once again, because attendee may send it as-is.
+    NSString *text = [SPNPPollTextResponse normalizedText:response.text];
+    BOOL isCounted = (text && [voter isKindOfClass:NSString.class] &&
+                      [self.poll.identifier isEqual:response.pollIdentifier]);
+    if (isCounted) {
+        
+        NSUInteger previousChoice = [self.responders registerChoice:0 forVoter:voter
+                                                  replacingExisting:NO];
+        isCounted = (previousChoice == NSNotFound);
+    }
+    if (isCounted) {
+        
+        [self.heavyHitters addItem:[[SPNPStringTable sharedTable] internedString:text]];
+        self.responsesCount++;
+        self.hasResponses = YES;
+    }
+    else { self.droppedResponsesCount++; }
+    
+    return isCounted;
+}
+
+- (BOOL)hasResponsesSinceLastCheck {
+    
+    BOOL hasResponses = self.hasResponses;
+    self.hasResponses = NO;
+    
+    return hasResponses;
+}
+
+- (SPNPPollTextStatistic *)statisticWithTopCount:(NSUInteger)count sequence:(NSNumber *)sequence {
+    
+    NSMutableArray *responses = [NSMutableArray arrayWithCapacity:count];
+    [self.heavyHitters enumerateTopItems:count usingBlock:^(NSString *item,
+                                                            unsigned long long itemCount,
+                                                            unsigned long long error, BOOL *stop) {
+        
+        [responses addObject:[SPNPTextResponseStatistic statisticForText:item votesCount:itemCount
+                                                                   error:error]];
+    }];
+    
+    return [SPNPPollTextStatistic statisticForPoll:self.poll.identifier withResponses:responses
+                                          sequence:sequence
+                                    responsesCount:self.heavyHitters.totalCount
+                                      maximumError:self.heavyHitters.maximumError];
+}
+
+#pragma mark -
+
+
+@end
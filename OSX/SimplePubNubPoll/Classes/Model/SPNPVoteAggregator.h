@@ -0,0 +1,199 @@
+#import <Foundation/Foundation.h>
+
+
+#pragma mark Class forward
+
+@class SPNPStatisticStore, SPNPVoterIndex, SPNPVoteLog, SPNPMetrics, SPNPPoll;
+
+
+/**
+ @brief      Host side votes aggregation engine.
+ @discussion Aggregator collect attendee responses into batches (limited by size and latency), 
+             parse them on it's own serial queue and count them using plain atomic counters (one 
+             per response variant), so burst of votes doesn't allocate statistic objects and 
+             doesn't trigger KVO notifications on the thread which deliver messages. Manager 
+             periodically take aggregated votes count snapshot and use it to update statistic 
+             instances at once.
+             Polls which collect responses using several shard channels aggregated with separate
+             queue, counters and voters index for each shard, so shards doesn't contend with each 
+             other and counters merged only when snapshot is taken.
+             Aggregator should be used from main thread.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPVoteAggregator : NSObject
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief      Stores whether attendee allowed to change his vote or not.
+ @discussion Each vote is checked against index of attendees which already voted for active poll.
+             If change allowed, previously chosen response counter will be decreased ("latest vote 
+             wins"), otherwise repeated votes ignored ("first vote wins"). Votes without attendee 
+             identifier always counted.
+             Disabled by default.
+ */
+@property (nonatomic, assign) BOOL allowsVoteChange;
+
+/**
+ @brief      Stores reference on log into which accepted votes should be written.
+ @discussion Log accessed only from aggregator queue (shards pass accepted votes to it). Log 
+             restarted each time when aggregator reset for new poll.
+ */
+@property (nonatomic, strong) SPNPVoteLog *voteLog;
+
+/**
+ @brief  Stores reference on metrics into which batches processing time and counted votes should be
+         recorded.
+ */
+@property (nonatomic, strong) SPNPMetrics *metrics;
+
+/**
+ @brief      Stores maximum number of responses which can be collected into single batch.
+ @discussion Batch sent for processing as soon as it reach this size. Value \c 1 disable batching.
+             Default value is \c 128.
+ */
+@property (nonatomic, assign) NSUInteger maximumBatchSize;
+
+/**
+ @brief      Stores maximum time which response can wait in batch for processing.
+ @discussion Default value is \c 0.005 seconds.
+ */
+@property (nonatomic, assign) NSTimeInterval batchLatency;
+
+
+///------------------------------------------------
+/// @name State management
+///------------------------------------------------
+
+/**
+ @brief      Start votes aggregation for new poll.
+ @discussion Votes which has been received before reset and still wait for processing will be
+             counted for previous poll and won't affect new counters. Method wait for shards to
+             process them, so they won't be written into votes log of new poll.
+ 
+ @param poll       Reference on poll for which votes should be aggregated or \c nil to stop
+                   aggregation.
+ @param votesCount List of initial votes count for each response variant (sorted by response 
+                   order).
+ */
+- (void)resetForPoll:(SPNPPoll *)poll withVotesCount:(NSArray *)votesCount;
+
+/**
+ @brief      Start votes aggregation for poll which votes has been recounted.
+ @discussion Passed index of attendees which already voted used to de-duplicate votes which will be
+             received after reset.
+ 
+ @param poll       Reference on poll for which votes should be aggregated.
+ @param votesCount List of initial votes count for each response variant (sorted by response 
+                   order).
+ @param voters     Reference on index of attendees which already voted for \c poll or \c nil.
+ */
+- (void)resetForPoll:(SPNPPoll *)poll withVotesCount:(NSArray *)votesCount
+              voters:(SPNPVoterIndex *)voters;
+
+/**
+ @brief      Merge votes which has been recounted from history with votes which has been aggregated
+             since last reset.
+ @discussion Host subscribe for responses before history replay, so same attendee's vote can be 
+             counted by both. Such votes de-duplicated by voter: latest (aggregated) vote kept if
+             vote change allowed, otherwise first (recounted) vote kept. Recounted votes which 
+             affect counters are also written into votes log.
+ 
+ @param votesCount List of recounted votes count for each response variant (sorted by response 
+                   order).
+ @param voters     Reference on index of attendees which votes has been recounted.
+ @param block      Reference on block which is called on main queue when all shards merged 
+                   recounted votes.
+ */
+- (void)mergeRecountedVotesCount:(NSArray *)votesCount voters:(SPNPVoterIndex *)voters
+                  withCompletion:(dispatch_block_t)block;
+
+/**
+ @brief      Restore aggregation state from votes log which has been written by previous host 
+             session.
+ @discussion Counters and index of attendees which voted restored without network requests. Votes
+             which will be counted after restore appended to the same log.
+ 
+ @param votesCount Reference on pointer which will store list of restored votes count for each 
+                   response variant (sorted by response order).
+ 
+ @return Reference on poll for which votes has been restored or \c nil in case if there is no 
+         usable log.
+ */
+- (SPNPPoll *)restoreFromVoteLogWithVotesCount:(NSArray * __autoreleasing *)votesCount;
+
+
+///------------------------------------------------
+/// @name Aggregation
+///------------------------------------------------
+
+/**
+ @brief      Schedule attendee response processing.
+ @discussion Message added to current batch which is parsed, de-duplicated and counted on aggregator
+             queue in single pass. Responses for other polls and responses with unknown order number
+             ignored.
+             Votes de-duplicated using \c voter (identifier from message payload ignored), so votes
+             without voter dropped. When voters index is full votes of new voters still counted,
+             but reported by \c untrackedVotes metrics counter.
+ 
+ @param message Reference on message received from attendee (dictionary or compact 
+                representation).
+ @param voter   Reference on identifier of message publisher reported by transport.
+ */
+- (void)registerVoteFromMessage:(id)message fromVoter:(NSString *)voter;
+
+/**
+ @brief      Schedule processing of attendee response which has been received from shard channel.
+ @discussion Votes which has been sent not to the shard assigned to \c voter dropped.
+ 
+ @param message    Reference on message received from attendee (dictionary or compact 
+                   representation).
+ @param voter      Reference on identifier of message publisher reported by transport.
+ @param shardIndex Index of shard channel from which \c message has been received.
+ */
+- (void)registerVoteFromMessage:(id)message fromVoter:(NSString *)voter
+                        inShard:(NSUInteger)shardIndex;
+
+/**
+ @brief  Send collected responses for processing without waiting for batch size or latency limits.
+ */
+- (void)flushPendingVotes;
+
+/**
+ @brief  Retrieve snapshot of aggregated votes count.
+ 
+ @return List of votes count for each response variant (sorted by response order) or \c nil in 
+         case if there was no new votes since last snapshot.
+ */
+- (NSArray *)votesCountIfChanged;
+
+/**
+ @brief      Copy aggregated votes count into store.
+ @discussion Shard counters merged right into store's contiguous storage, so snapshot doesn't box 
+             votes count of response variants which didn't change.
+ 
+ @param store Reference on store which has been created for aggregated poll.
+ 
+ @return Indexes of responses which votes count has been changed or \c nil in case if there was no
+         new votes since last snapshot (or \c store doesn't match aggregated poll).
+ */
+- (NSIndexSet *)updateVotesCountInStore:(SPNPStatisticStore *)store;
+
+/**
+ @brief      Retrieve traces of sampled votes which has been counted since last call.
+ @discussion Traces become available only after their votes has been added to counters, so votes
+             count retrieved after this call include all of them.
+ 
+ @return List of \b SPNPVoteTrace instances (w/o publish time) or \c nil if there is no traces.
+ */
+- (NSArray *)dequeueVoteTraces;
+
+#pragma mark -
+
+
+@end
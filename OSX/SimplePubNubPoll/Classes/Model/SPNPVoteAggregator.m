@@ -0,0 +1,746 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPVoteAggregator.h"
+#import "SPNPStatisticStore.h"
+#import "SPNPVoteCounters.h"
+#import "SPNPPollResponse.h"
+#import "SPNPCompactCoder.h"
+#import "SPNPVoterIndex.h"
+#import "SPNPVoteTrace.h"
+#import "SPNPMetrics.h"
+#import "SPNPVoteLog.h"
+#import "SPNPPoll.h"
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores default batching limits.
+ */
+static NSUInteger const kSPNPDefaultVotesBatchSize = 128;
+static NSTimeInterval const kSPNPDefaultVotesBatchLatency = 0.005f;
+
+/**
+ @brief  Stores maximum number of sampled votes traces which wait for statistic publish.
+ */
+static NSUInteger const kSPNPMaximumPendingVoteTraces = 32;
+
+
+#pragma mark - Types
+
+/**
+ @brief  Describes vote which has been accepted by shard and should be written into votes log.
+ */
+typedef struct {
+    
+    uint64_t voter;
+    uint32_t choice;
+    uint32_t previousChoice;
+} SPNPVoteRecord;
+
+
+#pragma mark - Private interface declaration
+
+@interface SPNPVoteAggregator ()
+
+
+#pragma mark - Properties
+
+/**
+ @brief      Stores reference on serial queue which is used to parse and count votes.
+ @discussion Queue also used by first shard and it is the only queue from which votes log accessed.
+ */
+@property (nonatomic, strong) dispatch_queue_t queue;
+
+/**
+ @brief  Stores reference on serial queues which is used by shards to parse and count votes.
+ */
+@property (nonatomic, strong) NSMutableArray *shardQueues;
+
+/**
+ @brief      Stores reference on active poll votes counters (sharded).
+ @discussion Counters replaced on reset, so votes which still wait for processing update counters of
+             previous poll.
+ */
+@property (nonatomic, strong) SPNPVoteCounters *counters;
+
+/**
+ @brief      Stores reference on index of attendees which voted for active poll (one for each shard).
+ @discussion Index accessed only from shard queue and replaced on reset (same as counters).
+ */
+@property (nonatomic, copy) NSArray *voters;
+
+/**
+ @brief  Stores number of registered votes which has been observed during last snapshot.
+ */
+@property (nonatomic, assign) uint64_t snapshotVotesCount;
+
+/**
+ @brief  Stores reference on identifier and token of the poll for which votes aggregated.
+ */
+@property (nonatomic, copy) NSString *pollIdentifier;
+@property (nonatomic, strong) NSNumber *pollToken;
+
+/**
+ @brief  Stores reference on poll for which votes aggregated (used to verify voters shard).
+ */
+@property (nonatomic, strong) SPNPPoll *poll;
+
+/**
+ @brief  Stores reference on lists of messages which has been collected into current batch (one for
+         each shard).
+ */
+@property (nonatomic, strong) NSArray *pendingMessages;
+
+/**
+ @brief  Stores reference on fingerprints of voters which published messages from current batch (one
+         \c uint64_t storage for each shard, same order as in \c pendingMessages).
+ */
+@property (nonatomic, strong) NSArray *pendingVoterKeys;
+
+/**
+ @brief  Stores reference on time when first message of current batch has been received (one for 
+         each shard).
+ */
+@property (nonatomic, strong) NSMutableArray *pendingSince;
+
+/**
+ @brief  Stores reference on traces of sampled votes which has been counted.
+ */
+@property (nonatomic, strong) NSMutableArray *voteTraces;
+
+/**
+ @brief  Stores whether delayed batch processing has been scheduled or not.
+ */
+@property (nonatomic, assign, getter = isFlushScheduled) BOOL flushScheduled;
+
+
+#pragma mark - State management
+
+/**
+ @brief  Replace counters and voters index for new poll.
+ 
+ @param poll       Reference on poll for which votes should be aggregated.
+ @param votesCount List of initial votes count for each response variant.
+ @param voters     Reference on index of attendees which already voted for poll.
+ */
+- (void)setCountersForPoll:(SPNPPoll *)poll withVotesCount:(NSArray *)votesCount
+                    voters:(SPNPVoterIndex *)voters;
+
+/**
+ @brief      Split index of attendees which voted between shards.
+ @discussion Attendees assigned to shards using the same rule which is used by attendees to choose
+             shard channel.
+ 
+ @param voters Reference on index of attendees which voted for poll.
+ @param poll   Reference on poll for which votes aggregated.
+ 
+ @return List of voters indices (one for each shard).
+ */
+- (NSArray *)shardedVoters:(SPNPVoterIndex *)voters forPoll:(SPNPPoll *)poll;
+
+/**
+ @brief      De-duplicate recounted votes of shard's voters against votes which has been aggregated
+             by shard.
+ @discussion Method called on shard queue.
+ 
+ @param recountedVoters  Reference on index of shard's attendees which votes has been recounted.
+ @param voters           Reference on index of attendees which voted for poll using shard.
+ @param counters         Reference on poll votes counters.
+ @param shardIndex       Index of shard which counters should be updated.
+ @param allowsVoteChange Whether attendee allowed to change his vote or not.
+ 
+ @return List of recounted votes (\b SPNPVoteRecord values) which should be written into log.
+ */
++ (NSData *)mergeRecountedVoters:(SPNPVoterIndex *)recountedVoters
+                      intoVoters:(SPNPVoterIndex *)voters counters:(SPNPVoteCounters *)counters
+                           shard:(NSUInteger)shardIndex allowingVoteChange:(BOOL)allowsVoteChange;
+
+
+#pragma mark - Aggregation
+
+/**
+ @brief  Send responses collected by shard for processing.
+ 
+ @param shardIndex Index of shard which batch should be processed.
+ */
+- (void)flushPendingVotesInShard:(NSUInteger)shardIndex;
+
+/**
+ @brief      Parse and count batch of responses.
+ @discussion Method called on shard queue. Counters updated once per response variant which has
+             been changed by batch.
+ 
+ @param messages         List of messages received from attendees.
+ @param pollIdentifier   Identifier of the poll for which votes should be counted.
+ @param pollToken        Short token of the poll for which votes should be counted.
+ @param counters         Reference on poll votes counters.
+ @param shardIndex       Index of shard which counters should be updated.
+ @param voterKeys        Reference on fingerprints of voters which published \c messages.
+ @param voters           Reference on index of attendees which voted for poll using shard.
+ @param allowsVoteChange Whether attendee allowed to change his vote or not.
+ @param receivedTime     Reference on time when batch's first message has been received.
+ @param traces           Reference on variable into which traces of counted sampled votes should
+                         be stored.
+ @param untrackedVotes   Reference on variable into which number of votes which has been counted
+                         without voter tracking (voters index is full) should be stored.
+ 
+ @return List of accepted votes (\b SPNPVoteRecord values) which should be written into log.
+ */
++ (NSData *)countVotesFromMessages:(NSArray *)messages forPoll:(NSString *)pollIdentifier
+                             token:(NSNumber *)pollToken counters:(SPNPVoteCounters *)counters
+                             shard:(NSUInteger)shardIndex voterKeys:(NSData *)voterKeys
+                            voters:(SPNPVoterIndex *)voters
+                allowingVoteChange:(BOOL)allowsVoteChange receivedTime:(NSNumber *)receivedTime
+                            traces:(NSArray * __autoreleasing *)traces
+                    untrackedVotes:(NSUInteger *)untrackedVotes;
+
+/**
+ @brief      Store traces of sampled votes till statistic publish.
+ @discussion Method called on main queue.
+ 
+ @param traces         List of \b SPNPVoteTrace instances.
+ @param pollIdentifier Identifier of the poll for which votes has been counted.
+ */
+- (void)addVoteTraces:(NSArray *)traces forPoll:(NSString *)pollIdentifier;
+
+/**
+ @brief      Write accepted votes into votes log.
+ @discussion Method called on aggregator queue.
+ 
+ @param records List of accepted votes (\b SPNPVoteRecord values).
+ @param log     Reference on log into which votes should be written.
+ */
++ (void)appendRecords:(NSData *)records toLog:(SPNPVoteLog *)log;
+
+
+#pragma mark - Snapshot
+
+/**
+ @brief  Check whether new votes has been registered since last snapshot.
+ 
+ @return \c YES in case if snapshot should be taken.
+ */
+- (BOOL)hasVotesSinceSnapshot;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPVoteAggregator
+
+
+#pragma mark - Initialization and Configuration
+
+- (instancetype)init {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _queue = dispatch_queue_create("com.pubnub.poll.votes", DISPATCH_QUEUE_SERIAL);
+        _shardQueues = [NSMutableArray arrayWithObject:_queue];
+        _maximumBatchSize = kSPNPDefaultVotesBatchSize;
+        _batchLatency = kSPNPDefaultVotesBatchLatency;
+        [self resetForPoll:nil withVotesCount:nil];
+    }
+    
+    return self;
+}
+
+
+#pragma mark - State management
+
+- (void)resetForPoll:(SPNPPoll *)poll withVotesCount:(NSArray *)votesCount {
+    
+    [self resetForPoll:poll withVotesCount:votesCount voters:nil];
+}
+
+- (void)resetForPoll:(SPNPPoll *)poll withVotesCount:(NSArray *)votesCount
+              voters:(SPNPVoterIndex *)voters {
+    
+    // Responses collected for previous poll should be counted for it. Shard queues drained, so
+    // votes log records of previous poll queued before log will be restarted for new poll.
+    [self flushPendingVotes];
+    for (dispatch_queue_t queue in self.shardQueues) { dispatch_sync(queue, ^{}); }
+    if (poll && !voters) {
+        
+        voters = [SPNPVoterIndex indexWithMaximumCount:kSPNPVoterIndexMaximumVotersCount];
+    }
+    [self setCountersForPoll:poll withVotesCount:votesCount voters:(poll ? voters : nil)];
+    SPNPVoteLog *log = self.voteLog;
+    dispatch_async(self.queue, ^{
+        
+        [log startForPoll:poll withVotesCount:votesCount];
+    });
+}
+
+- (SPNPPoll *)restoreFromVoteLogWithVotesCount:(NSArray * __autoreleasing *)votesCount {
+    
+    __block SPNPPoll *poll = nil;
+    __block NSArray *restoredVotesCount = nil;
+    NSUInteger maximumVotersCount = kSPNPVoterIndexMaximumVotersCount;
+    SPNPVoterIndex *voters = [SPNPVoterIndex indexWithMaximumCount:maximumVotersCount];
+    SPNPVoteLog *log = self.voteLog;
+    dispatch_sync(self.queue, ^{
+        
+        NSArray *logVotesCount = nil;
+        poll = [log restoreVotesCount:&logVotesCount voters:voters];
+        restoredVotesCount = logVotesCount;
+    });
+    if (poll) {
+        
+        [self.pendingMessages makeObjectsPerformSelector:@selector(removeAllObjects)];
+        for (NSMutableData *voterKeys in self.pendingVoterKeys) { voterKeys.length = 0; }
+        [self setCountersForPoll:poll withVotesCount:restoredVotesCount voters:voters];
+    }
+    if (votesCount) { *votesCount = restoredVotesCount; }
+    
+    return poll;
+}
+
+- (void)setCountersForPoll:(SPNPPoll *)poll withVotesCount:(NSArray *)votesCount
+                    voters:(SPNPVoterIndex *)voters {
+    
+    NSUInteger shardsCount = MAX(poll.answerShardsCount.unsignedIntegerValue, 1);
+    NSMutableArray *pendingMessages = [NSMutableArray arrayWithCapacity:shardsCount];
+    NSMutableArray *pendingVoterKeys = [NSMutableArray arrayWithCapacity:shardsCount];
+    NSMutableArray *pendingSince = [NSMutableArray arrayWithCapacity:shardsCount];
+    for (NSUInteger shardIdx = 0; shardIdx < shardsCount; shardIdx++) {
+        
+        [pendingMessages addObject:[NSMutableArray new]];
+        [pendingVoterKeys addObject:[NSMutableData new]];
+        [pendingSince addObject:@0];
+        if (shardIdx >= self.shardQueues.count) {
+            
+            [self.shardQueues addObject:dispatch_queue_create("com.pubnub.poll.votes.shard",
+                                                              DISPATCH_QUEUE_SERIAL)];
+        }
+    }
+    self.pollIdentifier = poll.identifier;
+    self.pollToken = poll.token;
+    self.poll = poll;
+    self.snapshotVotesCount = 0;
+    self.counters = [SPNPVoteCounters countersWithVotesCount:(poll ? votesCount : nil)
+                                                 shardsCount:shardsCount];
+    self.voters = (voters ? [self shardedVoters:voters forPoll:poll] : nil);
+    self.pendingMessages = pendingMessages;
+    self.pendingVoterKeys = pendingVoterKeys;
+    self.pendingSince = pendingSince;
+    self.voteTraces = nil;
+}
+
+- (NSArray *)shardedVoters:(SPNPVoterIndex *)voters forPoll:(SPNPPoll *)poll {
+    
+    NSUInteger shardsCount = MAX(poll.answerShardsCount.unsignedIntegerValue, 1);
+    if (shardsCount == 1) { return @[voters]; }
+    
+    NSMutableArray *shardVoters = [NSMutableArray arrayWithCapacity:shardsCount];
+    for (NSUInteger shardIdx = 0; shardIdx < shardsCount; shardIdx++) {
+        
+        [shardVoters addObject:[SPNPVoterIndex indexWithMaximumCount:voters.maximumCount]];
+    }
+    [voters enumerateChoicesUsingBlock:^(uint64_t key, NSUInteger choice) {
+        
+        [(SPNPVoterIndex *)shardVoters[[poll answerShardForVoterKey:key]] registerChoice:choice
+                                                                                  forKey:key
+                                                                       replacingExisting:YES];
+    }];
+    
+    return [shardVoters copy];
+}
+
+- (void)mergeRecountedVotesCount:(NSArray *)votesCount voters:(SPNPVoterIndex *)voters
+                  withCompletion:(dispatch_block_t)block {
+    
+    // Votes which has been received before merge should be in voters index at the moment of merge.
+    [self flushPendingVotes];
+    NSUInteger count = self.counters.count;
+    if (!self.pollIdentifier || votesCount.count != count) {
+        
+        dispatch_async(dispatch_get_main_queue(), block);
+        return;
+    }
+    
+    // Recounted votes added to counters at once, so merged counters never drop below exact votes
+    // count while shards remove duplicates.
+    int64_t *changes = calloc(count, sizeof(int64_t));
+    uint64_t recountedVotes = 0;
+    for (NSUInteger counterIdx = 0; changes && counterIdx < count; counterIdx++) {
+        
+        changes[counterIdx] = [votesCount[counterIdx] longLongValue];
+        recountedVotes += (uint64_t)changes[counterIdx];
+    }
+    SPNPVoteCounters *counters = self.counters;
+    [counters applyChanges:changes registeringVotes:recountedVotes inShard:0];
+    free(changes);
+    
+    NSArray *recountedShardVoters = [self shardedVoters:voters forPoll:self.poll];
+    SPNPVoteLog *log = self.voteLog;
+    BOOL allowsVoteChange = self.allowsVoteChange;
+    dispatch_queue_t logQueue = self.queue;
+    dispatch_group_t group = dispatch_group_create();
+    for (NSUInteger shardIdx = 0; shardIdx < counters.shardsCount; shardIdx++) {
+        
+        SPNPVoterIndex *recountedVoters = recountedShardVoters[shardIdx];
+        SPNPVoterIndex *shardVoters = self.voters[shardIdx];
+        dispatch_queue_t queue = self.shardQueues[shardIdx];
+        dispatch_group_async(group, queue, ^{
+            
+            NSData *records = [SPNPVoteAggregator mergeRecountedVoters:recountedVoters
+                                                            intoVoters:shardVoters counters:counters
+                                                                 shard:shardIdx
+                                                    allowingVoteChange:allowsVoteChange];
+            if (log && records.length) {
+                
+                if (queue == logQueue) { [SPNPVoteAggregator appendRecords:records toLog:log]; }
+                else {
+                    
+                    dispatch_group_async(group, logQueue, ^{
+                        
+                        [SPNPVoteAggregator appendRecords:records toLog:log];
+                    });
+                }
+            }
+        });
+    }
+    dispatch_group_notify(group, dispatch_get_main_queue(), block);
+}
+
++ (NSData *)mergeRecountedVoters:(SPNPVoterIndex *)recountedVoters
+                      intoVoters:(SPNPVoterIndex *)voters counters:(SPNPVoteCounters *)counters
+                           shard:(NSUInteger)shardIndex allowingVoteChange:(BOOL)allowsVoteChange {
+    
+    NSUInteger count = counters.count;
+    int64_t *changes = calloc(count, sizeof(int64_t));
+    __block uint64_t mergedVotes = 0;
+    NSMutableData *records = [NSMutableData new];
+    [recountedVoters enumerateChoicesUsingBlock:^(uint64_t key, NSUInteger choice) {
+        
+        NSUInteger aggregatedChoice = [voters registerChoice:choice forKey:key
+                                           replacingExisting:!allowsVoteChange];
+        
+        // Recounted vote of voter which can't be tracked stay counted.
+        if (!changes || choice >= count || aggregatedChoice == kSPNPVoterIndexFull) { return; }
+        
+        // Voter's vote has been received only from history.
+        if (aggregatedChoice == NSNotFound) {
+            
+            SPNPVoteRecord record = { .voter = key, .choice = (uint32_t)choice,
+                                      .previousChoice = UINT32_MAX };
+            [records appendBytes:&record length:sizeof(SPNPVoteRecord)];
+        }
+        // Aggregated vote is latest, so recounted vote should be removed.
+        else if (allowsVoteChange || aggregatedChoice == choice) { changes[choice]--; }
+        
+        // Recounted vote is first, so aggregated vote should be removed.
+        else {
+            
+            if (aggregatedChoice < count) { changes[aggregatedChoice]--; }
+            SPNPVoteRecord record = { .voter = key, .choice = (uint32_t)choice,
+                                      .previousChoice = (uint32_t)aggregatedChoice };
+            [records appendBytes:&record length:sizeof(SPNPVoteRecord)];
+        }
+        mergedVotes++;
+    }];
+    
+    [counters applyChanges:changes registeringVotes:mergedVotes inShard:shardIndex];
+    free(changes);
+    
+    return records;
+}
+
+
+#pragma mark - Aggregation
+
+- (void)registerVoteFromMessage:(id)message fromVoter:(NSString *)voter {
+    
+    [self registerVoteFromMessage:message fromVoter:voter inShard:0];
+}
+
+- (void)registerVoteFromMessage:(id)message fromVoter:(NSString *)voter
+                        inShard:(NSUInteger)shardIndex {
+    
+    if (self.pollIdentifier && message && shardIndex < self.pendingMessages.count) {
+        
+        // Vote can't be attributed to the voter which is unknown or sent it through shard channel
+        // assigned to other voters (voter would be able to vote once for every shard).
+        uint64_t voterKey = ([voter isKindOfClass:NSString.class] ?
+                             [SPNPVoterIndex keyForVoter:voter] : 0);
+        if (!voterKey || [self.poll answerShardForVoterKey:voterKey] != shardIndex) {
+            
+            [self.metrics incrementCounter:SPNPDroppedVotesCounter by:1];
+            return;
+        }
+        
+        NSMutableArray *pendingMessages = self.pendingMessages[shardIndex];
+        if (!pendingMessages.count) { self.pendingSince[shardIndex] = [SPNPVoteTrace currentTime]; }
+        [pendingMessages addObject:message];
+        [self.pendingVoterKeys[shardIndex] appendBytes:&voterKey length:sizeof(uint64_t)];
+        if (pendingMessages.count >= self.maximumBatchSize) {
+            
+            [self flushPendingVotesInShard:shardIndex];
+        }
+        else if (!self.isFlushScheduled) {
+            
+            self.flushScheduled = YES;
+            __weak __typeof(self) weakSelf = self;
+            dispatch_time_t time = dispatch_time(DISPATCH_TIME_NOW,
+                                                 (int64_t)(self.batchLatency * NSEC_PER_SEC));
+            dispatch_after(time, dispatch_get_main_queue(), ^{
+                
+                [weakSelf flushPendingVotes];
+            });
+        }
+    }
+}
+
+- (void)flushPendingVotes {
+    
+    self.flushScheduled = NO;
+    for (NSUInteger shardIdx = 0; shardIdx < self.pendingMessages.count; shardIdx++) {
+        
+        [self flushPendingVotesInShard:shardIdx];
+    }
+}
+
+- (void)flushPendingVotesInShard:(NSUInteger)shardIndex {
+    
+    NSMutableArray *pendingMessages = self.pendingMessages[shardIndex];
+    if (pendingMessages.count) {
+        
+        NSArray *messages = [pendingMessages copy];
+        NSMutableData *pendingVoterKeys = self.pendingVoterKeys[shardIndex];
+        NSData *voterKeys = [pendingVoterKeys copy];
+        NSString *pollIdentifier = self.pollIdentifier;
+        NSNumber *pollToken = self.pollToken;
+        SPNPVoteCounters *counters = self.counters;
+        SPNPVoterIndex *voters = self.voters[shardIndex];
+        SPNPVoteLog *log = self.voteLog;
+        SPNPMetrics *metrics = self.metrics;
+        BOOL allowsVoteChange = self.allowsVoteChange;
+        dispatch_queue_t logQueue = self.queue;
+        dispatch_queue_t queue = self.shardQueues[shardIndex];
+        NSNumber *receivedTime = self.pendingSince[shardIndex];
+        [pendingMessages removeAllObjects];
+        pendingVoterKeys.length = 0;
+        __weak __typeof(self) weakSelf = self;
+        dispatch_async(queue, ^{
+            
+            uint64_t startTime = [SPNPMetrics currentTime];
+            NSArray *traces = nil;
+            NSUInteger untrackedVotes = 0;
+            NSData *records = [SPNPVoteAggregator countVotesFromMessages:messages forPoll:pollIdentifier
+                                                                   token:pollToken counters:counters
+                                                                   shard:shardIndex
+                                                               voterKeys:voterKeys voters:voters
+                                                      allowingVoteChange:allowsVoteChange
+                                                            receivedTime:receivedTime
+                                                                  traces:&traces
+                                                          untrackedVotes:&untrackedVotes];
+            [metrics recordLatency:SPNPVotesAggregationLatency since:startTime];
+            if (traces) {
+                
+                dispatch_async(dispatch_get_main_queue(), ^{
+                    
+                    [weakSelf addVoteTraces:traces forPoll:pollIdentifier];
+                });
+            }
+            [metrics incrementCounter:SPNPCountedVotesCounter
+                                   by:(records.length / sizeof(SPNPVoteRecord))];
+            [metrics incrementCounter:SPNPUntrackedVotesCounter by:untrackedVotes];
+            if (log && records.length) {
+                
+                if (queue == logQueue) { [SPNPVoteAggregator appendRecords:records toLog:log]; }
+                else {
+                    
+                    dispatch_async(logQueue, ^{
+                        
+                        [SPNPVoteAggregator appendRecords:records toLog:log];
+                    });
+                }
+            }
+        });
+    }
+}
+
++ (NSData *)countVotesFromMessages:(NSArray *)messages forPoll:(NSString *)pollIdentifier
+                             token:(NSNumber *)pollToken counters:(SPNPVoteCounters *)counters
+                             shard:(NSUInteger)shardIndex voterKeys:(NSData *)voterKeys
+                            voters:(SPNPVoterIndex *)voters
+                allowingVoteChange:(BOOL)allowsVoteChange receivedTime:(NSNumber *)receivedTime
+                            traces:(NSArray * __autoreleasing *)traces
+                    untrackedVotes:(NSUInteger *)untrackedVotes {
+    
+    NSMutableArray *tracedVotes = nil;
+    NSUInteger count = counters.count;
+    int64_t *changes = calloc(count, sizeof(int64_t));
+    uint64_t countedVotes = 0;
+    NSUInteger untracked = 0;
+    NSMutableData *records = [NSMutableData dataWithCapacity:(messages.count * sizeof(SPNPVoteRecord))];
+    
+    // Only response order and voter required to count vote, so they projected right from messages.
+    // Voter identifier from message payload ignored, because it can be spoofed by attendee.
+    SPNPCompactCoder *decoder = [SPNPCompactCoder reusableDecoderForPoll:pollIdentifier token:pollToken];
+    const uint64_t *keys = (const uint64_t *)voterKeys.bytes;
+    for (NSUInteger messageIdx = 0; messageIdx < messages.count; messageIdx++) {
+        
+        id message = messages[messageIdx];
+        NSUInteger order = 0;
+        uint64_t payloadVoterKey = 0;
+        uint64_t traceTime = 0;
+        uint64_t voterKey = keys[messageIdx];
+        BOOL isVote = [SPNPPollResponse readVoteFromMessage:message forPoll:pollIdentifier
+                                               usingDecoder:decoder order:&order
+                                                   voterKey:&payloadVoterKey traceTime:&traceTime];
+        if (changes && isVote && order < count) {
+            
+            NSUInteger previousOrder = [voters registerChoice:order forKey:voterKey
+                                            replacingExisting:allowsVoteChange];
+            
+            // Repeated votes of voter which can't be tracked won't be detected, but vote counted as
+            // first one (so votes aren't lost when index is full) and reported as untracked.
+            if (previousOrder == kSPNPVoterIndexFull) {
+                
+                previousOrder = NSNotFound;
+                untracked++;
+            }
+            
+            // Vote counted only if this is first attendee's vote or he changed his choice.
+            if (previousOrder == NSNotFound || (allowsVoteChange && previousOrder != order)) {
+                
+                if (previousOrder != NSNotFound && previousOrder < count) { changes[previousOrder]--; }
+                changes[order]++;
+                countedVotes++;
+                SPNPVoteRecord record = {
+                    .voter = voterKey, .choice = (uint32_t)order,
+                    .previousChoice = (previousOrder != NSNotFound ? (uint32_t)previousOrder : UINT32_MAX)
+                };
+                [records appendBytes:&record length:sizeof(SPNPVoteRecord)];
+                if (traceTime) {
+                    
+                    if (!tracedVotes) { tracedVotes = [NSMutableArray new]; }
+                    [tracedVotes addObject:@[@(voterKey), @(traceTime)]];
+                }
+            }
+        }
+    }
+    
+    [counters applyChanges:changes registeringVotes:countedVotes inShard:shardIndex];
+    free(changes);
+    if (untrackedVotes) { *untrackedVotes = untracked; }
+    
+    // Traced votes considered aggregated only after counters has been updated.
+    if (tracedVotes && traces) {
+        
+        NSNumber *aggregatedTime = [SPNPVoteTrace currentTime];
+        NSMutableArray *votesTraces = [NSMutableArray arrayWithCapacity:tracedVotes.count];
+        for (NSArray *vote in tracedVotes) {
+            
+            SPNPVoteTrace *trace = [SPNPVoteTrace traceForVoterKey:[vote[0] unsignedLongLongValue]
+                                                          sentTime:vote[1] receivedTime:receivedTime
+                                                    aggregatedTime:aggregatedTime
+                                                     publishedTime:nil];
+            [votesTraces addObject:trace];
+        }
+        *traces = votesTraces;
+    }
+    
+    return records;
+}
+
+- (void)addVoteTraces:(NSArray *)traces forPoll:(NSString *)pollIdentifier {
+    
+    // Traces for previous poll shouldn't be published with statistic of new poll.
+    if ([pollIdentifier isEqualToString:self.pollIdentifier]) {
+        
+        if (!self.voteTraces) { self.voteTraces = [NSMutableArray new]; }
+        for (SPNPVoteTrace *trace in traces) {
+            
+            if (self.voteTraces.count >= kSPNPMaximumPendingVoteTraces) { break; }
+            [self.voteTraces addObject:trace];
+        }
+    }
+}
+
+- (NSArray *)dequeueVoteTraces {
+    
+    NSArray *traces = (self.voteTraces.count ? [self.voteTraces copy] : nil);
+    [self.voteTraces removeAllObjects];
+    
+    return traces;
+}
+
++ (void)appendRecords:(NSData *)records toLog:(SPNPVoteLog *)log {
+    
+    const SPNPVoteRecord *values = (const SPNPVoteRecord *)records.bytes;
+    NSUInteger count = (records.length / sizeof(SPNPVoteRecord));
+    for (NSUInteger recordIdx = 0; recordIdx < count; recordIdx++) {
+        
+        NSUInteger previousChoice = (values[recordIdx].previousChoice != UINT32_MAX ?
+                                     values[recordIdx].previousChoice : NSNotFound);
+        [log appendChoice:values[recordIdx].choice previousChoice:previousChoice
+                 forVoter:values[recordIdx].voter];
+    }
+}
+
+- (NSArray *)votesCountIfChanged {
+    
+    // Shards counters merged only when snapshot is taken.
+    NSMutableArray *votesCount = nil;
+    NSUInteger count = self.counters.count;
+    if ([self hasVotesSinceSnapshot]) {
+        
+        votesCount = [NSMutableArray arrayWithCapacity:count];
+        for (NSUInteger counterIdx = 0; counterIdx < count; counterIdx++) {
+            
+            [votesCount addObject:@([self.counters votesCountAtIndex:counterIdx])];
+        }
+    }
+    
+    return [votesCount copy];
+}
+
+- (NSIndexSet *)updateVotesCountInStore:(SPNPStatisticStore *)store {
+    
+    NSMutableIndexSet *changedIndexes = nil;
+    NSUInteger count = self.counters.count;
+    if (store && store.count == count && [self hasVotesSinceSnapshot]) {
+        
+        changedIndexes = [NSMutableIndexSet new];
+        for (NSUInteger counterIdx = 0; counterIdx < count; counterIdx++) {
+            
+            // Votes counted using response order as counter index.
+            NSUInteger responseIdx = [store indexForOrder:counterIdx];
+            if ([store setVotesCount:[self.counters votesCountAtIndex:counterIdx]
+                             atIndex:responseIdx]) {
+                
+                [changedIndexes addIndex:responseIdx];
+            }
+        }
+    }
+    
+    return changedIndexes;
+}
+
+
+#pragma mark - Snapshot
+
+- (BOOL)hasVotesSinceSnapshot {
+    
+    uint64_t registeredVotesCount = [self.counters registeredVotesCount];
+    BOOL hasVotes = (registeredVotesCount != self.snapshotVotesCount);
+    self.snapshotVotesCount = registeredVotesCount;
+    
+    return hasVotes;
+}
+
+#pragma mark -
+
+
+@end
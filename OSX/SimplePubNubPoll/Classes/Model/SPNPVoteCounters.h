@@ -0,0 +1,83 @@
+#import <Foundation/Foundation.h>
+
+
+/**
+ @brief      Sharded storage of poll votes counters.
+ @discussion Each shard has own set of atomic counters (one for each response variant and one more
+             for number of registered votes) placed on separate cache lines, so shards update
+             counters from their queues without contention. Counters of all shards merged only when
+             they are read.
+             Counters can be updated and read from any thread.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPVoteCounters : NSObject
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores number of response variants which votes counted.
+ */
+@property (nonatomic, readonly, assign) NSUInteger count;
+
+/**
+ @brief  Stores number of shards which has own counters.
+ */
+@property (nonatomic, readonly, assign) NSUInteger shardsCount;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure votes counters.
+ 
+ @param votesCount  List of initial votes count for each response variant (stored by first shard).
+ @param shardsCount Number of shards which will update counters.
+ 
+ @return Configured and ready to use votes counters.
+ */
++ (instancetype)countersWithVotesCount:(NSArray *)votesCount shardsCount:(NSUInteger)shardsCount;
+
+
+///------------------------------------------------
+/// @name Counters
+///------------------------------------------------
+
+/**
+ @brief      Apply votes count changes to shard's counters.
+ @discussion Number of registered votes updated after response variant counters, so reader which
+             observed new registered votes count will see all changes.
+ 
+ @param changes    Pointer on votes count changes for each response variant.
+ @param votes      Number of votes which has been registered with \c changes.
+ @param shardIndex Index of shard which counters should be updated.
+ */
+- (void)applyChanges:(const int64_t *)changes registeringVotes:(uint64_t)votes
+             inShard:(NSUInteger)shardIndex;
+
+/**
+ @brief  Merge shards counters of response variant.
+ 
+ @param counterIdx Index of response variant counter.
+ 
+ @return Votes count which has been registered by all shards.
+ */
+- (uint64_t)votesCountAtIndex:(NSUInteger)counterIdx;
+
+/**
+ @brief  Merge number of registered votes from all shards.
+ 
+ @return Number of votes which has been registered by all shards.
+ */
+- (uint64_t)registeredVotesCount;
+
+#pragma mark -
+
+
+@end
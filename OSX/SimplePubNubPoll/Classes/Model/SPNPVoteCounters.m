@@ -0,0 +1,165 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPVoteCounters.h"
+#import <stdatomic.h>
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores size of storage which is reserved for each shard counters to keep them on separate
+         cache lines.
+ */
+static NSUInteger const kSPNPVoteCountersAlignment = 64;
+
+
+#pragma mark - Types
+
+/**
+ @brief  Type of counters which is used to store votes count.
+ */
+typedef _Atomic(uint64_t) SPNPVoteCounter;
+
+
+#pragma mark - Private interface declaration
+
+@interface SPNPVoteCounters ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, assign) NSUInteger count;
+@property (nonatomic, assign) NSUInteger shardsCount;
+
+/**
+ @brief  Stores number of counters which is reserved for each shard (including padding).
+ */
+@property (nonatomic, assign) NSUInteger stride;
+
+/**
+ @brief  Stores pointer on counters storage of all shards.
+ */
+@property (nonatomic, assign) SPNPVoteCounter *values;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Retrieve pointer on counters of specified shard.
+ 
+ @param shardIndex Index of shard for which counters should be returned.
+ 
+ @return Pointer on first shard counter.
+ */
+- (SPNPVoteCounter *)countersOfShard:(NSUInteger)shardIndex;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPVoteCounters
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)countersWithVotesCount:(NSArray *)votesCount shardsCount:(NSUInteger)shardsCount {
+    
+    SPNPVoteCounters *counters = [self new];
+    NSUInteger counterSize = sizeof(SPNPVoteCounter);
+    NSUInteger shardSize = ((votesCount.count + 1) * counterSize + kSPNPVoteCountersAlignment - 1);
+    shardSize -= (shardSize % kSPNPVoteCountersAlignment);
+    counters.count = votesCount.count;
+    counters.shardsCount = MAX(shardsCount, 1);
+    counters.stride = (shardSize / counterSize);
+    NSUInteger size = (shardSize * counters.shardsCount);
+    void *values = NULL;
+    if (posix_memalign(&values, kSPNPVoteCountersAlignment, size) == 0) {
+        
+        counters.values = (SPNPVoteCounter *)values;
+        for (NSUInteger counterIdx = 0; counterIdx < counters.stride * counters.shardsCount;
+             counterIdx++) {
+            
+            atomic_init(&counters.values[counterIdx], 0);
+        }
+        
+        // Initial votes count stored by first shard, so merged counters start from it.
+        for (NSUInteger counterIdx = 0; counterIdx < counters.count; counterIdx++) {
+            
+            atomic_init(&counters.values[counterIdx],
+                        [votesCount[counterIdx] unsignedLongLongValue]);
+        }
+    }
+    else { counters.count = 0; }
+    
+    return counters;
+}
+
+- (void)dealloc {
+    
+    free(_values);
+}
+
+
+#pragma mark - Counters
+
+- (void)applyChanges:(const int64_t *)changes registeringVotes:(uint64_t)votes
+             inShard:(NSUInteger)shardIndex {
+    
+    SPNPVoteCounter *values = [self countersOfShard:shardIndex];
+    if (!values || !votes) { return; }
+    
+    for (NSUInteger counterIdx = 0; counterIdx < self.count; counterIdx++) {
+        
+        if (changes[counterIdx] != 0) {
+            
+            atomic_fetch_add_explicit(&values[counterIdx], (uint64_t)changes[counterIdx],
+                                      memory_order_relaxed);
+        }
+    }
+    atomic_fetch_add_explicit(&values[self.count], votes, memory_order_release);
+}
+
+- (uint64_t)votesCountAtIndex:(NSUInteger)counterIdx {
+    
+    uint64_t votes = 0;
+    for (NSUInteger shardIdx = 0; counterIdx < self.count && shardIdx < self.shardsCount;
+         shardIdx++) {
+        
+        votes += atomic_load_explicit(&[self countersOfShard:shardIdx][counterIdx],
+                                      memory_order_relaxed);
+    }
+    
+    return votes;
+}
+
+- (uint64_t)registeredVotesCount {
+    
+    uint64_t votes = 0;
+    for (NSUInteger shardIdx = 0; self.values && shardIdx < self.shardsCount; shardIdx++) {
+        
+        votes += atomic_load_explicit(&[self countersOfShard:shardIdx][self.count],
+                                      memory_order_acquire);
+    }
+    
+    return votes;
+}
+
+
+#pragma mark - Misc
+
+- (SPNPVoteCounter *)countersOfShard:(NSUInteger)shardIndex {
+    
+    return (self.values && shardIndex < self.shardsCount ? &self.values[shardIndex * self.stride] :
+            NULL);
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,129 @@
+#import <Foundation/Foundation.h>
+
+
+#pragma mark Class forward
+
+@class SPNPVoterIndex, SPNPPoll;
+
+
+/**
+ @brief      Host side durable log of accepted votes.
+ @discussion Log consists of two files: memory-mapped append-only file with fixed size records
+             (voter fingerprint, chosen and previously chosen response order) and compact snapshot
+             which store active poll and votes count for each response variant at some log
+             position. Snapshot rewritten periodically, so host which has been restarted read
+             snapshot and replay only records which has been appended after it to get exact votes
+             count without network round-trips.
+             Records written into shared file mapping, so they survive process termination without
+             explicit flush. Mapping synchronized with disk asynchronously each time when snapshot
+             is written.
+             Log is not thread-safe and should be used from single queue.
+
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPVoteLog : NSObject
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on path to the file which store log records.
+ */
+@property (nonatomic, readonly, copy) NSString *path;
+
+/**
+ @brief  Stores number of records which has been written into log for active poll.
+ */
+@property (nonatomic, readonly, assign) NSUInteger recordsCount;
+
+/**
+ @brief      Stores number of records after which new snapshot should be written.
+ @discussion Smaller interval reduce number of records which should be replayed during restore.
+             Default value is \c 16384.
+ */
+@property (nonatomic, assign) NSUInteger snapshotInterval;
+
+/**
+ @brief  Retrieve path which should be used by host to store votes log.
+
+ @param identifier Reference on unique host identifier.
+
+ @return Path inside of application support directory.
+ */
++ (NSString *)defaultPathForHost:(NSString *)identifier;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure votes log.
+
+ @param path Reference on path to the file which should store log records (snapshot stored next to
+             it).
+
+ @return Configured and ready to use votes log.
+ */
++ (instancetype)logWithPath:(NSString *)path;
+
+
+///------------------------------------------------
+/// @name State management
+///------------------------------------------------
+
+/**
+ @brief      Start new log for poll.
+ @discussion Previous log and snapshot removed and initial snapshot written for new poll.
+
+ @param poll       Reference on poll for which votes will be logged or \c nil to remove log.
+ @param votesCount List of initial votes count for each response variant (sorted by response
+                   order).
+ */
+- (void)startForPoll:(SPNPPoll *)poll withVotesCount:(NSArray *)votesCount;
+
+/**
+ @brief      Restore log which has been written by previous host session.
+ @discussion Votes count read from snapshot and updated with records appended after it. All records
+             replayed into voters index, so attendees won't be able to vote twice after restart.
+             New records will be appended to restored log.
+
+ @param votesCount Reference on pointer which will store list of votes count for each response
+                   variant (sorted by response order).
+ @param voters     Reference on index into which voters choices should be registered.
+
+ @return Reference on poll for which log has been written or \c nil in case if there is no log or
+         it is damaged.
+ */
+- (SPNPPoll *)restoreVotesCount:(NSArray * __autoreleasing *)votesCount
+                         voters:(SPNPVoterIndex *)voters;
+
+
+///------------------------------------------------
+/// @name Records
+///------------------------------------------------
+
+/**
+ @brief  Append accepted vote to the log.
+
+ @param choice         Response order number which has been chosen by voter.
+ @param previousChoice Response order number which has been chosen by voter before or
+                       \c NSNotFound in case if this is first voter's vote.
+ @param voterKey       Voter fingerprint (computed with \b SPNPVoterIndex) or \c 0 for anonymous
+                       vote.
+ */
+- (void)appendChoice:(NSUInteger)choice previousChoice:(NSUInteger)previousChoice
+            forVoter:(uint64_t)voterKey;
+
+/**
+ @brief  Write snapshot for current log position.
+ */
+- (void)writeSnapshot;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,471 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPVoteLog.h"
+#import "SPNPCompactCoder.h"
+#import "SPNPVoterIndex.h"
+#import <sys/mman.h>
+#import "SPNPPoll.h"
+#import <sys/stat.h>
+#import <unistd.h>
+#import <fcntl.h>
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores value which is written at the beginning of log file ('SPVL').
+ */
+static uint32_t const kSPNPVoteLogMagic = 0x4C565053;
+
+/**
+ @brief  Stores version of log and snapshot format.
+ */
+static uint32_t const kSPNPVoteLogVersion = 1;
+
+/**
+ @brief  Stores number of records for which space reserved when log created.
+ */
+static NSUInteger const kSPNPVoteLogInitialCapacity = 65536;
+
+/**
+ @brief  Stores default number of records after which new snapshot written.
+ */
+static NSUInteger const kSPNPVoteLogDefaultSnapshotInterval = 16384;
+
+/**
+ @brief  Stores value which is used in record when voter didn't choose anything before.
+ */
+static uint32_t const kSPNPVoteLogNoChoice = UINT32_MAX;
+
+
+#pragma mark - Types
+
+/**
+ @brief  Describes log file header.
+ */
+typedef struct {
+
+    uint32_t magic;
+    uint32_t version;
+
+    /**
+     @brief  Random value which bind log file to the snapshot which has been written for it.
+     */
+    uint64_t generation;
+
+    /**
+     @brief  Number of records which has been completely written (updated after record).
+     */
+    uint64_t recordsCount;
+    uint64_t reserved;
+} SPNPVoteLogHeader;
+
+/**
+ @brief  Describes single accepted vote.
+ */
+typedef struct {
+
+    uint64_t voter;
+    uint32_t choice;
+    uint32_t previousChoice;
+} SPNPVoteLogRecord;
+
+
+#pragma mark - Private interface declaration
+
+@interface SPNPVoteLog ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, copy) NSString *path;
+
+/**
+ @brief  Stores reference on path to the file which store log snapshot.
+ */
+@property (nonatomic, copy) NSString *snapshotPath;
+
+/**
+ @brief  Stores reference on poll for which votes logged.
+ */
+@property (nonatomic, strong) SPNPPoll *poll;
+
+/**
+ @brief  Stores reference on votes count for each response variant (\c uint64_t values).
+ */
+@property (nonatomic, strong) NSMutableData *counters;
+
+/**
+ @brief  Stores log file descriptor (\c -1 if log not opened).
+ */
+@property (nonatomic, assign) int fileDescriptor;
+
+/**
+ @brief  Stores reference on mapped log file and it's length.
+ */
+@property (nonatomic, assign) SPNPVoteLogHeader *header;
+@property (nonatomic, assign) size_t mappedLength;
+
+/**
+ @brief  Stores number of records for which there is space in mapped file.
+ */
+@property (nonatomic, assign) NSUInteger capacity;
+
+/**
+ @brief  Stores number of records which has been taken into account by last written snapshot.
+ */
+@property (nonatomic, assign) NSUInteger snapshotRecordsCount;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize votes log.
+
+ @param path Reference on path to the file which should store log records.
+
+ @return Initialized and ready to use votes log.
+ */
+- (instancetype)initWithPath:(NSString *)path;
+
+
+#pragma mark - File
+
+/**
+ @brief  Open log file.
+
+ @param shouldCreate Whether file should be created if it doesn't exist.
+
+ @return \c YES in case if file has been opened.
+ */
+- (BOOL)openCreatingFile:(BOOL)shouldCreate;
+
+/**
+ @brief      Map log file with space for specified number of records.
+ @discussion File extended if required.
+
+ @param capacity Number of records for which there should be space in mapped file.
+
+ @return \c YES in case if file has been mapped.
+ */
+- (BOOL)mapWithCapacity:(NSUInteger)capacity;
+
+/**
+ @brief  Unmap and close log file.
+ */
+- (void)close;
+
+
+#pragma mark - Snapshot
+
+/**
+ @brief  Read snapshot and validate it against opened log file.
+
+ @return \c YES in case if snapshot has been written for opened log.
+ */
+- (BOOL)readSnapshot;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Retrieve reference on first log record.
+
+ @return Pointer on first record in mapped log file.
+ */
+- (SPNPVoteLogRecord *)records;
+
+/**
+ @brief  Apply record to votes counters.
+
+ @param record Reference on record which should be applied.
+ */
+- (void)applyRecord:(const SPNPVoteLogRecord *)record;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPVoteLog
+
+
+#pragma mark - Information
+
+- (NSUInteger)recordsCount {
+    
+    return (self.header ? (NSUInteger)self.header->recordsCount : 0);
+}
+
++ (NSString *)defaultPathForHost:(NSString *)identifier {
+    
+    NSString *directory = NSSearchPathForDirectoriesInDomains(NSApplicationSupportDirectory,
+                                                              NSUserDomainMask, YES).firstObject;
+    directory = [(directory?: NSTemporaryDirectory()) stringByAppendingPathComponent:@"SimplePubNubPoll"];
+    [[NSFileManager defaultManager] createDirectoryAtPath:directory withIntermediateDirectories:YES
+                                               attributes:nil error:nil];
+    
+    return [directory stringByAppendingPathComponent:[identifier stringByAppendingString:@".votes"]];
+}
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)logWithPath:(NSString *)path {
+    
+    return [[self alloc] initWithPath:path];
+}
+
+- (instancetype)initWithPath:(NSString *)path {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _path = [path copy];
+        _snapshotPath = [_path stringByAppendingPathExtension:@"snapshot"];
+        _snapshotInterval = kSPNPVoteLogDefaultSnapshotInterval;
+        _fileDescriptor = -1;
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    
+    [self close];
+}
+
+
+#pragma mark - State management
+
+- (void)startForPoll:(SPNPPoll *)poll withVotesCount:(NSArray *)votesCount {
+    
+    [self close];
+    unlink(self.path.fileSystemRepresentation);
+    unlink(self.snapshotPath.fileSystemRepresentation);
+    self.poll = poll;
+    self.counters = nil;
+    if (poll && [self openCreatingFile:YES] && [self mapWithCapacity:kSPNPVoteLogInitialCapacity]) {
+        
+        self.counters = [NSMutableData dataWithLength:(poll.responses.count * sizeof(uint64_t))];
+        uint64_t *counters = (uint64_t *)self.counters.mutableBytes;
+        for (NSUInteger counterIdx = 0; counterIdx < poll.responses.count; counterIdx++) {
+            
+            counters[counterIdx] = (counterIdx < votesCount.count ?
+                                    [votesCount[counterIdx] unsignedLongLongValue] : 0);
+        }
+        self.header->magic = kSPNPVoteLogMagic;
+        self.header->version = kSPNPVoteLogVersion;
+        self.header->generation = (((uint64_t)arc4random() << 32) | arc4random());
+        self.header->recordsCount = 0;
+        [self writeSnapshot];
+    }
+    else if (poll) { [self close]; }
+}
+
+- (SPNPPoll *)restoreVotesCount:(NSArray * __autoreleasing *)votesCount
+                         voters:(SPNPVoterIndex *)voters {
+    
+    [self close];
+    BOOL isRestored = ([self openCreatingFile:NO] && [self mapWithCapacity:0] && [self readSnapshot]);
+    if (isRestored) {
+        
+        // Only records which has been appended after snapshot should be applied to counters.
+        SPNPVoteLogRecord *records = [self records];
+        NSUInteger recordsCount = self.recordsCount;
+        for (NSUInteger recordIdx = 0; recordIdx < recordsCount; recordIdx++) {
+            
+            if (recordIdx >= self.snapshotRecordsCount) { [self applyRecord:&records[recordIdx]]; }
+            if (records[recordIdx].voter) {
+                
+                [voters registerChoice:records[recordIdx].choice forKey:records[recordIdx].voter
+                     replacingExisting:YES];
+            }
+        }
+        
+        if (votesCount) {
+            
+            const uint64_t *counters = (const uint64_t *)self.counters.bytes;
+            NSUInteger count = (self.counters.length / sizeof(uint64_t));
+            NSMutableArray *restoredVotesCount = [NSMutableArray arrayWithCapacity:count];
+            for (NSUInteger counterIdx = 0; counterIdx < count; counterIdx++) {
+                
+                [restoredVotesCount addObject:@(counters[counterIdx])];
+            }
+            *votesCount = [restoredVotesCount copy];
+        }
+    }
+    else {
+        
+        [self close];
+        self.poll = nil;
+        self.counters = nil;
+    }
+    
+    return self.poll;
+}
+
+
+#pragma mark - Records
+
+- (void)appendChoice:(NSUInteger)choice previousChoice:(NSUInteger)previousChoice
+            forVoter:(uint64_t)voterKey {
+    
+    NSUInteger recordsCount = self.recordsCount;
+    if (self.header && (recordsCount < self.capacity || [self mapWithCapacity:(self.capacity * 2)])) {
+        
+        SPNPVoteLogRecord *record = &[self records][recordsCount];
+        record->voter = voterKey;
+        record->choice = (uint32_t)choice;
+        record->previousChoice = (previousChoice < kSPNPVoteLogNoChoice ? (uint32_t)previousChoice :
+                                  kSPNPVoteLogNoChoice);
+        [self applyRecord:record];
+        
+        // Record counted only after it has been completely written.
+        self.header->recordsCount = recordsCount + 1;
+        if (recordsCount + 1 - self.snapshotRecordsCount >= self.snapshotInterval) {
+            
+            [self writeSnapshot];
+        }
+    }
+}
+
+
+#pragma mark - File
+
+- (BOOL)openCreatingFile:(BOOL)shouldCreate {
+    
+    int flags = (O_RDWR | (shouldCreate ? O_CREAT : 0));
+    self.fileDescriptor = open(self.path.fileSystemRepresentation, flags, 0644);
+    
+    return (self.fileDescriptor >= 0);
+}
+
+- (BOOL)mapWithCapacity:(NSUInteger)capacity {
+    
+    BOOL isMapped = NO;
+    struct stat fileStatus;
+    if (self.fileDescriptor >= 0 && fstat(self.fileDescriptor, &fileStatus) == 0) {
+        
+        // Existing file never truncated, so records which has been written before won't be lost.
+        size_t length = (sizeof(SPNPVoteLogHeader) + capacity * sizeof(SPNPVoteLogRecord));
+        length = MAX(length, (size_t)fileStatus.st_size);
+        if (length >= sizeof(SPNPVoteLogHeader) &&
+            (length == (size_t)fileStatus.st_size || ftruncate(self.fileDescriptor, (off_t)length) == 0)) {
+            
+            void *mapping = mmap(NULL, length, (PROT_READ | PROT_WRITE), MAP_SHARED,
+                                 self.fileDescriptor, 0);
+            if (mapping != MAP_FAILED) {
+                
+                if (self.header) { munmap(self.header, self.mappedLength); }
+                self.header = (SPNPVoteLogHeader *)mapping;
+                self.mappedLength = length;
+                self.capacity = ((length - sizeof(SPNPVoteLogHeader)) / sizeof(SPNPVoteLogRecord));
+                isMapped = YES;
+            }
+        }
+    }
+    
+    return isMapped;
+}
+
+- (void)close {
+    
+    if (self.header) {
+        
+        msync(self.header, self.mappedLength, MS_ASYNC);
+        munmap(self.header, self.mappedLength);
+    }
+    if (self.fileDescriptor >= 0) { close(self.fileDescriptor); }
+    self.header = NULL;
+    self.mappedLength = 0;
+    self.capacity = 0;
+    self.snapshotRecordsCount = 0;
+    self.fileDescriptor = -1;
+}
+
+
+#pragma mark - Snapshot
+
+- (void)writeSnapshot {
+    
+    if (self.header && self.poll) {
+        
+        msync(self.header, self.mappedLength, MS_ASYNC);
+        const uint64_t *counters = (const uint64_t *)self.counters.bytes;
+        NSUInteger count = (self.counters.length / sizeof(uint64_t));
+        SPNPCompactCoder *coder = [SPNPCompactCoder encoderForPoll:nil token:nil];
+        [coder encodeUnsignedInteger:kSPNPVoteLogVersion];
+        [coder encodeUnsignedInteger:self.header->generation];
+        [coder encodeUnsignedInteger:self.header->recordsCount];
+        [coder encodeString:[self.poll compactRepresentationForPoll:nil token:nil]];
+        [coder encodeUnsignedInteger:count];
+        for (NSUInteger counterIdx = 0; counterIdx < count; counterIdx++) {
+            
+            [coder encodeUnsignedInteger:counters[counterIdx]];
+        }
+        if ([coder.data writeToFile:self.snapshotPath atomically:YES]) {
+            
+            self.snapshotRecordsCount = (NSUInteger)self.header->recordsCount;
+        }
+    }
+}
+
+- (BOOL)readSnapshot {
+    
+    NSData *data = [NSData dataWithContentsOfFile:self.snapshotPath];
+    SPNPCompactCoder *coder = [SPNPCompactCoder decoderWithData:data forPoll:nil token:nil];
+    BOOL isValid = (self.header->magic == kSPNPVoteLogMagic &&
+                    self.header->version == kSPNPVoteLogVersion &&
+                    self.header->recordsCount <= self.capacity);
+    isValid = (isValid && [coder decodeUnsignedInteger] == kSPNPVoteLogVersion);
+    isValid = (isValid && [coder decodeUnsignedInteger] == self.header->generation);
+    uint64_t snapshotRecordsCount = [coder decodeUnsignedInteger];
+    SPNPPoll *poll = [SPNPPoll objectFromCompactRepresentation:[coder decodeString] forPoll:nil
+                                                         token:nil];
+    uint64_t count = [coder decodeUnsignedInteger];
+    isValid = (isValid && poll.isActive && snapshotRecordsCount <= self.header->recordsCount &&
+               count == poll.responses.count);
+    if (isValid) {
+        
+        self.counters = [NSMutableData dataWithLength:((NSUInteger)count * sizeof(uint64_t))];
+        uint64_t *counters = (uint64_t *)self.counters.mutableBytes;
+        for (NSUInteger counterIdx = 0; counterIdx < count; counterIdx++) {
+            
+            counters[counterIdx] = [coder decodeUnsignedInteger];
+        }
+        self.poll = poll;
+        self.snapshotRecordsCount = (NSUInteger)snapshotRecordsCount;
+    }
+    
+    return (isValid && coder.isValid);
+}
+
+
+#pragma mark - Misc
+
+- (SPNPVoteLogRecord *)records {
+    
+    return (SPNPVoteLogRecord *)(self.header + 1);
+}
+
+- (void)applyRecord:(const SPNPVoteLogRecord *)record {
+    
+    uint64_t *counters = (uint64_t *)self.counters.mutableBytes;
+    NSUInteger count = (self.counters.length / sizeof(uint64_t));
+    if (record->choice < count) { counters[record->choice]++; }
+    if (record->previousChoice < count && counters[record->previousChoice] > 0) {
+        
+        counters[record->previousChoice]--;
+    }
+}
+
+#pragma mark -
+
+
+@end
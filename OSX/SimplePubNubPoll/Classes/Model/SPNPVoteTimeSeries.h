@@ -0,0 +1,152 @@
+#import <Foundation/Foundation.h>
+
+
+#pragma mark Types
+
+/**
+ @brief  Time series resolutions.
+ */
+typedef NS_ENUM(NSUInteger, SPNPVoteTimeSeriesResolution) {
+    
+    /**
+     @brief  Last minute of per-second buckets.
+     */
+    SPNPVoteTimeSeriesSecondResolution,
+    
+    /**
+     @brief  Last hour of per-minute buckets.
+     */
+    SPNPVoteTimeSeriesMinuteResolution,
+    
+    /**
+     @brief  Last day of per-hour buckets.
+     */
+    SPNPVoteTimeSeriesHourResolution
+};
+
+
+/**
+ @brief      Per-response votes time series of single poll.
+ @discussion Series stores votes changes in fixed size ring buffers for each resolution, so each
+             recorded change cost constant time and memory usage doesn't depend from session
+             duration. When time move forward oldest buckets of fine resolution dropped while
+             their votes still counted by buckets of coarser resolution.
+             Series should be used from main thread.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPVoteTimeSeries : NSObject
+
+
+///------------------------------------------------
+/// @name Configuration
+///------------------------------------------------
+
+/**
+ @brief  Stores time constant of exponential moving average of votes rate (default value is \c 10
+         seconds).
+ */
+@property (nonatomic, assign) NSTimeInterval averagingPeriod;
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores number of responses for which votes changes recorded.
+ */
+@property (nonatomic, readonly, assign) NSUInteger responsesCount;
+
+/**
+ @brief  Stores number of bytes used by series buckets.
+ */
+@property (nonatomic, readonly, assign) NSUInteger memoryUsage;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure votes time series.
+ 
+ @param responsesCount Number of poll response variants.
+ 
+ @return Configured and ready to use votes time series.
+ */
++ (instancetype)seriesWithResponsesCount:(NSUInteger)responsesCount;
+
+
+///------------------------------------------------
+/// @name Recording
+///------------------------------------------------
+
+/**
+ @brief  Record response votes change.
+ 
+ @param change Number of votes which has been added (or removed if negative) to response.
+ @param order  Order of response variant in poll.
+ @param time   Reference date based time at which change has been counted.
+ */
+- (void)recordChange:(long long)change forResponse:(NSUInteger)order atTime:(NSTimeInterval)time;
+
+/**
+ @brief  Forget all recorded changes.
+ */
+- (void)reset;
+
+
+///------------------------------------------------
+/// @name Trend
+///------------------------------------------------
+
+/**
+ @brief      Compute response votes rate.
+ @discussion Rate computed from buckets with finest resolution which cover requested interval.
+ 
+ @param order    Order of response variant in poll.
+ @param interval Duration of window which ends at \c time.
+ @param time     Reference date based time for which rate should be computed.
+ 
+ @return Average number of votes per second.
+ */
+- (double)rateForResponse:(NSUInteger)order overInterval:(NSTimeInterval)interval
+                   atTime:(NSTimeInterval)time;
+
+/**
+ @brief  Exponential moving average of response votes rate.
+ 
+ @param order Order of response variant in poll.
+ @param time  Reference date based time for which rate should be computed.
+ 
+ @return Smoothed number of votes per second.
+ */
+- (double)averageRateForResponse:(NSUInteger)order atTime:(NSTimeInterval)time;
+
+/**
+ @brief  Response votes changes for all buckets of specified resolution.
+ 
+ @param order      Order of response variant in poll.
+ @param resolution One of \b SPNPVoteTimeSeriesResolution fields.
+ @param time       Reference date based time which is covered by newest bucket.
+ 
+ @return List of votes changes (from oldest to newest bucket).
+ */
+- (NSArray *)seriesForResponse:(NSUInteger)order withResolution:(SPNPVoteTimeSeriesResolution)resolution
+                        atTime:(NSTimeInterval)time;
+
+/**
+ @brief  Per-second votes changes of all responses which can be sent to attendees.
+ 
+ @param time Reference date based time which is covered by newest bucket.
+ 
+ @return List of per-response series (in responses order) of \c SPNPVoteTimeSeriesSecondResolution.
+ */
+- (NSArray *)trendAtTime:(NSTimeInterval)time;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,322 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPVoteTimeSeries.h"
+#import <math.h>
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores number of supported resolutions.
+ */
+#define kSPNPVoteTimeSeriesResolutionsCount 3
+
+/**
+ @brief  Stores duration of single bucket (in seconds) for each resolution.
+ */
+static NSTimeInterval const kSPNPVoteTimeSeriesBucketDurations[kSPNPVoteTimeSeriesResolutionsCount] = {
+    1.0f, 60.0f, 3600.0f
+};
+
+/**
+ @brief  Stores number of buckets in ring buffer of each resolution.
+ */
+static NSUInteger const kSPNPVoteTimeSeriesBucketsCount[kSPNPVoteTimeSeriesResolutionsCount] = {
+    60, 60, 24
+};
+
+/**
+ @brief  Stores default time constant of votes rate moving average.
+ */
+static NSTimeInterval const kSPNPVoteTimeSeriesDefaultAveragingPeriod = 10.0f;
+
+
+#pragma mark - Private interface declaration
+
+@interface SPNPVoteTimeSeries () {
+    
+    /**
+     @brief  Stores index of newest bucket (number of bucket durations since reference date) for
+             each resolution.
+     */
+    long long _heads[kSPNPVoteTimeSeriesResolutionsCount];
+    
+    /**
+     @brief  Stores offset of first bucket of each resolution inside of \c buckets.
+     */
+    NSUInteger _offsets[kSPNPVoteTimeSeriesResolutionsCount];
+}
+
+
+#pragma mark - Properties
+
+@property (nonatomic, assign) NSUInteger responsesCount;
+
+/**
+ @brief      Stores reference on ring buffers of all resolutions.
+ @discussion Each bucket store votes changes of all responses one after another.
+ */
+@property (nonatomic, assign) long long *buckets;
+
+/**
+ @brief  Stores overall number of buckets of all resolutions.
+ */
+@property (nonatomic, assign) NSUInteger bucketsCount;
+
+/**
+ @brief  Stores reference on moving average of votes rate for each response.
+ */
+@property (nonatomic, assign) double *averageRates;
+
+/**
+ @brief  Stores whether at least one change has been recorded since last reset.
+ */
+@property (nonatomic, assign, getter = isStarted) BOOL started;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize votes time series.
+ 
+ @param responsesCount Number of poll response variants.
+ 
+ @return Initialized and ready to use votes time series.
+ */
+- (instancetype)initWithResponsesCount:(NSUInteger)responsesCount;
+
+
+#pragma mark - Buckets
+
+/**
+ @brief      Move newest bucket of all resolutions to the one which cover specified time.
+ @discussion Buckets which is reused for new time cleared. Votes of completed seconds folded into
+             moving averages.
+ 
+ @param time Reference date based time which should be covered by newest buckets.
+ */
+- (void)advanceToTime:(NSTimeInterval)time;
+
+/**
+ @brief  Compute reference on bucket votes changes.
+ 
+ @param resolution One of \b SPNPVoteTimeSeriesResolution fields.
+ @param bucketIdx  Index of bucket (number of bucket durations since reference date).
+ 
+ @return Reference on votes changes of all responses.
+ */
+- (long long *)bucketWithResolution:(SPNPVoteTimeSeriesResolution)resolution
+                            atIndex:(long long)bucketIdx;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPVoteTimeSeries
+
+
+#pragma mark - Information
+
+- (NSUInteger)memoryUsage {
+    
+    return (self.bucketsCount * self.responsesCount * sizeof(long long) +
+            self.responsesCount * sizeof(double));
+}
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)seriesWithResponsesCount:(NSUInteger)responsesCount {
+    
+    return [[self alloc] initWithResponsesCount:responsesCount];
+}
+
+- (instancetype)initWithResponsesCount:(NSUInteger)responsesCount {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _responsesCount = responsesCount;
+        _averagingPeriod = kSPNPVoteTimeSeriesDefaultAveragingPeriod;
+        for (NSUInteger resolution = 0; resolution < kSPNPVoteTimeSeriesResolutionsCount; resolution++) {
+            
+            _offsets[resolution] = _bucketsCount;
+            _bucketsCount += kSPNPVoteTimeSeriesBucketsCount[resolution];
+        }
+        _buckets = calloc(MAX(_bucketsCount * responsesCount, 1), sizeof(long long));
+        _averageRates = calloc(MAX(responsesCount, 1), sizeof(double));
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    
+    free(_buckets);
+    free(_averageRates);
+}
+
+
+#pragma mark - Recording
+
+- (void)recordChange:(long long)change forResponse:(NSUInteger)order atTime:(NSTimeInterval)time {
+    
+    if (order >= self.responsesCount || change == 0) { return; }
+    
+    [self advanceToTime:time];
+    for (NSUInteger resolution = 0; resolution < kSPNPVoteTimeSeriesResolutionsCount; resolution++) {
+        
+        // Changes which is older than resolution window can't be stored.
+        long long bucketIdx = (long long)floor(time / kSPNPVoteTimeSeriesBucketDurations[resolution]);
+        if (_heads[resolution] - bucketIdx < (long long)kSPNPVoteTimeSeriesBucketsCount[resolution]) {
+            
+            [self bucketWithResolution:resolution atIndex:bucketIdx][order] += change;
+        }
+    }
+}
+
+- (void)reset {
+    
+    memset(self.buckets, 0, self.bucketsCount * self.responsesCount * sizeof(long long));
+    memset(self.averageRates, 0, self.responsesCount * sizeof(double));
+    self.started = NO;
+}
+
+
+#pragma mark - Trend
+
+- (double)rateForResponse:(NSUInteger)order overInterval:(NSTimeInterval)interval
+                   atTime:(NSTimeInterval)time {
+    
+    if (order >= self.responsesCount || interval <= 0.0f) { return 0.0f; }
+    
+    [self advanceToTime:time];
+    NSUInteger resolution = 0;
+    NSTimeInterval duration = kSPNPVoteTimeSeriesBucketDurations[resolution];
+    while (resolution + 1 < kSPNPVoteTimeSeriesResolutionsCount &&
+           interval > duration * kSPNPVoteTimeSeriesBucketsCount[resolution]) {
+        
+        resolution++;
+        duration = kSPNPVoteTimeSeriesBucketDurations[resolution];
+    }
+    long long bucketsCount = MIN((long long)ceil(interval / duration),
+                                 (long long)kSPNPVoteTimeSeriesBucketsCount[resolution]);
+    
+    // Newest bucket cover only part of its duration.
+    long long votesCount = 0;
+    long long head = _heads[resolution];
+    for (long long bucketIdx = head - bucketsCount + 1; bucketIdx <= head; bucketIdx++) {
+        
+        votesCount += [self bucketWithResolution:resolution atIndex:bucketIdx][order];
+    }
+    NSTimeInterval elapsed = MAX(time - (NSTimeInterval)head * duration, 0.0f);
+    NSTimeInterval window = ((NSTimeInterval)(bucketsCount - 1) * duration + MIN(elapsed, duration));
+    
+    return (window > 0.0f ? (double)votesCount / window : 0.0f);
+}
+
+- (double)averageRateForResponse:(NSUInteger)order atTime:(NSTimeInterval)time {
+    
+    if (order >= self.responsesCount) { return 0.0f; }
+    [self advanceToTime:time];
+    
+    return self.averageRates[order];
+}
+
+- (NSArray *)seriesForResponse:(NSUInteger)order withResolution:(SPNPVoteTimeSeriesResolution)resolution
+                        atTime:(NSTimeInterval)time {
+    
+    if (order >= self.responsesCount || resolution >= kSPNPVoteTimeSeriesResolutionsCount) {
+        
+        return nil;
+    }
+    
+    [self advanceToTime:time];
+    long long bucketsCount = (long long)kSPNPVoteTimeSeriesBucketsCount[resolution];
+    NSMutableArray *series = [NSMutableArray arrayWithCapacity:(NSUInteger)bucketsCount];
+    long long head = _heads[resolution];
+    for (long long bucketIdx = head - bucketsCount + 1; bucketIdx <= head; bucketIdx++) {
+        
+        [series addObject:@([self bucketWithResolution:resolution atIndex:bucketIdx][order])];
+    }
+    
+    return series;
+}
+
+- (NSArray *)trendAtTime:(NSTimeInterval)time {
+    
+    NSMutableArray *trend = [NSMutableArray arrayWithCapacity:self.responsesCount];
+    for (NSUInteger responseIdx = 0; responseIdx < self.responsesCount; responseIdx++) {
+        
+        [trend addObject:[self seriesForResponse:responseIdx
+                                  withResolution:SPNPVoteTimeSeriesSecondResolution atTime:time]];
+    }
+    
+    return trend;
+}
+
+
+#pragma mark - Buckets
+
+- (void)advanceToTime:(NSTimeInterval)time {
+    
+    NSUInteger responsesCount = self.responsesCount;
+    BOOL isStarted = self.isStarted;
+    self.started = YES;
+    for (NSUInteger resolution = 0; resolution < kSPNPVoteTimeSeriesResolutionsCount; resolution++) {
+        
+        long long bucketIdx = (long long)floor(time / kSPNPVoteTimeSeriesBucketDurations[resolution]);
+        if (!isStarted) {
+            
+            _heads[resolution] = bucketIdx;
+            continue;
+        }
+        
+        long long head = _heads[resolution];
+        if (bucketIdx <= head) { continue; }
+        
+        // Completed seconds folded into moving average: newest bucket and then empty seconds.
+        if (resolution == SPNPVoteTimeSeriesSecondResolution) {
+            
+            double decay = exp(-1.0f / MAX(self.averagingPeriod, 1.0f));
+            double emptySecondsDecay = pow(decay, (double)(bucketIdx - head - 1));
+            long long *votesChanges = [self bucketWithResolution:resolution atIndex:head];
+            for (NSUInteger responseIdx = 0; responseIdx < responsesCount; responseIdx++) {
+                
+                double averageRate = (self.averageRates[responseIdx] * decay +
+                                      (1.0f - decay) * (double)votesChanges[responseIdx]);
+                self.averageRates[responseIdx] = averageRate * emptySecondsDecay;
+            }
+        }
+        
+        // Buckets which is reused for new time should be cleared.
+        long long clearedBucketsCount = MIN(bucketIdx - head,
+                                            (long long)kSPNPVoteTimeSeriesBucketsCount[resolution]);
+        for (long long clearedIdx = 1; clearedIdx <= clearedBucketsCount; clearedIdx++) {
+            
+            memset([self bucketWithResolution:resolution atIndex:(head + clearedIdx)], 0,
+                   responsesCount * sizeof(long long));
+        }
+        _heads[resolution] = bucketIdx;
+    }
+}
+
+- (long long *)bucketWithResolution:(SPNPVoteTimeSeriesResolution)resolution
+                            atIndex:(long long)bucketIdx {
+    
+    long long bucketsCount = (long long)kSPNPVoteTimeSeriesBucketsCount[resolution];
+    long long slot = ((bucketIdx % bucketsCount) + bucketsCount) % bucketsCount;
+    
+    return (self.buckets + (_offsets[resolution] + (NSUInteger)slot) * self.responsesCount);
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,150 @@
+#import <Foundation/Foundation.h>
+
+
+#pragma mark Class forward
+
+@class SPNPLoopbackTransport;
+
+
+/**
+ @brief      In-process real-time network stand-in.
+ @discussion Broker implements channels, presence occupancy and history for loopback transports 
+             which has been created with it, so single process can run host and many attendee 
+             poll managers without \b PubNub service (for example to measure votes processing 
+             throughput and statistic delivery latency). Delivery latency and messages loss 
+             can be configured.
+             Events delivered to transports on main queue.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPLoopbackBroker : NSObject
+
+
+///------------------------------------------------
+/// @name Configuration
+///------------------------------------------------
+
+/**
+ @brief  Stores delay which is used for messages and events delivery (default value is \c 0).
+ */
+@property (nonatomic, assign) NSTimeInterval latency;
+
+/**
+ @brief  Stores probability (from \c 0 to \c 1) with which message won't be delivered to the 
+         subscriber (default value is \c 0).
+ */
+@property (nonatomic, assign) double lossRate;
+
+/**
+ @brief  Stores maximum number of messages which is stored in each channel's history (default value
+         is \c 100).
+ */
+@property (nonatomic, assign) NSUInteger historyLimit;
+
+/**
+ @brief      Stores interval with which presence changes announced to observers.
+ @discussion Value \c 0 means what each join / leave delivered as separate event (default), 
+             otherwise changes collected and delivered as single interval announcement.
+ */
+@property (nonatomic, assign) NSTimeInterval presenceInterval;
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores number of messages which has been published, delivered and lost by broker.
+ */
+@property (nonatomic, readonly, assign) NSUInteger publishedMessagesCount;
+@property (nonatomic, readonly, assign) NSUInteger deliveredMessagesCount;
+@property (nonatomic, readonly, assign) NSUInteger lostMessagesCount;
+
+/**
+ @brief  Retrieve number of transports which is subscribed on channel.
+ 
+ @param channel Reference on name of channel for which occupancy should be calculated.
+ 
+ @return Channel occupancy.
+ */
+- (NSUInteger)occupancyForChannel:(NSString *)channel;
+
+
+///------------------------------------------------
+/// @name Transport support
+///------------------------------------------------
+
+/**
+ @brief  Add transport to channels subscribers list.
+ 
+ @param transport Reference on transport which should receive real-time events.
+ @param channels  List of channel names (names with \c -pnpres suffix used to subscribe on presence
+                  events).
+ */
+- (void)subscribeTransport:(SPNPLoopbackTransport *)transport toChannels:(NSArray *)channels;
+
+/**
+ @brief  Remove transport from all channels.
+ 
+ @param transport Reference on transport which should stop receiving real-time events.
+ */
+- (void)unsubscribeTransport:(SPNPLoopbackTransport *)transport;
+
+/**
+ @brief  Remove transport from specified channels subscribers list.
+ 
+ @param transport Reference on transport which should stop receiving real-time events from 
+                  \c channels.
+ @param channels  List of channel names.
+ */
+- (void)unsubscribeTransport:(SPNPLoopbackTransport *)transport fromChannels:(NSArray *)channels;
+
+/**
+ @brief  Store message in channel history and deliver it to channel subscribers.
+ 
+ @param message   Reference on object which should be sent.
+ @param channel   Reference on name of channel to which message should be sent.
+ @param publisher Reference on unique identifier of transport's user which publish message.
+ @param block     Reference on block which should be called at the end of publish process.
+ */
+- (void)publish:(id)message toChannel:(NSString *)channel fromPublisher:(NSString *)publisher
+ withCompletion:(void(^)(NSString *errorMessage))block;
+
+/**
+ @brief  Retrieve messages which has been sent to the channel.
+ 
+ @param channel Reference on name of channel for which history should be retrieved.
+ @param limit   Maximum number of latest messages which should be returned.
+ @param block   Reference on block which should be called at the end of history retrieve process.
+ */
+- (void)historyForChannel:(NSString *)channel limit:(NSUInteger)limit
+           withCompletion:(void(^)(NSArray *messages, NSString *errorMessage))block;
+
+/**
+ @brief  Retrieve page of messages which has been sent to the channel in specified time range.
+ 
+ @param channel Reference on name of channel for which history should be retrieved.
+ @param start   Time token after which (exclusive) messages should be returned or \c nil.
+ @param end     Time token till which (inclusive) messages should be returned or \c nil.
+ @param limit   Maximum number of messages which should be returned.
+ @param block   Reference on block which should be called at the end of history retrieve process.
+ */
+- (void)historyForChannel:(NSString *)channel start:(NSNumber *)start end:(NSNumber *)end
+                    limit:(NSUInteger)limit
+           withCompletion:(void(^)(NSArray *messages, NSNumber *lastTimetoken,
+                                   NSString *errorMessage))block;
+
+/**
+ @brief      Retrieve broker's current time token.
+ @discussion Time token is never smaller than time token of latest published message and always 
+             smaller than time tokens of messages which will be published later.
+ 
+ @param block Reference on block which should be called with current time token.
+ */
+- (void)timeWithCompletion:(void(^)(NSNumber *timetoken, NSString *errorMessage))block;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,444 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPLoopbackBroker.h"
+#import "SPNPLoopbackTransport.h"
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores suffix which is used by presence channels.
+ */
+static NSString * const kSPNPPresenceChannelSuffix = @"-pnpres";
+
+/**
+ @brief  Stores default number of messages which is stored in channel history.
+ */
+static NSUInteger const kSPNPDefaultHistoryLimit = 100;
+
+
+#pragma mark - Private interface declaration
+
+@interface SPNPLoopbackBroker ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, assign) NSUInteger publishedMessagesCount;
+@property (nonatomic, assign) NSUInteger deliveredMessagesCount;
+@property (nonatomic, assign) NSUInteger lostMessagesCount;
+
+/**
+ @brief  Stores reference on serial queue which is used to access broker state.
+ */
+@property (nonatomic, strong) dispatch_queue_t queue;
+
+/**
+ @brief  Stores reference on channel name to subscribed transports (weak references) map.
+ */
+@property (nonatomic, strong) NSMutableDictionary *subscribers;
+
+/**
+ @brief  Stores reference on channel name to presence observers (weak references) map.
+ */
+@property (nonatomic, strong) NSMutableDictionary *presenceObservers;
+
+/**
+ @brief  Stores reference on channel name to list of published messages map.
+ */
+@property (nonatomic, strong) NSMutableDictionary *history;
+
+/**
+ @brief  Stores reference on channel name to list of published messages time tokens map.
+ */
+@property (nonatomic, strong) NSMutableDictionary *historyTimetokens;
+
+/**
+ @brief  Stores time token which has been assigned to last published message.
+ */
+@property (nonatomic, assign) unsigned long long lastTimetoken;
+
+/**
+ @brief  Stores reference on channel name to list of joined / left subscribers identifiers map
+         which hasn't been announced yet.
+ */
+@property (nonatomic, strong) NSMutableDictionary *pendingJoins;
+@property (nonatomic, strong) NSMutableDictionary *pendingLeaves;
+
+/**
+ @brief  Stores reference on names of channels for which occupancy change hasn't been announced.
+ */
+@property (nonatomic, strong) NSMutableSet *pendingPresenceChannels;
+
+/**
+ @brief  Stores whether interval presence announcement already scheduled or not.
+ */
+@property (nonatomic, assign, getter = isPresenceAnnouncementScheduled) BOOL presenceAnnouncementScheduled;
+
+
+#pragma mark - Delivery
+
+/**
+ @brief  Call block on main queue after configured latency.
+ 
+ @param block Reference on block which should be called.
+ */
+- (void)deliverWithBlock:(dispatch_block_t)block;
+
+/**
+ @brief      Register channels occupancy change.
+ @discussion Method should be called on broker queue. Change delivered right away or with next 
+             interval announcement (depending from \c presenceInterval).
+ 
+ @param channels List of channel names for which occupancy changed.
+ @param joined   Reference on identifier of subscriber which joined channels (if any).
+ @param left     Reference on identifier of subscriber which left channels (if any).
+ */
+- (void)registerPresenceChangeOnChannels:(NSSet *)channels joined:(NSString *)joined
+                                    left:(NSString *)left;
+
+/**
+ @brief      Notify presence observers about occupancy changes which hasn't been announced yet.
+ @discussion Method should be called on broker queue.
+ */
+- (void)deliverPendingPresence;
+
+/**
+ @brief  Check whether message should be lost or not (basing on configured loss rate).
+ 
+ @return \c YES in case if message shouldn't be delivered.
+ */
+- (BOOL)shouldLoseMessage;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPLoopbackBroker
+
+
+#pragma mark - Initialization and Configuration
+
+- (instancetype)init {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _historyLimit = kSPNPDefaultHistoryLimit;
+        _queue = dispatch_queue_create("com.pubnub.poll.loopback", DISPATCH_QUEUE_SERIAL);
+        _subscribers = [NSMutableDictionary new];
+        _presenceObservers = [NSMutableDictionary new];
+        _history = [NSMutableDictionary new];
+        _historyTimetokens = [NSMutableDictionary new];
+        _pendingJoins = [NSMutableDictionary new];
+        _pendingLeaves = [NSMutableDictionary new];
+        _pendingPresenceChannels = [NSMutableSet new];
+    }
+    
+    return self;
+}
+
+
+#pragma mark - Information
+
+- (NSUInteger)occupancyForChannel:(NSString *)channel {
+    
+    __block NSUInteger occupancy = 0;
+    dispatch_sync(self.queue, ^{
+        
+        occupancy = [self.subscribers[channel] allObjects].count;
+    });
+    
+    return occupancy;
+}
+
+
+#pragma mark - Transport support
+
+- (void)subscribeTransport:(SPNPLoopbackTransport *)transport toChannels:(NSArray *)channels {
+    
+    dispatch_async(self.queue, ^{
+        
+        NSMutableSet *changedChannels = [NSMutableSet new];
+        NSMutableSet *joinedChannels = [NSMutableSet new];
+        for (NSString *channel in channels) {
+            
+            BOOL isPresence = [channel hasSuffix:kSPNPPresenceChannelSuffix];
+            NSString *targetChannel = channel;
+            NSMutableDictionary *storage = self.subscribers;
+            if (isPresence) {
+                
+                targetChannel = [channel substringToIndex:(channel.length - kSPNPPresenceChannelSuffix.length)];
+                storage = self.presenceObservers;
+            }
+            NSHashTable *transports = storage[targetChannel];
+            if (!transports) {
+                
+                transports = [NSHashTable weakObjectsHashTable];
+                storage[targetChannel] = transports;
+            }
+            if (!isPresence && ![transports containsObject:transport]) {
+                
+                [joinedChannels addObject:targetChannel];
+            }
+            [transports addObject:transport];
+            [changedChannels addObject:targetChannel];
+        }
+        [self deliverWithBlock:^{
+            
+            [transport.delegate transport:transport didChangeStatus:SPNPTransportConnected
+                                withError:nil];
+        }];
+        [changedChannels minusSet:joinedChannels];
+        [self registerPresenceChangeOnChannels:joinedChannels joined:transport.uuid left:nil];
+        [self registerPresenceChangeOnChannels:changedChannels joined:nil left:nil];
+    });
+}
+
+- (void)unsubscribeTransport:(SPNPLoopbackTransport *)transport {
+    
+    dispatch_async(self.queue, ^{
+        
+        NSMutableSet *changedChannels = [NSMutableSet new];
+        [self.subscribers enumerateKeysAndObjectsUsingBlock:^(NSString *channel,
+                                                              NSHashTable *transports,
+                                                              BOOL *subscribersEnumeratorStop) {
+            
+            if ([transports containsObject:transport]) {
+                
+                [transports removeObject:transport];
+                [changedChannels addObject:channel];
+            }
+        }];
+        [self.presenceObservers enumerateKeysAndObjectsUsingBlock:^(NSString *channel,
+                                                                    NSHashTable *transports,
+                                                                    BOOL *observersEnumeratorStop) {
+            
+            [transports removeObject:transport];
+        }];
+        [self deliverWithBlock:^{
+            
+            [transport.delegate transport:transport didChangeStatus:SPNPTransportDisconnected
+                                withError:nil];
+        }];
+        [self registerPresenceChangeOnChannels:changedChannels joined:nil left:transport.uuid];
+    });
+}
+
+- (void)unsubscribeTransport:(SPNPLoopbackTransport *)transport fromChannels:(NSArray *)channels {
+    
+    dispatch_async(self.queue, ^{
+        
+        NSMutableSet *changedChannels = [NSMutableSet new];
+        for (NSString *channel in channels) {
+            
+            NSHashTable *transports = self.subscribers[channel];
+            if ([transports containsObject:transport]) {
+                
+                [transports removeObject:transport];
+                [changedChannels addObject:channel];
+            }
+        }
+        [self registerPresenceChangeOnChannels:changedChannels joined:nil left:transport.uuid];
+    });
+}
+
+- (void)publish:(id)message toChannel:(NSString *)channel fromPublisher:(NSString *)publisher
+ withCompletion:(void(^)(NSString *errorMessage))block {
+    
+    dispatch_async(self.queue, ^{
+        
+        NSMutableArray *history = self.history[channel];
+        NSMutableArray *timetokens = self.historyTimetokens[channel];
+        if (!history) {
+            
+            history = [NSMutableArray new];
+            timetokens = [NSMutableArray new];
+            self.history[channel] = history;
+            self.historyTimetokens[channel] = timetokens;
+        }
+        
+        // Time tokens should be unique and grow even if messages published faster than clock ticks.
+        unsigned long long timetoken = ([NSDate date].timeIntervalSince1970 * 10000000);
+        self.lastTimetoken = MAX(self.lastTimetoken + 1, timetoken);
+        [history addObject:message];
+        [timetokens addObject:@(self.lastTimetoken)];
+        if (history.count > self.historyLimit) {
+            
+            NSRange range = NSMakeRange(0, history.count - self.historyLimit);
+            [history removeObjectsInRange:range];
+            [timetokens removeObjectsInRange:range];
+        }
+        self.publishedMessagesCount++;
+        
+        NSMutableArray *recipients = [NSMutableArray new];
+        for (SPNPLoopbackTransport *transport in [self.subscribers[channel] allObjects]) {
+            
+            if (![self shouldLoseMessage]) { [recipients addObject:transport]; }
+            else { self.lostMessagesCount++; }
+        }
+        self.deliveredMessagesCount += recipients.count;
+        [self deliverWithBlock:^{
+            
+            for (SPNPLoopbackTransport *transport in recipients) {
+                
+                [transport.delegate transport:transport didReceiveMessage:message
+                                fromPublisher:publisher onChannel:channel];
+            }
+            if (block) { block(nil); }
+        }];
+    });
+}
+
+- (void)historyForChannel:(NSString *)channel limit:(NSUInteger)limit
+           withCompletion:(void(^)(NSArray *messages, NSString *errorMessage))block {
+    
+    dispatch_async(self.queue, ^{
+        
+        NSArray *history = self.history[channel];
+        NSUInteger count = MIN(history.count, limit);
+        NSArray *messages = [history subarrayWithRange:NSMakeRange(history.count - count, count)];
+        [self deliverWithBlock:^{
+            
+            block(messages, nil);
+        }];
+    });
+}
+
+- (void)historyForChannel:(NSString *)channel start:(NSNumber *)start end:(NSNumber *)end
+                    limit:(NSUInteger)limit
+           withCompletion:(void(^)(NSArray *messages, NSNumber *lastTimetoken,
+                                   NSString *errorMessage))block {
+    
+    dispatch_async(self.queue, ^{
+        
+        NSArray *history = self.history[channel];
+        NSArray *timetokens = self.historyTimetokens[channel];
+        NSUInteger startIdx = 0;
+        if (start) {
+            
+            startIdx = [timetokens indexOfObject:start inSortedRange:NSMakeRange(0, timetokens.count)
+                                         options:(NSBinarySearchingLastEqual |
+                                                  NSBinarySearchingInsertionIndex)
+                                 usingComparator:^NSComparisonResult(NSNumber *token1, NSNumber *token2) {
+                                     
+                return [token1 compare:token2];
+            }];
+        }
+        NSUInteger endIdx = startIdx;
+        while (endIdx < history.count && endIdx - startIdx < limit &&
+               (!end || [timetokens[endIdx] compare:end] != NSOrderedDescending)) {
+            
+            endIdx++;
+        }
+        NSArray *messages = [history subarrayWithRange:NSMakeRange(startIdx, endIdx - startIdx)];
+        NSNumber *lastTimetoken = (endIdx > startIdx ? timetokens[endIdx - 1] : nil);
+        [self deliverWithBlock:^{
+            
+            block(messages, lastTimetoken, nil);
+        }];
+    });
+}
+
+- (void)timeWithCompletion:(void(^)(NSNumber *timetoken, NSString *errorMessage))block {
+    
+    dispatch_async(self.queue, ^{
+        
+        // Messages which will be published after this request should have bigger time tokens.
+        unsigned long long timetoken = ([NSDate date].timeIntervalSince1970 * 10000000);
+        self.lastTimetoken = MAX(self.lastTimetoken, timetoken);
+        NSNumber *currentTimetoken = @(self.lastTimetoken);
+        [self deliverWithBlock:^{
+            
+            block(currentTimetoken, nil);
+        }];
+    });
+}
+
+
+#pragma mark - Delivery
+
+- (void)deliverWithBlock:(dispatch_block_t)block {
+    
+    if (self.latency > 0.0f) {
+        
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.latency * NSEC_PER_SEC)),
+                       dispatch_get_main_queue(), block);
+    }
+    else { dispatch_async(dispatch_get_main_queue(), block); }
+}
+
+- (void)registerPresenceChangeOnChannels:(NSSet *)channels joined:(NSString *)joined
+                                    left:(NSString *)left {
+    
+    if (!channels.count) { return; }
+    for (NSString *channel in channels) {
+        
+        NSString *identifier = (joined?: left);
+        NSMutableDictionary *storage = (joined ? self.pendingJoins : self.pendingLeaves);
+        if (identifier) {
+            
+            NSMutableArray *identifiers = storage[channel];
+            if (!identifiers) {
+                
+                identifiers = [NSMutableArray new];
+                storage[channel] = identifiers;
+            }
+            [identifiers addObject:identifier];
+        }
+        [self.pendingPresenceChannels addObject:channel];
+    }
+    
+    if (self.presenceInterval <= 0.0f) { [self deliverPendingPresence]; }
+    else if (!self.isPresenceAnnouncementScheduled) {
+        
+        self.presenceAnnouncementScheduled = YES;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.presenceInterval * NSEC_PER_SEC)),
+                       self.queue, ^{
+            
+            self.presenceAnnouncementScheduled = NO;
+            [self deliverPendingPresence];
+        });
+    }
+}
+
+- (void)deliverPendingPresence {
+    
+    for (NSString *channel in self.pendingPresenceChannels) {
+        
+        NSUInteger occupancy = [self.subscribers[channel] allObjects].count;
+        NSArray *joined = [self.pendingJoins[channel] copy];
+        NSArray *left = [self.pendingLeaves[channel] copy];
+        NSArray *observers = [self.presenceObservers[channel] allObjects];
+        if (observers.count) {
+            
+            [self deliverWithBlock:^{
+                
+                for (SPNPLoopbackTransport *transport in observers) {
+                    
+                    [transport.delegate transport:transport didReceiveOccupancy:occupancy
+                                           joined:joined left:left onChannel:channel];
+                }
+            }];
+        }
+    }
+    [self.pendingPresenceChannels removeAllObjects];
+    [self.pendingJoins removeAllObjects];
+    [self.pendingLeaves removeAllObjects];
+}
+
+- (BOOL)shouldLoseMessage {
+    
+    return (self.lossRate > 0.0f && arc4random_uniform(1000000) < (uint32_t)(self.lossRate * 1000000));
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,56 @@
+#import <Foundation/Foundation.h>
+#import "SPNPTransport.h"
+
+
+#pragma mark Class forward
+
+@class SPNPLoopbackBroker;
+
+
+/**
+ @brief  Transport which use in-process loopback broker instead of real-time network.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPLoopbackTransport : NSObject <SPNPTransport>
+
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on broker which is used to deliver messages.
+ */
+@property (nonatomic, readonly, strong) SPNPLoopbackBroker *broker;
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure loopback transport.
+ 
+ @param broker Reference on broker which should be used to deliver messages.
+ @param uuid   Reference on unique user identifier or \c nil to use generated one.
+ 
+ @return Configured and ready to use transport.
+ */
++ (instancetype)transportWithBroker:(SPNPLoopbackBroker *)broker uuid:(NSString *)uuid;
+
+
+///------------------------------------------------
+/// @name Subscription
+///------------------------------------------------
+
+/**
+ @brief  Unsubscribe from all channels.
+ */
+- (void)unsubscribe;
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,126 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPLoopbackTransport.h"
+#import "SPNPLoopbackBroker.h"
+
+
+#pragma mark Private interface declaration
+
+@interface SPNPLoopbackTransport ()
+
+
+#pragma mark - Properties
+
+@property (nonatomic, weak) id<SPNPTransportDelegate> delegate;
+@property (nonatomic, copy) NSString *uuid;
+@property (nonatomic, strong) SPNPLoopbackBroker *broker;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize loopback transport.
+ 
+ @param broker Reference on broker which should be used to deliver messages.
+ @param uuid   Reference on unique user identifier or \c nil to use generated one.
+ 
+ @return Initialized and ready to use transport.
+ */
+- (instancetype)initWithBroker:(SPNPLoopbackBroker *)broker uuid:(NSString *)uuid;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPLoopbackTransport
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)transportWithBroker:(SPNPLoopbackBroker *)broker uuid:(NSString *)uuid {
+    
+    return [[self alloc] initWithBroker:broker uuid:uuid];
+}
+
+- (instancetype)initWithBroker:(SPNPLoopbackBroker *)broker uuid:(NSString *)uuid {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        _broker = broker;
+        _uuid = [(uuid?: [NSUUID UUID].UUIDString) copy];
+    }
+    
+    return self;
+}
+
+
+#pragma mark - Subscription
+
+- (void)subscribeToChannels:(NSArray *)channels {
+    
+    [self.broker subscribeTransport:self toChannels:channels];
+}
+
+- (void)unsubscribeFromChannels:(NSArray *)channels {
+    
+    [self.broker unsubscribeTransport:self fromChannels:channels];
+}
+
+- (void)unsubscribe {
+    
+    [self.broker unsubscribeTransport:self];
+}
+
+
+#pragma mark - Publish
+
+- (void)publish:(id)message toChannel:(NSString *)channel mobilePushPayload:(NSDictionary *)payload
+ withCompletion:(void(^)(NSString *errorMessage))block {
+    
+    [self.broker publish:message toChannel:channel fromPublisher:self.uuid withCompletion:block];
+}
+
+
+#pragma mark - History
+
+- (void)historyForChannel:(NSString *)channel limit:(NSUInteger)limit
+           withCompletion:(void(^)(NSArray *messages, NSString *errorMessage))block {
+    
+    [self.broker historyForChannel:channel limit:limit withCompletion:block];
+}
+
+- (void)historyForChannel:(NSString *)channel start:(NSNumber *)start end:(NSNumber *)end
+                    limit:(NSUInteger)limit
+           withCompletion:(void(^)(NSArray *messages, NSNumber *lastTimetoken,
+                                   NSString *errorMessage))block {
+    
+    [self.broker historyForChannel:channel start:start end:end limit:limit withCompletion:block];
+}
+
+
+#pragma mark - Time
+
+- (void)timeWithCompletion:(void(^)(NSNumber *timetoken, NSString *errorMessage))block {
+    
+    [self.broker timeWithCompletion:block];
+}
+
+
+#pragma mark - Push notifications
+
+- (void)addPushNotificationsOnChannels:(NSArray *)channels withDevicePushToken:(NSData *)token {
+    
+    // Loopback broker doesn't deliver push notifications.
+}
+
+#pragma mark -
+
+
+@end
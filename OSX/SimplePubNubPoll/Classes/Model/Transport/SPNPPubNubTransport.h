@@ -0,0 +1,31 @@
+#import <Foundation/Foundation.h>
+#import "SPNPTransport.h"
+
+
+/**
+ @brief  Transport which use \b PubNub real-time network.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@interface SPNPPubNubTransport : NSObject <SPNPTransport>
+
+
+///------------------------------------------------
+/// @name Initialization and Configuration
+///------------------------------------------------
+
+/**
+ @brief  Create and configure \b PubNub transport.
+ 
+ @param uuid Reference on unique user identifier which should be used by \b PubNub client or \c nil
+             to use generated one.
+ 
+ @return Configured and ready to use transport.
+ */
++ (instancetype)transportWithUUID:(NSString *)uuid;
+
+#pragma mark -
+
+
+@end
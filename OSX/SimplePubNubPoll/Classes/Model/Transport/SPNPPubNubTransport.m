@@ -0,0 +1,244 @@
+/**
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import "SPNPPubNubTransport.h"
+#import <PubNub/PubNub.h>
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores reference on key which is required by \b PubNub client to give ability to retrieve
+         real-time updates.
+ */
+static NSString * const kSPNPPubNubSubscribeKey = @"demo-36";
+
+/**
+ @brief  Stores reference on key which is required by \b PubNub client to give ability to push data
+         to data channels.
+ */
+static NSString * const kSPNPPubNubPublishKey = @"demo-36";
+
+
+#pragma mark - Private interface declaration
+
+@interface SPNPPubNubTransport () <PNObjectEventListener>
+
+
+#pragma mark - Properties
+
+@property (nonatomic, weak) id<SPNPTransportDelegate> delegate;
+
+/**
+ @brief  Stores reference on \b PubNub client which is used for real-time communication.
+ */
+@property (nonatomic) PubNub *client;
+
+
+#pragma mark - Initialization and Configuration
+
+/**
+ @brief  Initialize \b PubNub transport.
+ 
+ @param uuid Reference on unique user identifier which should be used by \b PubNub client or \c nil
+             to use generated one.
+ 
+ @return Initialized and ready to use transport.
+ */
+- (instancetype)initWithUUID:(NSString *)uuid;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPPubNubTransport
+
+
+#pragma mark - Information
+
+- (NSString *)uuid {
+    
+    return self.client.uuid;
+}
+
+
+#pragma mark - Initialization and Configuration
+
++ (instancetype)transportWithUUID:(NSString *)uuid {
+    
+    return [[self alloc] initWithUUID:uuid];
+}
+
+- (instancetype)initWithUUID:(NSString *)uuid {
+    
+    // Check whether initialization was successful or not.
+    if ((self = [super init])) {
+        
+        [PNLog enabled:YES];
+        PNConfiguration *configuration = [PNConfiguration configurationWithPublishKey:kSPNPPubNubPublishKey
+                                                                         subscribeKey:kSPNPPubNubSubscribeKey];
+        if (uuid) { configuration.uuid = uuid; }
+        _client = [PubNub clientWithConfiguration:configuration];
+        [_client addListener:self];
+    }
+    
+    return self;
+}
+
+
+#pragma mark - Subscription
+
+- (void)subscribeToChannels:(NSArray *)channels {
+    
+    [self.client subscribeToChannels:channels withPresence:NO];
+}
+
+- (void)unsubscribeFromChannels:(NSArray *)channels {
+    
+    [self.client unsubscribeFromChannels:channels withPresence:NO];
+}
+
+
+#pragma mark - Publish
+
+- (void)publish:(id)message toChannel:(NSString *)channel mobilePushPayload:(NSDictionary *)payload
+ withCompletion:(void(^)(NSString *errorMessage))block {
+    
+    void(^completionBlock)(PNPublishStatus *) = ^(PNPublishStatus *status) {
+        
+        if (block) { block(status.isError ? status.errorData.information : nil); }
+    };
+    if (payload) {
+        
+        [self.client publish:message toChannel:channel mobilePushPayload:payload compressed:YES
+              withCompletion:completionBlock];
+    }
+    else { [self.client publish:message toChannel:channel compressed:YES withCompletion:completionBlock]; }
+}
+
+
+#pragma mark - History
+
+- (void)historyForChannel:(NSString *)channel limit:(NSUInteger)limit
+           withCompletion:(void(^)(NSArray *messages, NSString *errorMessage))block {
+    
+    [self.client historyForChannel:channel start:nil end:nil limit:limit
+                    withCompletion:^(PNHistoryResult *result, PNErrorStatus *status) {
+                        
+        block(result.data.messages, (status.isError ? status.errorData.information : nil));
+    }];
+}
+
+- (void)historyForChannel:(NSString *)channel start:(NSNumber *)start end:(NSNumber *)end
+                    limit:(NSUInteger)limit
+           withCompletion:(void(^)(NSArray *messages, NSNumber *lastTimetoken,
+                                   NSString *errorMessage))block {
+    
+    // Reversed history returns messages which follow 'start' time token.
+    [self.client historyForChannel:channel start:start end:end limit:limit reverse:YES
+                    withCompletion:^(PNHistoryResult *result, PNErrorStatus *status) {
+                        
+        NSNumber *lastTimetoken = (result.data.messages.count ? result.data.end : nil);
+        block(result.data.messages, lastTimetoken,
+              (status.isError ? status.errorData.information : nil));
+    }];
+}
+
+
+#pragma mark - Time
+
+- (void)timeWithCompletion:(void(^)(NSNumber *timetoken, NSString *errorMessage))block {
+    
+    [self.client timeWithCompletion:^(PNTimeResult *result, PNErrorStatus *status) {
+        
+        block(result.data.timetoken, (status.isError ? status.errorData.information : nil));
+    }];
+}
+
+
+#pragma mark - Push notifications
+
+- (void)addPushNotificationsOnChannels:(NSArray *)channels withDevicePushToken:(NSData *)token {
+    
+    [self.client addPushNotificationsOnChannels:channels withDevicePushToken:token andCompletion:nil];
+}
+
+
+#pragma mark - PubNub event listener
+
+- (void)client:(PubNub *)client didReceiveStatus:(PNStatus *)status {
+    
+    if (status.operation == PNSubscribeOperation) {
+        
+        NSString *errorMessage = nil;
+        SPNPTransportStatus transportStatus = SPNPTransportConnected;
+        if (status.category == PNUnexpectedDisconnectCategory) {
+            
+            transportStatus = SPNPTransportUnexpectedlyDisconnected;
+            errorMessage = ((PNErrorStatus *)status).errorData.information;
+        }
+        [self.delegate transport:self didChangeStatus:transportStatus withError:errorMessage];
+    }
+    // Client stay connected if it has been unsubscribed only from some channels.
+    else if (status.operation == PNUnsubscribeOperation && !client.channels.count) {
+        
+        [self.delegate transport:self didChangeStatus:SPNPTransportDisconnected withError:nil];
+    }
+}
+
+- (void)client:(PubNub *)client didReceivePresenceEvent:(PNPresenceEventResult *)event {
+    
+    NSArray *joined = nil;
+    NSArray *left = nil;
+    NSString *type = event.data.presenceEvent;
+    id presence = event.data.presence;
+    NSString *uuid = event.data.presence.uuid;
+    if ([type isEqualToString:@"join"]) { joined = (uuid ? @[uuid] : nil); }
+    else if ([type isEqualToString:@"leave"] || [type isEqualToString:@"timeout"]) {
+        
+        left = (uuid ? @[uuid] : nil);
+    }
+    // Interval announcement lists available only with SDK versions which support them.
+    else if ([type isEqualToString:@"interval"]) {
+        
+        if ([presence respondsToSelector:NSSelectorFromString(@"join")]) {
+            
+            joined = [presence valueForKey:@"join"];
+        }
+        NSMutableArray *leftSubscribers = [NSMutableArray new];
+        for (NSString *key in @[@"leave", @"timeout"]) {
+            
+            NSArray *subscribers = nil;
+            if ([presence respondsToSelector:NSSelectorFromString(key)]) {
+                
+                subscribers = [presence valueForKey:key];
+            }
+            if ([subscribers isKindOfClass:NSArray.class]) {
+                
+                [leftSubscribers addObjectsFromArray:subscribers];
+            }
+        }
+        left = (leftSubscribers.count ? leftSubscribers : nil);
+    }
+    
+    [self.delegate transport:self
+         didReceiveOccupancy:event.data.presence.occupancy.unsignedIntegerValue
+                      joined:([joined isKindOfClass:NSArray.class] ? joined : nil) left:left
+                   onChannel:event.data.subscribedChannel];
+}
+
+- (void)client:(PubNub *)client didReceiveMessage:(PNMessageResult *)message {
+    
+    [self.delegate transport:self didReceiveMessage:message.data.message
+               fromPublisher:message.data.publisher onChannel:message.data.subscribedChannel];
+}
+
+#pragma mark -
+
+
+@end
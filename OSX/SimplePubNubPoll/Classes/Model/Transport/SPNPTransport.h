@@ -0,0 +1,221 @@
+#import <Foundation/Foundation.h>
+
+
+#pragma mark Class forward
+
+@protocol SPNPTransport;
+
+
+#pragma mark - Types
+
+/**
+ @brief  Describes transport subscription states.
+ */
+typedef NS_ENUM(NSUInteger, SPNPTransportStatus) {
+    
+    /**
+     @brief  Transport subscribed on requested channels and ready to receive messages.
+     */
+    SPNPTransportConnected,
+    
+    /**
+     @brief  Transport unexpectedly lost connection to real-time network.
+     */
+    SPNPTransportUnexpectedlyDisconnected,
+    
+    /**
+     @brief  Transport unsubscribed from channels.
+     */
+    SPNPTransportDisconnected
+};
+
+
+/**
+ @brief      Protocol which should be implemented by transport delegate to receive real-time events.
+ @discussion Events delivered on main queue.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@protocol SPNPTransportDelegate <NSObject>
+
+
+@required
+
+/**
+ @brief  Handle transport subscription status change.
+ 
+ @param transport    Reference on transport which changed it's state.
+ @param status       One of \b SPNPTransportStatus fields which represent new transport state.
+ @param errorMessage Reference on description of error because of which transport has been 
+                     disconnected.
+ */
+- (void)transport:(id<SPNPTransport>)transport didChangeStatus:(SPNPTransportStatus)status
+        withError:(NSString *)errorMessage;
+
+/**
+ @brief      Handle new message from one of subscribed channels.
+ @discussion Publisher identifier reported by real-time network and can't be changed by message 
+             sender (unlike identifiers which is sent in message payload).
+ 
+ @param transport Reference on transport which received message.
+ @param message   Reference on message which has been published to the channel.
+ @param publisher Reference on unique identifier of transport's user which published message or 
+                  \c nil in case if it is unknown.
+ @param channel   Reference on name of channel on which message has been received.
+ */
+- (void)transport:(id<SPNPTransport>)transport didReceiveMessage:(id)message
+    fromPublisher:(NSString *)publisher onChannel:(NSString *)channel;
+
+/**
+ @brief      Handle channel occupancy change.
+ @discussion Single presence event carry identifier of subscriber which joined or left channel.
+             Interval presence announcement carry lists of subscribers which joined or left since 
+             previous announcement (lists can be \c nil if there is too many changes).
+ 
+ @param transport Reference on transport which received presence event.
+ @param occupancy Number of subscribers which currently subscribed on channel.
+ @param joined    List of identifiers of subscribers which joined channel.
+ @param left      List of identifiers of subscribers which left channel (or timed out).
+ @param channel   Reference on name of channel for which occupancy changed.
+ */
+- (void)transport:(id<SPNPTransport>)transport didReceiveOccupancy:(NSUInteger)occupancy
+           joined:(NSArray *)joined left:(NSArray *)left onChannel:(NSString *)channel;
+
+@end
+
+
+/**
+ @brief      Protocol which describe real-time communication layer used by poll manager.
+ @discussion Allow to replace \b PubNub client with other implementations (for example in-process
+             loopback transport for load tests).
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+@protocol SPNPTransport <NSObject>
+
+
+@required
+
+///------------------------------------------------
+/// @name Information
+///------------------------------------------------
+
+/**
+ @brief  Stores reference on object which should receive real-time events.
+ */
+@property (nonatomic, weak) id<SPNPTransportDelegate> delegate;
+
+/**
+ @brief  Stores reference on unique identifier of transport's user.
+ */
+@property (nonatomic, readonly, copy) NSString *uuid;
+
+
+///------------------------------------------------
+/// @name Subscription
+///------------------------------------------------
+
+/**
+ @brief  Subscribe to real-time events on specified channels.
+ 
+ @param channels List of channel names (names with \c -pnpres suffix used to subscribe on presence
+                 events).
+ */
+- (void)subscribeToChannels:(NSArray *)channels;
+
+/**
+ @brief      Stop receiving real-time events from specified channels.
+ @discussion Transport stay connected to the rest of channels.
+ 
+ @param channels List of channel names.
+ */
+- (void)unsubscribeFromChannels:(NSArray *)channels;
+
+
+///------------------------------------------------
+/// @name Publish
+///------------------------------------------------
+
+/**
+ @brief  Send message to the channel.
+ 
+ @param message Reference on object which should be sent (\c NSString or JSON compatible 
+                collection).
+ @param channel Reference on name of channel to which message should be sent.
+ @param payload Reference on optional mobile push notification payload.
+ @param block   Reference on block which should be called at the end of publish process. Block pass
+                only one argument - publish error description.
+ */
+- (void)publish:(id)message toChannel:(NSString *)channel mobilePushPayload:(NSDictionary *)payload
+ withCompletion:(void(^)(NSString *errorMessage))block;
+
+
+///------------------------------------------------
+/// @name History
+///------------------------------------------------
+
+/**
+ @brief  Retrieve messages which has been sent to the channel.
+ 
+ @param channel Reference on name of channel for which history should be retrieved.
+ @param limit   Maximum number of latest messages which should be returned.
+ @param block   Reference on block which should be called at the end of history retrieve process.
+                Block pass two arguments: \c messages - list of messages (from oldest to newest);
+                \c errorMessage - history request error description.
+ */
+- (void)historyForChannel:(NSString *)channel limit:(NSUInteger)limit
+           withCompletion:(void(^)(NSArray *messages, NSString *errorMessage))block;
+
+/**
+ @brief      Retrieve page of messages which has been sent to the channel in specified time range.
+ @discussion Messages returned from oldest to newest, so next page can be requested starting from 
+             time token of last message in page.
+ 
+ @param channel Reference on name of channel for which history should be retrieved.
+ @param start   Time token after which (exclusive) messages should be returned or \c nil to start 
+                from oldest message.
+ @param end     Time token till which (inclusive) messages should be returned or \c nil to return 
+                messages till latest one.
+ @param limit   Maximum number of messages which should be returned.
+ @param block   Reference on block which should be called at the end of history retrieve process.
+                Block pass three arguments: \c messages - list of messages (from oldest to newest);
+                \c lastTimetoken - time token of last message in page; \c errorMessage - history 
+                request error description.
+ */
+- (void)historyForChannel:(NSString *)channel start:(NSNumber *)start end:(NSNumber *)end
+                    limit:(NSUInteger)limit
+           withCompletion:(void(^)(NSArray *messages, NSNumber *lastTimetoken,
+                                   NSString *errorMessage))block;
+
+
+///------------------------------------------------
+/// @name Time
+///------------------------------------------------
+
+/**
+ @brief      Retrieve current real-time network time token.
+ @discussion Time token can be compared with time tokens of messages stored in history (unlike time
+             of local clock which may be skewed).
+ 
+ @param block Reference on block which should be called at the end of time request. Block pass two
+              arguments: \c timetoken - current time token (10^-7 seconds since 1970);
+              \c errorMessage - time request error description.
+ */
+- (void)timeWithCompletion:(void(^)(NSNumber *timetoken, NSString *errorMessage))block;
+
+
+///------------------------------------------------
+/// @name Push notifications
+///------------------------------------------------
+
+/**
+ @brief  Enable push notifications on specified channels.
+ 
+ @param channels List of channel names for which push notifications should be enabled.
+ @param token    Reference on device push token.
+ */
+- (void)addPushNotificationsOnChannels:(NSArray *)channels withDevicePushToken:(NSData *)token;
+
+@end
@@ -0,0 +1,304 @@
+/**
+ @brief      Tests for compact binary format encoder and decoder.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <XCTest/XCTest.h>
+#import "SPNPPollResponse.h"
+#import "SPNPCompactCoder.h"
+#import "SPNPPoll.h"
+
+
+#pragma mark Interface declaration
+
+@interface SPNPCompactCoderTests : XCTestCase
+
+
+#pragma mark - Properties
+
+@property (nonatomic, strong) SPNPPoll *poll;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Construct encoder for tested poll.
+ 
+ @return Configured and ready to use encoder.
+ */
+- (SPNPCompactCoder *)encoder;
+
+/**
+ @brief  Construct decoder for tested poll.
+ 
+ @param data Reference on data which should be decoded.
+ 
+ @return Configured and ready to use decoder.
+ */
+- (SPNPCompactCoder *)decoderWithData:(NSData *)data;
+
+/**
+ @brief  Construct decoder for tested poll from raw bytes.
+ 
+ @param bytes  Pointer on bytes which should be decoded.
+ @param length Number of bytes which should be decoded.
+ 
+ @return Configured and ready to use decoder.
+ */
+- (SPNPCompactCoder *)decoderWithBytes:(const uint8_t *)bytes length:(NSUInteger)length;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPCompactCoderTests
+
+
+#pragma mark - Configuration
+
+- (void)setUp {
+    
+    [super setUp];
+    
+    self.poll = [SPNPPoll pollWithQuestion:@"Best talk?" responses:@[@"First", @"Second"]];
+}
+
+
+#pragma mark - Integers
+
+- (void)testUnsignedIntegerBoundaryValuesRoundTrip {
+    
+    uint64_t values[] = {0, 1, 127, 128, 16383, 16384, UINT32_MAX, (1ULL << 63), UINT64_MAX};
+    NSUInteger lengths[] = {1, 1, 1, 2, 2, 3, 5, 10, 10};
+    for (NSUInteger valueIdx = 0; valueIdx < sizeof(values) / sizeof(uint64_t); valueIdx++) {
+        
+        SPNPCompactCoder *encoder = [self encoder];
+        [encoder encodeUnsignedInteger:values[valueIdx]];
+        XCTAssertEqual(encoder.data.length, lengths[valueIdx]);
+        
+        SPNPCompactCoder *decoder = [self decoderWithData:encoder.data];
+        XCTAssertEqual([decoder decodeUnsignedInteger], values[valueIdx]);
+        XCTAssertTrue(decoder.isValid);
+        XCTAssertTrue(decoder.isAtEnd);
+    }
+}
+
+- (void)testSignedIntegerZigZagBoundaryValuesRoundTrip {
+    
+    int64_t values[] = {0, -1, 1, -64, 63, 64, INT32_MIN, INT64_MIN, INT64_MAX};
+    NSUInteger lengths[] = {1, 1, 1, 1, 1, 2, 5, 10, 10};
+    for (NSUInteger valueIdx = 0; valueIdx < sizeof(values) / sizeof(int64_t); valueIdx++) {
+        
+        SPNPCompactCoder *encoder = [self encoder];
+        [encoder encodeSignedInteger:values[valueIdx]];
+        XCTAssertEqual(encoder.data.length, lengths[valueIdx]);
+        
+        SPNPCompactCoder *decoder = [self decoderWithData:encoder.data];
+        XCTAssertEqual([decoder decodeSignedInteger], values[valueIdx]);
+        XCTAssertTrue(decoder.isValid);
+        XCTAssertTrue(decoder.isAtEnd);
+    }
+    
+    SPNPCompactCoder *encoder = [self encoder];
+    [encoder encodeSignedInteger:-1];
+    [encoder encodeSignedInteger:1];
+    XCTAssertEqual(((const uint8_t *)encoder.data.bytes)[0], 0x01);
+    XCTAssertEqual(((const uint8_t *)encoder.data.bytes)[1], 0x02);
+}
+
+- (void)testTruncatedVarintRejected {
+    
+    uint8_t bytes[] = {0xFF, 0xFF, 0x80};
+    SPNPCompactCoder *decoder = [self decoderWithBytes:bytes length:sizeof(bytes)];
+    XCTAssertEqual([decoder decodeUnsignedInteger], 0);
+    XCTAssertFalse(decoder.isValid);
+    XCTAssertNil([decoder decodeNumber]);
+}
+
+- (void)testVarintLongerThan64BitsRejected {
+    
+    uint8_t overflow[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x03};
+    SPNPCompactCoder *decoder = [self decoderWithBytes:overflow length:sizeof(overflow)];
+    XCTAssertEqual([decoder decodeUnsignedInteger], 0);
+    XCTAssertFalse(decoder.isValid);
+    
+    uint8_t overlong[] = {0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01};
+    decoder = [self decoderWithBytes:overlong length:sizeof(overlong)];
+    XCTAssertEqual([decoder decodeUnsignedInteger], 0);
+    XCTAssertFalse(decoder.isValid);
+}
+
+
+#pragma mark - Values
+
+- (void)testValuesRoundTrip {
+    
+    NSString *uuid = [NSUUID UUID].UUIDString;
+    SPNPCompactCoder *encoder = [self encoder];
+    [encoder encodeNumber:nil];
+    [encoder encodeNumber:@0];
+    [encoder encodeNumber:@42];
+    [encoder encodeBool:YES];
+    [encoder encodeDouble:-0.5];
+    [encoder encodeString:nil];
+    [encoder encodeString:@""];
+    [encoder encodeString:@"Доклад"];
+    [encoder encodeIdentifier:uuid];
+    [encoder encodeIdentifier:@"attendee"];
+    [encoder encodeIdentifier:nil];
+    [encoder encodePollIdentifier:self.poll.identifier];
+    
+    SPNPCompactCoder *decoder = [self decoderWithData:encoder.data];
+    XCTAssertNil([decoder decodeNumber]);
+    XCTAssertEqualObjects([decoder decodeNumber], @0);
+    XCTAssertEqualObjects([decoder decodeNumber], @42);
+    XCTAssertTrue([decoder decodeBool]);
+    XCTAssertEqual([decoder decodeDouble], -0.5);
+    XCTAssertNil([decoder decodeString]);
+    XCTAssertEqualObjects([decoder decodeString], @"");
+    XCTAssertEqualObjects([decoder decodeString], @"Доклад");
+    XCTAssertEqualObjects([decoder decodeIdentifier], uuid);
+    XCTAssertEqualObjects([decoder decodeIdentifier], @"attendee");
+    XCTAssertNil([decoder decodeIdentifier]);
+    XCTAssertEqualObjects([decoder decodePollIdentifier], self.poll.identifier);
+    XCTAssertTrue(decoder.isValid);
+    XCTAssertTrue(decoder.isAtEnd);
+}
+
+- (void)testObjectsListRoundTrip {
+    
+    SPNPCompactCoder *encoder = [self encoder];
+    [encoder encodeObjects:self.poll.responses];
+    [encoder encodeObjects:nil];
+    
+    SPNPCompactCoder *decoder = [self decoderWithData:encoder.data];
+    NSArray *responses = [decoder decodeObjectsOfClass:SPNPPollResponse.class];
+    XCTAssertEqual(responses.count, 2);
+    XCTAssertEqualObjects([responses.lastObject response], @"Second");
+    XCTAssertEqualObjects([responses.lastObject order], @1);
+    XCTAssertNil([decoder decodeObjectsOfClass:SPNPPollResponse.class]);
+    XCTAssertTrue(decoder.isValid);
+    XCTAssertTrue(decoder.isAtEnd);
+}
+
+
+#pragma mark - Damaged data
+
+- (void)testListLongerThanLimitRejected {
+    
+    // Declared list length followed by single valid element.
+    SPNPCompactCoder *encoder = [self encoder];
+    [encoder encodeUnsignedInteger:(65536 + 1)];
+    [self.poll.responses.firstObject encodeWithCompactCoder:encoder];
+    
+    SPNPCompactCoder *decoder = [self decoderWithData:encoder.data];
+    XCTAssertNil([decoder decodeObjectsOfClass:SPNPPollResponse.class]);
+    XCTAssertFalse(decoder.isValid);
+    
+    // List with allowed length fails on first missing element.
+    encoder = [self encoder];
+    [encoder encodeUnsignedInteger:(65535 + 1)];
+    [self.poll.responses.firstObject encodeWithCompactCoder:encoder];
+    decoder = [self decoderWithData:encoder.data];
+    XCTAssertNil([decoder decodeObjectsOfClass:SPNPPollResponse.class]);
+    XCTAssertFalse(decoder.isValid);
+}
+
+- (void)testTrailingBytesLeaveDecoderNotAtEnd {
+    
+    SPNPCompactCoder *encoder = [self encoder];
+    [encoder encodeNumber:@7];
+    [encoder encodeBool:NO];
+    
+    SPNPCompactCoder *decoder = [self decoderWithData:encoder.data];
+    XCTAssertEqualObjects([decoder decodeNumber], @7);
+    XCTAssertTrue(decoder.isValid);
+    XCTAssertFalse(decoder.isAtEnd);
+    XCTAssertFalse([decoder decodeBool]);
+    XCTAssertTrue(decoder.isAtEnd);
+}
+
+- (void)testReadPastEndFailsCleanly {
+    
+    uint8_t bytes[] = {0x01, 0x02};
+    SPNPCompactCoder *decoder = [self decoderWithBytes:bytes length:sizeof(bytes)];
+    XCTAssertEqual([decoder decodeDouble], 0.0f);
+    XCTAssertFalse(decoder.isValid);
+    XCTAssertEqual([decoder decodeUnsignedInteger], 0);
+    XCTAssertFalse([decoder decodeBool]);
+    XCTAssertNil([decoder decodeString]);
+    XCTAssertNil([decoder decodeIdentifier]);
+    XCTAssertFalse(decoder.isValid);
+    
+    // String length prefix which point behind the end of data.
+    SPNPCompactCoder *encoder = [self encoder];
+    [encoder encodeUnsignedInteger:101];
+    [encoder encodeBool:YES];
+    decoder = [self decoderWithData:encoder.data];
+    XCTAssertNil([decoder decodeString]);
+    XCTAssertFalse(decoder.isValid);
+    
+    encoder = [self encoder];
+    [encoder encodeUnsignedInteger:UINT64_MAX];
+    decoder = [self decoderWithData:encoder.data];
+    XCTAssertNil([decoder decodeString]);
+    XCTAssertFalse(decoder.isValid);
+    
+    // Unknown identifier type.
+    encoder = [self encoder];
+    [encoder encodeUnsignedInteger:9];
+    decoder = [self decoderWithData:encoder.data];
+    XCTAssertNil([decoder decodePollIdentifier]);
+    XCTAssertFalse(decoder.isValid);
+}
+
+- (void)testReusableDecoderRejectsDamagedRepresentation {
+    
+    SPNPCompactCoder *encoder = [self encoder];
+    [encoder encodeString:@"reusable"];
+    NSString *representation = [encoder.data base64EncodedStringWithOptions:0];
+    SPNPCompactCoder *decoder = [SPNPCompactCoder reusableDecoderForPoll:self.poll.identifier
+                                                                   token:self.poll.token];
+    XCTAssertFalse([decoder resetWithRepresentation:@"AAA"]);
+    XCTAssertFalse([decoder resetWithRepresentation:@"A*=="]);
+    XCTAssertFalse([decoder resetWithRepresentation:(NSString *)@42]);
+    XCTAssertNil([decoder decodeString]);
+    
+    XCTAssertTrue([decoder resetWithRepresentation:representation]);
+    XCTAssertEqualObjects([decoder decodeString], @"reusable");
+    XCTAssertTrue(decoder.isAtEnd);
+    
+    // Only part of representation decoded and string is cut.
+    XCTAssertTrue([decoder resetWithRepresentation:representation length:4]);
+    XCTAssertNil([decoder decodeString]);
+    XCTAssertFalse(decoder.isValid);
+}
+
+
+#pragma mark - Misc
+
+- (SPNPCompactCoder *)encoder {
+    
+    return [SPNPCompactCoder encoderForPoll:self.poll.identifier token:self.poll.token];
+}
+
+- (SPNPCompactCoder *)decoderWithData:(NSData *)data {
+    
+    return [SPNPCompactCoder decoderWithData:[data copy] forPoll:self.poll.identifier
+                                       token:self.poll.token];
+}
+
+- (SPNPCompactCoder *)decoderWithBytes:(const uint8_t *)bytes length:(NSUInteger)length {
+    
+    return [self decoderWithData:[NSData dataWithBytes:bytes length:length]];
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,127 @@
+/**
+ @brief      Tests for least recently used objects cache with cost limit.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <XCTest/XCTest.h>
+#import "SPNPCostCache.h"
+
+
+#pragma mark Interface declaration
+
+@interface SPNPCostCacheTests : XCTestCase
+
+
+#pragma mark - Properties
+
+@property (nonatomic, strong) SPNPCostCache *cache;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPCostCacheTests
+
+
+#pragma mark - Configuration
+
+- (void)setUp {
+    
+    [super setUp];
+    
+    self.cache = [SPNPCostCache cacheWithCostLimit:10];
+}
+
+
+#pragma mark - Objects
+
+- (void)testLookupCountHitsAndMisses {
+    
+    [self.cache setObject:@"first" forKey:@"a" cost:4];
+    
+    XCTAssertEqualObjects([self.cache objectForKey:@"a"], @"first");
+    XCTAssertNil([self.cache objectForKey:@"b"]);
+    XCTAssertEqual(self.cache.hitsCount, 1);
+    XCTAssertEqual(self.cache.missesCount, 1);
+}
+
+- (void)testLeastRecentlyUsedObjectEvicted {
+    
+    [self.cache setObject:@"first" forKey:@"a" cost:4];
+    [self.cache setObject:@"second" forKey:@"b" cost:4];
+    [self.cache objectForKey:@"a"];
+    [self.cache setObject:@"third" forKey:@"c" cost:4];
+    
+    XCTAssertNil([self.cache objectForKey:@"b"]);
+    XCTAssertEqualObjects([self.cache objectForKey:@"a"], @"first");
+    XCTAssertEqualObjects([self.cache objectForKey:@"c"], @"third");
+    XCTAssertEqual(self.cache.count, 2);
+    XCTAssertEqual(self.cache.totalCost, 8);
+    XCTAssertEqual(self.cache.evictionsCount, 1);
+}
+
+- (void)testReplacedObjectCostUpdated {
+    
+    [self.cache setObject:@"first" forKey:@"a" cost:4];
+    [self.cache setObject:@"second" forKey:@"b" cost:2];
+    [self.cache setObject:@"updated" forKey:@"a" cost:8];
+    
+    XCTAssertEqualObjects([self.cache objectForKey:@"a"], @"updated");
+    XCTAssertEqual(self.cache.count, 2);
+    XCTAssertEqual(self.cache.totalCost, 10);
+    XCTAssertEqual(self.cache.evictionsCount, 0);
+}
+
+- (void)testObjectExceedingLimitNotStored {
+    
+    [self.cache setObject:@"first" forKey:@"a" cost:4];
+    [self.cache setObject:@"large" forKey:@"b" cost:11];
+    [self.cache setObject:@"large" forKey:@"a" cost:11];
+    
+    XCTAssertEqual(self.cache.count, 0);
+    XCTAssertEqual(self.cache.totalCost, 0);
+    XCTAssertNil([self.cache objectForKey:@"b"]);
+}
+
+- (void)testDecreasedLimitEvictRightAway {
+    
+    for (NSUInteger objectIdx = 0; objectIdx < 5; objectIdx++) {
+        
+        [self.cache setObject:@(objectIdx) forKey:@(objectIdx) cost:2];
+    }
+    [self.cache objectForKey:@0];
+    self.cache.costLimit = 4;
+    
+    XCTAssertEqual(self.cache.count, 2);
+    XCTAssertEqual(self.cache.evictionsCount, 3);
+    XCTAssertEqualObjects([self.cache objectForKey:@0], @0);
+    XCTAssertEqualObjects([self.cache objectForKey:@4], @4);
+    XCTAssertNil([self.cache objectForKey:@1]);
+}
+
+- (void)testRemovedObjectsReleaseCost {
+    
+    [self.cache setObject:@"first" forKey:@"a" cost:4];
+    [self.cache setObject:@"second" forKey:@"b" cost:4];
+    [self.cache removeObjectForKey:@"a"];
+    XCTAssertEqual(self.cache.totalCost, 4);
+    
+    [self.cache objectForKey:@"b"];
+    [self.cache removeAllObjects];
+    XCTAssertEqual(self.cache.count, 0);
+    XCTAssertEqual(self.cache.totalCost, 0);
+    XCTAssertEqual(self.cache.hitsCount, 1);
+    
+    [self.cache setObject:@"third" forKey:@"c" cost:10];
+    XCTAssertEqualObjects([self.cache objectForKey:@"c"], @"third");
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,242 @@
+/**
+ @brief      Tests for Space-Saving top-K items counter.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <XCTest/XCTest.h>
+#import "SPNPHeavyHitters.h"
+
+
+#pragma mark Interface declaration
+
+@interface SPNPHeavyHittersTests : XCTestCase
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Retrieve most frequent items.
+ 
+ @param count        Maximum number of items which should be returned.
+ @param heavyHitters Reference on counter from which items should be retrieved.
+ 
+ @return List of items in "<item>:<count>:<error>" format (ordered by count from largest).
+ */
+- (NSArray *)topItems:(NSUInteger)count from:(SPNPHeavyHitters *)heavyHitters;
+
+/**
+ @brief      Generate stream of items with Zipf-distributed frequencies.
+ @discussion Item with rank \c k appear with probability proportional to 1 / k^1.1 (like answers on
+             open-text poll). Stream generated with fixed seed, so it is the same for each call.
+ 
+ @param count         Number of items in stream.
+ @param distinctCount Number of different items in stream.
+ 
+ @return List of items in "item-<rank>" format.
+ */
+- (NSArray *)zipfItems:(NSUInteger)count withDistinctCount:(NSUInteger)distinctCount;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPHeavyHittersTests
+
+
+#pragma mark - Counting
+
+- (void)testItemsCountedExactlyWithinCapacity {
+    
+    SPNPHeavyHitters *heavyHitters = [SPNPHeavyHitters heavyHittersWithCapacity:4];
+    for (NSString *item in @[@"b", @"a", @"c", @"a", @"b", @"a", @"a", @"b", @"a"]) {
+        
+        [heavyHitters addItem:item];
+    }
+    [heavyHitters addItem:nil];
+    
+    XCTAssertEqualObjects([self topItems:10 from:heavyHitters], (@[@"a:5:0", @"b:3:0", @"c:1:0"]));
+    XCTAssertEqualObjects([self topItems:2 from:heavyHitters], (@[@"a:5:0", @"b:3:0"]));
+    XCTAssertEqual(heavyHitters.trackedCount, 3);
+    XCTAssertEqual(heavyHitters.totalCount, 9);
+}
+
+- (void)testLeastFrequentItemReplaced {
+    
+    SPNPHeavyHitters *heavyHitters = [SPNPHeavyHitters heavyHittersWithCapacity:2];
+    for (NSString *item in @[@"a", @"a", @"a", @"b", @"c"]) {
+        
+        [heavyHitters addItem:item];
+    }
+    
+    // New item inherit count of replaced item as possible overestimation.
+    XCTAssertEqualObjects([self topItems:10 from:heavyHitters], (@[@"a:3:0", @"c:2:1"]));
+    XCTAssertEqual(heavyHitters.trackedCount, 2);
+    XCTAssertEqual(heavyHitters.maximumError, 2);
+}
+
+- (void)testFrequentItemKeptInLongTail {
+    
+    SPNPHeavyHitters *heavyHitters = [SPNPHeavyHitters heavyHittersWithCapacity:10];
+    for (NSUInteger itemIdx = 0; itemIdx < 1000; itemIdx++) {
+        
+        NSString *item = (itemIdx % 4 == 0 ? @"hot" : @(itemIdx).stringValue);
+        [heavyHitters addItem:item];
+    }
+    
+    __block NSString *topItem = nil;
+    __block unsigned long long topItemCount = 0;
+    __block unsigned long long topItemError = 0;
+    [heavyHitters enumerateTopItems:1 usingBlock:^(NSString *item, unsigned long long itemCount,
+                                                   unsigned long long error, BOOL *stop) {
+        
+        topItem = item;
+        topItemCount = itemCount;
+        topItemError = error;
+    }];
+    XCTAssertEqualObjects(topItem, @"hot");
+    XCTAssertGreaterThanOrEqual(topItemCount, 250);
+    XCTAssertLessThanOrEqual(topItemCount - topItemError, 250);
+    XCTAssertLessThanOrEqual(topItemError, heavyHitters.maximumError);
+    XCTAssertEqual(heavyHitters.trackedCount, 10);
+}
+
+- (void)testEnumerationStopped {
+    
+    SPNPHeavyHitters *heavyHitters = [SPNPHeavyHitters heavyHittersWithCapacity:4];
+    for (NSString *item in @[@"a", @"b", @"c"]) { [heavyHitters addItem:item]; }
+    
+    __block NSUInteger enumeratedCount = 0;
+    [heavyHitters enumerateTopItems:10 usingBlock:^(NSString *item, unsigned long long itemCount,
+                                                    unsigned long long error, BOOL *stop) {
+        
+        enumeratedCount++;
+        *stop = YES;
+    }];
+    XCTAssertEqual(enumeratedCount, 1);
+}
+
+- (void)testResetForgetItems {
+    
+    SPNPHeavyHitters *heavyHitters = [SPNPHeavyHitters heavyHittersWithCapacity:4];
+    [heavyHitters addItem:@"a"];
+    [heavyHitters reset];
+    [heavyHitters addItem:@"b"];
+    
+    XCTAssertEqualObjects([self topItems:10 from:heavyHitters], @[@"b:1:0"]);
+    XCTAssertEqual(heavyHitters.totalCount, 1);
+}
+
+
+#pragma mark - Accuracy
+
+- (void)testZipfTopItemsAccuracy {
+    
+    NSArray *items = [self zipfItems:100000 withDistinctCount:10000];
+    NSCountedSet *exactCounts = [[NSCountedSet alloc] initWithArray:items];
+    SPNPHeavyHitters *heavyHitters = [SPNPHeavyHitters heavyHittersWithCapacity:1000];
+    for (NSString *item in items) { [heavyHitters addItem:item]; }
+    
+    // Each estimated count is upper bound and estimated count without error is lower bound.
+    NSMutableSet *topItems = [NSMutableSet new];
+    [heavyHitters enumerateTopItems:5 usingBlock:^(NSString *item, unsigned long long itemCount,
+                                                   unsigned long long error, BOOL *stop) {
+        
+        unsigned long long exactCount = [exactCounts countForObject:item];
+        XCTAssertGreaterThanOrEqual(itemCount, exactCount);
+        XCTAssertLessThanOrEqual(itemCount - error, exactCount);
+        [topItems addObject:item];
+    }];
+    XCTAssertEqualObjects(topItems, ([NSSet setWithArray:@[@"item-1", @"item-2", @"item-3",
+                                                           @"item-4", @"item-5"]]));
+    XCTAssertLessThanOrEqual(heavyHitters.maximumError, 100000 / 1000);
+    XCTAssertEqual(heavyHitters.trackedCount, 1000);
+    XCTAssertEqual(heavyHitters.totalCount, 100000);
+}
+
+
+#pragma mark - Performance
+
+- (void)testZipfItemsCountingPerformance {
+    
+    NSArray *items = [self zipfItems:200000 withDistinctCount:10000];
+    [self measureBlock:^{
+        
+        SPNPHeavyHitters *heavyHitters = [SPNPHeavyHitters heavyHittersWithCapacity:100];
+        for (NSString *item in items) { [heavyHitters addItem:item]; }
+        XCTAssertEqual([self topItems:10 from:heavyHitters].count, 10);
+    }];
+}
+
+- (void)testUniqueItemsCountingPerformance {
+    
+    // Each item replace least frequent tracked item (worst case for Space-Saving).
+    NSMutableArray *items = [NSMutableArray arrayWithCapacity:200000];
+    for (NSUInteger itemIdx = 0; itemIdx < 200000; itemIdx++) {
+        
+        [items addObject:[NSString stringWithFormat:@"item-%@", @(itemIdx)]];
+    }
+    [self measureBlock:^{
+        
+        SPNPHeavyHitters *heavyHitters = [SPNPHeavyHitters heavyHittersWithCapacity:100];
+        for (NSString *item in items) { [heavyHitters addItem:item]; }
+        XCTAssertEqual(heavyHitters.trackedCount, 100);
+    }];
+}
+
+
+#pragma mark - Misc
+
+- (NSArray *)topItems:(NSUInteger)count from:(SPNPHeavyHitters *)heavyHitters {
+    
+    NSMutableArray *items = [NSMutableArray new];
+    [heavyHitters enumerateTopItems:count usingBlock:^(NSString *item, unsigned long long itemCount,
+                                                       unsigned long long error, BOOL *stop) {
+        
+        [items addObject:[NSString stringWithFormat:@"%@:%@:%@", item, @(itemCount), @(error)]];
+    }];
+    
+    return [items copy];
+}
+
+- (NSArray *)zipfItems:(NSUInteger)count withDistinctCount:(NSUInteger)distinctCount {
+    
+    NSMutableArray *distinctItems = [NSMutableArray arrayWithCapacity:distinctCount];
+    double *cumulativeWeights = calloc(distinctCount, sizeof(double));
+    double weight = 0.0f;
+    for (NSUInteger rankIdx = 0; rankIdx < distinctCount; rankIdx++) {
+        
+        weight += 1.0f / pow((double)(rankIdx + 1), 1.1f);
+        cumulativeWeights[rankIdx] = weight;
+        [distinctItems addObject:[NSString stringWithFormat:@"item-%@", @(rankIdx + 1)]];
+    }
+    
+    srand48(42);
+    NSMutableArray *items = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger itemIdx = 0; itemIdx < count; itemIdx++) {
+        
+        // Find first rank which cumulative weight is larger than random value.
+        double value = (drand48() * weight);
+        NSUInteger lowerIdx = 0;
+        NSUInteger upperIdx = (distinctCount - 1);
+        while (lowerIdx < upperIdx) {
+            
+            NSUInteger middleIdx = (lowerIdx + (upperIdx - lowerIdx) / 2);
+            if (cumulativeWeights[middleIdx] <= value) { lowerIdx = middleIdx + 1; }
+            else { upperIdx = middleIdx; }
+        }
+        [items addObject:distinctItems[lowerIdx]];
+    }
+    free(cumulativeWeights);
+    
+    return [items copy];
+}
+
+#pragma mark -
+
+
+@end
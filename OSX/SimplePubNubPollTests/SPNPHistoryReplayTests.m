@@ -0,0 +1,206 @@
+/**
+ @brief      Tests for votes recount from paged channel history.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <XCTest/XCTest.h>
+#import "SPNPLoopbackTransport.h"
+#import "SPNPLoopbackBroker.h"
+#import "SPNPHistoryReplay.h"
+#import "SPNPPollResponse.h"
+#import "SPNPVoterIndex.h"
+#import "SPNPPoll.h"
+
+
+#pragma mark Interface declaration
+
+@interface SPNPHistoryReplayTests : XCTestCase
+
+
+#pragma mark - Properties
+
+@property (nonatomic, strong) SPNPLoopbackBroker *broker;
+@property (nonatomic, strong) SPNPLoopbackTransport *host;
+@property (nonatomic, strong) SPNPPoll *poll;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Publish attendee's vote in compact representation to responses channel.
+ 
+ @param order Order number of response which has been chosen by attendee.
+ @param voter Unique identifier of attendee which submit response (\c nil for anonymous vote).
+ @param poll  Reference on poll for which vote should be published.
+ */
+- (void)publishVote:(NSUInteger)order fromVoter:(NSString *)voter inPoll:(SPNPPoll *)poll;
+
+/**
+ @brief  Publish votes which has been sent by attendees while poll has been active.
+ 
+ @return Number of messages which has been published to responses channel.
+ */
+- (NSUInteger)publishPollVotes;
+
+/**
+ @brief  Replay votes for tested poll and wait for completion.
+ 
+ @param replay           Reference on configured replay instance.
+ @param allowsVoteChange Whether latest vote of the same attendee should be counted.
+ @param voters           Reference on variable into which index of counted voters should be stored.
+ 
+ @return Votes count for each poll response.
+ */
+- (NSArray *)replayVotesWith:(SPNPHistoryReplay *)replay allowingVoteChange:(BOOL)allowsVoteChange
+                      voters:(SPNPVoterIndex **)voters;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPHistoryReplayTests
+
+
+#pragma mark - Configuration
+
+- (void)setUp {
+    
+    [super setUp];
+    
+    self.broker = [SPNPLoopbackBroker new];
+    self.host = [SPNPLoopbackTransport transportWithBroker:self.broker uuid:@"host"];
+    SPNPPoll *poll = [SPNPPoll pollWithQuestion:@"Best talk?"
+                                      responses:@[@"First", @"Second", @"Third"]];
+    
+    // Vote which has been sent before poll start shouldn't be counted.
+    [self publishVote:0 fromVoter:@"early" inPoll:poll];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Poll start"];
+    [self.broker timeWithCompletion:^(NSNumber *timetoken, NSString *errorMessage) {
+        
+        self.poll = [poll pollStartedAt:timetoken];
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0f handler:nil];
+}
+
+
+#pragma mark - Replay
+
+- (void)testFirstVoteCountedAcrossPages {
+    
+    NSUInteger messagesCount = [self publishPollVotes];
+    SPNPHistoryReplay *replay = [SPNPHistoryReplay replayWithTransport:self.host
+                                                              channel:@"responses"];
+    replay.pageSize = 2;
+    replay.maximumConcurrentRequests = 1;
+    SPNPVoterIndex *voters = nil;
+    NSArray *votesCount = [self replayVotesWith:replay allowingVoteChange:NO voters:&voters];
+    
+    XCTAssertEqualObjects(votesCount, (@[@1, @2, @1]));
+    XCTAssertEqual(voters.count, 4);
+    XCTAssertEqual([voters choiceForVoter:@"first"], 0);
+    XCTAssertEqual([voters choiceForVoter:@"early"], NSNotFound);
+    XCTAssertEqual(replay.decodedMessagesCount, messagesCount);
+    XCTAssertGreaterThan(replay.fetchedPagesCount, 1);
+}
+
+- (void)testChangedVoteCountedForConcurrentSegments {
+    
+    [self publishPollVotes];
+    SPNPHistoryReplay *replay = [SPNPHistoryReplay replayWithTransport:self.host
+                                                              channel:@"responses"];
+    replay.pageSize = 2;
+    replay.maximumConcurrentRequests = 4;
+    SPNPVoterIndex *voters = nil;
+    NSArray *votesCount = [self replayVotesWith:replay allowingVoteChange:YES voters:&voters];
+    
+    XCTAssertEqualObjects(votesCount, (@[@0, @2, @2]));
+    XCTAssertEqual(voters.count, 4);
+    XCTAssertEqual([voters choiceForVoter:@"first"], 2);
+}
+
+- (void)testProgressReportedForPartialCount {
+    
+    [self publishPollVotes];
+    SPNPHistoryReplay *replay = [SPNPHistoryReplay replayWithTransport:self.host
+                                                              channel:@"responses"];
+    replay.pageSize = 1;
+    replay.maximumConcurrentRequests = 1;
+    __block float lastProgress = 0.0f;
+    __block NSUInteger progressCount = 0;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Replay"];
+    [replay replayVotesForPoll:self.poll allowingVoteChange:NO
+                 progressBlock:^(NSArray *votesCount, float progress) {
+        
+        XCTAssertEqual(votesCount.count, 3);
+        XCTAssertGreaterThanOrEqual(progress, lastProgress);
+        XCTAssertLessThanOrEqual(progress, 1.0f);
+        lastProgress = progress;
+        progressCount++;
+    }
+               completionBlock:^(NSArray *votesCount, SPNPVoterIndex *voters,
+                                 NSString *errorMessage) {
+        
+        XCTAssertNil(errorMessage);
+        XCTAssertEqualObjects(votesCount, (@[@1, @2, @1]));
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0f handler:nil];
+    XCTAssertGreaterThan(progressCount, 0);
+}
+
+
+#pragma mark - Misc
+
+- (void)publishVote:(NSUInteger)order fromVoter:(NSString *)voter inPoll:(SPNPPoll *)poll {
+    
+    SPNPPollResponse *response = [SPNPPollResponse pollResponseFor:poll.identifier withValue:@""
+                                                       orderNumber:@(order) voter:voter];
+    [self.broker publish:[response compactRepresentationForPoll:poll.identifier token:poll.token]
+               toChannel:@"responses" fromPublisher:(voter ?: @"anonymous") withCompletion:nil];
+}
+
+- (NSUInteger)publishPollVotes {
+    
+    SPNPPoll *otherPoll = [SPNPPoll pollWithQuestion:@"Other" responses:@[@"First", @"Second"]];
+    [self publishVote:0 fromVoter:@"first" inPoll:self.poll];
+    [self publishVote:1 fromVoter:@"second" inPoll:self.poll];
+    [self publishVote:1 fromVoter:@"first" inPoll:otherPoll];
+    [self publishVote:2 fromVoter:@"third" inPoll:self.poll];
+    [self publishVote:0 fromVoter:nil inPoll:self.poll];
+    [self publishVote:2 fromVoter:@"first" inPoll:self.poll];
+    [self publishVote:1 fromVoter:@"fourth" inPoll:self.poll];
+    
+    return 7;
+}
+
+- (NSArray *)replayVotesWith:(SPNPHistoryReplay *)replay allowingVoteChange:(BOOL)allowsVoteChange
+                      voters:(SPNPVoterIndex **)voters {
+    
+    __block NSArray *replayedVotesCount = nil;
+    __block SPNPVoterIndex *replayedVoters = nil;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Replay"];
+    [replay replayVotesForPoll:self.poll allowingVoteChange:allowsVoteChange progressBlock:nil
+               completionBlock:^(NSArray *votesCount, SPNPVoterIndex *index,
+                                 NSString *errorMessage) {
+        
+        XCTAssertNil(errorMessage);
+        replayedVotesCount = votesCount;
+        replayedVoters = index;
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0f handler:nil];
+    if (voters) { *voters = replayedVoters; }
+    
+    return replayedVotesCount;
+}
+
+#pragma mark -
+
+
+@end
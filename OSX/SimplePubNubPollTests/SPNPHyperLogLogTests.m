@@ -0,0 +1,294 @@
+/**
+ @brief      Tests for unique identifiers count estimation sketch.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <XCTest/XCTest.h>
+#import "SPNPHyperLogLog.h"
+#import "SPNPVoterIndex.h"
+
+
+#pragma mark Interface declaration
+
+@interface SPNPHyperLogLogTests : XCTestCase
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Add fingerprints of attendee identifiers to sketch.
+ 
+ @param count  Number of unique attendee identifiers which should be added.
+ @param sketch Reference on sketch into which identifiers should be added.
+ */
+- (void)addAttendees:(NSUInteger)count toSketch:(SPNPHyperLogLog *)sketch;
+
+/**
+ @brief  Add fingerprints of attendee identifiers from specified range to sketch.
+ 
+ @param range  Range of attendee identifiers which should be added.
+ @param sketch Reference on sketch into which identifiers should be added.
+ */
+- (void)addAttendeesInRange:(NSRange)range toSketch:(SPNPHyperLogLog *)sketch;
+
+/**
+ @brief  Create sketches for host nodes which counted overlapping subsets of attendees.
+ 
+ @param nodesCount     Number of host nodes for which sketches should be created.
+ @param attendeesCount Number of attendees which has been counted by each node (half of them also
+                       counted by next node).
+ 
+ @return List of \b SPNPHyperLogLog instances (one for each node).
+ */
+- (NSArray *)sketchesForNodes:(NSUInteger)nodesCount withAttendees:(NSUInteger)attendeesCount;
+
+/**
+ @brief  Shuffle list of objects.
+ 
+ @param array Reference on list which should be shuffled.
+ 
+ @return Shuffled copy of \c array.
+ */
+- (NSArray *)shuffledArray:(NSArray *)array;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPHyperLogLogTests
+
+
+#pragma mark - Configuration
+
+- (void)testPrecisionClamped {
+    
+    XCTAssertEqual([SPNPHyperLogLog sketch].precision, 12);
+    XCTAssertEqual([SPNPHyperLogLog sketch].memoryUsage, 4096);
+    XCTAssertEqual([SPNPHyperLogLog sketchWithPrecision:2].precision, 4);
+    XCTAssertEqual([SPNPHyperLogLog sketchWithPrecision:20].precision, 16);
+}
+
+
+#pragma mark - Estimation
+
+- (void)testEmptySketchEstimateZero {
+    
+    XCTAssertEqual([SPNPHyperLogLog sketch].estimatedCount, 0);
+}
+
+- (void)testSmallCardinalityEstimatedClosely {
+    
+    SPNPHyperLogLog *sketch = [SPNPHyperLogLog sketch];
+    [self addAttendees:100 toSketch:sketch];
+    
+    XCTAssertEqualWithAccuracy((double)sketch.estimatedCount, 100.0, 3.0);
+}
+
+- (void)testLargeCardinalityEstimatedWithinError {
+    
+    SPNPHyperLogLog *sketch = [SPNPHyperLogLog sketch];
+    [self addAttendees:100000 toSketch:sketch];
+    
+    // Standard error for default precision is about 1.6%.
+    XCTAssertEqualWithAccuracy((double)sketch.estimatedCount, 100000.0, 5000.0);
+}
+
+- (void)testRepeatedIdentifiersNotCounted {
+    
+    SPNPHyperLogLog *sketch = [SPNPHyperLogLog sketch];
+    [self addAttendees:1000 toSketch:sketch];
+    unsigned long long estimatedCount = sketch.estimatedCount;
+    for (NSUInteger attendeeIdx = 0; attendeeIdx < 1000; attendeeIdx++) {
+        
+        NSString *attendee = [NSString stringWithFormat:@"attendee-%@", @(attendeeIdx)];
+        XCTAssertFalse([sketch addKey:[SPNPVoterIndex keyForVoter:attendee]]);
+    }
+    
+    XCTAssertEqual(sketch.estimatedCount, estimatedCount);
+}
+
+- (void)testResetForgetIdentifiers {
+    
+    SPNPHyperLogLog *sketch = [SPNPHyperLogLog sketch];
+    [self addAttendees:1000 toSketch:sketch];
+    [sketch reset];
+    
+    XCTAssertEqual(sketch.estimatedCount, 0);
+    XCTAssertTrue([sketch addKey:[SPNPVoterIndex keyForVoter:@"attendee-0"]]);
+    XCTAssertEqual(sketch.estimatedCount, 1);
+}
+
+
+#pragma mark - Merge
+
+- (void)testMergeIdempotentAndCommutative {
+    
+    NSArray *sketches = [self sketchesForNodes:2 withAttendees:1000];
+    SPNPHyperLogLog *first = [SPNPHyperLogLog sketch];
+    SPNPHyperLogLog *second = [SPNPHyperLogLog sketch];
+    XCTAssertTrue([first mergeSketch:sketches.firstObject]);
+    XCTAssertTrue([first mergeSketch:sketches.lastObject]);
+    XCTAssertFalse([first mergeSketch:sketches.lastObject]);
+    XCTAssertTrue([second mergeSketch:sketches.lastObject]);
+    XCTAssertTrue([second mergeSketch:sketches.firstObject]);
+    
+    XCTAssertEqual(first.estimatedCount, second.estimatedCount);
+    XCTAssertEqualWithAccuracy((double)first.estimatedCount, 1500.0, 75.0);
+    XCTAssertFalse([first mergeSketch:[SPNPHyperLogLog sketchWithPrecision:10]]);
+    XCTAssertFalse([first mergeSketch:nil]);
+}
+
+- (void)testNodesSketchesConvergeInAnyMergeOrder {
+    
+    // Each of 16 nodes counted 20000 attendees, half of which also counted by next node.
+    NSUInteger nodesCount = 16;
+    NSArray *sketches = [self sketchesForNodes:nodesCount withAttendees:20000];
+    NSMutableArray *replicas = [NSMutableArray new];
+    for (NSUInteger replicaIdx = 0; replicaIdx < 8; replicaIdx++) {
+        
+        // Replicas receive sketches in different order and some of them more than once.
+        SPNPHyperLogLog *replica = [SPNPHyperLogLog sketch];
+        NSArray *deliveries = [sketches arrayByAddingObjectsFromArray:
+                               [sketches subarrayWithRange:NSMakeRange(0, replicaIdx)]];
+        for (SPNPHyperLogLog *sketch in [self shuffledArray:deliveries]) {
+            
+            [replica mergeSketch:sketch];
+        }
+        [replicas addObject:replica];
+    }
+    
+    // Standard error for default precision is about 1.6%.
+    double uniqueAttendeesCount = (double)((nodesCount + 1) * 10000);
+    unsigned long long estimatedCount = [replicas.firstObject estimatedCount];
+    XCTAssertEqualWithAccuracy((double)estimatedCount, uniqueAttendeesCount,
+                               uniqueAttendeesCount * 0.05);
+    for (SPNPHyperLogLog *replica in replicas) {
+        
+        XCTAssertEqual(replica.estimatedCount, estimatedCount);
+    }
+}
+
+- (void)testGossipingNodesConverge {
+    
+    NSArray *sketches = [self sketchesForNodes:8 withAttendees:10000];
+    NSMutableArray *replicas = [NSMutableArray new];
+    for (SPNPHyperLogLog *sketch in sketches) {
+        
+        SPNPHyperLogLog *replica = [SPNPHyperLogLog sketch];
+        [replica mergeSketch:sketch];
+        [replicas addObject:replica];
+    }
+    
+    // Each round every node merge sketch of random peer until there is no changes.
+    BOOL isChanged = YES;
+    NSUInteger roundsCount = 0;
+    while (isChanged && roundsCount < 1000) {
+        
+        isChanged = NO;
+        for (SPNPHyperLogLog *replica in [self shuffledArray:replicas]) {
+            
+            isChanged |= [replica mergeSketch:replicas[arc4random_uniform(8)]];
+        }
+        roundsCount++;
+        if (!isChanged) {
+            
+            // Random peers may skip some replica, so make sure that nobody is behind.
+            for (SPNPHyperLogLog *replica in replicas) {
+                
+                for (SPNPHyperLogLog *peer in replicas) { isChanged |= [replica mergeSketch:peer]; }
+            }
+        }
+    }
+    
+    XCTAssertLessThan(roundsCount, 1000);
+    unsigned long long estimatedCount = [replicas.firstObject estimatedCount];
+    XCTAssertEqualWithAccuracy((double)estimatedCount, 45000.0, 2250.0);
+    for (SPNPHyperLogLog *replica in replicas) {
+        
+        XCTAssertEqual(replica.estimatedCount, estimatedCount);
+    }
+}
+
+
+#pragma mark - Performance
+
+- (void)testMergeEightNodesSketchesPerformance {
+    
+    NSArray *sketches = [self sketchesForNodes:8 withAttendees:10000];
+    [self measureBlock:^{
+        
+        for (NSUInteger mergeIdx = 0; mergeIdx < 1000; mergeIdx++) {
+            
+            SPNPHyperLogLog *replica = [SPNPHyperLogLog sketch];
+            for (SPNPHyperLogLog *sketch in sketches) { [replica mergeSketch:sketch]; }
+            XCTAssertGreaterThan(replica.estimatedCount, 0);
+        }
+    }];
+}
+
+- (void)testMergeSixtyFourNodesSketchesPerformance {
+    
+    NSArray *sketches = [self sketchesForNodes:64 withAttendees:10000];
+    [self measureBlock:^{
+        
+        for (NSUInteger mergeIdx = 0; mergeIdx < 125; mergeIdx++) {
+            
+            SPNPHyperLogLog *replica = [SPNPHyperLogLog sketch];
+            for (SPNPHyperLogLog *sketch in sketches) { [replica mergeSketch:sketch]; }
+            XCTAssertGreaterThan(replica.estimatedCount, 0);
+        }
+    }];
+}
+
+
+#pragma mark - Misc
+
+- (void)addAttendees:(NSUInteger)count toSketch:(SPNPHyperLogLog *)sketch {
+    
+    [self addAttendeesInRange:NSMakeRange(0, count) toSketch:sketch];
+}
+
+- (void)addAttendeesInRange:(NSRange)range toSketch:(SPNPHyperLogLog *)sketch {
+    
+    for (NSUInteger attendeeIdx = range.location; attendeeIdx < NSMaxRange(range); attendeeIdx++) {
+        
+        NSString *attendee = [NSString stringWithFormat:@"attendee-%@", @(attendeeIdx)];
+        [sketch addKey:[SPNPVoterIndex keyForVoter:attendee]];
+    }
+}
+
+- (NSArray *)sketchesForNodes:(NSUInteger)nodesCount withAttendees:(NSUInteger)attendeesCount {
+    
+    NSMutableArray *sketches = [NSMutableArray new];
+    for (NSUInteger nodeIdx = 0; nodeIdx < nodesCount; nodeIdx++) {
+        
+        SPNPHyperLogLog *sketch = [SPNPHyperLogLog sketch];
+        [self addAttendeesInRange:NSMakeRange(nodeIdx * attendeesCount / 2, attendeesCount)
+                         toSketch:sketch];
+        [sketches addObject:sketch];
+    }
+    
+    return [sketches copy];
+}
+
+- (NSArray *)shuffledArray:(NSArray *)array {
+    
+    NSMutableArray *shuffledArray = [array mutableCopy];
+    for (NSUInteger objectIdx = shuffledArray.count; objectIdx > 1; objectIdx--) {
+        
+        [shuffledArray exchangeObjectAtIndex:(objectIdx - 1)
+                           withObjectAtIndex:arc4random_uniform((uint32_t)objectIdx)];
+    }
+    
+    return [shuffledArray copy];
+}
+
+#pragma mark -
+
+
+@end
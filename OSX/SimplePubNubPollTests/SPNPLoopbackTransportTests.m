@@ -0,0 +1,257 @@
+/**
+ @brief      Tests for in-process loopback transport and broker.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <XCTest/XCTest.h>
+#import "SPNPLoopbackTransport.h"
+#import "SPNPLoopbackBroker.h"
+
+
+#pragma mark Interface declaration
+
+@interface SPNPLoopbackTransportTests : XCTestCase <SPNPTransportDelegate>
+
+
+#pragma mark - Properties
+
+@property (nonatomic, strong) SPNPLoopbackBroker *broker;
+@property (nonatomic, strong) SPNPLoopbackTransport *host;
+@property (nonatomic, strong) SPNPLoopbackTransport *attendee;
+
+/**
+ @brief  Stores reference on list of received messages in 
+         "<receiver>:<publisher>:<channel>:<message>" format.
+ */
+@property (nonatomic, strong) NSMutableArray *messages;
+
+/**
+ @brief  Stores reference on list of received presence events in
+         "<channel>:<occupancy>:<joined>:<left>" format.
+ */
+@property (nonatomic, strong) NSMutableArray *presenceEvents;
+@property (nonatomic, strong) NSMutableArray *statuses;
+
+
+#pragma mark - Misc
+
+/**
+ @brief      Wait till all events scheduled by broker will be delivered.
+ @discussion Broker process requests on serial queue and deliver events on main queue in same order,
+             so time request completion called after all previously scheduled events.
+ */
+- (void)waitForBroker;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPLoopbackTransportTests
+
+
+#pragma mark - Configuration
+
+- (void)setUp {
+    
+    [super setUp];
+    
+    self.messages = [NSMutableArray new];
+    self.presenceEvents = [NSMutableArray new];
+    self.statuses = [NSMutableArray new];
+    self.broker = [SPNPLoopbackBroker new];
+    self.host = [SPNPLoopbackTransport transportWithBroker:self.broker uuid:@"host"];
+    self.attendee = [SPNPLoopbackTransport transportWithBroker:self.broker uuid:@"attendee"];
+    self.host.delegate = self;
+    self.attendee.delegate = self;
+}
+
+
+#pragma mark - Publish
+
+- (void)testMessageDeliveredOnlyToSubscribers {
+    
+    [self.host subscribeToChannels:@[@"responses"]];
+    [self.attendee subscribeToChannels:@[@"statistic"]];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Publish"];
+    [self.attendee publish:@"vote" toChannel:@"responses" mobilePushPayload:nil
+            withCompletion:^(NSString *errorMessage) {
+        
+        XCTAssertNil(errorMessage);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0f handler:nil];
+    
+    XCTAssertEqualObjects(self.messages, @[@"host:attendee:responses:vote"]);
+    XCTAssertEqualObjects(self.statuses, (@[@(SPNPTransportConnected), @(SPNPTransportConnected)]));
+    XCTAssertEqual(self.broker.publishedMessagesCount, 1);
+    XCTAssertEqual(self.broker.deliveredMessagesCount, 1);
+}
+
+- (void)testLostMessagesNotDeliveredButStored {
+    
+    self.broker.lossRate = 1.0f;
+    [self.host subscribeToChannels:@[@"responses"]];
+    [self.attendee publish:@"vote" toChannel:@"responses" mobilePushPayload:nil
+            withCompletion:nil];
+    [self waitForBroker];
+    
+    XCTAssertEqual(self.messages.count, 0);
+    XCTAssertEqual(self.broker.lostMessagesCount, 1);
+    XCTestExpectation *expectation = [self expectationWithDescription:@"History"];
+    [self.host historyForChannel:@"responses" limit:10
+                  withCompletion:^(NSArray *messages, NSString *errorMessage) {
+        
+        XCTAssertEqualObjects(messages, @[@"vote"]);
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0f handler:nil];
+}
+
+
+#pragma mark - History
+
+- (void)testHistoryKeepLatestMessages {
+    
+    self.broker.historyLimit = 3;
+    for (NSUInteger messageIdx = 0; messageIdx < 5; messageIdx++) {
+        
+        [self.host publish:@(messageIdx) toChannel:@"statistic" mobilePushPayload:nil
+            withCompletion:nil];
+    }
+    XCTestExpectation *expectation = [self expectationWithDescription:@"History"];
+    [self.attendee historyForChannel:@"statistic" limit:2
+                      withCompletion:^(NSArray *messages, NSString *errorMessage) {
+        
+        XCTAssertEqualObjects(messages, (@[@3, @4]));
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0f handler:nil];
+}
+
+- (void)testHistoryPagesCoverTimeRange {
+    
+    for (NSUInteger messageIdx = 0; messageIdx < 5; messageIdx++) {
+        
+        [self.host publish:@(messageIdx) toChannel:@"responses" mobilePushPayload:nil
+            withCompletion:nil];
+    }
+    __block NSNumber *rangeEnd = nil;
+    XCTestExpectation *timeExpectation = [self expectationWithDescription:@"Time"];
+    [self.host timeWithCompletion:^(NSNumber *timetoken, NSString *errorMessage) {
+        
+        rangeEnd = timetoken;
+        [timeExpectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0f handler:nil];
+    [self.host publish:@5 toChannel:@"responses" mobilePushPayload:nil withCompletion:nil];
+    
+    __block NSArray *firstPage = nil;
+    __block NSNumber *firstPageEnd = nil;
+    XCTestExpectation *firstPageExpectation = [self expectationWithDescription:@"First page"];
+    [self.host historyForChannel:@"responses" start:nil end:rangeEnd limit:3
+                  withCompletion:^(NSArray *messages, NSNumber *lastTimetoken, NSString *error) {
+        
+        firstPage = messages;
+        firstPageEnd = lastTimetoken;
+        [firstPageExpectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0f handler:nil];
+    XCTAssertEqualObjects(firstPage, (@[@0, @1, @2]));
+    XCTAssertNotNil(firstPageEnd);
+    
+    XCTestExpectation *secondPageExpectation = [self expectationWithDescription:@"Second page"];
+    [self.host historyForChannel:@"responses" start:firstPageEnd end:rangeEnd limit:3
+                  withCompletion:^(NSArray *messages, NSNumber *lastTimetoken, NSString *error) {
+        
+        XCTAssertEqualObjects(messages, (@[@3, @4]));
+        XCTAssertLessThanOrEqual([lastTimetoken compare:rangeEnd], NSOrderedSame);
+        [secondPageExpectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0f handler:nil];
+}
+
+
+#pragma mark - Presence
+
+- (void)testPresenceReportJoinAndLeave {
+    
+    [self.host subscribeToChannels:@[@"poll-pnpres"]];
+    [self.attendee subscribeToChannels:@[@"poll", @"statistic"]];
+    [self waitForBroker];
+    XCTAssertEqual([self.broker occupancyForChannel:@"poll"], 1);
+    
+    [self.attendee unsubscribeFromChannels:@[@"poll"]];
+    [self waitForBroker];
+    XCTAssertEqual([self.broker occupancyForChannel:@"poll"], 0);
+    XCTAssertEqual([self.broker occupancyForChannel:@"statistic"], 1);
+    NSArray *expectedEvents = @[@"poll:0::", @"poll:1:attendee:", @"poll:0::attendee"];
+    XCTAssertEqualObjects(self.presenceEvents, expectedEvents);
+}
+
+- (void)testPresenceChangesCollectedForInterval {
+    
+    self.broker.presenceInterval = 0.1f;
+    [self.host subscribeToChannels:@[@"poll-pnpres"]];
+    [self.attendee subscribeToChannels:@[@"poll"]];
+    SPNPLoopbackTransport *lateAttendee = [SPNPLoopbackTransport transportWithBroker:self.broker
+                                                                                uuid:@"late"];
+    [lateAttendee subscribeToChannels:@[@"poll"]];
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Presence interval"];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.3f * NSEC_PER_SEC)),
+                   dispatch_get_main_queue(), ^{
+        
+        [expectation fulfill];
+    });
+    [self waitForExpectationsWithTimeout:5.0f handler:nil];
+    
+    XCTAssertEqual(self.presenceEvents.count, 1);
+    XCTAssertTrue([self.presenceEvents.firstObject hasPrefix:@"poll:"]);
+    XCTAssertTrue([self.presenceEvents.firstObject containsString:@"attendee,late"]);
+}
+
+
+#pragma mark - SPNPTransport delegate methods
+
+- (void)transport:(id<SPNPTransport>)transport didChangeStatus:(SPNPTransportStatus)status
+        withError:(NSString *)errorMessage {
+    
+    [self.statuses addObject:@(status)];
+}
+
+- (void)transport:(id<SPNPTransport>)transport didReceiveMessage:(id)message
+    fromPublisher:(NSString *)publisher onChannel:(NSString *)channel {
+    
+    [self.messages addObject:[NSString stringWithFormat:@"%@:%@:%@:%@", transport.uuid, publisher,
+                              channel, message]];
+}
+
+- (void)transport:(id<SPNPTransport>)transport didReceiveOccupancy:(NSUInteger)occupancy
+           joined:(NSArray *)joined left:(NSArray *)left onChannel:(NSString *)channel {
+    
+    [self.presenceEvents addObject:[NSString stringWithFormat:@"%@:%@:%@:%@", channel, @(occupancy),
+                                    [joined componentsJoinedByString:@","] ?: @"",
+                                    [left componentsJoinedByString:@","] ?: @""]];
+}
+
+
+#pragma mark - Misc
+
+- (void)waitForBroker {
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Broker events"];
+    [self.broker timeWithCompletion:^(NSNumber *timetoken, NSString *errorMessage) {
+        
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5.0f handler:nil];
+}
+
+#pragma mark -
+
+
+@end
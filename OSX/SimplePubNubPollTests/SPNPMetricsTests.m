@@ -0,0 +1,222 @@
+/**
+ @brief      Tests for lock-free poll manager instrumentation.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <XCTest/XCTest.h>
+#import "SPNPMetrics.h"
+
+
+#pragma mark Interface declaration
+
+@interface SPNPMetricsTests : XCTestCase
+
+
+#pragma mark - Properties
+
+@property (nonatomic, strong) SPNPMetrics *metrics;
+
+/**
+ @brief  Stores full path to the file into which metrics snapshots dumped.
+ */
+@property (nonatomic, copy) NSString *path;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Retrieve snapshot of single latency histogram.
+ 
+ @param name Name of latency histogram in metrics snapshot.
+ 
+ @return Histogram values in microseconds.
+ */
+- (NSDictionary *)latencyWithName:(NSString *)name;
+
+/**
+ @brief  Wait for specified amount of time while main queue is running.
+ 
+ @param delay Number of seconds which should pass before method return.
+ */
+- (void)waitFor:(NSTimeInterval)delay;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPMetricsTests
+
+
+#pragma mark - Configuration
+
+- (void)setUp {
+    
+    [super setUp];
+    
+    self.metrics = [SPNPMetrics metrics];
+    NSString *name = [[NSUUID UUID].UUIDString stringByAppendingPathExtension:@"ndjson"];
+    self.path = [NSTemporaryDirectory() stringByAppendingPathComponent:name];
+}
+
+- (void)tearDown {
+    
+    [self.metrics stopDumping];
+    [[NSFileManager defaultManager] removeItemAtPath:self.path error:nil];
+    
+    [super tearDown];
+}
+
+
+#pragma mark - Counters
+
+- (void)testCountersIncremented {
+    
+    [self.metrics incrementCounter:SPNPReceivedMessagesCounter by:1];
+    [self.metrics incrementCounter:SPNPReceivedMessagesCounter by:2];
+    [self.metrics incrementCounter:SPNPObserverNotificationsCounter by:1];
+    [self.metrics incrementCounter:SPNPMetricsCountersCount by:1];
+    
+    NSDictionary *counters = self.metrics.snapshot[@"counters"];
+    XCTAssertEqual(counters.count, SPNPMetricsCountersCount);
+    XCTAssertEqualObjects(counters[@"receivedMessages"], @3);
+    XCTAssertEqualObjects(counters[@"observerNotifications"], @1);
+    XCTAssertEqualObjects(counters[@"countedVotes"], @0);
+}
+
+- (void)testResetZeroMetrics {
+    
+    [self.metrics incrementCounter:SPNPCountedVotesCounter by:5];
+    [self.metrics recordLatency:SPNPMessageDecodeLatency withDuration:0.001f];
+    [self.metrics reset];
+    
+    XCTAssertEqualObjects(self.metrics.snapshot[@"counters"][@"countedVotes"], @0);
+    XCTAssertEqualObjects([self latencyWithName:@"messageDecode"][@"count"], @0);
+    XCTAssertEqualObjects([self latencyWithName:@"messageDecode"][@"max"], @0);
+}
+
+
+#pragma mark - Latencies
+
+- (void)testLatencyHistogramSummary {
+    
+    for (NSUInteger sampleIdx = 0; sampleIdx < 100; sampleIdx++) {
+        
+        NSTimeInterval duration = (sampleIdx < 90 ? 0.000001f : 0.001f);
+        [self.metrics recordLatency:SPNPStatisticPublishLatency withDuration:duration];
+    }
+    [self.metrics recordLatency:SPNPMetricsLatenciesCount withDuration:1.0f];
+    
+    // Percentiles reported as upper bound of histogram bucket (1024 ns for 1 us samples).
+    NSDictionary *latency = [self latencyWithName:@"statisticPublish"];
+    XCTAssertEqualObjects(latency[@"count"], @100);
+    XCTAssertEqualWithAccuracy([latency[@"mean"] doubleValue], 100.9f, 0.01f);
+    XCTAssertEqualWithAccuracy([latency[@"p50"] doubleValue], 1.024f, 0.001f);
+    XCTAssertEqualWithAccuracy([latency[@"p90"] doubleValue], 1.024f, 0.001f);
+    XCTAssertEqualWithAccuracy([latency[@"p99"] doubleValue], 1000.0f, 0.01f);
+    XCTAssertEqualWithAccuracy([latency[@"max"] doubleValue], 1000.0f, 0.01f);
+    XCTAssertEqualObjects([self latencyWithName:@"messageDecode"][@"count"], @0);
+}
+
+- (void)testLatencyMeasuredSinceStartTime {
+    
+    uint64_t startTime = [SPNPMetrics currentTime];
+    [self waitFor:0.01f];
+    [self.metrics recordLatency:SPNPHistoryRestoreLatency since:startTime];
+    
+    NSDictionary *latency = [self latencyWithName:@"historyRestore"];
+    XCTAssertEqualObjects(latency[@"count"], @1);
+    XCTAssertGreaterThanOrEqual([latency[@"max"] doubleValue], 10000.0f);
+}
+
+
+#pragma mark - Concurrency
+
+- (void)testConcurrentRecordingCountedExactly {
+    
+    SPNPMetrics *metrics = self.metrics;
+    dispatch_apply(8, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t writerIdx) {
+        
+        for (NSUInteger eventIdx = 0; eventIdx < 100000; eventIdx++) {
+            
+            [metrics incrementCounter:SPNPCountedVotesCounter by:1];
+            [metrics recordLatency:SPNPVotesAggregationLatency
+                      withDuration:(0.000001f * (writerIdx + 1))];
+        }
+    });
+    
+    NSDictionary *latency = [self latencyWithName:@"votesAggregation"];
+    XCTAssertEqualObjects(self.metrics.snapshot[@"counters"][@"countedVotes"], @800000);
+    XCTAssertEqualObjects(latency[@"count"], @800000);
+    XCTAssertEqualWithAccuracy([latency[@"max"] doubleValue], 8.0f, 0.01f);
+}
+
+
+#pragma mark - Dump
+
+- (void)testSnapshotsDumpedAsJSONLines {
+    
+    [self.metrics incrementCounter:SPNPPublishedStatisticsCounter by:1];
+    [self.metrics startDumpingToFileAtPath:self.path withInterval:0.05f];
+    [self waitFor:0.3f];
+    [self.metrics stopDumping];
+    [self waitFor:0.1f];
+    
+    NSString *dump = [NSString stringWithContentsOfFile:self.path encoding:NSUTF8StringEncoding
+                                                  error:nil];
+    NSArray *lines = [[dump stringByTrimmingCharactersInSet:[NSCharacterSet newlineCharacterSet]]
+                      componentsSeparatedByString:@"\n"];
+    XCTAssertGreaterThan(lines.count, 2);
+    for (NSString *line in lines) {
+        
+        NSDictionary *snapshot = [NSJSONSerialization
+                                  JSONObjectWithData:[line dataUsingEncoding:NSUTF8StringEncoding]
+                                             options:0 error:nil];
+        XCTAssertEqualObjects(snapshot[@"counters"][@"publishedStatistics"], @1);
+        XCTAssertNotNil(snapshot[@"latencies"][@"observerNotification"]);
+    }
+}
+
+
+#pragma mark - Performance
+
+- (void)testRecordingPerformance {
+    
+    [self measureBlock:^{
+        
+        for (NSUInteger eventIdx = 0; eventIdx < 1000000; eventIdx++) {
+            
+            uint64_t startTime = [SPNPMetrics currentTime];
+            [self.metrics incrementCounter:SPNPReceivedMessagesCounter by:1];
+            [self.metrics recordLatency:SPNPMessageDecodeLatency since:startTime];
+        }
+    }];
+}
+
+
+#pragma mark - Misc
+
+- (NSDictionary *)latencyWithName:(NSString *)name {
+    
+    return self.metrics.snapshot[@"latencies"][name];
+}
+
+- (void)waitFor:(NSTimeInterval)delay {
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Delay"];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)),
+                   dispatch_get_main_queue(), ^{
+        
+        [expectation fulfill];
+    });
+    [self waitForExpectationsWithTimeout:5.0f handler:nil];
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,223 @@
+/**
+ @brief      Tests for host polls registry and statistic channels resolution.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <XCTest/XCTest.h>
+#import "SPNPPollResponse.h"
+#import "SPNPPollRegistry.h"
+#import "SPNPPollSession.h"
+#import "SPNPPoll.h"
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores name of default statistic channel which is used in tests.
+ */
+static NSString * const kSPNPTestStatisticsChannel = @"host-stat";
+
+
+#pragma mark - Interface declaration
+
+@interface SPNPPollRegistryTests : XCTestCase
+
+
+#pragma mark - Properties
+
+@property (nonatomic, strong) SPNPPollRegistry *registry;
+@property (nonatomic, strong) SPNPPollSession *primarySession;
+@property (nonatomic, strong) SPNPPollSession *additionalSession;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Create session in the same way as host do for announced poll.
+ 
+ @param poll Reference on poll for which responses should be accepted.
+ 
+ @return Configured and ready to use poll session.
+ */
+- (SPNPPollSession *)sessionForPoll:(SPNPPoll *)poll;
+
+/**
+ @brief  Construct attendee's vote message.
+ 
+ @param poll      Reference on poll for which vote should be constructed.
+ @param isCompact Whether vote should be in compact representation or dictionary.
+ 
+ @return Attendee's vote message.
+ */
+- (id)voteForPoll:(SPNPPoll *)poll compact:(BOOL)isCompact;
+
+/**
+ @brief  Resolve statistic changes channel in the same way as attendee do for announced poll.
+ 
+ @param poll Reference on poll which has been announced by host.
+ 
+ @return Statistic changes channel name.
+ */
+- (NSString *)attendeeDeltasChannelForPoll:(SPNPPoll *)poll;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPPollRegistryTests
+
+
+#pragma mark - Configuration
+
+- (void)setUp {
+    
+    [super setUp];
+    
+    self.registry = [SPNPPollRegistry new];
+    SPNPPoll *primaryPoll = [SPNPPoll pollWithQuestion:@"Best talk?"
+                                             responses:@[@"First", @"Second"]];
+    SPNPPoll *additionalPoll = [SPNPPoll pollWithQuestion:@"Best speaker?"
+                                                responses:@[@"First", @"Second"]];
+    NSString *channel = [kSPNPTestStatisticsChannel
+                         stringByAppendingFormat:@"-%@", additionalPoll.token];
+    additionalPoll = [additionalPoll pollWithStatisticsChannel:channel];
+    self.primarySession = [self sessionForPoll:primaryPoll];
+    self.additionalSession = [self sessionForPoll:additionalPoll];
+    [self.registry registerSession:self.primarySession];
+    [self.registry registerSession:self.additionalSession];
+}
+
+
+#pragma mark - Routing
+
+- (void)testResponsesRoutedToOwnPollSession {
+    
+    SPNPPoll *primaryPoll = self.primarySession.poll;
+    SPNPPoll *additionalPoll = self.additionalSession.poll;
+    
+    XCTAssertEqual(self.registry.sessions.count, 2);
+    XCTAssertEqual([self.registry sessionForResponseMessage:[self voteForPoll:primaryPoll
+                                                                      compact:YES]],
+                   self.primarySession);
+    XCTAssertEqual([self.registry sessionForResponseMessage:[self voteForPoll:primaryPoll
+                                                                      compact:NO]],
+                   self.primarySession);
+    XCTAssertEqual([self.registry sessionForResponseMessage:[self voteForPoll:additionalPoll
+                                                                      compact:YES]],
+                   self.additionalSession);
+    XCTAssertEqual([self.registry sessionForResponseMessage:[self voteForPoll:additionalPoll
+                                                                      compact:NO]],
+                   self.additionalSession);
+    XCTAssertEqual([self.registry sessionForPollIdentifier:additionalPoll.identifier],
+                   self.additionalSession);
+    XCTAssertTrue([self.registry hasSessionWithToken:primaryPoll.token]);
+}
+
+- (void)testResponsesForUnknownPollsDropped {
+    
+    SPNPPoll *unknownPoll = [SPNPPoll pollWithQuestion:@"Unknown" responses:@[@"First"]];
+    
+    XCTAssertNil([self.registry sessionForResponseMessage:[self voteForPoll:unknownPoll
+                                                                    compact:YES]]);
+    XCTAssertNil([self.registry sessionForResponseMessage:[self voteForPoll:unknownPoll
+                                                                    compact:NO]]);
+    XCTAssertNil([self.registry sessionForResponseMessage:@"not base64!"]);
+    XCTAssertNil([self.registry sessionForResponseMessage:@{@"question": @"Best talk?"}]);
+    XCTAssertNil([self.registry sessionForPollIdentifier:nil]);
+    XCTAssertFalse([self.registry hasSessionWithToken:nil]);
+}
+
+- (void)testCompletedPollResponsesDropped {
+    
+    SPNPPoll *additionalPoll = self.additionalSession.poll;
+    [self.registry unregisterSessionForPoll:additionalPoll];
+    
+    XCTAssertEqual(self.registry.sessions.count, 1);
+    XCTAssertNil([self.registry sessionForResponseMessage:[self voteForPoll:additionalPoll
+                                                                    compact:YES]]);
+    XCTAssertNil([self.registry sessionForResponseMessage:[self voteForPoll:additionalPoll
+                                                                    compact:NO]]);
+    XCTAssertFalse([self.registry hasSessionWithToken:additionalPoll.token]);
+    SPNPPoll *primaryPoll = self.primarySession.poll;
+    XCTAssertEqual([self.registry sessionForResponseMessage:[self voteForPoll:primaryPoll
+                                                                      compact:YES]],
+                   self.primarySession);
+}
+
+- (void)testRegisteredSessionReplaced {
+    
+    SPNPPollSession *session = [self sessionForPoll:self.primarySession.poll];
+    [self.registry registerSession:session];
+    
+    XCTAssertEqual(self.registry.sessions.count, 2);
+    XCTAssertEqual([self.registry sessionForResponseMessage:[self voteForPoll:session.poll
+                                                                      compact:YES]], session);
+}
+
+
+#pragma mark - Statistic channels
+
+- (void)testAttendeeSubscribeToSessionStatisticChannel {
+    
+    XCTAssertEqualObjects(self.primarySession.statisticsChannelName, kSPNPTestStatisticsChannel);
+    XCTAssertNotEqualObjects(self.additionalSession.statisticDeltasChannelName,
+                             self.primarySession.statisticDeltasChannelName);
+    XCTAssertEqualObjects([self attendeeDeltasChannelForPoll:self.primarySession.poll],
+                          self.primarySession.statisticDeltasChannelName);
+    XCTAssertEqualObjects([self attendeeDeltasChannelForPoll:self.additionalSession.poll],
+                          self.additionalSession.statisticDeltasChannelName);
+}
+
+- (void)testAnnouncedStatisticChannelRestored {
+    
+    SPNPPoll *poll = self.additionalSession.poll;
+    NSString *representation = [poll compactRepresentationForPoll:poll.identifier token:poll.token];
+    SPNPPoll *restoredPoll = [SPNPPoll objectFromCompactRepresentation:representation
+                                                               forPoll:poll.identifier
+                                                                 token:poll.token];
+    
+    XCTAssertEqualObjects(restoredPoll.statisticsChannel,
+                          self.additionalSession.statisticsChannelName);
+    XCTAssertFalse(restoredPoll.isRating);
+    XCTAssertNil(restoredPoll.minimumRating);
+    XCTAssertNil([[self.primarySession.poll completedPoll] statisticsChannel]);
+}
+
+
+#pragma mark - Misc
+
+- (SPNPPollSession *)sessionForPoll:(SPNPPoll *)poll {
+    
+    return [SPNPPollSession sessionForPoll:poll withStatistics:[NSMutableArray new]
+                            voteAggregator:nil statisticsChannel:kSPNPTestStatisticsChannel];
+}
+
+- (id)voteForPoll:(SPNPPoll *)poll compact:(BOOL)isCompact {
+    
+    SPNPPollResponse *response = [SPNPPollResponse pollResponseFor:poll.identifier withValue:@""
+                                                       orderNumber:@0];
+    
+    return (isCompact ? [response compactRepresentationForPoll:poll.identifier token:poll.token]
+                      : [response dictionaryRepresentation]);
+}
+
+- (NSString *)attendeeDeltasChannelForPoll:(SPNPPoll *)poll {
+    
+    // Attendee receive poll from announcement.
+    SPNPPoll *announcedPoll = [SPNPPoll objectFromDictionaryRepresentation:
+                               [poll dictionaryRepresentation]];
+    NSString *channel = [SPNPPollSession statisticsChannelForPoll:announcedPoll
+                                                   defaultChannel:kSPNPTestStatisticsChannel];
+    
+    return [SPNPPollSession deltasChannelFor:channel];
+}
+
+#pragma mark -
+
+
+@end
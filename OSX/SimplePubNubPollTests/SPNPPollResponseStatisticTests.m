@@ -0,0 +1,331 @@
+/**
+ @brief      Tests for host nodes votes counters merge.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <XCTest/XCTest.h>
+#import "SPNPPollResponseStatistic.h"
+#import "SPNPPollStatistic.h"
+#import "SPNPPollResponse.h"
+#import "SPNPPoll.h"
+
+
+#pragma mark Interface declaration
+
+@interface SPNPPollResponseStatisticTests : XCTestCase
+
+
+#pragma mark - Properties
+
+@property (nonatomic, strong) SPNPPoll *poll;
+
+
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Construct statistic for poll response with votes counted by host nodes.
+ 
+ @param order      Order number of poll response for which statistic should be created.
+ @param votesCount Dictionary with number of votes counted by each host node.
+ 
+ @return Configured and ready to use response statistic instance.
+ */
+- (SPNPPollResponseStatistic *)statisticForResponse:(NSUInteger)order
+                                     withVotesCount:(NSDictionary *)votesCount;
+
+/**
+ @brief  Simulate host nodes which count votes and publish their counters after each round.
+ 
+ @param nodesCount  Number of host nodes which count votes.
+ @param roundsCount Number of times which each node update and publish it's votes count.
+ @param votesCount  Reference on pointer which will store overall votes count after last round.
+ 
+ @return List of node counters which has been published by nodes (in order of publishing).
+ */
+- (NSArray *)publishedCountersOfNodes:(NSUInteger)nodesCount rounds:(NSUInteger)roundsCount
+                           votesCount:(unsigned long long *)votesCount;
+
+/**
+ @brief  Shuffle list of objects.
+ 
+ @param array Reference on list which should be shuffled.
+ 
+ @return Shuffled copy of \c array.
+ */
+- (NSArray *)shuffledArray:(NSArray *)array;
+
+/**
+ @brief  Measure time which is required to merge counters published by host nodes.
+ 
+ @param nodesCount Number of host nodes which publish counters.
+ */
+- (void)measureMergeOfNodesCounters:(NSUInteger)nodesCount;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPPollResponseStatisticTests
+
+
+#pragma mark - Configuration
+
+- (void)setUp {
+    
+    [super setUp];
+    
+    self.poll = [SPNPPoll pollWithQuestion:@"Best talk?" responses:@[@"First", @"Second"]
+                              answerShards:4];
+}
+
+
+#pragma mark - Node counters
+
+- (void)testNodeVotesCountStoredAsGrowOnlyCounters {
+    
+    SPNPPollResponseStatistic *statistic = [self statisticForResponse:0
+                                                       withVotesCount:@{@"node-a": @5}];
+    [statistic updateVotesCount:3 forNode:@"node-a"];
+    [statistic updateVotesCount:4 forNode:@"node-b"];
+    
+    XCTAssertEqualObjects(statistic.nodeCounters[@"node-a"], (@[@5, @2]));
+    XCTAssertEqualObjects(statistic.nodeCounters[@"node-b"], (@[@4, @0]));
+    XCTAssertEqual([statistic votesCountForNode:@"node-a"], 3);
+    XCTAssertEqual([statistic votesCountForNode:@"node-c"], 0);
+    XCTAssertEqualObjects(statistic.votesCount, @7);
+}
+
+- (void)testMergeIdempotentAndCommutative {
+    
+    SPNPPollResponseStatistic *first = [self statisticForResponse:0
+                                                   withVotesCount:@{@"node-a": @3}];
+    SPNPPollResponseStatistic *second = [self statisticForResponse:0
+                                                    withVotesCount:@{@"node-b": @4}];
+    [second updateVotesCount:2 forNode:@"node-b"];
+    
+    XCTAssertTrue([first mergeNodeCounters:second.nodeCounters preservingNode:nil]);
+    XCTAssertFalse([first mergeNodeCounters:second.nodeCounters preservingNode:nil]);
+    XCTAssertEqualObjects(first.votesCount, @5);
+    
+    XCTAssertTrue([second mergeNodeCounters:first.nodeCounters preservingNode:nil]);
+    XCTAssertEqualObjects(second.nodeCounters, first.nodeCounters);
+    XCTAssertEqualObjects(second.votesCount, @5);
+}
+
+- (void)testStaleCountersDoesntChangeVotesCount {
+    
+    SPNPPollResponseStatistic *statistic = [self statisticForResponse:0
+                                                       withVotesCount:@{@"node-a": @5}];
+    [statistic updateVotesCount:3 forNode:@"node-a"];
+    
+    XCTAssertFalse([statistic mergeNodeCounters:@{@"node-a": @[@4, @0]} preservingNode:nil]);
+    XCTAssertFalse([statistic mergeNodeCounters:@{@"node-a": @[@5]} preservingNode:nil]);
+    XCTAssertEqualObjects(statistic.nodeCounters[@"node-a"], (@[@5, @2]));
+    XCTAssertEqualObjects(statistic.votesCount, @3);
+}
+
+- (void)testMergePreserveOwnNodeVotesCount {
+    
+    // Counters published by previous node's run can be higher than votes count restored from log.
+    SPNPPollResponseStatistic *statistic = [self statisticForResponse:0
+                                                       withVotesCount:@{@"node-a": @2}];
+    NSDictionary *publishedCounters = @{@"node-a": @[@5, @1], @"node-b": @[@3, @0]};
+    XCTAssertTrue([statistic mergeNodeCounters:publishedCounters preservingNode:@"node-a"]);
+    
+    XCTAssertEqual([statistic votesCountForNode:@"node-a"], 2);
+    XCTAssertEqual([statistic votesCountForNode:@"node-b"], 3);
+    XCTAssertEqualObjects(statistic.nodeCounters[@"node-a"], (@[@5, @3]));
+    XCTAssertEqualObjects(statistic.votesCount, @5);
+}
+
+
+#pragma mark - Convergence
+
+- (void)testNodesCountersConvergeInAnyMergeOrder {
+    
+    unsigned long long votesCount = 0;
+    NSArray *publishedCounters = [self publishedCountersOfNodes:16 rounds:5 votesCount:&votesCount];
+    NSMutableArray *replicas = [NSMutableArray new];
+    for (NSUInteger replicaIdx = 0; replicaIdx < 8; replicaIdx++) {
+        
+        // Replicas receive counters in different order, stale counters after newer ones and some
+        // of them more than once.
+        SPNPPollResponseStatistic *replica = [self statisticForResponse:0 withVotesCount:nil];
+        NSRange duplicatesRange = NSMakeRange(0, replicaIdx * 4);
+        NSArray *deliveries = [publishedCounters arrayByAddingObjectsFromArray:
+                               [publishedCounters subarrayWithRange:duplicatesRange]];
+        for (NSDictionary *nodeCounters in [self shuffledArray:deliveries]) {
+            
+            [replica mergeNodeCounters:nodeCounters preservingNode:nil];
+        }
+        [replicas addObject:replica];
+    }
+    
+    // Unlike unique attendees estimation, merged votes count is exact.
+    SPNPPollResponseStatistic *firstReplica = replicas.firstObject;
+    XCTAssertEqualObjects(firstReplica.votesCount, @(votesCount));
+    XCTAssertEqual(firstReplica.nodeCounters.count, 16);
+    for (SPNPPollResponseStatistic *replica in replicas) {
+        
+        XCTAssertEqualObjects(replica.nodeCounters, firstReplica.nodeCounters);
+        XCTAssertEqualObjects(replica.votesCount, @(votesCount));
+    }
+}
+
+- (void)testPartiallyMergedReplicasConverge {
+    
+    unsigned long long votesCount = 0;
+    NSArray *publishedCounters = [self publishedCountersOfNodes:8 rounds:4 votesCount:&votesCount];
+    NSUInteger half = (publishedCounters.count / 2);
+    SPNPPollResponseStatistic *first = [self statisticForResponse:0 withVotesCount:nil];
+    SPNPPollResponseStatistic *second = [self statisticForResponse:0 withVotesCount:nil];
+    for (NSDictionary *nodeCounters in [publishedCounters subarrayWithRange:NSMakeRange(0, half)]) {
+        
+        [first mergeNodeCounters:nodeCounters preservingNode:nil];
+    }
+    for (NSDictionary *nodeCounters in [publishedCounters subarrayWithRange:
+                                        NSMakeRange(half, publishedCounters.count - half)]) {
+        
+        [second mergeNodeCounters:nodeCounters preservingNode:nil];
+    }
+    
+    // Replicas which has seen different updates converge after exchanging their counters.
+    [first mergeNodeCounters:second.nodeCounters preservingNode:nil];
+    [second mergeNodeCounters:first.nodeCounters preservingNode:nil];
+    
+    XCTAssertEqualObjects(first.nodeCounters, second.nodeCounters);
+    XCTAssertEqualObjects(first.votesCount, @(votesCount));
+    XCTAssertEqualObjects(second.votesCount, @(votesCount));
+}
+
+
+#pragma mark - Compact representation
+
+- (void)testNodeCountersCompactRoundTrip {
+    
+    NSArray *responses = @[[self statisticForResponse:0 withVotesCount:@{@"node-a": @2,
+                                                                          @"node-b": @1}],
+                           [self statisticForResponse:1 withVotesCount:@{@"node-a": @4}]];
+    [responses.lastObject updateVotesCount:3 forNode:@"node-a"];
+    SPNPPollStatistic *statistic = [SPNPPollStatistic statisticForPoll:self.poll
+                                                         withResponses:responses sequence:@1];
+    XCTAssertTrue(statistic.isMergeable);
+    
+    NSString *representation = [statistic compactRepresentationForPoll:self.poll.identifier
+                                                                  token:self.poll.token];
+    SPNPPollStatistic *restoredStatistic =
+        [SPNPPollStatistic objectFromCompactRepresentation:representation
+                                                   forPoll:self.poll.identifier
+                                                     token:self.poll.token];
+    XCTAssertTrue(restoredStatistic.isMergeable);
+    XCTAssertEqualObjects(restoredStatistic.sequence, @1);
+    SPNPPollResponseStatistic *first = restoredStatistic.responses.firstObject;
+    SPNPPollResponseStatistic *second = restoredStatistic.responses.lastObject;
+    XCTAssertEqualObjects(first.nodeCounters, [responses.firstObject nodeCounters]);
+    XCTAssertEqualObjects(first.votesCount, @3);
+    XCTAssertEqualObjects(second.nodeCounters[@"node-a"], (@[@4, @1]));
+    XCTAssertEqualObjects(second.votesCount, @3);
+}
+
+
+#pragma mark - Performance
+
+- (void)testMergeEightNodesCountersPerformance {
+    
+    [self measureMergeOfNodesCounters:8];
+}
+
+- (void)testMergeSixtyFourNodesCountersPerformance {
+    
+    [self measureMergeOfNodesCounters:64];
+}
+
+
+#pragma mark - Misc
+
+- (SPNPPollResponseStatistic *)statisticForResponse:(NSUInteger)order
+                                     withVotesCount:(NSDictionary *)votesCount {
+    
+    SPNPPollResponseStatistic *statistic =
+        [SPNPPollResponseStatistic statisticForResponse:self.poll.responses[order]];
+    [votesCount enumerateKeysAndObjectsUsingBlock:^(NSString *node, NSNumber *nodeVotesCount,
+                                                    BOOL *votesCountEnumeratorStop) {
+        
+        [statistic updateVotesCount:nodeVotesCount.unsignedLongLongValue forNode:node];
+    }];
+    
+    return statistic;
+}
+
+- (NSArray *)publishedCountersOfNodes:(NSUInteger)nodesCount rounds:(NSUInteger)roundsCount
+                           votesCount:(unsigned long long *)votesCount {
+    
+    NSMutableArray *publishedCounters = [NSMutableArray new];
+    NSMutableArray *nodes = [NSMutableArray new];
+    for (NSUInteger nodeIdx = 0; nodeIdx < nodesCount; nodeIdx++) {
+        
+        [nodes addObject:[self statisticForResponse:0 withVotesCount:nil]];
+    }
+    
+    // Node's votes count can decrease between rounds (votes changed to other response).
+    for (NSUInteger roundIdx = 0; roundIdx < roundsCount; roundIdx++) {
+        
+        *votesCount = 0;
+        [nodes enumerateObjectsUsingBlock:^(SPNPPollResponseStatistic *statistic,
+                                            NSUInteger nodeIdx, BOOL *nodesEnumeratorStop) {
+            
+            unsigned long long nodeVotesCount = arc4random_uniform(1000);
+            [statistic updateVotesCount:nodeVotesCount
+                                forNode:[NSString stringWithFormat:@"node-%@", @(nodeIdx)]];
+            [publishedCounters addObject:[[NSDictionary alloc]
+                                          initWithDictionary:statistic.nodeCounters
+                                                   copyItems:YES]];
+            *votesCount += nodeVotesCount;
+        }];
+    }
+    
+    return [publishedCounters copy];
+}
+
+- (NSArray *)shuffledArray:(NSArray *)array {
+    
+    NSMutableArray *shuffledArray = [array mutableCopy];
+    for (NSUInteger objectIdx = shuffledArray.count; objectIdx > 1; objectIdx--) {
+        
+        [shuffledArray exchangeObjectAtIndex:(objectIdx - 1)
+                           withObjectAtIndex:arc4random_uniform((uint32_t)objectIdx)];
+    }
+    
+    return [shuffledArray copy];
+}
+
+- (void)measureMergeOfNodesCounters:(NSUInteger)nodesCount {
+    
+    unsigned long long votesCount = 0;
+    NSArray *publishedCounters = [self publishedCountersOfNodes:nodesCount rounds:1
+                                                     votesCount:&votesCount];
+    [self measureBlock:^{
+        
+        for (NSUInteger mergeIdx = 0; mergeIdx < 100; mergeIdx++) {
+            
+            SPNPPollResponseStatistic *replica = [self statisticForResponse:0 withVotesCount:nil];
+            for (NSDictionary *nodeCounters in publishedCounters) {
+                
+                [replica mergeNodeCounters:nodeCounters preservingNode:nil];
+            }
+            XCTAssertEqualObjects(replica.votesCount, @(votesCount));
+        }
+    }];
+}
+
+#pragma mark -
+
+
+@end
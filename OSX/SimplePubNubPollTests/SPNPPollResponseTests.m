@@ -0,0 +1,278 @@
+/**
+ @brief      Tests for attendee's vote fields projection from received messages.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <XCTest/XCTest.h>
+#import "SPNPPollResponse.h"
+#import "SPNPCompactCoder.h"
+#import "SPNPVoterIndex.h"
+#import "SPNPPoll.h"
+
+
+#pragma mark Interface declaration
+
+@interface SPNPPollResponseTests : XCTestCase
+
+
+#pragma mark - Properties
+
+@property (nonatomic, strong) SPNPPoll *poll;
+@property (nonatomic, strong) SPNPCompactCoder *decoder;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Construct attendees' vote messages for tested poll.
+ 
+ @param count     Number of messages which should be constructed.
+ @param isCompact Whether messages should be in compact representation or dictionary.
+ 
+ @return List of vote messages from different voters.
+ */
+- (NSArray *)votesCount:(NSUInteger)count compact:(BOOL)isCompact;
+
+/**
+ @brief  Measure time which is required to read vote fields using projection.
+ 
+ @param isCompact Whether messages should be in compact representation or dictionary.
+ */
+- (void)measureVotesProjectionCompact:(BOOL)isCompact;
+
+/**
+ @brief  Measure time which is required to read vote fields from deserialized response models.
+ 
+ @param isCompact Whether messages should be in compact representation or dictionary.
+ */
+- (void)measureVotesDeserializationCompact:(BOOL)isCompact;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPPollResponseTests
+
+
+#pragma mark - Configuration
+
+- (void)setUp {
+    
+    [super setUp];
+    
+    self.poll = [SPNPPoll pollWithQuestion:@"Best talk?" responses:@[@"First", @"Second"]];
+    self.decoder = [SPNPCompactCoder reusableDecoderForPoll:self.poll.identifier
+                                                      token:self.poll.token];
+}
+
+
+#pragma mark - Projection
+
+- (void)testCompactVoteFieldsProjected {
+    
+    NSString *voter = [NSUUID UUID].UUIDString;
+    SPNPPollResponse *response = [SPNPPollResponse pollResponseFor:self.poll.identifier
+                                                         withValue:@"Second" orderNumber:@1
+                                                             voter:voter traceTime:@1450000000000];
+    NSString *message = [response compactRepresentationForPoll:self.poll.identifier
+                                                          token:self.poll.token];
+    NSUInteger order = NSNotFound;
+    uint64_t voterKey = 0;
+    uint64_t traceTime = 0;
+    XCTAssertTrue([SPNPPollResponse readVoteFromMessage:message forPoll:self.poll.identifier
+                                           usingDecoder:self.decoder order:&order
+                                               voterKey:&voterKey traceTime:&traceTime]);
+    XCTAssertEqual(order, 1);
+    XCTAssertEqual(voterKey, [SPNPVoterIndex keyForVoter:voter]);
+    XCTAssertEqual(traceTime, 1450000000000);
+}
+
+- (void)testDictionaryVoteFieldsProjected {
+    
+    SPNPPollResponse *response = [SPNPPollResponse pollResponseFor:self.poll.identifier
+                                                         withValue:@"First" orderNumber:@0
+                                                             voter:@"attendee" traceTime:@42];
+    NSUInteger order = NSNotFound;
+    uint64_t voterKey = 0;
+    uint64_t traceTime = 0;
+    XCTAssertTrue([SPNPPollResponse readVoteFromMessage:[response dictionaryRepresentation]
+                                                forPoll:self.poll.identifier
+                                           usingDecoder:self.decoder order:&order
+                                               voterKey:&voterKey traceTime:&traceTime]);
+    XCTAssertEqual(order, 0);
+    XCTAssertEqual(voterKey, [SPNPVoterIndex keyForVoter:@"attendee"]);
+    XCTAssertEqual(traceTime, 42);
+}
+
+- (void)testVoteWithoutVoterProjectedWithEmptyKey {
+    
+    SPNPPollResponse *response = [SPNPPollResponse pollResponseFor:self.poll.identifier
+                                                         withValue:@"Second" orderNumber:@1];
+    NSString *message = [response compactRepresentationForPoll:self.poll.identifier
+                                                          token:self.poll.token];
+    NSUInteger order = NSNotFound;
+    uint64_t voterKey = 1;
+    XCTAssertTrue([SPNPPollResponse readVoteFromMessage:message forPoll:self.poll.identifier
+                                           usingDecoder:self.decoder order:&order
+                                               voterKey:&voterKey]);
+    XCTAssertEqual(order, 1);
+    XCTAssertEqual(voterKey, 0);
+}
+
+- (void)testDecoderReusedForSequentialMessages {
+    
+    for (NSUInteger voterIdx = 0; voterIdx < 100; voterIdx++) {
+        
+        NSString *voter = [NSString stringWithFormat:@"voter-%@", @(voterIdx)];
+        SPNPPollResponse *response = [SPNPPollResponse pollResponseFor:self.poll.identifier
+                                                             withValue:@""
+                                                           orderNumber:@(voterIdx % 2)
+                                                                 voter:voter];
+        NSString *message = [response compactRepresentationForPoll:self.poll.identifier
+                                                              token:self.poll.token];
+        NSUInteger order = NSNotFound;
+        uint64_t voterKey = 0;
+        XCTAssertTrue([SPNPPollResponse readVoteFromMessage:message forPoll:self.poll.identifier
+                                               usingDecoder:self.decoder order:&order
+                                                   voterKey:&voterKey]);
+        XCTAssertEqual(order, (voterIdx % 2));
+        XCTAssertEqual(voterKey, [SPNPVoterIndex keyForVoter:voter]);
+    }
+}
+
+
+#pragma mark - Rejection
+
+- (void)testVoteForOtherPollRejected {
+    
+    SPNPPoll *otherPoll = [SPNPPoll pollWithQuestion:@"Other" responses:@[@"First", @"Second"]];
+    SPNPPollResponse *response = [SPNPPollResponse pollResponseFor:otherPoll.identifier
+                                                         withValue:@"First" orderNumber:@0
+                                                             voter:@"attendee"];
+    NSString *compactMessage = [response compactRepresentationForPoll:otherPoll.identifier
+                                                                 token:otherPoll.token];
+    NSUInteger order = NSNotFound;
+    XCTAssertFalse([SPNPPollResponse readVoteFromMessage:compactMessage
+                                                 forPoll:self.poll.identifier
+                                            usingDecoder:self.decoder order:&order
+                                                voterKey:NULL]);
+    XCTAssertFalse([SPNPPollResponse readVoteFromMessage:[response dictionaryRepresentation]
+                                                 forPoll:self.poll.identifier
+                                            usingDecoder:self.decoder order:&order
+                                                voterKey:NULL]);
+    XCTAssertFalse([SPNPPollResponse readVoteFromMessage:[self.poll dictionaryRepresentation]
+                                                 forPoll:self.poll.identifier
+                                            usingDecoder:self.decoder order:&order
+                                                voterKey:NULL]);
+    XCTAssertFalse([SPNPPollResponse readVoteFromMessage:@"not base64!"
+                                                 forPoll:self.poll.identifier
+                                            usingDecoder:self.decoder order:&order
+                                                voterKey:NULL]);
+    XCTAssertEqual(order, NSNotFound);
+}
+
+
+#pragma mark - Performance
+
+- (void)testCompactVotesProjectionPerformance {
+    
+    [self measureVotesProjectionCompact:YES];
+}
+
+- (void)testCompactVotesDeserializationPerformance {
+    
+    [self measureVotesDeserializationCompact:YES];
+}
+
+- (void)testDictionaryVotesProjectionPerformance {
+    
+    [self measureVotesProjectionCompact:NO];
+}
+
+- (void)testDictionaryVotesDeserializationPerformance {
+    
+    [self measureVotesDeserializationCompact:NO];
+}
+
+
+#pragma mark - Misc
+
+- (NSArray *)votesCount:(NSUInteger)count compact:(BOOL)isCompact {
+    
+    NSMutableArray *votes = [NSMutableArray new];
+    for (NSUInteger voteIdx = 0; voteIdx < count; voteIdx++) {
+        
+        NSUInteger order = (voteIdx % self.poll.responses.count);
+        NSString *value = [self.poll.responses[order] response];
+        SPNPPollResponse *response = [SPNPPollResponse pollResponseFor:self.poll.identifier
+                                                             withValue:value
+                                                           orderNumber:@(order)
+                                                                 voter:[NSUUID UUID].UUIDString];
+        [votes addObject:(isCompact ? [response compactRepresentationForPoll:self.poll.identifier
+                                                                        token:self.poll.token]
+                                    : [response dictionaryRepresentation])];
+    }
+    
+    return [votes copy];
+}
+
+- (void)measureVotesProjectionCompact:(BOOL)isCompact {
+    
+    NSArray *votes = [self votesCount:20000 compact:isCompact];
+    [self measureBlock:^{
+        
+        NSUInteger countedVotes = 0;
+        for (id vote in votes) {
+            
+            NSUInteger order = NSNotFound;
+            uint64_t voterKey = 0;
+            if ([SPNPPollResponse readVoteFromMessage:vote forPoll:self.poll.identifier
+                                         usingDecoder:self.decoder order:&order
+                                             voterKey:&voterKey] && voterKey) {
+                
+                countedVotes++;
+            }
+        }
+        XCTAssertEqual(countedVotes, votes.count);
+    }];
+}
+
+- (void)measureVotesDeserializationCompact:(BOOL)isCompact {
+    
+    NSArray *votes = [self votesCount:20000 compact:isCompact];
+    NSString *pollIdentifier = self.poll.identifier;
+    [self measureBlock:^{
+        
+        NSUInteger countedVotes = 0;
+        for (id vote in votes) {
+            
+            @autoreleasepool {
+                
+                SPNPPollResponse *response = nil;
+                if (isCompact) {
+                    
+                    response = [SPNPPollResponse objectFromCompactRepresentation:vote
+                                                                         forPoll:pollIdentifier
+                                                                           token:self.poll.token];
+                }
+                else { response = [SPNPPollResponse objectFromDictionaryRepresentation:vote]; }
+                if ([response.pollIdentifier isEqualToString:pollIdentifier] &&
+                    response.order && [SPNPVoterIndex keyForVoter:response.voter]) {
+                    
+                    countedVotes++;
+                }
+            }
+        }
+        XCTAssertEqual(countedVotes, votes.count);
+    }];
+}
+
+#pragma mark -
+
+
+@end
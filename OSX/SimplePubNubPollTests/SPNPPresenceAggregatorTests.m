@@ -0,0 +1,187 @@
+/**
+ @brief      Tests for throttled presence events aggregation.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <XCTest/XCTest.h>
+#import "SPNPPresenceAggregator.h"
+
+
+#pragma mark Interface declaration
+
+@interface SPNPPresenceAggregatorTests : XCTestCase
+
+
+#pragma mark - Properties
+
+@property (nonatomic, strong) SPNPPresenceAggregator *aggregator;
+
+/**
+ @brief  Stores reference on list of updates passed to update block in 
+         "<occupancy>:<unique attendees>" format.
+ */
+@property (nonatomic, strong) NSMutableArray *updates;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Measure time which is required to handle simulated join / leave events.
+ 
+ @param eventsCount    Number of join / leave events which should be handled.
+ @param attendeesCount Number of attendees which is announced by single presence event (interval
+                       mode announce several attendees at once).
+ */
+- (void)measureHandlingOfEvents:(NSUInteger)eventsCount withAttendees:(NSUInteger)attendeesCount;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPPresenceAggregatorTests
+
+
+#pragma mark - Configuration
+
+- (void)setUp {
+    
+    [super setUp];
+    
+    NSMutableArray *updates = [NSMutableArray new];
+    self.updates = updates;
+    self.aggregator = [SPNPPresenceAggregator aggregatorWithUpdateBlock:^(NSUInteger occupancy,
+                                                                       unsigned long long count) {
+        
+        [updates addObject:[NSString stringWithFormat:@"%@:%@", @(occupancy), @(count)]];
+    }];
+    self.aggregator.updateInterval = 0.0f;
+    self.aggregator.ignoredIdentifier = @"host";
+}
+
+
+#pragma mark - Presence
+
+- (void)testUniqueAttendeesCountedOnce {
+    
+    [self.aggregator handleOccupancy:3 joined:@[@"host", @"first", @"second"] left:nil];
+    [self.aggregator handleOccupancy:2 joined:nil left:@[@"first"]];
+    [self.aggregator handleOccupancy:3 joined:@[@"first"] left:nil];
+    [self.aggregator handleOccupancy:3 joined:@[@"second"] left:nil];
+    
+    XCTAssertEqualObjects(self.updates, (@[@"3:2", @"2:2", @"3:2"]));
+    XCTAssertEqual(self.aggregator.occupancy, 3);
+    XCTAssertEqual(self.aggregator.uniqueAttendeesCount, 2);
+    XCTAssertEqual(self.aggregator.eventsCount, 4);
+    XCTAssertEqual(self.aggregator.updatesCount, 3);
+}
+
+- (void)testResetForgetUniqueAttendees {
+    
+    [self.aggregator handleOccupancy:2 joined:@[@"first", @"second"] left:nil];
+    [self.aggregator resetUniqueAttendees];
+    [self.aggregator handleOccupancy:3 joined:@[@"first", @"third"] left:nil];
+    
+    XCTAssertEqualObjects(self.updates, (@[@"2:2", @"2:0", @"3:2"]));
+}
+
+- (void)testUpdatesThrottledForInterval {
+    
+    self.aggregator.updateInterval = 0.2f;
+    [self.aggregator handleOccupancy:1 joined:@[@"first"] left:nil];
+    [self.aggregator handleOccupancy:2 joined:@[@"second"] left:nil];
+    [self.aggregator handleOccupancy:3 joined:@[@"third"] left:nil];
+    XCTAssertEqualObjects(self.updates, @[@"1:1"]);
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Throttled update"];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.4f * NSEC_PER_SEC)),
+                   dispatch_get_main_queue(), ^{
+        
+        [expectation fulfill];
+    });
+    [self waitForExpectationsWithTimeout:5.0f handler:nil];
+    
+    XCTAssertEqualObjects(self.updates, (@[@"1:1", @"3:3"]));
+    XCTAssertEqual(self.aggregator.updatesCount, 2);
+}
+
+- (void)testFlushDeliverPendingChanges {
+    
+    self.aggregator.updateInterval = 10.0f;
+    [self.aggregator handleOccupancy:1 joined:@[@"first"] left:nil];
+    [self.aggregator handleOccupancy:2 joined:@[@"second"] left:nil];
+    [self.aggregator flush];
+    [self.aggregator flush];
+    
+    XCTAssertEqualObjects(self.updates, (@[@"1:1", @"2:2"]));
+}
+
+
+#pragma mark - Performance
+
+- (void)testJoinLeaveEventsPerformance {
+    
+    [self measureHandlingOfEvents:100000 withAttendees:1];
+}
+
+- (void)testIntervalAnnouncementsPerformance {
+    
+    [self measureHandlingOfEvents:100000 withAttendees:20];
+}
+
+
+#pragma mark - Misc
+
+- (void)measureHandlingOfEvents:(NSUInteger)eventsCount withAttendees:(NSUInteger)attendeesCount {
+    
+    // Half of events announce new attendees and half announce leave of attendees which joined
+    // before, so occupancy stay small while number of unique attendees grow.
+    NSMutableArray *events = [NSMutableArray new];
+    for (NSUInteger eventIdx = 0; eventIdx < eventsCount; eventIdx++) {
+        
+        NSMutableArray *attendees = [NSMutableArray new];
+        for (NSUInteger attendeeIdx = 0; attendeeIdx < attendeesCount; attendeeIdx++) {
+            
+            NSUInteger attendee = ((eventIdx / 2) * attendeesCount + attendeeIdx);
+            [attendees addObject:[NSString stringWithFormat:@"attendee-%@", @(attendee)]];
+        }
+        [events addObject:attendees];
+    }
+    
+    [self measureBlock:^{
+        
+        __block NSUInteger updatesCount = 0;
+        SPNPPresenceAggregator *aggregator =
+            [SPNPPresenceAggregator aggregatorWithUpdateBlock:^(NSUInteger occupancy,
+                                                                unsigned long long count) {
+                
+                updatesCount++;
+            }];
+        aggregator.updateInterval = 10.0f;
+        [events enumerateObjectsUsingBlock:^(NSArray *attendees, NSUInteger eventIdx,
+                                             BOOL *eventsEnumeratorStop) {
+            
+            BOOL isJoin = (eventIdx % 2 == 0);
+            [aggregator handleOccupancy:(isJoin ? attendeesCount : 0)
+                                 joined:(isJoin ? attendees : nil)
+                                   left:(isJoin ? nil : attendees)];
+        }];
+        [aggregator flush];
+        
+        // Memory used to estimate unique attendees doesn't depend from their number.
+        double uniqueAttendeesCount = (double)(eventsCount / 2 * attendeesCount);
+        XCTAssertEqual(aggregator.eventsCount, eventsCount);
+        XCTAssertEqual(updatesCount, 2);
+        XCTAssertEqualWithAccuracy((double)aggregator.uniqueAttendeesCount, uniqueAttendeesCount,
+                                   uniqueAttendeesCount * 0.05);
+    }];
+}
+
+#pragma mark -
+
+
+@end
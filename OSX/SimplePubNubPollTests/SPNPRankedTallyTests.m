@@ -0,0 +1,333 @@
+/**
+ @brief      Tests for ranked-choice ballots tally and instant-runoff rounds.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <XCTest/XCTest.h>
+#import "SPNPRankedRoundStatistic.h"
+#import "SPNPPollRankedStatistic.h"
+#import "SPNPPollRankedResponse.h"
+#import "SPNPRankedTally.h"
+#import "SPNPPoll.h"
+
+
+#pragma mark Interface declaration
+
+@interface SPNPRankedTallyTests : XCTestCase
+
+
+#pragma mark - Properties
+
+@property (nonatomic, strong) SPNPPoll *poll;
+@property (nonatomic, strong) SPNPRankedTally *tally;
+
+/**
+ @brief  Stores number of ballots which has been cast by unique attendees.
+ */
+@property (nonatomic, assign) NSUInteger votersCount;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Count ballots with same ranking from unique attendees.
+ 
+ @param count   Number of ballots which should be cast.
+ @param ranking List of response order numbers (from most preferred).
+ */
+- (void)castBallots:(NSUInteger)count withRanking:(NSArray *)ranking;
+
+/**
+ @brief  Construct attendee's ballot message for tested poll.
+ 
+ @param ranking List of response order numbers (from most preferred).
+ 
+ @return Dictionary representation of attendee's ballot.
+ */
+- (NSDictionary *)ballotWithRanking:(NSArray *)ranking;
+
+/**
+ @brief  Represent runoff round standings as string.
+ 
+ @param round Reference on round statistic which should be represented.
+ 
+ @return Round standings in "<order>:<votes count>,..." format.
+ */
+- (NSString *)standingsOfRound:(SPNPRankedRoundStatistic *)round;
+
+/**
+ @brief  Construct attendee's ballot messages for all possible rankings of tested poll responses.
+ 
+ @return List of dictionary representations of attendee's ballots (15 different rankings).
+ */
+- (NSArray *)ballotsWithAllRankings;
+
+/**
+ @brief  Count ballots from unique attendees.
+ 
+ @param count   Number of ballots which should be cast.
+ @param ballots List of ballot messages which is cast one after another.
+ 
+ @return Number of ballots which has been accepted by tally.
+ */
+- (NSUInteger)castBallots:(NSUInteger)count from:(NSArray *)ballots;
+
+/**
+ @brief  Measure counting of new ballots by tally which already counted ballots.
+ 
+ @param count Number of ballots which has been counted before measurement.
+ */
+- (void)measureBallotsCountingAfter:(NSUInteger)count;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPRankedTallyTests
+
+
+#pragma mark - Configuration
+
+- (void)setUp {
+    
+    [super setUp];
+    
+    self.poll = [SPNPPoll rankedPollWithQuestion:@"Best talk?"
+                                       responses:@[@"First", @"Second", @"Third"]
+                                    answerShards:1];
+    self.tally = [SPNPRankedTally tallyForPoll:self.poll];
+}
+
+
+#pragma mark - Rounds
+
+- (void)testMajorityWinFirstRound {
+    
+    [self castBallots:3 withRanking:@[@0]];
+    [self castBallots:1 withRanking:@[@1, @0]];
+    [self castBallots:1 withRanking:@[@2]];
+    SPNPPollRankedStatistic *statistic = [self.tally statisticWithSequence:@1];
+    
+    XCTAssertEqualObjects(statistic.winner, @0);
+    XCTAssertEqualObjects(statistic.ballotsCount, @5);
+    XCTAssertEqualObjects(statistic.sequence, @1);
+    XCTAssertEqual(statistic.rounds.count, 1);
+    XCTAssertEqualObjects([self standingsOfRound:statistic.rounds.firstObject], @"0:3,1:1,2:1");
+}
+
+- (void)testEliminatedResponseBallotsTransferred {
+    
+    [self castBallots:4 withRanking:@[@0]];
+    [self castBallots:3 withRanking:@[@1, @2]];
+    [self castBallots:2 withRanking:@[@2, @1]];
+    SPNPPollRankedStatistic *statistic = [self.tally statisticWithSequence:@1];
+    
+    XCTAssertEqualObjects(statistic.winner, @1);
+    XCTAssertEqual(statistic.rounds.count, 2);
+    SPNPRankedRoundStatistic *firstRound = statistic.rounds.firstObject;
+    SPNPRankedRoundStatistic *lastRound = statistic.rounds.lastObject;
+    XCTAssertEqualObjects([self standingsOfRound:firstRound], @"0:4,1:3,2:2");
+    XCTAssertEqualObjects(firstRound.eliminated, @[@2]);
+    XCTAssertEqualObjects([self standingsOfRound:lastRound], @"0:4,1:5");
+    XCTAssertEqualObjects(lastRound.exhaustedCount, @0);
+}
+
+- (void)testExhaustedBallotsExcludedFromMajority {
+    
+    [self castBallots:3 withRanking:@[@0]];
+    [self castBallots:2 withRanking:@[@1]];
+    [self castBallots:1 withRanking:@[@2]];
+    SPNPPollRankedStatistic *statistic = [self.tally statisticWithSequence:@1];
+    
+    // Without exhausted ballot response wouldn't have majority (3 of 6).
+    XCTAssertEqualObjects(statistic.winner, @0);
+    XCTAssertEqual(statistic.rounds.count, 2);
+    XCTAssertEqualObjects([statistic.rounds.lastObject exhaustedCount], @1);
+    XCTAssertEqualObjects([self standingsOfRound:statistic.rounds.lastObject], @"0:3,1:2");
+}
+
+- (void)testEmptyTallyHasNoWinner {
+    
+    SPNPPollRankedStatistic *statistic = [self.tally statisticWithSequence:@1];
+    
+    XCTAssertNil(statistic.winner);
+    XCTAssertEqual(statistic.rounds.count, 0);
+    XCTAssertEqualObjects(statistic.ballotsCount, @0);
+}
+
+
+#pragma mark - Ballots
+
+- (void)testSameRankingsShareBucket {
+    
+    [self castBallots:3 withRanking:@[@0, @1]];
+    [self castBallots:2 withRanking:@[@0, @1, @0]];
+    [self castBallots:1 withRanking:@[@0, @2]];
+    
+    XCTAssertEqual(self.tally.ballotsCount, 6);
+    XCTAssertEqual(self.tally.bucketsCount, 2);
+    XCTAssertTrue([self.tally hasBallotsSinceLastCheck]);
+    XCTAssertFalse([self.tally hasBallotsSinceLastCheck]);
+}
+
+- (void)testInvalidBallotsDropped {
+    
+    SPNPPoll *otherPoll = [SPNPPoll rankedPollWithQuestion:@"Other" responses:@[@"A", @"B"]
+                                              answerShards:1];
+    SPNPPollRankedResponse *otherBallot =
+        [SPNPPollRankedResponse rankedResponseFor:otherPoll.identifier withRanking:@[@0]
+                                            voter:@"first"];
+    
+    XCTAssertFalse([self.tally registerBallotFromMessage:[otherBallot dictionaryRepresentation]
+                                               fromVoter:@"first"]);
+    XCTAssertFalse([self.tally registerBallotFromMessage:[self ballotWithRanking:@[@0, @5]]
+                                               fromVoter:@"second"]);
+    XCTAssertFalse([self.tally registerBallotFromMessage:[self ballotWithRanking:@[@0]]
+                                               fromVoter:nil]);
+    XCTAssertEqual(self.tally.droppedBallotsCount, 3);
+    XCTAssertEqual(self.tally.ballotsCount, 0);
+    XCTAssertFalse([self.tally hasBallotsSinceLastCheck]);
+}
+
+- (void)testRepeatedBallotDroppedByDefault {
+    
+    XCTAssertTrue([self.tally registerBallotFromMessage:[self ballotWithRanking:@[@0]]
+                                              fromVoter:@"first"]);
+    XCTAssertFalse([self.tally registerBallotFromMessage:[self ballotWithRanking:@[@1]]
+                                               fromVoter:@"first"]);
+    SPNPPollRankedStatistic *statistic = [self.tally statisticWithSequence:@1];
+    
+    XCTAssertEqualObjects(statistic.winner, @0);
+    XCTAssertEqualObjects(statistic.ballotsCount, @1);
+    XCTAssertEqual(self.tally.droppedBallotsCount, 1);
+}
+
+- (void)testChangedBallotReplacePrevious {
+    
+    self.tally.allowsBallotChange = YES;
+    [self castBallots:1 withRanking:@[@0]];
+    [self castBallots:1 withRanking:@[@1]];
+    [self.tally registerBallotFromMessage:[self ballotWithRanking:@[@1]] fromVoter:@"first"];
+    XCTAssertEqualObjects([self.tally statisticWithSequence:@1].winner, @1);
+    
+    XCTAssertTrue([self.tally registerBallotFromMessage:[self ballotWithRanking:@[@2, @1]]
+                                              fromVoter:@"first"]);
+    SPNPPollRankedStatistic *statistic = [self.tally statisticWithSequence:@2];
+    
+    XCTAssertEqualObjects(statistic.ballotsCount, @3);
+    XCTAssertEqualObjects(statistic.winner, @1);
+    XCTAssertEqual(statistic.rounds.count, 2);
+    XCTAssertEqualObjects([self standingsOfRound:statistic.rounds.firstObject], @"0:1,1:1,2:1");
+    XCTAssertEqualObjects([self standingsOfRound:statistic.rounds.lastObject], @"0:1,1:2");
+}
+
+
+#pragma mark - Performance
+
+- (void)testBallotsCountingPerformanceAfter10kBallots {
+    
+    [self measureBallotsCountingAfter:10000];
+}
+
+- (void)testBallotsCountingPerformanceAfter100kBallots {
+    
+    [self measureBallotsCountingAfter:100000];
+}
+
+- (void)testBallotsCountingPerformanceAfter1MBallots {
+    
+    [self measureBallotsCountingAfter:1000000];
+}
+
+
+#pragma mark - Misc
+
+- (void)castBallots:(NSUInteger)count withRanking:(NSArray *)ranking {
+    
+    for (NSUInteger ballotIdx = 0; ballotIdx < count; ballotIdx++) {
+        
+        NSString *voter = [NSString stringWithFormat:@"voter-%@", @(self.votersCount++)];
+        XCTAssertTrue([self.tally registerBallotFromMessage:[self ballotWithRanking:ranking]
+                                                  fromVoter:voter]);
+    }
+}
+
+- (NSDictionary *)ballotWithRanking:(NSArray *)ranking {
+    
+    SPNPPollRankedResponse *ballot = [SPNPPollRankedResponse rankedResponseFor:self.poll.identifier
+                                                                    withRanking:ranking
+                                                                          voter:nil];
+    
+    return [ballot dictionaryRepresentation];
+}
+
+- (NSString *)standingsOfRound:(SPNPRankedRoundStatistic *)round {
+    
+    NSMutableArray *standings = [NSMutableArray new];
+    [round enumerateStandingsUsingBlock:^(NSUInteger order, unsigned long long votesCount) {
+        
+        [standings addObject:[NSString stringWithFormat:@"%@:%@", @(order), @(votesCount)]];
+    }];
+    
+    return [standings componentsJoinedByString:@","];
+}
+
+- (NSArray *)ballotsWithAllRankings {
+    
+    NSMutableArray *ballots = [NSMutableArray new];
+    for (NSUInteger first = 0; first < 3; first++) {
+        
+        [ballots addObject:[self ballotWithRanking:@[@(first)]]];
+        for (NSUInteger second = 0; second < 3; second++) {
+            
+            if (second == first) { continue; }
+            NSUInteger third = (3 - first - second);
+            [ballots addObject:[self ballotWithRanking:@[@(first), @(second)]]];
+            [ballots addObject:[self ballotWithRanking:@[@(first), @(second), @(third)]]];
+        }
+    }
+    
+    return [ballots copy];
+}
+
+- (NSUInteger)castBallots:(NSUInteger)count from:(NSArray *)ballots {
+    
+    NSUInteger acceptedBallotsCount = 0;
+    for (NSUInteger ballotIdx = 0; ballotIdx < count; ballotIdx++) {
+        
+        NSString *voter = [NSString stringWithFormat:@"voter-%@", @(self.votersCount++)];
+        if ([self.tally registerBallotFromMessage:ballots[ballotIdx % ballots.count]
+                                        fromVoter:voter]) {
+            
+            acceptedBallotsCount++;
+        }
+    }
+    
+    return acceptedBallotsCount;
+}
+
+- (void)measureBallotsCountingAfter:(NSUInteger)count {
+    
+    NSArray *ballots = [self ballotsWithAllRankings];
+    XCTAssertEqual([self castBallots:count from:ballots], count);
+    XCTAssertEqual(self.tally.bucketsCount, 15);
+    
+    // Identical rankings share bucket, so cost of ballot and rounds doesn't depend on count.
+    __block unsigned long long sequence = 0;
+    [self measureBlock:^{
+        
+        XCTAssertEqual([self castBallots:10000 from:ballots], 10000);
+        SPNPPollRankedStatistic *statistic = [self.tally statisticWithSequence:@(++sequence)];
+        XCTAssertNotNil(statistic.winner);
+    }];
+}
+
+#pragma mark -
+
+
+@end
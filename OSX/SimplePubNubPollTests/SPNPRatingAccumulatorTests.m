@@ -0,0 +1,164 @@
+/**
+ @brief      Tests for streaming ratings mean, variance and histogram accumulation.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <XCTest/XCTest.h>
+#import "SPNPRatingAccumulator.h"
+
+
+#pragma mark Interface declaration
+
+@interface SPNPRatingAccumulatorTests : XCTestCase
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Construct accumulator for \c 1 - \c 10 scale with accumulated values.
+ 
+ @param values List of values which should be added to accumulator.
+ 
+ @return Configured and ready to use accumulator.
+ */
+- (SPNPRatingAccumulator *)accumulatorWithValues:(NSArray *)values;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPRatingAccumulatorTests
+
+
+#pragma mark - Values
+
+- (void)testMeanAndVarianceAccumulated {
+    
+    SPNPRatingAccumulator *accumulator = [self accumulatorWithValues:@[@2, @4, @4, @4, @5, @5,
+                                                                         @7, @9]];
+    
+    XCTAssertEqual(accumulator.count, 8);
+    XCTAssertEqualWithAccuracy(accumulator.mean, 5.0, 1e-9);
+    XCTAssertEqualWithAccuracy(accumulator.sumOfSquaredDeviations, 32.0, 1e-9);
+    XCTAssertEqualWithAccuracy(accumulator.variance, 32.0 / 7.0, 1e-9);
+    XCTAssertEqual([self accumulatorWithValues:@[@3]].variance, 0.0);
+}
+
+- (void)testLargeValuesAccumulatedWithoutPrecisionLoss {
+    
+    // Naive sum of squares lose all significant digits for such values.
+    SPNPRatingAccumulator *accumulator = [self accumulatorWithValues:@[@1000000004, @1000000007,
+                                                                         @1000000013, @1000000016]];
+    
+    XCTAssertEqualWithAccuracy(accumulator.mean, 1000000010.0, 1e-6);
+    XCTAssertEqualWithAccuracy(accumulator.variance, 30.0, 1e-6);
+}
+
+- (void)testHistogramCountValuesOnScale {
+    
+    SPNPRatingAccumulator *accumulator = [SPNPRatingAccumulator accumulatorWithMinimumValue:1
+                                                                               maximumValue:5];
+    for (NSNumber *value in @[@1, @5, @5, @3, @0, @9]) { [accumulator addValue:value.doubleValue]; }
+    
+    XCTAssertEqual(accumulator.binsCount, 5);
+    XCTAssertEqualObjects(accumulator.histogram, (@[@2, @0, @1, @0, @3]));
+}
+
+- (void)testRemovedValueReverseAccumulation {
+    
+    SPNPRatingAccumulator *accumulator = [self accumulatorWithValues:@[@2, @4, @8, @9]];
+    SPNPRatingAccumulator *expectedAccumulator = [self accumulatorWithValues:@[@2, @8, @9]];
+    [accumulator removeValue:4];
+    
+    XCTAssertEqual(accumulator.count, 3);
+    XCTAssertEqualWithAccuracy(accumulator.mean, expectedAccumulator.mean, 1e-9);
+    XCTAssertEqualWithAccuracy(accumulator.variance, expectedAccumulator.variance, 1e-9);
+    XCTAssertEqualObjects(accumulator.histogram, expectedAccumulator.histogram);
+}
+
+- (void)testRemovedUnknownOrLastValue {
+    
+    SPNPRatingAccumulator *accumulator = [self accumulatorWithValues:@[@6]];
+    [accumulator removeValue:3];
+    XCTAssertEqual(accumulator.count, 1);
+    
+    [accumulator removeValue:6];
+    XCTAssertEqual(accumulator.count, 0);
+    XCTAssertEqual(accumulator.mean, 0.0);
+    XCTAssertEqual(accumulator.sumOfSquaredDeviations, 0.0);
+    XCTAssertTrue(isnan([accumulator valueAtQuantile:0.5]));
+}
+
+
+#pragma mark - Quantiles
+
+- (void)testIntegerScaleQuantiles {
+    
+    SPNPRatingAccumulator *accumulator = [self accumulatorWithValues:@[@1, @2, @2, @3, @5]];
+    
+    XCTAssertEqual([accumulator valueAtQuantile:0.0], 1.0);
+    XCTAssertEqual([accumulator valueAtQuantile:0.5], 2.0);
+    XCTAssertEqual([accumulator valueAtQuantile:1.0], 5.0);
+}
+
+- (void)testWideScaleQuantileInterpolated {
+    
+    SPNPRatingAccumulator *accumulator = [SPNPRatingAccumulator accumulatorWithMinimumValue:0
+                                                                               maximumValue:127];
+    for (NSUInteger value = 0; value < 100; value++) { [accumulator addValue:value]; }
+    
+    XCTAssertEqual(accumulator.binsCount, 64);
+    XCTAssertEqualWithAccuracy([accumulator valueAtQuantile:0.5], 50.0, 0.01);
+}
+
+
+#pragma mark - Merge
+
+- (void)testMergedPartialAggregatesMatchWholeStream {
+    
+    SPNPRatingAccumulator *accumulator = [self accumulatorWithValues:@[@1, @3, @3, @10]];
+    SPNPRatingAccumulator *partialAccumulator = [self accumulatorWithValues:@[@6, @7, @2]];
+    SPNPRatingAccumulator *expectedAccumulator = [self accumulatorWithValues:@[@1, @3, @3, @10,
+                                                                                 @6, @7, @2]];
+    [accumulator mergeAccumulator:partialAccumulator];
+    [accumulator mergeAccumulator:[self accumulatorWithValues:@[]]];
+    
+    XCTAssertEqual(accumulator.count, 7);
+    XCTAssertEqualWithAccuracy(accumulator.mean, expectedAccumulator.mean, 1e-9);
+    XCTAssertEqualWithAccuracy(accumulator.sumOfSquaredDeviations,
+                               expectedAccumulator.sumOfSquaredDeviations, 1e-9);
+    XCTAssertEqualObjects(accumulator.histogram, expectedAccumulator.histogram);
+}
+
+- (void)testMergeIgnoreHistogramOfOtherScale {
+    
+    SPNPRatingAccumulator *accumulator = [self accumulatorWithValues:@[@4]];
+    [accumulator mergeCount:2 mean:6.0 sumOfSquaredDeviations:2.0 histogram:@[@1, @1]];
+    
+    XCTAssertEqual(accumulator.count, 3);
+    XCTAssertEqualWithAccuracy(accumulator.mean, 16.0 / 3.0, 1e-9);
+    XCTAssertEqualWithAccuracy(accumulator.variance, 7.0 / 3.0, 1e-9);
+    XCTAssertEqualObjects(accumulator.histogram, [self accumulatorWithValues:@[@4]].histogram);
+}
+
+
+#pragma mark - Misc
+
+- (SPNPRatingAccumulator *)accumulatorWithValues:(NSArray *)values {
+    
+    SPNPRatingAccumulator *accumulator = [SPNPRatingAccumulator accumulatorWithMinimumValue:1
+                                                                               maximumValue:10];
+    for (NSNumber *value in values) { [accumulator addValue:value.doubleValue]; }
+    
+    return accumulator;
+}
+
+#pragma mark -
+
+
+@end
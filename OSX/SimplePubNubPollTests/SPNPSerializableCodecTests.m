@@ -0,0 +1,304 @@
+/**
+ @brief      Tests for dictionary and compact representation of models.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <XCTest/XCTest.h>
+#import "SPNPSerializableCodec.h"
+#import "SPNPPollResponse.h"
+#import "SPNPCompactCoder.h"
+#import "SPNPPoll.h"
+
+
+#pragma mark Interface declaration
+
+@interface SPNPSerializableCodecTests : XCTestCase
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Construct set of polls which is used to measure properties access performance.
+ 
+ @return List of started rating polls.
+ */
+- (NSArray *)pollsForBenchmark;
+
+/**
+ @brief  Read values of all serializable properties from passed polls.
+ 
+ @param polls              List of polls from which values should be read.
+ @param usesKeyValueCoding Whether values should be read with \c -valueForKey: instead of cached
+                           accessor implementations.
+ 
+ @return List of properties values list for each poll (\c NSNull used for \c nil values).
+ */
+- (NSArray *)valuesOfPolls:(NSArray *)polls usingKeyValueCoding:(BOOL)usesKeyValueCoding;
+
+/**
+ @brief  Create polls and set values for all serializable properties.
+ 
+ @param values             List of properties values list for each poll.
+ @param usesKeyValueCoding Whether values should be set with \c -setValue:forKey: instead of cached
+                           accessor implementations.
+ 
+ @return List of restored polls.
+ */
+- (NSArray *)pollsFromValues:(NSArray *)values usingKeyValueCoding:(BOOL)usesKeyValueCoding;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPSerializableCodecTests
+
+
+#pragma mark - Class registry
+
+- (void)testSerializableClassResolvedOnlyForModels {
+    
+    XCTAssertEqual([SPNPSerializableCodec serializableClassWithName:@"SPNPPollResponse"],
+                   SPNPPollResponse.class);
+    XCTAssertNil([SPNPSerializableCodec serializableClassWithName:@"SPNPSerializable"]);
+    XCTAssertNil([SPNPSerializableCodec serializableClassWithName:@"NSObject"]);
+    XCTAssertNil([SPNPSerializableCodec serializableClassWithName:(NSString *)@42]);
+}
+
+
+#pragma mark - Properties access
+
+- (void)testPropertyIndicesMatchNames {
+    
+    SPNPPollResponse *response = [SPNPPollResponse pollResponseFor:@"poll" withValue:@"Yes"
+                                                       orderNumber:@3];
+    SPNPSerializableCodec *codec = [SPNPSerializableCodec codecForObject:response];
+    XCTAssertEqualObjects(codec.className, @"SPNPPollResponse");
+    XCTAssertGreaterThan(codec.count, 0);
+    for (NSUInteger propertyIdx = 0; propertyIdx < codec.count; propertyIdx++) {
+        
+        NSString *propertyName = [codec propertyNameAtIndex:propertyIdx];
+        XCTAssertEqual([codec indexOfPropertyWithName:propertyName], propertyIdx);
+    }
+    XCTAssertEqual([codec indexOfPropertyWithName:@"unknown"], NSNotFound);
+    
+    NSUInteger orderIdx = [codec indexOfPropertyWithName:@"order"];
+    XCTAssertEqualObjects([codec valueAtIndex:orderIdx fromObject:response], @3);
+    [codec setValue:@7 atIndex:orderIdx forObject:response];
+    XCTAssertEqualObjects(response.order, @7);
+    XCTAssertEqual([SPNPSerializableCodec codecForObject:response], codec);
+}
+
+
+#pragma mark - Dictionary representation
+
+- (void)testPollDictionaryRoundTrip {
+    
+    SPNPPoll *poll = [SPNPPoll pollWithQuestion:@"Best talk?" responses:@[@"First", @"Second"]
+                                   answerShards:4];
+    poll = [poll pollStartedAt:@14500000000000000];
+    NSDictionary *representation = [poll dictionaryRepresentation];
+    XCTAssertEqualObjects(representation[@"s_class"], @"SPNPPoll");
+    XCTAssertNotNil([NSJSONSerialization dataWithJSONObject:representation options:0 error:NULL]);
+    
+    SPNPPoll *restoredPoll = [SPNPPoll objectFromDictionaryRepresentation:representation];
+    XCTAssertEqualObjects(restoredPoll.identifier, poll.identifier);
+    XCTAssertEqualObjects(restoredPoll.question, poll.question);
+    XCTAssertEqualObjects(restoredPoll.token, poll.token);
+    XCTAssertEqualObjects(restoredPoll.startTimetoken, @14500000000000000);
+    XCTAssertEqualObjects(restoredPoll.answerShardsCount, @4);
+    XCTAssertTrue(restoredPoll.isActive);
+    XCTAssertEqual(restoredPoll.responses.count, 2);
+    XCTAssertEqualObjects([restoredPoll.responses.lastObject response], @"Second");
+    XCTAssertEqualObjects([restoredPoll.responses.lastObject order], @1);
+    XCTAssertFalse([poll completedPoll].isActive);
+}
+
+- (void)testDictionaryOfOtherClassRejected {
+    
+    SPNPPollResponse *response = [SPNPPollResponse pollResponseFor:@"poll" withValue:@"Yes"
+                                                       orderNumber:@0];
+    XCTAssertNil([SPNPPoll objectFromDictionaryRepresentation:[response dictionaryRepresentation]]);
+    XCTAssertNil([SPNPPoll objectFromDictionaryRepresentation:(NSDictionary *)@"SPNPPoll"]);
+}
+
+
+#pragma mark - Compact representation
+
+- (void)testResponseCompactRoundTrip {
+    
+    SPNPPoll *poll = [SPNPPoll pollWithQuestion:@"Best talk?" responses:@[@"First", @"Second"]];
+    NSString *voter = [NSUUID UUID].UUIDString;
+    SPNPPollResponse *response = [SPNPPollResponse pollResponseFor:poll.identifier
+                                                         withValue:@"Second" orderNumber:@1
+                                                             voter:voter traceTime:@1450000000000];
+    NSString *representation = [response compactRepresentationForPoll:poll.identifier
+                                                                 token:poll.token];
+    XCTAssertNotNil(representation);
+    XCTAssertLessThan(representation.length,
+                      [NSJSONSerialization dataWithJSONObject:[response dictionaryRepresentation]
+                                                      options:0 error:NULL].length);
+    
+    SPNPPollResponse *restoredResponse = [SPNPPollResponse objectFromMessage:representation
+                                                                     forPoll:poll.identifier
+                                                                       token:poll.token];
+    XCTAssertEqualObjects(restoredResponse.pollIdentifier, poll.identifier);
+    XCTAssertEqualObjects(restoredResponse.response, @"Second");
+    XCTAssertEqualObjects(restoredResponse.order, @1);
+    XCTAssertEqualObjects(restoredResponse.voter.uppercaseString, voter);
+    XCTAssertEqualObjects(restoredResponse.traceTime, @1450000000000);
+    XCTAssertEqualObjects([SPNPPollResponse pollKeyFromMessage:representation], poll.token);
+    XCTAssertEqualObjects([SPNPPollResponse pollKeyFromMessage:[response dictionaryRepresentation]],
+                          poll.identifier);
+}
+
+- (void)testPollCompactRoundTrip {
+    
+    SPNPPoll *poll = [SPNPPoll ratingPollWithQuestion:@"Rate talk" minimumRating:-2 maximumRating:5
+                                         answerShards:2];
+    NSString *representation = [poll compactRepresentationForPoll:poll.identifier token:poll.token];
+    SPNPPoll *restoredPoll = [SPNPPoll objectFromCompactRepresentation:representation
+                                                               forPoll:poll.identifier
+                                                                 token:poll.token];
+    XCTAssertEqualObjects(restoredPoll.identifier, poll.identifier);
+    XCTAssertEqualObjects(restoredPoll.question, @"Rate talk");
+    XCTAssertEqualObjects(restoredPoll.answerShardsCount, @2);
+    XCTAssertTrue(restoredPoll.isRating);
+    XCTAssertFalse(restoredPoll.isRanked);
+    XCTAssertEqualObjects(restoredPoll.minimumRating, @-2);
+    XCTAssertEqualObjects(restoredPoll.maximumRating, @5);
+}
+
+- (void)testDamagedCompactRepresentationRejected {
+    
+    SPNPPoll *poll = [SPNPPoll pollWithQuestion:@"Best talk?" responses:@[@"First", @"Second"]];
+    SPNPPollResponse *response = [SPNPPollResponse pollResponseFor:poll.identifier
+                                                         withValue:@"First" orderNumber:@0];
+    NSString *representation = [response compactRepresentationForPoll:poll.identifier
+                                                                 token:poll.token];
+    NSString *truncated = [representation substringToIndex:4];
+    XCTAssertNil([SPNPPollResponse objectFromCompactRepresentation:truncated forPoll:poll.identifier
+                                                             token:poll.token]);
+    XCTAssertNil([SPNPPoll objectFromCompactRepresentation:representation forPoll:poll.identifier
+                                                     token:poll.token]);
+    XCTAssertNil([SPNPPollResponse pollKeyFromMessage:@"not base64!"]);
+}
+
+
+#pragma mark - Performance
+
+- (void)testCachedAccessorsRestoreSameValuesAsKeyValueCoding {
+    
+    NSArray *polls = [self pollsForBenchmark];
+    NSArray *values = [self valuesOfPolls:polls usingKeyValueCoding:NO];
+    XCTAssertEqualObjects(values, [self valuesOfPolls:polls usingKeyValueCoding:YES]);
+    XCTAssertEqualObjects([self valuesOfPolls:[self pollsFromValues:values usingKeyValueCoding:NO]
+                                usingKeyValueCoding:YES], values);
+}
+
+- (void)testCachedAccessorsEncodePerformance {
+    
+    NSArray *polls = [self pollsForBenchmark];
+    [self measureBlock:^{
+        
+        [self valuesOfPolls:polls usingKeyValueCoding:NO];
+    }];
+}
+
+- (void)testKeyValueCodingEncodePerformance {
+    
+    NSArray *polls = [self pollsForBenchmark];
+    [self measureBlock:^{
+        
+        [self valuesOfPolls:polls usingKeyValueCoding:YES];
+    }];
+}
+
+- (void)testCachedAccessorsDecodePerformance {
+    
+    NSArray *values = [self valuesOfPolls:[self pollsForBenchmark] usingKeyValueCoding:NO];
+    [self measureBlock:^{
+        
+        [self pollsFromValues:values usingKeyValueCoding:NO];
+    }];
+}
+
+- (void)testKeyValueCodingDecodePerformance {
+    
+    NSArray *values = [self valuesOfPolls:[self pollsForBenchmark] usingKeyValueCoding:NO];
+    [self measureBlock:^{
+        
+        [self pollsFromValues:values usingKeyValueCoding:YES];
+    }];
+}
+
+
+#pragma mark - Misc
+
+- (NSArray *)pollsForBenchmark {
+    
+    NSMutableArray *polls = [NSMutableArray arrayWithCapacity:2000];
+    for (NSUInteger pollIdx = 0; pollIdx < 2000; pollIdx++) {
+        
+        SPNPPoll *poll = [SPNPPoll ratingPollWithQuestion:@"Rate talk" minimumRating:1
+                                            maximumRating:5 answerShards:(pollIdx % 4)];
+        [polls addObject:[poll pollStartedAt:@(14500000000000000 + pollIdx)]];
+    }
+    
+    return polls;
+}
+
+- (NSArray *)valuesOfPolls:(NSArray *)polls usingKeyValueCoding:(BOOL)usesKeyValueCoding {
+    
+    SPNPSerializableCodec *codec = [SPNPSerializableCodec codecForObject:polls.firstObject];
+    NSMutableArray *values = [NSMutableArray arrayWithCapacity:polls.count];
+    for (SPNPPoll *poll in polls) {
+        
+        NSMutableArray *pollValues = [NSMutableArray arrayWithCapacity:codec.count];
+        for (NSUInteger propertyIdx = 0; propertyIdx < codec.count; propertyIdx++) {
+            
+            id value = nil;
+            if (usesKeyValueCoding) {
+                
+                value = [poll valueForKey:[codec propertyNameAtIndex:propertyIdx]];
+            }
+            else { value = [codec valueAtIndex:propertyIdx fromObject:poll]; }
+            [pollValues addObject:(value ?: [NSNull null])];
+        }
+        [values addObject:pollValues];
+    }
+    
+    return values;
+}
+
+- (NSArray *)pollsFromValues:(NSArray *)values usingKeyValueCoding:(BOOL)usesKeyValueCoding {
+    
+    SPNPSerializableCodec *codec = [SPNPSerializableCodec codecForObject:[SPNPPoll new]];
+    NSMutableArray *polls = [NSMutableArray arrayWithCapacity:values.count];
+    for (NSArray *pollValues in values) {
+        
+        SPNPPoll *poll = [SPNPPoll new];
+        for (NSUInteger propertyIdx = 0; propertyIdx < codec.count; propertyIdx++) {
+            
+            id value = pollValues[propertyIdx];
+            if ([value isKindOfClass:[NSNull class]]) { continue; }
+            if (usesKeyValueCoding) {
+                
+                [poll setValue:value forKey:[codec propertyNameAtIndex:propertyIdx]];
+            }
+            else { [codec setValue:value atIndex:propertyIdx forObject:poll]; }
+        }
+        [polls addObject:poll];
+    }
+    
+    return polls;
+}
+
+#pragma mark -
+
+
+@end
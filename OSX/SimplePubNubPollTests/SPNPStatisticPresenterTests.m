@@ -0,0 +1,157 @@
+/**
+ @brief      Tests for poll statistic chart presentation diff and frames coalescing.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <XCTest/XCTest.h>
+#import "SPNPPollResponseStatistic.h"
+#import "SPNPStatisticPresenter.h"
+#import "SPNPPollResponse.h"
+
+
+#pragma mark Interface declaration
+
+@interface SPNPStatisticPresenterTests : XCTestCase
+
+
+#pragma mark - Properties
+
+@property (nonatomic, strong) SPNPStatisticPresenter *presenter;
+
+/**
+ @brief  Stores reference on list of updates passed to update block in 
+         "<changed bars>:<is initial>" format.
+ */
+@property (nonatomic, strong) NSMutableArray *updates;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPStatisticPresenterTests
+
+
+#pragma mark - Configuration
+
+- (void)setUp {
+    
+    [super setUp];
+    
+    NSMutableArray *updates = [NSMutableArray new];
+    self.updates = updates;
+    self.presenter = [SPNPStatisticPresenter presenterWithUpdateBlock:^(NSIndexSet *changedBars,
+                                                                        BOOL isInitial) {
+        
+        NSMutableArray *bars = [NSMutableArray new];
+        [changedBars enumerateIndexesUsingBlock:^(NSUInteger barIdx, BOOL *barsEnumeratorStop) {
+            
+            [bars addObject:@(barIdx)];
+        }];
+        [updates addObject:[NSString stringWithFormat:@"%@:%@",
+                            [bars componentsJoinedByString:@","], @(isInitial)]];
+    }];
+}
+
+
+#pragma mark - Diff
+
+- (void)testOnlyChangedBarsReported {
+    
+    XCTAssertEqualObjects([self.presenter applyVotesCount:@[@1, @2, @4]],
+                          [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, 3)]);
+    XCTAssertEqual(self.presenter.scale, 4);
+    XCTAssertEqualWithAccuracy([self.presenter percentForBar:0], 0.25, 0.0001);
+    
+    XCTAssertEqualObjects([self.presenter applyVotesCount:@[@1, @3, @4]],
+                          [NSIndexSet indexSetWithIndex:1]);
+    XCTAssertEqual([self.presenter votesCountForBar:1], 3);
+    XCTAssertEqual([self.presenter applyVotesCount:@[@1, @3, @4]].count, 0);
+    XCTAssertEqual([self.presenter votesCountForBar:7], 0);
+    XCTAssertEqual([self.presenter percentForBar:7], 0.0);
+}
+
+- (void)testScaleChangeReportAllBarsWithChangedPercent {
+    
+    [self.presenter applyVotesCount:@[@0, @2, @4]];
+    XCTAssertEqualObjects([self.presenter applyVotesCount:@[@0, @2, @8]],
+                          [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(1, 2)]);
+    XCTAssertEqual(self.presenter.scale, 8);
+    XCTAssertEqualWithAccuracy([self.presenter percentForBar:1], 0.25, 0.0001);
+    XCTAssertEqual([self.presenter percentForBar:0], 0.0);
+}
+
+- (void)testBarsCountChangeReportAllBars {
+    
+    [self.presenter applyVotesCount:@[@1, @2]];
+    XCTAssertEqualObjects([self.presenter applyVotesCount:@[@1, @2, @0]],
+                          [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, 3)]);
+    XCTAssertEqual(self.presenter.barsCount, 3);
+}
+
+
+#pragma mark - Updates
+
+- (void)testFirstUpdateReportedAsInitial {
+    
+    SPNPPollResponse *firstResponse = [SPNPPollResponse pollResponseFor:@"poll" withValue:@"First"
+                                                            orderNumber:@0];
+    SPNPPollResponse *secondResponse = [SPNPPollResponse pollResponseFor:@"poll"
+                                                               withValue:@"Second" orderNumber:@1];
+    SPNPPollResponseStatistic *first =
+        [SPNPPollResponseStatistic statisticForResponse:firstResponse];
+    SPNPPollResponseStatistic *second =
+        [SPNPPollResponseStatistic statisticForResponse:secondResponse];
+    [second updateVotesCount:2];
+    [self.presenter updateWithStatistics:@[first, second]];
+    
+    XCTAssertEqualObjects(self.updates, @[@"0,1:1"]);
+    XCTAssertEqual([self.presenter votesCountForBar:1], 2);
+    
+    [self.presenter reset];
+    [self.presenter updateWithVotesCount:@[@0, @2]];
+    [self.presenter flush];
+    XCTAssertEqualObjects(self.updates, (@[@"0,1:1", @"0,1:1"]));
+}
+
+- (void)testUpdatesCoalescedToFrame {
+    
+    self.presenter.maximumFrameRate = 10;
+    [self.presenter updateWithVotesCount:@[@1, @0]];
+    [self.presenter updateWithVotesCount:@[@2, @0]];
+    [self.presenter updateWithVotesCount:@[@2, @1]];
+    XCTAssertEqualObjects(self.updates, @[@"0,1:1"]);
+    
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Next frame"];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.3f * NSEC_PER_SEC)),
+                   dispatch_get_main_queue(), ^{
+        
+        [expectation fulfill];
+    });
+    [self waitForExpectationsWithTimeout:5.0f handler:nil];
+    
+    XCTAssertEqualObjects(self.updates, (@[@"0,1:1", @"0,1:0"]));
+    XCTAssertEqual(self.presenter.updatesCount, 2);
+    XCTAssertEqual([self.presenter votesCountForBar:0], 2);
+}
+
+- (void)testUnchangedVotesCountNotPresented {
+    
+    self.presenter.maximumFrameRate = 1000;
+    [self.presenter updateWithVotesCount:@[@1, @2]];
+    [self.presenter flush];
+    [self.presenter updateWithVotesCount:@[@1, @2]];
+    [self.presenter flush];
+    
+    XCTAssertEqualObjects(self.updates, @[@"0,1:1"]);
+    XCTAssertEqual(self.presenter.updatesCount, 1);
+}
+
+#pragma mark -
+
+
+@end
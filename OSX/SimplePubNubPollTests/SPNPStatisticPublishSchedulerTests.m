@@ -0,0 +1,258 @@
+/**
+ @brief      Tests for host statistic publish scheduler decisions.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <XCTest/XCTest.h>
+#import "SPNPStatisticPublishScheduler.h"
+
+
+#pragma mark Interface declaration
+
+@interface SPNPStatisticPublishSchedulerTests : XCTestCase
+
+
+#pragma mark - Properties
+
+@property (nonatomic, strong) SPNPStatisticPublishScheduler *scheduler;
+
+/**
+ @brief  Stores simulated time which is reported by scheduler's clock.
+ */
+@property (nonatomic, assign) NSTimeInterval time;
+
+/**
+ @brief  Stores sorted list of times at which votes has been received.
+ */
+@property (nonatomic, copy) NSArray *voteTimes;
+
+/**
+ @brief  Stores index of first vote which hasn't been seen by scheduler yet.
+ */
+@property (nonatomic, assign) NSUInteger voteIndex;
+
+/**
+ @brief  Stores whether publish request should complete right away and with which result.
+ */
+@property (nonatomic, assign) BOOL completesPublish;
+@property (nonatomic, assign) BOOL publishResult;
+
+/**
+ @brief  Stores reference on completion block of publish request which is in progress.
+ */
+@property (nonatomic, copy) void(^pendingCompletion)(BOOL published);
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Create scheduler which use simulated time and votes.
+ */
+- (void)createScheduler;
+
+/**
+ @brief  Check whether new votes has been received since previous check.
+ 
+ @return \c YES in case if there is votes which has been received till current time.
+ */
+- (BOOL)hasVotesSinceLastCheck;
+
+/**
+ @brief  Build list of times at which votes has been received.
+ 
+ @param start    Time at which first vote has been received.
+ @param end      Time after which there was no more votes.
+ @param interval Interval between votes.
+ 
+ @return List of votes time.
+ */
+- (NSArray *)voteTimesFrom:(NSTimeInterval)start till:(NSTimeInterval)end
+                     every:(NSTimeInterval)interval;
+
+/**
+ @brief      Run scheduler checks with simulated time in the same way as they triggered by timer.
+ @discussion Publish requests complete right away.
+ 
+ @param duration Simulated time during which checks should be performed.
+ 
+ @return Number of checks which has been performed.
+ */
+- (NSUInteger)runChecksDuring:(NSTimeInterval)duration;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPStatisticPublishSchedulerTests
+
+
+#pragma mark - Configuration
+
+- (void)setUp {
+    
+    [super setUp];
+    
+    [self createScheduler];
+}
+
+
+#pragma mark - Activity
+
+- (void)testIdleStatisticNotPublished {
+    
+    NSUInteger checksCount = [self runChecksDuring:60.0f];
+    
+    XCTAssertEqual(self.scheduler.publishesCount, 0);
+    XCTAssertEqual(self.scheduler.lastDecision, SPNPStatisticPublishIdle);
+    XCTAssertEqualWithAccuracy(self.scheduler.interval, self.scheduler.maximumInterval, 0.001f);
+    XCTAssertLessThan(checksCount, 60.0f / self.scheduler.maximumInterval + 4);
+}
+
+- (void)testContinuousVotesPublishedAtMinimumInterval {
+    
+    self.voteTimes = [self voteTimesFrom:0.0f till:10.0f every:0.01f];
+    [self runChecksDuring:10.0f];
+    
+    XCTAssertEqualWithAccuracy(self.scheduler.publishesCount, 40, 2);
+    XCTAssertEqualWithAccuracy(self.scheduler.interval, self.scheduler.minimumInterval, 0.001f);
+}
+
+- (void)testBurstyVotesPublishesScaleWithActivity {
+    
+    NSArray *firstBurst = [self voteTimesFrom:10.0f till:15.0f every:0.01f];
+    NSArray *secondBurst = [self voteTimesFrom:40.0f till:45.0f every:0.01f];
+    self.voteTimes = [firstBurst arrayByAddingObjectsFromArray:secondBurst];
+    [self runChecksDuring:60.0f];
+    NSUInteger burstyPublishesCount = self.scheduler.publishesCount;
+    
+    // Same activity during longer period of time shouldn't cause more publishes.
+    [self createScheduler];
+    self.voteTimes = [firstBurst arrayByAddingObjectsFromArray:secondBurst];
+    [self runChecksDuring:600.0f];
+    
+    XCTAssertGreaterThan(burstyPublishesCount, 2);
+    XCTAssertLessThanOrEqual(burstyPublishesCount, 10.0f / self.scheduler.minimumInterval + 2);
+    XCTAssertEqual(self.scheduler.publishesCount, burstyPublishesCount);
+    XCTAssertEqual(self.scheduler.lastDecision, SPNPStatisticPublishIdle);
+}
+
+
+#pragma mark - Publish requests
+
+- (void)testSinglePublishInFlight {
+    
+    self.completesPublish = NO;
+    self.voteTimes = [self voteTimesFrom:0.0f till:1.0f every:0.01f];
+    self.time = 0.25f;
+    XCTAssertEqual([self.scheduler check], SPNPStatisticPublish);
+    self.time = 0.5f;
+    XCTAssertEqual([self.scheduler check], SPNPStatisticPublishWaitForCompletion);
+    self.time = 0.75f;
+    XCTAssertEqual([self.scheduler check], SPNPStatisticPublishWaitForCompletion);
+    XCTAssertTrue(self.scheduler.isPublishing);
+    XCTAssertEqual(self.scheduler.publishesCount, 1);
+    
+    // Changes collected while request was in progress published with next snapshot.
+    self.pendingCompletion(YES);
+    self.time = 1.0f;
+    XCTAssertEqual([self.scheduler check], SPNPStatisticPublish);
+    XCTAssertEqual(self.scheduler.publishesCount, 2);
+}
+
+- (void)testFailedPublishBacksOff {
+    
+    self.publishResult = NO;
+    self.voteTimes = @[@0.1f];
+    self.time = 0.25f;
+    XCTAssertEqual([self.scheduler check], SPNPStatisticPublish);
+    self.time = 0.5f;
+    XCTAssertEqual([self.scheduler check], SPNPStatisticPublishBackOff);
+    self.time = 0.75f;
+    XCTAssertEqual([self.scheduler check], SPNPStatisticPublish);
+    XCTAssertEqual(self.scheduler.failuresCount, 2);
+    
+    // Back off delay doubled after each failure.
+    self.time = 1.5f;
+    XCTAssertEqual([self.scheduler check], SPNPStatisticPublishBackOff);
+    self.publishResult = YES;
+    self.time = 1.75f;
+    XCTAssertEqual([self.scheduler check], SPNPStatisticPublish);
+    XCTAssertEqual(self.scheduler.failuresCount, 0);
+    self.time = 2.0f;
+    XCTAssertEqual([self.scheduler check], SPNPStatisticPublishIdle);
+    XCTAssertEqual(self.scheduler.publishesCount, 3);
+}
+
+
+#pragma mark - Misc
+
+- (void)createScheduler {
+    
+    __weak __typeof(self) weakSelf = self;
+    self.scheduler = [SPNPStatisticPublishScheduler schedulerWithChangesBlock:^BOOL{
+        
+        return [weakSelf hasVotesSinceLastCheck];
+    } publishBlock:^(void(^completion)(BOOL published)) {
+        
+        if (weakSelf.completesPublish) { completion(weakSelf.publishResult); }
+        else { weakSelf.pendingCompletion = completion; }
+    }];
+    self.scheduler.clock = ^NSTimeInterval{ return weakSelf.time; };
+    self.time = 0.0f;
+    self.voteIndex = 0;
+    self.completesPublish = YES;
+    self.publishResult = YES;
+}
+
+- (BOOL)hasVotesSinceLastCheck {
+    
+    NSUInteger voteIndex = self.voteIndex;
+    while (self.voteIndex < self.voteTimes.count &&
+           [self.voteTimes[self.voteIndex] doubleValue] <= self.time) {
+        
+        self.voteIndex++;
+    }
+    
+    return (self.voteIndex != voteIndex);
+}
+
+- (NSArray *)voteTimesFrom:(NSTimeInterval)start till:(NSTimeInterval)end
+                     every:(NSTimeInterval)interval {
+    
+    NSMutableArray *voteTimes = [NSMutableArray new];
+    for (NSTimeInterval time = start; time < end; time += interval) {
+        
+        [voteTimes addObject:@(time)];
+    }
+    
+    return [voteTimes copy];
+}
+
+- (NSUInteger)runChecksDuring:(NSTimeInterval)duration {
+    
+    NSUInteger checksCount = 0;
+    self.time = self.scheduler.minimumInterval;
+    while (self.time < duration) {
+        
+        [self.scheduler check];
+        checksCount++;
+        NSTimeInterval interval = self.scheduler.interval;
+        if (self.scheduler.lastDecision == SPNPStatisticPublishBackOff) {
+            
+            interval = self.scheduler.minimumInterval;
+        }
+        self.time += interval;
+    }
+    
+    return checksCount;
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,300 @@
+/**
+ @brief      Tests for statistic keyframes and changes sequencing on attendee side.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <XCTest/XCTest.h>
+#import "SPNPPollResponseStatistic.h"
+#import "SPNPStatisticSequencer.h"
+#import "SPNPPollStatisticDelta.h"
+#import "SPNPPollStatistic.h"
+#import "SPNPPoll.h"
+
+
+#pragma mark Interface declaration
+
+@interface SPNPStatisticSequencerTests : XCTestCase
+
+
+#pragma mark - Properties
+
+@property (nonatomic, strong) SPNPStatisticSequencer *sequencer;
+@property (nonatomic, strong) SPNPPoll *poll;
+
+/**
+ @brief  Stores votes count which attendee built from received updates.
+ */
+@property (nonatomic, strong) NSMutableArray *votesCount;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Construct keyframe with full statistic as it received by attendee.
+ 
+ @param sequence   Sequence number of update.
+ @param votesCount Votes count for each poll response.
+ 
+ @return Keyframe decoded from compact representation.
+ */
+- (SPNPPollStatistic *)keyframe:(NSNumber *)sequence withVotesCount:(NSArray *)votesCount;
+
+/**
+ @brief  Construct votes count changes as it received by attendee.
+ 
+ @param sequence Sequence number of update.
+ @param changes  List of response order number and votes count change pairs.
+ 
+ @return Changes decoded from compact representation.
+ */
+- (SPNPPollStatisticDelta *)delta:(NSNumber *)sequence withChanges:(NSArray *)changes;
+
+/**
+ @brief  Apply received statistic updates in same way as poll manager do.
+ 
+ @param updates List of \b SPNPPollStatistic and \b SPNPPollStatisticDelta instances.
+ 
+ @return Number of updates which has been applied.
+ */
+- (NSUInteger)receiveUpdates:(NSArray *)updates;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPStatisticSequencerTests
+
+
+#pragma mark - Configuration
+
+- (void)setUp {
+    
+    [super setUp];
+    
+    self.poll = [SPNPPoll pollWithQuestion:@"Best talk?"
+                                 responses:@[@"First", @"Second", @"Third"]];
+    self.sequencer = [SPNPStatisticSequencer sequencerWithKeyframeInterval:20];
+    self.votesCount = [@[@0, @0, @0] mutableCopy];
+}
+
+
+#pragma mark - Changes
+
+- (void)testChangesAppliedAfterKeyframe {
+    
+    NSArray *updates = @[[self delta:@1 withChanges:@[@0, @1]],
+                         [self keyframe:@2 withVotesCount:@[@1, @0, @0]],
+                         [self delta:@3 withChanges:@[@0, @1]],
+                         [self delta:@4 withChanges:@[@1, @2, @2, @1]]];
+    
+    XCTAssertEqual([self receiveUpdates:updates], 3);
+    XCTAssertEqualObjects(self.votesCount, (@[@2, @2, @1]));
+    XCTAssertEqual(self.sequencer.sequence, 4);
+    XCTAssertTrue(self.sequencer.isSynchronized);
+}
+
+- (void)testSequenceGapWaitForKeyframe {
+    
+    NSArray *updates = @[[self keyframe:@1 withVotesCount:@[@1, @0, @0]],
+                         [self delta:@3 withChanges:@[@1, @1]],
+                         [self delta:@4 withChanges:@[@1, @1]]];
+    
+    XCTAssertEqual([self receiveUpdates:updates], 1);
+    XCTAssertEqualObjects(self.votesCount, (@[@1, @0, @0]));
+    XCTAssertEqual(self.sequencer.sequence, 1);
+    XCTAssertFalse(self.sequencer.isSynchronized);
+    
+    // Keyframe re-synchronize attendee and following changes applied again.
+    updates = @[[self keyframe:@5 withVotesCount:@[@1, @3, @0]],
+                [self delta:@6 withChanges:@[@2, @1]]];
+    XCTAssertEqual([self receiveUpdates:updates], 2);
+    XCTAssertEqualObjects(self.votesCount, (@[@1, @3, @1]));
+    XCTAssertTrue(self.sequencer.isSynchronized);
+}
+
+- (void)testDuplicatedChangesIgnored {
+    
+    SPNPPollStatisticDelta *delta = [self delta:@2 withChanges:@[@0, @1]];
+    NSArray *updates = @[[self keyframe:@1 withVotesCount:@[@1, @0, @0]], delta, delta,
+                         [self keyframe:@1 withVotesCount:@[@1, @0, @0]]];
+    
+    XCTAssertEqual([self receiveUpdates:updates], 2);
+    XCTAssertEqualObjects(self.votesCount, (@[@2, @0, @0]));
+    XCTAssertEqual(self.sequencer.sequence, 2);
+    XCTAssertTrue(self.sequencer.isSynchronized);
+}
+
+- (void)testReorderedChangesWaitForKeyframe {
+    
+    NSArray *updates = @[[self keyframe:@1 withVotesCount:@[@1, @0, @0]],
+                         [self delta:@3 withChanges:@[@1, @1]],
+                         [self delta:@2 withChanges:@[@0, @1]],
+                         [self delta:@4 withChanges:@[@2, @1]]];
+    
+    XCTAssertEqual([self receiveUpdates:updates], 1);
+    XCTAssertEqualObjects(self.votesCount, (@[@1, @0, @0]));
+    XCTAssertFalse(self.sequencer.isSynchronized);
+    
+    // Keyframe which has been delivered before one of previous changes should be applied.
+    updates = @[[self keyframe:@5 withVotesCount:@[@2, @1, @1]],
+                [self delta:@4 withChanges:@[@2, @1]]];
+    XCTAssertEqual([self receiveUpdates:updates], 1);
+    XCTAssertEqualObjects(self.votesCount, (@[@2, @1, @1]));
+    XCTAssertTrue(self.sequencer.isSynchronized);
+}
+
+
+#pragma mark - Keyframes
+
+- (void)testOutdatedKeyframeIgnored {
+    
+    NSArray *updates = @[[self keyframe:@50 withVotesCount:@[@5, @0, @0]],
+                         [self keyframe:@49 withVotesCount:@[@4, @0, @0]],
+                         [self keyframe:@30 withVotesCount:@[@3, @0, @0]]];
+    
+    XCTAssertEqual([self receiveUpdates:updates], 1);
+    XCTAssertEqualObjects(self.votesCount, (@[@5, @0, @0]));
+    XCTAssertEqual(self.sequencer.sequence, 50);
+}
+
+- (void)testRestartedHostKeyframeAccepted {
+    
+    NSArray *updates = @[[self keyframe:@50 withVotesCount:@[@5, @0, @0]],
+                         [self keyframe:@1 withVotesCount:@[@5, @1, @0]],
+                         [self delta:@2 withChanges:@[@2, @1]]];
+    
+    XCTAssertEqual([self receiveUpdates:updates], 3);
+    XCTAssertEqualObjects(self.votesCount, (@[@5, @1, @1]));
+    XCTAssertEqual(self.sequencer.sequence, 2);
+}
+
+- (void)testKeyframeWithoutSequenceDoesntAllowChanges {
+    
+    NSArray *updates = @[[self keyframe:nil withVotesCount:@[@1, @1, @0]],
+                         [self delta:@1 withChanges:@[@0, @1]],
+                         [self keyframe:nil withVotesCount:@[@1, @2, @0]]];
+    
+    XCTAssertEqual([self receiveUpdates:updates], 2);
+    XCTAssertEqualObjects(self.votesCount, (@[@1, @2, @0]));
+    XCTAssertFalse(self.sequencer.isSynchronized);
+}
+
+- (void)testResetRestoreSynchronizedState {
+    
+    [self.sequencer resetWithSequence:7 synchronized:YES];
+    XCTAssertTrue([self.sequencer acceptChangesWithSequence:@8]);
+    
+    [self.sequencer resetWithSequence:0 synchronized:NO];
+    XCTAssertFalse([self.sequencer acceptChangesWithSequence:@1]);
+    XCTAssertTrue([SPNPStatisticSequencer isSequence:@3 newerThan:2 keyframeInterval:20]);
+    XCTAssertFalse([SPNPStatisticSequencer isSequence:@2 newerThan:2 keyframeInterval:20]);
+    XCTAssertTrue([SPNPStatisticSequencer isSequence:nil newerThan:2 keyframeInterval:20]);
+}
+
+
+#pragma mark - Payload size
+
+- (void)testChangesSmallerThanFullStatistic {
+    
+    NSMutableArray *variants = [NSMutableArray new];
+    for (NSUInteger variantIdx = 0; variantIdx < 8; variantIdx++) {
+        
+        [variants addObject:[NSString stringWithFormat:@"Talk number %@", @(variantIdx)]];
+    }
+    self.poll = [SPNPPoll pollWithQuestion:@"Best talk?" responses:variants];
+    NSMutableArray *votesCount = [NSMutableArray new];
+    for (NSUInteger variantIdx = 0; variantIdx < variants.count; variantIdx++) {
+        
+        [votesCount addObject:@(1000 + variantIdx * 37)];
+    }
+    SPNPPollStatistic *keyframe = [self keyframe:@20 withVotesCount:votesCount];
+    SPNPPollStatisticDelta *delta = [self delta:@21 withChanges:@[@3, @2, @5, @1]];
+    NSDictionary *keyframeMessage = [keyframe dictionaryRepresentation];
+    NSData *keyframeJSON = [NSJSONSerialization dataWithJSONObject:keyframeMessage options:0
+                                                             error:NULL];
+    NSData *deltaJSON = [NSJSONSerialization dataWithJSONObject:[delta dictionaryRepresentation]
+                                                        options:0 error:NULL];
+    NSUInteger keyframeSize = keyframeJSON.length;
+    NSUInteger deltaSize = deltaJSON.length;
+    NSUInteger compactDeltaSize = [delta compactRepresentationForPoll:self.poll.identifier
+                                                                token:self.poll.token].length;
+    
+    XCTAssertLessThan(deltaSize, keyframeSize);
+    XCTAssertLessThan(compactDeltaSize * 10, keyframeSize);
+}
+
+
+#pragma mark - Misc
+
+- (SPNPPollStatistic *)keyframe:(NSNumber *)sequence withVotesCount:(NSArray *)votesCount {
+    
+    NSMutableArray *responses = [NSMutableArray arrayWithCapacity:votesCount.count];
+    [votesCount enumerateObjectsUsingBlock:^(NSNumber *responseVotesCount, NSUInteger responseIdx,
+                                             BOOL *votesCountEnumeratorStop) {
+        
+        SPNPPollResponseStatistic *statistic =
+            [SPNPPollResponseStatistic statisticForResponse:self.poll.responses[responseIdx]];
+        [statistic updateVotesCount:responseVotesCount.unsignedLongLongValue];
+        [responses addObject:statistic];
+    }];
+    SPNPPollStatistic *keyframe = [SPNPPollStatistic statisticForPoll:self.poll
+                                                        withResponses:responses sequence:sequence];
+    NSString *message = [keyframe compactRepresentationForPoll:self.poll.identifier
+                                                         token:self.poll.token];
+    
+    return [SPNPPollStatistic objectFromMessage:message forPoll:self.poll.identifier
+                                          token:self.poll.token];
+}
+
+- (SPNPPollStatisticDelta *)delta:(NSNumber *)sequence withChanges:(NSArray *)changes {
+    
+    SPNPPollStatisticDelta *delta = [SPNPPollStatisticDelta deltaForPoll:self.poll sequence:sequence
+                                                             withChanges:changes];
+    
+    NSString *message = [delta compactRepresentationForPoll:self.poll.identifier
+                                                      token:self.poll.token];
+    
+    return [SPNPPollStatisticDelta objectFromMessage:message forPoll:self.poll.identifier
+                                               token:self.poll.token];
+}
+
+- (NSUInteger)receiveUpdates:(NSArray *)updates {
+    
+    NSUInteger appliedCount = 0;
+    for (id update in updates) {
+        
+        if ([update isKindOfClass:SPNPPollStatisticDelta.class]) {
+            
+            SPNPPollStatisticDelta *delta = update;
+            if ([self.sequencer acceptChangesWithSequence:delta.sequence]) {
+                
+                [delta enumerateChangesUsingBlock:^(NSUInteger order, long long change) {
+                    
+                    self.votesCount[order] = @([self.votesCount[order] longLongValue] + change);
+                }];
+                appliedCount++;
+            }
+        }
+        else if ([self.sequencer acceptKeyframeWithSequence:[update sequence]]) {
+            
+            [self.votesCount removeAllObjects];
+            for (SPNPPollResponseStatistic *statistic in [update responses]) {
+                
+                [self.votesCount addObject:statistic.votesCount];
+            }
+            appliedCount++;
+        }
+    }
+    
+    return appliedCount;
+}
+
+#pragma mark -
+
+
+@end
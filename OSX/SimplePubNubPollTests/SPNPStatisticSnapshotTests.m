@@ -0,0 +1,221 @@
+/**
+ @brief      Tests for immutable poll statistic snapshots.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <XCTest/XCTest.h>
+#import "SPNPPollResponseStatistic.h"
+#import "SPNPStatisticSnapshot.h"
+#import "SPNPPollResponse.h"
+
+
+#pragma mark Interface declaration
+
+@interface SPNPStatisticSnapshotTests : XCTestCase
+
+
+#pragma mark - Properties
+
+/**
+ @brief  Stores reference on list of response statistic instances which is updated in place.
+ */
+@property (nonatomic, strong) NSArray *statistics;
+
+/**
+ @brief      Stores reference on latest snapshot which has been taken from \c statistics.
+ @discussion Property is atomic because it is replaced by writers and read by readers concurrently.
+ */
+@property (atomic, strong) SPNPStatisticSnapshot *snapshot;
+
+
+#pragma mark - Misc
+
+/**
+ @brief      Check whether snapshot content is the same as it has been at the moment of snapshot.
+ @discussion Votes only moved between responses during stress test, so torn snapshot will have
+             different total votes count.
+ 
+ @param snapshot    Reference on snapshot which should be verified.
+ @param votesCount  Overall number of votes which should be stored by snapshot.
+ 
+ @return \c YES in case if snapshot, its statistic copies and their serialized representation
+         store the same votes.
+ */
+- (BOOL)isConsistentSnapshot:(SPNPStatisticSnapshot *)snapshot
+              withVotesCount:(unsigned long long)votesCount;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPStatisticSnapshotTests
+
+
+#pragma mark - Configuration
+
+- (void)setUp {
+    
+    [super setUp];
+    
+    NSMutableArray *statistics = [NSMutableArray new];
+    for (NSUInteger responseIdx = 0; responseIdx < 3; responseIdx++) {
+        
+        NSString *value = [NSString stringWithFormat:@"Response %@", @(responseIdx)];
+        SPNPPollResponse *response = [SPNPPollResponse pollResponseFor:@"poll" withValue:value
+                                                           orderNumber:@(responseIdx)];
+        [statistics addObject:[SPNPPollResponseStatistic statisticForResponse:response]];
+    }
+    self.statistics = statistics;
+}
+
+
+#pragma mark - Snapshot
+
+- (void)testSnapshotCopyCurrentValues {
+    
+    [self.statistics[1] updateVotesCount:2];
+    SPNPStatisticSnapshot *snapshot = [SPNPStatisticSnapshot snapshotOfStatistics:self.statistics
+                                                                 previousSnapshot:nil];
+    
+    XCTAssertEqual(snapshot.version, 1);
+    XCTAssertEqualObjects(snapshot.votesCount, (@[@0, @2, @0]));
+    XCTAssertEqual(snapshot.statistics.count, 3);
+    XCTAssertNotEqual(snapshot.statistics[1], self.statistics[1]);
+    XCTAssertEqualObjects([snapshot.statistics[1] order], @1);
+}
+
+- (void)testSnapshotNotAffectedByLaterUpdates {
+    
+    SPNPStatisticSnapshot *snapshot = [SPNPStatisticSnapshot snapshotOfStatistics:self.statistics
+                                                                 previousSnapshot:nil];
+    [self.statistics[0] updateVotesCount:5];
+    [self.statistics[2] updateVotesCount:1 forNode:@"node-a"];
+    
+    XCTAssertEqualObjects(snapshot.votesCount, (@[@0, @0, @0]));
+    XCTAssertEqualObjects([snapshot.statistics[0] votesCount], @0);
+    XCTAssertNil([snapshot.statistics[2] nodeCounters]);
+}
+
+- (void)testUnchangedStatisticReuseSnapshot {
+    
+    SPNPStatisticSnapshot *snapshot = [SPNPStatisticSnapshot snapshotOfStatistics:self.statistics
+                                                                 previousSnapshot:nil];
+    
+    XCTAssertEqual([SPNPStatisticSnapshot snapshotOfStatistics:self.statistics
+                                              previousSnapshot:snapshot], snapshot);
+}
+
+- (void)testChangedStatisticShareUnchangedCopies {
+    
+    SPNPStatisticSnapshot *snapshot = [SPNPStatisticSnapshot snapshotOfStatistics:self.statistics
+                                                                 previousSnapshot:nil];
+    [self.statistics[1] registerVoice];
+    SPNPStatisticSnapshot *nextSnapshot =
+        [SPNPStatisticSnapshot snapshotOfStatistics:self.statistics previousSnapshot:snapshot];
+    
+    XCTAssertNotEqual(nextSnapshot, snapshot);
+    XCTAssertEqual(nextSnapshot.version, 2);
+    XCTAssertEqualObjects(nextSnapshot.votesCount, (@[@0, @1, @0]));
+    XCTAssertEqual(nextSnapshot.statistics[0], snapshot.statistics[0]);
+    XCTAssertNotEqual(nextSnapshot.statistics[1], snapshot.statistics[1]);
+    XCTAssertEqual(nextSnapshot.statistics[2], snapshot.statistics[2]);
+}
+
+- (void)testChangedResponsesCountTakeNewSnapshot {
+    
+    SPNPStatisticSnapshot *snapshot = [SPNPStatisticSnapshot snapshotOfStatistics:self.statistics
+                                                                 previousSnapshot:nil];
+    NSArray *statistics = [self.statistics subarrayWithRange:NSMakeRange(0, 2)];
+    SPNPStatisticSnapshot *nextSnapshot = [SPNPStatisticSnapshot snapshotOfStatistics:statistics
+                                                                     previousSnapshot:snapshot];
+    
+    XCTAssertEqual(nextSnapshot.version, 2);
+    XCTAssertEqualObjects(nextSnapshot.votesCount, (@[@0, @0]));
+}
+
+
+#pragma mark - Concurrency
+
+- (void)testConcurrentSnapshotsConsistent {
+    
+    for (SPNPPollResponseStatistic *statistic in self.statistics) {
+        
+        [statistic updateVotesCount:1000];
+    }
+    self.snapshot = [SPNPStatisticSnapshot snapshotOfStatistics:self.statistics
+                                               previousSnapshot:nil];
+    dispatch_queue_t ingestQueue = dispatch_queue_create("com.pubnub.poll.test.ingest",
+                                                         DISPATCH_QUEUE_SERIAL);
+    NSUInteger *inconsistentSnapshots = calloc(8, sizeof(NSUInteger));
+    dispatch_apply(8, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t workerIdx) {
+        
+        unsigned long long version = 0;
+        for (NSUInteger iterationIdx = 0; iterationIdx < 5000; iterationIdx++) {
+            
+            if (workerIdx % 2 == 0) {
+                
+                // Statistic updated and snapshot taken on the same queue (like manager do on main).
+                dispatch_sync(ingestQueue, ^{
+                    
+                    [self.statistics[iterationIdx % 3] applyVotesCountChange:-1];
+                    [self.statistics[(iterationIdx + 1) % 3] registerVoice];
+                    self.snapshot = [SPNPStatisticSnapshot snapshotOfStatistics:self.statistics
+                                                               previousSnapshot:self.snapshot];
+                });
+            }
+            else {
+                
+                SPNPStatisticSnapshot *snapshot = self.snapshot;
+                if (snapshot.version < version ||
+                    ![self isConsistentSnapshot:snapshot withVotesCount:3000]) {
+                    
+                    inconsistentSnapshots[workerIdx]++;
+                }
+                version = snapshot.version;
+            }
+        }
+    });
+    
+    NSUInteger inconsistentSnapshotsCount = 0;
+    for (NSUInteger workerIdx = 0; workerIdx < 8; workerIdx++) {
+        
+        inconsistentSnapshotsCount += inconsistentSnapshots[workerIdx];
+    }
+    free(inconsistentSnapshots);
+    XCTAssertEqual(inconsistentSnapshotsCount, 0);
+    XCTAssertEqual(self.snapshot.version, 20001);
+    XCTAssertTrue([self isConsistentSnapshot:self.snapshot withVotesCount:3000]);
+    XCTAssertEqualObjects(self.snapshot.votesCount, [self.statistics valueForKey:@"votesCount"]);
+}
+
+
+#pragma mark - Misc
+
+- (BOOL)isConsistentSnapshot:(SPNPStatisticSnapshot *)snapshot
+              withVotesCount:(unsigned long long)votesCount {
+    
+    BOOL isConsistent = (snapshot.statistics.count == 3 && snapshot.votesCount.count == 3);
+    unsigned long long snapshotVotesCount = 0;
+    for (NSUInteger statisticIdx = 0; isConsistent && statisticIdx < 3; statisticIdx++) {
+        
+        // Snapshot serialized on reader's queue while writers keep updating statistic.
+        SPNPPollResponseStatistic *statistic = snapshot.statistics[statisticIdx];
+        NSDictionary *representation = [statistic dictionaryRepresentation];
+        isConsistent = ([statistic.order isEqualToNumber:@(statisticIdx)] &&
+                        [statistic.votesCount isEqualToNumber:snapshot.votesCount[statisticIdx]] &&
+                        [representation[@"votesCount"] isEqualToNumber:statistic.votesCount]);
+        snapshotVotesCount += statistic.votesCount.unsignedLongLongValue;
+    }
+    
+    return (isConsistent && snapshotVotesCount == votesCount);
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,294 @@
+/**
+ @brief      Tests for contiguous poll statistic store.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <XCTest/XCTest.h>
+#import <malloc/malloc.h>
+#import "SPNPPollResponseStatistic.h"
+#import "SPNPStatisticStore.h"
+#import "SPNPPollResponse.h"
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores number of votes count updates and reads which is done by each iteration benchmark.
+ */
+static NSUInteger const kSPNPTestIterationsCount = 1000000;
+
+
+#pragma mark - Interface declaration
+
+@interface SPNPStatisticStoreTests : XCTestCase
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Create response statistic in the same way as host do for announced poll.
+ 
+ @param orders List of response order numbers (statistic created in the same order).
+ 
+ @return List of \b SPNPPollResponseStatistic instances with \c order * 10 votes.
+ */
+- (NSArray *)statisticsWithOrders:(NSArray *)orders;
+
+/**
+ @brief  Create response statistic for poll with sequential response order numbers.
+ 
+ @param count Number of response variants in poll.
+ 
+ @return List of \b SPNPPollResponseStatistic instances.
+ */
+- (NSArray *)statisticsWithResponsesCount:(NSUInteger)count;
+
+/**
+ @brief  Compute number of bytes which is used by statistic objects graph (w/o shared strings).
+ 
+ @param statistics Reference on list of \b SPNPPollResponseStatistic instances.
+ 
+ @return Number of bytes which has been allocated for list, statistic objects and boxed values.
+ */
+- (NSUInteger)memoryUsageOfStatistics:(NSArray *)statistics;
+
+/**
+ @brief  Measure update and summing of votes count stored by contiguous store.
+ 
+ @param count Number of response variants in poll.
+ */
+- (void)measureStoreIterationWithResponsesCount:(NSUInteger)count;
+
+/**
+ @brief  Measure update and summing of votes count stored by statistic objects.
+ 
+ @param count Number of response variants in poll.
+ */
+- (void)measureStatisticsIterationWithResponsesCount:(NSUInteger)count;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPStatisticStoreTests
+
+
+#pragma mark - Responses
+
+- (void)testResponsesStoredByOrder {
+    
+    SPNPStatisticStore *store = [SPNPStatisticStore
+                                 storeWithStatistics:[self statisticsWithOrders:@[@2, @0, @1]]
+                                             forPoll:@"poll"];
+    
+    XCTAssertEqual(store.count, 3);
+    XCTAssertEqualObjects(store.pollIdentifier, @"poll");
+    XCTAssertEqualObjects([store responseAtIndex:0], @"Response 0");
+    XCTAssertEqualObjects([store responseAtIndex:2], @"Response 2");
+    XCTAssertEqualObjects(store.votesCount, (@[@0, @10, @20]));
+    XCTAssertEqual(store.votesCounts[1], 10);
+    XCTAssertEqual(store.totalVotesCount, 30);
+}
+
+- (void)testNonSequentialOrdersFound {
+    
+    SPNPStatisticStore *store = [SPNPStatisticStore
+                                 storeWithStatistics:[self statisticsWithOrders:@[@5, @0, @2]]
+                                             forPoll:@"poll"];
+    
+    XCTAssertEqual([store indexForOrder:0], 0);
+    XCTAssertEqual([store indexForOrder:2], 1);
+    XCTAssertEqual([store indexForOrder:5], 2);
+    XCTAssertEqual([store indexForOrder:1], NSNotFound);
+    XCTAssertEqual([store indexForOrder:6], NSNotFound);
+    XCTAssertEqual([store orderAtIndex:2], 5);
+    XCTAssertEqual([store votesCountAtIndex:2], 50);
+}
+
+- (void)testOutOfBoundsIndexesIgnored {
+    
+    SPNPStatisticStore *store = [SPNPStatisticStore
+                                 storeWithStatistics:[self statisticsWithResponsesCount:2]
+                                             forPoll:@"poll"];
+    
+    XCTAssertEqual([store orderAtIndex:2], NSNotFound);
+    XCTAssertNil([store responseAtIndex:2]);
+    XCTAssertEqual([store votesCountAtIndex:2], 0);
+    XCTAssertFalse([store setVotesCount:5 atIndex:2]);
+    XCTAssertEqual(store.totalVotesCount, 10);
+}
+
+- (void)testStringsShared {
+    
+    NSString *identifier = [NSString stringWithFormat:@"%@", @"poll-identifier"];
+    SPNPStatisticStore *store = [SPNPStatisticStore
+                                 storeWithStatistics:[self statisticsWithResponsesCount:2]
+                                             forPoll:identifier];
+    SPNPStatisticStore *otherStore = [SPNPStatisticStore
+                                      storeWithStatistics:[self statisticsWithResponsesCount:2]
+                                                  forPoll:[identifier mutableCopy]];
+    
+    XCTAssertEqual(store.pollIdentifier, otherStore.pollIdentifier);
+    XCTAssertEqual([store responseAtIndex:1], [otherStore responseAtIndex:1]);
+}
+
+
+#pragma mark - Votes
+
+- (void)testUpdateReturnChangedIndexes {
+    
+    SPNPStatisticStore *store = [SPNPStatisticStore
+                                 storeWithStatistics:[self statisticsWithResponsesCount:3]
+                                             forPoll:@"poll"];
+    NSIndexSet *changedIndexes = [store updateWithVotesCount:@[@0, @11, @25]];
+    
+    XCTAssertEqualObjects(changedIndexes,
+                          [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(1, 2)]);
+    XCTAssertEqual(store.totalVotesCount, 36);
+    XCTAssertEqual([store updateWithVotesCount:@[@0, @11, @25]].count, 0);
+    XCTAssertNil([store updateWithVotesCount:@[@0, @11]]);
+    XCTAssertFalse([store setVotesCount:11 atIndex:1]);
+    XCTAssertTrue([store setVotesCount:1 atIndex:1]);
+    XCTAssertEqual(store.totalVotesCount, 26);
+}
+
+- (void)testStoreUseLessMemoryThanStatistics {
+    
+    for (NSNumber *count in @[@10, @100, @1000]) {
+        
+        NSArray *statistics = [self statisticsWithResponsesCount:count.unsignedIntegerValue];
+        SPNPStatisticStore *store = [SPNPStatisticStore storeWithStatistics:statistics
+                                                                    forPoll:@"poll"];
+        
+        XCTAssertEqual(store.memoryUsage, count.unsignedIntegerValue *
+                       (sizeof(unsigned long long) + sizeof(NSUInteger) + sizeof(id)));
+        XCTAssertLessThan(store.memoryUsage, [self memoryUsageOfStatistics:statistics]);
+    }
+}
+
+
+#pragma mark - Performance
+
+- (void)testStoreIterationPerformanceWith10Responses {
+    
+    [self measureStoreIterationWithResponsesCount:10];
+}
+
+- (void)testStatisticsIterationPerformanceWith10Responses {
+    
+    [self measureStatisticsIterationWithResponsesCount:10];
+}
+
+- (void)testStoreIterationPerformanceWith100Responses {
+    
+    [self measureStoreIterationWithResponsesCount:100];
+}
+
+- (void)testStatisticsIterationPerformanceWith100Responses {
+    
+    [self measureStatisticsIterationWithResponsesCount:100];
+}
+
+- (void)testStoreIterationPerformanceWith1000Responses {
+    
+    [self measureStoreIterationWithResponsesCount:1000];
+}
+
+- (void)testStatisticsIterationPerformanceWith1000Responses {
+    
+    [self measureStatisticsIterationWithResponsesCount:1000];
+}
+
+
+#pragma mark - Misc
+
+- (NSArray *)statisticsWithOrders:(NSArray *)orders {
+    
+    NSMutableArray *statistics = [NSMutableArray arrayWithCapacity:orders.count];
+    for (NSNumber *order in orders) {
+        
+        NSString *value = [NSString stringWithFormat:@"Response %@", order];
+        SPNPPollResponse *response = [SPNPPollResponse pollResponseFor:@"poll" withValue:value
+                                                           orderNumber:order];
+        SPNPPollResponseStatistic *statistic = [SPNPPollResponseStatistic
+                                                statisticForResponse:response];
+        [statistic updateVotesCount:(order.unsignedLongLongValue * 10)];
+        [statistics addObject:statistic];
+    }
+    
+    return [statistics copy];
+}
+
+- (NSArray *)statisticsWithResponsesCount:(NSUInteger)count {
+    
+    NSMutableArray *orders = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger responseIdx = 0; responseIdx < count; responseIdx++) {
+        
+        [orders addObject:@(responseIdx)];
+    }
+    
+    return [self statisticsWithOrders:orders];
+}
+
+- (NSUInteger)memoryUsageOfStatistics:(NSArray *)statistics {
+    
+    // Small boxed numbers are tagged pointers, so there is no allocation to count.
+    NSUInteger memoryUsage = malloc_size((__bridge const void *)statistics);
+    for (SPNPPollResponseStatistic *statistic in statistics) {
+        
+        memoryUsage += malloc_size((__bridge const void *)statistic);
+        memoryUsage += malloc_size((__bridge const void *)statistic.order);
+        memoryUsage += malloc_size((__bridge const void *)statistic.votesCount);
+    }
+    
+    return memoryUsage;
+}
+
+- (void)measureStoreIterationWithResponsesCount:(NSUInteger)count {
+    
+    SPNPStatisticStore *store = [SPNPStatisticStore
+                                 storeWithStatistics:[self statisticsWithResponsesCount:count]
+                                             forPoll:@"poll"];
+    [self measureBlock:^{
+        
+        unsigned long long votesCount = 0;
+        for (NSUInteger roundIdx = 0; roundIdx < kSPNPTestIterationsCount / count; roundIdx++) {
+            
+            [store setVotesCount:roundIdx atIndex:(roundIdx % count)];
+            const unsigned long long *votesCounts = store.votesCounts;
+            for (NSUInteger responseIdx = 0; responseIdx < count; responseIdx++) {
+                
+                votesCount += votesCounts[responseIdx];
+            }
+        }
+        XCTAssertGreaterThan(votesCount, 0);
+    }];
+}
+
+- (void)measureStatisticsIterationWithResponsesCount:(NSUInteger)count {
+    
+    NSArray *statistics = [self statisticsWithResponsesCount:count];
+    [self measureBlock:^{
+        
+        unsigned long long votesCount = 0;
+        for (NSUInteger roundIdx = 0; roundIdx < kSPNPTestIterationsCount / count; roundIdx++) {
+            
+            [statistics[roundIdx % count] updateVotesCount:roundIdx];
+            for (SPNPPollResponseStatistic *statistic in statistics) {
+                
+                votesCount += statistic.votesCount.unsignedLongLongValue;
+            }
+        }
+        XCTAssertGreaterThan(votesCount, 0);
+    }];
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,476 @@
+/**
+ @brief      Tests for host side votes aggregation.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <XCTest/XCTest.h>
+#import "SPNPVoteAggregator.h"
+#import "SPNPPollResponse.h"
+#import "SPNPVoterIndex.h"
+#import "SPNPVoteTrace.h"
+#import "SPNPMetrics.h"
+#import "SPNPPoll.h"
+
+
+#pragma mark Interface declaration
+
+@interface SPNPVoteAggregatorTests : XCTestCase
+
+
+#pragma mark - Properties
+
+@property (nonatomic, strong) SPNPVoteAggregator *aggregator;
+@property (nonatomic, strong) SPNPPoll *poll;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Construct attendee's vote message in compact representation.
+ 
+ @param order Order number of response which has been chosen by attendee.
+ @param poll  Reference on poll for which vote should be constructed.
+ 
+ @return Compact representation of attendee's vote.
+ */
+- (NSString *)vote:(NSUInteger)order inPoll:(SPNPPoll *)poll;
+
+/**
+ @brief      Construct attendee's sampled vote message in compact representation.
+ @discussion Voter identifier in payload ignored by aggregator (voter reported by transport used).
+ 
+ @param order     Order number of response which has been chosen by attendee.
+ @param traceTime Reference on time when attendee sent vote.
+ 
+ @return Compact representation of attendee's vote with trace stamp.
+ */
+- (NSString *)vote:(NSUInteger)order withTraceTime:(NSNumber *)traceTime;
+
+/**
+ @brief      Wait till all scheduled votes will be counted by aggregator.
+ @discussion Merge of empty recount complete only after shards processed all batches which has been
+             scheduled before it.
+ */
+- (void)waitForAggregatedVotes;
+
+/**
+ @brief  Measure time which is required to aggregate votes from unique voters.
+ 
+ @param votesCount  Number of votes which should be aggregated.
+ @param shardsCount Number of answer shards which is used by poll.
+ @param batchSize   Maximum number of votes which is collected into single batch.
+ */
+- (void)measureAggregationOfVotes:(NSUInteger)votesCount inShards:(NSUInteger)shardsCount
+                        batchSize:(NSUInteger)batchSize;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPVoteAggregatorTests
+
+
+#pragma mark - Configuration
+
+- (void)setUp {
+    
+    [super setUp];
+    
+    self.poll = [SPNPPoll pollWithQuestion:@"Best talk?"
+                                 responses:@[@"First", @"Second", @"Third"]];
+    self.aggregator = [SPNPVoteAggregator new];
+    self.aggregator.maximumBatchSize = 4;
+    [self.aggregator resetForPoll:self.poll withVotesCount:@[@0, @0, @0]];
+}
+
+
+#pragma mark - Aggregation
+
+- (void)testBatchedVotesCounted {
+    
+    for (NSUInteger voterIdx = 0; voterIdx < 10; voterIdx++) {
+        
+        [self.aggregator registerVoteFromMessage:[self vote:(voterIdx % 3) inPoll:self.poll]
+                                       fromVoter:[NSUUID UUID].UUIDString];
+    }
+    [self waitForAggregatedVotes];
+    
+    XCTAssertEqualObjects([self.aggregator votesCountIfChanged], (@[@4, @3, @3]));
+    XCTAssertNil([self.aggregator votesCountIfChanged]);
+}
+
+- (void)testDictionaryAndCompactVotesCounted {
+    
+    SPNPPollResponse *vote = [SPNPPollResponse pollResponseFor:self.poll.identifier
+                                                     withValue:@"Third" orderNumber:@2];
+    [self.aggregator registerVoteFromMessage:[vote dictionaryRepresentation] fromVoter:@"first"];
+    [self.aggregator registerVoteFromMessage:[self vote:2 inPoll:self.poll]
+                                   fromVoter:@"second"];
+    [self waitForAggregatedVotes];
+    
+    XCTAssertEqualObjects([self.aggregator votesCountIfChanged], (@[@0, @0, @2]));
+}
+
+- (void)testRepeatedVotesIgnoredByDefault {
+    
+    NSString *voter = [NSUUID UUID].UUIDString;
+    [self.aggregator registerVoteFromMessage:[self vote:0 inPoll:self.poll] fromVoter:voter];
+    [self.aggregator registerVoteFromMessage:[self vote:1 inPoll:self.poll] fromVoter:voter];
+    [self.aggregator registerVoteFromMessage:[self vote:1 inPoll:self.poll] fromVoter:nil];
+    [self waitForAggregatedVotes];
+    
+    XCTAssertEqualObjects([self.aggregator votesCountIfChanged], (@[@1, @0, @0]));
+}
+
+- (void)testChangedVoteMovedToLatestChoice {
+    
+    NSString *voter = [NSUUID UUID].UUIDString;
+    self.aggregator.allowsVoteChange = YES;
+    [self.aggregator registerVoteFromMessage:[self vote:0 inPoll:self.poll] fromVoter:voter];
+    [self.aggregator registerVoteFromMessage:[self vote:2 inPoll:self.poll] fromVoter:voter];
+    [self waitForAggregatedVotes];
+    
+    XCTAssertEqualObjects([self.aggregator votesCountIfChanged], (@[@0, @0, @1]));
+}
+
+- (void)testVotesForOtherPollAndUnknownResponseIgnored {
+    
+    SPNPPoll *otherPoll = [SPNPPoll pollWithQuestion:@"Other" responses:@[@"First", @"Second"]];
+    [self.aggregator registerVoteFromMessage:[self vote:0 inPoll:otherPoll]
+                                   fromVoter:@"first"];
+    [self.aggregator registerVoteFromMessage:[self vote:7 inPoll:self.poll]
+                                   fromVoter:@"second"];
+    [self.aggregator registerVoteFromMessage:@{@"pollIdentifier": self.poll.identifier}
+                                   fromVoter:@"third"];
+    [self waitForAggregatedVotes];
+    
+    XCTAssertNil([self.aggregator votesCountIfChanged]);
+}
+
+- (void)testResetCountPendingVotesForPreviousPoll {
+    
+    [self.aggregator registerVoteFromMessage:[self vote:1 inPoll:self.poll]
+                                   fromVoter:@"first"];
+    SPNPPoll *nextPoll = [SPNPPoll pollWithQuestion:@"Next" responses:@[@"First", @"Second"]];
+    [self.aggregator resetForPoll:nextPoll withVotesCount:@[@5, @2]];
+    [self.aggregator registerVoteFromMessage:[self vote:1 inPoll:self.poll]
+                                   fromVoter:@"second"];
+    [self.aggregator registerVoteFromMessage:[self vote:0 inPoll:nextPoll]
+                                   fromVoter:@"second"];
+    self.poll = nextPoll;
+    [self waitForAggregatedVotes];
+    
+    XCTAssertEqualObjects([self.aggregator votesCountIfChanged], (@[@6, @2]));
+}
+
+- (void)testVotesCountedWhenVotersIndexFull {
+    
+    SPNPMetrics *metrics = [SPNPMetrics metrics];
+    self.aggregator.metrics = metrics;
+    [self.aggregator resetForPoll:self.poll withVotesCount:@[@0, @0, @0]
+                           voters:[SPNPVoterIndex indexWithMaximumCount:2]];
+    for (NSUInteger voterIdx = 0; voterIdx < 5; voterIdx++) {
+        
+        NSString *voter = [NSString stringWithFormat:@"voter-%@", @(voterIdx)];
+        [self.aggregator registerVoteFromMessage:[self vote:(voterIdx % 3) inPoll:self.poll]
+                                       fromVoter:voter];
+    }
+    
+    // Repeated vote of tracked voter still ignored.
+    [self.aggregator registerVoteFromMessage:[self vote:2 inPoll:self.poll]
+                                   fromVoter:@"voter-0"];
+    [self waitForAggregatedVotes];
+    
+    NSDictionary *counters = [metrics snapshot][@"counters"];
+    XCTAssertEqualObjects([self.aggregator votesCountIfChanged], (@[@2, @2, @1]));
+    XCTAssertEqualObjects(counters[@"countedVotes"], @5);
+    XCTAssertEqualObjects(counters[@"untrackedVotes"], @3);
+    XCTAssertEqualObjects(counters[@"droppedVotes"], @0);
+}
+
+
+#pragma mark - Tracing
+
+- (void)testSampledVotesTraced {
+    
+    NSNumber *sentTime = @1450000000000;
+    NSNumber *startTime = [SPNPVoteTrace currentTime];
+    [self.aggregator registerVoteFromMessage:[self vote:1 withTraceTime:sentTime]
+                                   fromVoter:@"sampled"];
+    [self.aggregator registerVoteFromMessage:[self vote:2 inPoll:self.poll]
+                                   fromVoter:@"unsampled"];
+    [self waitForAggregatedVotes];
+    
+    NSArray *traces = [self.aggregator dequeueVoteTraces];
+    SPNPVoteTrace *trace = traces.firstObject;
+    XCTAssertEqual(traces.count, 1);
+    uint64_t voterKey = [SPNPVoterIndex keyForVoter:@"sampled"];
+    XCTAssertEqualObjects(trace.voterKey, [SPNPVoteTrace traceKeyForVoterKey:voterKey]);
+    XCTAssertEqualObjects(trace.sentTime, sentTime);
+    XCTAssertGreaterThanOrEqual(trace.receivedTime.doubleValue, startTime.doubleValue);
+    XCTAssertGreaterThanOrEqual(trace.aggregatedTime.doubleValue, trace.receivedTime.doubleValue);
+    XCTAssertNil(trace.publishedTime);
+    XCTAssertNil([self.aggregator dequeueVoteTraces]);
+}
+
+- (void)testRepeatedSampledVoteNotTraced {
+    
+    [self.aggregator registerVoteFromMessage:[self vote:1 withTraceTime:@1] fromVoter:@"sampled"];
+    [self.aggregator registerVoteFromMessage:[self vote:2 withTraceTime:@2] fromVoter:@"sampled"];
+    [self waitForAggregatedVotes];
+    
+    // Only votes which affect counters reported back to attendee.
+    NSArray *traces = [self.aggregator dequeueVoteTraces];
+    XCTAssertEqual(traces.count, 1);
+    XCTAssertEqualObjects([traces.firstObject sentTime], @1);
+}
+
+- (void)testPendingTracesBounded {
+    
+    for (NSUInteger voterIdx = 0; voterIdx < 100; voterIdx++) {
+        
+        [self.aggregator registerVoteFromMessage:[self vote:0 withTraceTime:@(voterIdx + 1)]
+                                       fromVoter:[NSString stringWithFormat:@"voter-%@",
+                                                  @(voterIdx)]];
+    }
+    [self waitForAggregatedVotes];
+    
+    XCTAssertEqualObjects([self.aggregator votesCountIfChanged], (@[@100, @0, @0]));
+    XCTAssertEqual([self.aggregator dequeueVoteTraces].count, 32);
+}
+
+- (void)testTracesOfPreviousPollDropped {
+    
+    [self.aggregator registerVoteFromMessage:[self vote:0 withTraceTime:@1] fromVoter:@"first"];
+    [self waitForAggregatedVotes];
+    SPNPPoll *nextPoll = [SPNPPoll pollWithQuestion:@"Next" responses:@[@"First", @"Second"]];
+    [self.aggregator resetForPoll:nextPoll withVotesCount:@[@0, @0]];
+    
+    XCTAssertNil([self.aggregator dequeueVoteTraces]);
+}
+
+
+#pragma mark - Shards
+
+- (void)testVoterAssignedToSingleShard {
+    
+    SPNPPoll *poll = [SPNPPoll pollWithQuestion:@"Best talk?" responses:@[@"First", @"Second"]
+                                   answerShards:4];
+    NSMutableIndexSet *usedShards = [NSMutableIndexSet new];
+    for (NSUInteger voterIdx = 0; voterIdx < 1000; voterIdx++) {
+        
+        uint64_t key = [SPNPVoterIndex keyForVoter:[NSUUID UUID].UUIDString];
+        NSUInteger shardIdx = [poll answerShardForVoterKey:key];
+        XCTAssertLessThan(shardIdx, 4);
+        XCTAssertEqual([poll answerShardForVoterKey:key], shardIdx);
+        XCTAssertEqual([self.poll answerShardForVoterKey:key], 0);
+        [usedShards addIndex:shardIdx];
+    }
+    XCTAssertEqual(usedShards.count, 4);
+}
+
+- (void)testVotesFromAssignedShardsMerged {
+    
+    SPNPMetrics *metrics = [SPNPMetrics metrics];
+    self.poll = [SPNPPoll pollWithQuestion:@"Best talk?"
+                                 responses:@[@"First", @"Second", @"Third"] answerShards:4];
+    self.aggregator.metrics = metrics;
+    [self.aggregator resetForPoll:self.poll withVotesCount:@[@0, @0, @0]];
+    for (NSUInteger voterIdx = 0; voterIdx < 40; voterIdx++) {
+        
+        NSString *voter = [NSString stringWithFormat:@"voter-%@", @(voterIdx)];
+        NSString *vote = [self vote:(voterIdx % 3) inPoll:self.poll];
+        NSUInteger shardIdx = [self.poll answerShardForVoterKey:[SPNPVoterIndex keyForVoter:voter]];
+        [self.aggregator registerVoteFromMessage:vote fromVoter:voter inShard:shardIdx];
+        
+        // Same vote sent through shard channel of other voters should be dropped.
+        [self.aggregator registerVoteFromMessage:vote fromVoter:voter
+                                         inShard:((shardIdx + 1) % 4)];
+    }
+    [self.aggregator registerVoteFromMessage:[self vote:0 inPoll:self.poll] fromVoter:nil
+                                     inShard:0];
+    [self waitForAggregatedVotes];
+    
+    XCTAssertEqualObjects([self.aggregator votesCountIfChanged], (@[@14, @13, @13]));
+    XCTAssertEqualObjects([metrics snapshot][@"counters"][@"droppedVotes"], @41);
+}
+
+- (void)testRecountedVotesMergedIntoShards {
+    
+    self.poll = [SPNPPoll pollWithQuestion:@"Best talk?"
+                                 responses:@[@"First", @"Second", @"Third"] answerShards:4];
+    [self.aggregator resetForPoll:self.poll withVotesCount:@[@0, @0, @0]];
+    SPNPVoterIndex *recountedVoters = [SPNPVoterIndex indexWithMaximumCount:100];
+    for (NSUInteger voterIdx = 0; voterIdx < 12; voterIdx++) {
+        
+        NSString *voter = [NSString stringWithFormat:@"voter-%@", @(voterIdx)];
+        [recountedVoters registerChoice:(voterIdx % 2) forVoter:voter replacingExisting:NO];
+    }
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Recount merge"];
+    [self.aggregator mergeRecountedVotesCount:@[@6, @6, @0] voters:recountedVoters
+                               withCompletion:^{ [expectation fulfill]; }];
+    [self waitForExpectationsWithTimeout:5.0f handler:nil];
+    
+    // Attendees which has been recounted can't vote again and only new attendee counted.
+    for (NSUInteger voterIdx = 0; voterIdx < 13; voterIdx++) {
+        
+        NSString *voter = [NSString stringWithFormat:@"voter-%@", @(voterIdx)];
+        NSUInteger shardIdx = [self.poll answerShardForVoterKey:[SPNPVoterIndex keyForVoter:voter]];
+        [self.aggregator registerVoteFromMessage:[self vote:2 inPoll:self.poll] fromVoter:voter
+                                         inShard:shardIdx];
+    }
+    [self waitForAggregatedVotes];
+    
+    XCTAssertEqualObjects([self.aggregator votesCountIfChanged], (@[@6, @6, @1]));
+}
+
+
+#pragma mark - Formats
+
+- (void)testMixedFormatVotesCountedByConcurrentShards {
+    
+    SPNPMetrics *metrics = [SPNPMetrics metrics];
+    self.poll = [SPNPPoll pollWithQuestion:@"Best talk?"
+                                 responses:@[@"First", @"Second", @"Third"] answerShards:4];
+    self.aggregator.metrics = metrics;
+    self.aggregator.maximumBatchSize = 16;
+    [self.aggregator resetForPoll:self.poll withVotesCount:@[@0, @0, @0]];
+    for (NSUInteger voterIdx = 0; voterIdx < 3000; voterIdx++) {
+        
+        NSString *voter = [NSString stringWithFormat:@"voter-%@", @(voterIdx)];
+        NSUInteger order = (voterIdx % 3);
+        id vote = [self vote:order inPoll:self.poll];
+        
+        // Attendees without compact encoding support send votes as dictionaries.
+        if (voterIdx % 2) {
+            
+            NSString *value = [self.poll.responses[order] response];
+            vote = [[SPNPPollResponse pollResponseFor:self.poll.identifier withValue:value
+                                          orderNumber:@(order)] dictionaryRepresentation];
+        }
+        NSUInteger shardIdx = [self.poll answerShardForVoterKey:[SPNPVoterIndex keyForVoter:voter]];
+        [self.aggregator registerVoteFromMessage:vote fromVoter:voter inShard:shardIdx];
+    }
+    [self waitForAggregatedVotes];
+    
+    XCTAssertEqualObjects([self.aggregator votesCountIfChanged], (@[@1000, @1000, @1000]));
+    XCTAssertEqualObjects([metrics snapshot][@"counters"][@"countedVotes"], @3000);
+}
+
+
+#pragma mark - Performance
+
+- (void)testAggregationThroughputPerformance {
+    
+    [self measureAggregationOfVotes:10000 inShards:4 batchSize:128];
+}
+
+- (void)testSingleShardAggregationPerformance {
+    
+    [self measureAggregationOfVotes:40000 inShards:1 batchSize:128];
+}
+
+- (void)testTwoShardsAggregationPerformance {
+    
+    [self measureAggregationOfVotes:40000 inShards:2 batchSize:128];
+}
+
+- (void)testFourShardsAggregationPerformance {
+    
+    [self measureAggregationOfVotes:40000 inShards:4 batchSize:128];
+}
+
+- (void)testEightShardsAggregationPerformance {
+    
+    [self measureAggregationOfVotes:40000 inShards:8 batchSize:128];
+}
+
+- (void)testBatchedVotesAggregationPerformance {
+    
+    [self measureAggregationOfVotes:10000 inShards:1 batchSize:128];
+}
+
+- (void)testPerMessageVotesAggregationPerformance {
+    
+    // Batch of single message is the same as previous per-message processing.
+    [self measureAggregationOfVotes:10000 inShards:1 batchSize:1];
+}
+
+#pragma mark - Misc
+
+- (NSString *)vote:(NSUInteger)order inPoll:(SPNPPoll *)poll {
+    
+    SPNPPollResponse *response = [SPNPPollResponse pollResponseFor:poll.identifier withValue:@""
+                                                       orderNumber:@(order)];
+    
+    return [response compactRepresentationForPoll:poll.identifier token:poll.token];
+}
+
+- (NSString *)vote:(NSUInteger)order withTraceTime:(NSNumber *)traceTime {
+    
+    SPNPPollResponse *response = [SPNPPollResponse pollResponseFor:self.poll.identifier
+                                                         withValue:@"" orderNumber:@(order)
+                                                             voter:@"attendee"
+                                                         traceTime:traceTime];
+    
+    return [response compactRepresentationForPoll:self.poll.identifier token:self.poll.token];
+}
+
+- (void)waitForAggregatedVotes {
+    
+    NSMutableArray *votesCount = [NSMutableArray arrayWithCapacity:self.poll.responses.count];
+    for (NSUInteger responseIdx = 0; responseIdx < self.poll.responses.count; responseIdx++) {
+        
+        [votesCount addObject:@0];
+    }
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Votes aggregation"];
+    [self.aggregator mergeRecountedVotesCount:votesCount
+                                       voters:[SPNPVoterIndex indexWithMaximumCount:1]
+                               withCompletion:^{ [expectation fulfill]; }];
+    [self waitForExpectationsWithTimeout:5.0f handler:nil];
+}
+
+- (void)measureAggregationOfVotes:(NSUInteger)votesCount inShards:(NSUInteger)shardsCount
+                        batchSize:(NSUInteger)batchSize {
+    
+    self.poll = [SPNPPoll pollWithQuestion:@"Best talk?"
+                                 responses:@[@"First", @"Second", @"Third"]
+                              answerShards:shardsCount];
+    self.aggregator.maximumBatchSize = batchSize;
+    NSMutableArray *voters = [NSMutableArray arrayWithCapacity:votesCount];
+    NSMutableArray *votes = [NSMutableArray arrayWithCapacity:votesCount];
+    NSMutableArray *shards = [NSMutableArray arrayWithCapacity:votesCount];
+    NSUInteger expectedVotes[3] = {0, 0, 0};
+    for (NSUInteger voterIdx = 0; voterIdx < votesCount; voterIdx++) {
+        
+        NSString *voter = [NSString stringWithFormat:@"voter-%@", @(voterIdx)];
+        uint64_t voterKey = [SPNPVoterIndex keyForVoter:voter];
+        [voters addObject:voter];
+        [votes addObject:[self vote:(voterIdx % 3) inPoll:self.poll]];
+        [shards addObject:@([self.poll answerShardForVoterKey:voterKey])];
+        expectedVotes[voterIdx % 3]++;
+    }
+    NSArray *expectedVotesCount = @[@(expectedVotes[0]), @(expectedVotes[1]), @(expectedVotes[2])];
+    
+    [self measureBlock:^{
+        
+        [self.aggregator resetForPoll:self.poll withVotesCount:@[@0, @0, @0]];
+        for (NSUInteger voterIdx = 0; voterIdx < votesCount; voterIdx++) {
+            
+            [self.aggregator registerVoteFromMessage:votes[voterIdx] fromVoter:voters[voterIdx]
+                                             inShard:[shards[voterIdx] unsignedIntegerValue]];
+        }
+        [self waitForAggregatedVotes];
+        XCTAssertEqualObjects([self.aggregator votesCountIfChanged], expectedVotesCount);
+    }];
+}
+
+#pragma mark -
+
+
+@end
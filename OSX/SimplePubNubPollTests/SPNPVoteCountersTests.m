@@ -0,0 +1,199 @@
+/**
+ @brief      Tests for sharded votes counters.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <XCTest/XCTest.h>
+#import "SPNPVoteCounters.h"
+
+
+#pragma mark Interface declaration
+
+@interface SPNPVoteCountersTests : XCTestCase
+
+
+#pragma mark - Properties
+
+@property (nonatomic, strong) SPNPVoteCounters *counters;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Count votes from concurrent writers (one for each shard).
+ 
+ @param votesCount  Number of votes which should be counted by each writer.
+ @param shardsCount Number of shards which is used by writers.
+ @param batchSize   Number of votes which writer register with single update.
+ */
+- (void)countVotes:(NSUInteger)votesCount inShards:(NSUInteger)shardsCount
+         batchSize:(NSUInteger)batchSize;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPVoteCountersTests
+
+
+#pragma mark - Configuration
+
+- (void)setUp {
+    
+    [super setUp];
+    
+    self.counters = [SPNPVoteCounters countersWithVotesCount:@[@3, @2, @1] shardsCount:4];
+}
+
+
+#pragma mark - Counters
+
+- (void)testInitialVotesCountMerged {
+    
+    XCTAssertEqual(self.counters.count, 3);
+    XCTAssertEqual(self.counters.shardsCount, 4);
+    XCTAssertEqual([self.counters votesCountAtIndex:0], 3);
+    XCTAssertEqual([self.counters votesCountAtIndex:2], 1);
+    XCTAssertEqual([self.counters votesCountAtIndex:3], 0);
+    XCTAssertEqual([self.counters registeredVotesCount], 0);
+}
+
+- (void)testChangesFromShardsMerged {
+    
+    int64_t firstChanges[3] = {1, 0, 2};
+    int64_t secondChanges[3] = {-1, 1, 0};
+    [self.counters applyChanges:firstChanges registeringVotes:3 inShard:1];
+    [self.counters applyChanges:secondChanges registeringVotes:1 inShard:3];
+    
+    // Changes of unknown shard and changes without registered votes ignored.
+    [self.counters applyChanges:firstChanges registeringVotes:3 inShard:4];
+    [self.counters applyChanges:firstChanges registeringVotes:0 inShard:0];
+    
+    XCTAssertEqual([self.counters votesCountAtIndex:0], 3);
+    XCTAssertEqual([self.counters votesCountAtIndex:1], 3);
+    XCTAssertEqual([self.counters votesCountAtIndex:2], 3);
+    XCTAssertEqual([self.counters registeredVotesCount], 4);
+}
+
+- (void)testEmptyCounters {
+    
+    SPNPVoteCounters *counters = [SPNPVoteCounters countersWithVotesCount:nil shardsCount:0];
+    [counters applyChanges:NULL registeringVotes:1 inShard:0];
+    
+    XCTAssertEqual(counters.count, 0);
+    XCTAssertEqual(counters.shardsCount, 1);
+    XCTAssertEqual([counters votesCountAtIndex:0], 0);
+    XCTAssertEqual([counters registeredVotesCount], 1);
+}
+
+
+#pragma mark - Concurrency
+
+- (void)testConcurrentWritersCountedExactly {
+    
+    self.counters = [SPNPVoteCounters countersWithVotesCount:@[@0, @0, @0] shardsCount:8];
+    [self countVotes:30000 inShards:8 batchSize:3];
+    
+    XCTAssertEqual([self.counters votesCountAtIndex:0], 80000);
+    XCTAssertEqual([self.counters votesCountAtIndex:1], 80000);
+    XCTAssertEqual([self.counters votesCountAtIndex:2], 80000);
+    XCTAssertEqual([self.counters registeredVotesCount], 240000);
+}
+
+- (void)testReaderObserveCountedVotes {
+    
+    self.counters = [SPNPVoteCounters countersWithVotesCount:@[@0, @0, @0] shardsCount:4];
+    BOOL isConsistent = YES;
+    dispatch_group_t group = dispatch_group_create();
+    dispatch_queue_t queue = dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0);
+    dispatch_group_async(group, queue, ^{
+        
+        [self countVotes:30000 inShards:4 batchSize:3];
+    });
+    
+    // Changes published before registered votes count, so merged counters never fall behind it
+    // and registered votes count never decrease.
+    uint64_t previousRegisteredVotes = 0;
+    while (dispatch_group_wait(group, DISPATCH_TIME_NOW) != 0) {
+        
+        uint64_t registeredVotes = [self.counters registeredVotesCount];
+        uint64_t countedVotes = 0;
+        for (NSUInteger counterIdx = 0; counterIdx < self.counters.count; counterIdx++) {
+            
+            countedVotes += [self.counters votesCountAtIndex:counterIdx];
+        }
+        isConsistent &= (registeredVotes >= previousRegisteredVotes &&
+                         countedVotes >= registeredVotes);
+        previousRegisteredVotes = registeredVotes;
+    }
+    
+    XCTAssertTrue(isConsistent);
+    XCTAssertEqual([self.counters registeredVotesCount], 120000);
+}
+
+
+#pragma mark - Performance
+
+- (void)testShardedCountersThroughputPerformance {
+    
+    [self measureBlock:^{
+        
+        self.counters = [SPNPVoteCounters countersWithVotesCount:@[@0, @0, @0] shardsCount:8];
+        [self countVotes:300000 inShards:8 batchSize:1];
+        XCTAssertEqual([self.counters registeredVotesCount], 2400000);
+    }];
+}
+
+- (void)testSingleShardCountersThroughputPerformance {
+    
+    [self measureBlock:^{
+        
+        self.counters = [SPNPVoteCounters countersWithVotesCount:@[@0, @0, @0] shardsCount:1];
+        NSUInteger writersCount = 8;
+        dispatch_apply(writersCount, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0),
+                       ^(size_t writerIdx) {
+            
+            int64_t changes[3] = {0, 0, 0};
+            for (NSUInteger voteIdx = 0; voteIdx < 300000; voteIdx++) {
+                
+                changes[voteIdx % 3] = 1;
+                [self.counters applyChanges:changes registeringVotes:1 inShard:0];
+                changes[voteIdx % 3] = 0;
+            }
+        });
+        XCTAssertEqual([self.counters registeredVotesCount], 2400000);
+    }];
+}
+
+
+#pragma mark - Misc
+
+- (void)countVotes:(NSUInteger)votesCount inShards:(NSUInteger)shardsCount
+         batchSize:(NSUInteger)batchSize {
+    
+    SPNPVoteCounters *counters = self.counters;
+    dispatch_apply(shardsCount, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0),
+                   ^(size_t shardIdx) {
+        
+        int64_t changes[3] = {0, 0, 0};
+        for (NSUInteger voteIdx = 0; voteIdx < votesCount; voteIdx++) {
+            
+            changes[voteIdx % 3]++;
+            if ((voteIdx + 1) % batchSize == 0) {
+                
+                [counters applyChanges:changes registeringVotes:batchSize inShard:shardIdx];
+                memset(changes, 0, sizeof(changes));
+            }
+        }
+    });
+}
+
+#pragma mark -
+
+
+@end
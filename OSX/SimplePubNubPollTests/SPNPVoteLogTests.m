@@ -0,0 +1,190 @@
+/**
+ @brief      Tests for durable votes log and host state restore.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <XCTest/XCTest.h>
+#import "SPNPVoteAggregator.h"
+#import "SPNPPollResponse.h"
+#import "SPNPVoterIndex.h"
+#import "SPNPVoteLog.h"
+#import "SPNPPoll.h"
+
+
+#pragma mark Interface declaration
+
+@interface SPNPVoteLogTests : XCTestCase
+
+
+#pragma mark - Properties
+
+@property (nonatomic, copy) NSString *path;
+@property (nonatomic, strong) SPNPPoll *poll;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPVoteLogTests
+
+
+#pragma mark - Configuration
+
+- (void)setUp {
+    
+    [super setUp];
+    
+    NSString *name = [[NSUUID UUID].UUIDString stringByAppendingPathExtension:@"votes"];
+    self.path = [NSTemporaryDirectory() stringByAppendingPathComponent:name];
+    self.poll = [SPNPPoll pollWithQuestion:@"Best talk?"
+                                 responses:@[@"First", @"Second", @"Third"]];
+}
+
+- (void)tearDown {
+    
+    [[SPNPVoteLog logWithPath:self.path] startForPoll:nil withVotesCount:nil];
+    
+    [super tearDown];
+}
+
+
+#pragma mark - Replay
+
+- (void)testRestoreReplayRecords {
+    
+    uint64_t firstVoter = [SPNPVoterIndex keyForVoter:@"first"];
+    uint64_t secondVoter = [SPNPVoterIndex keyForVoter:@"second"];
+    SPNPVoteLog *log = [SPNPVoteLog logWithPath:self.path];
+    [log startForPoll:self.poll withVotesCount:@[@1, @0, @0]];
+    [log appendChoice:0 previousChoice:NSNotFound forVoter:firstVoter];
+    [log appendChoice:2 previousChoice:NSNotFound forVoter:secondVoter];
+    [log appendChoice:1 previousChoice:0 forVoter:firstVoter];
+    [log appendChoice:2 previousChoice:NSNotFound forVoter:0];
+    XCTAssertEqual(log.recordsCount, 4);
+    
+    NSArray *votesCount = nil;
+    SPNPVoterIndex *voters = [SPNPVoterIndex indexWithMaximumCount:100];
+    SPNPVoteLog *restoredLog = [SPNPVoteLog logWithPath:self.path];
+    SPNPPoll *poll = [restoredLog restoreVotesCount:&votesCount voters:voters];
+    XCTAssertEqualObjects(poll.identifier, self.poll.identifier);
+    XCTAssertEqualObjects(votesCount, (@[@1, @1, @2]));
+    XCTAssertEqual(voters.count, 2);
+    XCTAssertEqual([voters choiceForVoter:@"first"], 1);
+    XCTAssertEqual([voters choiceForVoter:@"second"], 2);
+    XCTAssertEqual(restoredLog.recordsCount, 4);
+}
+
+- (void)testRecordsBeforeSnapshotNotCountedTwice {
+    
+    SPNPVoteLog *log = [SPNPVoteLog logWithPath:self.path];
+    log.snapshotInterval = 2;
+    [log startForPoll:self.poll withVotesCount:@[@0, @0, @0]];
+    for (NSUInteger voterIdx = 0; voterIdx < 5; voterIdx++) {
+        
+        [log appendChoice:(voterIdx % 3) previousChoice:NSNotFound forVoter:(voterIdx + 1)];
+    }
+    
+    NSArray *votesCount = nil;
+    SPNPVoteLog *restoredLog = [SPNPVoteLog logWithPath:self.path];
+    [restoredLog restoreVotesCount:&votesCount voters:[SPNPVoterIndex indexWithMaximumCount:100]];
+    XCTAssertEqualObjects(votesCount, (@[@2, @2, @1]));
+    
+    [restoredLog appendChoice:2 previousChoice:NSNotFound forVoter:6];
+    SPNPVoteLog *secondRestoredLog = [SPNPVoteLog logWithPath:self.path];
+    [secondRestoredLog restoreVotesCount:&votesCount
+                                  voters:[SPNPVoterIndex indexWithMaximumCount:100]];
+    XCTAssertEqualObjects(votesCount, (@[@2, @2, @2]));
+}
+
+- (void)testDamagedSnapshotRejected {
+    
+    SPNPVoteLog *log = [SPNPVoteLog logWithPath:self.path];
+    [log startForPoll:self.poll withVotesCount:@[@0, @0, @0]];
+    [log appendChoice:0 previousChoice:NSNotFound forVoter:1];
+    NSString *snapshotPath = [self.path stringByAppendingPathExtension:@"snapshot"];
+    [[NSData dataWithBytes:"damaged" length:7] writeToFile:snapshotPath atomically:YES];
+    
+    NSArray *votesCount = nil;
+    SPNPVoteLog *restoredLog = [SPNPVoteLog logWithPath:self.path];
+    XCTAssertNil([restoredLog restoreVotesCount:&votesCount
+                                         voters:[SPNPVoterIndex indexWithMaximumCount:100]]);
+    XCTAssertNil(votesCount);
+}
+
+- (void)testRemovedLogNotRestored {
+    
+    SPNPVoteLog *log = [SPNPVoteLog logWithPath:self.path];
+    [log startForPoll:self.poll withVotesCount:@[@0, @0, @0]];
+    [log appendChoice:0 previousChoice:NSNotFound forVoter:1];
+    [log startForPoll:nil withVotesCount:nil];
+    
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:self.path]);
+    XCTAssertNil([[SPNPVoteLog logWithPath:self.path] restoreVotesCount:NULL voters:nil]);
+}
+
+
+#pragma mark - Aggregation
+
+- (void)testAggregatorRestoreCountedVotes {
+    
+    SPNPVoteAggregator *aggregator = [SPNPVoteAggregator new];
+    aggregator.voteLog = [SPNPVoteLog logWithPath:self.path];
+    [aggregator resetForPoll:self.poll withVotesCount:@[@0, @0, @0]];
+    for (NSUInteger voterIdx = 0; voterIdx < 6; voterIdx++) {
+        
+        SPNPPollResponse *vote = [SPNPPollResponse pollResponseFor:self.poll.identifier
+                                                         withValue:@"" orderNumber:@(voterIdx % 2)];
+        [aggregator registerVoteFromMessage:[vote dictionaryRepresentation]
+                                  fromVoter:[NSString stringWithFormat:@"voter-%@", @(voterIdx)]];
+    }
+    
+    // Single shard use log queue, so records written by the time when merge of empty recount
+    // completes.
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Votes aggregation"];
+    [aggregator mergeRecountedVotesCount:@[@0, @0, @0]
+                                  voters:[SPNPVoterIndex indexWithMaximumCount:1]
+                          withCompletion:^{ [expectation fulfill]; }];
+    [self waitForExpectationsWithTimeout:5.0f handler:nil];
+    
+    NSArray *votesCount = nil;
+    SPNPVoteAggregator *restoredAggregator = [SPNPVoteAggregator new];
+    restoredAggregator.voteLog = [SPNPVoteLog logWithPath:self.path];
+    SPNPPoll *poll = [restoredAggregator restoreFromVoteLogWithVotesCount:&votesCount];
+    XCTAssertEqualObjects(poll.identifier, self.poll.identifier);
+    XCTAssertEqualObjects(votesCount, (@[@3, @3, @0]));
+}
+
+
+#pragma mark - Performance
+
+- (void)testMillionVotesLogRestorePerformance {
+    
+    SPNPVoteLog *log = [SPNPVoteLog logWithPath:self.path];
+    [log startForPoll:self.poll withVotesCount:@[@0, @0, @0]];
+    for (NSUInteger voterIdx = 0; voterIdx < 1000000; voterIdx++) {
+        
+        [log appendChoice:(voterIdx % 3) previousChoice:NSNotFound forVoter:(voterIdx + 1)];
+    }
+    
+    [self measureBlock:^{
+        
+        NSArray *votesCount = nil;
+        NSUInteger maximumVotersCount = kSPNPVoterIndexMaximumVotersCount;
+        SPNPVoterIndex *voters = [SPNPVoterIndex indexWithMaximumCount:maximumVotersCount];
+        SPNPVoteLog *restoredLog = [SPNPVoteLog logWithPath:self.path];
+        SPNPPoll *poll = [restoredLog restoreVotesCount:&votesCount voters:voters];
+        XCTAssertEqualObjects(poll.identifier, self.poll.identifier);
+        XCTAssertEqualObjects(votesCount, (@[@333334, @333333, @333333]));
+        XCTAssertEqual(voters.count, 1000000);
+    }];
+}
+
+#pragma mark -
+
+
+@end
@@ -0,0 +1,271 @@
+/**
+ @brief      Tests for per-response votes time series.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <XCTest/XCTest.h>
+#import "SPNPVoteTimeSeries.h"
+
+
+#pragma mark Static
+
+/**
+ @brief  Stores time at which tested series start (beginning of hour since reference date).
+ */
+static NSTimeInterval const kSPNPTestStartTime = 3600.0f;
+
+
+#pragma mark - Interface declaration
+
+@interface SPNPVoteTimeSeriesTests : XCTestCase
+
+
+#pragma mark - Properties
+
+@property (nonatomic, strong) SPNPVoteTimeSeries *series;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Record votes which has been received with same rate during specified period of time.
+ 
+ @param rate  Number of votes which has been received each second.
+ @param order Order of response variant for which votes should be recorded.
+ @param start Time at which first vote has been received.
+ @param end   Time after which there was no more votes.
+ */
+- (void)recordVotesWithRate:(NSUInteger)rate forResponse:(NSUInteger)order
+                       from:(NSTimeInterval)start till:(NSTimeInterval)end;
+
+/**
+ @brief  Compute overall votes change from response series.
+ 
+ @param order      Order of response variant in poll.
+ @param resolution One of \b SPNPVoteTimeSeriesResolution fields.
+ @param time       Reference date based time which is covered by newest bucket.
+ 
+ @return Sum of votes changes in all buckets of specified resolution.
+ */
+- (long long)votesForResponse:(NSUInteger)order
+               withResolution:(SPNPVoteTimeSeriesResolution)resolution atTime:(NSTimeInterval)time;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPVoteTimeSeriesTests
+
+
+#pragma mark - Configuration
+
+- (void)setUp {
+    
+    [super setUp];
+    
+    self.series = [SPNPVoteTimeSeries seriesWithResponsesCount:2];
+}
+
+
+#pragma mark - Buckets
+
+- (void)testChangesStoredInSecondBuckets {
+    
+    [self.series recordChange:1 forResponse:0 atTime:kSPNPTestStartTime];
+    [self.series recordChange:2 forResponse:0 atTime:(kSPNPTestStartTime + 0.999f)];
+    [self.series recordChange:4 forResponse:0 atTime:(kSPNPTestStartTime + 1.0f)];
+    [self.series recordChange:-1 forResponse:1 atTime:(kSPNPTestStartTime + 1.5f)];
+    
+    NSArray *series = [self.series seriesForResponse:0
+                                      withResolution:SPNPVoteTimeSeriesSecondResolution
+                                              atTime:(kSPNPTestStartTime + 1.5f)];
+    XCTAssertEqual(series.count, 60);
+    XCTAssertEqualObjects([series subarrayWithRange:NSMakeRange(57, 3)], (@[@0, @3, @4]));
+    NSArray *trend = [self.series trendAtTime:(kSPNPTestStartTime + 1.5f)];
+    XCTAssertEqual(trend.count, 2);
+    XCTAssertEqualObjects(trend.firstObject, series);
+    XCTAssertEqualObjects([trend.lastObject lastObject], @-1);
+}
+
+- (void)testChangesStoredInCoarserBuckets {
+    
+    [self.series recordChange:3 forResponse:0 atTime:(kSPNPTestStartTime + 59.5f)];
+    [self.series recordChange:2 forResponse:0 atTime:(kSPNPTestStartTime + 60.0f)];
+    
+    NSArray *minutes = [self.series seriesForResponse:0
+                                       withResolution:SPNPVoteTimeSeriesMinuteResolution
+                                               atTime:(kSPNPTestStartTime + 60.0f)];
+    NSArray *hours = [self.series seriesForResponse:0
+                                     withResolution:SPNPVoteTimeSeriesHourResolution
+                                             atTime:(kSPNPTestStartTime + 60.0f)];
+    XCTAssertEqual(minutes.count, 60);
+    XCTAssertEqualObjects([minutes subarrayWithRange:NSMakeRange(58, 2)], (@[@3, @2]));
+    XCTAssertEqual(hours.count, 24);
+    XCTAssertEqualObjects(hours.lastObject, @5);
+}
+
+- (void)testUnknownResponseIgnored {
+    
+    [self.series recordChange:1 forResponse:2 atTime:kSPNPTestStartTime];
+    
+    XCTAssertNil([self.series seriesForResponse:2
+                                 withResolution:SPNPVoteTimeSeriesSecondResolution
+                                         atTime:kSPNPTestStartTime]);
+    XCTAssertNil([self.series seriesForResponse:0 withResolution:3 atTime:kSPNPTestStartTime]);
+    XCTAssertEqual([self.series rateForResponse:2 overInterval:1.0f atTime:kSPNPTestStartTime], 0);
+}
+
+
+#pragma mark - Rollup and eviction
+
+- (void)testOldSecondsRolledIntoMinutes {
+    
+    [self.series recordChange:3 forResponse:0 atTime:(kSPNPTestStartTime + 0.5f)];
+    [self.series recordChange:2 forResponse:0 atTime:(kSPNPTestStartTime + 10.0f)];
+    NSTimeInterval time = (kSPNPTestStartTime + 130.0f);
+    
+    // Per-second buckets dropped, but their votes still counted by minute and hour buckets.
+    NSArray *minutes = [self.series seriesForResponse:0
+                                       withResolution:SPNPVoteTimeSeriesMinuteResolution
+                                               atTime:time];
+    XCTAssertEqual([self votesForResponse:0 withResolution:SPNPVoteTimeSeriesSecondResolution
+                                   atTime:time], 0);
+    XCTAssertEqualObjects([minutes subarrayWithRange:NSMakeRange(57, 3)], (@[@5, @0, @0]));
+    XCTAssertEqual([self votesForResponse:0 withResolution:SPNPVoteTimeSeriesHourResolution
+                                   atTime:time], 5);
+}
+
+- (void)testExpiredBucketsEvicted {
+    
+    [self.series recordChange:5 forResponse:0 atTime:(kSPNPTestStartTime + 0.5f)];
+    
+    NSTimeInterval time = (kSPNPTestStartTime + 3700.0f);
+    XCTAssertEqual([self votesForResponse:0 withResolution:SPNPVoteTimeSeriesMinuteResolution
+                                   atTime:time], 0);
+    XCTAssertEqual([self votesForResponse:0 withResolution:SPNPVoteTimeSeriesHourResolution
+                                   atTime:time], 5);
+    
+    time = (kSPNPTestStartTime + 25.0f * 3600.0f);
+    XCTAssertEqual([self votesForResponse:0 withResolution:SPNPVoteTimeSeriesHourResolution
+                                   atTime:time], 0);
+}
+
+- (void)testReusedBucketsCleared {
+    
+    [self.series recordChange:5 forResponse:0 atTime:(kSPNPTestStartTime + 0.5f)];
+    [self.series recordChange:1 forResponse:0 atTime:(kSPNPTestStartTime + 60.5f)];
+    
+    // Second bucket which has been used minute ago reused for new second.
+    NSArray *seconds = [self.series seriesForResponse:0
+                                       withResolution:SPNPVoteTimeSeriesSecondResolution
+                                               atTime:(kSPNPTestStartTime + 60.5f)];
+    XCTAssertEqual([self votesForResponse:0 withResolution:SPNPVoteTimeSeriesSecondResolution
+                                   atTime:(kSPNPTestStartTime + 60.5f)], 1);
+    XCTAssertEqualObjects(seconds.lastObject, @1);
+}
+
+- (void)testChangesOlderThanResolutionWindowIgnored {
+    
+    [self.series recordChange:1 forResponse:0 atTime:(kSPNPTestStartTime + 130.0f)];
+    [self.series recordChange:5 forResponse:0 atTime:(kSPNPTestStartTime + 0.5f)];
+    
+    NSTimeInterval time = (kSPNPTestStartTime + 130.0f);
+    XCTAssertEqual([self votesForResponse:0 withResolution:SPNPVoteTimeSeriesSecondResolution
+                                   atTime:time], 1);
+    XCTAssertEqual([self votesForResponse:0 withResolution:SPNPVoteTimeSeriesMinuteResolution
+                                   atTime:time], 6);
+}
+
+- (void)testMemoryUsageDoesntGrow {
+    
+    NSUInteger memoryUsage = self.series.memoryUsage;
+    [self recordVotesWithRate:2 forResponse:0 from:kSPNPTestStartTime
+                         till:(kSPNPTestStartTime + 2.0f * 3600.0f)];
+    
+    XCTAssertEqual(self.series.memoryUsage, memoryUsage);
+    XCTAssertEqual(memoryUsage, (60 + 60 + 24) * 2 * sizeof(long long) + 2 * sizeof(double));
+}
+
+- (void)testResetForgetChanges {
+    
+    [self.series recordChange:5 forResponse:0 atTime:(kSPNPTestStartTime + 0.5f)];
+    [self.series reset];
+    
+    XCTAssertEqual([self votesForResponse:0 withResolution:SPNPVoteTimeSeriesHourResolution
+                                   atTime:(kSPNPTestStartTime + 0.5f)], 0);
+    XCTAssertEqual([self.series averageRateForResponse:0 atTime:(kSPNPTestStartTime + 5.0f)], 0);
+}
+
+
+#pragma mark - Trend
+
+- (void)testWindowedRate {
+    
+    [self recordVotesWithRate:10 forResponse:0 from:kSPNPTestStartTime
+                         till:(kSPNPTestStartTime + 10.0f)];
+    [self recordVotesWithRate:2 forResponse:1 from:kSPNPTestStartTime
+                         till:(kSPNPTestStartTime + 10.0f)];
+    NSTimeInterval time = (kSPNPTestStartTime + 10.0f);
+    
+    XCTAssertEqualWithAccuracy([self.series rateForResponse:0 overInterval:5.0f atTime:time],
+                               10.0f, 0.001f);
+    XCTAssertEqualWithAccuracy([self.series rateForResponse:1 overInterval:5.0f atTime:time],
+                               2.0f, 0.001f);
+    
+    // Long windows computed from minute buckets.
+    time = (kSPNPTestStartTime + 299.0f);
+    XCTAssertEqualWithAccuracy([self.series rateForResponse:0 overInterval:300.0f atTime:time],
+                               100.0f / 299.0f, 0.001f);
+    XCTAssertEqual([self.series rateForResponse:0 overInterval:5.0f atTime:time], 0);
+}
+
+- (void)testMovingAverageFollowActivity {
+    
+    [self recordVotesWithRate:10 forResponse:0 from:kSPNPTestStartTime
+                         till:(kSPNPTestStartTime + 100.0f)];
+    
+    XCTAssertEqualWithAccuracy([self.series averageRateForResponse:0
+                                                            atTime:(kSPNPTestStartTime + 100.0f)],
+                               10.0f, 0.1f);
+    XCTAssertEqual([self.series averageRateForResponse:1 atTime:(kSPNPTestStartTime + 100.0f)], 0);
+    XCTAssertEqualWithAccuracy([self.series averageRateForResponse:0
+                                                            atTime:(kSPNPTestStartTime + 200.0f)],
+                               0.0f, 0.1f);
+}
+
+
+#pragma mark - Misc
+
+- (void)recordVotesWithRate:(NSUInteger)rate forResponse:(NSUInteger)order
+                       from:(NSTimeInterval)start till:(NSTimeInterval)end {
+    
+    NSUInteger votesCount = (NSUInteger)((end - start) * rate);
+    for (NSUInteger voteIdx = 0; voteIdx < votesCount; voteIdx++) {
+        
+        [self.series recordChange:1 forResponse:order
+                           atTime:(start + (NSTimeInterval)voteIdx / (NSTimeInterval)rate)];
+    }
+}
+
+- (long long)votesForResponse:(NSUInteger)order
+               withResolution:(SPNPVoteTimeSeriesResolution)resolution atTime:(NSTimeInterval)time {
+    
+    long long votes = 0;
+    for (NSNumber *change in [self.series seriesForResponse:order withResolution:resolution
+                                                     atTime:time]) {
+        
+        votes += change.longLongValue;
+    }
+    
+    return votes;
+}
+
+#pragma mark -
+
+
+@end
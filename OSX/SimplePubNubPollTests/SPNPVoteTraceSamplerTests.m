@@ -0,0 +1,239 @@
+/**
+ @brief      Tests for attendee's votes end-to-end tracing sampler.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <XCTest/XCTest.h>
+#import "SPNPVoteTraceSampler.h"
+#import "SPNPVoterIndex.h"
+#import "SPNPVoteTrace.h"
+#import "SPNPMetrics.h"
+
+
+#pragma mark Interface declaration
+
+@interface SPNPVoteTraceSamplerTests : XCTestCase
+
+
+#pragma mark - Properties
+
+@property (nonatomic, strong) SPNPVoteTraceSampler *sampler;
+@property (nonatomic, strong) SPNPMetrics *metrics;
+
+/**
+ @brief  Stores fingerprint of attendee which sample votes.
+ */
+@property (nonatomic, assign) uint64_t voterKey;
+
+
+#pragma mark - Misc
+
+/**
+ @brief  Count votes which has been sampled by sampler.
+ 
+ @param votesCount Number of votes which is sent by attendee.
+ 
+ @return Number of votes which should carry trace stamp.
+ */
+- (NSUInteger)sampledVotesFrom:(NSUInteger)votesCount;
+
+/**
+ @brief  Sample vote with send time which is different from previously sampled votes.
+ 
+ @return Send time of sampled vote.
+ */
+- (NSNumber *)sampleUniqueVote;
+
+/**
+ @brief  Construct trace which has been sent by host for sampled vote.
+ 
+ @param sentTime Reference on time when attendee sent vote.
+ @param voterKey Fingerprint of attendee which sent vote.
+ 
+ @return Trace with host stamps which is 10, 15 and 40 milliseconds after \c sentTime.
+ */
+- (SPNPVoteTrace *)traceForVoteSentAt:(NSNumber *)sentTime byVoter:(uint64_t)voterKey;
+
+/**
+ @brief  Retrieve snapshot of single latency histogram.
+ 
+ @param name Name of latency histogram in metrics snapshot.
+ 
+ @return Histogram values in microseconds.
+ */
+- (NSDictionary *)latencyWithName:(NSString *)name;
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPVoteTraceSamplerTests
+
+
+#pragma mark - Configuration
+
+- (void)setUp {
+    
+    [super setUp];
+    
+    self.sampler = [SPNPVoteTraceSampler samplerWithMaximumTracesCount:4];
+    self.metrics = [SPNPMetrics metrics];
+    self.voterKey = [SPNPVoterIndex keyForVoter:@"attendee"];
+}
+
+
+#pragma mark - Sampling
+
+- (void)testSamplingDisabledByDefault {
+    
+    XCTAssertEqual(self.sampler.sampleRate, 0);
+    XCTAssertEqual([self sampledVotesFrom:1000], 0);
+    XCTAssertEqual(self.sampler.pendingTracesCount, 0);
+}
+
+- (void)testAllVotesSampledWithFullRate {
+    
+    self.sampler.sampleRate = 1.0f;
+    
+    XCTAssertEqual([self sampledVotesFrom:1000], 1000);
+}
+
+- (void)testVotesSampledWithConfiguredRate {
+    
+    self.sampler.sampleRate = 0.1f;
+    
+    // Standard deviation for 100000 votes is about 95 sampled votes.
+    XCTAssertEqualWithAccuracy((double)[self sampledVotesFrom:100000], 10000.0f, 600.0f);
+}
+
+- (void)testPendingTracesBounded {
+    
+    self.sampler.sampleRate = 1.0f;
+    NSMutableArray *sentTimes = [NSMutableArray new];
+    for (NSUInteger voteIdx = 0; voteIdx < 6; voteIdx++) {
+        
+        [sentTimes addObject:[self sampleUniqueVote]];
+    }
+    
+    // Oldest sampled votes dropped, so their traces won't be recorded.
+    XCTAssertEqual(self.sampler.pendingTracesCount, 4);
+    NSArray *traces = @[[self traceForVoteSentAt:sentTimes.firstObject byVoter:self.voterKey],
+                        [self traceForVoteSentAt:sentTimes.lastObject byVoter:self.voterKey]];
+    XCTAssertEqual([self.sampler recordLatencyOfTraces:traces forVoterKey:self.voterKey
+                                                atTime:[SPNPVoteTrace currentTime]
+                                             inMetrics:self.metrics], 1);
+    XCTAssertEqual(self.sampler.pendingTracesCount, 3);
+}
+
+- (void)testResetForgetSampledVotes {
+    
+    self.sampler.sampleRate = 1.0f;
+    NSNumber *sentTime = [self sampleUniqueVote];
+    [self.sampler reset];
+    
+    XCTAssertEqual(self.sampler.pendingTracesCount, 0);
+    XCTAssertEqual([self.sampler recordLatencyOfTraces:@[[self traceForVoteSentAt:sentTime
+                                                                          byVoter:self.voterKey]]
+                                           forVoterKey:self.voterKey atTime:sentTime
+                                             inMetrics:self.metrics], 0);
+}
+
+
+#pragma mark - Latency
+
+- (void)testLatencyComponentsRecordedFromTrace {
+    
+    self.sampler.sampleRate = 1.0f;
+    NSNumber *sentTime = [self sampleUniqueVote];
+    NSArray *traces = @[[self traceForVoteSentAt:sentTime byVoter:self.voterKey]];
+    NSNumber *time = @(sentTime.unsignedLongLongValue + 100);
+    XCTAssertEqual([self.sampler recordLatencyOfTraces:traces forVoterKey:self.voterKey
+                                                atTime:time inMetrics:self.metrics], 1);
+    
+    // Transport latency is visible latency without time which vote spent on host.
+    XCTAssertEqualWithAccuracy([[self latencyWithName:@"voteVisible"][@"max"] doubleValue],
+                               100000.0f, 1.0f);
+    XCTAssertEqualWithAccuracy([[self latencyWithName:@"voteIngest"][@"max"] doubleValue],
+                               5000.0f, 1.0f);
+    XCTAssertEqualWithAccuracy([[self latencyWithName:@"votePublishInterval"][@"max"] doubleValue],
+                               25000.0f, 1.0f);
+    XCTAssertEqualWithAccuracy([[self latencyWithName:@"voteTransport"][@"max"] doubleValue],
+                               70000.0f, 1.0f);
+    XCTAssertEqual(self.sampler.pendingTracesCount, 0);
+}
+
+- (void)testTraceRecordedOnce {
+    
+    self.sampler.sampleRate = 1.0f;
+    NSNumber *sentTime = [self sampleUniqueVote];
+    NSArray *traces = @[[self traceForVoteSentAt:sentTime byVoter:self.voterKey]];
+    [self.sampler recordLatencyOfTraces:traces forVoterKey:self.voterKey atTime:sentTime
+                              inMetrics:self.metrics];
+    
+    // Same trace can be sent with both keyframe and delta.
+    XCTAssertEqual([self.sampler recordLatencyOfTraces:traces forVoterKey:self.voterKey
+                                                atTime:sentTime inMetrics:self.metrics], 0);
+    XCTAssertEqualObjects([self latencyWithName:@"voteVisible"][@"count"], @1);
+}
+
+- (void)testOtherTracesIgnored {
+    
+    self.sampler.sampleRate = 1.0f;
+    NSNumber *sentTime = [self sampleUniqueVote];
+    uint64_t otherVoterKey = [SPNPVoterIndex keyForVoter:@"other"];
+    NSArray *traces = @[[self traceForVoteSentAt:sentTime byVoter:otherVoterKey],
+                        [self traceForVoteSentAt:@(sentTime.unsignedLongLongValue + 1)
+                                         byVoter:self.voterKey]];
+    
+    XCTAssertEqual([self.sampler recordLatencyOfTraces:traces forVoterKey:self.voterKey
+                                                atTime:sentTime inMetrics:self.metrics], 0);
+    XCTAssertEqual(self.sampler.pendingTracesCount, 1);
+    XCTAssertEqualObjects([self latencyWithName:@"voteVisible"][@"count"], @0);
+}
+
+
+#pragma mark - Misc
+
+- (NSUInteger)sampledVotesFrom:(NSUInteger)votesCount {
+    
+    NSUInteger sampledVotesCount = 0;
+    for (NSUInteger voteIdx = 0; voteIdx < votesCount; voteIdx++) {
+        
+        if ([self.sampler traceTimeForVote]) { sampledVotesCount++; }
+        XCTAssertLessThanOrEqual(self.sampler.pendingTracesCount, 4);
+    }
+    
+    return sampledVotesCount;
+}
+
+- (NSNumber *)sampleUniqueVote {
+    
+    // Send time has millisecond precision.
+    NSNumber *sentTime = [SPNPVoteTrace currentTime];
+    while ([[SPNPVoteTrace currentTime] isEqualToNumber:sentTime]) { usleep(100); }
+    
+    return [self.sampler traceTimeForVote];
+}
+
+- (SPNPVoteTrace *)traceForVoteSentAt:(NSNumber *)sentTime byVoter:(uint64_t)voterKey {
+    
+    unsigned long long time = sentTime.unsignedLongLongValue;
+    
+    return [SPNPVoteTrace traceForVoterKey:voterKey sentTime:sentTime receivedTime:@(time + 10)
+                            aggregatedTime:@(time + 15) publishedTime:@(time + 40)];
+}
+
+- (NSDictionary *)latencyWithName:(NSString *)name {
+    
+    return self.metrics.snapshot[@"latencies"][name];
+}
+
+#pragma mark -
+
+
+@end
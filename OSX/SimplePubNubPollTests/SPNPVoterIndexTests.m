@@ -0,0 +1,123 @@
+/**
+ @brief      Tests for attendees votes index.
+ 
+ @author Sergey Mamontov
+ @copyright © 2009-2015 PubNub, Inc.
+ */
+#import <XCTest/XCTest.h>
+#import "SPNPVoterIndex.h"
+
+
+#pragma mark Interface declaration
+
+@interface SPNPVoterIndexTests : XCTestCase
+
+#pragma mark -
+
+
+@end
+
+
+#pragma mark - Interface implementation
+
+@implementation SPNPVoterIndexTests
+
+
+#pragma mark - Fingerprints
+
+- (void)testUUIDFingerprintIgnoreCaseAndMatchBinaryRepresentation {
+    
+    NSUUID *uuid = [NSUUID UUID];
+    uuid_t bytes;
+    [uuid getUUIDBytes:bytes];
+    uint64_t key = [SPNPVoterIndex keyForVoter:uuid.UUIDString];
+    XCTAssertNotEqual(key, 0);
+    XCTAssertEqual([SPNPVoterIndex keyForVoter:uuid.UUIDString.lowercaseString], key);
+    XCTAssertEqual([SPNPVoterIndex keyForVoterBytes:bytes length:sizeof(uuid_t) isUUID:YES], key);
+    XCTAssertNotEqual([SPNPVoterIndex keyForVoter:[NSUUID UUID].UUIDString], key);
+}
+
+- (void)testStringFingerprintMatchUTF8Representation {
+    
+    NSString *voter = @"attendee-42";
+    const char *bytes = voter.UTF8String;
+    uint64_t key = [SPNPVoterIndex keyForVoter:voter];
+    XCTAssertEqual([SPNPVoterIndex keyForVoterBytes:(const uint8_t *)bytes length:strlen(bytes)
+                                             isUUID:NO], key);
+    XCTAssertNotEqual([SPNPVoterIndex keyForVoter:@"attendee-43"], key);
+}
+
+
+#pragma mark - Voters
+
+- (void)testFirstVoteRegistered {
+    
+    SPNPVoterIndex *index = [SPNPVoterIndex indexWithMaximumCount:100];
+    XCTAssertEqual([index choiceForVoter:@"voter"], NSNotFound);
+    XCTAssertEqual([index registerChoice:2 forVoter:@"voter" replacingExisting:NO], NSNotFound);
+    XCTAssertEqual([index choiceForVoter:@"voter"], 2);
+    XCTAssertEqual(index.count, 1);
+}
+
+- (void)testRepeatedVoteKeepOrReplaceChoice {
+    
+    SPNPVoterIndex *index = [SPNPVoterIndex indexWithMaximumCount:100];
+    [index registerChoice:2 forVoter:@"voter" replacingExisting:NO];
+    XCTAssertEqual([index registerChoice:5 forVoter:@"voter" replacingExisting:NO], 2);
+    XCTAssertEqual([index choiceForVoter:@"voter"], 2);
+    XCTAssertEqual([index registerChoice:5 forVoter:@"voter" replacingExisting:YES], 2);
+    XCTAssertEqual([index choiceForVoter:@"voter"], 5);
+    XCTAssertEqual(index.count, 1);
+}
+
+- (void)testIndexGrowKeepRegisteredChoices {
+    
+    NSUInteger votersCount = 5000;
+    SPNPVoterIndex *index = [SPNPVoterIndex indexWithMaximumCount:votersCount];
+    NSUInteger initialMemoryUsage = index.memoryUsage;
+    for (NSUInteger voterIdx = 0; voterIdx < votersCount; voterIdx++) {
+        
+        NSString *voter = [NSString stringWithFormat:@"voter-%@", @(voterIdx)];
+        XCTAssertEqual([index registerChoice:(voterIdx % 7) forVoter:voter replacingExisting:NO],
+                       NSNotFound);
+    }
+    XCTAssertEqual(index.count, votersCount);
+    XCTAssertGreaterThan(index.memoryUsage, initialMemoryUsage);
+    for (NSUInteger voterIdx = 0; voterIdx < votersCount; voterIdx++) {
+        
+        NSString *voter = [NSString stringWithFormat:@"voter-%@", @(voterIdx)];
+        XCTAssertEqual([index choiceForVoter:voter], (voterIdx % 7));
+    }
+    
+    __block NSUInteger enumeratedCount = 0;
+    __block NSUInteger choicesSum = 0;
+    [index enumerateChoicesUsingBlock:^(uint64_t key, NSUInteger choice) {
+        
+        enumeratedCount++;
+        choicesSum += choice;
+    }];
+    NSUInteger expectedSum = 0;
+    for (NSUInteger voterIdx = 0; voterIdx < votersCount; voterIdx++) {
+        
+        expectedSum += (voterIdx % 7);
+    }
+    XCTAssertEqual(enumeratedCount, votersCount);
+    XCTAssertEqual(choicesSum, expectedSum);
+}
+
+- (void)testFullIndexRejectNewVoters {
+    
+    SPNPVoterIndex *index = [SPNPVoterIndex indexWithMaximumCount:10];
+    for (NSUInteger voterIdx = 0; voterIdx < 10; voterIdx++) {
+        
+        [index registerChoice:0 forKey:(voterIdx + 1) replacingExisting:NO];
+    }
+    XCTAssertEqual([index registerChoice:0 forKey:100 replacingExisting:NO], kSPNPVoterIndexFull);
+    XCTAssertEqual([index registerChoice:1 forKey:1 replacingExisting:YES], 0);
+    XCTAssertEqual(index.count, 10);
+}
+
+#pragma mark -
+
+
+@end
@@ -1,6 +1,11 @@
 #import <WatchKit/WatchKit.h>
 
 
+#pragma mark Class forward
+
+@class SPNPPoll;
+
+
 /**
  @brief  Class describes bar based chart controller.
  
@@ -10,6 +15,17 @@
 @interface SPNPBarChartController : WKInterfaceController
 
 
+///------------------------------------------------
+/// @name Configuration
+///------------------------------------------------
+
+/**
+ @brief  Prepare resources which is required to show chart for poll (bar title images).
+ 
+ @param poll Reference on announced poll which statistic will be shown.
+ */
++ (void)prepareForPoll:(SPNPPoll *)poll;
+
 #pragma mark -
 
 
@@ -4,6 +4,8 @@
  */
 #import "SPNPBarChartController.h"
 #import "SPNPPollResponseStatistic.h"
+#import "SPNPStatisticPresenter.h"
+#import "SPNPStatisticSnapshot.h"
 #import "SPNPBarChartLegendCell.h"
 #import "SPNPPollResponse.h"
 #import "SPNPChartBarView.h"
@@ -84,9 +86,11 @@ static NSString * const kSPNPBarChartLegendCell = @"SPNPBarChartLegendCell";
 @property (nonatomic) SPNPPollManager *manager;
 
 /**
- @brief  Stores number of charts which is displayed on screen at this moment.
+ @brief      Stores reference on presenter which coalesce statistic updates and report changed bars.
+ @discussion Frame rate limited by chart animation duration, so each bar property sent to the watch
+             not more often than it can be shown.
  */
-@property (nonatomic, assign) NSUInteger entriesCount;
+@property (nonatomic) SPNPStatisticPresenter *presenter;
 
 
 #pragma mark - Interface
@@ -107,16 +111,33 @@ static NSString * const kSPNPBarChartLegendCell = @"SPNPBarChartLegendCell";
 - (void)updateStatistics;
 
 /**
- @brief  Update displayed chart information with user provided data.
+ @brief  Update displayed chart bars with values from presenter.
  
- @param statistics Reference on list of response statistics entries.
- @param animated   Whether update should be animated or not.
+ @param changedBars Indices of bars which presented value has been changed.
+ @param isInitial   Whether bars layout should be updated w/o animation.
  */
-- (void)updateStatistics:(NSArray *)statistics animated:(BOOL)animated;
+- (void)updateChartBars:(NSIndexSet *)changedBars initial:(BOOL)isInitial;
+
+/**
+ @brief  Pass presenter values to the chart bars.
+ 
+ @param changedBars Indices of bars which should be updated.
+ */
+- (void)showChartBars:(NSIndexSet *)changedBars;
 
 
 #pragma mark - Misc
 
+/**
+ @brief  Compute width of chart bar.
+ 
+ @param barsCount Number of bars which should be shown by chart (chart has only 
+                  \c kWKNumberOfChartBars bars).
+ 
+ @return Width which should be used by each bar.
+ */
++ (CGFloat)barWidthForBarsCount:(NSUInteger)barsCount;
+
 /**
  @brief  Gather all outlets and wrap them into classes which is easier to use.
  */
@@ -144,6 +165,18 @@ static NSString * const kSPNPBarChartLegendCell = @"SPNPBarChartLegendCell";
 @implementation SPNPBarChartController
 
 
+#pragma mark - Configuration
+
++ (void)prepareForPoll:(SPNPPoll *)poll {
+    
+    // Chart has limited number of bars, so images prepared only for responses which fit into it.
+    NSArray *titles = [poll.responses valueForKey:@"response"];
+    CGFloat barWidth = [self barWidthForBarsCount:titles.count];
+    titles = [titles subarrayWithRange:NSMakeRange(0, MIN(titles.count, kWKNumberOfChartBars))];
+    [SPNPChartBarView prepareImagesForFields:titles withBarWidth:barWidth];
+}
+
+
 #pragma mark - Controller life-cycle
 
 - (void)awakeWithContext:(id)context {
@@ -153,6 +186,13 @@ static NSString * const kSPNPBarChartLegendCell = @"SPNPBarChartLegendCell";
     
     [self prepareChartBars];
     self.manager = context;
+    __weak __typeof(self) weakSelf = self;
+    self.presenter = [SPNPStatisticPresenter presenterWithUpdateBlock:^(NSIndexSet *changedBars,
+                                                                        BOOL isInitial) {
+        
+        [weakSelf updateChartBars:changedBars initial:isInitial];
+    }];
+    self.presenter.maximumFrameRate = (NSUInteger)(1.0f / kWKChartUpdateAnimationDuration);
     [self prepareInterface];
     [self subscribeOnUpdates];
 }
@@ -175,43 +215,55 @@ static NSString * const kSPNPBarChartLegendCell = @"SPNPBarChartLegendCell";
                                             BOOL *responsesEnumeratorStop) {
         
         SPNPBarChartLegendCell *cell = [self.legendTable rowControllerAtIndex:responseIdx];
-        [cell updateWithTitle:response.response color:self.barsColor[responseIdx]];
+        UIColor *color = self.barsColor[responseIdx % self.barsColor.count];
+        [cell updateWithTitle:response.response color:color];
     }];
 }
 
 - (void)updateStatistics {
     
-    [self updateStatistics:self.manager.statistics animated:(self.entriesCount != 0)];
-    self.entriesCount = self.manager.statistics.count;
+    [self.presenter updateWithStatistics:self.manager.statisticSnapshot.statistics];
 }
 
-- (void)updateStatistics:(NSArray *)statistics animated:(BOOL)animated {
+- (void)updateChartBars:(NSIndexSet *)changedBars initial:(BOOL)isInitial {
     
-    if (animated) {
+    if (isInitial) {
         
-        [self animateWithDuration:kWKChartUpdateAnimationDuration animations:^{
-        
-            [self updateStatistics:statistics animated:NO];
+        CGFloat barWidth = [[self class] barWidthForBarsCount:self.presenter.barsCount];
+        [changedBars enumerateIndexesUsingBlock:^(NSUInteger barIdx, BOOL *barsEnumeratorStop) {
+            
+            SPNPChartBarView *bar = (barIdx < self.bars.count ? self.bars[barIdx] : nil);
+            [bar setWidth:barWidth];
         }];
+        [self showChartBars:changedBars];
     }
     else {
         
-        NSArray *values = [statistics valueForKey:@"votesCount"];
-        NSUInteger maximumValue = ((NSNumber *)[values valueForKeyPath:@"@max.self"]).unsignedIntegerValue;
-        CGFloat screenWidth = [WKInterfaceDevice currentDevice].screenBounds.size.width;
-        [statistics enumerateObjectsUsingBlock:^(SPNPPollResponseStatistic *statistic,
-                                                NSUInteger statisticIdx,
-                                                BOOL *statisticsEnumeratorStop) {
-            
-            SPNPChartBarView *bar = self.bars[statisticIdx];
+        [self animateWithDuration:kWKChartUpdateAnimationDuration animations:^{
             
-            if (self.entriesCount == 0) { [bar setWidth:(screenWidth / statistics.count)]; }
-            [bar showValue:statistic.votesCount withTitle:statistic.response
-                   percent:(statistic.votesCount.floatValue / MAX(maximumValue, 0.001f))];
+            [self showChartBars:changedBars];
         }];
     }
 }
 
+- (void)showChartBars:(NSIndexSet *)changedBars {
+    
+    NSArray *statistics = self.manager.statisticSnapshot.statistics;
+    SPNPStatisticPresenter *presenter = self.presenter;
+    [changedBars enumerateIndexesUsingBlock:^(NSUInteger barIdx, BOOL *barsEnumeratorStop) {
+        
+        if (barIdx >= statistics.count || barIdx >= self.bars.count) {
+            
+            *barsEnumeratorStop = YES;
+            return;
+        }
+        SPNPPollResponseStatistic *statistic = statistics[barIdx];
+        [(SPNPChartBarView *)self.bars[barIdx] showValue:@([presenter votesCountForBar:barIdx])
+                                               withTitle:statistic.response
+                                                 percent:(CGFloat)[presenter percentForBar:barIdx]];
+    }];
+}
+
 
 #pragma mark - Handlers
 
@@ -249,6 +301,13 @@ static NSString * const kSPNPBarChartLegendCell = @"SPNPBarChartLegendCell";
     [_manager removeObserver:self forKeyPath:@"activePoll" context:nil];
 }
 
++ (CGFloat)barWidthForBarsCount:(NSUInteger)barsCount {
+    
+    CGFloat screenWidth = [WKInterfaceDevice currentDevice].screenBounds.size.width;
+    
+    return (screenWidth / MIN(MAX(barsCount, (NSUInteger)1), kWKNumberOfChartBars));
+}
+
 - (void)prepareChartBars {
     
     _barsColor = @[[UIColor colorWithRed:(38.0/255.0) green:(120.0/255.0) blue:(178.0/255.0) alpha:1.0],
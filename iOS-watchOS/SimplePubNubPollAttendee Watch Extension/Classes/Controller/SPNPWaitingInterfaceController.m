@@ -3,6 +3,7 @@
  @copyright © 2009-2015 PubNub, Inc.
  */
 #import "SPNPWaitingInterfaceController.h"
+#import "SPNPBarChartController.h"
 #import "SPNPPollManager.h"
 
 
@@ -104,7 +105,7 @@ static NSString * const kSPNPChartsInterfaceController = @"SPNPPollStatisticsScr
     
     // Forward method call to the super class.
     [super awakeWithContext:context];
-
+    
     self.manager = context;
     
     __weak __typeof(self) weakSelf = self;
@@ -159,7 +160,12 @@ static NSString * const kSPNPChartsInterfaceController = @"SPNPPollStatisticsScr
         [self updateInterface];
         id activePoll = change[NSKeyValueChangeNewKey];
         if ([activePoll isEqual:[NSNull null]]) { activePoll = nil; }
-        if (activePoll) { [self showPollInformation]; }
+        if (activePoll) {
+            
+            // Render bar titles before chart appear, so they won't be rendered during animation.
+            [SPNPBarChartController prepareForPoll:activePoll];
+            [self showPollInformation];
+        }
     }
 }
 
@@ -1,9 +1,14 @@
 #import <WatchKit/WatchKit.h>
 
 
+#pragma mark Class forward
+
+@class SPNPCostCache;
+
+
 /**
  @brief  Class which describe bar based chart single bar item.
-
+ 
  @author Sergey Mamontov
  @copyright © 2009-2015 PubNub, Inc.
  */
@@ -36,11 +41,30 @@
  */
 - (void)setColor:(UIColor *)barColor;
 
+/**
+ @brief      Retrieve cache of images generated for field titles.
+ @discussion Images cached for title and bar size, least recently used images evicted when total
+             bitmaps size exceed cache budget (\c 2 MB by default).
+ 
+ @return Reference on shared images cache.
+ */
++ (SPNPCostCache *)imageCache;
+
 /**
  @brief  Clean up generated image cache for field titles.
  */
 + (void)clearImageCache;
 
+/**
+ @brief      Generate and cache images for field titles in advance.
+ @discussion Should be called when poll announced, so images doesn't rendered during chart 
+             animation.
+ 
+ @param fieldNames List of titles which will be shown by chart bars.
+ @param barWidth   Width which will be used by chart bars.
+ */
++ (void)prepareImagesForFields:(NSArray *)fieldNames withBarWidth:(CGFloat)barWidth;
+
 
 ///------------------------------------------------
 /// @name Presentation
@@ -4,6 +4,7 @@
  */
 #import "SPNPChartBarView.h"
 #import <CoreGraphics/CoreGraphics.h>
+#import "SPNPCostCache.h"
 #import <UIKit/UIKit.h>
 
 
@@ -19,6 +20,11 @@ static CGFloat const kWKBarValueLabelHeight = 14.0f;
  */
 static CGFloat const kWKBarElementsSpacing = 4.0f;
 
+/**
+ @brief  Stores maximum number of bytes which can be used by cached field title images.
+ */
+static NSUInteger const kWKImageCacheCostLimit = (2 * 1024 * 1024);
+
 
 #pragma mark - Private interface declaration
 
@@ -71,19 +77,24 @@ static CGFloat const kWKBarElementsSpacing = 4.0f;
 #pragma mark - Misc
 
 /**
- @brief  Stores reference on images generated to be shown as field name.
+ @brief  Compute size of the bar which has specified width.
+ 
+ @param barWidth Bar holder width.
+ 
+ @return Size which is available for bar and field title image.
  */
-+ (NSMutableDictionary *)imageCache;
++ (CGSize)barSizeWithWidth:(CGFloat)barWidth;
 
 /**
  @brief  Retrieve image which should be shown at the back of the bar to clarify for which field data
          is shown.
  
  @param fieldName Name of the fields for which image should be retrieved from cache or generated.
+ @param barSize   Size of the bar for which image should be retrieved.
  
- @return Generated \c UIImage instance.
+ @return Cached or generated \c UIImage instance.
  */
-- (UIImage *)imageForField:(NSString *)fieldName;
++ (UIImage *)imageForField:(NSString *)fieldName withSize:(CGSize)barSize;
 
 #pragma mark -
 
@@ -110,8 +121,7 @@ static CGFloat const kWKBarElementsSpacing = 4.0f;
     // Check whether initialization was successful or not.
     if ((self = [super init])) {
         
-        CGSize screenSize = [WKInterfaceDevice currentDevice].screenBounds.size;
-        _orignalBarSize = CGSizeMake(0.0f, screenSize.height - kWKBarValueLabelHeight - kWKBarElementsSpacing);
+        _orignalBarSize = [[self class] barSizeWithWidth:0.0f];
         
         _holder = holder;
         _value = value;
@@ -134,11 +144,32 @@ static CGFloat const kWKBarElementsSpacing = 4.0f;
     [self.bar setAlpha:0.6f];
 }
 
++ (SPNPCostCache *)imageCache {
+    
+    static SPNPCostCache *_sharedImageCache;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        
+        _sharedImageCache = [SPNPCostCache cacheWithCostLimit:kWKImageCacheCostLimit];
+    });
+    
+    return _sharedImageCache;
+}
+
 + (void)clearImageCache {
     
     [[self imageCache] removeAllObjects];
 }
 
++ (void)prepareImagesForFields:(NSArray *)fieldNames withBarWidth:(CGFloat)barWidth {
+    
+    CGSize size = [self barSizeWithWidth:barWidth];
+    for (NSString *fieldName in fieldNames) {
+        
+        if (fieldName.length) { [self imageForField:fieldName withSize:size]; }
+    }
+}
+
 
 #pragma mark - Presentation
 
@@ -154,7 +185,8 @@ static CGFloat const kWKBarElementsSpacing = 4.0f;
         [self.bar setHeight:(self.orignalBarSize.height * percent)];
         if (![self.currentFieldName isEqualToString:title]) {
             
-            [self.holder setBackgroundImage:[self imageForField:title]];
+            [self.holder setBackgroundImage:[[self class] imageForField:title
+                                                              withSize:self.orignalBarSize]];
         }
         [self.value setText:value.description];
     }
@@ -164,21 +196,19 @@ static CGFloat const kWKBarElementsSpacing = 4.0f;
 
 #pragma mark - Misc
 
-+ (NSMutableDictionary *)imageCache {
++ (CGSize)barSizeWithWidth:(CGFloat)barWidth {
     
-    static NSMutableDictionary *_sharedImageCache;
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
-        
-        _sharedImageCache = [NSMutableDictionary new];
-    });
+    CGSize screenSize = [WKInterfaceDevice currentDevice].screenBounds.size;
     
-    return _sharedImageCache;
+    return CGSizeMake(barWidth, screenSize.height - kWKBarValueLabelHeight - kWKBarElementsSpacing);
 }
 
-- (UIImage *)imageForField:(NSString *)fieldName {
++ (UIImage *)imageForField:(NSString *)fieldName withSize:(CGSize)barSize {
     
-    UIImage *image = [self.class imageCache][fieldName];
+    // Same title rendered differently for different bar sizes.
+    NSString *key = [NSString stringWithFormat:@"%.0fx%.0f:%@", barSize.width, barSize.height,
+                     fieldName];
+    UIImage *image = [[self imageCache] objectForKey:key];
     if (!image) {
         
         UIFont *font = [UIFont systemFontOfSize:14.0f];
@@ -187,9 +217,9 @@ static CGFloat const kWKBarElementsSpacing = 4.0f;
         paragraphStyle.lineBreakMode = NSLineBreakByTruncatingTail;
         paragraphStyle.alignment = NSTextAlignmentLeft;
         
-        UIGraphicsBeginImageContext(self.orignalBarSize);
-        CGRect titleFrame = CGRectMake(ceilf((self.orignalBarSize.width - size.width) * 0.5f),
-                                       ceilf(self.orignalBarSize.height - size.height),
+        UIGraphicsBeginImageContext(barSize);
+        CGRect titleFrame = CGRectMake(ceilf((barSize.width - size.width) * 0.5f),
+                                       ceilf(barSize.height - size.height),
                                        size.width, size.height);
         CGPoint titleCenter = CGPointMake(ceilf(titleFrame.origin.x + size.width * 0.5f),
                                           ceilf(titleFrame.origin.y + size.height * 0.5f));
@@ -197,7 +227,7 @@ static CGFloat const kWKBarElementsSpacing = 4.0f;
         CGContextSaveGState(context);
         CGContextTranslateCTM(context, titleCenter.x, titleCenter.y);
         CGContextRotateCTM(context, -90.0f * M_PI/180.0f);
-        CGContextTranslateCTM(context, -titleCenter.x + size.width * 0.5f, -titleCenter.y - self.orignalBarSize.width * 0.5f);
+        CGContextTranslateCTM(context, -titleCenter.x + size.width * 0.5f, -titleCenter.y - barSize.width * 0.5f);
         CGContextTranslateCTM(context, 0.0f, size.height * 0.5f);
         NSDictionary *attributes = @{ NSFontAttributeName: font,
                                       NSParagraphStyleAttributeName: paragraphStyle,
@@ -207,9 +237,11 @@ static CGFloat const kWKBarElementsSpacing = 4.0f;
         
         CGImageRef imageRef = CGBitmapContextCreateImage(context);
         image = [UIImage imageWithCGImage:imageRef];
+        NSUInteger cost = (CGImageGetBytesPerRow(imageRef) * CGImageGetHeight(imageRef));
+        CGImageRelease(imageRef);
         UIGraphicsPopContext();
         UIGraphicsEndImageContext();
-        [[self.class imageCache] setValue:image forKey:fieldName];
+        [[self imageCache] setObject:image forKey:key cost:cost];
     }
     
     return image;
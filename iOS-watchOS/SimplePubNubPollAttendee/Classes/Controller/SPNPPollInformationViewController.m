@@ -4,6 +4,7 @@
  */
 #import "SPNPPollInformationViewController.h"
 #import "SPNPPollResponseStatistic.h"
+#import "SPNPStatisticSnapshot.h"
 #import "SPNPStatisticsView.h"
 #import "SPNPPollStatistic.h"
 #import "SPNPPollResponse.h"
@@ -133,7 +134,7 @@
 
 - (void)showPollStatistics {
     
-    [self.statisticsView updateStatistics:self.manager.statistics];
+    [self.statisticsView updateStatistics:self.manager.statisticSnapshot.statistics];
     
     CGFloat value = self.constraint.constant;
     if (self.constraint.firstAttribute == NSLayoutAttributeTop) {
@@ -166,7 +167,7 @@
     }
     else if ([keyPath isEqualToString:@"statistics"]) {
         
-        [self.statisticsView updateStatistics:self.manager.statistics];
+        [self.statisticsView updateStatistics:self.manager.statisticSnapshot.statistics];
     }
 }
 
@@ -185,7 +186,7 @@
                                         message:message preferredStyle:UIAlertControllerStyleAlert];
             UIAlertAction *ok = [UIAlertAction actionWithTitle:@"OK" style:UIAlertActionStyleDestructive
                                                        handler:^(UIAlertAction * _Nonnull action) {
-                                                           
+                
                 [alert dismissViewControllerAnimated:YES completion:nil];
             }];
             [alert addAction:ok];
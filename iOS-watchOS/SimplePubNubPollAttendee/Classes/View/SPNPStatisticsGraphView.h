@@ -3,7 +3,7 @@
 
 #pragma mark Class forward
 
-@class SPNPPollStatistic;
+@class SPNPStatisticPresenter;
 
 
 /**
@@ -32,11 +32,14 @@
 ///------------------------------------------------
 
 /**
- @brief  Update presented data according to received stats.
+ @brief  Update presented data for bars which has been changed by presenter.
  
- @param pollStatistics Reference on list of response statistics entries.
+ @param changedBars Indices of bars which presented value has been changed.
+ @param presenter   Reference on presenter from which bar values should be taken.
+ @param animated    Whether bars change should be animated or not.
  */
-- (void)updateStatistics:(NSArray *)pollStatistics;
+- (void)showBars:(NSIndexSet *)changedBars fromPresenter:(SPNPStatisticPresenter *)presenter
+        animated:(BOOL)animated;
 
 #pragma mark -
 
@@ -4,8 +4,7 @@
  */
 #import "SPNPStatisticsGraphView.h"
 #import "SPNPStatisticsGraphBarView.h"
-#import "SPNPPollResponseStatistic.h"
-#import "SPNPPollStatistic.h"
+#import "SPNPStatisticPresenter.h"
 
 
 #pragma mark Private interface declaration
@@ -24,11 +23,6 @@
 @property (nonatomic, weak) IBOutlet SPNPStatisticsGraphBarView *bar4View;
 @property (nonatomic, weak) IBOutlet SPNPStatisticsGraphBarView *bar5View;
 
-/**
- @brief  Stores whether graph view shown at least one portion of data or not.
- */
-@property (nonatomic, assign) BOOL presentedData;
-
 /**
  @brief  Stores reference on list of bars for which data available.
  */
@@ -63,23 +57,26 @@
 
 #pragma mark - Data representation
 
-- (void)updateStatistics:(NSArray *)pollStatistics {
+- (void)showBars:(NSIndexSet *)changedBars fromPresenter:(SPNPStatisticPresenter *)presenter
+        animated:(BOOL)animated {
     
-    NSArray *values = [pollStatistics valueForKey:@"votesCount"];
-    NSUInteger maximumValue = ((NSNumber *)[values valueForKeyPath:@"@max.self"]).unsignedIntegerValue;
+    NSUInteger scale = (NSUInteger)presenter.scale;
     dispatch_block_t barsUpdateBlock = ^{
         
-        [values enumerateObjectsUsingBlock:^(NSNumber *votesCount, NSUInteger responsIdx,
-                                             BOOL *responsesStatisticEnumerationStop) {
+        [changedBars enumerateIndexesUsingBlock:^(NSUInteger barIdx, BOOL *barsEnumeratorStop) {
             
-            SPNPStatisticsGraphBarView *barView = self.activeBars[responsIdx];
-            [barView showValue:votesCount.unsignedIntegerValue scale:maximumValue];
+            if (barIdx >= self.activeBars.count) {
+                
+                *barsEnumeratorStop = YES;
+                return;
+            }
+            SPNPStatisticsGraphBarView *barView = self.activeBars[barIdx];
+            [barView showValue:(NSUInteger)[presenter votesCountForBar:barIdx] scale:scale];
             [barView setNeedsDisplay];
         }];
         [self layoutIfNeeded];
-        self.presentedData = YES;
     };
-    if (!self.presentedData) {
+    if (!animated) {
         
         barsUpdateBlock();
     }
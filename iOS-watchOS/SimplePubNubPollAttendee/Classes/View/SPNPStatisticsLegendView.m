@@ -90,8 +90,9 @@ static NSString * const kSPNPLegendCellIdentifier = @"SPNPStatisticsLegendCell";
 - (void)  tableView:(UITableView *)tableView willDisplayCell:(UITableViewCell *)cell
   forRowAtIndexPath:(NSIndexPath *)indexPath {
     
-    [(SPNPStatisticsLegendCell *)cell updateWithTitle:self.legendTitles[indexPath.row]
-                                                color:self.legendColors[indexPath.row]];
+    // Polls can have more response variants than there is colors.
+    UIColor *color = self.legendColors[indexPath.row % self.legendColors.count];
+    [(SPNPStatisticsLegendCell *)cell updateWithTitle:self.legendTitles[indexPath.row] color:color];
 }
 
 
@@ -3,6 +3,7 @@
  @copyright © 2009-2015 PubNub, Inc.
  */
 #import "SPNPStatisticsView.h"
+#import "SPNPStatisticPresenter.h"
 #import "SPNPStatisticsLegendView.h"
 #import "SPNPStatisticsGraphView.h"
 #import "SPNPPoll.h"
@@ -25,6 +26,11 @@
  */
 @property (nonatomic, weak) IBOutlet SPNPStatisticsLegendView *legendView;
 
+/**
+ @brief  Stores reference on presenter which coalesce statistic updates and report changed bars.
+ */
+@property (nonatomic, strong) SPNPStatisticPresenter *presenter;
+
 #pragma mark -
 
 
@@ -42,6 +48,18 @@
     
     [self.legendView setupWithResponses:poll.responses];
     [self.graphView setupWithResponses:poll.responses];
+    if (!self.presenter) {
+        
+        __weak __typeof(self) weakSelf = self;
+        self.presenter = [SPNPStatisticPresenter presenterWithUpdateBlock:^(NSIndexSet *changedBars,
+                                                                            BOOL isInitial) {
+            
+            __strong __typeof(self) strongSelf = weakSelf;
+            [strongSelf.graphView showBars:changedBars fromPresenter:strongSelf.presenter
+                                  animated:!isInitial];
+        }];
+    }
+    else { [self.presenter reset]; }
 }
 
 
@@ -49,7 +67,7 @@
 
 - (void)updateStatistics:(NSArray *)pollStatistics {
     
-    [self.graphView updateStatistics:pollStatistics];
+    [self.presenter updateWithStatistics:pollStatistics];
 }
 
 #pragma mark -